@@ -6,6 +6,14 @@
  *
  * Implements the CIA402 state machine for controlling motor drivers.
  * Provides high-level methods for motor enable/disable and state transitions.
+ *
+ * By default the statusword is polled over SDO. In PDO mode the FSM follows
+ * the statusword carried by TPDO1 and sends the controlword via RPDO1, so a
+ * transition completes as soon as the drive reports it; SDO polling is only
+ * used when no TPDO arrives within the fallback interval.
+ *
+ * Attached to an EMCYConsumer, the FSM also treats an emergency from its
+ * drive as FAULT the moment the frame is decoded, in either mode.
  */
 
 #pragma once
@@ -13,7 +21,15 @@
 #include "canopen/sdo_client.hpp"
 #include "canopen/object_dictionary.hpp"
 #include "canopen/cia402_constants.hpp"
+#include "canopen/emcy_consumer.hpp"
+#include "canopen/pdo_codec.hpp"
+#include "canopen/pdo_manager.hpp"
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -44,6 +60,15 @@ namespace canopen {
                 std::chrono::milliseconds state_timeout = std::chrono::milliseconds(1000)
             );
 
+            /**
+             * @brief Destructor - leaves PDO mode and detaches from EMCY
+             */
+            ~CIA402FSM();
+
+            // Prevent copying (the TPDO subscription refers to this instance)
+            CIA402FSM(const CIA402FSM&) = delete;
+            CIA402FSM& operator=(const CIA402FSM&) = delete;
+
             // =========================================================================
             // High-Level Control Methods
             // =========================================================================
@@ -154,35 +179,94 @@ namespace canopen {
             uint16_t get_statusword() const { return last_statusword_; }
 
             // =========================================================================
-            // Configuration Methods
+            // Event-Driven (PDO) Mode
             // =========================================================================
 
             /**
-             * @brief Set state transition timeout
-             * @param timeout Timeout duration
+             * @brief Follow statusword from TPDO1 and send controlword via RPDO1
+             * @param manager PDO manager receiving TPDOs for this node
+             * @param subscribe Register the TPDO1 callback on the manager. Pass
+             *        false when another component owns the TPDO1 callback and
+             *        forwards the statusword through on_statusword().
+             * @return false if TPDO1 of the dictionary does not map the statusword
+             *
+             * The controlword is sent via RPDO1 only when it is the sole object
+             * mapped there (otherwise other mapped values would be overwritten);
+             * in that case it keeps going over SDO.
              */
-            void set_state_timeout(std::chrono::milliseconds timeout) {
-                state_timeout_ = timeout;
-            }
+            bool enable_pdo_mode(PDOManager& manager, bool subscribe = true);
 
             /**
-             * @brief Get current state transition timeout
-             * @return Timeout duration
+             * @brief Return to SDO polling and drop the TPDO1 subscription
              */
-            std::chrono::milliseconds get_state_timeout() const {
-                return state_timeout_;
+            void disable_pdo_mode();
+
+            /**
+             * @brief Check if statusword is followed from TPDO
+             */
+            bool is_pdo_mode() const { return pdo_manager_ != nullptr; }
+
+            /**
+             * @brief Report statusword received by PDO (thread-safe)
+             *
+             * Called from the PDO receive thread; wakes any pending transition.
+             */
+            void on_statusword(uint16_t statusword);
+
+            /**
+             * @brief Set how long a transition waits for a TPDO before polling over SDO
+             */
+            void set_fallback_poll_interval(std::chrono::milliseconds interval) {
+                fallback_poll_interval_ = interval;
             }
 
-        private:
+            /**
+             * @brief Number of SDO statusword reads made because TPDOs were silent
+             */
+            uint64_t get_fallback_polls() const { return fallback_polls_; }
+
             // =========================================================================
-            // Internal Helper Methods
+            // Emergency (EMCY) Monitoring
+            // =========================================================================
+
+            /**
+             * @brief Treat emergencies of this node as FAULT as soon as they arrive
+             * @param consumer EMCY consumer receiving this node's emergencies; must
+             *        outlive the FSM or detach_emcy() must be called first
+             *
+             * A pending wait_for_state() returns false on the emergency frame
+             * instead of at the next statusword poll.
+             */
+            void attach_emcy(EMCYConsumer& consumer);
+
+            /**
+             * @brief Drop the EMCY subscription
+             */
+            void detach_emcy();
+
+            /**
+             * @brief Report an emergency of this node (thread-safe)
+             *
+             * A non-zero error code marks the drive as FAULT and wakes any
+             * pending transition; 0x0000 (error reset) only clears the code.
+             */
+            void on_emergency(uint16_t error_code);
+
+            /**
+             * @brief Error code of the last emergency unless it was reset (0 = none)
+             */
+            uint16_t get_emergency_code() const;
+
+            // =========================================================================
+            // Step Primitives (used by CIA402Group to burst commands across nodes)
             // =========================================================================
 
             /**
              * @brief Wait for device to reach expected state
              * @param expected_state Target state
              * @param timeout Maximum wait time
-             * @return true if state reached within timeout
+             * @return true if state reached within timeout; false on timeout,
+             *         FAULT or cancel_wait()
              */
             bool wait_for_state(cia402::State expected_state, std::chrono::milliseconds timeout);
 
@@ -193,6 +277,43 @@ namespace canopen {
              */
             bool send_controlword(uint16_t command);
 
+            /**
+             * @brief Abort a wait_for_state() in progress on another thread (thread-safe)
+             *
+             * The waiting thread wakes immediately in both modes.
+             */
+            void cancel_wait();
+
+            /**
+             * @brief Node ID of the controlled device
+             */
+            uint8_t get_node_id() const { return sdo_client_.get_node_id(); }
+
+            // =========================================================================
+            // Configuration Methods
+            // =========================================================================
+
+            /**
+             * @brief Set state transition timeout
+             * @param timeout Timeout duration
+             */
+            void set_state_timeout(std::chrono::milliseconds timeout) {
+                state_timeout_ = timeout;
+            }
+
+            /**
+             * @brief Get current state transition timeout
+             * @return Timeout duration
+             */
+            std::chrono::milliseconds get_state_timeout() const {
+                return state_timeout_;
+            }
+
+        private:
+            // =========================================================================
+            // Internal Helper Methods
+            // =========================================================================
+
             /**
              * @brief Read statusword from device
              * @return Statusword value
@@ -232,11 +353,57 @@ namespace canopen {
             SDOClient& sdo_client_;                 ///< SDO client for communication
             const ObjectDictionary& dictionary_;    ///< Object dictionary reference
 
-            cia402::State current_state_;           ///< Cached current state
-            uint16_t last_statusword_;              ///< Last read statusword value
+            // Atomic: a group quick stop updates the cache from another thread
+            std::atomic<cia402::State> current_state_; ///< Cached current state
+            std::atomic<uint16_t> last_statusword_; ///< Last read statusword value
             std::chrono::milliseconds state_timeout_; ///< Default state transition timeout
 
-            bool state_cache_valid_;                ///< Flag indicating if cached state is valid
+            std::atomic<bool> state_cache_valid_;   ///< Flag indicating if cached state is valid
+
+            /**
+             * @brief Statusword shared with the PDO receive thread
+             *
+             * Held by shared_ptr so a callback still running after
+             * unsubscription never touches a destroyed FSM.
+             */
+            struct PDOFeedback {
+                std::mutex mutex;
+                std::condition_variable cv;
+                uint16_t statusword = 0;
+                uint64_t updates = 0;               ///< Incremented per statusword (TPDO or SDO poll)
+                bool valid = false;
+                uint16_t emergency_code = 0;        ///< Last EMCY error code (0 = reset)
+                uint64_t emergencies = 0;           ///< Incremented per non-zero EMCY
+            };
+
+            PDOManager* pdo_manager_ = nullptr;     ///< Non-null in PDO mode
+            bool pdo_subscribed_ = false;           ///< TPDO1 callback registered by us
+            std::shared_ptr<PDOFeedback> feedback_ = std::make_shared<PDOFeedback>();
+            bool controlword_via_rpdo_ = false;     ///< RPDO1 maps only the controlword
+            PDOMapping rpdo_;                       ///< Compiled RPDO1 mapping
+            PDOFieldLayout controlword_field_;      ///< Controlword location in RPDO1
+            std::chrono::milliseconds fallback_poll_interval_{100};
+            uint64_t fallback_polls_ = 0;
+            uint64_t command_updates_ = 0;          ///< feedback_->updates when last command was sent
+            std::atomic<uint64_t> cancel_generation_{0}; ///< Bumped by cancel_wait()
+            EMCYConsumer* emcy_consumer_ = nullptr; ///< Non-null while attached
+            EMCYConsumer::SubscriptionId emcy_subscription_ = 0;
+
+            /**
+             * @brief Record an emergency in the shared feedback (any thread)
+             */
+            static void report_emergency(PDOFeedback& feedback, uint16_t error_code);
+
+            /**
+             * @brief Update cached state from a statusword value
+             */
+            void apply_statusword(uint16_t statusword);
+
+            /**
+             * @brief Event-driven wait used in PDO mode
+             */
+            bool wait_for_state_pdo(cia402::State expected_state,
+                std::chrono::milliseconds timeout);
     };
 
 } // namespace canopen
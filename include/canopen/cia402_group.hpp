@@ -0,0 +1,255 @@
+/**
+ * @file cia402_group.hpp
+ * @brief Parallel CIA402 state machine orchestration for multi-axis systems
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-16
+ *
+ * Runs the CIA402 transitions of several drives side by side instead of one
+ * node after the other:
+ * - Each transition step is sent to all nodes in one burst: one task per node
+ *   is started first and released through a shared start gate, so the
+ *   controlwords leave together and the skew is the wake-up spread only
+ * - Every node then waits for its own target state concurrently; the group
+ *   waits for all nodes or for the first one
+ * - Nodes that fail a step drop out of the following steps and are reported
+ *   individually
+ * - quick_stop() aborts any group operation in progress and stops all axes
+ *   with a single burst
+ *
+ * Usage:
+ * @code
+ * CIA402Group group;
+ * for (auto& fsm : axes) group.add(*fsm);
+ *
+ * auto result = group.enable_operation();
+ * if (!result.success) {
+ *     for (uint8_t node : result.failed_nodes()) { ... }
+ * }
+ *
+ * group.quick_stop();   // safe from any thread
+ * @endcode
+ */
+
+#pragma once
+
+#include "canopen/cia402_fsm.hpp"
+#include "canopen/cia402_constants.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+namespace canopen {
+
+/**
+ * @brief Completion policy for group waits
+ */
+    enum class GroupWait : uint8_t {
+        ALL,  ///< Wait until every node reached the state (or failed)
+        ANY   ///< Return as soon as one node reached the state
+    };
+
+/**
+ * @brief Outcome of a group operation for one node
+ */
+    struct NodeResult {
+        uint8_t node_id = 0;
+        bool success = false;
+        cia402::State state = cia402::State::UNKNOWN;  ///< Last known state
+        std::chrono::microseconds elapsed{0};           ///< Time spent on this node
+    };
+
+/**
+ * @brief Outcome of a group operation
+ */
+    struct GroupResult {
+        bool success = false;                    ///< ALL: every node, ANY: at least one
+        std::vector<NodeResult> nodes;           ///< In group order
+        std::chrono::microseconds elapsed{0};    ///< Wall time of the whole operation
+        std::chrono::microseconds command_skew{0}; ///< Largest spread of one command burst
+
+        /**
+         * @brief Node IDs that did not succeed
+         */
+        std::vector<uint8_t> failed_nodes() const {
+            std::vector<uint8_t> failed;
+            for (const auto& node : nodes) {
+                if (!node.success) failed.push_back(node.node_id);
+            }
+            return failed;
+        }
+    };
+
+/**
+ * @class CIA402Group
+ * @brief Drives many CIA402FSM instances in lockstep
+ *
+ * The FSMs are borrowed and must outlive the group. Each FSM must own its
+ * SDO client. Group operations are serialized; quick_stop() and cancel()
+ * may be called from any thread, and quick_stop() does not wait for the
+ * operation it pre-empts to return. In SDO mode the Quick Stop write still
+ * waits for the transfer each client has in flight.
+ */
+    class CIA402Group {
+        public:
+            /**
+             * @brief Construct group
+             * @param state_timeout Per-step timeout for every node (default: 1000ms)
+             */
+            explicit CIA402Group(
+                std::chrono::milliseconds state_timeout = std::chrono::milliseconds(1000));
+
+            // Prevent copying
+            CIA402Group(const CIA402Group&) = delete;
+            CIA402Group& operator=(const CIA402Group&) = delete;
+
+            /**
+             * @brief Add a drive to the group
+             * @throws std::invalid_argument if a drive with the same node ID exists
+             */
+            void add(CIA402FSM& fsm);
+
+            /**
+             * @brief Number of drives in the group
+             */
+            std::size_t size() const { return members_.size(); }
+
+            // =========================================================================
+            // Group Transitions
+            // =========================================================================
+
+            /**
+             * @brief Enable all drives (fault reset, then Shutdown/Switch On/Enable bursts)
+             * @return Per-node result; success if every node is OPERATION_ENABLED
+             */
+            GroupResult enable_operation();
+
+            /**
+             * @brief Bring all enabled drives back to SWITCHED_ON
+             */
+            GroupResult disable_operation();
+
+            /**
+             * @brief Send Shutdown to all drives (READY_TO_SWITCH_ON)
+             */
+            GroupResult shutdown();
+
+            /**
+             * @brief Reset every faulted drive (SWITCH_ON_DISABLED)
+             */
+            GroupResult reset_fault();
+
+            /**
+             * @brief Coordinated quick stop of all drives
+             *
+             * Cancels any group operation in progress and sends Quick Stop to
+             * every node in one burst, without waiting for that operation to
+             * return. No step command of the cancelled operation is sent after
+             * the Quick Stop. Enabled drives must reach QUICK_STOP_ACTIVE, all
+             * others SWITCH_ON_DISABLED.
+             *
+             * With PDO mode the Quick Stop goes out at once. In SDO mode each
+             * write shares the node's SDO channel, so it is sent after the
+             * transfer in flight there completes (at most one SDO timeout).
+             */
+            GroupResult quick_stop();
+
+            /**
+             * @brief Wait until all or any drive reaches a state
+             * @param state Target state
+             * @param policy ALL or ANY
+             * @param timeout Maximum wait time
+             *
+             * With ANY, the remaining waits are cancelled once a node succeeds.
+             */
+            GroupResult wait_for_state(cia402::State state, GroupWait policy,
+                std::chrono::milliseconds timeout);
+
+            /**
+             * @brief Abort the group operation in progress (thread-safe)
+             */
+            void cancel();
+
+            // =========================================================================
+            // Configuration Methods
+            // =========================================================================
+
+            void set_state_timeout(std::chrono::milliseconds timeout) { state_timeout_ = timeout; }
+            std::chrono::milliseconds get_state_timeout() const { return state_timeout_; }
+
+        private:
+            /**
+             * @brief Per-node work item of a burst
+             * @return true if the node completed the step
+             */
+            using NodeTask = std::function<bool (CIA402FSM& fsm)>;
+
+            std::vector<CIA402FSM*> members_;
+            std::chrono::milliseconds state_timeout_;
+
+            std::mutex operation_mutex_;            ///< Serializes group operations
+            std::mutex stop_mutex_;                 ///< Serializes quick stops
+            std::shared_mutex command_mutex_;       ///< Step sends (shared) vs. quick stop
+            std::atomic<bool> cancelled_{false};
+            std::atomic<bool> stopping_{false};     ///< Quick stop burst in progress
+
+            /**
+             * @brief Predicate on a node's final state
+             */
+            using StatePredicate = std::function<bool (cia402::State state)>;
+
+            /**
+             * @brief Transition step applied to the nodes currently in a source state
+             */
+            struct Step {
+                std::vector<cia402::State> from;
+                cia402::ControlwordCommand command;
+                cia402::State to;
+            };
+
+            /**
+             * @brief Run task on the selected nodes at once, released by a start gate
+             * @param selected Indices into members_
+             * @param task Work per node
+             * @param policy ALL or ANY completion
+             * @param ok Per-member success, updated for the selected nodes
+             * @param result Accumulates elapsed times and command skew
+             */
+            void run_burst(const std::vector<std::size_t>& selected, const NodeTask& task,
+                GroupWait policy, std::vector<bool>& ok, GroupResult& result);
+
+            /**
+             * @brief Send command to all nodes in the from state and wait for to
+             */
+            void run_step(const Step& step, std::vector<bool>& ok, GroupResult& result);
+
+            /**
+             * @brief Fill per-node states and overall success
+             */
+            GroupResult finish(GroupResult result, const std::vector<bool>& ok,
+                GroupWait policy, std::chrono::steady_clock::time_point start) const;
+
+            /**
+             * @brief Refresh states, then run steps; a node succeeds if done(state)
+             * @param prepare Optional per-node task run first (e.g. fault reset)
+             */
+            GroupResult run_sequence(const char* name, const std::vector<Step>& steps,
+                const StatePredicate& done, const StatePredicate& needs_prepare = nullptr,
+                const NodeTask& prepare = nullptr);
+
+            /**
+             * @brief Empty result with one entry per member
+             */
+            GroupResult begin() const;
+
+            /**
+             * @brief Indices of members still ok and in one of the given states
+             */
+            std::vector<std::size_t> select(const std::vector<bool>& ok,
+                const StatePredicate& predicate) const;
+    };
+
+} // namespace canopen
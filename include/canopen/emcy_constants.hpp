@@ -0,0 +1,109 @@
+/**
+ * @file emcy_constants.hpp
+ * @brief CANopen EMCY (Emergency) Constants and Definitions
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-20
+ *
+ * EMCY (Emergency):
+ * - Produced by a node on 0x080 + node_id when an internal error occurs
+ *   (0x080 itself is SYNC, so node IDs 1-127 map to 0x081-0x0FF)
+ * - 8 bytes: error code (bytes 0-1, little endian), error register 0x1001
+ *   (byte 2), manufacturer specific error field (bytes 3-7)
+ * - Error code 0x0000 ("error reset or no error") tells that the node left
+ *   the error condition
+ *
+ * Error register bits are shared with 0x1001, see cia402::ErrorRegisterBit.
+ *
+ * @see CiA 301 v4.2.0 Section 7.2.7 (Emergency object)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace canopen {
+    namespace emcy {
+
+// =============================================================================
+// COB-IDs
+// =============================================================================
+
+        constexpr uint32_t EMCY_BASE = 0x080;    ///< Emergency (+ node_id, 1-127)
+
+        constexpr uint32_t emcy_cob_id(uint8_t node_id) {
+            return EMCY_BASE + node_id;
+        }
+
+// =============================================================================
+// Frame Layout
+// =============================================================================
+
+        constexpr std::size_t FRAME_LENGTH = 8;
+        constexpr std::size_t MANUFACTURER_LENGTH = 5;   ///< Bytes 3-7
+
+        constexpr uint16_t NO_ERROR = 0x0000;            ///< Error reset / no error
+
+// =============================================================================
+// Error Code Classes (upper byte / nibble of the error code)
+// =============================================================================
+
+/**
+ * @brief Error code classes (CiA 301 Table 21)
+ */
+        enum class ErrorClass : uint8_t {
+            NO_ERROR,
+            GENERIC,            ///< 0x10xx
+            CURRENT,            ///< 0x2xxx
+            VOLTAGE,            ///< 0x3xxx
+            TEMPERATURE,        ///< 0x4xxx
+            HARDWARE,           ///< 0x50xx Device hardware
+            SOFTWARE,           ///< 0x6xxx Device software
+            ADDITIONAL_MODULES, ///< 0x70xx
+            MONITORING,         ///< 0x8xxx (communication, protocol)
+            EXTERNAL,           ///< 0x90xx
+            ADDITIONAL_FUNCTIONS, ///< 0xF0xx
+            DEVICE_SPECIFIC,    ///< 0xFFxx
+            UNKNOWN
+        };
+
+        constexpr ErrorClass classify(uint16_t error_code) {
+            if (error_code == NO_ERROR) return ErrorClass::NO_ERROR;
+            if ((error_code & 0xFF00) == 0xFF00) return ErrorClass::DEVICE_SPECIFIC;
+            if ((error_code & 0xFF00) == 0xF000) return ErrorClass::ADDITIONAL_FUNCTIONS;
+            switch (error_code >> 12) {
+            case 0x1: return ErrorClass::GENERIC;
+            case 0x2: return ErrorClass::CURRENT;
+            case 0x3: return ErrorClass::VOLTAGE;
+            case 0x4: return ErrorClass::TEMPERATURE;
+            case 0x5: return ErrorClass::HARDWARE;
+            case 0x6: return ErrorClass::SOFTWARE;
+            case 0x7: return ErrorClass::ADDITIONAL_MODULES;
+            case 0x8: return ErrorClass::MONITORING;
+            case 0x9: return ErrorClass::EXTERNAL;
+            default: return ErrorClass::UNKNOWN;
+            }
+        }
+
+        inline std::string error_class_to_string(ErrorClass error_class) {
+            switch (error_class) {
+            case ErrorClass::NO_ERROR: return "NO_ERROR";
+            case ErrorClass::GENERIC: return "GENERIC";
+            case ErrorClass::CURRENT: return "CURRENT";
+            case ErrorClass::VOLTAGE: return "VOLTAGE";
+            case ErrorClass::TEMPERATURE: return "TEMPERATURE";
+            case ErrorClass::HARDWARE: return "HARDWARE";
+            case ErrorClass::SOFTWARE: return "SOFTWARE";
+            case ErrorClass::ADDITIONAL_MODULES: return "ADDITIONAL_MODULES";
+            case ErrorClass::MONITORING: return "MONITORING";
+            case ErrorClass::EXTERNAL: return "EXTERNAL";
+            case ErrorClass::ADDITIONAL_FUNCTIONS: return "ADDITIONAL_FUNCTIONS";
+            case ErrorClass::DEVICE_SPECIFIC: return "DEVICE_SPECIFIC";
+            case ErrorClass::UNKNOWN: return "UNKNOWN";
+            }
+            return "UNKNOWN";
+        }
+
+    } // namespace emcy
+} // namespace canopen
@@ -0,0 +1,246 @@
+/**
+ * @file emcy_consumer.hpp
+ * @brief EMCY consumer with per-node error history
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-20
+ *
+ * Decodes the emergency frames (0x080 + node_id) produced by up to 127 nodes
+ * and keeps, for each node, the last HISTORY_SIZE emergencies in a fixed-size
+ * ring. The receive thread is the only writer; readers on any thread copy a
+ * node history without locking (each slot carries a sequence number, a slot
+ * overwritten during the copy is dropped from the result).
+ *
+ * Subscribers are called from the receive thread as soon as the frame is
+ * decoded. CIA402FSM::attach_emcy() subscribes a state machine, so a drive
+ * fault ends a pending transition within one frame time instead of one
+ * statusword poll.
+ *
+ * Usage:
+ * @code
+ * EMCYConsumer emcy(socket);
+ * emcy.subscribe(EMCYConsumer::ALL_NODES, [](const Emergency& e) { ... });
+ * fsm.attach_emcy(emcy);
+ * emcy.start();
+ * for (const auto& e : emcy.history(1)) { ... }
+ * @endcode
+ */
+
+#pragma once
+
+#include "canopen/emcy_constants.hpp"
+#include "canopen/pdo_constants.hpp"
+#include "io/can_socket.hpp"
+#include <linux/can.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace canopen {
+
+/**
+ * @brief One decoded emergency frame
+ */
+    struct Emergency {
+        uint8_t node_id = 0;
+        uint16_t error_code = 0;                ///< Bytes 0-1 (little endian)
+        uint8_t error_register = 0;             ///< Byte 2 (object 0x1001)
+        std::array<uint8_t, emcy::MANUFACTURER_LENGTH> manufacturer{};  ///< Bytes 3-7
+        std::chrono::steady_clock::time_point timestamp;
+
+        /**
+         * @brief Error reset / no error (node left the error condition)
+         */
+        bool is_reset() const { return error_code == emcy::NO_ERROR; }
+
+        emcy::ErrorClass error_class() const { return emcy::classify(error_code); }
+
+        /**
+         * @brief Decode an emergency frame (no COB-ID check)
+         */
+        static Emergency decode(uint8_t node_id, const can_frame& frame,
+            std::chrono::steady_clock::time_point timestamp);
+    };
+
+/**
+ * @class EMCYConsumer
+ * @brief Emergency receiver, history store and dispatcher
+ *
+ * Owns the receive thread of its socket; use a socket dedicated to EMCY (as
+ * for NMTMaster) or feed frames from another loop through process().
+ */
+    class EMCYConsumer {
+        public:
+            using Callback = std::function<void (const Emergency& emergency)>;
+            using SubscriptionId = uint64_t;
+
+            static constexpr uint8_t ALL_NODES = 0;        ///< subscribe() to every node
+            static constexpr std::size_t HISTORY_SIZE = 16; ///< Emergencies kept per node
+
+            /**
+             * @brief Non-atomic snapshot of consumer statistics
+             */
+            struct StatisticsSnapshot {
+                uint64_t received;          ///< Emergencies decoded (resets included)
+                uint64_t resets;            ///< Error code 0x0000
+                uint64_t malformed;         ///< EMCY COB-ID with DLC < 3
+                uint64_t callback_errors;   ///< Exceptions thrown by subscribers
+            };
+
+            /**
+             * @brief Construct consumer
+             * @param socket CAN socket (dedicated when start() is used)
+             * @throws std::runtime_error if the socket is not open
+             */
+            explicit EMCYConsumer(std::shared_ptr<waveshare::ICANSocket> socket);
+
+            /**
+             * @brief Destructor - stops the receive thread
+             */
+            ~EMCYConsumer();
+
+            // Prevent copying (socket is a system resource)
+            EMCYConsumer(const EMCYConsumer&) = delete;
+            EMCYConsumer& operator=(const EMCYConsumer&) = delete;
+
+            // =========================================================================
+            // Lifecycle Management
+            // =========================================================================
+
+            /**
+             * @brief Start receive thread
+             * @return true if running
+             */
+            bool start();
+
+            /**
+             * @brief Stop receive thread
+             */
+            void stop();
+
+            bool is_running() const { return running_.load(); }
+
+            /**
+             * @brief Handle one received frame (for callers running their own loop)
+             *
+             * Must always be called from the same thread, and not combined with
+             * start(): the history rings have a single writer.
+             *
+             * @return true if the frame was an emergency
+             */
+            bool process(const can_frame& frame);
+
+            // =========================================================================
+            // Subscriptions
+            // =========================================================================
+
+            /**
+             * @brief Call back on every emergency of a node (thread-safe)
+             * @param node_id Node to follow, or ALL_NODES
+             * @param callback Called on the receive thread; must not block
+             * @return Identifier for unsubscribe()
+             * @throws std::invalid_argument on invalid node ID
+             */
+            SubscriptionId subscribe(uint8_t node_id, Callback callback);
+
+            /**
+             * @brief Remove a subscription (thread-safe)
+             *
+             * A callback already running on the receive thread may still complete.
+             */
+            void unsubscribe(SubscriptionId id);
+
+            // =========================================================================
+            // History (lock-free, any thread)
+            // =========================================================================
+
+            /**
+             * @brief Last emergencies of a node, oldest first (at most HISTORY_SIZE)
+             */
+            std::vector<Emergency> history(uint8_t node_id) const;
+
+            /**
+             * @brief Most recent emergency of a node, if any
+             */
+            std::optional<Emergency> last_emergency(uint8_t node_id) const;
+
+            /**
+             * @brief Error code of the last emergency unless it was a reset (0 = none)
+             */
+            uint16_t active_error(uint8_t node_id) const;
+
+            bool has_active_error(uint8_t node_id) const { return active_error(node_id) != 0; }
+
+            /**
+             * @brief Error register of the last emergency of a node
+             */
+            uint8_t error_register(uint8_t node_id) const;
+
+            /**
+             * @brief Emergencies received from a node since construction
+             */
+            uint64_t emergency_count(uint8_t node_id) const;
+
+            StatisticsSnapshot get_statistics() const;
+
+        private:
+            /**
+             * @brief Ring slot; sequence is 2 × position + 2 once written,
+             *        odd while being written
+             */
+            struct Slot {
+                std::atomic<uint64_t> sequence{0};
+                std::atomic<uint64_t> payload{0};     ///< Frame bytes 0-7
+                std::atomic<int64_t> timestamp{0};    ///< steady_clock ticks
+            };
+
+            struct NodeHistory {
+                std::atomic<uint64_t> head{0};        ///< Emergencies written
+                std::atomic<uint16_t> active_error{0};
+                std::atomic<uint8_t> error_register{0};
+                std::array<Slot, HISTORY_SIZE> slots;
+            };
+
+            struct Subscriber {
+                SubscriptionId id;
+                uint8_t node_id;
+                Callback callback;
+            };
+
+            using SubscriberList = std::vector<Subscriber>;
+
+            std::shared_ptr<waveshare::ICANSocket> socket_;
+            std::unique_ptr<NodeHistory[]> nodes_;   ///< Indexed by node ID (0 unused)
+
+            std::thread receive_thread_;
+            std::atomic<bool> running_{false};
+
+            // Copy-on-write: writers hold subscribers_mutex_, the receive thread
+            // only loads the current list
+            std::mutex subscribers_mutex_;
+            std::shared_ptr<const SubscriberList> subscribers_;
+            SubscriptionId next_subscription_ = 1;
+
+            // Statistics
+            std::atomic<uint64_t> received_{0};
+            std::atomic<uint64_t> resets_{0};
+            std::atomic<uint64_t> malformed_{0};
+            std::atomic<uint64_t> callback_errors_{0};
+
+            /**
+             * @brief Receive loop running in separate thread
+             */
+            void receive_loop();
+
+            void record(const Emergency& emergency, uint64_t payload);
+            void dispatch(const Emergency& emergency);
+            const NodeHistory* node(uint8_t node_id) const;
+    };
+
+} // namespace canopen
@@ -0,0 +1,289 @@
+/**
+ * @file motion_streamer.hpp
+ * @brief Cyclic synchronous position/velocity (CSP/CSV) setpoint streaming
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-15
+ *
+ * Streams buffered trajectories to CiA 402 drives running in Cyclic
+ * Synchronous Position (mode 8) or Velocity (mode 9):
+ * - Waypoints (time, value, derivative) are buffered per node in a
+ *   fixed-capacity lock-free ring
+ * - Every cycle the setpoint is cubic-Hermite interpolated between the
+ *   surrounding waypoints and packed into a preallocated RPDO payload
+ * - Exactly one RPDO per node per cycle, queued on a SyncScheduler (sent
+ *   right after SYNC) or sent directly when stepping manually
+ * - TPDO feedback is decoded to track following error
+ * - Buffer underruns and cycle timing are recorded
+ *
+ * Usage:
+ * @code
+ * MotionStreamConfig config;
+ * config.mode = cia402::OperationMode::CYCLIC_SYNC_POSITION;
+ * config.period = std::chrono::milliseconds(2);
+ *
+ * MotionStreamer streamer(pdo_manager, dictionary, config);
+ * streamer.add_node(1);
+ * streamer.attach(scheduler);      // one step per SYNC cycle
+ * streamer.push(1, {0.0, 0.0, 0.0});
+ * streamer.push(1, {0.5, 1000.0, 0.0});
+ * streamer.finish(1);
+ * scheduler.start();
+ * @endcode
+ */
+
+#pragma once
+
+#include "canopen/cia402_constants.hpp"
+#include "canopen/object_dictionary.hpp"
+#include "canopen/pdo_codec.hpp"
+#include "canopen/pdo_manager.hpp"
+#include "canopen/sync_scheduler.hpp"
+#include "canopen/timing_histogram.hpp"
+#include <linux/can.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace canopen {
+
+/**
+ * @brief Trajectory waypoint
+ *
+ * Values are in engineering units: raw drive units × the dictionary
+ * scaling_factor of the target object.
+ */
+    struct Waypoint {
+        double time_s;     ///< Time since stream start (strictly increasing)
+        double value;      ///< Position (CSP) or velocity (CSV)
+        double derivative; ///< Velocity (CSP) or acceleration (CSV), per second
+    };
+
+/**
+ * @brief Streaming configuration shared by all nodes of a streamer
+ */
+    struct MotionStreamConfig {
+        /**
+         * @brief CYCLIC_SYNC_POSITION or CYCLIC_SYNC_VELOCITY
+         */
+        cia402::OperationMode mode = cia402::OperationMode::CYCLIC_SYNC_POSITION;
+
+        /**
+         * @brief Cycle period (must match the SYNC period)
+         */
+        std::chrono::microseconds period{1000};
+
+        /**
+         * @brief RPDO carrying the target (and optionally controlword)
+         *
+         * Must map target_position (CSP) or target_velocity (CSV); the constructor
+         * rejects it otherwise. The shipped config/motor_config.json maps neither
+         * in rpdo1, so remap an RPDO for streaming and name it here.
+         */
+        std::string rpdo = "rpdo1";
+
+        /**
+         * @brief TPDO carrying the actual value (empty = feed with update_actual())
+         */
+        std::string feedback_tpdo = "tpdo1";
+
+        /**
+         * @brief Controlword sent with every setpoint if mapped (Enable Operation)
+         */
+        uint16_t controlword = 0x000F;
+
+        /**
+         * @brief Absolute following error that counts as a violation (0 = disabled)
+         */
+        double following_error_limit = 0.0;
+
+        /**
+         * @brief Waypoints buffered per node
+         */
+        std::size_t buffer_capacity = 256;
+    };
+
+/**
+ * @brief Streams interpolated CSP/CSV setpoints, one RPDO per node per cycle
+ *
+ * Threading: push()/finish() from one producer thread per node, step() from
+ * the cycle thread, feed() from the PDO receive thread. Nodes must be added
+ * before streaming starts.
+ */
+    class MotionStreamer {
+        public:
+            /**
+             * @brief Called from the cycle thread when a node's buffer runs dry
+             */
+            using UnderrunCallback = std::function<void (uint8_t node_id)>;
+
+            /**
+             * @brief Non-atomic snapshot of one node's streaming state
+             */
+            struct NodeStatistics {
+                uint64_t setpoints_sent;
+                uint64_t underruns;          ///< Cycles without a waypoint ahead
+                uint64_t following_error_violations;
+                std::size_t buffered;        ///< Waypoints still queued
+                double last_setpoint;
+                double last_actual;
+                double following_error;      ///< Last setpoint - actual
+                double max_following_error;  ///< Largest |following error| seen
+            };
+
+            /**
+             * @brief Non-atomic snapshot of cycle timing
+             */
+            struct CycleStatistics {
+                uint64_t cycles;
+                TimingHistogram::Snapshot interval_jitter; ///< |interval - period| between steps
+                TimingHistogram::Snapshot compute_time;    ///< Time spent in step()
+            };
+
+            /**
+             * @brief Construct streamer
+             * @throws std::invalid_argument if the mode is not CSP/CSV
+             * @throws std::runtime_error if the RPDO/TPDO mapping lacks the
+             *         target/actual object for the mode
+             */
+            MotionStreamer(PDOManager& manager, const ObjectDictionary& dictionary,
+                MotionStreamConfig config = {});
+
+            ~MotionStreamer();
+
+            // Prevent copying
+            MotionStreamer(const MotionStreamer&) = delete;
+            MotionStreamer& operator=(const MotionStreamer&) = delete;
+
+            /**
+             * @brief Add node to the stream (allocates its waypoint buffer)
+             * @throws std::invalid_argument on invalid or duplicate node ID
+             *
+             * Registers the feedback TPDO callback when feedback_tpdo is set.
+             */
+            void add_node(uint8_t node_id);
+
+            /**
+             * @brief Append waypoint to a node's trajectory
+             * @return false if the buffer is full, the node is unknown or time
+             *         does not increase
+             */
+            bool push(uint8_t node_id, const Waypoint& waypoint);
+
+            /**
+             * @brief Mark end of trajectory: hold the last value without underrun
+             */
+            void finish(uint8_t node_id);
+
+            /**
+             * @brief Drive the streamer from a SyncScheduler (one step per cycle)
+             * @throws std::invalid_argument if the scheduler period differs
+             *
+             * Installs the scheduler's cycle callback; call before scheduler.start().
+             */
+            void attach(SyncScheduler& scheduler);
+
+            /**
+             * @brief Compute and emit one cycle of setpoints
+             *
+             * Queued on the attached scheduler, or sent immediately otherwise.
+             */
+            void step();
+
+            /**
+             * @brief Decode feedback TPDO and update following error
+             * @return true if the frame was a feedback TPDO for a streamed node
+             */
+            bool feed(const can_frame& frame);
+
+            /**
+             * @brief Update actual value directly (when feedback is not in a TPDO)
+             */
+            void update_actual(uint8_t node_id, double actual);
+
+            /**
+             * @brief Set underrun notification (call before streaming)
+             */
+            void set_underrun_callback(UnderrunCallback callback) {
+                underrun_callback_ = std::move(callback);
+            }
+
+            NodeStatistics get_statistics(uint8_t node_id) const;
+            CycleStatistics get_cycle_statistics() const;
+
+            /**
+             * @brief Cubic Hermite interpolation between two waypoints
+             */
+            static double interpolate(const Waypoint& from, const Waypoint& to, double t);
+
+        private:
+            /**
+             * @brief Per-node stream state; ring is single-producer/single-consumer
+             */
+            struct Channel {
+                uint8_t node_id = 0;
+                std::vector<Waypoint> ring;          // capacity + 1 slots
+                std::atomic<std::size_t> head{0};    // consumer (cycle thread)
+                std::atomic<std::size_t> tail{0};    // producer
+                std::atomic<bool> finished{false};
+                double last_pushed_time = -1.0;      // producer only
+
+                // Cycle thread state
+                double stream_time = 0.0;
+                bool started = false;
+                bool in_underrun = false;
+                uint8_t payload[pdo::limits::MAX_PDO_DATA_LENGTH] = {};
+
+                // Shared statistics
+                std::atomic<uint64_t> setpoints_sent{0};
+                std::atomic<uint64_t> underruns{0};
+                std::atomic<uint64_t> violations{0};
+                std::atomic<double> last_setpoint{0.0};
+                std::atomic<double> last_actual{0.0};
+                std::atomic<double> following_error{0.0};
+                std::atomic<double> max_following_error{0.0};
+
+                std::size_t size() const;
+            };
+
+            PDOManager& manager_;
+            MotionStreamConfig config_;
+            SyncScheduler* scheduler_ = nullptr;
+            UnderrunCallback underrun_callback_;
+
+            PDOMapping rpdo_;
+            PDOFieldLayout target_;
+            bool has_controlword_ = false;
+            PDOFieldLayout controlword_;
+
+            PDOMapping feedback_;
+            PDOFieldLayout actual_;
+            bool has_feedback_ = false;
+
+            // Shared with the node's feedback callback, which may outlive the streamer
+            std::array<std::shared_ptr<Channel>, pdo::MAX_NODE_ID + 1> channels_{};
+            std::vector<Channel*> active_;
+
+            // Cycle timing (cycle thread only, read via snapshots)
+            std::atomic<uint64_t> cycles_{0};
+            std::chrono::steady_clock::time_point last_step_{};
+            TimingHistogram interval_jitter_;
+            TimingHistogram compute_time_;
+
+            Channel* channel(uint8_t node_id) const;
+
+            /**
+             * @brief Setpoint for the channel's current stream time
+             * @return false if the channel has no data yet
+             */
+            bool next_setpoint(Channel& ch, double& setpoint);
+
+            void emit(Channel& ch, double setpoint);
+            static void record_actual(Channel& ch, double actual, double error_limit);
+    };
+
+} // namespace canopen
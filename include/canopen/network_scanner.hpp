@@ -0,0 +1,202 @@
+/**
+ * @file network_scanner.hpp
+ * @brief Parallel CANopen network discovery over SDO
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-21
+ *
+ * Finds every node of a CANopen network and reads its identity:
+ * 1. Probe: an SDO upload of 0x1018:1 (vendor ID, mandatory on every node)
+ *    is sent to each node ID of the range in one paced burst
+ * 2. Inventory: every node that answered is then asked for device type
+ *    (0x1000), product code, revision and serial number (0x1018:2-4).
+ *    A node has one SDO request in flight at a time (as the protocol
+ *    requires), but all nodes are served at once, so the inventory costs a
+ *    few round trips whatever the number of nodes.
+ *
+ * Responses are matched through a table indexed by the response COB-ID
+ * (0x580 + node_id), so each frame costs one subtraction and one compare of
+ * the multiplexer against the request in flight.
+ *
+ * The scanner only needs a way to send and to receive a frame, so it runs on
+ * an ICANSocket or directly on a USB adapter.
+ *
+ * Usage:
+ * @code
+ * NetworkScanner scanner(socket);
+ * auto result = scanner.scan();
+ * for (const auto& node : result.nodes) {
+ *     std::cout << int(node.node_id) << ": vendor 0x" << std::hex << node.vendor_id << "\n";
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include "canopen/pdo_constants.hpp"
+#include "canopen/sdo_constants.hpp"
+#include "io/can_socket.hpp"
+#include <linux/can.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace canopen {
+
+/**
+ * @brief Network scan configuration
+ */
+    struct NetworkScanConfig {
+        uint8_t first_node = 1;                     ///< First node ID probed
+        uint8_t last_node = pdo::MAX_NODE_ID;       ///< Last node ID probed
+
+        /**
+         * @brief Gap between two probe requests (0 = back to back)
+         *
+         * Keeps the burst from overrunning adapter or node receive queues;
+         * 127 probes at the default take about 25 ms.
+         */
+        std::chrono::microseconds pace{200};
+
+        /**
+         * @brief Wait for an SDO response before giving up on a request
+         */
+        std::chrono::milliseconds response_timeout{100};
+
+        /**
+         * @brief Read device type, product, revision and serial of each node
+         *        (disable to only list the nodes present)
+         */
+        bool read_identity = true;
+    };
+
+/**
+ * @brief Identity of a discovered node
+ */
+    struct NodeIdentity {
+        /**
+         * @brief Identity objects a node answered (bit per Field)
+         */
+        enum Field : uint8_t {
+            DEVICE_TYPE = 0x01,     ///< 0x1000
+            PRODUCT_CODE = 0x02,    ///< 0x1018:2
+            REVISION = 0x04,        ///< 0x1018:3
+            SERIAL_NUMBER = 0x08,   ///< 0x1018:4
+            VENDOR_ID = 0x10        ///< 0x1018:1 (unset if the probe was refused)
+        };
+
+        uint8_t node_id = 0;
+        uint32_t vendor_id = 0;         ///< 0x1018:1 (answer to the probe)
+        uint32_t device_type = 0;
+        uint32_t product_code = 0;
+        uint32_t revision = 0;
+        uint32_t serial_number = 0;
+        uint8_t fields = 0;             ///< Field bits holding a value
+
+        std::chrono::microseconds probe_latency{0};  ///< Probe request → response
+
+        bool has(Field field) const { return (fields & field) != 0; }
+
+        /**
+         * @brief CiA device profile number (low 16 bits of the device type)
+         */
+        uint16_t device_profile() const { return static_cast<uint16_t>(device_type & 0xFFFF); }
+    };
+
+/**
+ * @brief Outcome of a network scan
+ */
+    struct NetworkScanResult {
+        std::vector<NodeIdentity> nodes;    ///< Sorted by node ID
+        std::chrono::microseconds elapsed{0};
+        uint64_t requests_sent = 0;
+        uint64_t responses = 0;             ///< Responses matched to a request
+        uint64_t aborts = 0;                ///< Inventory reads refused by a node
+        uint64_t timeouts = 0;              ///< Inventory reads left unanswered
+        uint64_t ignored = 0;               ///< Frames received that matched no request
+        uint64_t send_errors = 0;           ///< Requests the transport refused
+    };
+
+/**
+ * @class NetworkScanner
+ * @brief SDO-based node discovery and identity inventory
+ *
+ * Not thread-safe; the scan runs on the calling thread. Use a transport no
+ * other component reads from during the scan.
+ */
+    class NetworkScanner {
+        public:
+            /**
+             * @brief Send one frame; false if it could not be queued
+             */
+            using SendFunction = std::function<bool (const can_frame& frame)>;
+
+            /**
+             * @brief Receive one frame, waiting at most timeout; false if none arrived
+             */
+            using ReceiveFunction = std::function<bool (can_frame& frame,
+                std::chrono::microseconds timeout)>;
+
+            /**
+             * @brief Scan through a CAN socket
+             * @throws std::runtime_error if the socket is not open
+             */
+            explicit NetworkScanner(std::shared_ptr<waveshare::ICANSocket> socket);
+
+            /**
+             * @brief Scan through any transport
+             * @throws std::invalid_argument if a function is empty
+             */
+            NetworkScanner(SendFunction send, ReceiveFunction receive);
+
+            /**
+             * @brief Discover nodes and read their identity
+             * @throws std::invalid_argument on an invalid node range
+             */
+            NetworkScanResult scan(const NetworkScanConfig& config = {});
+
+        private:
+            using Clock = std::chrono::steady_clock;
+
+            /**
+             * @brief SDO channel of one node during the scan
+             */
+            struct Channel {
+                bool pending = false;       ///< Request in flight
+                bool present = false;       ///< Answered the probe
+                uint8_t step = 0;           ///< Next inventory read
+                uint16_t index = 0;         ///< Multiplexer of the request in flight
+                uint8_t subindex = 0;
+                Clock::time_point sent;
+                Clock::time_point deadline;
+            };
+
+            /**
+             * @brief Indexed by response COB-ID - 0x580 (i.e. node ID)
+             */
+            using ChannelTable = std::array<Channel, pdo::MAX_NODE_ID + 1>;
+            using IdentityTable = std::array<NodeIdentity, pdo::MAX_NODE_ID + 1>;
+
+            SendFunction send_;
+            ReceiveFunction receive_;
+
+            bool request(Channel& channel, uint8_t node_id, uint16_t index, uint8_t subindex,
+                const NetworkScanConfig& config, NetworkScanResult& result);
+
+            /**
+             * @brief Send the next inventory read of a node, if any is left
+             */
+            void request_next(Channel& channel, uint8_t node_id, const NetworkScanConfig& config,
+                NetworkScanResult& result);
+
+            /**
+             * @brief Match a received frame against the request in flight
+             */
+            void handle_response(const can_frame& frame, ChannelTable& channels,
+                IdentityTable& identities, const NetworkScanConfig& config,
+                NetworkScanResult& result);
+    };
+
+} // namespace canopen
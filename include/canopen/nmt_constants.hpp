@@ -0,0 +1,102 @@
+/**
+ * @file nmt_constants.hpp
+ * @brief CANopen NMT (Network Management) Constants and Definitions
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-17
+ *
+ * NMT (Network Management):
+ * - The master commands node states with a 2-byte frame on COB-ID 0x000
+ * - Nodes report their state by heartbeat (0x700 + node_id, 1 byte), or
+ *   answer an RTR on the same COB-ID when node guarding is used
+ *
+ * @see CiA 301 v4.2.0 Section 7.2.8 (Network management)
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace canopen {
+    namespace nmt {
+
+// =============================================================================
+// COB-IDs
+// =============================================================================
+
+        constexpr uint32_t NMT_COB_ID = 0x000;        ///< NMT module control (master → nodes)
+        constexpr uint32_t HEARTBEAT_BASE = 0x700;    ///< Heartbeat / node guard (+ node_id)
+        constexpr uint8_t BROADCAST = 0;              ///< Node ID addressing all nodes
+
+        /**
+         * @brief Heartbeat / node guard COB-ID for a node
+         */
+        constexpr uint32_t heartbeat_cob_id(uint8_t node_id) {
+            return HEARTBEAT_BASE + node_id;
+        }
+
+// =============================================================================
+// Commands and States
+// =============================================================================
+
+/**
+ * @brief NMT command specifiers (byte 0 of the NMT frame)
+ */
+        enum class Command : uint8_t {
+            START = 0x01,                ///< Enter OPERATIONAL
+            STOP = 0x02,                 ///< Enter STOPPED
+            ENTER_PRE_OPERATIONAL = 0x80,///< Enter PRE-OPERATIONAL
+            RESET_NODE = 0x81,           ///< Application reset
+            RESET_COMMUNICATION = 0x82   ///< Communication reset
+        };
+
+/**
+ * @brief Node states as reported by heartbeat / node guard (bits 0-6)
+ */
+        enum class State : uint8_t {
+            BOOTUP = 0x00,
+            STOPPED = 0x04,
+            OPERATIONAL = 0x05,
+            PRE_OPERATIONAL = 0x7F,
+            UNKNOWN = 0xFF               ///< Not heard from yet
+        };
+
+        constexpr uint8_t STATE_MASK = 0x7F;   ///< State bits of heartbeat/guard byte
+        constexpr uint8_t TOGGLE_BIT = 0x80;   ///< Node guard toggle bit
+
+        /**
+         * @brief Decode heartbeat / node guard byte
+         */
+        inline State decode_state(uint8_t value) {
+            switch (value & STATE_MASK) {
+            case 0x00: return State::BOOTUP;
+            case 0x04: return State::STOPPED;
+            case 0x05: return State::OPERATIONAL;
+            case 0x7F: return State::PRE_OPERATIONAL;
+            default: return State::UNKNOWN;
+            }
+        }
+
+        inline std::string state_to_string(State state) {
+            switch (state) {
+            case State::BOOTUP: return "BOOTUP";
+            case State::STOPPED: return "STOPPED";
+            case State::OPERATIONAL: return "OPERATIONAL";
+            case State::PRE_OPERATIONAL: return "PRE_OPERATIONAL";
+            default: return "UNKNOWN";
+            }
+        }
+
+        inline std::string command_to_string(Command command) {
+            switch (command) {
+            case Command::START: return "START";
+            case Command::STOP: return "STOP";
+            case Command::ENTER_PRE_OPERATIONAL: return "ENTER_PRE_OPERATIONAL";
+            case Command::RESET_NODE: return "RESET_NODE";
+            case Command::RESET_COMMUNICATION: return "RESET_COMMUNICATION";
+            default: return "UNKNOWN";
+            }
+        }
+
+    } // namespace nmt
+} // namespace canopen
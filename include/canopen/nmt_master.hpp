@@ -0,0 +1,282 @@
+/**
+ * @file nmt_master.hpp
+ * @brief NMT master with heartbeat consumer and node guarding
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-17
+ *
+ * Sends NMT module control commands (start, stop, pre-operational, reset)
+ * to single nodes or to the whole network, and watches up to 127 nodes:
+ * - Heartbeat consumer: each heartbeat (0x700 + node) re-arms a deadline of
+ *   consumer_time; monitoring starts with the first heartbeat (CiA 301)
+ * - Node guarding: an RTR is sent every guard_time and the node must answer
+ *   within guard_time × life_time_factor; the toggle bit is checked
+ *
+ * All deadlines and guard requests live in one hierarchical TimerWheel, so
+ * expiry checking costs O(1) per tick whatever the number of nodes. A node
+ * whose deadline passes is reported lost once (its state becomes UNKNOWN) and
+ * reported again through the state callback when it is heard from again.
+ *
+ * Usage:
+ * @code
+ * NMTMaster nmt(socket);
+ * nmt.set_node_lost_callback([](uint8_t node) { ... });
+ * nmt.monitor_heartbeat(1, dictionary);    // heartbeat_producer_ms from config
+ * nmt.monitor_node_guard(2, std::chrono::milliseconds(100), 3);
+ * nmt.start();
+ * nmt.start_node();                        // broadcast START
+ * @endcode
+ */
+
+#pragma once
+
+#include "canopen/nmt_constants.hpp"
+#include "canopen/object_dictionary.hpp"
+#include "canopen/pdo_constants.hpp"
+#include "canopen/timer_wheel.hpp"
+#include "io/can_socket.hpp"
+#include <linux/can.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace canopen {
+
+/**
+ * @class NMTMaster
+ * @brief NMT command producer and node liveness monitor
+ *
+ * Owns the receive/tick thread of its socket; use a socket dedicated to NMT
+ * (as each SDOClient has its own) so no other reader consumes heartbeats.
+ */
+    class NMTMaster {
+        public:
+            /**
+             * @brief Called from the monitor thread when a node misses its deadline
+             */
+            using NodeLostCallback = std::function<void (uint8_t node_id)>;
+
+            /**
+             * @brief Called from the monitor thread when a node's NMT state changes
+             *
+             * A lost node changes to UNKNOWN; boot-up is reported as BOOTUP.
+             */
+            using StateCallback = std::function<void (uint8_t node_id, nmt::State previous,
+                nmt::State current)>;
+
+            /**
+             * @brief Liveness protocol used for a node
+             */
+            enum class MonitorMode : uint8_t {
+                NONE,       ///< State tracked from heartbeats, no deadline
+                HEARTBEAT,  ///< Heartbeat consumer
+                NODE_GUARD  ///< Master polls with RTR
+            };
+
+            /**
+             * @brief Snapshot of one node's monitoring state
+             */
+            struct NodeStatus {
+                MonitorMode mode = MonitorMode::NONE;
+                nmt::State state = nmt::State::UNKNOWN;
+                bool alive = false;
+                uint64_t messages = 0;       ///< Heartbeats / guard responses received
+                uint64_t lost_events = 0;    ///< Deadlines missed
+                uint64_t toggle_errors = 0;  ///< Node guard responses with a wrong toggle bit
+                std::chrono::steady_clock::time_point last_seen{};
+            };
+
+            /**
+             * @brief Construct NMT master
+             * @param socket CAN socket dedicated to NMT traffic
+             * @param tick Timer wheel resolution (bounds detection latency)
+             * @throws std::runtime_error if the socket is not open
+             * @throws std::invalid_argument if tick is not positive
+             */
+            explicit NMTMaster(std::shared_ptr<waveshare::ICANSocket> socket,
+                std::chrono::milliseconds tick = std::chrono::milliseconds(1));
+
+            /**
+             * @brief Destructor - stops monitor thread
+             */
+            ~NMTMaster();
+
+            // Prevent copying
+            NMTMaster(const NMTMaster&) = delete;
+            NMTMaster& operator=(const NMTMaster&) = delete;
+
+            /**
+             * @brief Start receive/tick thread
+             * @return true if running
+             */
+            bool start();
+
+            /**
+             * @brief Stop receive/tick thread
+             */
+            void stop();
+
+            bool is_running() const { return running_.load(); }
+
+            // =========================================================================
+            // NMT Commands
+            // =========================================================================
+
+            /**
+             * @brief Send NMT command
+             * @param command NMT command specifier
+             * @param node_id Target node (1-127) or nmt::BROADCAST
+             * @return true if the frame was sent
+             */
+            bool send_command(nmt::Command command, uint8_t node_id);
+
+            bool start_node(uint8_t node_id = nmt::BROADCAST) {
+                return send_command(nmt::Command::START, node_id);
+            }
+
+            bool stop_node(uint8_t node_id = nmt::BROADCAST) {
+                return send_command(nmt::Command::STOP, node_id);
+            }
+
+            bool enter_pre_operational(uint8_t node_id = nmt::BROADCAST) {
+                return send_command(nmt::Command::ENTER_PRE_OPERATIONAL, node_id);
+            }
+
+            bool reset_node(uint8_t node_id = nmt::BROADCAST) {
+                return send_command(nmt::Command::RESET_NODE, node_id);
+            }
+
+            bool reset_communication(uint8_t node_id = nmt::BROADCAST) {
+                return send_command(nmt::Command::RESET_COMMUNICATION, node_id);
+            }
+
+            /**
+             * @brief Send NMT command to all nodes
+             */
+            bool broadcast(nmt::Command command) { return send_command(command, nmt::BROADCAST); }
+
+            // =========================================================================
+            // Monitoring
+            // =========================================================================
+
+            /**
+             * @brief Consume heartbeats of a node
+             * @param node_id Node ID (1-127)
+             * @param producer_time Node's heartbeat period (0x1017)
+             * @param consumer_time Deadline after each heartbeat (0 = 1.5 × producer_time,
+             *        i.e. loss is reported within one period of the missed heartbeat)
+             * @throws std::invalid_argument on invalid node ID or period
+             */
+            void monitor_heartbeat(uint8_t node_id, std::chrono::milliseconds producer_time,
+                std::chrono::milliseconds consumer_time = std::chrono::milliseconds(0));
+
+            /**
+             * @brief Consume heartbeats using communication_parameters.heartbeat_producer_ms
+             * @throws std::runtime_error if the dictionary has no heartbeat period
+             */
+            void monitor_heartbeat(uint8_t node_id, const ObjectDictionary& dictionary);
+
+            /**
+             * @brief Guard a node with periodic RTR requests
+             * @param node_id Node ID (1-127)
+             * @param guard_time Request period
+             * @param life_time_factor Node is lost after guard_time × factor without reply
+             * @throws std::invalid_argument on invalid node ID, time or factor
+             */
+            void monitor_node_guard(uint8_t node_id, std::chrono::milliseconds guard_time,
+                uint8_t life_time_factor = 3);
+
+            /**
+             * @brief Stop deadline monitoring of a node (state is still tracked)
+             */
+            void stop_monitoring(uint8_t node_id);
+
+            /**
+             * @brief Set node-lost notification (call before start())
+             */
+            void set_node_lost_callback(NodeLostCallback callback) {
+                node_lost_callback_ = std::move(callback);
+            }
+
+            /**
+             * @brief Set state-change notification (call before start())
+             */
+            void set_state_callback(StateCallback callback) {
+                state_callback_ = std::move(callback);
+            }
+
+            NodeStatus get_node_status(uint8_t node_id) const;
+            nmt::State get_node_state(uint8_t node_id) const { return get_node_status(node_id).state; }
+            bool is_node_alive(uint8_t node_id) const { return get_node_status(node_id).alive; }
+
+        private:
+            /**
+             * @brief Per-node monitoring state (guarded by mutex_)
+             */
+            struct Node {
+                NodeStatus status;
+                uint64_t deadline_ticks = 0;   ///< consumer time or guard × life factor
+                uint64_t guard_ticks = 0;      ///< Node guard request period
+                uint8_t expected_toggle = 0;
+                bool armed = false;            ///< Deadline timer running
+            };
+
+            /**
+             * @brief Notification collected under the lock, delivered after it
+             */
+            struct Event {
+                uint8_t node_id;
+                bool lost;
+                nmt::State previous;
+                nmt::State current;
+            };
+
+            std::shared_ptr<waveshare::ICANSocket> socket_;
+            std::chrono::steady_clock::duration tick_;
+            std::chrono::steady_clock::time_point epoch_;
+
+            std::thread monitor_thread_;
+            std::atomic<bool> running_{false};
+
+            NodeLostCallback node_lost_callback_;
+            StateCallback state_callback_;
+
+            mutable std::mutex mutex_;
+            std::array<Node, pdo::MAX_NODE_ID + 1> nodes_{};
+            TimerWheel wheel_{2 * (pdo::MAX_NODE_ID + 1)};
+            std::vector<Event> events_;        ///< Filled under mutex_
+            std::vector<Event> delivering_;    ///< Monitor thread only
+
+            // Timer IDs: two per node
+            static uint32_t deadline_timer(uint8_t node_id) { return 2u * node_id; }
+            static uint32_t guard_timer(uint8_t node_id) { return 2u * node_id + 1; }
+
+            uint64_t now_ticks() const;
+            static void validate_node(uint8_t node_id);
+
+            /**
+             * @brief Receive/tick loop running in separate thread
+             */
+            void monitor_loop();
+
+            /**
+             * @brief Handle heartbeat / guard response (caller holds mutex_)
+             */
+            void handle_frame(const can_frame& frame, uint64_t now);
+
+            /**
+             * @brief Handle expired timer (caller holds mutex_)
+             */
+            void handle_timer(uint32_t id, uint64_t expiry);
+
+            void set_state(uint8_t node_id, nmt::State state);
+            bool send_guard_request(uint8_t node_id);
+            void deliver_events();
+    };
+
+} // namespace canopen
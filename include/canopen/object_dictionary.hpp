@@ -47,6 +47,20 @@ namespace canopen {
                 std::string unit;
 
                 size_t size_bytes() const;  // Returns size in bytes based on datatype
+                bool is_signed() const;     // True for INT8/INT16/INT32/INT64
+            };
+
+            /**
+             * @brief PDO Configuration Entry
+             * Communication and mapping parameters of one PDO, as listed in
+             * the "pdo_configuration" section of the JSON file.
+             */
+            struct PDOConfig {
+                uint16_t cob_id_base;       // # e.g. 0x180 (node ID added at runtime)
+                uint8_t transmission_type;  // # CiA 301 transmission type
+                uint32_t inhibit_time_us;   // # 0 = no inhibit time
+                uint16_t event_timer_ms;    // # 0 = event timer disabled
+                std::vector<std::string> objects; // # mapped objects, in frame order
             };
 
             /**
@@ -71,6 +85,13 @@ namespace canopen {
              */
             bool has_object(const std::string& name) const;
 
+            /**
+             * @brief Get names of all objects
+             *
+             * @return std::vector<std::string> (sorted)
+             */
+            std::vector<std::string> get_object_names() const;
+
             /**
              * @brief Convert typed value to raw bytes (little-endian)
              *
@@ -95,11 +116,38 @@ namespace canopen {
             /**
              * @brief Get the pdo objects object
              *
+             * Uses the ordered "pdo_configuration" list when present, otherwise
+             * collects objects whose pdo_mapping matches (unordered).
+             *
              * @param pdo_name
              * @return std::vector<std::string>
              */
             std::vector<std::string> get_pdo_objects(const std::string& pdo_name) const;
 
+            /**
+             * @brief Check if a PDO configuration entry exists
+             *
+             * @param pdo_name e.g. "tpdo1"
+             * @return true if present in "pdo_configuration"
+             */
+            bool has_pdo_config(const std::string& pdo_name) const;
+
+            /**
+             * @brief Get PDO configuration entry by name
+             *
+             * @param pdo_name e.g. "tpdo1"
+             * @return const PDOConfig&
+             * @throws std::runtime_error if not configured
+             */
+            const PDOConfig& get_pdo_config(const std::string& pdo_name) const;
+
+            /**
+             * @brief Get names of all configured PDOs
+             *
+             * @return std::vector<std::string>
+             */
+            std::vector<std::string> get_pdo_config_names() const;
+
             /**
              * @brief Get motor parameter by name
              *
@@ -108,6 +156,14 @@ namespace canopen {
              */
             double get_motor_param(const std::string& param_name) const;
 
+            /**
+             * @brief Get communication parameter by name (e.g. heartbeat_producer_ms)
+             *
+             * @param param_name
+             * @return double
+             */
+            double get_communication_param(const std::string& param_name) const;
+
             /**
              * @brief Get the Node ID
              *
@@ -128,6 +184,8 @@ namespace canopen {
         private:
             // * Collection of all objects parsed from JSON
             std::unordered_map<std::string, ObjectEntry> objects_;
+            // * PDO communication/mapping parameters from "pdo_configuration"
+            std::unordered_map<std::string, PDOConfig> pdo_configs_;
             nlohmann::json config_;
             uint8_t node_id_;
             std::string device_name_;
@@ -0,0 +1,395 @@
+/**
+ * @file pdo_codec.hpp
+ * @brief Declarative PDO mapping codec (typed structs ↔ PDO frames)
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-12
+ *
+ * Compiles the PDO mappings described in the object dictionary
+ * ("pdo_configuration" + object datatypes/scaling) into flat
+ * offset/width/sign-extension tables, then binds user structs to them:
+ * - TPDO frames are unpacked into typed, scaled structs
+ * - RPDO frames are packed from typed structs
+ * - No allocation and no name lookup per frame (binding happens once)
+ *
+ * Usage:
+ * @code
+ * struct Feedback {
+ *     uint16_t statusword;
+ *     double position;     // counts × scaling_factor
+ * };
+ *
+ * template<> struct canopen::PDOLayout<Feedback> {
+ *     static constexpr const char* pdo = "tpdo1";
+ *     static constexpr auto fields = std::make_tuple(
+ *         pdo_field("statusword", &Feedback::statusword),
+ *         pdo_field("position_actual", &Feedback::position));
+ * };
+ *
+ * PDOCodec codec(pdo_manager, dictionary);
+ * codec.on_tpdo<Feedback>(1, [](const Feedback& fb) { ... });
+ * @endcode
+ */
+
+#pragma once
+
+#include "canopen/object_dictionary.hpp"
+#include "canopen/pdo_constants.hpp"
+#include "canopen/pdo_manager.hpp"
+#include <linux/can.h>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace canopen {
+
+// =============================================================================
+// Compiled Field Layout
+// =============================================================================
+
+/**
+ * @brief Precomputed location of one mapped object inside a PDO payload
+ *
+ * Little-endian, byte-aligned (CiA 301 mapping of the dictionary datatypes).
+ */
+    struct PDOFieldLayout {
+        uint8_t offset = 0;     ///< Byte offset in CAN payload
+        uint8_t width = 0;      ///< Width in bytes (1, 2, 4 or 8)
+        uint8_t sign_shift = 0; ///< 64 - 8×width for signed objects, 0 for unsigned
+        double scale = 1.0;     ///< Scaling factor applied to floating-point members
+
+        /**
+         * @brief Read raw (sign-extended) value from payload
+         * @param data CAN payload (at least offset + width bytes)
+         * @return Raw object value
+         */
+        int64_t decode(const uint8_t* data) const {
+            uint64_t value = 0;
+            for (uint8_t i = 0; i < width; ++i) {
+                value |= static_cast<uint64_t>(data[offset + i]) << (8 * i);
+            }
+            if (sign_shift != 0) {
+                return static_cast<int64_t>(value << sign_shift) >> sign_shift;
+            }
+            return static_cast<int64_t>(value);
+        }
+
+        /**
+         * @brief Write raw value into payload (truncated to width)
+         * @param data CAN payload (at least offset + width bytes)
+         * @param raw Raw object value
+         */
+        void encode(uint8_t* data, int64_t raw) const {
+            uint64_t value = static_cast<uint64_t>(raw);
+            for (uint8_t i = 0; i < width; ++i) {
+                data[offset + i] = static_cast<uint8_t>(value >> (8 * i));
+            }
+        }
+    };
+
+// =============================================================================
+// Compiled PDO Mapping
+// =============================================================================
+
+/**
+ * @class PDOMapping
+ * @brief Flat layout table of one PDO compiled from the object dictionary
+ */
+    class PDOMapping {
+        public:
+            /**
+             * @brief Compile mapping of a configured PDO
+             * @param dictionary Object dictionary with object and PDO definitions
+             * @param pdo_name PDO name (e.g. "tpdo1", "rpdo2")
+             * @return Compiled mapping
+             * @throws std::runtime_error if the PDO name is invalid, an object is
+             *         unknown, or the mapping exceeds 8 bytes
+             */
+            static PDOMapping compile(const ObjectDictionary& dictionary,
+                const std::string& pdo_name);
+
+            /**
+             * @brief Get layout of a mapped object (bind-time lookup)
+             * @param object_name Object dictionary name
+             * @return Field layout
+             * @throws std::runtime_error if object is not mapped in this PDO
+             */
+            const PDOFieldLayout& field(const std::string& object_name) const;
+
+            /**
+             * @brief Check if object is mapped in this PDO
+             */
+            bool contains(const std::string& object_name) const;
+
+            const std::string& name() const { return name_; }
+            pdo::PDOType type() const { return type_; }
+            uint8_t length() const { return length_; }          ///< Payload length in bytes
+            std::size_t field_count() const { return count_; }
+
+            /**
+             * @brief Parse PDO name ("rpdo1".."tpdo4") into PDOType
+             * @throws std::runtime_error if name is not a PDO name
+             */
+            static pdo::PDOType parse_type(const std::string& pdo_name);
+
+        private:
+            std::string name_;
+            pdo::PDOType type_ = pdo::PDOType::TPDO1;
+            std::array<PDOFieldLayout, pdo::limits::MAX_PDO_DATA_LENGTH> fields_{};
+            std::array<std::string, pdo::limits::MAX_PDO_DATA_LENGTH> names_{};
+            std::size_t count_ = 0;
+            uint8_t length_ = 0;
+    };
+
+// =============================================================================
+// Declarative Struct Binding
+// =============================================================================
+
+/**
+ * @brief Binding of one struct member to an object dictionary entry
+ */
+    template<typename Struct, typename Member>
+    struct PDOFieldBinding {
+        const char* object_name;
+        Member Struct::* member;
+    };
+
+/**
+ * @brief Create a struct member binding
+ * @param object_name Object dictionary name (e.g. "statusword")
+ * @param member Pointer to struct member (integral or floating-point)
+ */
+    template<typename Struct, typename Member>
+    constexpr PDOFieldBinding<Struct, Member> pdo_field(const char* object_name,
+        Member Struct::* member) {
+        static_assert(std::is_arithmetic<Member>::value,
+            "PDO struct members must be integral or floating-point");
+        return {object_name, member};
+    }
+
+/**
+ * @brief Layout declaration for a PDO struct (specialise per struct)
+ *
+ * Specialisations provide:
+ * - static constexpr const char* pdo;   // PDO name, e.g. "tpdo1"
+ * - static constexpr auto fields;       // std::tuple of pdo_field(...)
+ */
+    template<typename T>
+    struct PDOLayout;
+
+/**
+ * @class PDOStructCodec
+ * @brief Struct codec bound to a compiled PDO mapping
+ *
+ * Holds one PDOFieldLayout per declared member, resolved at construction.
+ * Pack/unpack are unrolled over the member tuple at compile time.
+ *
+ * Integral members receive the raw object value; floating-point members
+ * receive raw × scaling_factor (and are divided by it when packing).
+ */
+    template<typename T>
+    class PDOStructCodec {
+        using Fields = std::decay_t<decltype(PDOLayout<T>::fields)>;
+        static constexpr std::size_t FIELD_COUNT = std::tuple_size<Fields>::value;
+
+        public:
+            /**
+             * @brief Bind struct members to a compiled mapping
+             * @param mapping Compiled PDO mapping (must match PDOLayout<T>::pdo)
+             * @throws std::runtime_error if a declared object is not mapped
+             */
+            explicit PDOStructCodec(const PDOMapping& mapping)
+                : type_(mapping.type())
+                , length_(mapping.length()) {
+                bind(mapping, std::make_index_sequence<FIELD_COUNT>{});
+            }
+
+            /**
+             * @brief Unpack PDO frame into struct
+             * @param frame Received CAN frame
+             * @param out Destination struct
+             * @return false if the frame is shorter than the mapping
+             */
+            bool unpack(const can_frame& frame, T& out) const {
+                if (frame.can_dlc < length_) {
+                    return false;
+                }
+                unpack_fields(frame.data, out, std::make_index_sequence<FIELD_COUNT>{});
+                return true;
+            }
+
+            /**
+             * @brief Pack struct into PDO frame payload (sets can_dlc)
+             * @param in Source struct
+             * @param frame Destination frame (can_id is left untouched)
+             */
+            void pack(const T& in, can_frame& frame) const {
+                frame.can_dlc = length_;
+                pack_fields(in, frame.data, std::make_index_sequence<FIELD_COUNT>{});
+            }
+
+            pdo::PDOType type() const { return type_; }
+            uint8_t length() const { return length_; }
+
+        private:
+            pdo::PDOType type_;
+            uint8_t length_;
+            std::array<PDOFieldLayout, FIELD_COUNT> layouts_{};
+
+            template<std::size_t ... I>
+            void bind(const PDOMapping& mapping, std::index_sequence<I...>) {
+                ((layouts_[I] = mapping.field(std::get<I>(PDOLayout<T>::fields).object_name)), ...);
+            }
+
+            template<typename Member>
+            static Member from_raw(const PDOFieldLayout& layout, int64_t raw) {
+                if constexpr (std::is_floating_point<Member>::value) {
+                    return static_cast<Member>(static_cast<double>(raw) * layout.scale);
+                } else {
+                    return static_cast<Member>(raw);
+                }
+            }
+
+            template<typename Member>
+            static int64_t to_raw(const PDOFieldLayout& layout, Member value) {
+                if constexpr (std::is_floating_point<Member>::value) {
+                    return static_cast<int64_t>(std::llround(static_cast<double>(value) /
+                        layout.scale));
+                } else {
+                    return static_cast<int64_t>(value);
+                }
+            }
+
+            template<std::size_t ... I>
+            void unpack_fields(const uint8_t* data, T& out, std::index_sequence<I...>) const {
+                ((out.*(std::get<I>(PDOLayout<T>::fields).member) =
+                    from_raw<std::decay_t<decltype(out.*(std::get<I>(PDOLayout<T>::fields).member))>>(
+                    layouts_[I], layouts_[I].decode(data))), ...);
+            }
+
+            template<std::size_t ... I>
+            void pack_fields(const T& in, uint8_t* data, std::index_sequence<I...>) const {
+                (layouts_[I].encode(data, to_raw(layouts_[I],
+                    in.*(std::get<I>(PDOLayout<T>::fields).member))), ...);
+            }
+    };
+
+// =============================================================================
+// PDO Codec (PDOManager front-end)
+// =============================================================================
+
+/**
+ * @class RPDOSender
+ * @brief Typed RPDO sender bound to one node (pack + send, no allocation)
+ */
+    template<typename T>
+    class RPDOSender {
+        public:
+            RPDOSender(PDOManager& manager, uint8_t node_id, PDOStructCodec<T> codec)
+                : manager_(manager), node_id_(node_id), codec_(std::move(codec)) {}
+
+            /**
+             * @brief Pack struct and send RPDO
+             * @return true if sent successfully
+             */
+            bool send(const T& value) const {
+                can_frame frame{};
+                codec_.pack(value, frame);
+                return manager_.send_rpdo(codec_.type(), node_id_, frame.data, frame.can_dlc);
+            }
+
+            uint8_t node_id() const { return node_id_; }
+
+        private:
+            PDOManager& manager_;
+            uint8_t node_id_;
+            PDOStructCodec<T> codec_;
+    };
+
+/**
+ * @class PDOCodec
+ * @brief Compiles all configured PDO mappings and exposes typed callbacks
+ *
+ * All mappings are compiled at construction; typed callbacks and senders
+ * bind their struct layouts once at registration.
+ */
+    class PDOCodec {
+        public:
+            /**
+             * @brief Compile every PDO listed in the dictionary's pdo_configuration
+             * @param manager PDO manager used for registration and sending
+             * @param dictionary Object dictionary
+             * @throws std::runtime_error on invalid mappings
+             */
+            PDOCodec(PDOManager& manager, const ObjectDictionary& dictionary);
+
+            /**
+             * @brief Get compiled mapping by PDO name
+             * @throws std::runtime_error if not configured
+             */
+            const PDOMapping& mapping(const std::string& pdo_name) const;
+
+            /**
+             * @brief Bind struct T to its declared PDO mapping
+             * @return Bound struct codec
+             */
+            template<typename T>
+            PDOStructCodec<T> bind() const {
+                return PDOStructCodec<T>(mapping(PDOLayout<T>::pdo));
+            }
+
+            /**
+             * @brief Register typed TPDO callback
+             * @param node_id CANopen node ID (1-127)
+             * @param callback Called with the unpacked struct on every TPDO
+             *
+             * Frames shorter than the mapping are counted as errors in the
+             * manager statistics and not delivered.
+             */
+            template<typename T>
+            void on_tpdo(uint8_t node_id, std::function<void(const T&)> callback) {
+                PDOStructCodec<T> codec = bind<T>();
+                if (!PDOManager::is_tpdo(codec.type())) {
+                    throw std::runtime_error(std::string("PDOCodec: ") + PDOLayout<T>::pdo +
+                        " is not a TPDO");
+                }
+
+                PDOManager& manager = manager_;
+                manager_.register_tpdo_callback(codec.type(), node_id,
+                    [&manager, node_id, codec, callback = std::move(callback)](
+                        const can_frame& frame) {
+                        T value{};
+                        if (!codec.unpack(frame, value)) {
+                            manager.record_error(node_id);
+                            return;
+                        }
+                        callback(value);
+                    });
+            }
+
+            /**
+             * @brief Create typed RPDO sender for a node
+             * @param node_id CANopen node ID (1-127)
+             */
+            template<typename T>
+            RPDOSender<T> rpdo_sender(uint8_t node_id) const {
+                PDOStructCodec<T> codec = bind<T>();
+                if (!PDOManager::is_rpdo(codec.type())) {
+                    throw std::runtime_error(std::string("PDOCodec: ") + PDOLayout<T>::pdo +
+                        " is not an RPDO");
+                }
+                return RPDOSender<T>(manager_, node_id, std::move(codec));
+            }
+
+        private:
+            PDOManager& manager_;
+            std::array<PDOMapping, 8> mappings_{};     // Indexed by PDOType - 1
+            std::array<bool, 8> configured_{};
+    };
+
+} // namespace canopen
@@ -0,0 +1,117 @@
+/**
+ * @file pdo_configurator.hpp
+ * @brief Startup PDO remapping from the dictionary "pdo_configuration" section
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-13
+ *
+ * Applies the communication and mapping parameters declared in the motor
+ * configuration to each drive using the CiA 301 remap sequence:
+ *
+ * 1. Disable the PDO (COB-ID bit 31 = 1)
+ * 2. Clear the mapping (mapping sub0 = 0)
+ * 3. Write mapping entries (sub1..N)
+ * 4. Set mapping count (sub0 = N)
+ * 5. Write transmission type, inhibit time and event timer
+ * 6. Re-enable the PDO (COB-ID bit 31 = 0)
+ *
+ * Drives shipping different factory mappings thus end up with identical,
+ * densely packed PDOs regardless of firmware version.
+ *
+ * @see CiA 301 v4.2.0 Section 7.5.2.35 - 7.5.2.38
+ */
+
+#pragma once
+
+#include "canopen/object_dictionary.hpp"
+#include "canopen/pdo_constants.hpp"
+#include "canopen/sdo_client.hpp"
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace canopen {
+
+/**
+ * @brief Single SDO write in a PDO remap sequence
+ */
+    struct PDOConfigStep {
+        uint16_t index;
+        uint8_t subindex;
+        uint32_t value;
+        uint8_t size;  ///< Payload size in bytes (1, 2 or 4)
+        bool verify;   ///< Final value expected on read-back
+    };
+
+/**
+ * @brief Applies "pdo_configuration" to drives over SDO
+ *
+ * Sequences are built once from the dictionary at construction. Nodes are
+ * configured concurrently, one thread per SDOClient.
+ *
+ * @note Each SDOClient passed to configure_nodes() must own its socket:
+ *       a shared socket would hand one node's SDO responses to another thread.
+ */
+    class PDOConfigurator {
+        public:
+            /**
+             * @brief Build remap sequences for every configured PDO
+             * @throws std::runtime_error if a mapping is invalid (unknown object,
+             *         more than 8 bytes, unknown PDO name)
+             */
+            explicit PDOConfigurator(const ObjectDictionary& dictionary);
+
+            /**
+             * @brief Build the remap sequence of one PDO for a node
+             * @param dictionary Object dictionary with "pdo_configuration"
+             * @param pdo_name PDO name ("rpdo1" ... "tpdo4")
+             * @param node_id Target node ID (added to the configured COB-ID base)
+             */
+            static std::vector<PDOConfigStep> build_sequence(
+                const ObjectDictionary& dictionary,
+                const std::string& pdo_name,
+                uint8_t node_id
+            );
+
+            /**
+             * @brief Remap all configured PDOs on a single node
+             * @param client SDO client addressing the node
+             * @param verify Read back every final value after writing
+             * @return true if every write (and verification) succeeded
+             */
+            bool configure_node(SDOClient& client, bool verify = true) const;
+
+            /**
+             * @brief Remap all configured PDOs on several nodes in parallel
+             * @param clients One SDO client per node (each with its own socket)
+             * @param verify Read back every final value after writing
+             * @return Per-node result, keyed by node ID
+             */
+            std::map<uint8_t, bool> configure_nodes(
+                const std::vector<SDOClient*>& clients,
+                bool verify = true
+            ) const;
+
+            /**
+             * @brief Names of the PDOs this configurator applies
+             */
+            const std::vector<std::string>& pdo_names() const { return pdo_names_; }
+
+            /**
+             * @brief Per-SDO transfer timeout
+             */
+            void set_timeout(std::chrono::milliseconds timeout) { timeout_ = timeout; }
+
+        private:
+            const ObjectDictionary& dictionary_;
+            std::vector<std::string> pdo_names_;
+            std::chrono::milliseconds timeout_{1000};
+
+            bool apply(SDOClient& client, const std::vector<PDOConfigStep>& steps) const;
+            bool verify(SDOClient& client, const std::vector<PDOConfigStep>& steps) const;
+
+            static std::vector<uint8_t> to_bytes(uint32_t value, uint8_t size);
+    };
+
+} // namespace canopen
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <cstdint>
+#include <cstddef>
 #include <string>
 #include <stdexcept>
 
@@ -190,8 +191,68 @@ namespace canopen {
              * @brief Minimum safe PDO cycle time (milliseconds)
              */
             constexpr uint32_t MIN_CYCLE_MS = 1; // 1000 Hz (theoretical CAN limit)
+
+            /**
+             * @brief Cache line size used to align per-node hot data (bytes)
+             */
+            constexpr std::size_t CACHE_LINE_SIZE = 64;
         } // namespace limits
 
+// =============================================================================
+// PDO Parameter Objects (CiA 301 Section 7.5.2.35 - 7.5.2.38)
+// =============================================================================
+
+        namespace params {
+            constexpr uint16_t RPDO_COMMUNICATION_BASE = 0x1400; ///< RPDO communication parameter
+            constexpr uint16_t RPDO_MAPPING_BASE = 0x1600;       ///< RPDO mapping parameter
+            constexpr uint16_t TPDO_COMMUNICATION_BASE = 0x1800; ///< TPDO communication parameter
+            constexpr uint16_t TPDO_MAPPING_BASE = 0x1A00;       ///< TPDO mapping parameter
+
+            constexpr uint8_t SUB_COUNT = 0;             ///< Number of entries / mapped objects
+            constexpr uint8_t SUB_COB_ID = 1;            ///< COB-ID used by the PDO (UNSIGNED32)
+            constexpr uint8_t SUB_TRANSMISSION_TYPE = 2; ///< Transmission type (UNSIGNED8)
+            constexpr uint8_t SUB_INHIBIT_TIME = 3;      ///< Inhibit time, 100 us units (UNSIGNED16)
+            constexpr uint8_t SUB_EVENT_TIMER = 5;       ///< Event timer, ms (UNSIGNED16)
+
+            /**
+             * @brief COB-ID bit 31: PDO does not exist / is not valid
+             */
+            constexpr uint32_t COB_ID_INVALID = 0x80000000;
+
+            /**
+             * @brief Inhibit time resolution in microseconds
+             */
+            constexpr uint32_t INHIBIT_TIME_UNIT_US = 100;
+
+            /**
+             * @brief Communication parameter index for a PDO (0x1400/0x1800 + n - 1)
+             */
+            inline uint16_t communication_index(PDOType type) {
+                uint8_t raw = static_cast<uint8_t>(type);
+                return raw <= limits::MAX_PDOS_PER_DIRECTION
+                    ? static_cast<uint16_t>(RPDO_COMMUNICATION_BASE + raw - 1)
+                    : static_cast<uint16_t>(TPDO_COMMUNICATION_BASE + raw - 5);
+            }
+
+            /**
+             * @brief Mapping parameter index for a PDO (0x1600/0x1A00 + n - 1)
+             */
+            inline uint16_t mapping_index(PDOType type) {
+                uint8_t raw = static_cast<uint8_t>(type);
+                return raw <= limits::MAX_PDOS_PER_DIRECTION
+                    ? static_cast<uint16_t>(RPDO_MAPPING_BASE + raw - 1)
+                    : static_cast<uint16_t>(TPDO_MAPPING_BASE + raw - 5);
+            }
+
+            /**
+             * @brief Encode a mapping entry: index(16) | subindex(8) | length in bits(8)
+             */
+            constexpr uint32_t mapping_entry(uint16_t index, uint8_t subindex, uint8_t bits) {
+                return (static_cast<uint32_t>(index) << 16) |
+                       (static_cast<uint32_t>(subindex) << 8) | bits;
+            }
+        } // namespace params
+
 // =============================================================================
 // Utility Functions
 // =============================================================================
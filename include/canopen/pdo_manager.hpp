@@ -8,18 +8,20 @@
  * - Routes TPDOs (feedback) from motors to appropriate callbacks
  * - Sends RPDOs (commands) to motors with correct COB-IDs
  * - Single receive thread for all motors (efficient)
- * - Thread-safe operation
+ * - Thread-safe operation (lock-free TPDO dispatch)
  */
 
 #pragma once
 
 #include "canopen/pdo_constants.hpp"
+#include "canopen/timing_histogram.hpp"
 #include "io/can_socket.hpp"
 #include <linux/can.h>
 #include <linux/can/raw.h>
 #include <functional>
 #include <thread>
 #include <atomic>
+#include <array>
 #include <unordered_map>
 #include <vector>
 #include <mutex>
@@ -110,6 +112,28 @@ namespace canopen {
              */
             bool send_rpdo2(uint8_t node_id, const std::vector<uint8_t>& data);
 
+            /**
+             * @brief Send any RPDO (1-4) to motor without allocating
+             * @param type RPDO type (RPDO1..RPDO4)
+             * @param node_id CANopen node ID (1-127)
+             * @param data PDO data payload
+             * @param length Payload length (up to 8 bytes)
+             * @return true if sent successfully
+             *
+             * Only RPDO1/RPDO2 are counted in Statistics.
+             */
+            bool send_rpdo(pdo::PDOType type, uint8_t node_id, const uint8_t* data,
+                uint8_t length);
+
+            /**
+             * @brief Send SYNC message (COB-ID 0x080, no payload)
+             * @return true if sent successfully
+             *
+             * Triggers synchronous TPDO transmission and RPDO actuation on all
+             * nodes configured with a synchronous transmission type.
+             */
+            bool send_sync();
+
             // =========================================================================
             // TPDO Reception (Feedback from Motors)
             // =========================================================================
@@ -142,12 +166,51 @@ namespace canopen {
              */
             void register_tpdo2_callback(uint8_t node_id, TPDOCallback callback);
 
+            /**
+             * @brief Register callback for any TPDO (1-4) from specific motor
+             * @param type TPDO type (TPDO1..TPDO4)
+             * @param node_id CANopen node ID (1-127)
+             * @param callback Function to call when the TPDO is received
+             * @throws std::invalid_argument if type is not a TPDO or node_id is invalid
+             *
+             * Only TPDO1/TPDO2 are counted in Statistics.
+             */
+            void register_tpdo_callback(pdo::PDOType type, uint8_t node_id,
+                TPDOCallback callback);
+
+            /**
+             * @brief Unregister callback for one TPDO of a specific motor
+             * @param type TPDO type (TPDO1..TPDO4)
+             * @param node_id CANopen node ID
+             * @throws std::invalid_argument if type is not a TPDO
+             *
+             * Same completion semantics as unregister_callbacks().
+             */
+            void unregister_tpdo_callback(pdo::PDOType type, uint8_t node_id);
+
             /**
              * @brief Unregister all callbacks for specific motor
              * @param node_id CANopen node ID
+             *
+             * @note A callback already running on the receive thread may still
+             * complete after this returns; it is released once dispatch moves on.
              */
             void unregister_callbacks(uint8_t node_id);
 
+            /**
+             * @brief Check whether a PDO type is a TPDO (motor → host)
+             */
+            static bool is_tpdo(pdo::PDOType type) {
+                return type >= pdo::PDOType::TPDO1 && type <= pdo::PDOType::TPDO4;
+            }
+
+            /**
+             * @brief Check whether a PDO type is an RPDO (host → motor)
+             */
+            static bool is_rpdo(pdo::PDOType type) {
+                return type >= pdo::PDOType::RPDO1 && type <= pdo::PDOType::RPDO4;
+            }
+
             // =========================================================================
             // Statistics & Diagnostics
             // =========================================================================
@@ -155,10 +218,12 @@ namespace canopen {
             /**
              * @brief PDO communication statistics with atomic counters
              *
-             * All counters are atomic for lock-free thread-safe updates.
+             * All counters and timestamps are atomic for lock-free thread-safe
+             * updates. Records are cache-line aligned so that the send path and
+             * the receive thread updating different nodes never share a line.
              * Use get_statistics() to get a non-atomic snapshot.
              */
-            struct Statistics {
+            struct alignas(pdo::limits::CACHE_LINE_SIZE) Statistics {
                 std::atomic<uint64_t> tpdo1_received{0};
                 std::atomic<uint64_t> tpdo2_received{0};
                 std::atomic<uint64_t> rpdo1_sent{0};
@@ -166,11 +231,14 @@ namespace canopen {
                 std::atomic<uint64_t> errors{0};
                 std::atomic<uint64_t> total_latency_us{0}; // Sum for average calculation
                 std::atomic<uint64_t> latency_samples{0}; // Count for average calculation
-                std::chrono::steady_clock::time_point last_tpdo1_time;
-                std::chrono::steady_clock::time_point last_tpdo2_time;
+                std::atomic<std::chrono::steady_clock::rep> last_tpdo1_time{0}; // steady_clock ticks
+                std::atomic<std::chrono::steady_clock::rep> last_tpdo2_time{0}; // steady_clock ticks
+                std::atomic<std::chrono::steady_clock::rep> last_tpdo_time{0}; // any TPDO, ticks
+                std::atomic<std::chrono::steady_clock::rep> pending_request_time{0}; // oldest unanswered RPDO
+                TimingHistogram latency; // RPDO/SYNC → TPDO round trip
 
                 /**
-                 * @brief Reset all counters to zero
+                 * @brief Reset all counters and timestamps to zero
                  */
                 void reset() {
                     tpdo1_received.store(0, std::memory_order_relaxed);
@@ -180,6 +248,11 @@ namespace canopen {
                     errors.store(0, std::memory_order_relaxed);
                     total_latency_us.store(0, std::memory_order_relaxed);
                     latency_samples.store(0, std::memory_order_relaxed);
+                    last_tpdo1_time.store(0, std::memory_order_relaxed);
+                    last_tpdo2_time.store(0, std::memory_order_relaxed);
+                    last_tpdo_time.store(0, std::memory_order_relaxed);
+                    pending_request_time.store(0, std::memory_order_relaxed);
+                    latency.reset();
                 }
 
                 /**
@@ -206,6 +279,11 @@ namespace canopen {
                 uint64_t rpdo2_sent;
                 uint64_t errors;
                 double avg_latency_us;
+                double latency_p50_us;
+                double latency_p90_us;
+                double latency_p99_us;
+                double latency_max_us;
+                TimingHistogram::Snapshot latency;
                 std::chrono::steady_clock::time_point last_tpdo1_time;
                 std::chrono::steady_clock::time_point last_tpdo2_time;
             };
@@ -214,6 +292,12 @@ namespace canopen {
              * @brief Get communication statistics for specific motor
              * @param node_id CANopen node ID
              * @return Non-atomic snapshot of statistics
+             *
+             * Latency is the round trip from a request to the next TPDO of the
+             * same node: from the oldest unanswered RPDO if there is one,
+             * otherwise from the last SYNC if this is the node's first TPDO
+             * since it. Unsolicited TPDOs are not sampled. Percentiles are
+             * bucket upper bounds (see TimingHistogram).
              */
             StatisticsSnapshot get_statistics(uint8_t node_id) const;
 
@@ -223,6 +307,15 @@ namespace canopen {
              */
             void reset_statistics(uint8_t node_id);
 
+            /**
+             * @brief Count a malformed PDO against a node (lock-free)
+             * @param node_id CANopen node ID (ignored if out of range)
+             *
+             * For callbacks that reject a frame on the receive thread without
+             * the cost of throwing into dispatch.
+             */
+            void record_error(uint8_t node_id);
+
             /**
              * @brief Get CAN interface name
              * @return Interface name (e.g., "vcan0")
@@ -265,18 +358,78 @@ namespace canopen {
             // Callback Management
             // =========================================================================
 
-            // Callback registry: COB-ID → callback function
-            std::unordered_map<uint32_t, TPDOCallback> tpdo_callbacks_;
-            mutable std::mutex callback_mutex_;
+            /**
+             * @brief Number of dispatch slots (one per 11-bit COB-ID)
+             */
+            static constexpr std::size_t COB_ID_TABLE_SIZE = CAN_SFF_MASK + 1;
+
+            /**
+             * @brief Callback retired from the dispatch table, awaiting reclamation
+             */
+            struct RetiredCallback {
+                uint64_t dispatch_seq;          ///< dispatch_seq_ observed at retirement
+                std::unique_ptr<TPDOCallback> callback;
+            };
+
+            // Dispatch table: COB-ID → callback. The receive thread does one
+            // acquire load per frame; writers publish a new callback by pointer
+            // swap (RCU-style) and retire the old one instead of deleting it.
+            std::array<std::atomic<TPDOCallback*>, COB_ID_TABLE_SIZE> tpdo_table_{};
+
+            // Dispatch sequence: odd while the receive thread is inside a
+            // callback, even otherwise. Used to decide when retired callbacks
+            // can no longer be referenced by the reader.
+            std::atomic<uint64_t> dispatch_seq_{0};
+
+            // Writer-side state only; never taken on the receive path
+            std::vector<RetiredCallback> retired_callbacks_;
+            std::mutex registry_mutex_;
+
+            /**
+             * @brief Swap callback into the dispatch table (registry_mutex_ held)
+             * @param cob_id 11-bit COB-ID slot
+             * @param callback New callback, or nullptr to clear the slot
+             */
+            void publish_callback(uint32_t cob_id, std::unique_ptr<TPDOCallback> callback);
+
+            /**
+             * @brief Free retired callbacks the receive thread can no longer see
+             * (registry_mutex_ held)
+             */
+            void reclaim_retired_callbacks();
 
             // =========================================================================
             // Statistics Management
             // =========================================================================
 
-            // Statistics per motor: node_id → stats
-            // Mutex only protects map access, not the atomic counters within Statistics
-            std::unordered_map<uint8_t, Statistics> stats_;
-            mutable std::mutex stats_mutex_;
+            // Statistics per motor, indexed directly by node_id (0 is unused).
+            // Fixed storage: no allocation, rehash or lock on the hot path.
+            std::array<Statistics, pdo::MAX_NODE_ID + 1> stats_{};
+
+            // Time of the last SYNC sent (steady_clock ticks, 0 = never)
+            std::atomic<std::chrono::steady_clock::rep> last_sync_time_{0};
+
+            /**
+             * @brief Correlate a received TPDO with its request and record latency
+             * @param stats Node statistics record
+             * @param now Reception time (steady_clock ticks)
+             */
+            void record_latency(Statistics& stats, std::chrono::steady_clock::rep now);
+
+            /**
+             * @brief Get statistics record for node
+             * @param node_id CANopen node ID
+             * @return Pointer to record, or nullptr if node_id is out of range
+             */
+            Statistics* node_stats(uint8_t node_id) {
+                return (node_id >= pdo::MIN_NODE_ID && node_id <= pdo::MAX_NODE_ID)
+                    ? &stats_[node_id] : nullptr;
+            }
+
+            const Statistics* node_stats(uint8_t node_id) const {
+                return (node_id >= pdo::MIN_NODE_ID && node_id <= pdo::MAX_NODE_ID)
+                    ? &stats_[node_id] : nullptr;
+            }
 
             // =========================================================================
             // COB-ID Calculation (CANopen Standard)
@@ -20,6 +20,7 @@
 #include <vector>
 #include <chrono>
 #include <memory>
+#include <mutex>
 
 namespace canopen {
 
@@ -73,6 +74,38 @@ namespace canopen {
                 std::chrono::milliseconds timeout = std::chrono::milliseconds(1000)
             );
 
+            /**
+             * @brief Write raw index/subindex via expedited SDO (blocking with timeout)
+             * @param index Object index
+             * @param subindex Object subindex
+             * @param data Raw bytes to write (1-4 bytes)
+             * @param timeout Maximum wait time for response
+             * @return true if write successful
+             *
+             * Used for communication-profile objects (0x1400-0x1AFF) that are not
+             * part of the motor object dictionary.
+             */
+            bool write_raw(
+                uint16_t index,
+                uint8_t subindex,
+                const std::vector<uint8_t>& data,
+                std::chrono::milliseconds timeout = std::chrono::milliseconds(1000)
+            );
+
+            /**
+             * @brief Read raw index/subindex via expedited SDO (blocking with timeout)
+             * @param index Object index
+             * @param subindex Object subindex
+             * @param timeout Maximum wait time for response
+             * @return Data bytes (length taken from the response size indicator)
+             * @throws std::runtime_error on timeout, abort or invalid response
+             */
+            std::vector<uint8_t> read_raw(
+                uint16_t index,
+                uint8_t subindex,
+                std::chrono::milliseconds timeout = std::chrono::milliseconds(1000)
+            );
+
             /**
              * @brief Type-safe write wrapper
              */
@@ -96,10 +129,16 @@ namespace canopen {
              */
             bool is_open() const { return socket_ && socket_->is_open(); }
 
+            /**
+             * @brief Get target node ID
+             */
+            uint8_t get_node_id() const { return node_id_; }
+
         private:
             std::shared_ptr<waveshare::ICANSocket> socket_;
             const ObjectDictionary& dictionary_;
             uint8_t node_id_;
+            std::mutex transfer_mutex_;             ///< One request/response exchange at a time
 
             // SDO protocol helpers (CiA 301)
             can_frame create_sdo_write_expedited(uint16_t index, uint8_t subindex,
@@ -0,0 +1,173 @@
+/**
+ * @file sdo_constants.hpp
+ * @brief CANopen SDO (Service Data Object) Constants and Definitions
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-19
+ *
+ * SDO:
+ * - Client requests on 0x600 + node_id, server responses on 0x580 + node_id
+ * - Byte 0 carries the command specifier (bits 7-5) and transfer flags
+ * - Expedited transfers carry up to 4 bytes in the initiate frame; larger
+ *   objects use segmented (7 bytes per confirmed frame) or block transfers
+ *   (up to 127 unconfirmed segments per acknowledge)
+ *
+ * @see CiA 301 v4.2.0 Section 7.2.4 (Service data object)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace canopen {
+    namespace sdo {
+
+// =============================================================================
+// COB-IDs
+// =============================================================================
+
+        constexpr uint32_t REQUEST_BASE = 0x600;   ///< Client → server (+ node_id)
+        constexpr uint32_t RESPONSE_BASE = 0x580;  ///< Server → client (+ node_id)
+
+        constexpr uint32_t request_cob_id(uint8_t node_id) {
+            return REQUEST_BASE + node_id;
+        }
+
+        constexpr uint32_t response_cob_id(uint8_t node_id) {
+            return RESPONSE_BASE + node_id;
+        }
+
+// =============================================================================
+// Command Specifiers (byte 0, bits 7-5)
+// =============================================================================
+
+/**
+ * @brief Client command specifiers (ccs)
+ */
+        enum class ClientCommand : uint8_t {
+            DOWNLOAD_SEGMENT = 0,
+            INITIATE_DOWNLOAD = 1,
+            INITIATE_UPLOAD = 2,
+            UPLOAD_SEGMENT = 3,
+            ABORT = 4,
+            BLOCK_UPLOAD = 5,
+            BLOCK_DOWNLOAD = 6
+        };
+
+/**
+ * @brief Server command specifiers (scs)
+ */
+        enum class ServerCommand : uint8_t {
+            UPLOAD_SEGMENT = 0,
+            DOWNLOAD_SEGMENT = 1,
+            INITIATE_UPLOAD = 2,
+            INITIATE_DOWNLOAD = 3,
+            ABORT = 4,
+            BLOCK_DOWNLOAD = 5,
+            BLOCK_UPLOAD = 6
+        };
+
+        constexpr uint8_t command_of(uint8_t byte0) {
+            return byte0 >> 5;
+        }
+
+        constexpr uint8_t to_byte(ServerCommand command) {
+            return static_cast<uint8_t>(static_cast<uint8_t>(command) << 5);
+        }
+
+        constexpr uint8_t to_byte(ClientCommand command) {
+            return static_cast<uint8_t>(static_cast<uint8_t>(command) << 5);
+        }
+
+// =============================================================================
+// Transfer Limits
+// =============================================================================
+
+        constexpr std::size_t EXPEDITED_MAX = 4;     ///< Bytes in an expedited frame
+        constexpr std::size_t SEGMENT_SIZE = 7;      ///< Bytes per segment
+        constexpr uint8_t MAX_BLOCK_SIZE = 127;      ///< Segments per block
+        constexpr uint8_t TOGGLE_BIT = 0x10;         ///< Segmented transfer toggle
+        constexpr uint8_t LAST_SEGMENT = 0x80;       ///< Block transfer "c" bit of seqno byte
+
+// =============================================================================
+// Abort Codes
+// =============================================================================
+
+/**
+ * @brief SDO abort codes (CiA 301 Table 22)
+ */
+        enum class AbortCode : uint32_t {
+            NONE = 0x00000000,                   ///< Not an abort (hooks: accept)
+            TOGGLE_BIT = 0x05030000,             ///< Toggle bit not alternated
+            TIMEOUT = 0x05040000,                ///< SDO protocol timed out
+            COMMAND_SPECIFIER = 0x05040001,      ///< Invalid or unknown command specifier
+            INVALID_BLOCK_SIZE = 0x05040002,     ///< Invalid block size (block mode)
+            INVALID_SEQUENCE = 0x05040003,       ///< Invalid sequence number (block mode)
+            CRC_ERROR = 0x05040004,              ///< CRC error (block mode)
+            OUT_OF_MEMORY = 0x05040005,
+            UNSUPPORTED_ACCESS = 0x06010000,
+            WRITE_ONLY = 0x06010001,             ///< Attempt to read a write-only object
+            READ_ONLY = 0x06010002,              ///< Attempt to write a read-only object
+            NO_OBJECT = 0x06020000,              ///< Object does not exist
+            LENGTH_MISMATCH = 0x06070010,        ///< Data type length does not match
+            LENGTH_TOO_HIGH = 0x06070012,
+            LENGTH_TOO_LOW = 0x06070013,
+            NO_SUBINDEX = 0x06090011,            ///< Sub-index does not exist
+            VALUE_RANGE = 0x06090030,            ///< Value range of parameter exceeded
+            GENERAL = 0x08000000,                ///< General error
+            CANNOT_STORE = 0x08000020,           ///< Data cannot be transferred or stored
+            DEVICE_STATE = 0x08000022            ///< ... because of the present device state
+        };
+
+        constexpr uint32_t to_value(AbortCode code) {
+            return static_cast<uint32_t>(code);
+        }
+
+        inline std::string abort_to_string(AbortCode code) {
+            switch (code) {
+            case AbortCode::NONE: return "NONE";
+            case AbortCode::TOGGLE_BIT: return "TOGGLE_BIT";
+            case AbortCode::TIMEOUT: return "TIMEOUT";
+            case AbortCode::COMMAND_SPECIFIER: return "COMMAND_SPECIFIER";
+            case AbortCode::INVALID_BLOCK_SIZE: return "INVALID_BLOCK_SIZE";
+            case AbortCode::INVALID_SEQUENCE: return "INVALID_SEQUENCE";
+            case AbortCode::CRC_ERROR: return "CRC_ERROR";
+            case AbortCode::OUT_OF_MEMORY: return "OUT_OF_MEMORY";
+            case AbortCode::UNSUPPORTED_ACCESS: return "UNSUPPORTED_ACCESS";
+            case AbortCode::WRITE_ONLY: return "WRITE_ONLY";
+            case AbortCode::READ_ONLY: return "READ_ONLY";
+            case AbortCode::NO_OBJECT: return "NO_OBJECT";
+            case AbortCode::LENGTH_MISMATCH: return "LENGTH_MISMATCH";
+            case AbortCode::LENGTH_TOO_HIGH: return "LENGTH_TOO_HIGH";
+            case AbortCode::LENGTH_TOO_LOW: return "LENGTH_TOO_LOW";
+            case AbortCode::NO_SUBINDEX: return "NO_SUBINDEX";
+            case AbortCode::VALUE_RANGE: return "VALUE_RANGE";
+            case AbortCode::GENERAL: return "GENERAL";
+            case AbortCode::CANNOT_STORE: return "CANNOT_STORE";
+            case AbortCode::DEVICE_STATE: return "DEVICE_STATE";
+            }
+            return "UNKNOWN";
+        }
+
+// =============================================================================
+// Block Transfer CRC
+// =============================================================================
+
+        /**
+         * @brief CRC-16-CCITT (polynomial 0x1021, initial value 0) used by block transfers
+         * @param crc Running CRC (0 to start)
+         */
+        inline uint16_t crc16(const uint8_t* data, std::size_t length, uint16_t crc = 0) {
+            for (std::size_t i = 0; i < length; ++i) {
+                crc ^= static_cast<uint16_t>(data[i] << 8);
+                for (int bit = 0; bit < 8; ++bit) {
+                    crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021)
+                                         : static_cast<uint16_t>(crc << 1);
+                }
+            }
+            return crc;
+        }
+
+    } // namespace sdo
+} // namespace canopen
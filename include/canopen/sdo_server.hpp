@@ -0,0 +1,356 @@
+/**
+ * @file sdo_server.hpp
+ * @brief SDO server exposing an ObjectDictionary on a CAN socket (device side)
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-19
+ *
+ * Lets a Linux application act as a CANopen slave: every object of the
+ * dictionary gets a value, readable and writable by SDO clients according to
+ * its access ("ro", "wo", "rw", "const"). Supported transfers:
+ * - Expedited upload/download (up to 4 bytes)
+ * - Segmented upload/download (7 bytes per confirmed segment)
+ * - Block upload/download (up to 127 segments per acknowledge, CRC-16)
+ *
+ * Lookup is done on a flat array sorted by index/subindex, addressed through
+ * a perfect hash table built when objects are added, so each request costs
+ * one multiplication and one comparison, never a name lookup.
+ *
+ * Read hooks run before an upload (e.g. to refresh a measured value), write
+ * hooks run before a download is stored and can refuse it with an abort code.
+ * Hooks run on the server thread with the server locked: they must work on
+ * the data they are given and must not call back into the server.
+ *
+ * Usage:
+ * @code
+ * ObjectDictionary dict("device_config.json");
+ * SDOServer server(socket, dict);               // node ID from the dictionary
+ * server.set<uint16_t>("statusword", 0x0250);
+ * server.on_write(0x6040, 0, [](uint16_t, uint8_t, const std::vector<uint8_t>& data) {
+ *     return data[0] & 0x80 ? sdo::AbortCode::DEVICE_STATE : sdo::AbortCode::NONE;
+ * });
+ * server.start();
+ * @endcode
+ *
+ * A server embedded in a larger event loop (e.g. a simulated drive) can be
+ * built on a Sender instead of a socket and fed with process().
+ */
+
+#pragma once
+
+#include "canopen/object_dictionary.hpp"
+#include "canopen/sdo_constants.hpp"
+#include "io/can_socket.hpp"
+#include <linux/can.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace canopen {
+
+/**
+ * @class SDOServer
+ * @brief Answers SDO requests addressed to one node from a single event loop
+ *
+ * Owns the receive thread of its socket. Transfers are served one at a time,
+ * as a CANopen SDO channel allows.
+ */
+    class SDOServer {
+        public:
+            /**
+             * @brief Object access rights
+             */
+            enum class Access : uint8_t {
+                RO,     ///< Read only (may change on the device side)
+                WO,     ///< Write only
+                RW,     ///< Read and write
+                CONST   ///< Read only, never changes
+            };
+
+            /**
+             * @brief Called before an object is uploaded
+             * @param data Current value; may be replaced (size must stay valid)
+             * @return AbortCode::NONE to proceed, otherwise the abort sent to the client
+             */
+            using ReadHook = std::function<sdo::AbortCode(uint16_t index, uint8_t subindex,
+                std::vector<uint8_t>& data)>;
+
+            /**
+             * @brief Called before a downloaded value is stored
+             * @return AbortCode::NONE to store, otherwise the abort sent to the client
+             */
+            using WriteHook = std::function<sdo::AbortCode(uint16_t index, uint8_t subindex,
+                const std::vector<uint8_t>& data)>;
+
+            /**
+             * @brief Sends one response frame (used instead of a socket)
+             * @return true if the frame was sent
+             */
+            using Sender = std::function<bool(const can_frame& frame)>;
+
+            /**
+             * @brief Non-atomic snapshot of server statistics
+             */
+            struct StatisticsSnapshot {
+                uint64_t requests;           ///< Frames received on 0x600 + node_id
+                uint64_t expedited;          ///< Completed expedited transfers
+                uint64_t segmented;          ///< Completed segmented transfers
+                uint64_t block;              ///< Completed block transfers
+                uint64_t aborts_sent;
+                uint64_t aborts_received;
+                uint64_t timeouts;           ///< Transfers aborted for client silence
+            };
+
+            /**
+             * @brief Construct server
+             * @param socket CAN socket (dedicated: the server thread reads every frame)
+             * @param dictionary Objects to serve; values start at zero
+             * @param node_id Node ID to answer for (0 = dictionary node_id)
+             * @param timeout Abort a segmented/block transfer after this client silence
+             * @throws std::runtime_error if the socket is not open
+             * @throws std::invalid_argument on invalid node ID
+             */
+            SDOServer(std::shared_ptr<waveshare::ICANSocket> socket,
+                const ObjectDictionary& dictionary, uint8_t node_id = 0,
+                std::chrono::milliseconds timeout = std::chrono::milliseconds(1000));
+
+            /**
+             * @brief Construct server without a socket (process() and check_timeout() only)
+             * @param sender Called for every response frame
+             * @param dictionary Objects to serve; values start at zero
+             * @param node_id Node ID to answer for (0 = dictionary node_id)
+             * @param timeout Abort a segmented/block transfer after this client silence
+             * @throws std::runtime_error if sender is empty
+             * @throws std::invalid_argument on invalid node ID
+             */
+            SDOServer(Sender sender, const ObjectDictionary& dictionary, uint8_t node_id = 0,
+                std::chrono::milliseconds timeout = std::chrono::milliseconds(1000));
+
+            /**
+             * @brief Destructor - stops the server thread
+             */
+            ~SDOServer();
+
+            // Prevent copying (socket is a system resource)
+            SDOServer(const SDOServer&) = delete;
+            SDOServer& operator=(const SDOServer&) = delete;
+
+            // =========================================================================
+            // Lifecycle Management
+            // =========================================================================
+
+            /**
+             * @brief Start server thread
+             * @return true if running (false for a server without socket)
+             */
+            bool start();
+
+            /**
+             * @brief Stop server thread (a transfer in progress is dropped)
+             */
+            void stop();
+
+            bool is_running() const { return running_.load(); }
+
+            /**
+             * @brief Handle one received frame (for callers running their own loop)
+             *
+             * Frames not addressed to this server are ignored; responses are sent
+             * on the socket. Do not combine with start().
+             */
+            void process(const can_frame& frame);
+
+            /**
+             * @brief Abort a stalled transfer (for callers running their own loop)
+             */
+            void check_timeout();
+
+            uint8_t get_node_id() const { return node_id_; }
+
+            // =========================================================================
+            // Objects
+            // =========================================================================
+
+            /**
+             * @brief Add an object outside the dictionary (e.g. a string or domain)
+             * @param index Object index
+             * @param subindex Object subindex
+             * @param access Access rights
+             * @param value Initial value
+             * @param variable_size Accept downloads of any length (otherwise the
+             *        length of value is enforced)
+             * @throws std::invalid_argument if the object already exists
+             */
+            void add_object(uint16_t index, uint8_t subindex, Access access,
+                std::vector<uint8_t> value, bool variable_size = true);
+
+            bool has_object(uint16_t index, uint8_t subindex) const;
+            std::size_t object_count() const;
+
+            /**
+             * @brief Read object value (thread-safe)
+             * @throws std::out_of_range if the object does not exist
+             */
+            std::vector<uint8_t> get_value(uint16_t index, uint8_t subindex) const;
+
+            /**
+             * @brief Write object value, bypassing access rights and hooks (thread-safe)
+             * @throws std::out_of_range if the object does not exist
+             * @throws std::invalid_argument if a fixed-size object gets a different length
+             */
+            void set_value(uint16_t index, uint8_t subindex, const std::vector<uint8_t>& value);
+
+            /**
+             * @brief Type-safe read of a dictionary object by name
+             */
+            template<typename T>
+            T get(const std::string& name) const {
+                const auto& entry = dictionary_.get_object(name);
+                return dictionary_.from_raw<T>(get_value(entry.index, entry.subindex));
+            }
+
+            /**
+             * @brief Type-safe write of a dictionary object by name
+             */
+            template<typename T>
+            void set(const std::string& name, T value) {
+                const auto& entry = dictionary_.get_object(name);
+                set_value(entry.index, entry.subindex, dictionary_.to_raw(value));
+            }
+
+            /**
+             * @brief Install read hook for an object (replaces any previous one)
+             * @throws std::out_of_range if the object does not exist
+             */
+            void on_read(uint16_t index, uint8_t subindex, ReadHook hook);
+            void on_read(const std::string& name, ReadHook hook);
+
+            /**
+             * @brief Install write hook for an object (replaces any previous one)
+             * @throws std::out_of_range if the object does not exist
+             */
+            void on_write(uint16_t index, uint8_t subindex, WriteHook hook);
+            void on_write(const std::string& name, WriteHook hook);
+
+            StatisticsSnapshot get_statistics() const;
+
+        private:
+            /**
+             * @brief One served object (entries_ is sorted by key)
+             */
+            struct Entry {
+                uint32_t key;               ///< index << 8 | subindex
+                Access access;
+                bool variable_size;
+                std::vector<uint8_t> data;
+                ReadHook read_hook;
+                WriteHook write_hook;
+
+                bool readable() const { return access != Access::WO; }
+                bool writable() const { return access == Access::WO || access == Access::RW; }
+            };
+
+            /**
+             * @brief Transfer in progress on the SDO channel
+             */
+            enum class Transfer : uint8_t {
+                NONE,
+                DOWNLOAD,             ///< Segmented download, waiting for segments
+                UPLOAD,               ///< Segmented upload, waiting for segment requests
+                BLOCK_DOWNLOAD,       ///< Receiving block segments
+                BLOCK_DOWNLOAD_END,   ///< Waiting for end of block download
+                BLOCK_UPLOAD_START,   ///< Initiate answered, waiting for start command
+                BLOCK_UPLOAD,         ///< Block sent, waiting for acknowledge
+                BLOCK_UPLOAD_END      ///< End sent, waiting for client confirmation
+            };
+
+            struct TransferState {
+                Transfer type = Transfer::NONE;
+                std::size_t entry = 0;
+                uint16_t index = 0;
+                uint8_t subindex = 0;
+                std::vector<uint8_t> buffer;
+                std::size_t size = 0;         ///< Indicated size (download) / total (upload)
+                bool size_indicated = false;
+                std::size_t offset = 0;       ///< Upload: first byte of the current block
+                uint8_t toggle = 0;
+                uint8_t sequence = 0;         ///< Block download: last good sequence number
+                uint8_t block_size = sdo::MAX_BLOCK_SIZE;
+                uint8_t block_sent = 0;       ///< Block upload: segments in flight
+                bool final_block = false;     ///< Block upload: flight ends with the last segment
+                bool crc = false;
+                std::chrono::steady_clock::time_point deadline;
+            };
+
+            static constexpr uint16_t EMPTY = 0xFFFF;
+
+            static uint32_t key(uint16_t index, uint8_t subindex) {
+                return (static_cast<uint32_t>(index) << 8) | subindex;
+            }
+
+            void load_dictionary();
+
+            std::shared_ptr<waveshare::ICANSocket> socket_;
+            Sender sender_;                 ///< Set instead of socket_
+            const ObjectDictionary& dictionary_;
+            uint8_t node_id_;
+            std::chrono::milliseconds timeout_;
+
+            std::thread server_thread_;
+            std::atomic<bool> running_{false};
+
+            // Guarded by mutex_
+            mutable std::mutex mutex_;
+            std::vector<Entry> entries_;
+            std::vector<uint16_t> table_;   ///< Perfect hash slot → entries_ position
+            uint32_t multiplier_ = 1;
+            unsigned shift_ = 31;
+            TransferState transfer_;
+
+            // Statistics
+            std::atomic<uint64_t> requests_{0};
+            std::atomic<uint64_t> expedited_{0};
+            std::atomic<uint64_t> segmented_{0};
+            std::atomic<uint64_t> block_{0};
+            std::atomic<uint64_t> aborts_sent_{0};
+            std::atomic<uint64_t> aborts_received_{0};
+            std::atomic<uint64_t> timeouts_{0};
+
+            /**
+             * @brief Receive loop running in separate thread
+             */
+            void server_loop();
+
+            // Caller holds mutex_
+            int find(uint16_t index, uint8_t subindex) const;
+            Entry& entry_at(uint16_t index, uint8_t subindex);
+            void insert(Entry entry);
+            void rebuild_index();
+
+            void handle_request(const can_frame& request);
+            void initiate_download(const can_frame& request);
+            void download_segment(const can_frame& request);
+            void initiate_upload(const can_frame& request);
+            void upload_segment(const can_frame& request);
+            void block_download(const can_frame& request);
+            void block_upload(const can_frame& request);
+            void send_upload_block();
+            void expire_transfer();
+
+            sdo::AbortCode check_length(const Entry& entry, std::size_t size) const;
+            sdo::AbortCode read_value(Entry& entry, std::vector<uint8_t>& data);
+            sdo::AbortCode store(Entry& entry, const std::vector<uint8_t>& data);
+
+            void reply(uint8_t command, uint16_t index, uint8_t subindex,
+                const uint8_t* payload = nullptr, std::size_t length = 0);
+            void send_segment(uint8_t command, const uint8_t* payload, std::size_t length);
+            void abort(uint16_t index, uint8_t subindex, sdo::AbortCode code);
+            void arm_timeout();
+    };
+
+} // namespace canopen
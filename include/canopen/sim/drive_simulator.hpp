@@ -0,0 +1,219 @@
+/**
+ * @file drive_simulator.hpp
+ * @brief Event loop simulating a fleet of CiA 402 drives on one CAN socket
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-18
+ *
+ * One thread serves every simulated node of the bus:
+ * - Received frames are dispatched by COB-ID through a 2048-entry table, so
+ *   the cost per frame does not depend on the number of drives
+ * - SDO requests are served by each drive's SDOServer (expedited, segmented
+ *   and block), RPDOs applied, NMT commands and node guard requests obeyed
+ * - SYNC triggers the synchronous TPDOs of all OPERATIONAL drives
+ * - Event-timer TPDOs and heartbeats run on a TimerWheel
+ * - Each tick advances the motor model of every drive
+ *
+ * Usage:
+ * @code
+ * ObjectDictionary dict("motor_config.json");
+ * DriveSimulator sim(socket, dict);
+ * sim.add_drives(1, 100);            // nodes 1..100
+ * sim.start();
+ * @endcode
+ */
+
+#pragma once
+
+#include "canopen/sim/virtual_drive.hpp"
+#include "canopen/timer_wheel.hpp"
+#include "canopen/timing_histogram.hpp"
+#include "io/can_socket.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace canopen {
+    namespace sim {
+
+/**
+ * @brief Simulator configuration
+ */
+        struct SimulatorConfig {
+            /**
+             * @brief Motor model / timer resolution
+             */
+            std::chrono::microseconds tick{1000};
+
+            /**
+             * @brief Drives boot into NMT OPERATIONAL (otherwise PRE-OPERATIONAL)
+             */
+            bool auto_start = true;
+
+            /**
+             * @brief Send a boot-up message for each drive on start()
+             */
+            bool send_bootup = false;
+
+            /**
+             * @brief Maximum frames handled between two ticks (bounds tick latency)
+             */
+            std::size_t rx_budget = 512;
+        };
+
+/**
+ * @class DriveSimulator
+ * @brief Simulates up to 127 drives on one socket from a single event loop
+ */
+        class DriveSimulator {
+            public:
+                /**
+                 * @brief Non-atomic snapshot of simulator statistics
+                 */
+                struct StatisticsSnapshot {
+                    uint64_t frames_received;
+                    uint64_t frames_sent;
+                    uint64_t send_errors;
+                    uint64_t sdo_requests;
+                    uint64_t rpdos_received;
+                    uint64_t syncs_received;
+                    uint64_t tpdos_sent;
+                    uint64_t heartbeats_sent;
+                    uint64_t ticks;
+                    TimingHistogram::Snapshot tick_time;  ///< Motor model + TPDO work per tick
+                };
+
+                /**
+                 * @brief Construct simulator
+                 * @param socket CAN socket the drives live on (vcan or mock)
+                 * @param dictionary Device description shared by all drives
+                 * @param config Loop configuration
+                 * @throws std::runtime_error if the socket is not open
+                 * @throws std::invalid_argument if the tick is not positive
+                 */
+                DriveSimulator(std::shared_ptr<waveshare::ICANSocket> socket,
+                    const ObjectDictionary& dictionary, SimulatorConfig config = {});
+
+                /**
+                 * @brief Destructor - stops event loop
+                 */
+                ~DriveSimulator();
+
+                // Prevent copying
+                DriveSimulator(const DriveSimulator&) = delete;
+                DriveSimulator& operator=(const DriveSimulator&) = delete;
+
+                /**
+                 * @brief Add a drive
+                 * @throws std::invalid_argument on invalid or duplicate node ID
+                 */
+                VirtualDrive& add_drive(uint8_t node_id);
+
+                /**
+                 * @brief Add drives first .. first + count - 1
+                 * @throws std::invalid_argument if the range leaves 1-127
+                 */
+                void add_drives(uint8_t first, std::size_t count);
+
+                std::size_t drive_count() const;
+
+                /**
+                 * @brief Start event loop thread
+                 * @return true if running
+                 */
+                bool start();
+
+                /**
+                 * @brief Stop event loop thread
+                 */
+                void stop();
+
+                bool is_running() const { return running_.load(); }
+
+                /**
+                 * @brief Run a function on a drive with the event loop paused
+                 * @return false if no drive has this node ID
+                 */
+                bool with_drive(uint8_t node_id, const std::function<void(VirtualDrive&)>& fn);
+
+                /**
+                 * @brief Access the shared profile (e.g. to tune the motor model before start)
+                 */
+                DriveProfile& profile() { return profile_; }
+
+                StatisticsSnapshot get_statistics() const;
+
+            private:
+                /**
+                 * @brief What a COB-ID means to the simulator
+                 */
+                enum class Route : uint8_t { NONE, NMT, SYNC, SDO, RPDO, GUARD };
+
+                struct Dispatch {
+                    Route route = Route::NONE;
+                    uint8_t node_id = 0;
+                    uint8_t pdo = 0;       ///< Index into profile rpdos()
+                };
+
+                // Timer IDs: per node, one per TPDO plus the heartbeat
+                static constexpr uint32_t TIMERS_PER_NODE = pdo::limits::MAX_PDOS_PER_DIRECTION + 1;
+                static uint32_t tpdo_timer(uint8_t node_id, std::size_t pdo) {
+                    return node_id * TIMERS_PER_NODE + static_cast<uint32_t>(pdo);
+                }
+                static uint32_t heartbeat_timer(uint8_t node_id) {
+                    return node_id * TIMERS_PER_NODE + pdo::limits::MAX_PDOS_PER_DIRECTION;
+                }
+
+                std::shared_ptr<waveshare::ICANSocket> socket_;
+                DriveProfile profile_;
+                SimulatorConfig config_;
+
+                std::thread loop_thread_;
+                std::atomic<bool> running_{false};
+
+                // Guarded by mutex_ (held by the loop while it processes)
+                mutable std::mutex mutex_;
+                std::array<std::unique_ptr<VirtualDrive>, pdo::MAX_NODE_ID + 1> drives_{};
+                std::vector<VirtualDrive*> active_;             ///< Dense list for per-tick work
+                std::vector<can_frame> sdo_replies_;            ///< Reused for every SDO request
+                std::array<Dispatch, CAN_SFF_MASK + 1> routes_{};
+                TimerWheel wheel_{(pdo::MAX_NODE_ID + 1) * TIMERS_PER_NODE};
+
+                // Statistics (written by the loop thread only)
+                std::atomic<uint64_t> frames_received_{0};
+                std::atomic<uint64_t> frames_sent_{0};
+                std::atomic<uint64_t> send_errors_{0};
+                std::atomic<uint64_t> sdo_requests_{0};
+                std::atomic<uint64_t> rpdos_received_{0};
+                std::atomic<uint64_t> syncs_received_{0};
+                std::atomic<uint64_t> tpdos_sent_{0};
+                std::atomic<uint64_t> heartbeats_sent_{0};
+                std::atomic<uint64_t> ticks_{0};
+                TimingHistogram tick_time_;
+
+                /**
+                 * @brief Event loop running in separate thread
+                 */
+                void loop();
+
+                // Caller holds mutex_
+                void handle_frame(const can_frame& frame);
+                void handle_sync();
+                void handle_tick(uint64_t ticks);
+                void handle_timer(uint32_t id, uint64_t expiry);
+                void schedule_timers(VirtualDrive& drive);
+                void sync_heartbeat_timer(const VirtualDrive& drive, bool restart);
+                void send_tpdo(VirtualDrive& drive, std::size_t pdo);
+                void send_bootup(const VirtualDrive& drive);
+                void send(const can_frame& frame);
+
+                uint64_t ms_to_ticks(uint32_t ms) const;
+        };
+
+    } // namespace sim
+} // namespace canopen
@@ -0,0 +1,309 @@
+/**
+ * @file virtual_drive.hpp
+ * @brief Simulated CiA 402 drive: object storage, SDO/PDO handling, motor model
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-18
+ *
+ * A DriveProfile is compiled once from an ObjectDictionary and shared by every
+ * simulated node: object index/subindex → storage slot, PDO layouts and motor
+ * parameters. Each VirtualDrive then owns a flat array of object values and
+ * an SDOServer whose hooks read and write that array, so SDO transfers of
+ * every kind are served like on a real drive and no lookup is done by name.
+ *
+ * VirtualDrive is not thread-safe; DriveSimulator serializes access to it.
+ */
+
+#pragma once
+
+#include "canopen/cia402_constants.hpp"
+#include "canopen/nmt_constants.hpp"
+#include "canopen/object_dictionary.hpp"
+#include "canopen/pdo_codec.hpp"
+#include "canopen/pdo_constants.hpp"
+#include "canopen/sdo_server.hpp"
+#include <linux/can.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace canopen {
+    namespace sim {
+
+// =============================================================================
+// Identity reported by simulated drives (0x1000, 0x1018)
+// =============================================================================
+
+        constexpr uint32_t DEVICE_TYPE = 0x00020192;    ///< CiA 402 servo drive
+        constexpr uint32_t VENDOR_ID = 0x00005753;      ///< Simulator vendor ("WS")
+        constexpr uint32_t PRODUCT_CODE = 0x00000402;
+        constexpr uint32_t REVISION = 0x00010000;       ///< Serial number is the node ID
+
+/**
+ * @brief First-order motor model parameters
+ */
+        struct MotorModel {
+            double counts_per_rev = 4096.0;       ///< Encoder counts per revolution
+            double max_rpm = 3000.0;              ///< Velocity clamp
+            double acceleration_rpm_s = 10000.0;  ///< Used when 0x6083 is 0
+            double quick_stop_rpm_s = 20000.0;    ///< Used when 0x6085 is 0
+        };
+
+/**
+ * @brief Device description shared by all simulated drives of one type
+ */
+        class DriveProfile {
+            public:
+                /**
+                 * @brief Storage description of one object
+                 */
+                struct Object {
+                    uint16_t index;
+                    uint8_t subindex;
+                    uint8_t size;        ///< Bytes (1, 2, 4 or 8)
+                    bool is_signed;
+                    bool writable;
+                };
+
+                /**
+                 * @brief One mapped object inside a PDO payload
+                 */
+                struct Field {
+                    PDOFieldLayout layout;
+                    uint16_t slot;
+                };
+
+                /**
+                 * @brief Compiled PDO (communication + mapping parameters)
+                 */
+                struct PDO {
+                    pdo::PDOType type;
+                    uint16_t cob_id_base;
+                    uint8_t transmission_type;
+                    uint32_t inhibit_time_us;
+                    uint16_t event_timer_ms;
+                    uint8_t length;
+                    std::array<Field, pdo::limits::MAX_PDO_DATA_LENGTH> fields{};
+                    std::size_t count = 0;
+                };
+
+                static constexpr int NOT_FOUND = -1;
+
+                /**
+                 * @brief Compile profile from an object dictionary
+                 * @param dictionary Objects, PDO configuration and motor_parameters
+                 * @throws std::runtime_error if a PDO mapping is invalid
+                 *
+                 * The CiA 301/402 objects the simulation needs (identity,
+                 * heartbeat, controlword, statusword, modes, position and
+                 * velocity) are added when the dictionary does not list them,
+                 * as are the communication and mapping parameters of every PDO.
+                 * PDO parameters written over SDO are stored and read back but
+                 * do not change the compiled layouts.
+                 */
+                explicit DriveProfile(const ObjectDictionary& dictionary);
+
+                /**
+                 * @brief Storage slot of an object (O(1))
+                 * @return Slot index or NOT_FOUND
+                 */
+                int find(uint16_t index, uint8_t subindex) const {
+                    auto it = slots_.find(key(index, subindex));
+                    return it != slots_.end() ? static_cast<int>(it->second) : NOT_FOUND;
+                }
+
+                /**
+                 * @brief Storage slot of an object that is always present
+                 */
+                uint16_t slot(uint16_t index, uint8_t subindex = 0) const {
+                    return slots_.at(key(index, subindex));
+                }
+
+                const Object& object(std::size_t slot) const { return objects_[slot]; }
+                std::size_t object_count() const { return objects_.size(); }
+
+                const std::vector<PDO>& rpdos() const { return rpdos_; }
+                const std::vector<PDO>& tpdos() const { return tpdos_; }
+
+                /**
+                 * @brief Dictionary the drives' SDO servers are built from
+                 */
+                const ObjectDictionary& dictionary() const { return dictionary_; }
+
+                const MotorModel& motor() const { return motor_; }
+                MotorModel& motor() { return motor_; }
+
+                /**
+                 * @brief Heartbeat period from communication_parameters (0 = off)
+                 */
+                uint16_t heartbeat_ms() const { return heartbeat_ms_; }
+
+            private:
+                ObjectDictionary dictionary_;
+                std::vector<Object> objects_;
+                std::unordered_map<uint32_t, uint16_t> slots_;
+                std::vector<PDO> rpdos_;
+                std::vector<PDO> tpdos_;
+                MotorModel motor_;
+                uint16_t heartbeat_ms_ = 0;
+
+                static uint32_t key(uint16_t index, uint8_t subindex) {
+                    return (static_cast<uint32_t>(index) << 8) | subindex;
+                }
+
+                uint16_t add_object(uint16_t index, uint8_t subindex, uint8_t size,
+                    bool is_signed, bool writable);
+                PDO compile_pdo(const ObjectDictionary& dictionary, const std::string& name);
+                void add_pdo_parameters(pdo::PDOType type);
+        };
+
+/**
+ * @brief One simulated CiA 402 drive
+ */
+        class VirtualDrive {
+            public:
+                /**
+                 * @brief Construct drive in SWITCH_ON_DISABLED
+                 * @param profile Shared profile (must outlive the drive)
+                 * @param node_id CANopen node ID (1-127)
+                 * @param auto_start Boot (and reset) straight into NMT OPERATIONAL,
+                 *        like a drive configured for NMT self-start
+                 * @throws std::invalid_argument on invalid node ID
+                 */
+                VirtualDrive(const DriveProfile& profile, uint8_t node_id,
+                    bool auto_start = true);
+
+                // Prevent copying (the SDO server hooks point at this drive)
+                VirtualDrive(const VirtualDrive&) = delete;
+                VirtualDrive& operator=(const VirtualDrive&) = delete;
+
+                uint8_t node_id() const { return node_id_; }
+
+                // =====================================================================
+                // Protocol
+                // =====================================================================
+
+                /**
+                 * @brief Serve an SDO request (expedited, segmented or block)
+                 * @param request Frame received on 0x600 + node_id
+                 * @param replies Responses (0x580 + node_id) are appended; none for
+                 *        a block download segment, a whole block for a block upload
+                 */
+                void handle_sdo(const can_frame& request, std::vector<can_frame>& replies);
+
+                /**
+                 * @brief Abort an SDO transfer the client left stalled
+                 * @param replies The abort, if any, is appended
+                 */
+                void expire_sdo(std::vector<can_frame>& replies);
+
+                /**
+                 * @brief SDO server of this drive, e.g. to add strings or domains
+                 */
+                SDOServer& sdo_server() { return *sdo_; }
+
+                /**
+                 * @brief Apply a received RPDO (ignored unless OPERATIONAL)
+                 * @param pdo Index into profile().rpdos()
+                 */
+                void handle_rpdo(std::size_t pdo, const can_frame& frame);
+
+                /**
+                 * @brief Apply an NMT command addressed to this node
+                 */
+                void handle_nmt(nmt::Command command);
+
+                /**
+                 * @brief Encode a TPDO from the current object values
+                 * @param pdo Index into profile().tpdos()
+                 */
+                void build_tpdo(std::size_t pdo, can_frame& frame) const;
+
+                /**
+                 * @brief Encode heartbeat (0x700 + node_id)
+                 */
+                void build_heartbeat(can_frame& frame) const;
+
+                /**
+                 * @brief Encode node guard response (state + alternating toggle bit)
+                 */
+                void build_guard_reply(can_frame& frame);
+
+                /**
+                 * @brief Advance the motor model
+                 * @param dt Elapsed time in seconds
+                 */
+                void step(double dt);
+
+                // =====================================================================
+                // Object Access
+                // =====================================================================
+
+                /**
+                 * @brief Read object value
+                 * @throws std::out_of_range if the object does not exist
+                 */
+                int64_t get(uint16_t index, uint8_t subindex = 0) const;
+
+                /**
+                 * @brief Write object value (bypasses access rights, runs write hooks)
+                 * @throws std::out_of_range if the object does not exist
+                 */
+                void set(uint16_t index, uint8_t subindex, int64_t value);
+
+                uint16_t statusword() const { return static_cast<uint16_t>(values_[statusword_]); }
+                uint16_t heartbeat_ms() const { return static_cast<uint16_t>(values_[heartbeat_]); }
+                cia402::State state() const { return state_; }
+                nmt::State nmt_state() const { return nmt_state_; }
+                double position() const { return position_; }  ///< counts
+                double velocity() const { return velocity_; }  ///< rpm
+
+                /**
+                 * @brief Force the drive into FAULT (error register bit 0 set)
+                 */
+                void inject_fault();
+
+                /**
+                 * @brief TPDO bookkeeping kept per drive by the simulator
+                 */
+                struct TPDOState {
+                    uint8_t sync_count = 0;
+                    uint64_t last_sent_tick = 0;
+                    std::array<uint8_t, pdo::limits::MAX_PDO_DATA_LENGTH> last_data{};
+                    bool sent = false;
+                };
+
+                std::array<TPDOState, pdo::limits::MAX_PDOS_PER_DIRECTION> tpdo_state{};
+
+            private:
+                const DriveProfile& profile_;
+                uint8_t node_id_;
+                std::vector<int64_t> values_;
+                cia402::State state_ = cia402::State::SWITCH_ON_DISABLED;
+                nmt::State nmt_state_;
+                uint16_t last_controlword_ = 0;
+                uint8_t guard_toggle_ = 0;
+                bool auto_start_;
+                bool target_reached_ = true;
+                double position_ = 0.0;
+                double velocity_ = 0.0;
+
+                // Slots of the objects the model touches every step
+                uint16_t controlword_, statusword_, mode_, mode_display_;
+                uint16_t position_actual_, velocity_actual_, target_position_, target_velocity_;
+                uint16_t profile_velocity_, profile_acceleration_, quick_stop_deceleration_;
+                uint16_t error_register_, heartbeat_;
+
+                std::unique_ptr<SDOServer> sdo_;
+                std::vector<can_frame>* outbox_ = nullptr;  ///< Set while sdo_ may send
+
+                void serve_objects();
+                void write_slot(std::size_t slot, int64_t value);
+                void apply_controlword(uint16_t controlword);
+                void update_statusword();
+                void reset_objects();
+        };
+
+    } // namespace sim
+} // namespace canopen
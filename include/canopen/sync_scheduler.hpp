@@ -0,0 +1,204 @@
+/**
+ * @file sync_scheduler.hpp
+ * @brief Cyclic SYNC producer and RPDO scheduler
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-14
+ *
+ * Emits SYNC (0x080) at a fixed period and sends the RPDOs queued for the
+ * cycle in the same burst right after it. Cycle deadlines are absolute
+ * CLOCK_MONOTONIC times (clock_nanosleep with TIMER_ABSTIME), so wake-up
+ * error does not accumulate; an optional spin window busy-waits the last
+ * microseconds before the deadline to trade CPU for lower jitter.
+ *
+ * Cycle sequence:
+ * 1. Wait for the absolute deadline
+ * 2. Send SYNC
+ * 3. Send queued RPDOs (latest value per COB-ID)
+ * 4. Invoke the cycle callback (compute and queue next cycle's commands)
+ */
+
+#pragma once
+
+#include "canopen/pdo_constants.hpp"
+#include "canopen/pdo_manager.hpp"
+#include "canopen/timing_histogram.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace canopen {
+
+/**
+ * @brief Cyclic scheduler configuration
+ */
+    struct SyncSchedulerConfig {
+        /**
+         * @brief Cycle period (must be >= pdo::limits::MIN_CYCLE_MS)
+         */
+        std::chrono::microseconds period{pdo::limits::RECOMMENDED_CYCLE_MS * 1000};
+
+        /**
+         * @brief Busy-wait window before each deadline (0 = sleep only)
+         */
+        std::chrono::microseconds spin{0};
+
+        /**
+         * @brief Wake-up lateness counted as a deadline miss (0 = period / 4)
+         */
+        std::chrono::microseconds miss_threshold{0};
+
+        /**
+         * @brief Emit SYNC each cycle (disable to only burst RPDOs)
+         */
+        bool send_sync = true;
+    };
+
+/**
+ * @brief Cyclic SYNC/RPDO scheduler running on its own thread
+ */
+    class SyncScheduler {
+        public:
+            /**
+             * @brief Called once per cycle after the burst, with the cycle number
+             */
+            using CycleCallback = std::function<void (uint64_t cycle)>;
+
+            /**
+             * @brief Non-atomic snapshot of scheduler statistics
+             */
+            struct StatisticsSnapshot {
+                uint64_t cycles;
+                uint64_t sync_sent;
+                uint64_t rpdos_sent;
+                uint64_t send_errors;
+                uint64_t deadline_misses;   ///< Wake-ups later than miss_threshold
+                uint64_t skipped_cycles;    ///< Whole periods lost to overruns
+                TimingHistogram::Snapshot jitter;  ///< Wake-up lateness, every cycle
+                TimingHistogram::Snapshot misses;  ///< Wake-up lateness, missed cycles only
+            };
+
+            /**
+             * @brief Construct scheduler
+             * @param manager PDO manager used to send SYNC and RPDOs
+             * @param config Cycle configuration
+             * @throws std::invalid_argument if the period or spin window is invalid
+             */
+            explicit SyncScheduler(PDOManager& manager, SyncSchedulerConfig config = {});
+
+            /**
+             * @brief Destructor - stops cyclic thread
+             */
+            ~SyncScheduler();
+
+            // Prevent copying
+            SyncScheduler(const SyncScheduler&) = delete;
+            SyncScheduler& operator=(const SyncScheduler&) = delete;
+
+            /**
+             * @brief Start cyclic thread (first cycle one period from now)
+             * @return true if started, false if already running
+             */
+            bool start();
+
+            /**
+             * @brief Stop cyclic thread (returns within one period)
+             */
+            void stop();
+
+            /**
+             * @brief Check if scheduler is running
+             */
+            bool is_running() const { return running_.load(); }
+
+            /**
+             * @brief Queue RPDO for the next cycle's burst
+             * @param type RPDO type (RPDO1..RPDO4)
+             * @param node_id CANopen node ID (1-127)
+             * @param data PDO data payload
+             * @param length Payload length (up to 8 bytes)
+             * @return false if the target or length is invalid
+             *
+             * A later call for the same RPDO and node before the cycle fires
+             * replaces the queued payload (latest value wins).
+             */
+            bool queue_rpdo(pdo::PDOType type, uint8_t node_id, const uint8_t* data,
+                uint8_t length);
+
+            /**
+             * @brief Queue RPDO for the next cycle's burst
+             */
+            bool queue_rpdo(pdo::PDOType type, uint8_t node_id, const std::vector<uint8_t>& data) {
+                if (data.size() > pdo::limits::MAX_PDO_DATA_LENGTH) return false;
+                return queue_rpdo(type, node_id, data.data(), static_cast<uint8_t>(data.size()));
+            }
+
+            /**
+             * @brief Set per-cycle callback (call before start())
+             */
+            void set_cycle_callback(CycleCallback callback) { cycle_callback_ = std::move(callback); }
+
+            /**
+             * @brief Get scheduler statistics
+             */
+            StatisticsSnapshot get_statistics() const;
+
+            /**
+             * @brief Reset counters and histograms
+             */
+            void reset_statistics();
+
+            /**
+             * @brief Get configured period
+             */
+            std::chrono::microseconds period() const { return config_.period; }
+
+        private:
+            /**
+             * @brief RPDO waiting for the next cycle
+             */
+            struct PendingRPDO {
+                pdo::PDOType type;
+                uint8_t node_id;
+                uint8_t length;
+                uint8_t data[pdo::limits::MAX_PDO_DATA_LENGTH];
+            };
+
+            PDOManager& manager_;
+            SyncSchedulerConfig config_;
+            CycleCallback cycle_callback_;
+
+            std::thread cycle_thread_;
+            std::atomic<bool> running_{false};
+
+            // Producer side fills pending_, the cycle swaps it with burst_;
+            // both keep their capacity so the steady state never allocates.
+            std::mutex queue_mutex_;
+            std::vector<PendingRPDO> pending_;
+            std::vector<PendingRPDO> burst_;
+
+            // Statistics (written by the cycle thread only)
+            std::atomic<uint64_t> cycles_{0};
+            std::atomic<uint64_t> sync_sent_{0};
+            std::atomic<uint64_t> rpdos_sent_{0};
+            std::atomic<uint64_t> send_errors_{0};
+            std::atomic<uint64_t> deadline_misses_{0};
+            std::atomic<uint64_t> skipped_cycles_{0};
+            TimingHistogram jitter_;
+            TimingHistogram misses_;
+
+            /**
+             * @brief Cyclic loop running in separate thread
+             */
+            void cycle_loop();
+
+            /**
+             * @brief Send SYNC and queued RPDOs for one cycle
+             */
+            void send_burst();
+    };
+
+} // namespace canopen
@@ -0,0 +1,205 @@
+/**
+ * @file timer_wheel.hpp
+ * @brief Hierarchical timer wheel for many concurrent deadlines
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-17
+ *
+ * Four levels of 64 slots each cover 64^4 ticks. Timers live in intrusive
+ * doubly-linked slot lists indexed by a fixed timer ID, so scheduling,
+ * rescheduling and cancelling are O(1) and never allocate. Advancing one
+ * tick only visits the current level-0 slot; timers on higher levels are
+ * cascaded down when the lower level wraps (amortized O(1) per timer).
+ *
+ * Not thread-safe: the owner serializes access.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace canopen {
+
+/**
+ * @brief Hierarchical timer wheel with a fixed set of timer IDs
+ */
+    class TimerWheel {
+        public:
+            static constexpr std::size_t SLOT_BITS = 6;
+            static constexpr std::size_t SLOTS = std::size_t{1} << SLOT_BITS;
+            static constexpr std::size_t LEVELS = 4;
+
+            /**
+             * @brief Longest delay representable without re-cascading
+             */
+            static constexpr uint64_t MAX_DELTA = (uint64_t{1} << (SLOT_BITS * LEVELS)) - 1;
+
+            /**
+             * @brief Construct wheel
+             * @param capacity Number of timer IDs (0 .. capacity-1)
+             * @param start_tick Initial current tick
+             */
+            explicit TimerWheel(std::size_t capacity, uint64_t start_tick = 0)
+                : entries_(capacity), current_(start_tick) {
+                heads_.fill(NIL);
+            }
+
+            /**
+             * @brief Schedule (or move) a timer to expire at an absolute tick
+             * @throws std::out_of_range if id >= capacity
+             *
+             * A tick at or before the current one fires on the next advance.
+             */
+            void schedule(uint32_t id, uint64_t expiry_tick) {
+                Entry& entry = at(id);
+                if (entry.slot != NIL) {
+                    unlink(id);
+                }
+                entry.expiry = expiry_tick > current_ ? expiry_tick : current_ + 1;
+                insert(id);
+            }
+
+            /**
+             * @brief Cancel a timer (no-op if not scheduled)
+             */
+            void cancel(uint32_t id) {
+                if (at(id).slot != NIL) {
+                    unlink(id);
+                }
+            }
+
+            bool is_scheduled(uint32_t id) const { return at(id).slot != NIL; }
+
+            /**
+             * @brief Expiry tick of a scheduled timer
+             */
+            uint64_t expiry(uint32_t id) const { return at(id).expiry; }
+
+            /**
+             * @brief Advance to an absolute tick, firing every expired timer
+             * @param tick Target tick (ignored if not after the current tick)
+             * @param on_expire Called as on_expire(id, expiry_tick); may
+             *        schedule or cancel any timer, including the one firing
+             * @return Number of timers fired
+             */
+            template<typename F>
+            std::size_t advance(uint64_t tick, F&& on_expire) {
+                std::size_t fired = 0;
+                while (current_ < tick) {
+                    ++current_;
+
+                    // Cascade every level whose lower neighbour wrapped, highest first
+                    std::size_t wrapped = 0;
+                    while (wrapped + 1 < LEVELS && index(current_, wrapped) == 0) {
+                        ++wrapped;
+                    }
+                    for (std::size_t level = wrapped; level >= 1; --level) {
+                        cascade(level, index(current_, level));
+                    }
+
+                    // Everything left in the current level-0 slot is due now
+                    int32_t& head = heads_[index(current_, 0)];
+                    while (head != NIL) {
+                        uint32_t id = static_cast<uint32_t>(head);
+                        uint64_t expiry = entries_[id].expiry;
+                        unlink(id);
+                        on_expire(id, expiry);
+                        ++fired;
+                    }
+                }
+                return fired;
+            }
+
+            /**
+             * @brief Current tick
+             */
+            uint64_t now() const { return current_; }
+
+            /**
+             * @brief Number of timer IDs
+             */
+            std::size_t capacity() const { return entries_.size(); }
+
+        private:
+            static constexpr int32_t NIL = -1;
+            static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+
+            struct Entry {
+                uint64_t expiry = 0;
+                int32_t prev = NIL;
+                int32_t next = NIL;
+                int32_t slot = NIL;     ///< level * SLOTS + index, NIL if idle
+            };
+
+            std::vector<Entry> entries_;
+            std::array<int32_t, LEVELS * SLOTS> heads_{};
+            uint64_t current_;
+
+            static std::size_t index(uint64_t tick, std::size_t level) {
+                return static_cast<std::size_t>((tick >> (SLOT_BITS * level)) & SLOT_MASK);
+            }
+
+            Entry& at(uint32_t id) {
+                if (id >= entries_.size()) throw std::out_of_range("TimerWheel: invalid timer ID");
+                return entries_[id];
+            }
+
+            const Entry& at(uint32_t id) const {
+                if (id >= entries_.size()) throw std::out_of_range("TimerWheel: invalid timer ID");
+                return entries_[id];
+            }
+
+            void insert(uint32_t id) {
+                Entry& entry = entries_[id];
+                uint64_t delta = entry.expiry - current_;
+                uint64_t target = entry.expiry;
+                if (delta > MAX_DELTA) {
+                    // Beyond the wheel: park on the top level, re-cascaded later
+                    target = current_ + MAX_DELTA;
+                    delta = MAX_DELTA;
+                }
+
+                std::size_t level = 0;
+                while (level + 1 < LEVELS && delta >= (uint64_t{1} << (SLOT_BITS * (level + 1)))) {
+                    ++level;
+                }
+
+                int32_t slot = static_cast<int32_t>(level * SLOTS + index(target, level));
+                entry.slot = slot;
+                entry.prev = NIL;
+                entry.next = heads_[slot];
+                if (entry.next != NIL) {
+                    entries_[entry.next].prev = static_cast<int32_t>(id);
+                }
+                heads_[slot] = static_cast<int32_t>(id);
+            }
+
+            void unlink(uint32_t id) {
+                Entry& entry = entries_[id];
+                if (entry.prev != NIL) {
+                    entries_[entry.prev].next = entry.next;
+                } else {
+                    heads_[entry.slot] = entry.next;
+                }
+                if (entry.next != NIL) {
+                    entries_[entry.next].prev = entry.prev;
+                }
+                entry.prev = entry.next = entry.slot = NIL;
+            }
+
+            void cascade(std::size_t level, std::size_t slot_index) {
+                int32_t id = heads_[level * SLOTS + slot_index];
+                heads_[level * SLOTS + slot_index] = NIL;
+                while (id != NIL) {
+                    int32_t next = entries_[id].next;
+                    entries_[id].slot = NIL;
+                    insert(static_cast<uint32_t>(id));
+                    id = next;
+                }
+            }
+    };
+
+} // namespace canopen
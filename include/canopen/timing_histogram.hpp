@@ -0,0 +1,145 @@
+/**
+ * @file timing_histogram.hpp
+ * @brief Fixed-memory, lock-free histogram for timing measurements
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-14
+ *
+ * Buckets follow a 1-2-5 series from 1 µs to 1 s plus an overflow bucket.
+ * Recording is a handful of relaxed atomic operations and never allocates,
+ * so it is safe to call from the cyclic and receive threads.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace canopen {
+
+/**
+ * @brief Lock-free histogram of durations in nanoseconds
+ */
+    class TimingHistogram {
+        public:
+            /**
+             * @brief Bucket upper bounds (inclusive) in nanoseconds
+             */
+            static constexpr std::array<uint64_t, 19> BOUNDS_NS = {
+                1'000, 2'000, 5'000,
+                10'000, 20'000, 50'000,
+                100'000, 200'000, 500'000,
+                1'000'000, 2'000'000, 5'000'000,
+                10'000'000, 20'000'000, 50'000'000,
+                100'000'000, 200'000'000, 500'000'000,
+                1'000'000'000
+            };
+
+            /**
+             * @brief Number of buckets (bounds + overflow)
+             */
+            static constexpr std::size_t BUCKET_COUNT = BOUNDS_NS.size() + 1;
+
+            /**
+             * @brief Non-atomic copy of the histogram
+             */
+            struct Snapshot {
+                std::array<uint64_t, BUCKET_COUNT> buckets{};
+                uint64_t count = 0;
+                uint64_t sum_ns = 0;
+                uint64_t max_ns = 0;
+
+                /**
+                 * @brief Mean of recorded samples in nanoseconds (0 if empty)
+                 */
+                double mean_ns() const {
+                    return count ? static_cast<double>(sum_ns) / static_cast<double>(count) : 0.0;
+                }
+
+                /**
+                 * @brief Upper bound of the bucket containing the given percentile
+                 * @param p Percentile in [0, 100]
+                 * @return Bound in nanoseconds (max_ns for the overflow bucket, 0 if empty)
+                 */
+                uint64_t percentile_ns(double p) const {
+                    if (count == 0) return 0;
+                    uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(count));
+                    if (rank >= count) rank = count - 1;
+
+                    uint64_t seen = 0;
+                    for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+                        seen += buckets[i];
+                        if (seen > rank) {
+                            uint64_t bound = i < BOUNDS_NS.size() ? BOUNDS_NS[i] : max_ns;
+                            return bound < max_ns ? bound : max_ns;
+                        }
+                    }
+                    return max_ns;
+                }
+            };
+
+            /**
+             * @brief Record one sample
+             */
+            void record(uint64_t ns) {
+                buckets_[bucket_for(ns)].fetch_add(1, std::memory_order_relaxed);
+                count_.fetch_add(1, std::memory_order_relaxed);
+                sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+
+                uint64_t prev = max_ns_.load(std::memory_order_relaxed);
+                while (ns > prev &&
+                    !max_ns_.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+                }
+            }
+
+            /**
+             * @brief Copy current values (buckets may be mutually inconsistent by a
+             * few in-flight samples)
+             */
+            Snapshot snapshot() const {
+                Snapshot snap;
+                for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+                    snap.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+                }
+                snap.count = count_.load(std::memory_order_relaxed);
+                snap.sum_ns = sum_ns_.load(std::memory_order_relaxed);
+                snap.max_ns = max_ns_.load(std::memory_order_relaxed);
+                return snap;
+            }
+
+            /**
+             * @brief Number of recorded samples
+             */
+            uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+            /**
+             * @brief Clear all buckets
+             */
+            void reset() {
+                for (auto& bucket : buckets_) {
+                    bucket.store(0, std::memory_order_relaxed);
+                }
+                count_.store(0, std::memory_order_relaxed);
+                sum_ns_.store(0, std::memory_order_relaxed);
+                max_ns_.store(0, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Bucket index for a sample
+             */
+            static std::size_t bucket_for(uint64_t ns) {
+                for (std::size_t i = 0; i < BOUNDS_NS.size(); ++i) {
+                    if (ns <= BOUNDS_NS[i]) return i;
+                }
+                return BOUNDS_NS.size();
+            }
+
+        private:
+            std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_{};
+            std::atomic<uint64_t> count_{0};
+            std::atomic<uint64_t> sum_ns_{0};
+            std::atomic<uint64_t> max_ns_{0};
+    };
+
+} // namespace canopen
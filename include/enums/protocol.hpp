@@ -392,6 +392,46 @@ namespace waveshare {
         }
     }
 
+    /**
+     * @brief Converts a CANBaud enum value to its bit rate.
+     * @param baud The CANBaud enum value
+     * @return int Bit rate in bits per second
+     */
+    constexpr int canbaud_to_int(CANBaud baud) {
+        switch (baud) {
+        case CANBaud::BAUD_5K:   return 5000;
+        case CANBaud::BAUD_10K:  return 10000;
+        case CANBaud::BAUD_20K:  return 20000;
+        case CANBaud::BAUD_50K:  return 50000;
+        case CANBaud::BAUD_100K: return 100000;
+        case CANBaud::BAUD_125K: return 125000;
+        case CANBaud::BAUD_200K: return 200000;
+        case CANBaud::BAUD_250K: return 250000;
+        case CANBaud::BAUD_400K: return 400000;
+        case CANBaud::BAUD_500K: return 500000;
+        case CANBaud::BAUD_800K: return 800000;
+        case CANBaud::BAUD_1M:   return 1000000;
+        }
+        return 1000000;
+    }
+
+    /**
+     * @brief Bits a classic CAN data frame occupies on the bus, worst case
+     *
+     * SOF, arbitration, control, data, CRC, delimiters, ACK, EOF and the
+     * 3-bit intermission, plus the worst-case stuff bits over the stuffed
+     * region (one every 4 bits after the first 5).
+     *
+     * @param dlc Data length (0-8)
+     * @param extended True for a 29-bit identifier
+     * @return std::uint32_t Frame length in bit times
+     */
+    constexpr std::uint32_t can_frame_bits(std::uint8_t dlc, bool extended) {
+        std::uint32_t data_bits = 8u * dlc;
+        std::uint32_t stuffed = (extended ? 54u : 34u) + data_bits;
+        return (extended ? 67u : 47u) + data_bits + (stuffed - 1) / 4;
+    }
+
     /**
      * @brief Converts a boolean into the AutoRTX enum value.
      *
@@ -0,0 +1,71 @@
+/**
+ * @file capture_file.hpp
+ * @brief Memory-mapped, read-only view of a binary capture
+ * @version 1.0
+ * @date 2025-11-24
+ *
+ * The file is mapped, not read: records are accessed in place, the page
+ * cache does the buffering, and a multi-GB capture costs no heap memory.
+ * A trailing partial record (capture interrupted mid-write) is ignored.
+ *
+ * Usage:
+ * @code
+ * CaptureFile capture("bus.wscap");
+ * for (std::size_t i = 0; i < capture.size(); ++i) {
+ *     const CaptureRecord& record = capture[i];
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "capture_format.hpp"
+
+namespace waveshare {
+
+    /**
+     * @class CaptureFile
+     * @brief Read-only mapping of a file written in CaptureFormat::BINARY
+     *
+     * Immutable once opened; safe to read from several threads.
+     */
+    class CaptureFile {
+        public:
+            /**
+             * @brief Open and map a capture
+             * @param path Capture file
+             * @throws std::runtime_error if the file cannot be opened or mapped,
+             *         or does not start with a valid capture header
+             */
+            explicit CaptureFile(const std::string& path);
+
+            ~CaptureFile();
+
+            CaptureFile(const CaptureFile&) = delete;
+            CaptureFile& operator=(const CaptureFile&) = delete;
+
+            /**
+             * @brief Number of complete records
+             */
+            std::size_t size() const { return count_; }
+
+            bool empty() const { return count_ == 0; }
+
+            const CaptureRecord* records() const { return records_; }
+
+            const CaptureRecord& operator[](std::size_t index) const { return records_[index]; }
+
+            const std::string& path() const { return path_; }
+
+        private:
+            std::string path_;
+            void* map_ = nullptr;
+            std::size_t length_ = 0;
+            const CaptureRecord* records_ = nullptr;
+            std::size_t count_ = 0;
+    };
+
+}  // namespace waveshare
@@ -0,0 +1,68 @@
+/**
+ * @file capture_format.hpp
+ * @brief On-disk layout of binary CAN captures
+ * @version 1.0
+ * @date 2025-11-23
+ *
+ * A capture is a 16-byte file header followed by fixed-size records, so
+ * record N sits at offset 16 + N × record_size and a file can be split
+ * anywhere on a record boundary. All fields are little-endian.
+ *
+ * | Offset | Size | Field                                         |
+ * |--------|------|-----------------------------------------------|
+ * | 0      | 8    | Magic "WSCAPv1\0"                             |
+ * | 8      | 4    | Record size (24)                              |
+ * | 12     | 4    | Flags (reserved, 0)                           |
+ *
+ * Record:
+ *
+ * | Offset | Size | Field                                         |
+ * |--------|------|-----------------------------------------------|
+ * | 0      | 8    | Timestamp, microseconds since the Unix epoch  |
+ * | 8      | 4    | CAN ID with SocketCAN EFF/RTR flags           |
+ * | 12     | 1    | DLC                                           |
+ * | 13     | 3    | Reserved (0)                                  |
+ * | 16     | 8    | Data (unused bytes are 0)                     |
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace waveshare {
+
+    /**
+     * @brief Output format of a capture
+     */
+    enum class CaptureFormat {
+        BINARY,     ///< CaptureFileHeader + CaptureRecords
+        CANDUMP     ///< Text lines as written by candump -L
+    };
+
+    /**
+     * @brief Header at the start of a binary capture
+     */
+    struct CaptureFileHeader {
+        char magic[8];
+        std::uint32_t record_size;
+        std::uint32_t flags;
+    };
+
+    /**
+     * @brief One captured frame
+     */
+    struct CaptureRecord {
+        std::uint64_t timestamp_us;
+        std::uint32_t can_id;
+        std::uint8_t dlc;
+        std::uint8_t reserved[3];
+        std::uint8_t data[8];
+    };
+
+    static_assert(sizeof(CaptureFileHeader) == 16, "CaptureFileHeader must be 16 bytes");
+    static_assert(sizeof(CaptureRecord) == 24, "CaptureRecord must be 24 bytes");
+
+    constexpr char CAPTURE_MAGIC[8] = {'W', 'S', 'C', 'A', 'P', 'v', '1', '\0'};
+
+}  // namespace waveshare
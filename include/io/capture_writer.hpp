@@ -0,0 +1,148 @@
+/**
+ * @file capture_writer.hpp
+ * @brief Buffered capture output on a dedicated writer thread
+ * @version 1.0
+ * @date 2025-11-23
+ *
+ * The receive loop only formats records into large in-memory buffers; full
+ * buffers are handed to a writer thread, so a slow disk, pipe or terminal
+ * never stalls the reads from the adapter. When every buffer is waiting to
+ * be written the record is dropped and counted instead of blocking.
+ *
+ * Usage:
+ * @code
+ * int fd = ::open("bus.wscap", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+ * CaptureWriter writer(fd, CaptureFormat::BINARY);
+ * writer.write(frame, timestamp_us);
+ * writer.stop();     // Flushes and joins the writer thread
+ * @endcode
+ */
+
+#pragma once
+
+#include <linux/can.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "capture_format.hpp"
+
+namespace waveshare {
+
+    /**
+     * @brief Capture writer counters
+     */
+    struct CaptureStatistics {
+        std::uint64_t records = 0;          ///< Records accepted
+        std::uint64_t dropped = 0;          ///< Records dropped, no free buffer
+        std::uint64_t bytes_written = 0;    ///< Bytes the writer thread wrote
+        std::uint64_t write_errors = 0;     ///< Failed write() calls
+    };
+
+    /**
+     * @class CaptureWriter
+     * @brief Writes captured frames as binary records or candump -L lines
+     *
+     * write() is meant for a single producer thread; get_statistics() may be
+     * called from any thread. The descriptor is not closed by the writer.
+     */
+    class CaptureWriter {
+        public:
+            /**
+             * @brief Start the writer thread
+             * @param fd Output descriptor (file, pipe or stdout)
+             * @param format Binary records or candump -L text
+             * @param interface_name Interface column of candump lines
+             * @param buffer_size Bytes per buffer
+             * @param buffer_count Buffers in rotation (at least 2)
+             * @throws std::invalid_argument on a bad descriptor or buffer setup
+             */
+            CaptureWriter(int fd, CaptureFormat format, std::string interface_name = "can0",
+                std::size_t buffer_size = 1 << 20, std::size_t buffer_count = 4);
+
+            ~CaptureWriter();
+
+            CaptureWriter(const CaptureWriter&) = delete;
+            CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+            /**
+             * @brief Append one frame
+             * @param frame SocketCAN frame
+             * @param timestamp_us Reception time, microseconds since the Unix epoch
+             * @return bool False if the record was dropped
+             */
+            bool write(const struct can_frame& frame, std::uint64_t timestamp_us);
+
+            /**
+             * @brief Hand the current buffer over and wait until all is written
+             */
+            void flush();
+
+            /**
+             * @brief Flush and join the writer thread (idempotent)
+             */
+            void stop();
+
+            CaptureStatistics get_statistics() const;
+
+            CaptureFormat format() const { return format_; }
+
+        private:
+            struct Buffer {
+                std::vector<std::uint8_t> data;
+                std::size_t used = 0;
+            };
+
+            int fd_;
+            CaptureFormat format_;
+            std::string interface_name_;
+            std::size_t record_limit_;      ///< Largest formatted record
+            std::vector<Buffer> buffers_;
+
+            // Producer side
+            Buffer* current_ = nullptr;
+
+            // Shared with the writer thread, under mutex_
+            mutable std::mutex mutex_;
+            std::condition_variable work_cv_;
+            std::condition_variable done_cv_;
+            std::deque<Buffer*> free_;
+            std::deque<Buffer*> full_;
+            bool writing_ = false;
+            bool stopping_ = false;
+            std::thread thread_;
+
+            std::atomic<std::uint64_t> records_{0};
+            std::atomic<std::uint64_t> dropped_{0};
+            std::atomic<std::uint64_t> bytes_written_{0};
+            std::atomic<std::uint64_t> write_errors_{0};
+
+            /**
+             * @brief Format one record at the end of buf
+             */
+            void format_record(Buffer& buf, const struct can_frame& frame,
+                std::uint64_t timestamp_us) const;
+
+            /**
+             * @brief Queue the current buffer for the writer thread
+             */
+            void submit();
+
+            /**
+             * @brief Writer thread body
+             */
+            void run();
+
+            /**
+             * @brief write() the whole buffer, retrying on EINTR and partial writes
+             */
+            void write_out(const Buffer& buf);
+    };
+
+}  // namespace waveshare
@@ -0,0 +1,113 @@
+/**
+ * @file frame_stream_decoder.hpp
+ * @brief Buffered decoder of the Waveshare serial byte stream
+ * @version 1.0
+ * @date 2025-11-23
+ *
+ * Turns whatever chunk of bytes a serial read returns into SocketCAN frames,
+ * without building a frame object or taking a lock per frame:
+ * - Variable frames are sized from their TYPE byte, so a 0x55 data byte is
+ *   never mistaken for the END byte
+ * - Fixed frames are checked against their checksum
+ * - A frame split across reads is completed by the next chunk
+ * - On a malformed frame the decoder drops one byte and resynchronizes on
+ *   the next START byte
+ *
+ * Usage:
+ * @code
+ * FrameStreamDecoder decoder(FrameStreamDecoder::Mode::VARIABLE);
+ * std::vector<can_frame> frames;
+ * int n = adapter->receive_bytes(buffer, sizeof(buffer), 100);
+ * decoder.decode(buffer, n, frames);
+ * @endcode
+ */
+
+#pragma once
+
+#include <linux/can.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace waveshare {
+
+    /**
+     * @brief Stateful decoder of a Waveshare data-frame byte stream
+     *
+     * Not thread-safe; use one decoder per stream.
+     */
+    class FrameStreamDecoder {
+        public:
+            /**
+             * @brief Protocol the adapter was configured for
+             */
+            enum class Mode {
+                VARIABLE,   ///< 5-15 byte frames, AA TYPE ID DATA 55
+                FIXED       ///< 20 byte frames, AA 55 ... CHECKSUM
+            };
+
+            /**
+             * @brief Decoder counters
+             */
+            struct Statistics {
+                std::uint64_t frames = 0;           ///< Frames decoded
+                std::uint64_t decode_errors = 0;    ///< Malformed frames and garbage runs
+                std::uint64_t skipped_bytes = 0;    ///< Bytes dropped while resynchronizing
+            };
+
+            explicit FrameStreamDecoder(Mode mode = Mode::VARIABLE);
+
+            /**
+             * @brief Decode a chunk of the stream
+             * @param data Bytes received
+             * @param size Number of bytes
+             * @param frames Decoded frames are appended here
+             * @return std::size_t Number of frames appended
+             */
+            std::size_t decode(const std::uint8_t* data, std::size_t size,
+                std::vector<struct can_frame>& frames);
+
+            /**
+             * @brief Drop any partial frame (e.g. after reconfiguring the adapter)
+             */
+            void reset() { pending_.clear(); in_garbage_ = false; }
+
+            /**
+             * @brief Bytes held waiting for the rest of a frame
+             */
+            std::size_t pending() const { return pending_.size(); }
+
+            const Statistics& get_statistics() const { return stats_; }
+
+            Mode mode() const { return mode_; }
+
+        private:
+            /**
+             * @brief Result of parsing at one position
+             */
+            enum class Parse {
+                FRAME,      ///< Frame decoded, length consumed
+                INCOMPLETE, ///< Need more bytes
+                INVALID     ///< Not a frame at this position
+            };
+
+            Mode mode_;
+            std::vector<std::uint8_t> pending_;    ///< Unparsed tail of the previous chunk
+            bool in_garbage_ = false;               ///< Inside a run of skipped bytes
+            Statistics stats_;
+
+            /**
+             * @brief Parse every complete frame of [data, data + size)
+             * @return std::size_t Bytes consumed (the rest is an incomplete frame)
+             */
+            std::size_t parse(const std::uint8_t* data, std::size_t size,
+                std::vector<struct can_frame>& frames);
+
+            Parse parse_variable(const std::uint8_t* data, std::size_t size,
+                struct can_frame& frame, std::size_t& length) const;
+
+            Parse parse_fixed(const std::uint8_t* data, std::size_t size,
+                struct can_frame& frame, std::size_t& length) const;
+    };
+
+}  // namespace waveshare
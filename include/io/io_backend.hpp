@@ -0,0 +1,57 @@
+/**
+ * @file io_backend.hpp
+ * @brief Runtime choice between POSIX and io_uring port/socket implementations
+ * @version 1.0
+ * @date 2025-11-29
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "can_socket.hpp"
+#include "serial_port.hpp"
+#include "../enums/protocol.hpp"
+
+namespace waveshare {
+
+    /**
+     * @brief I/O implementation for serial ports and CAN sockets
+     */
+    enum class IoBackend {
+        POSIX,      ///< RealSerialPort / RealCANSocket (poll + read/write)
+        IO_URING    ///< UringSerialPort / UringCANSocket, POSIX if the kernel lacks support
+    };
+
+    /**
+     * @brief Parse "posix" or "io_uring" (also "uring")
+     * @throws std::invalid_argument on any other name
+     */
+    IoBackend io_backend_from_string(const std::string& name);
+
+    std::string io_backend_to_string(IoBackend backend);
+
+    /**
+     * @brief Backend that will actually be used for a requested one
+     */
+    IoBackend effective_io_backend(IoBackend requested);
+
+    /**
+     * @brief Open a serial port with the requested backend
+     *
+     * IO_URING falls back to POSIX, with a warning, when io_uring is
+     * unavailable.
+     * @throws DeviceException if the port cannot be opened
+     */
+    std::unique_ptr<ISerialPort> open_serial_port(const std::string& device_path,
+        SerialBaud baud_rate, IoBackend backend);
+
+    /**
+     * @brief Open a CAN socket with the requested backend (same fallback)
+     * @throws DeviceException if the socket cannot be opened
+     */
+    std::unique_ptr<ICANSocket> open_can_socket(const std::string& interface, int timeout_ms,
+        IoBackend backend);
+
+}  // namespace waveshare
@@ -0,0 +1,198 @@
+/**
+ * @file local_can_bus.hpp
+ * @brief In-process loopback CAN bus with ICANSocket endpoints
+ * @version 1.0
+ * @date 2025-11-28
+ *
+ * A LocalCANBus stands in for a vcan interface when every participant (the
+ * bridge, PDOManager, a control loop, test doubles) lives in one process:
+ * - Every endpoint is an ICANSocket with a bounded lock-free MPMC ring; a
+ *   send() copies the frame straight into each matching receiver's ring
+ * - get_fd() is an eventfd, so select()/poll() loops work unchanged; it is
+ *   written once per burst, not once per frame
+ * - Receive filters, the error mask and own-message echo follow SocketCAN
+ *   raw socket semantics (CAN_RAW_FILTER, CAN_RAW_ERR_FILTER,
+ *   CAN_RAW_RECV_OWN_MSGS), with loopback to the other endpoints always on
+ *
+ * Usage:
+ * @code
+ * auto bus = LocalCANBus::create("local0");
+ * auto master = bus->open();
+ * auto drive = bus->open();
+ * canopen::SDOClient sdo(master, dict, node_id);
+ * @endcode
+ */
+
+#pragma once
+
+#include <linux/can.h>
+#include <sys/types.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "can_socket.hpp"
+
+namespace waveshare {
+
+    class LocalCANBus;
+    struct LocalCANEndpoint;
+
+    /**
+     * @brief Per-endpoint settings
+     */
+    struct LocalCANSocketConfig {
+        int timeout_ms = 1000;                  ///< receive() wait on an empty queue, 0 = never
+        std::size_t queue_capacity = 1024;      ///< Rounded up to a power of two
+        /// Receive filters; the default accepts everything, an empty list nothing
+        std::vector<struct can_filter> filters = {{0, 0}};
+        can_err_mask_t error_mask = 0;          ///< Error frame classes to receive
+        bool receive_own = false;               ///< Echo this endpoint's own frames
+    };
+
+    /**
+     * @brief Per-endpoint counters
+     */
+    struct LocalCANSocketStatistics {
+        std::uint64_t tx_frames = 0;
+        std::uint64_t rx_frames = 0;            ///< Frames queued to this endpoint
+        std::uint64_t rx_dropped = 0;           ///< Frames lost to a full queue
+    };
+
+    /**
+     * @class LocalCANSocket
+     * @brief One endpoint of a LocalCANBus
+     *
+     * Created by LocalCANBus::open(); keeps the bus alive. Several threads may
+     * send and receive on the same endpoint.
+     */
+    class LocalCANSocket : public ICANSocket {
+        public:
+            ~LocalCANSocket() override;
+
+            LocalCANSocket(const LocalCANSocket&) = delete;
+            LocalCANSocket& operator=(const LocalCANSocket&) = delete;
+
+            /**
+             * @brief Deliver a frame to every other matching endpoint
+             * @return sizeof(can_frame), or -1 with errno (ENOTCONN, EINVAL)
+             *
+             * Never blocks: a receiver whose queue is full loses the frame.
+             */
+            ssize_t send(const struct can_frame& frame) override;
+
+            /**
+             * @brief Take the oldest queued frame
+             * @return sizeof(can_frame), or -1 with errno EAGAIN on timeout
+             *         and ENOTCONN once closed
+             */
+            ssize_t receive(struct can_frame& frame) override;
+
+            bool is_open() const override;
+
+            /**
+             * @brief Detach from the bus (idempotent); wakes blocked receivers
+             */
+            void close() override;
+
+            std::string get_interface_name() const override;
+
+            /**
+             * @brief eventfd readable while frames are queued, -1 once closed
+             */
+            int get_fd() const override;
+
+            /**
+             * @brief Replace the receive filters (CAN_RAW_FILTER semantics)
+             *
+             * A frame passes if any filter matches:
+             * (can_id & mask) == (filter.can_id & mask), inverted when the
+             * filter's can_id carries CAN_INV_FILTER.
+             */
+            void set_filters(const std::vector<struct can_filter>& filters);
+
+            /**
+             * @brief Error frame classes to receive (CAN_RAW_ERR_FILTER)
+             */
+            void set_error_filter(can_err_mask_t mask);
+
+            /**
+             * @brief Receive this endpoint's own frames (CAN_RAW_RECV_OWN_MSGS)
+             */
+            void set_receive_own(bool enable);
+
+            LocalCANSocketStatistics get_statistics() const;
+
+            /**
+             * @brief Frames waiting for receive()
+             */
+            std::size_t pending() const;
+
+        private:
+            friend class LocalCANBus;
+
+            LocalCANSocket(std::shared_ptr<LocalCANBus> bus,
+                std::shared_ptr<LocalCANEndpoint> endpoint);
+
+            std::shared_ptr<LocalCANBus> bus_;
+            std::shared_ptr<LocalCANEndpoint> endpoint_;
+    };
+
+    /**
+     * @class LocalCANBus
+     * @brief Named in-process bus connecting LocalCANSocket endpoints
+     *
+     * Sends read an immutable snapshot of the attached endpoints and their
+     * filters; opening, closing and re-filtering endpoints publish a new one.
+     */
+    class LocalCANBus : public std::enable_shared_from_this<LocalCANBus> {
+        public:
+            /**
+             * @brief Create an empty bus
+             * @param name Reported by the endpoints' get_interface_name()
+             */
+            static std::shared_ptr<LocalCANBus> create(const std::string& name = "local0");
+
+            ~LocalCANBus();
+
+            LocalCANBus(const LocalCANBus&) = delete;
+            LocalCANBus& operator=(const LocalCANBus&) = delete;
+
+            /**
+             * @brief Attach a new endpoint
+             * @throws DeviceException if the eventfd cannot be created
+             * @throws std::invalid_argument on a zero queue capacity
+             */
+            std::shared_ptr<LocalCANSocket> open(const LocalCANSocketConfig& config = {});
+
+            const std::string& get_name() const { return name_; }
+
+            /**
+             * @brief Number of open endpoints
+             */
+            std::size_t endpoint_count() const;
+
+        private:
+            friend class LocalCANSocket;
+            struct Routes;
+
+            explicit LocalCANBus(const std::string& name);
+
+            void deliver(const LocalCANEndpoint* sender, const struct can_frame& frame) const;
+            void detach(const LocalCANEndpoint* endpoint);
+
+            /**
+             * @brief Rebuild the send snapshot (caller holds mutex_)
+             */
+            void publish();
+
+            std::string name_;
+            mutable std::mutex mutex_;          ///< Serializes snapshot writers only
+            std::vector<std::shared_ptr<LocalCANEndpoint>> endpoints_;
+            std::shared_ptr<const Routes> routes_;  ///< Accessed with std::atomic_load/store
+    };
+
+}  // namespace waveshare
@@ -0,0 +1,83 @@
+/**
+ * @file uring_can_socket.hpp
+ * @brief ICANSocket doing its I/O through io_uring
+ * @version 1.0
+ * @date 2025-11-29
+ */
+
+#pragma once
+
+#include <linux/can.h>
+#include <memory>
+
+#include "can_socket.hpp"
+#include "uring_context.hpp"
+
+namespace waveshare {
+
+    /**
+     * @class UringCANSocket
+     * @brief SocketCAN socket with a multishot recv armed in an io_uring
+     *
+     * Each received frame is one completion in a provided buffer, so a burst
+     * is consumed without a syscall per frame. send_batch() writes several
+     * frames with a single submission. Socket creation and binding are left
+     * to the wrapped socket (RealCANSocket by default).
+     */
+    class UringCANSocket : public ICANSocket {
+        public:
+            /**
+             * @brief Open and bind the interface, then attach the ring
+             * @throws DeviceException on socket or io_uring failure
+             */
+            UringCANSocket(const std::string& interface, int timeout_ms);
+
+            /**
+             * @brief Attach the ring to an already open socket
+             * @param timeout_ms receive() wait on an empty queue
+             * @throws DeviceException if the socket is not open or io_uring is unavailable
+             */
+            UringCANSocket(std::unique_ptr<ICANSocket> socket, int timeout_ms);
+
+            ~UringCANSocket() override;
+
+            UringCANSocket(const UringCANSocket&) = delete;
+            UringCANSocket& operator=(const UringCANSocket&) = delete;
+
+            ssize_t send(const struct can_frame& frame) override;
+
+            /**
+             * @brief Send frames in order with one submission
+             * @return Frames sent; errno is set if fewer than count
+             */
+            std::size_t send_batch(const struct can_frame* frames, std::size_t count);
+
+            /**
+             * @brief Take the next frame, waiting up to timeout_ms
+             * @return sizeof(can_frame), or -1 with errno (EAGAIN on timeout)
+             */
+            ssize_t receive(struct can_frame& frame) override;
+
+            bool is_open() const override;
+            void close() override;
+            std::string get_interface_name() const override;
+
+            /**
+             * @brief eventfd readable while frames may be queued
+             */
+            int get_fd() const override;
+
+            IoUringStreamStatistics get_statistics() const;
+
+            /**
+             * @brief Stream sizing for CAN frames
+             */
+            static IoUringStreamConfig stream_config();
+
+        private:
+            std::unique_ptr<ICANSocket> socket_;
+            std::unique_ptr<IoUringStream> stream_;
+            int timeout_ms_;
+    };
+
+}  // namespace waveshare
@@ -0,0 +1,288 @@
+/**
+ * @file uring_context.hpp
+ * @brief Minimal io_uring ring and a buffered byte stream on top of it
+ * @version 1.0
+ * @date 2025-11-29
+ *
+ * Talks to the kernel through the raw io_uring syscalls, so no liburing is
+ * needed at build or run time:
+ * - IoUringContext owns one ring: SQ/CQ mappings, fixed buffers, a provided
+ *   buffer ring for reads and a completion eventfd
+ * - IoUringStream keeps a read permanently armed on one fd (multishot where
+ *   the kernel supports it), so received data is already in user memory
+ *   when the caller asks for it, and issues writes from registered buffers
+ *
+ * Used by UringSerialPort and UringCANSocket; see io_backend.hpp for the
+ * runtime selection between these and the POSIX implementations.
+ */
+
+#pragma once
+
+#include <linux/io_uring.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace waveshare {
+
+    /**
+     * @class IoUringContext
+     * @brief One io_uring instance (not thread-safe)
+     */
+    class IoUringContext {
+        public:
+            /**
+             * @brief Set up the ring and map its queues
+             * @param entries Submission queue size
+             * @throws DeviceException if io_uring is unavailable
+             */
+            explicit IoUringContext(unsigned entries = 64);
+
+            ~IoUringContext();
+
+            IoUringContext(const IoUringContext&) = delete;
+            IoUringContext& operator=(const IoUringContext&) = delete;
+
+            /**
+             * @brief Whether the kernel offers everything the stream needs
+             *
+             * Checks ring setup, timed waits (IORING_FEAT_EXT_ARG), the
+             * read/recv/write-fixed opcodes and provided buffer rings. The
+             * result is computed once per process.
+             */
+            static bool is_supported();
+
+            /**
+             * @brief Whether the kernel implements an opcode (IORING_REGISTER_PROBE)
+             */
+            bool supports(std::uint8_t opcode) const;
+
+            /**
+             * @brief Next free submission entry, zeroed
+             * @return nullptr if the queue is full (submit first)
+             */
+            struct io_uring_sqe* get_sqe();
+
+            /**
+             * @brief Submit queued entries and optionally wait for completions
+             * @param wait_nr Completions to wait for (0 = do not wait)
+             * @param timeout_ms Wait limit, -1 = unbounded
+             * @return Entries submitted, or -1 with errno (ETIME on timeout)
+             */
+            int submit(unsigned wait_nr = 0, int timeout_ms = -1);
+
+            /**
+             * @brief Hand every available completion to handler and consume it
+             * @return Completions consumed
+             */
+            template<typename Handler>
+            unsigned reap(Handler&& handler) {
+                unsigned head = *cq_head_;
+                unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+                unsigned count = 0;
+                for (; head != tail; ++head, ++count) {
+                    handler(cqes_[head & cq_mask_]);
+                }
+                __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+                return count;
+            }
+
+            /**
+             * @brief Register fixed buffers for READ_FIXED/WRITE_FIXED
+             * @throws DeviceException on failure
+             */
+            void register_buffers(const struct iovec* buffers, unsigned count);
+
+            /**
+             * @brief Signal an eventfd on every posted completion
+             * @throws DeviceException on failure
+             */
+            void register_eventfd(int fd);
+
+            /**
+             * @brief Create provided buffer group 0 for buffer-select reads
+             * @param count Buffers, a power of two
+             * @param size Bytes per buffer
+             * @throws DeviceException on failure
+             */
+            void setup_buffer_ring(unsigned count, unsigned size);
+
+            /**
+             * @brief Data of a provided buffer named by a completion
+             */
+            const std::uint8_t* buffer(std::uint16_t id) const {
+                return buffer_data_.data() + static_cast<std::size_t>(id) * buffer_size_;
+            }
+
+            /**
+             * @brief Give a consumed buffer back to the kernel
+             */
+            void recycle(std::uint16_t id);
+
+            /**
+             * @brief Number of enter syscalls made so far
+             */
+            std::uint64_t enter_calls() const { return enter_calls_; }
+
+        private:
+            int ring_fd_ = -1;
+            struct io_uring_params params_ {};
+
+            void* sq_ring_ = nullptr;
+            std::size_t sq_ring_size_ = 0;
+            void* cq_ring_ = nullptr;
+            std::size_t cq_ring_size_ = 0;
+            struct io_uring_sqe* sqes_ = nullptr;
+            std::size_t sqes_size_ = 0;
+
+            unsigned* sq_head_ = nullptr;
+            unsigned* sq_tail_ = nullptr;
+            unsigned sq_mask_ = 0;
+            unsigned sqe_tail_ = 0;         ///< Entries handed out by get_sqe()
+            unsigned* cq_head_ = nullptr;
+            unsigned* cq_tail_ = nullptr;
+            unsigned cq_mask_ = 0;
+            struct io_uring_cqe* cqes_ = nullptr;
+
+            std::vector<std::uint8_t> probe_;   ///< Supported opcode flags, by opcode
+
+            void* buffer_ring_ = nullptr;
+            std::size_t buffer_ring_size_ = 0;
+            unsigned buffer_mask_ = 0;
+            unsigned buffer_size_ = 0;
+            std::uint16_t buffer_tail_ = 0;
+            std::vector<std::uint8_t> buffer_data_;
+
+            std::uint64_t enter_calls_ = 0;
+    };
+
+    /**
+     * @brief IoUringStream sizing
+     */
+    struct IoUringStreamConfig {
+        unsigned ring_entries = 128;
+        unsigned read_buffers = 64;         ///< Provided read buffers, a power of two
+        unsigned read_buffer_size = 512;    ///< One datagram or one chunk of a byte stream
+        unsigned write_slots = 64;          ///< Largest write batch
+        unsigned write_slot_size = 512;     ///< Larger writes are split
+        bool socket = false;                ///< Read with RECV (datagram sockets)
+        bool multishot = true;              ///< Use multishot reads when available
+    };
+
+    /**
+     * @brief IoUringStream counters
+     */
+    struct IoUringStreamStatistics {
+        std::uint64_t enter_calls = 0;      ///< io_uring_enter syscalls
+        std::uint64_t read_completions = 0;
+        std::uint64_t write_completions = 0;
+        std::uint64_t read_arms = 0;        ///< Read submissions (1 per multishot run)
+        bool multishot = false;             ///< Multishot reads active
+    };
+
+    /**
+     * @class IoUringStream
+     * @brief Thread-safe io_uring I/O on one descriptor
+     *
+     * The descriptor is switched to blocking mode so the kernel parks reads
+     * instead of failing them with EAGAIN; the owner keeps it open for the
+     * stream's lifetime. get_event_fd() is readable while received data may
+     * be waiting.
+     */
+    class IoUringStream {
+        public:
+            /**
+             * @throws DeviceException if the ring cannot be set up
+             */
+            IoUringStream(int fd, const IoUringStreamConfig& config = {});
+
+            ~IoUringStream();
+
+            IoUringStream(const IoUringStream&) = delete;
+            IoUringStream& operator=(const IoUringStream&) = delete;
+
+            /**
+             * @brief Copy received data
+             * @param whole_chunk Return exactly one completion (a datagram);
+             *        bytes beyond len are discarded
+             * @return Bytes copied, 0 if nothing is waiting, -1 with errno on a
+             *         read error
+             */
+            ssize_t read(void* data, std::size_t len, bool whole_chunk = false);
+
+            /**
+             * @brief Wait until read() may return data
+             * @param timeout_ms -1 = unbounded
+             */
+            bool wait_readable(int timeout_ms);
+
+            /**
+             * @brief Write len bytes, split into write slots, in one submission
+             * @return Bytes written, or -1 with errno
+             */
+            ssize_t write(const void* data, std::size_t len);
+
+            /**
+             * @brief Write several messages (e.g. CAN frames) with one submission
+             *
+             * Each message must fit a write slot and is written with its own
+             * operation, keeping datagram boundaries.
+             * @return Messages written in full; errno is set if fewer than count
+             */
+            std::size_t write_batch(const struct iovec* messages, std::size_t count);
+
+            int get_event_fd() const { return event_fd_; }
+
+            IoUringStreamStatistics get_statistics() const;
+
+        private:
+            struct Chunk {
+                std::uint16_t buffer;
+                std::uint32_t offset;
+                std::uint32_t length;
+            };
+
+            /**
+             * @brief Queue a read if none is in flight (caller holds mutex_)
+             */
+            void arm_read();
+
+            /**
+             * @brief Consume completions into chunks_ and write results
+             */
+            void drain_completions();
+
+            /**
+             * @brief Submit queued writes and wait for all of them
+             */
+            std::size_t run_writes(unsigned count, std::size_t* bytes);
+
+            /**
+             * @brief Clear the eventfd, re-signalling it if data is pending
+             */
+            void quiesce();
+
+            int fd_;
+            int original_flags_ = -1;       ///< fcntl flags restored on destruction
+            IoUringStreamConfig config_;
+            IoUringContext ring_;
+            int event_fd_ = -1;
+            std::vector<std::uint8_t> write_data_;
+
+            mutable std::mutex mutex_;
+            std::deque<Chunk> chunks_;
+            bool read_armed_ = false;
+            bool starved_ = false;          ///< Read ended for lack of free buffers
+            bool multishot_ = false;
+            int read_error_ = 0;
+            unsigned writes_pending_ = 0;
+            int write_error_ = 0;
+            std::vector<std::int32_t> write_results_;
+            IoUringStreamStatistics stats_;
+    };
+
+}  // namespace waveshare
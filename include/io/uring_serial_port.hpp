@@ -0,0 +1,76 @@
+/**
+ * @file uring_serial_port.hpp
+ * @brief ISerialPort doing its I/O through io_uring
+ * @version 1.0
+ * @date 2025-11-29
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "serial_port.hpp"
+#include "uring_context.hpp"
+#include "../enums/protocol.hpp"
+
+namespace waveshare {
+
+    /**
+     * @class UringSerialPort
+     * @brief Serial port whose reads stay armed in an io_uring
+     *
+     * Opening and termios setup are left to the wrapped port (RealSerialPort
+     * by default); reads and writes go through an IoUringStream. Received
+     * bytes land in provided buffers without a syscall per read, and
+     * get_fd() is the stream's eventfd so poll()-based callers such as
+     * USBAdapter::receive_bytes() work unchanged.
+     */
+    class UringSerialPort : public ISerialPort {
+        public:
+            /**
+             * @brief Open and configure the device, then attach the ring
+             * @throws DeviceException if the port cannot be opened or io_uring is unavailable
+             */
+            UringSerialPort(const std::string& device_path, SerialBaud baud_rate,
+                const IoUringStreamConfig& config = {});
+
+            /**
+             * @brief Attach the ring to an already open port
+             * @throws DeviceException if the port is not open or io_uring is unavailable
+             */
+            explicit UringSerialPort(std::unique_ptr<ISerialPort> port,
+                const IoUringStreamConfig& config = {});
+
+            ~UringSerialPort() override;
+
+            UringSerialPort(const UringSerialPort&) = delete;
+            UringSerialPort& operator=(const UringSerialPort&) = delete;
+
+            ssize_t write(const void* data, std::size_t len) override;
+
+            /**
+             * @brief Copy buffered input
+             *
+             * Like RealSerialPort, returns -1 with errno EAGAIN right away
+             * when nothing is buffered, unless timeout_ms > 0, in which case
+             * it first waits up to timeout_ms for data.
+             */
+            ssize_t read(void* data, std::size_t len, int timeout_ms) override;
+
+            bool is_open() const override;
+            void close() override;
+            std::string get_device_path() const override;
+
+            /**
+             * @brief eventfd readable while input may be buffered
+             */
+            int get_fd() const override;
+
+            IoUringStreamStatistics get_statistics() const;
+
+        private:
+            std::unique_ptr<ISerialPort> port_;
+            std::unique_ptr<IoUringStream> stream_;
+    };
+
+}  // namespace waveshare
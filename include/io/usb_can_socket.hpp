@@ -0,0 +1,167 @@
+/**
+ * @file usb_can_socket.hpp
+ * @brief ICANSocket implemented directly on a Waveshare USB adapter
+ * @version 1.0
+ * @date 2025-11-27
+ *
+ * Lets every ICANSocket user (SDOClient, PDOManager, CIA402FSM, ...) talk to
+ * the adapter in-process, without SocketCANBridge and a vcan interface in
+ * between:
+ * - A reader thread pulls raw bytes from the adapter, decodes all frames of
+ *   each read with a FrameStreamDecoder and queues them in a fixed ring
+ * - get_fd() is an eventfd that is readable exactly while the ring holds
+ *   frames, so select()/poll() loops work unchanged
+ * - send() encodes the Waveshare variable frame into a stack buffer and
+ *   writes it with one call, with no frame object in between
+ *
+ * Like a single SocketCAN socket, each received frame is delivered to one
+ * receive() call: components sharing the socket share its frames.
+ *
+ * Usage:
+ * @code
+ * std::shared_ptr<USBAdapter> adapter = USBAdapter::create("/dev/ttyUSB0");
+ * auto socket = std::make_shared<USBCANSocket>(adapter);
+ * canopen::SDOClient sdo(socket, dict, node_id);
+ * @endcode
+ */
+
+#pragma once
+
+#include <linux/can.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "can_socket.hpp"
+#include "frame_stream_decoder.hpp"
+
+namespace waveshare {
+
+    class USBAdapter;
+
+    /**
+     * @brief USBCANSocket settings
+     */
+    struct USBCANSocketConfig {
+        /**
+         * @brief Frame format the adapter sends (its CANVersion)
+         *
+         * Transmitted frames always use the variable format.
+         */
+        FrameStreamDecoder::Mode mode = FrameStreamDecoder::Mode::VARIABLE;
+        std::size_t queue_capacity = 4096;  ///< Received frames held; newer ones drop
+        int receive_timeout_ms = 100;       ///< receive() wait on an empty queue
+        int read_timeout_ms = 50;           ///< Adapter wait per reader iteration
+        std::string interface_name;         ///< Defaults to the adapter device path
+    };
+
+    /**
+     * @brief USBCANSocket counters
+     */
+    struct USBCANSocketStatistics {
+        std::uint64_t rx_frames = 0;        ///< Frames decoded from the adapter
+        std::uint64_t rx_dropped = 0;       ///< Frames lost to a full queue
+        std::uint64_t tx_frames = 0;
+        std::uint64_t tx_errors = 0;
+        std::uint64_t decode_errors = 0;
+    };
+
+    /**
+     * @class USBCANSocket
+     * @brief In-process CAN socket on a USBAdapter
+     *
+     * The adapter must already be configured for the bus (e.g. by
+     * configure_can() or autobaud()). While the socket is open it owns the
+     * adapter's receive side: nothing else may read from the adapter.
+     */
+    class USBCANSocket : public ICANSocket {
+        public:
+            /**
+             * @brief Open the socket and start the reader thread
+             * @throws DeviceException if the adapter is null or not open, or
+             *         the eventfd cannot be created
+             * @throws std::invalid_argument on a zero queue capacity
+             */
+            explicit USBCANSocket(std::shared_ptr<USBAdapter> adapter,
+                const USBCANSocketConfig& config = {});
+
+            ~USBCANSocket() override;
+
+            USBCANSocket(const USBCANSocket&) = delete;
+            USBCANSocket& operator=(const USBCANSocket&) = delete;
+
+            /**
+             * @brief Encode and write one frame to the adapter
+             * @return sizeof(can_frame), or -1 with errno (ENOTCONN, EIO)
+             */
+            ssize_t send(const struct can_frame& frame) override;
+
+            /**
+             * @brief Take the oldest queued frame
+             *
+             * Waits up to receive_timeout_ms when the queue is empty.
+             * @return sizeof(can_frame), or -1 with errno EAGAIN on timeout
+             *         and ENOTCONN once closed
+             */
+            ssize_t receive(struct can_frame& frame) override;
+
+            bool is_open() const override { return open_.load(); }
+
+            /**
+             * @brief Stop the reader thread and close the eventfd (idempotent)
+             *
+             * The adapter itself stays open.
+             */
+            void close() override;
+
+            std::string get_interface_name() const override { return interface_name_; }
+
+            /**
+             * @brief eventfd readable while frames are queued
+             */
+            int get_fd() const override { return event_fd_; }
+
+            USBCANSocketStatistics get_statistics() const;
+
+            /**
+             * @brief Frames waiting for receive()
+             */
+            std::size_t pending() const;
+
+            /**
+             * @brief Encode a frame in the Waveshare variable format
+             * @param out At least 15 bytes
+             * @return std::size_t Encoded length
+             */
+            static std::size_t encode_variable(const struct can_frame& frame, std::uint8_t* out);
+
+        private:
+            void reader_loop();
+
+            /**
+             * @brief Queue decoded frames and signal the eventfd (reader thread)
+             */
+            void enqueue(const std::vector<struct can_frame>& frames);
+
+            std::shared_ptr<USBAdapter> adapter_;
+            USBCANSocketConfig config_;
+            std::string interface_name_;
+            int event_fd_ = -1;
+
+            mutable std::mutex mutex_;
+            std::condition_variable not_empty_;
+            std::vector<struct can_frame> ring_;
+            std::size_t head_ = 0;          ///< Oldest frame
+            std::size_t count_ = 0;
+            USBCANSocketStatistics stats_;
+
+            std::atomic<bool> open_{false};
+            std::thread reader_;
+    };
+
+}  // namespace waveshare
@@ -0,0 +1,242 @@
+/**
+ * @file adapter_emulator.hpp
+ * @brief USB-CAN-A emulator on a pseudo-terminal
+ * @version 1.0
+ * @date 2025-11-30
+ *
+ * Creates a pty pair and answers on the master side the way the adapter does
+ * on its USB serial port, so RealSerialPort, USBAdapter and everything above
+ * them run unchanged against the slave path instead of /dev/ttyUSB0:
+ * - ConfigFrames set the CAN rate, mode, acceptance filter and mask
+ * - Data frames from the host (variable or fixed) are transmitted on an
+ *   emulated bus; on_transmit() sees them, and echo mode answers each one
+ *   with a copy, like a mirror node
+ * - LOOPBACK modes return the host's frames and ignore the bus, SILENT
+ *   modes receive but never transmit
+ * - Traffic is injected with inject() or replayed from a capture file
+ * - Frames delivered to the host pass the acceptance filter and are encoded
+ *   as variable frames, or as 20-byte fixed frames after a CONF_FIXED
+ *   ConfigFrame
+ *
+ * Timing: every frame occupies the bus for its bit time (can_frame_bits() at
+ * the configured rate), one after the other, and every byte on the serial
+ * link takes 10 bit times of the serial baud rate in each direction. The
+ * host therefore sees the throughput and latency of the real link, and an
+ * adapter configured for another rate than the bus (bus_baud) receives
+ * nothing, as during autobaud. Arbitration and error frames are not
+ * modelled.
+ *
+ * Usage:
+ * @code
+ * AdapterEmulator emulator;
+ * emulator.start();
+ * auto adapter = USBAdapter::create(emulator.get_slave_path(), SerialBaud::BAUD_2M);
+ * emulator.replay("bus.wscap");
+ * @endcode
+ */
+
+#pragma once
+
+#include <linux/can.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../enums/protocol.hpp"
+#include "../io/capture_format.hpp"
+#include "../io/frame_stream_decoder.hpp"
+
+namespace waveshare {
+
+    /**
+     * @brief Emulator settings
+     */
+    struct AdapterEmulatorConfig {
+        SerialBaud serial_baud = DEFAULT_SERIAL_BAUD;   ///< Rate the host opens the port with
+        bool serial_timing = true;          ///< Pace the serial link at serial_baud
+        bool bus_timing = true;             ///< Pace the bus at the configured CAN rate
+
+        /**
+         * @brief Rate the emulated bus runs at
+         *
+         * Unset: always the rate the host configured. Set: the adapter only
+         * sends and receives while configured for this rate.
+         */
+        std::optional<CANBaud> bus_baud;
+
+        bool echo = false;                  ///< Answer every transmitted frame with a copy
+        std::size_t host_queue_frames = 1024;   ///< Frames buffered toward the host
+        std::string link_path;              ///< Optional symlink to the slave (e.g. /tmp/ttyWS0)
+    };
+
+    /**
+     * @brief Adapter state set by the host's ConfigFrames
+     */
+    struct AdapterEmulatorState {
+        CANBaud can_baud = DEFAULT_CAN_BAUD;
+        CANMode can_mode = DEFAULT_CAN_MODE;
+        RTX auto_rtx = DEFAULT_RTX;
+        std::uint32_t filter = 0;
+        std::uint32_t mask = 0;             ///< 0 accepts every ID
+        Type config_type = DEFAULT_CONF_TYPE;   ///< CONF_FIXED: 20-byte frames to the host
+    };
+
+    /**
+     * @brief Emulator counters
+     */
+    struct AdapterEmulatorStatistics {
+        std::uint64_t config_frames = 0;    ///< ConfigFrames applied
+        std::uint64_t host_frames = 0;      ///< Data frames received from the host
+        std::uint64_t bus_frames = 0;       ///< Host frames transmitted on the bus
+        std::uint64_t injected = 0;         ///< Frames put on the bus by inject()/replay()
+        std::uint64_t delivered = 0;        ///< Frames sent to the host
+        std::uint64_t filtered = 0;         ///< Bus frames rejected by the acceptance filter
+        std::uint64_t not_sent = 0;         ///< Host frames dropped by SILENT mode or a rate mismatch
+        std::uint64_t overruns = 0;         ///< Frames lost to a full host queue
+        std::uint64_t skipped_bytes = 0;    ///< Host bytes dropped while resynchronizing
+    };
+
+    /**
+     * @class AdapterEmulator
+     * @brief Waveshare USB-CAN-A on the master side of a pty
+     *
+     * One thread serves the pty; inject() and replay() may be called from
+     * any thread.
+     */
+    class AdapterEmulator {
+        public:
+            using TransmitCallback = std::function<void (const struct can_frame& frame)>;
+
+            /**
+             * @brief Create the pty pair (the thread starts with start())
+             * @throws DeviceException if the pty or the link cannot be created
+             */
+            explicit AdapterEmulator(const AdapterEmulatorConfig& config = {});
+
+            ~AdapterEmulator();
+
+            AdapterEmulator(const AdapterEmulator&) = delete;
+            AdapterEmulator& operator=(const AdapterEmulator&) = delete;
+
+            /**
+             * @brief Path the host opens (/dev/pts/N, or link_path if set)
+             */
+            const std::string& get_slave_path() const { return slave_path_; }
+
+            void start();
+            void stop();
+            bool is_running() const { return running_.load(); }
+
+            /**
+             * @brief Called from the emulator thread for every frame the host
+             *        transmits on the bus; set before start()
+             */
+            void on_transmit(TransmitCallback callback) { on_transmit_ = std::move(callback); }
+
+            /**
+             * @brief Put a frame from another node on the bus
+             */
+            void inject(const struct can_frame& frame);
+
+            /**
+             * @brief Replay a binary capture (as written by wave_reader -o)
+             * @param speed Time scale of the record timestamps; 0 sends as
+             *        fast as the bus and the host link allow
+             * @param loop Start over at the end
+             * @throws std::runtime_error if the capture cannot be read
+             * @throws std::invalid_argument on a negative speed
+             */
+            void replay(const std::string& capture_path, double speed = 1.0, bool loop = false);
+
+            /**
+             * @brief True once a non-looping replay has put its last frame on the bus
+             */
+            bool replay_done() const;
+
+            AdapterEmulatorState get_state() const;
+            AdapterEmulatorStatistics get_statistics() const;
+
+        private:
+            using Clock = std::chrono::steady_clock;
+
+            enum class Origin : std::uint8_t {
+                HOST,       ///< Sent by the host through the adapter
+                BUS         ///< Sent by another node (inject, replay, echo)
+            };
+
+            struct BusSlot {
+                Clock::time_point done;     ///< End of the frame on the bus
+                struct can_frame frame;
+                Origin origin;
+            };
+
+            struct HostBytes {
+                Clock::time_point due;      ///< Last byte through the serial link
+                std::vector<std::uint8_t> bytes;
+            };
+
+            AdapterEmulatorConfig config_;
+            std::string slave_path_;
+            int master_fd_ = -1;
+            int slave_fd_ = -1;             ///< Held open so the master never sees a hangup
+            int wake_fd_ = -1;
+
+            std::atomic<bool> running_{false};
+            std::thread thread_;
+            TransmitCallback on_transmit_;
+
+            mutable std::mutex mutex_;
+            AdapterEmulatorState state_;
+            AdapterEmulatorStatistics stats_;
+            std::vector<std::uint8_t> input_;   ///< Host bytes not yet parsed
+            FrameStreamDecoder variable_decoder_{FrameStreamDecoder::Mode::VARIABLE};
+            FrameStreamDecoder fixed_decoder_{FrameStreamDecoder::Mode::FIXED};
+            std::vector<struct can_frame> decoded_;
+
+            std::deque<BusSlot> bus_;           ///< Frames on the bus, in end order
+            std::deque<HostBytes> to_host_;     ///< Encoded frames, in delivery order
+            std::size_t written_ = 0;           ///< Bytes of to_host_.front() already written
+            bool host_blocked_ = false;         ///< Pty full: wait for POLLOUT
+            Clock::time_point bus_free_{};
+            Clock::time_point rx_free_{};       ///< Host to adapter serial line
+            Clock::time_point tx_free_{};       ///< Adapter to host serial line
+
+            std::vector<CaptureRecord> records_;
+            std::size_t replay_index_ = 0;
+            double replay_speed_ = 1.0;
+            bool replay_loop_ = false;
+            Clock::time_point replay_start_{};
+
+            void run();
+            void wake();
+
+            /**
+             * @brief Parse complete frames from input_
+             */
+            void parse_input(Clock::time_point now);
+            bool handle_frame(const std::uint8_t* data, std::size_t size,
+                Clock::time_point ready);
+            void apply_config(const std::uint8_t* data, std::size_t size);
+
+            void schedule_bus(const struct can_frame& frame, Origin origin,
+                Clock::time_point ready);
+            void schedule_host(const struct can_frame& frame, Clock::time_point ready);
+            void replay_due(Clock::time_point now);
+            void complete_bus(Clock::time_point now, std::vector<struct can_frame>& transmitted);
+            void flush_host(Clock::time_point now);
+            std::optional<Clock::time_point> next_deadline() const;
+
+            bool rate_matches() const;
+            bool accepts(const struct can_frame& frame) const;
+            Clock::duration frame_time(const struct can_frame& frame) const;
+            Clock::duration serial_time(std::size_t bytes) const;
+    };
+
+}  // namespace waveshare
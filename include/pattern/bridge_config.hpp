@@ -21,10 +21,13 @@
 #include <cstdint>
 #include <optional>
 #include <map>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
 #include "../enums/protocol.hpp"
+#include "gateway_rules.hpp"
+#include "../io/io_backend.hpp"
 
 namespace waveshare {
 
@@ -52,6 +55,8 @@ namespace waveshare {
      * - WAVESHARE_USB_READ_TIMEOUT: USB read timeout in ms (default: 100)
      *
      * - WAVESHARE_SOCKETCAN_READ_TIMEOUT: SocketCAN read timeout in ms (default: 100)
+     *
+     * - WAVESHARE_IO_BACKEND: Port/socket I/O (posix/io_uring, default: posix)
      */
     struct BridgeConfig {
         // === Network Configuration ===
@@ -72,6 +77,12 @@ namespace waveshare {
         std::uint32_t usb_read_timeout_ms = 100;
         std::uint32_t socketcan_read_timeout_ms = 100;
 
+        // === I/O ===
+        IoBackend io_backend = IoBackend::POSIX;
+
+        // === Gateway Rules (JSON only, see gateway_rules.hpp) ===
+        std::vector<GatewayRule> rules;
+
         /**
          * @brief Validate configuration
          * @throws std::invalid_argument if config is invalid
@@ -0,0 +1,158 @@
+/**
+ * @file bus_analyzer.hpp
+ * @brief Offline per-ID timing and bus-load analysis of captures
+ * @version 1.0
+ * @date 2025-11-24
+ *
+ * Answers "which node is violating its cycle time" from captured traffic:
+ * - Per ID: period estimate (median gap), jitter percentiles around it,
+ *   missed cycles (gaps spanning several periods) and bursts (frames
+ *   arriving well before the next period)
+ * - Per bus: a load timeline at a configurable resolution, each frame
+ *   weighted by its worst-case bit time (can_frame_bits())
+ *
+ * The records are split into one contiguous chunk per thread. Each thread
+ * collects per-ID gaps and timeline bins for its chunk; the chunks are then
+ * stitched in order (the gap across each chunk boundary is recovered from
+ * the last and first timestamp of every ID) and the per-ID statistics are
+ * computed in parallel again.
+ *
+ * Timestamps are those of the capture: wave_reader stamps all frames of one
+ * serial read with the time of that read, so gaps below the read period are
+ * not meaningful.
+ *
+ * Usage:
+ * @code
+ * CaptureFile capture("bus.wscap");
+ * BusAnalyzerConfig config;
+ * config.can_baud = CANBaud::BAUD_500K;
+ * config.resolution = std::chrono::milliseconds(100);
+ * BusAnalysis analysis = BusAnalyzer(config).analyze(capture);
+ * @endcode
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../enums/protocol.hpp"
+#include "../io/capture_file.hpp"
+
+namespace waveshare {
+
+    /**
+     * @brief Analysis settings
+     */
+    struct BusAnalyzerConfig {
+        CANBaud can_baud = DEFAULT_CAN_BAUD;    ///< Bit rate the load is computed for
+        std::chrono::microseconds resolution{10000};    ///< Load timeline bin width
+        std::size_t threads = 0;                ///< Worker threads (0 = one per core)
+
+        /**
+         * @brief A gap above missed_factor × period counts as missed cycles
+         */
+        double missed_factor = 1.5;
+
+        /**
+         * @brief A gap below burst_factor × period makes the frame part of a burst
+         */
+        double burst_factor = 0.5;
+
+        /**
+         * @brief IDs with fewer frames get no period estimate
+         */
+        std::size_t min_frames = 3;
+    };
+
+    /**
+     * @brief Timing statistics of one CAN ID
+     *
+     * IDs are keyed by the SocketCAN can_id, so a remote frame and a data
+     * frame with the same identifier are separate streams.
+     */
+    struct IdStatistics {
+        std::uint32_t can_id = 0;           ///< With SocketCAN EFF/RTR flags
+        std::uint64_t frames = 0;
+        std::uint64_t bits = 0;             ///< Worst-case bus bit times
+        std::uint64_t first_us = 0;
+        std::uint64_t last_us = 0;
+
+        double period_us = 0.0;             ///< Median gap (0 = too few frames)
+
+        // |gap - period| over the gaps that are neither missed cycles nor bursts
+        double jitter_p50_us = 0.0;
+        double jitter_p95_us = 0.0;
+        double jitter_p99_us = 0.0;
+        double jitter_max_us = 0.0;
+
+        std::uint64_t missed_cycles = 0;    ///< Periods with no frame
+        std::uint64_t burst_frames = 0;     ///< Frames early by more than burst_factor
+        std::uint64_t bursts = 0;           ///< Runs of consecutive early frames
+        std::uint64_t max_burst = 0;        ///< Frames in the longest burst
+
+        /**
+         * @brief Share of the bus over the whole capture, in percent
+         */
+        double load_percent = 0.0;
+    };
+
+    /**
+     * @brief One bin of the bus-load timeline
+     */
+    struct LoadBin {
+        std::uint64_t start_us = 0;
+        std::uint64_t frames = 0;
+        std::uint64_t bits = 0;
+        double load_percent = 0.0;
+    };
+
+    /**
+     * @brief Result of an analysis
+     */
+    struct BusAnalysis {
+        std::uint64_t frames = 0;
+        std::uint64_t first_us = 0;
+        std::uint64_t last_us = 0;
+        std::uint64_t out_of_order = 0;     ///< Records older than their predecessor
+        double load_percent = 0.0;          ///< Mean over the whole capture
+        std::vector<IdStatistics> ids;      ///< Sorted by can_id
+        std::vector<LoadBin> timeline;
+
+        /**
+         * @brief Busiest timeline bin (nullptr if empty)
+         */
+        const LoadBin* peak_bin() const;
+    };
+
+    /**
+     * @class BusAnalyzer
+     * @brief Computes a BusAnalysis from capture records
+     */
+    class BusAnalyzer {
+        public:
+            /**
+             * @throws std::invalid_argument on a zero resolution or invalid factors
+             */
+            explicit BusAnalyzer(const BusAnalyzerConfig& config = {});
+
+            /**
+             * @brief Analyze records in capture order
+             * @param records First record
+             * @param count Number of records
+             */
+            BusAnalysis analyze(const CaptureRecord* records, std::size_t count) const;
+
+            BusAnalysis analyze(const CaptureFile& capture) const {
+                return analyze(capture.records(), capture.size());
+            }
+
+            const BusAnalyzerConfig& config() const { return config_; }
+
+        private:
+            BusAnalyzerConfig config_;
+    };
+
+}  // namespace waveshare
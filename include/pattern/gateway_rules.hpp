@@ -0,0 +1,204 @@
+/**
+ * @file gateway_rules.hpp
+ * @brief ID remapping and payload transform rules for the SocketCAN bridge
+ * @version 1.0
+ * @date 2025-11-26
+ *
+ * Lets the bridge act as a gateway between buses with different ID plans.
+ * A rule matches frames by ID/mask and direction and runs its actions in
+ * order:
+ * - set_id: rewrite the identifier (11- or 29-bit)
+ * - and / or: clear or set bits of one payload byte
+ * - scale: read an integer field, apply value × mul / div + offset,
+ *   saturate to the field width and write it back
+ * - drop: do not forward the frame
+ *
+ * The first matching rule wins; frames no rule matches pass unchanged.
+ *
+ * Rules are compiled once, when the bridge is built:
+ * - Standard IDs go through a flat table of 2048 entries per direction
+ *   holding the winning rule of every ID, so the lookup is one load
+ * - Extended IDs are matched against the 29-bit rules of that direction in
+ *   order (the mask makes a table impractical)
+ * - Actions become fixed-size instructions in one array; a rule is an
+ *   offset into it, and running it is a switch per instruction with no
+ *   allocation or virtual call
+ *
+ * JSON format (in bridge_config.json, next to the other bridge settings):
+ * @code
+ * "rules": [
+ *   {"name": "pdo remap", "direction": "usb_to_can", "id": "0x181", "mask": "0x7FF",
+ *    "actions": [
+ *      {"op": "set_id", "id": "0x281"},
+ *      {"op": "and", "byte": 0, "value": "0x0F"},
+ *      {"op": "scale", "byte": 2, "length": 2, "endian": "little", "signed": true,
+ *       "mul": 1, "div": 10, "offset": 0}
+ *    ]},
+ *   {"direction": "both", "id": "0x18FF0000", "mask": "0x1FFF0000", "extended": true,
+ *    "actions": [{"op": "drop"}]}
+ * ]
+ * @endcode
+ */
+
+#pragma once
+
+#include <linux/can.h>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace waveshare {
+
+    /**
+     * @brief Forwarding direction a rule applies to
+     */
+    enum class RuleDirection : std::uint8_t {
+        USB_TO_CAN = 1,
+        CAN_TO_USB = 2,
+        BOTH = 3
+    };
+
+    /**
+     * @brief One step of a rule
+     */
+    struct RuleAction {
+        enum class Type : std::uint8_t { SET_ID, AND, OR, SCALE, DROP };
+
+        Type type = Type::DROP;
+
+        // SET_ID
+        std::uint32_t id = 0;
+        bool extended = false;
+
+        // AND / OR (byte and value), SCALE (byte, length and the rest)
+        std::uint8_t byte = 0;
+        std::uint8_t value = 0;
+        std::uint8_t length = 1;        ///< Field size: 1, 2 or 4 bytes
+        bool big_endian = false;
+        bool is_signed = false;
+        std::int32_t mul = 1;
+        std::int32_t div = 1;
+        std::int32_t offset = 0;
+
+        /**
+         * @throws std::invalid_argument on an unknown op or a bad field
+         */
+        static RuleAction from_json(const nlohmann::json& j);
+    };
+
+    /**
+     * @brief A rule as written in the configuration
+     */
+    struct GatewayRule {
+        std::string name;
+        RuleDirection direction = RuleDirection::BOTH;
+        std::uint32_t id = 0;
+        std::uint32_t mask = CAN_SFF_MASK;  ///< Use CAN_EFF_MASK for exact 29-bit matches
+        bool extended = false;              ///< Match 29-bit frames
+        std::vector<RuleAction> actions;
+
+        /**
+         * @throws std::invalid_argument on a malformed rule
+         */
+        static GatewayRule from_json(const nlohmann::json& j);
+    };
+
+    /**
+     * @class GatewayRuleEngine
+     * @brief Compiled rule set, applied to frames in place
+     *
+     * Immutable after construction, so both forwarding threads can use it
+     * without locking.
+     */
+    class GatewayRuleEngine {
+        public:
+            /**
+             * @brief Outcome of apply()
+             */
+            enum class Verdict : std::uint8_t {
+                PASS,       ///< No rule matched
+                REWRITTEN,  ///< A rule matched and the frame may have changed
+                DROP        ///< The frame must not be forwarded
+            };
+
+            GatewayRuleEngine() : GatewayRuleEngine(std::vector<GatewayRule>{}) {}
+
+            /**
+             * @brief Compile rules
+             * @throws std::invalid_argument on an ID or field out of range,
+             *         a zero divisor or a rule without actions
+             */
+            explicit GatewayRuleEngine(const std::vector<GatewayRule>& rules);
+
+            /**
+             * @brief Run the first rule matching the frame
+             * @param direction USB_TO_CAN or CAN_TO_USB
+             * @param frame Frame to transform in place
+             */
+            Verdict apply(RuleDirection direction, struct can_frame& frame) const {
+                const std::size_t d = direction == RuleDirection::USB_TO_CAN ? 0 : 1;
+                const std::uint32_t id = frame.can_id;
+                if (id & CAN_ERR_FLAG) {
+                    return Verdict::PASS;
+                }
+                if (!(id & CAN_EFF_FLAG)) {
+                    const std::uint16_t program = standard_[d][id & CAN_SFF_MASK];
+                    return program == NO_RULE ? Verdict::PASS : run(program, frame);
+                }
+                for (const ExtendedMatch& match : extended_[d]) {
+                    if ((id & match.mask) == match.id) {
+                        return run(match.program, frame);
+                    }
+                }
+                return Verdict::PASS;
+            }
+
+            std::size_t size() const { return rule_count_; }
+            bool empty() const { return rule_count_ == 0; }
+
+        private:
+            static constexpr std::uint16_t NO_RULE = 0xFFFF;
+
+            enum class Op : std::uint8_t { SET_ID, AND, OR, SCALE, DROP, END };
+
+            /**
+             * @brief One compiled action (20 bytes)
+             */
+            struct Instruction {
+                Op op;
+                std::uint8_t byte;
+                std::uint8_t length;
+                std::uint8_t flags;         ///< SCALE_* bits
+                std::uint32_t arg;          ///< New can_id, or the AND/OR operand
+                std::int32_t mul;
+                std::int32_t div;
+                std::int32_t offset;
+            };
+
+            static constexpr std::uint8_t SCALE_BIG_ENDIAN = 0x01;
+            static constexpr std::uint8_t SCALE_SIGNED = 0x02;
+
+            struct ExtendedMatch {
+                std::uint32_t id;           ///< With CAN_EFF_FLAG
+                std::uint32_t mask;         ///< With CAN_EFF_FLAG
+                std::uint16_t program;
+            };
+
+            Verdict run(std::uint16_t program, struct can_frame& frame) const;
+
+            std::array<std::array<std::uint16_t, CAN_SFF_MASK + 1>, 2> standard_;
+            std::array<std::vector<ExtendedMatch>, 2> extended_;
+            std::vector<Instruction> code_;
+            std::size_t rule_count_ = 0;
+    };
+
+    /**
+     * @brief Parse a direction name ("usb_to_can", "can_to_usb", "both")
+     * @throws std::invalid_argument on an unknown name
+     */
+    RuleDirection rule_direction_from_string(const std::string& name);
+
+}  // namespace waveshare
@@ -0,0 +1,362 @@
+/**
+ * @file isotp_engine.hpp
+ * @brief ISO-TP (ISO 15765-2) transport over CAN
+ * @version 1.0
+ * @date 2025-11-25
+ *
+ * Carries messages of up to 4095 bytes (UDS requests and responses) over
+ * classic CAN frames with normal addressing:
+ * - Single frame (SF) for payloads of up to 7 bytes
+ * - First frame (FF) + consecutive frames (CF) for longer payloads, paced by
+ *   the block size (BS) and separation time (STmin) of the receiver's
+ *   flow-control (FC) frames
+ *
+ * Every channel is a pair of IDs: the one this side transmits on and the one
+ * it receives on (data frames from the peer and flow control for our own
+ * transfers both arrive there). Channels transfer in both directions at once
+ * and independently of each other.
+ *
+ * Incoming multi-frame messages are reassembled straight from the CAN frames
+ * into buffers taken from a pool allocated at construction; the receive
+ * callback gets a view of that buffer, which goes back to the pool when the
+ * callback returns. When the pool is empty, the first frame is refused with
+ * an FC overflow instead of allocating. Outgoing messages are copied once
+ * into a pool buffer, so send() returns immediately.
+ *
+ * Nothing sleeps: consecutive frames are due at deadlines (STmin after the
+ * previous one, or at once for STmin 0, in which case a whole block goes out
+ * back to back) and so are the N_Bs/N_Cr timeouts. poll() sends what is due,
+ * expires what is late and returns the next deadline, which the receive loop
+ * uses as its wait timeout.
+ *
+ * Usage over a CAN socket (own thread):
+ * @code
+ * IsoTpEngine engine(socket);
+ * std::size_t ecu = engine.add_channel({0x7E0, 0x7E8});
+ * engine.on_receive([](std::size_t, const uint8_t* data, std::size_t size) {
+ *     handle_uds_response(data, size);    // data is valid until return
+ * });
+ * engine.start();
+ * engine.send(ecu, request.data(), request.size());
+ * @endcode
+ *
+ * Usage over a USBAdapter (caller's loop):
+ * @code
+ * IsoTpEngine engine(IsoTpEngine::adapter_sender(adapter));
+ * ...
+ * for (const auto& frame : decoded_frames) engine.process(frame);
+ * auto next_deadline = engine.poll();
+ * @endcode
+ */
+
+#pragma once
+
+#include <linux/can.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../io/can_socket.hpp"
+
+namespace waveshare {
+
+    class USBAdapter;
+
+    namespace isotp {
+        // Protocol control information, high nibble of the first data byte
+        constexpr uint8_t PCI_SINGLE_FRAME = 0x00;
+        constexpr uint8_t PCI_FIRST_FRAME = 0x10;
+        constexpr uint8_t PCI_CONSECUTIVE_FRAME = 0x20;
+        constexpr uint8_t PCI_FLOW_CONTROL = 0x30;
+        constexpr uint8_t PCI_TYPE_MASK = 0xF0;
+
+        constexpr std::size_t SF_MAX_DATA = 7;
+        constexpr std::size_t FF_DATA = 6;
+        constexpr std::size_t CF_DATA = 7;
+        constexpr std::size_t MAX_MESSAGE_SIZE = 4095;    ///< 12-bit FF_DL
+
+        /**
+         * @brief Flow status of a flow-control frame
+         */
+        enum class FlowStatus : uint8_t {
+            CONTINUE = 0,   ///< Clear to send BS more frames
+            WAIT = 1,       ///< Keep waiting for another FC
+            OVERFLOW = 2    ///< Message too large for the receiver
+        };
+
+        /**
+         * @brief Decode an STmin byte
+         *
+         * 0x00-0x7F are milliseconds, 0xF1-0xF9 are 100-900 microseconds;
+         * reserved values mean the maximum, 127 ms.
+         */
+        inline std::chrono::microseconds stmin_to_duration(uint8_t st_min) {
+            if (st_min <= 0x7F) {
+                return std::chrono::milliseconds(st_min);
+            }
+            if (st_min >= 0xF1 && st_min <= 0xF9) {
+                return std::chrono::microseconds(100 * (st_min - 0xF0));
+            }
+            return std::chrono::milliseconds(0x7F);
+        }
+    }  // namespace isotp
+
+    /**
+     * @brief Outcome of a transfer
+     */
+    enum class IsoTpResult : uint8_t {
+        OK,
+        TIMEOUT_BS,         ///< No flow control in time (sender)
+        TIMEOUT_CR,         ///< No consecutive frame in time (receiver)
+        WRONG_SN,           ///< Consecutive frame out of sequence (receiver)
+        UNEXPECTED_PDU,     ///< New SF/FF interrupted a reception, or invalid FC
+        OVERFLOW,           ///< Peer refused the message (sender)
+        WFT_OVERRUN,        ///< Too many FC WAIT frames (sender)
+        NO_BUFFER,          ///< Buffer pool empty
+        BUSY,               ///< Channel is already sending
+        SEND_ERROR          ///< The transport refused a frame
+    };
+
+    /**
+     * @brief One channel: the ID pair and what this side advertises
+     *
+     * IDs are SocketCAN can_ids; set CAN_EFF_FLAG for 29-bit identifiers.
+     */
+    struct IsoTpChannelConfig {
+        uint32_t tx_id = 0;             ///< Our SF/FF/CF and FC frames
+        uint32_t rx_id = 0;             ///< Peer frames, unique per engine
+        uint8_t block_size = 0;         ///< BS we advertise (0 = no further FC)
+        uint8_t st_min = 0;             ///< STmin we advertise (ISO encoding)
+        bool pad = true;                ///< Pad frames to 8 bytes
+        uint8_t padding = 0xCC;
+        std::chrono::milliseconds timeout{1000};    ///< N_Bs and N_Cr
+        uint8_t max_wait_frames = 10;   ///< N_WFTmax
+    };
+
+    /**
+     * @brief Engine-wide settings
+     */
+    struct IsoTpEngineConfig {
+        std::size_t pool_buffers = 16;                  ///< Shared by all channels
+        std::size_t buffer_size = isotp::MAX_MESSAGE_SIZE;
+        std::chrono::milliseconds idle_wait{100};       ///< Longest receive wait
+    };
+
+    /**
+     * @brief Engine counters
+     */
+    struct IsoTpStatistics {
+        uint64_t messages_sent = 0;
+        uint64_t messages_received = 0;
+        uint64_t frames_sent = 0;
+        uint64_t frames_received = 0;   ///< Frames on a channel rx_id
+        uint64_t timeouts = 0;
+        uint64_t sequence_errors = 0;
+        uint64_t interrupted = 0;       ///< Receptions cut short by a new SF/FF
+        uint64_t overflows = 0;         ///< FFs refused for lack of a buffer
+        uint64_t send_errors = 0;
+    };
+
+    /**
+     * @class IsoTpBufferPool
+     * @brief Fixed set of message buffers in one allocation
+     *
+     * Not thread-safe; the engine uses it under its lock.
+     */
+    class IsoTpBufferPool {
+        public:
+            static constexpr int NONE = -1;
+
+            IsoTpBufferPool(std::size_t count, std::size_t buffer_size);
+
+            /**
+             * @brief Take a free buffer
+             * @return Buffer index, or NONE if all are in use
+             */
+            int acquire();
+            void release(int index);
+
+            uint8_t* data(int index) {
+                return storage_.data() + static_cast<std::size_t>(index) * buffer_size_;
+            }
+            std::size_t buffer_size() const { return buffer_size_; }
+            std::size_t available() const { return free_.size(); }
+
+        private:
+            std::size_t buffer_size_;
+            std::vector<uint8_t> storage_;
+            std::vector<int> free_;
+    };
+
+    /**
+     * @class IsoTpEngine
+     * @brief ISO-TP channels over one CAN transport
+     */
+    class IsoTpEngine {
+        public:
+            using Clock = std::chrono::steady_clock;
+
+            /**
+             * @brief Transmits one CAN frame
+             * @return false if the frame could not be sent
+             */
+            using SendFunction = std::function<bool(const struct can_frame&)>;
+
+            /**
+             * @brief Called with each complete message
+             * @param data Reassembly buffer, valid until the callback returns
+             */
+            using ReceiveCallback = std::function<void(std::size_t channel,
+                const uint8_t* data, std::size_t size)>;
+
+            /**
+             * @brief Called once for every send() that returned OK, when the
+             *        message is out (OK) or the transfer failed
+             */
+            using SendCallback = std::function<void(std::size_t channel, IsoTpResult result)>;
+
+            /**
+             * @brief Engine on a CAN socket; start() runs the receive loop
+             */
+            explicit IsoTpEngine(std::shared_ptr<ICANSocket> socket,
+                const IsoTpEngineConfig& config = {});
+
+            /**
+             * @brief Engine on any transport; the caller feeds process() and poll()
+             */
+            explicit IsoTpEngine(SendFunction send, const IsoTpEngineConfig& config = {});
+
+            ~IsoTpEngine();
+
+            IsoTpEngine(const IsoTpEngine&) = delete;
+            IsoTpEngine& operator=(const IsoTpEngine&) = delete;
+
+            /**
+             * @brief SendFunction writing to a Waveshare adapter
+             */
+            static SendFunction adapter_sender(std::shared_ptr<USBAdapter> adapter);
+
+            /**
+             * @brief Add a channel
+             * @return Channel handle for send()
+             * @throws std::invalid_argument if rx_id is already used or the
+             *         timeout is not positive
+             */
+            std::size_t add_channel(const IsoTpChannelConfig& config);
+
+            void on_receive(ReceiveCallback callback);
+            void on_send_complete(SendCallback callback);
+
+            /**
+             * @brief Queue a message; SF/FF go out at once, CFs from poll()
+             * @return OK, BUSY, NO_BUFFER or SEND_ERROR (a larger message
+             *         than the pool buffers is NO_BUFFER)
+             * @throws std::out_of_range on an unknown channel
+             * @throws std::invalid_argument on an empty message or one above
+             *         isotp::MAX_MESSAGE_SIZE
+             */
+            IsoTpResult send(std::size_t channel, const uint8_t* data, std::size_t size,
+                Clock::time_point now = Clock::now());
+
+            /**
+             * @brief Handle a received frame (ignored if not on a channel rx_id)
+             */
+            void process(const struct can_frame& frame, Clock::time_point now = Clock::now());
+
+            /**
+             * @brief Send due consecutive frames and expire late transfers
+             * @return Next deadline, or time_point::max() if nothing is pending
+             */
+            Clock::time_point poll(Clock::time_point now = Clock::now());
+
+            /**
+             * @brief Start the receive loop (socket constructor only)
+             * @throws std::logic_error without a socket
+             */
+            void start();
+            void stop();
+            bool is_running() const { return running_.load(); }
+
+            IsoTpStatistics get_statistics() const;
+            std::size_t available_buffers() const;
+
+        private:
+            enum class RxState : uint8_t { IDLE, RECEIVING };
+            enum class TxState : uint8_t { IDLE, WAIT_FC, SENDING };
+
+            struct Channel {
+                IsoTpChannelConfig config;
+
+                RxState rx_state = RxState::IDLE;
+                int rx_buffer = IsoTpBufferPool::NONE;
+                std::size_t rx_size = 0;
+                std::size_t rx_received = 0;
+                uint8_t rx_sn = 0;
+                uint8_t rx_block_count = 0;
+                Clock::time_point rx_deadline;
+
+                TxState tx_state = TxState::IDLE;
+                int tx_buffer = IsoTpBufferPool::NONE;
+                std::size_t tx_size = 0;
+                std::size_t tx_sent = 0;
+                uint8_t tx_sn = 0;
+                uint8_t tx_block_size = 0;
+                uint8_t tx_block_remaining = 0;
+                uint8_t tx_wait_count = 0;
+                std::chrono::microseconds tx_st_min{0};
+                Clock::time_point tx_deadline;      ///< N_Bs while WAIT_FC, next CF while SENDING
+            };
+
+            /**
+             * @brief Message or send result handed to the callbacks after unlocking
+             */
+            struct Event {
+                std::size_t channel;
+                IsoTpResult result;
+                bool received;
+                int buffer;                 ///< NONE for a single frame
+                std::size_t size;
+                uint8_t single[isotp::SF_MAX_DATA];
+            };
+
+            bool send_frame(Channel& channel, const uint8_t* data, std::size_t size);
+            bool send_flow_control(Channel& channel, isotp::FlowStatus status);
+            void handle_single(std::size_t index, const struct can_frame& frame);
+            void handle_first(std::size_t index, const struct can_frame& frame,
+                Clock::time_point now);
+            void handle_consecutive(std::size_t index, const struct can_frame& frame,
+                Clock::time_point now);
+            void handle_flow_control(std::size_t index, const struct can_frame& frame,
+                Clock::time_point now);
+            void abort_reception(std::size_t index, IsoTpResult result);
+            void finish_send(std::size_t index, IsoTpResult result);
+            void send_consecutive(std::size_t index, Clock::time_point now);
+            void dispatch_events(std::unique_lock<std::mutex>& lock);
+            void receive_loop();
+
+            std::shared_ptr<ICANSocket> socket_;
+            SendFunction send_;
+            IsoTpEngineConfig config_;
+
+            mutable std::mutex mutex_;
+            IsoTpBufferPool pool_;
+            std::vector<Channel> channels_;
+            std::unordered_map<uint32_t, std::size_t> by_rx_id_;
+            std::vector<Event> events_;
+            IsoTpStatistics stats_;
+            // Shared so dispatch_events() can call them without the lock
+            std::shared_ptr<const ReceiveCallback> receive_callback_;
+            std::shared_ptr<const SendCallback> send_callback_;
+
+            std::atomic<bool> running_{false};
+            std::thread thread_;
+    };
+
+}  // namespace waveshare
@@ -0,0 +1,245 @@
+/**
+ * @file load_generator.hpp
+ * @brief Paced CAN traffic generator for bus-load testing
+ * @version 1.0
+ * @date 2025-11-22
+ *
+ * Generates CAN traffic at a controlled rate:
+ * - Frames are drawn once, at construction, from the ID and DLC
+ *   distributions of a LoadProfile into a pool, and pre-encoded in the
+ *   Waveshare protocol; sending costs no allocation or serialization
+ * - The pool is sent in batches of consecutive frames (one write() each)
+ * - Batches are paced on absolute deadlines computed from the start time,
+ *   so sleep overshoot and write jitter never accumulate into drift
+ * - The pace comes either from a fixed gap between frames or from a target
+ *   bus load: each frame then occupies can_frame_bits() / (bit rate × load)
+ *   seconds
+ *
+ * Usage:
+ * @code
+ * LoadGeneratorConfig config;
+ * config.can_baud = CANBaud::BAUD_500K;
+ * config.bus_load_percent = 60.0;
+ * config.batch_size = 8;
+ * LoadGenerator generator(LoadProfile::from_file("config/load_profile.json"), config);
+ * std::atomic<bool> running{true};
+ * generator.run([&](const LoadBatch& batch) {
+ *     return adapter->send_encoded(batch.bytes, batch.size) > 0;
+ * }, running);
+ * @endcode
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#pragma once
+
+#include <linux/can.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "../enums/protocol.hpp"
+
+namespace waveshare {
+
+    /**
+     * @brief Distributions of the generated traffic
+     *
+     * JSON format (weights are relative):
+     * @code
+     * {
+     *   "load_profile": {
+     *     "ids": [
+     *       {"id": "0x181", "weight": 4},
+     *       {"id": "0x18FF0001", "extended": true, "weight": 1}
+     *     ],
+     *     "dlc": [
+     *       {"dlc": 8, "weight": 3},
+     *       {"dlc": 2, "weight": 1}
+     *     ]
+     *   }
+     * }
+     * @endcode
+     */
+    struct LoadProfile {
+        struct IdEntry {
+            std::uint32_t id;
+            bool extended;
+            double weight;
+        };
+
+        struct DlcEntry {
+            std::uint8_t dlc;
+            double weight;
+        };
+
+        std::vector<IdEntry> ids;
+        std::vector<DlcEntry> dlcs;
+
+        /**
+         * @brief Validate the profile
+         * @throws std::invalid_argument on an empty distribution, an ID out of
+         *         range, a DLC above 8 or a weight that is not positive
+         */
+        void validate() const;
+
+        /**
+         * @brief Profile with one ID and one DLC
+         */
+        static LoadProfile single(std::uint32_t id, std::uint8_t dlc);
+
+        /**
+         * @brief Load a profile from a JSON object containing load_profile
+         * @throws std::invalid_argument if the JSON is malformed
+         */
+        static LoadProfile from_json(const nlohmann::json& j);
+
+        /**
+         * @brief Load a profile from a JSON file
+         * @throws std::runtime_error if the file cannot be read or parsed
+         * @throws std::invalid_argument if the profile is malformed
+         */
+        static LoadProfile from_file(const std::string& filepath);
+    };
+
+    /**
+     * @brief Load generator settings
+     */
+    struct LoadGeneratorConfig {
+        CANBaud can_baud = DEFAULT_CAN_BAUD;    ///< Bus rate the load is computed for
+
+        /**
+         * @brief Target share of the bus bit rate in percent (0 = use gap)
+         */
+        double bus_load_percent = 0.0;
+
+        /**
+         * @brief Interval between frame starts when bus_load_percent is 0
+         */
+        std::chrono::microseconds gap{1000};
+
+        std::size_t batch_size = 1;     ///< Frames per write()
+        std::size_t pool_size = 4096;   ///< Pre-encoded frames, rounded up to batch_size
+        std::uint64_t count = 0;        ///< Frames to send (0 = until stopped)
+
+        /**
+         * @brief Consecutive refused batches that end a counted run (0 = never)
+         *
+         * Refused batches are retried and do not count toward count, so
+         * without this limit a dead transport would keep a counted run going.
+         */
+        std::uint64_t max_send_failures = 1000;
+        bool fixed_frames = false;      ///< Encode 20-byte FixedFrames instead of VariableFrames
+        std::uint32_t seed = 1;         ///< Seed of the ID, DLC and payload draws
+
+        /**
+         * @brief Period of the statistics callback
+         */
+        std::chrono::milliseconds stats_interval{1000};
+    };
+
+    /**
+     * @brief Consecutive pool frames sent together
+     */
+    struct LoadBatch {
+        const struct can_frame* frames;     ///< SocketCAN form
+        std::size_t count;
+        const std::uint8_t* bytes;          ///< Waveshare protocol form, contiguous
+        std::size_t size;
+    };
+
+    /**
+     * @brief Counters of a load generator run (or of one stats interval)
+     */
+    struct LoadStatistics {
+        std::uint64_t frames_sent = 0;
+        std::uint64_t batches_sent = 0;
+        std::uint64_t bytes_sent = 0;       ///< Waveshare protocol bytes
+        std::uint64_t bits_sent = 0;        ///< CAN bus bit times
+        std::uint64_t send_errors = 0;      ///< Batches the send function refused
+        bool gave_up = false;               ///< Counted run ended by max_send_failures
+        std::uint64_t late_batches = 0;     ///< Sent more than one batch period late
+        std::chrono::microseconds max_lateness{0};
+        std::chrono::microseconds elapsed{0};
+
+        /**
+         * @brief Frames per second
+         */
+        double frame_rate() const;
+
+        /**
+         * @brief Bus occupation in percent of the given bit rate
+         */
+        double bus_load_percent(CANBaud can_baud) const;
+    };
+
+    /**
+     * @class LoadGenerator
+     * @brief Sends a pre-encoded frame pool at a controlled rate
+     *
+     * Not thread-safe; run() blocks the calling thread and spins for the last
+     * part of each wait, so gaps of a few microseconds are honoured.
+     */
+    class LoadGenerator {
+        public:
+            /**
+             * @brief Send one batch; false if it could not be sent
+             */
+            using SendFunction = std::function<bool (const LoadBatch& batch)>;
+
+            /**
+             * @brief Called every stats_interval with the interval and run totals
+             */
+            using StatsCallback = std::function<void (const LoadStatistics& interval,
+                const LoadStatistics& total)>;
+
+            /**
+             * @brief Draw and encode the frame pool
+             * @throws std::invalid_argument on an invalid profile or configuration
+             */
+            LoadGenerator(const LoadProfile& profile, const LoadGeneratorConfig& config);
+
+            /**
+             * @brief Send batches until count frames are sent, running turns false
+             *        or max_send_failures batches in a row are refused
+             * @param send Transport (must not throw)
+             * @param running Cleared by another thread or a signal handler to stop
+             * @param on_stats Optional periodic statistics callback
+             * @return LoadStatistics Totals of the run
+             */
+            LoadStatistics run(const SendFunction& send, const std::atomic<bool>& running,
+                const StatsCallback& on_stats = nullptr);
+
+            const std::vector<struct can_frame>& frames() const { return frames_; }
+            const std::vector<std::uint8_t>& encoded() const { return encoded_; }
+
+            /**
+             * @brief Frames per second the schedule targets
+             */
+            double target_frame_rate() const;
+
+            const LoadGeneratorConfig& config() const { return config_; }
+
+        private:
+            using Clock = std::chrono::steady_clock;
+
+            LoadGeneratorConfig config_;
+            std::vector<struct can_frame> frames_;
+            std::vector<std::uint8_t> encoded_;
+            std::vector<std::size_t> offsets_;          ///< Byte offset of each frame (+ end)
+            std::vector<std::uint32_t> bits_;           ///< Bus bits of each batch
+            std::vector<Clock::duration> periods_;      ///< Schedule slot of each batch
+            Clock::duration cycle_{0};                  ///< Schedule of the whole pool
+
+            /**
+             * @brief Sleep, then spin, until the deadline
+             */
+            static void wait_until(Clock::time_point deadline);
+    };
+
+}  // namespace waveshare
@@ -47,6 +47,8 @@ namespace waveshare {
         std::atomic<uint64_t> socketcan_rx_errors{0};  ///< SocketCAN receive errors
         std::atomic<uint64_t> socketcan_tx_errors{0};  ///< SocketCAN send errors
         std::atomic<uint64_t> conversion_errors{0};    ///< Frame conversion failures
+        std::atomic<uint64_t> rule_rewrites{0};        ///< Frames a gateway rule matched
+        std::atomic<uint64_t> rule_drops{0};           ///< Frames a gateway rule dropped
 
         /**
          * @brief Reset all counters to zero
@@ -61,6 +63,8 @@ namespace waveshare {
             socketcan_rx_errors.store(0, std::memory_order_relaxed);
             socketcan_tx_errors.store(0, std::memory_order_relaxed);
             conversion_errors.store(0, std::memory_order_relaxed);
+            rule_rewrites.store(0, std::memory_order_relaxed);
+            rule_drops.store(0, std::memory_order_relaxed);
         }
 
         /**
@@ -87,7 +91,11 @@ namespace waveshare {
                 << "  CAN TX Errors: " << std::setw(10) <<
                 socketcan_tx_errors.load(std::memory_order_relaxed) << "\n"
                 << "  Conv Errors:   " << std::setw(10) <<
-                conversion_errors.load(std::memory_order_relaxed);
+                conversion_errors.load(std::memory_order_relaxed) << "\n"
+                << "  Rule Rewrites: " << std::setw(10) <<
+                rule_rewrites.load(std::memory_order_relaxed) << "\n"
+                << "  Rule Drops:    " << std::setw(10) <<
+                rule_drops.load(std::memory_order_relaxed);
             return oss.str();
         }
     };
@@ -107,6 +115,8 @@ namespace waveshare {
         uint64_t socketcan_rx_errors;
         uint64_t socketcan_tx_errors;
         uint64_t conversion_errors;
+        uint64_t rule_rewrites;
+        uint64_t rule_drops;
 
         /**
          * @brief Get human-readable statistics string
@@ -123,7 +133,9 @@ namespace waveshare {
                 << "  USB TX Errors: " << std::setw(10) << usb_tx_errors << "\n"
                 << "  CAN RX Errors: " << std::setw(10) << socketcan_rx_errors << "\n"
                 << "  CAN TX Errors: " << std::setw(10) << socketcan_tx_errors << "\n"
-                << "  Conv Errors:   " << std::setw(10) << conversion_errors;
+                << "  Conv Errors:   " << std::setw(10) << conversion_errors << "\n"
+                << "  Rule Rewrites: " << std::setw(10) << rule_rewrites << "\n"
+                << "  Rule Drops:    " << std::setw(10) << rule_drops;
             return oss.str();
         }
     };
@@ -193,6 +205,8 @@ namespace waveshare {
      * - Dual-threaded concurrent forwarding
      * - Lock-free performance statistics
      * - Configurable timeouts, filters, and error handling
+     * - Gateway rules (GatewayRuleEngine): ID remapping, payload transforms
+     *   and drops, applied to the can_frame in each forwarding thread
      * - Optional frame-level callbacks for monitoring
      * - Clean lifecycle management (start/stop/destructor)
      *
@@ -274,6 +288,12 @@ namespace waveshare {
                 return adapter_.get();
             }
 
+            /**
+             * @brief Get the compiled gateway rules
+             * @return const GatewayRuleEngine& Rules built from the configuration
+             */
+            const GatewayRuleEngine& get_rules() const { return rules_; }
+
             /**
              * @brief Get statistics snapshot
              * @return BridgeStatisticsSnapshot Non-atomic copy of current statistics
@@ -307,6 +327,8 @@ namespace waveshare {
              * @brief Set callback for USB → SocketCAN frame forwarding
              * @param callback Function called with (VariableFrame, can_frame) when frame is forwarded
              *
+             * The can_frame is the one written to SocketCAN, after the gateway rules.
+             *
              * Callback signature: void(const VariableFrame& usb_frame, const ::can_frame& socketcan_frame)
              * Called from USB→SocketCAN thread, should be thread-safe and non-blocking.
              */
@@ -319,6 +341,8 @@ namespace waveshare {
              * @brief Set callback for SocketCAN → USB frame forwarding
              * @param callback Function called with (can_frame, VariableFrame) when frame is forwarded
              *
+             * Both frames are the ones sent to the adapter, after the gateway rules.
+             *
              * Callback signature: void(const ::can_frame& socketcan_frame, const VariableFrame& usb_frame)
              * Called from SocketCAN→USB thread, should be thread-safe and non-blocking.
              */
@@ -335,6 +359,9 @@ namespace waveshare {
             std::unique_ptr<ICANSocket> can_socket_;  // Injected CAN socket (real or mock)
             std::unique_ptr<USBAdapter> adapter_;     // USB adapter
 
+            // === Gateway Rules (immutable, shared by both threads) ===
+            GatewayRuleEngine rules_;
+
             // === Statistics ===
             BridgeStatistics stats_;
 
@@ -385,6 +412,12 @@ namespace waveshare {
              * Uses select() for timeout handling. Runs while running_ flag is true.
              */
             void socketcan_to_usb_loop();
+
+            /**
+             * @brief Run the gateway rules on a frame about to be forwarded
+             * @return bool False if the frame must be dropped
+             */
+            bool apply_rules(RuleDirection direction, struct can_frame& cf);
     };
 
 } // namespace waveshare
@@ -30,10 +30,70 @@
 #include <shared_mutex>
 #include <chrono>
 #include "../io/serial_port.hpp"
+#include "../io/io_backend.hpp"
 #include <memory>
+#include <optional>
+#include <vector>
 
 namespace waveshare {
 
+    /**
+     * @brief Settings for USBAdapter::autobaud()
+     */
+    struct AutobaudConfig {
+        /**
+         * @brief Rates to try, in order (empty = every CANBaud, most common first)
+         *
+         * The rate detected by the previous autobaud() is always tried first.
+         */
+        std::vector<CANBaud> candidates;
+
+        /**
+         * @brief Listening window per candidate on the first pass
+         *
+         * Each pass over the candidates doubles the window up to max_window,
+         * so a busy bus is found quickly and a quiet one still gets a chance.
+         */
+        std::chrono::milliseconds initial_window{50};
+        std::chrono::milliseconds max_window{800};
+
+        /**
+         * @brief Time given to the adapter to apply each ConfigFrame
+         */
+        std::chrono::milliseconds settle{20};
+
+        /**
+         * @brief Valid frames needed to accept a rate
+         */
+        std::size_t frames_required = 1;
+
+        /**
+         * @brief Mode configured at the detected rate (SILENT to stay passive)
+         */
+        CANMode final_mode = CANMode::NORMAL;
+
+        /**
+         * @brief Settings applied with final_mode
+         *
+         * Rates are sampled with an accept-all filter so no traffic is hidden.
+         */
+        RTX auto_rtx = RTX::AUTO;
+        std::uint32_t filter = 0;
+        std::uint32_t mask = 0;
+    };
+
+    /**
+     * @brief Outcome of USBAdapter::autobaud()
+     */
+    struct AutobaudResult {
+        bool detected = false;
+        CANBaud baud_rate = DEFAULT_CAN_BAUD;   ///< Valid when detected
+        std::size_t frames = 0;                 ///< Valid frames seen at baud_rate
+        std::size_t errors = 0;                 ///< Malformed frames, all candidates
+        std::size_t attempts = 0;               ///< Candidate windows sampled
+        std::chrono::milliseconds elapsed{0};
+    };
+
     /**
      * @brief Thread-safe USB-CAN adapter interface with dependency injection
      *
@@ -91,10 +151,11 @@ namespace waveshare {
             SerialBaud baudrate_;   // e.g., SerialBaud::BAUD_2M
             bool is_configured_ = false; // Flag to indicate if the port is configured
             bool is_monitoring_ = false;  // Flag to indicate if monitoring is active
+            std::optional<CANBaud> detected_can_baud_;  // Last autobaud() result
             static inline volatile std::sig_atomic_t stop_flag = false; // Flag to indicate if a stop signal was received
 
             // # Thread-safety primitives
-            mutable std::shared_mutex state_mutex_;  // Protects is_configured_
+            mutable std::shared_mutex state_mutex_;  // Protects is_configured_, detected_can_baud_
             std::mutex write_mutex_;                 // Exclusive write lock
             std::mutex read_mutex_;                  // Exclusive read lock
 
@@ -159,6 +220,17 @@ namespace waveshare {
              */
             void read_exact(std::uint8_t* buffer, std::size_t size, int timeout_ms);
 
+            /**
+             * @brief Send a ConfigFrame (DEFAULT_CONF_TYPE) for the given settings, then wait settle
+             */
+            void configure_can(CANBaud baud_rate, CANMode mode, RTX auto_rtx, std::uint32_t filter,
+                std::uint32_t mask, std::chrono::milliseconds settle);
+
+            /**
+             * @brief Drop bytes already queued by the adapter (at most a serial buffer)
+             */
+            void discard_input();
+
 
         public:
             /**
@@ -174,10 +246,11 @@ namespace waveshare {
              * @brief Factory method to create USBAdapter with real hardware
              * @param usb_dev Device path (e.g., "/dev/ttyUSB0")
              * @param baudrate Serial baud rate
+             * @param backend Serial port implementation (see io_backend.hpp)
              * @return std::unique_ptr<USBAdapter> Configured adapter ready to use
              */
             static std::unique_ptr<USBAdapter> create(const std::string& usb_dev,
-                SerialBaud baudrate = DEFAULT_SERIAL_BAUD);
+                SerialBaud baudrate = DEFAULT_SERIAL_BAUD, IoBackend backend = IoBackend::POSIX);
 
             // USBAdapter instance
 
@@ -308,6 +381,29 @@ namespace waveshare {
                 return bytes_written;
             }
 
+            /**
+             * @brief Send already serialized frames in a single write
+             *
+             * For senders that encode frames ahead of time (e.g. LoadGenerator
+             * batches): the bytes of several frames reach the adapter in one
+             * system call, with no per-frame serialization.
+             * @note This method is thread-safe; the whole buffer is written under write_mutex_.
+             * @param data Concatenated Waveshare protocol frames
+             * @param size Number of bytes
+             * @return int Bytes written (always size)
+             * @throws DeviceException if port not open or write fails
+             * @throws ProtocolException on invalid parameters or a partial write
+             */
+            int send_encoded(const std::uint8_t* data, std::size_t size) {
+                int bytes_written = write_bytes(data, size);
+                if (bytes_written != static_cast<int>(size)) {
+                    throw ProtocolException(Status::DNOT_OPEN,
+                        "send_encoded: Partial write " + std::to_string(bytes_written) +
+                        "/" + std::to_string(size));
+                }
+                return bytes_written;
+            }
+
             /**
              * @brief Receive a fixed-size Waveshare data frame from the USB adapter
              * This method reads exactly 20 bytes from the serial port and parses it into a FixedFrame object using deserialize().
@@ -341,6 +437,54 @@ namespace waveshare {
              */
 
             VariableFrame receive_variable_frame(int timeout_ms = 1000);
+
+            /**
+             * @brief Receive whatever raw bytes the adapter has queued
+             *
+             * For stream consumers (e.g. FrameStreamDecoder) that parse many
+             * frames per read instead of assembling one frame per call. Waits
+             * up to timeout_ms in poll() on the port descriptor when nothing
+             * is queued yet.
+             * @note This method is thread-safe; the read runs under read_mutex_.
+             * @param buffer Destination buffer
+             * @param size Buffer capacity
+             * @param timeout_ms Maximum time to wait for the first byte
+             * @return int Bytes read (0 on timeout)
+             * @throws DeviceException if port not open or read fails
+             * @throws ProtocolException on invalid parameters
+             */
+            int receive_bytes(std::uint8_t* buffer, std::size_t size, int timeout_ms = 100);
+
+            // === CAN Bit-Rate Detection ===
+
+            /**
+             * @brief Detect the CAN bus bit rate without transmitting
+             *
+             * The adapter is switched to CANMode::SILENT (listen-only: no ACK,
+             * no error frames, nothing that can disturb the bus) and listens at
+             * each candidate rate. A window ends as soon as enough valid frames
+             * arrive (rate found) or a malformed frame shows the rate is wrong.
+             * Unanswered candidates are retried with a doubled window until
+             * max_window. The bus must carry some traffic (heartbeats, PDOs).
+             *
+             * On success the adapter is left at the detected rate in
+             * config.final_mode, with the configured filter, mask and RTX;
+             * otherwise it stays silent at the last candidate.
+             * No other thread may read from the adapter meanwhile.
+             *
+             * @param config Candidates, windows and final settings
+             * @return AutobaudResult detected flag, rate and sampling counters
+             * @throws DeviceException if the port fails
+             */
+            AutobaudResult autobaud(const AutobaudConfig& config = {});
+
+            /**
+             * @brief Rate found by the last successful autobaud(), if any
+             */
+            std::optional<CANBaud> detected_can_baud() const {
+                std::shared_lock<std::shared_mutex> lock(state_mutex_);
+                return detected_can_baud_;
+            }
     };
 
 }     // namespace USBCANBridge
\ No newline at end of file
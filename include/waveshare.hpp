@@ -34,4 +34,18 @@
 #include "pattern/bridge_config.hpp"
 // Include the SocketCAN bridge
 #include "pattern/socketcan_bridge.hpp"
+// Include the load generator
+#include "pattern/load_generator.hpp"
+#include "io/frame_stream_decoder.hpp"
+#include "io/capture_writer.hpp"
+#include "io/capture_file.hpp"
+#include "pattern/bus_analyzer.hpp"
+#include "pattern/isotp_engine.hpp"
+#include "pattern/adapter_emulator.hpp"
+#include "io/usb_can_socket.hpp"
+#include "io/local_can_bus.hpp"
+#include "io/uring_context.hpp"
+#include "io/uring_serial_port.hpp"
+#include "io/uring_can_socket.hpp"
+#include "io/io_backend.hpp"
 
@@ -0,0 +1,199 @@
+/**
+ * @file bus_analyzer.cpp
+ * @brief Per-ID periodicity, jitter and bus-load report from a capture
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-24
+ *
+ * Reads a binary capture written by `wave_reader -o` and prints, for every
+ * CAN ID, its estimated period, jitter percentiles, missed cycles and
+ * bursts, plus the bus load over time:
+ *
+ *   ./bus_analyzer -b 500000 -r 100 -t timeline.csv bus.wscap
+ */
+
+#include "../include/io/capture_file.hpp"
+#include "../include/pattern/bus_analyzer.hpp"
+#include <linux/can.h>
+#include <chrono>
+#include <fstream>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace waveshare;
+
+namespace {
+
+    struct AnalyzerOptions {
+        std::string capture;
+        std::string timeline_csv;
+        int bit_rate = 1000000;
+        double resolution_ms = 10.0;
+        int threads = 0;
+        double missed_factor = 1.5;
+        double burst_factor = 0.5;
+        double jitter_limit = 0.1;
+    };
+
+    void print_usage(const char* name) {
+        std::cout << "Usage: " << name << " [options] <capture>\n"
+                  << "  -b, --bitrate <bps>      CAN bit rate (default: 1000000)\n"
+                  << "  -r, --resolution <ms>    Load timeline bin width (default: 10)\n"
+                  << "  -j, --threads <n>        Worker threads, 0 = one per core (default: 0)\n"
+                  << "  -t, --timeline <file>    Write the load timeline as CSV\n"
+                  << "  -m, --missed <factor>    Gap > factor x period is a missed cycle\n"
+                  << "                           (default: 1.5)\n"
+                  << "  -u, --burst <factor>     Gap < factor x period is a burst (default: 0.5)\n"
+                  << "  -J, --jitter <fraction>  Flag IDs whose p99 jitter exceeds this share\n"
+                  << "                           of their period (default: 0.1)\n"
+                  << "  -h, --help               Show this help\n"
+                  << "\nThe capture is a binary file written by wave_reader -o <file>.\n";
+    }
+
+    AnalyzerOptions parse_options(int argc, char* argv[]) {
+        static const struct option long_options[] = {
+            {"bitrate", required_argument, nullptr, 'b'},
+            {"resolution", required_argument, nullptr, 'r'},
+            {"threads", required_argument, nullptr, 'j'},
+            {"timeline", required_argument, nullptr, 't'},
+            {"missed", required_argument, nullptr, 'm'},
+            {"burst", required_argument, nullptr, 'u'},
+            {"jitter", required_argument, nullptr, 'J'},
+            {"help", no_argument, nullptr, 'h'},
+            {nullptr, 0, nullptr, 0}
+        };
+
+        AnalyzerOptions options;
+        int opt;
+        while ((opt = getopt_long(argc, argv, "b:r:j:t:m:u:J:h", long_options,
+            nullptr)) != -1) {
+            switch (opt) {
+            case 'b': options.bit_rate = std::stoi(optarg); break;
+            case 'r': options.resolution_ms = std::stod(optarg); break;
+            case 'j': options.threads = std::stoi(optarg); break;
+            case 't': options.timeline_csv = optarg; break;
+            case 'm': options.missed_factor = std::stod(optarg); break;
+            case 'u': options.burst_factor = std::stod(optarg); break;
+            case 'J': options.jitter_limit = std::stod(optarg); break;
+            case 'h': print_usage(argv[0]); std::exit(0);
+            default: print_usage(argv[0]); std::exit(1);
+            }
+        }
+        if (optind != argc - 1) {
+            print_usage(argv[0]);
+            std::exit(1);
+        }
+        options.capture = argv[optind];
+        return options;
+    }
+
+    std::string format_id(std::uint32_t can_id) {
+        std::ostringstream oss;
+        oss << std::hex << std::uppercase << std::setfill('0');
+        if (can_id & CAN_EFF_FLAG) {
+            oss << std::setw(8) << (can_id & CAN_EFF_MASK);
+        } else {
+            oss << std::setw(3) << (can_id & CAN_SFF_MASK);
+        }
+        if (can_id & CAN_RTR_FLAG) {
+            oss << " R";
+        }
+        return oss.str();
+    }
+
+    std::string format_flags(const IdStatistics& stats, double jitter_limit) {
+        std::string flags;
+        if (stats.missed_cycles > 0) flags += "MISSED ";
+        if (stats.bursts > 0) flags += "BURST ";
+        if (stats.period_us > 0.0 && stats.jitter_p99_us > jitter_limit * stats.period_us) {
+            flags += "JITTER ";
+        }
+        return flags;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    AnalyzerOptions options = parse_options(argc, argv);
+
+    try {
+        bool unsupported = false;
+        BusAnalyzerConfig config;
+        config.can_baud = canbaud_from_int(options.bit_rate, unsupported);
+        if (unsupported) {
+            std::cerr << "Unsupported CAN bit rate: " << options.bit_rate << std::endl;
+            return 1;
+        }
+        config.resolution = std::chrono::microseconds(
+            static_cast<std::int64_t>(options.resolution_ms * 1000.0));
+        config.threads = static_cast<std::size_t>(std::max(options.threads, 0));
+        config.missed_factor = options.missed_factor;
+        config.burst_factor = options.burst_factor;
+        BusAnalyzer analyzer(config);
+
+        auto start = std::chrono::steady_clock::now();
+        CaptureFile capture(options.capture);
+        BusAnalysis analysis = analyzer.analyze(capture);
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+
+        double span_s = static_cast<double>(analysis.last_us - analysis.first_us) / 1e6;
+        std::cout << "=== Capture " << options.capture << " ===\n"
+                  << "Frames:        " << analysis.frames << " over " << std::fixed
+                  << std::setprecision(3) << span_s << " s (" << analysis.ids.size()
+                  << " IDs, analysed in " << elapsed.count() << " ms)\n"
+                  << "Bus load:      " << std::setprecision(1) << analysis.load_percent
+                  << " % mean at " << options.bit_rate << " bit/s\n";
+        if (const LoadBin* peak = analysis.peak_bin()) {
+            std::cout << "Peak load:     " << peak->load_percent << " % at +"
+                      << std::setprecision(3)
+                      << static_cast<double>(peak->start_us - analysis.first_us) / 1e6
+                      << " s (" << options.resolution_ms << " ms bins)\n";
+        }
+        if (analysis.out_of_order > 0) {
+            std::cout << "Out of order:  " << analysis.out_of_order << " records\n";
+        }
+
+        std::cout << "\n" << std::left << std::setw(12) << "ID" << std::right
+                  << std::setw(10) << "Frames" << std::setw(12) << "Period ms"
+                  << std::setw(10) << "p50 us" << std::setw(10) << "p95 us"
+                  << std::setw(10) << "p99 us" << std::setw(10) << "max us"
+                  << std::setw(8) << "Missed" << std::setw(8) << "Bursts"
+                  << std::setw(8) << "Load %" << "  Flags\n";
+        for (const auto& stats : analysis.ids) {
+            std::cout << std::left << std::setw(12) << format_id(stats.can_id) << std::right
+                      << std::setw(10) << stats.frames << std::setprecision(3)
+                      << std::setw(12) << stats.period_us / 1000.0 << std::setprecision(0)
+                      << std::setw(10) << stats.jitter_p50_us
+                      << std::setw(10) << stats.jitter_p95_us
+                      << std::setw(10) << stats.jitter_p99_us
+                      << std::setw(10) << stats.jitter_max_us
+                      << std::setw(8) << stats.missed_cycles
+                      << std::setw(8) << stats.bursts << std::setprecision(2)
+                      << std::setw(8) << stats.load_percent << "  "
+                      << format_flags(stats, options.jitter_limit) << "\n";
+        }
+
+        if (!options.timeline_csv.empty()) {
+            std::ofstream csv(options.timeline_csv);
+            if (!csv.is_open()) {
+                std::cerr << "Cannot write " << options.timeline_csv << std::endl;
+                return 1;
+            }
+            csv << "time_s,frames,bits,load_percent\n" << std::fixed;
+            for (const auto& bin : analysis.timeline) {
+                csv << std::setprecision(6)
+                    << static_cast<double>(bin.start_us - analysis.first_us) / 1e6 << ","
+                    << bin.frames << "," << bin.bits << "," << std::setprecision(2)
+                    << bin.load_percent << "\n";
+            }
+            std::cout << "\nTimeline: " << analysis.timeline.size() << " bins written to "
+                      << options.timeline_csv << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
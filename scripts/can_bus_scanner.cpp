@@ -4,14 +4,19 @@
  * @version 1.0
  * @date 2025-11-02
  *
- * Scans for devices on the CAN bus and tests different configurations
+ * Scans for devices on the CAN bus and tests different configurations.
+ * Node discovery uses canopen::NetworkScanner: one SDO identity burst to all
+ * 127 node IDs, then the identity of every responder read in parallel.
  */
 
 #include "../include/waveshare.hpp"
+#include "../include/interface/socketcan_helpers.hpp"
+#include "../include/canopen/network_scanner.hpp"
 #include "script_utils.hpp"
 #include <iostream>
 #include <iomanip>
 #include <chrono>
+#include <sstream>
 #include <thread>
 #include <vector>
 #include <set>
@@ -68,40 +73,6 @@ class CANBusScanner {
             }
         }
 
-        void send_node_guard_request(uint8_t node_id) {
-            try {
-                // Send Node Guard request (NMT protocol)
-                auto frame = FrameBuilder<VariableFrame>()
-                    .with_type(CANVersion::STD_VARIABLE, Format::REMOTE_VARIABLE)
-                    .with_id(0x700 + node_id) // Node Guard COB-ID
-                    .build();
-
-                adapter_->send_frame(frame);
-            } catch (const std::exception& e) {
-                // Silent failure for scanning
-            }
-        }
-
-        void send_sdo_read_request(uint8_t node_id, uint16_t index, uint8_t subindex = 0) {
-            try {
-                auto frame = FrameBuilder<VariableFrame>()
-                    .with_type(CANVersion::STD_VARIABLE, Format::DATA_VARIABLE)
-                    .with_id(0x600 + node_id)
-                    .with_data({
-                0x40,      // SDO read request
-                static_cast<uint8_t>(index & 0xFF),
-                static_cast<uint8_t>((index >> 8) & 0xFF),
-                subindex,
-                0x00, 0x00, 0x00, 0x00
-            })
-                    .build();
-
-                adapter_->send_frame(frame);
-            } catch (const std::exception& e) {
-                // Silent failure for scanning
-            }
-        }
-
         void listen_for_responses(int duration_ms) {
             std::cout << "Listening for responses (" << duration_ms << "ms)..." << std::endl;
 
@@ -188,27 +159,75 @@ class CANBusScanner {
                 return;
             }
 
-            // Method 1: Send Node Guard requests to common node IDs
-            std::cout << "\n1. Sending Node Guard requests..." << std::endl;
-            for (uint8_t node_id = 1; node_id <= 8; node_id++) {
-                send_node_guard_request(node_id);
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-            }
+            // Identity probe to all 127 node IDs in one burst, then the
+            // inventory reads of every responder in parallel
+            canopen::NetworkScanner scanner(
+                [this](const can_frame& frame) {
+                    try {
+                        adapter_->send_frame(SocketCANHelper::from_socketcan(frame));
+                        return true;
+                    } catch (const std::exception&) {
+                        return false;
+                    }
+                },
+                [this](can_frame& frame, std::chrono::microseconds timeout) {
+                    try {
+                        int timeout_ms = static_cast<int>((timeout.count() + 999) / 1000);
+                        frame = SocketCANHelper::to_socketcan(
+                            adapter_->receive_variable_frame(timeout_ms));
+                        return true;
+                    } catch (const std::exception&) {
+                        return false;
+                    }
+                });
 
-            listen_for_responses(2000);
+            auto result = scanner.scan();
+            print_inventory(result);
 
-            // Method 2: Send SDO requests to Device Type object
-            std::cout << "\n2. Sending SDO Device Type requests..." << std::endl;
-            for (uint8_t node_id = 1; node_id <= 8; node_id++) {
-                send_sdo_read_request(node_id, 0x1000, 0); // Device Type
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            if (result.nodes.empty()) {
+                // No SDO server answered: any traffic still tells the baud rate matches
+                std::cout << "\nListening for spontaneous CAN traffic..." << std::endl;
+                listen_for_responses(500);
             }
+        }
 
-            listen_for_responses(2000);
+        void print_inventory(const canopen::NetworkScanResult& result) {
+            std::cout << "Found " << result.nodes.size() << " node(s) in "
+                      << result.elapsed.count() / 1000.0 << " ms ("
+                      << result.requests_sent << " requests, " << result.timeouts
+                      << " timeouts, " << result.aborts << " aborts)" << std::endl;
+
+            if (result.nodes.empty()) {
+                return;
+            }
 
-            // Method 3: Just listen for any spontaneous traffic
-            std::cout << "\n3. Listening for spontaneous CAN traffic..." << std::endl;
-            listen_for_responses(3000);
+            std::cout << "  Node  Device type  Vendor ID   Product     Revision    Serial"
+                      << "      Latency" << std::endl;
+            auto hex = [](bool valid, uint32_t value) {
+                    std::ostringstream out;
+                    if (valid) {
+                        out << "0x" << std::hex << std::uppercase << std::setfill('0')
+                            << std::setw(8) << value;
+                    } else {
+                        out << "-";
+                    }
+                    return out.str();
+                };
+            for (const auto& node : result.nodes) {
+                using Field = canopen::NodeIdentity;
+                std::cout << "  " << std::setw(4) << static_cast<int>(node.node_id)
+                          << "  " << std::left << std::setw(11)
+                          << hex(node.has(Field::DEVICE_TYPE), node.device_type)
+                          << "  " << std::setw(10)
+                          << hex(node.has(Field::VENDOR_ID), node.vendor_id)
+                          << "  " << std::setw(10)
+                          << hex(node.has(Field::PRODUCT_CODE), node.product_code)
+                          << "  " << std::setw(10) << hex(node.has(Field::REVISION), node.revision)
+                          << "  " << std::setw(10)
+                          << hex(node.has(Field::SERIAL_NUMBER), node.serial_number)
+                          << std::right << "  " << node.probe_latency.count() << " us"
+                          << std::endl;
+            }
         }
 
         void test_loopback() {
@@ -258,7 +277,7 @@ class CANBusScanner {
             // Test adapter functionality first
             test_loopback();
 
-            // Test common CAN bus speeds
+            // Common CAN bus speeds, probed when the bus is silent
             std::vector<CANBaud> baud_rates = {
                 CANBaud::BAUD_125K,
                 CANBaud::BAUD_250K,
@@ -266,6 +285,21 @@ class CANBusScanner {
                 CANBaud::BAUD_1M
             };
 
+            // Listen-only rate detection: the bus is not disturbed at a wrong rate
+            std::cout << "\n=== Detecting CAN bit rate (listen-only) ===" << std::endl;
+            try {
+                auto detection = adapter_->autobaud();
+                if (detection.detected) {
+                    std::cout << "✓ Bus traffic found after " << detection.attempts
+                              << " window(s), " << detection.elapsed.count() << " ms" << std::endl;
+                    baud_rates = {detection.baud_rate};
+                } else {
+                    std::cout << "⚠ No traffic heard, probing common rates" << std::endl;
+                }
+            } catch (const std::exception& e) {
+                std::cout << "❌ Rate detection failed: " << e.what() << std::endl;
+            }
+
             for (auto baud : baud_rates) {
                 scan_for_nodes(baud);
             }
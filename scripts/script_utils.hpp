@@ -86,6 +86,7 @@ namespace waveshare {
         std::uint32_t filter_mask = 0x00000000;
         std::uint32_t usb_read_timeout_ms = 100;
         std::uint32_t socketcan_read_timeout_ms = 100;
+        IoBackend io_backend = IoBackend::POSIX;
 
         // Writer-specific configuration
         WriterMode writer_mode = WriterMode::COUNT;
@@ -94,6 +95,19 @@ namespace waveshare {
         std::uint32_t start_id = 0x123;
         std::vector<std::uint8_t> message_data = {0xDE, 0xAD, 0xBE, 0xEF};
         bool increment_id = false;
+
+        // Writer load-generation mode (enabled by -L, -G or -P)
+        bool load_mode = false;
+        double bus_load_percent = 0.0;          // 0 = pace with load_gap_us
+        std::uint32_t load_gap_us = 1000;
+        std::string load_profile_path;          // Empty = start_id with message_data length
+        std::uint32_t batch_size = 1;
+        std::uint32_t stats_interval_ms = 1000;
+
+        // Reader capture mode (enabled by -o)
+        bool capture_mode = false;
+        std::string capture_path;               // "-" = stdout
+        CaptureFormat capture_format = CaptureFormat::BINARY;
     };
 
 /**
@@ -138,6 +152,8 @@ namespace waveshare {
             std::cout << "  -u <ms>         USB read timeout in milliseconds (default: 100)\n";
             std::cout <<
                 "  -t <ms>         SocketCAN read timeout in milliseconds (default: 100)\n";
+            std::cout << "  -x <backend>    Port/socket I/O backend (default: posix)\n";
+            std::cout << "                  Supported: posix, io_uring\n";
         }
 
         if (script_type == ScriptType::WRITER) {
@@ -152,6 +168,19 @@ namespace waveshare {
             std::cout << "  -l              Loop mode: send messages infinitely (same as -n 0)\n";
             std::cout << "  -c <interface>  SocketCAN interface fallback (default: vcan0)\n";
             std::cout << "                  Used when USB device is busy (bridge running)\n";
+            std::cout << "\nLoad generation (any of -L, -G, -P enables it):\n";
+            std::cout << "  -L <percent>    Target bus load in percent of the CAN bit rate\n";
+            std::cout << "  -G <us>         Gap between frames in microseconds (default: 1000)\n";
+            std::cout << "  -P <file>       ID/DLC distribution profile (JSON, load_profile section)\n";
+            std::cout << "  -B <count>      Frames per write() (default: 1)\n";
+            std::cout << "  -T <ms>         Statistics interval in milliseconds (default: 1000)\n";
+        }
+
+        if (script_type == ScriptType::READER) {
+            std::cout << "\nHeadless capture (-o enables it):\n";
+            std::cout << "  -o <file>       Capture output file ('-' = stdout)\n";
+            std::cout << "  -O <format>     Capture format: 'binary' or 'candump' (default: binary)\n";
+            std::cout << "  -T <ms>         Statistics interval in milliseconds (default: 1000)\n";
         }
 
         if (script_type != ScriptType::BRIDGE) {
@@ -165,6 +194,17 @@ namespace waveshare {
         switch (script_type) {
         case ScriptType::READER:
             std::cout << "Reads CAN frames from the Waveshare USB-CAN adapter and displays them.\n";
+            std::cout << "In capture mode frames are decoded in bulk and written by a separate\n";
+            std::cout << "thread, as 24-byte binary records or candump -L lines (replayable with\n";
+            std::cout << "canplayer); counts, drops and decode errors are reported periodically.\n";
+            std::cout << "\n";
+            std::cout << "Examples:\n";
+            std::cout << "  # Print frames as they arrive:\n";
+            std::cout << "  " << program_name << " -d /dev/ttyUSB0\n\n";
+            std::cout << "  # Capture a 1 Mbit/s bus to a binary file:\n";
+            std::cout << "  " << program_name << " -d /dev/ttyUSB0 -b 1000000 -o bus.wscap\n\n";
+            std::cout << "  # Stream a candump log to another tool:\n";
+            std::cout << "  " << program_name << " -o - -O candump | grep 181\n";
             break;
         case ScriptType::WRITER:
             std::cout << "Sends CAN frames to the Waveshare USB-CAN adapter.\n";
@@ -183,7 +223,12 @@ namespace waveshare {
             std::cout << "  # Infinite loop sending messages:\n";
             std::cout << "  " << program_name << " -i 0x200 -j \"CAFEBABE\" -l -g 500\n\n";
             std::cout << "  # Use SocketCAN fallback when bridge is running:\n";
-            std::cout << "  " << program_name << " -d /dev/ttyUSB0 -c vcan0 -i 0x123\n";
+            std::cout << "  " << program_name << " -d /dev/ttyUSB0 -c vcan0 -i 0x123\n\n";
+            std::cout << "  # 60% bus load at 500 kbps from a traffic profile, 8 frames per write:\n";
+            std::cout << "  " << program_name <<
+                " -b 500000 -L 60 -P config/load_profile.json -B 8 -l\n\n";
+            std::cout << "  # 10000 frames, one every 250 us:\n";
+            std::cout << "  " << program_name << " -i 0x181 -j \"0102030405060708\" -G 250 -n 10000\n";
             break;
         case ScriptType::BRIDGE:
             std::cout << "Bridges Waveshare USB-CAN adapter with SocketCAN interface.\n";
@@ -324,11 +369,11 @@ namespace waveshare {
 
         const char* optstring;
         if (script_type == ScriptType::BRIDGE) {
-            optstring = "hi:d:s:b:m:r:F:M:u:t:";
+            optstring = "hi:d:s:b:m:r:F:M:u:t:x:";
         } else if (script_type == ScriptType::WRITER) {
-            optstring = "hd:s:b:f:i:j:n:g:Ilc:";
+            optstring = "hd:s:b:f:i:j:n:g:Ilc:L:G:P:B:T:";
         } else { // READER
-            optstring = "hd:s:b:f:";
+            optstring = "hd:s:b:f:o:O:T:";
         }
 
         while ((opt = getopt(argc, argv, optstring)) != -1) {
@@ -404,6 +449,89 @@ namespace waveshare {
                 }
                 break;
 
+            case 'L':  // Target bus load (writer load mode)
+                if (script_type == ScriptType::WRITER) {
+                    try {
+                        config.bus_load_percent = std::stod(optarg);
+                    } catch (const std::exception& e) {
+                        throw std::invalid_argument("Invalid bus load: " + std::string(optarg));
+                    }
+                    if (config.bus_load_percent <= 0.0 || config.bus_load_percent > 100.0) {
+                        throw std::invalid_argument("Bus load must be in (0, 100]: " +
+                            std::string(optarg));
+                    }
+                    config.load_mode = true;
+                }
+                break;
+
+            case 'G':  // Gap in microseconds (writer load mode)
+                if (script_type == ScriptType::WRITER) {
+                    try {
+                        config.load_gap_us = parse_uint32(optarg);
+                    } catch (const std::invalid_argument& e) {
+                        std::cerr << "Invalid gap: " << optarg << "\n";
+                        throw;
+                    }
+                    if (config.load_gap_us == 0) {
+                        throw std::invalid_argument("Gap must be > 0 microseconds");
+                    }
+                    config.load_mode = true;
+                }
+                break;
+
+            case 'P':  // Traffic profile (writer load mode)
+                if (script_type == ScriptType::WRITER) {
+                    config.load_profile_path = optarg;
+                    config.load_mode = true;
+                }
+                break;
+
+            case 'B':  // Batch size (writer load mode)
+                if (script_type == ScriptType::WRITER) {
+                    try {
+                        config.batch_size = parse_uint32(optarg);
+                    } catch (const std::invalid_argument& e) {
+                        std::cerr << "Invalid batch size: " << optarg << "\n";
+                        throw;
+                    }
+                    if (config.batch_size == 0) {
+                        throw std::invalid_argument("Batch size must be > 0");
+                    }
+                }
+                break;
+
+            case 'o':  // Capture output (reader capture mode)
+                if (script_type == ScriptType::READER) {
+                    config.capture_path = optarg;
+                    config.capture_mode = true;
+                }
+                break;
+
+            case 'O':  // Capture format (reader capture mode)
+                if (script_type == ScriptType::READER) {
+                    std::string format = optarg;
+                    if (format == "binary") {
+                        config.capture_format = CaptureFormat::BINARY;
+                    } else if (format == "candump") {
+                        config.capture_format = CaptureFormat::CANDUMP;
+                    } else {
+                        throw std::invalid_argument("Invalid capture format: " + format +
+                            " (use 'binary' or 'candump')");
+                    }
+                }
+                break;
+
+            case 'T':  // Statistics interval (writer load mode, reader capture mode)
+                if (script_type != ScriptType::BRIDGE) {
+                    try {
+                        config.stats_interval_ms = parse_uint32(optarg);
+                    } catch (const std::invalid_argument& e) {
+                        std::cerr << "Invalid statistics interval: " << optarg << "\n";
+                        throw;
+                    }
+                }
+                break;
+
             case 'l':  // Loop mode (writer only)
                 if (script_type == ScriptType::WRITER) {
                     config.writer_mode = WriterMode::LOOP;
@@ -521,6 +649,18 @@ namespace waveshare {
                 }
                 break;
 
+            case 'x':  // I/O backend (bridge only)
+                if (script_type == ScriptType::BRIDGE) {
+                    try {
+                        config.io_backend = io_backend_from_string(optarg);
+                    } catch (const std::invalid_argument& e) {
+                        std::cerr << "Invalid I/O backend: " << optarg << "\n";
+                        std::cerr << "Supported: posix, io_uring\n";
+                        throw;
+                    }
+                }
+                break;
+
             case 'f':  // Frame type (reader/writer only)
                 if (script_type != ScriptType::BRIDGE) {
                     try {
@@ -537,7 +677,8 @@ namespace waveshare {
                 if (optopt == 'd' || optopt == 's' || optopt == 'b' || optopt == 'f' ||
                     optopt == 'i' || optopt == 'm' || optopt == 'r' || optopt == 'F' ||
                     optopt == 'M' || optopt == 'u' || optopt == 't' || optopt == 'j' ||
-                    optopt == 'n' || optopt == 'g') {
+                    optopt == 'n' || optopt == 'g' || optopt == 'L' || optopt == 'G' ||
+                    optopt == 'P' || optopt == 'B' || optopt == 'T') {
                     std::cerr << "Option -" << static_cast<char>(optopt) <<
                         " requires an argument.\n";
                 } else {
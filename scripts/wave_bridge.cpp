@@ -98,7 +98,9 @@ int main(int argc, char* argv[]) {
         std::cout << "  Filter Mask:         0x" << std::hex << std::uppercase << std::setfill('0')
                   << std::setw(8) << config.filter_mask << std::dec << "\n";
         std::cout << "  USB Read Timeout:    " << config.usb_read_timeout_ms << " ms\n";
-        std::cout << "  SocketCAN Timeout:   " << config.socketcan_read_timeout_ms << " ms\n\n";
+        std::cout << "  SocketCAN Timeout:   " << config.socketcan_read_timeout_ms << " ms\n";
+        std::cout << "  I/O Backend:         "
+                  << io_backend_to_string(effective_io_backend(config.io_backend)) << "\n\n";
 
         // Create bridge configuration from parsed arguments
         BridgeConfig bridge_config = BridgeConfig::create_default();
@@ -112,6 +114,7 @@ int main(int argc, char* argv[]) {
         bridge_config.filter_mask = config.filter_mask;
         bridge_config.usb_read_timeout_ms = config.usb_read_timeout_ms;
         bridge_config.socketcan_read_timeout_ms = config.socketcan_read_timeout_ms;
+        bridge_config.io_backend = config.io_backend;
 
         // Validate configuration
         bridge_config.validate();
@@ -0,0 +1,173 @@
+/**
+ * @file wave_emulator.cpp
+ * @brief USB-CAN-A emulator on a pseudo-terminal
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-30
+ *
+ * Stands in for the adapter when no hardware is attached: the printed slave
+ * path (or the -L link) is opened by any tool in place of /dev/ttyUSB0.
+ *
+ *   ./wave_emulator -L /tmp/ttyWS0 -B 500000 -c bus.wscap -l
+ *   ./wave_reader -d /tmp/ttyWS0 -b 500000
+ */
+
+#include "../include/pattern/adapter_emulator.hpp"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+using namespace waveshare;
+
+namespace {
+
+    std::atomic<bool> g_running{true};
+
+    void signal_handler(int signal) {
+        if (signal == SIGINT || signal == SIGTERM) {
+            g_running = false;
+        }
+    }
+
+    struct EmulatorOptions {
+        int serial_baud = 2000000;
+        int bus_rate = 0;
+        bool echo = false;
+        bool timing = true;
+        std::string capture;
+        double speed = 1.0;
+        bool loop = false;
+        std::string link_path;
+        bool verbose = false;
+    };
+
+    void print_usage(const char* name) {
+        std::cout << "Usage: " << name << " [options]\n"
+                  << "  -s, --serial <baud>      Serial baud rate (default: 2000000)\n"
+                  << "  -B, --bus <bps>          Fixed bus bit rate; the host only hears it\n"
+                  << "                           when configured for it (default: follow host)\n"
+                  << "  -e, --echo               Answer every transmitted frame with a copy\n"
+                  << "  -c, --capture <file>     Replay a binary capture onto the bus\n"
+                  << "  -x, --speed <factor>     Replay time scale, 0 = as fast as possible\n"
+                  << "                           (default: 1)\n"
+                  << "  -l, --loop               Replay the capture forever\n"
+                  << "  -L, --link <path>        Symlink to the slave pty (e.g. /tmp/ttyWS0)\n"
+                  << "  -n, --no-timing          Do not pace the serial link and the bus\n"
+                  << "  -v, --verbose            Print every frame the host transmits\n"
+                  << "  -h, --help               Show this help\n";
+    }
+
+    EmulatorOptions parse_options(int argc, char* argv[]) {
+        static const struct option long_options[] = {
+            {"serial", required_argument, nullptr, 's'},
+            {"bus", required_argument, nullptr, 'B'},
+            {"echo", no_argument, nullptr, 'e'},
+            {"capture", required_argument, nullptr, 'c'},
+            {"speed", required_argument, nullptr, 'x'},
+            {"loop", no_argument, nullptr, 'l'},
+            {"link", required_argument, nullptr, 'L'},
+            {"no-timing", no_argument, nullptr, 'n'},
+            {"verbose", no_argument, nullptr, 'v'},
+            {"help", no_argument, nullptr, 'h'},
+            {nullptr, 0, nullptr, 0}
+        };
+
+        EmulatorOptions options;
+        int opt;
+        while ((opt = getopt_long(argc, argv, "s:B:ec:x:lL:nvh", long_options,
+            nullptr)) != -1) {
+            switch (opt) {
+            case 's': options.serial_baud = std::stoi(optarg); break;
+            case 'B': options.bus_rate = std::stoi(optarg); break;
+            case 'e': options.echo = true; break;
+            case 'c': options.capture = optarg; break;
+            case 'x': options.speed = std::stod(optarg); break;
+            case 'l': options.loop = true; break;
+            case 'L': options.link_path = optarg; break;
+            case 'n': options.timing = false; break;
+            case 'v': options.verbose = true; break;
+            case 'h': print_usage(argv[0]); std::exit(0);
+            default: print_usage(argv[0]); std::exit(1);
+            }
+        }
+        if (optind != argc) {
+            print_usage(argv[0]);
+            std::exit(1);
+        }
+        return options;
+    }
+
+    void print_statistics(const AdapterEmulatorStatistics& stats) {
+        std::cout << "\n=== Emulator statistics ===\n"
+                  << "Config frames:  " << stats.config_frames << "\n"
+                  << "Host frames:    " << stats.host_frames << " (" << stats.bus_frames
+                  << " on the bus, " << stats.not_sent << " not sent)\n"
+                  << "Bus frames:     " << stats.injected << " injected, " << stats.delivered
+                  << " delivered, " << stats.filtered << " filtered\n"
+                  << "Overruns:       " << stats.overruns << "\n"
+                  << "Skipped bytes:  " << stats.skipped_bytes << std::endl;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    EmulatorOptions options = parse_options(argc, argv);
+
+    try {
+        bool unsupported = false;
+        AdapterEmulatorConfig config;
+        config.serial_baud = serialbaud_from_int(options.serial_baud, unsupported);
+        if (unsupported) {
+            std::cerr << "Unsupported serial baud rate: " << options.serial_baud << std::endl;
+            return 1;
+        }
+        if (options.bus_rate != 0) {
+            config.bus_baud = canbaud_from_int(options.bus_rate, unsupported);
+            if (unsupported) {
+                std::cerr << "Unsupported CAN bit rate: " << options.bus_rate << std::endl;
+                return 1;
+            }
+        }
+        config.echo = options.echo;
+        config.serial_timing = options.timing;
+        config.bus_timing = options.timing;
+        config.link_path = options.link_path;
+
+        AdapterEmulator emulator(config);
+        if (options.verbose) {
+            emulator.on_transmit([](const struct can_frame& frame) {
+                    std::cout << "[EMU] TX 0x" << std::hex << std::uppercase
+                              << (frame.can_id & CAN_EFF_MASK) << std::dec << " ["
+                              << static_cast<int>(frame.can_dlc) << "]" << std::endl;
+                });
+        }
+
+        std::signal(SIGINT, signal_handler);
+        std::signal(SIGTERM, signal_handler);
+        emulator.start();
+        if (!options.capture.empty()) {
+            emulator.replay(options.capture, options.speed, options.loop);
+        }
+        std::cout << "[EMU] Adapter on " << emulator.get_slave_path() << " at "
+                  << options.serial_baud << " baud (Ctrl+C to stop)" << std::endl;
+
+        bool replay_reported = options.capture.empty() || options.loop;
+        while (g_running) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (!replay_reported && emulator.replay_done()) {
+                std::cout << "[EMU] Capture replay finished" << std::endl;
+                replay_reported = true;
+            }
+        }
+
+        emulator.stop();
+        print_statistics(emulator.get_statistics());
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -2,24 +2,163 @@
  * @file wave_reader.cpp
  * @author effibot (andrea.efficace1@gmail.com)
  * @brief Simple example to read frames from the Waveshare USB-CAN adapter
- * @version 0.1
- * @date 2025-10-13
+ * @version 0.2
+ * @date 2025-11-23
+ *
+ * Two modes:
+ * - Interactive: one frame per receive call, printed as it arrives
+ * - Capture (-o): headless; raw reads are decoded in bulk by a
+ *   FrameStreamDecoder and handed to a CaptureWriter, whose thread writes
+ *   binary records or candump -L lines; statistics are printed periodically
  *
  * @copyright Copyright (c) 2025
  *
  */
 #include "script_utils.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
 
 using namespace waveshare;
 
+namespace {
+    constexpr std::size_t READ_CHUNK = 64 * 1024;
+    constexpr int READ_TIMEOUT_MS = 100;
+
+    std::uint64_t now_us() {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+}
+
+/**
+ * @brief Headless capture loop
+ *
+ * Frames of one read share the timestamp of that read. With output on
+ * stdout, all log output goes to stderr.
+ *
+ * @param config Script configuration (capture_path, capture_format)
+ * @param adapter Configured adapter
+ * @return int Exit code
+ */
+int run_capture(const ScriptConfig& config, USBAdapter& adapter) {
+    const bool to_stdout = config.capture_path == "-";
+    int fd = STDOUT_FILENO;
+    if (!to_stdout) {
+        fd = ::open(config.capture_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open capture file " + config.capture_path + ": " +
+                std::strerror(errno));
+        }
+    }
+
+    FrameStreamDecoder decoder(config.use_fixed_frames
+        ? FrameStreamDecoder::Mode::FIXED : FrameStreamDecoder::Mode::VARIABLE);
+    CaptureWriter writer(fd, config.capture_format);
+
+    std::cout << "\n=== CAN Capture ===\n";
+    std::cout << "Output: " << (to_stdout ? "stdout" : config.capture_path) << " ("
+              << (config.capture_format == CaptureFormat::BINARY ? "binary" : "candump -L")
+              << ")\n";
+    std::cout << "Capturing (statistics every " << config.stats_interval_ms
+              << " ms, Ctrl+C to stop)...\n\n";
+
+    std::vector<std::uint8_t> buffer(READ_CHUNK);
+    std::vector<struct can_frame> frames;
+    frames.reserve(READ_CHUNK / 5);
+
+    const auto interval = std::chrono::milliseconds(
+        std::max<std::uint32_t>(config.stats_interval_ms, 1));
+    const auto start = std::chrono::steady_clock::now();
+    auto last_report = start;
+    std::uint64_t bytes_in = 0;
+    std::uint64_t last_bytes = 0;
+    FrameStreamDecoder::Statistics last_decode;
+    CaptureStatistics last_capture;
+    int rc = 0;
+
+    auto report = [&](std::chrono::steady_clock::time_point now) {
+            const auto& decode = decoder.get_statistics();
+            CaptureStatistics capture = writer.get_statistics();
+            double seconds = std::chrono::duration<double>(now - last_report).count();
+            std::cout << "[" << get_timestamp() << "] " << std::fixed << std::setprecision(0)
+                      << static_cast<double>(decode.frames - last_decode.frames) / seconds
+                      << " frames/s, "
+                      << static_cast<double>(bytes_in - last_bytes) / seconds << " B/s in, dropped "
+                      << capture.dropped - last_capture.dropped << ", decode errors "
+                      << decode.decode_errors - last_decode.decode_errors << ", write errors "
+                      << capture.write_errors - last_capture.write_errors << "\n";
+            last_decode = decode;
+            last_capture = capture;
+            last_bytes = bytes_in;
+            last_report = now;
+        };
+
+    while (!USBAdapter::should_stop()) {
+        int n = 0;
+        try {
+            n = adapter.receive_bytes(buffer.data(), buffer.size(), READ_TIMEOUT_MS);
+        } catch (const WaveshareException& e) {
+            std::cerr << "Failed to receive: " << e.what() << "\n";
+            rc = 1;
+            break;
+        }
+
+        if (n > 0) {
+            std::uint64_t timestamp = now_us();
+            bytes_in += static_cast<std::uint64_t>(n);
+            frames.clear();
+            decoder.decode(buffer.data(), static_cast<std::size_t>(n), frames);
+            for (const auto& frame : frames) {
+                writer.write(frame, timestamp);
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_report >= interval) {
+            report(now);
+        }
+    }
+
+    writer.stop();
+    if (!to_stdout) {
+        ::close(fd);
+    }
+
+    const auto& decode = decoder.get_statistics();
+    CaptureStatistics capture = writer.get_statistics();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    std::cout << "\n=== Capture Complete ===\n";
+    std::cout << "Frames: " << decode.frames << " in " << elapsed.count() << " ms ("
+              << bytes_in << " bytes read)\n";
+    std::cout << "Written: " << capture.records << " records, "
+              << capture.bytes_written << " bytes\n";
+    std::cout << "Dropped: " << capture.dropped << ", decode errors: " << decode.decode_errors
+              << " (" << decode.skipped_bytes << " bytes skipped), write errors: "
+              << capture.write_errors << "\n";
+    return rc != 0 || capture.write_errors != 0 ? 1 : 0;
+}
+
 int main(int argc, char* argv[]) {
     try {
         // Parse command-line arguments
         ScriptConfig config = parse_arguments(argc, argv, ScriptType::READER);
 
+        // Keep stdout clean for the capture stream
+        if (config.capture_mode && config.capture_path == "-") {
+            std::cout.rdbuf(std::cerr.rdbuf());
+        }
+
         // Initialize and configure adapter with RTX OFF for receiving
         auto adapter = initialize_adapter(config, RTX::OFF);
 
+        if (config.capture_mode) {
+            int rc = run_capture(config, *adapter);
+            std::cout << "\n[READER] Stopped.\n";
+            return rc;
+        }
+
         std::cout << "\n=== CAN Frame Reader ===\n";
         std::cout << "Waiting for CAN frames (Ctrl+C to stop)...\n\n";
 
@@ -11,6 +11,9 @@
  * - Infinite loop
  * - Incrementing CAN ID
  * - Configurable delay between messages
+ * - Load generation: absolute-deadline pacing at microsecond gaps or at a
+ *   target bus load, ID/DLC distributions from a profile file, pre-encoded
+ *   batches sent with one write() each, periodic statistics
  *
  * Automatically detects if USB device is busy (bridge running) and
  * falls back to SocketCAN mode.
@@ -21,11 +24,13 @@
 #include "script_utils.hpp"
 #include <chrono>
 #include <thread>
+#include <atomic>
 #include <variant>
 #include <csignal>
 #include <linux/can.h>
 #include <linux/can/raw.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/ioctl.h>
 #include <net/if.h>
 #include <unistd.h>
@@ -43,8 +48,8 @@ enum class TransportMode {
     SOCKETCAN      // Via SocketCAN interface
 };
 
-// Global flag for signal handling
-static volatile bool running = true;
+// Global flag for signal handling (lock-free, safe to set from the handler)
+static std::atomic<bool> running{true};
 
 /**
  * @brief Signal handler for graceful shutdown
@@ -160,6 +165,121 @@ bool send_socketcan_frame(int sockfd, std::uint32_t can_id,
     return true;
 }
 
+/**
+ * @brief Send a batch of frames via SocketCAN with one sendmmsg() call
+ * @param sockfd SocketCAN file descriptor
+ * @param frames Frames to send
+ * @param count Number of frames
+ * @return true if every frame was queued
+ */
+bool send_socketcan_batch(int sockfd, const struct can_frame* frames, std::size_t count) {
+    std::vector<struct iovec> iov(count);
+    std::vector<struct mmsghdr> msgs(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        iov[i].iov_base = const_cast<struct can_frame*>(&frames[i]);
+        iov[i].iov_len = sizeof(struct can_frame);
+        std::memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    std::size_t sent = 0;
+    while (sent < count) {
+        int n = sendmmsg(sockfd, msgs.data() + sent, static_cast<unsigned>(count - sent), 0);
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+/**
+ * @brief Load-generation mode: paced, batched, pre-encoded traffic
+ * @param config Script configuration (load options)
+ * @param mode Transport in use
+ * @param adapter USB adapter (USB_DIRECT)
+ * @param socketcan_fd SocketCAN socket (SOCKETCAN)
+ * @return int Exit code
+ */
+int run_load_generator(const ScriptConfig& config, TransportMode mode, USBAdapter* adapter,
+    int socketcan_fd) {
+    LoadProfile profile = config.load_profile_path.empty()
+        ? LoadProfile::single(config.start_id,
+            static_cast<std::uint8_t>(config.message_data.size()))
+        : LoadProfile::from_file(config.load_profile_path);
+
+    LoadGeneratorConfig load_config;
+    load_config.can_baud = config.can_baudrate;
+    load_config.bus_load_percent = config.bus_load_percent;
+    load_config.gap = std::chrono::microseconds(config.load_gap_us);
+    load_config.batch_size = config.batch_size;
+    load_config.count = config.writer_mode == WriterMode::LOOP ? 0 : config.message_count;
+    load_config.fixed_frames = config.use_fixed_frames;
+    load_config.stats_interval = std::chrono::milliseconds(
+        std::max<std::uint32_t>(config.stats_interval_ms, 1));
+
+    LoadGenerator generator(profile, load_config);
+
+    std::cout << "Load generation:\n";
+    std::cout << "  Profile:         " << (config.load_profile_path.empty()
+        ? "single ID" : config.load_profile_path) << " (" << profile.ids.size() << " IDs, "
+              << profile.dlcs.size() << " DLCs)\n";
+    if (config.bus_load_percent > 0.0) {
+        std::cout << "  Target Load:     " << config.bus_load_percent << " %\n";
+    } else {
+        std::cout << "  Frame Gap:       " << config.load_gap_us << " us\n";
+    }
+    std::cout << "  Target Rate:     " << std::fixed << std::setprecision(0)
+              << generator.target_frame_rate() << " frames/s\n";
+    std::cout << "  Batch Size:      " << config.batch_size << " frames/write\n";
+    std::cout << "  Frame Pool:      " << generator.frames().size() << " frames, "
+              << generator.encoded().size() << " bytes pre-encoded\n\n";
+
+    LoadGenerator::SendFunction send;
+    if (mode == TransportMode::USB_DIRECT) {
+        send = [adapter](const LoadBatch& batch) {
+                try {
+                    adapter->send_encoded(batch.bytes, batch.size);
+                    return true;
+                } catch (const WaveshareException&) {
+                    return false;
+                }
+            };
+    } else {
+        send = [socketcan_fd](const LoadBatch& batch) {
+                return send_socketcan_batch(socketcan_fd, batch.frames, batch.count);
+            };
+    }
+
+    auto print_stats = [&](const char* label, const LoadStatistics& stats) {
+            std::cout << "[" << get_timestamp() << "] " << label << std::fixed
+                      << std::setprecision(0) << stats.frame_rate() << " frames/s, load "
+                      << std::setprecision(1) << stats.bus_load_percent(config.can_baudrate)
+                      << " %, late " << stats.late_batches << " (max "
+                      << stats.max_lateness.count() << " us), errors " << stats.send_errors
+                      << "\n";
+        };
+
+    std::cout << "Starting transmission (statistics every " << config.stats_interval_ms
+              << " ms)...\n\n";
+    LoadStatistics total = generator.run(send, running,
+        [&](const LoadStatistics& interval, const LoadStatistics&) {
+            print_stats("", interval);
+        });
+
+    std::cout << "\n=== Transmission Complete ===\n";
+    std::cout << "Total messages sent: " << total.frames_sent << " in "
+              << total.elapsed.count() / 1000 << " ms (" << total.batches_sent << " writes, "
+              << total.bytes_sent << " bytes)\n";
+    print_stats("Average: ", total);
+    if (total.gave_up) {
+        std::cerr << "Stopped after " << load_config.max_send_failures
+                  << " failed writes in a row\n";
+    }
+    return total.send_errors == 0 ? 0 : 1;
+}
+
 int main(int argc, char* argv[]) {
     try {
         // Install signal handler
@@ -255,8 +375,10 @@ int main(int argc, char* argv[]) {
             0x7FF ? 8 : 3) << config.start_id << std::dec << "\n";
         std::cout << "  Data:            " << format_can_data(config.message_data.data(),
             config.message_data.size()) << "\n";
-        std::cout << "  Message Gap:     " << config.message_gap_ms << " ms\n";
-        std::cout << "  Increment ID:    " << (config.increment_id ? "Yes" : "No") << "\n";
+        if (!config.load_mode) {
+            std::cout << "  Message Gap:     " << config.message_gap_ms << " ms\n";
+            std::cout << "  Increment ID:    " << (config.increment_id ? "Yes" : "No") << "\n";
+        }
 
         if (config.writer_mode == WriterMode::LOOP || config.message_count == 0) {
             std::cout << "  Mode:            Infinite loop (press Ctrl+C to stop)\n";
@@ -265,6 +387,14 @@ int main(int argc, char* argv[]) {
         }
         std::cout << "\n";
 
+        if (config.load_mode) {
+            int rc = run_load_generator(config, mode, adapter.get(), socketcan_fd);
+            if (mode == TransportMode::SOCKETCAN && socketcan_fd >= 0) {
+                close(socketcan_fd);
+            }
+            return rc;
+        }
+
         // Create data frame based on configuration
         std::variant<FixedFrame, VariableFrame> data_frame;
         std::uint32_t current_id = config.start_id;
@@ -0,0 +1,495 @@
+/**
+ * @file adapter_emulator.cpp
+ * @brief USB-CAN-A emulator on a pseudo-terminal
+ * @version 1.0
+ * @date 2025-11-30
+ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include "../include/pattern/adapter_emulator.hpp"
+#include "../include/exception/waveshare_exception.hpp"
+#include "../include/frame/config_frame.hpp"
+#include "../include/frame/fixed_frame.hpp"
+#include "../include/interface/socketcan_helpers.hpp"
+#include "../include/io/capture_file.hpp"
+
+namespace waveshare {
+
+    namespace {
+        constexpr std::size_t FIXED_SIZE = 20;      // Config and fixed data frames
+        constexpr std::size_t READ_CHUNK = 4096;
+        constexpr double SERIAL_BITS_PER_BYTE = 10.0;  // 8N1
+
+        [[noreturn]] void throw_errno(const std::string& what) {
+            throw DeviceException(Status::DNOT_OPEN,
+                "AdapterEmulator: " + what + ": " + std::strerror(errno));
+        }
+    }
+
+    AdapterEmulator::AdapterEmulator(const AdapterEmulatorConfig& config) : config_(config) {
+        if (config_.host_queue_frames == 0) {
+            throw std::invalid_argument("AdapterEmulator: host_queue_frames must be > 0");
+        }
+
+        master_fd_ = ::posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+        if (master_fd_ < 0) {
+            throw_errno("posix_openpt");
+        }
+        char name[64];
+        if (::grantpt(master_fd_) != 0 || ::unlockpt(master_fd_) != 0 ||
+            ::ptsname_r(master_fd_, name, sizeof(name)) != 0) {
+            int error = errno;
+            ::close(master_fd_);
+            errno = error;
+            throw_errno("pty setup");
+        }
+        slave_path_ = name;
+
+        // Raw until the host configures it: no echo of our own output
+        slave_fd_ = ::open(name, O_RDWR | O_NOCTTY | O_CLOEXEC);
+        struct termios2 tio;
+        if (slave_fd_ < 0 || ::ioctl(slave_fd_, TCGETS2, &tio) != 0) {
+            int error = errno;
+            if (slave_fd_ >= 0) ::close(slave_fd_);
+            ::close(master_fd_);
+            errno = error;
+            throw_errno("open " + slave_path_);
+        }
+        tio.c_iflag = IGNPAR;
+        tio.c_oflag = 0;
+        tio.c_lflag = 0;
+        ::ioctl(slave_fd_, TCSETS2, &tio);
+
+        wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_fd_ < 0) {
+            int error = errno;
+            ::close(slave_fd_);
+            ::close(master_fd_);
+            errno = error;
+            throw_errno("eventfd");
+        }
+
+        if (!config_.link_path.empty()) {
+            ::unlink(config_.link_path.c_str());
+            if (::symlink(slave_path_.c_str(), config_.link_path.c_str()) != 0) {
+                int error = errno;
+                ::close(wake_fd_);
+                ::close(slave_fd_);
+                ::close(master_fd_);
+                errno = error;
+                throw_errno("symlink " + config_.link_path);
+            }
+            slave_path_ = config_.link_path;
+        }
+    }
+
+    AdapterEmulator::~AdapterEmulator() {
+        stop();
+        if (!config_.link_path.empty()) {
+            ::unlink(config_.link_path.c_str());
+        }
+        ::close(wake_fd_);
+        ::close(slave_fd_);
+        ::close(master_fd_);
+    }
+
+    void AdapterEmulator::start() {
+        if (running_.exchange(true)) {
+            return;
+        }
+        thread_ = std::thread(&AdapterEmulator::run, this);
+    }
+
+    void AdapterEmulator::stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        wake();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    void AdapterEmulator::wake() {
+        std::uint64_t one = 1;
+        ssize_t ignored = ::write(wake_fd_, &one, sizeof(one));
+        (void)ignored;
+    }
+
+    // === Traffic sources ===
+
+    void AdapterEmulator::inject(const struct can_frame& frame) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            schedule_bus(frame, Origin::BUS, Clock::now());
+            ++stats_.injected;
+        }
+        wake();
+    }
+
+    void AdapterEmulator::replay(const std::string& capture_path, double speed, bool loop) {
+        if (speed < 0.0) {
+            throw std::invalid_argument("AdapterEmulator: replay speed must be >= 0");
+        }
+        CaptureFile capture(capture_path);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            records_.assign(capture.records(), capture.records() + capture.size());
+            replay_index_ = 0;
+            replay_speed_ = speed;
+            replay_loop_ = loop;
+            replay_start_ = Clock::now();
+        }
+        wake();
+    }
+
+    bool AdapterEmulator::replay_done() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return replay_index_ >= records_.size();
+    }
+
+    AdapterEmulatorState AdapterEmulator::get_state() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return state_;
+    }
+
+    AdapterEmulatorStatistics AdapterEmulator::get_statistics() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    // === Timing model ===
+
+    bool AdapterEmulator::rate_matches() const {
+        return !config_.bus_baud || *config_.bus_baud == state_.can_baud;
+    }
+
+    bool AdapterEmulator::accepts(const struct can_frame& frame) const {
+        const std::uint32_t id = frame.can_id &
+            ((frame.can_id & CAN_EFF_FLAG) ? CAN_EFF_MASK : CAN_SFF_MASK);
+        return (id & state_.mask) == (state_.filter & state_.mask);
+    }
+
+    AdapterEmulator::Clock::duration AdapterEmulator::frame_time(
+        const struct can_frame& frame) const {
+        if (!config_.bus_timing) {
+            return Clock::duration::zero();
+        }
+        const bool remote = (frame.can_id & CAN_RTR_FLAG) != 0;
+        const auto bits = can_frame_bits(remote ? 0 : std::min<std::uint8_t>(frame.can_dlc, 8),
+            (frame.can_id & CAN_EFF_FLAG) != 0);
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(
+            static_cast<double>(bits) / canbaud_to_int(state_.can_baud)));
+    }
+
+    AdapterEmulator::Clock::duration AdapterEmulator::serial_time(std::size_t bytes) const {
+        if (!config_.serial_timing) {
+            return Clock::duration::zero();
+        }
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(
+            SERIAL_BITS_PER_BYTE * static_cast<double>(bytes) /
+            static_cast<double>(to_speed_t(config_.serial_baud))));
+    }
+
+    void AdapterEmulator::schedule_bus(const struct can_frame& frame, Origin origin,
+        Clock::time_point ready) {
+        const bool loopback = state_.can_mode == CANMode::LOOPBACK ||
+            state_.can_mode == CANMode::LOOPBACK_SILENT;
+        if (origin == Origin::HOST) {
+            if (loopback) {
+                // Internal loop: the controller answers itself, the bus never sees it
+                schedule_host(frame, ready + frame_time(frame));
+                return;
+            }
+            if (state_.can_mode == CANMode::SILENT || !rate_matches()) {
+                ++stats_.not_sent;
+                return;
+            }
+        }
+
+        // The bus carries one frame at a time, so slots end in FIFO order
+        const auto start = std::max(ready, bus_free_);
+        bus_free_ = start + frame_time(frame);
+        bus_.push_back({bus_free_, frame, origin});
+    }
+
+    void AdapterEmulator::schedule_host(const struct can_frame& frame, Clock::time_point ready) {
+        if (to_host_.size() >= config_.host_queue_frames) {
+            ++stats_.overruns;
+            return;
+        }
+        // Same frame format the host chose with its last ConfigFrame
+        std::vector<std::uint8_t> bytes;
+        if (state_.config_type == Type::CONF_FIXED) {
+            const bool extended = (frame.can_id & CAN_EFF_FLAG) != 0;
+            const bool remote = (frame.can_id & CAN_RTR_FLAG) != 0;
+            const std::uint8_t dlc = std::min<std::uint8_t>(frame.can_dlc, 8);
+            bytes = FixedFrame(remote ? Format::REMOTE_FIXED : Format::DATA_FIXED,
+                extended ? CANVersion::EXT_FIXED : CANVersion::STD_FIXED,
+                frame.can_id & (extended ? CAN_EFF_MASK : CAN_SFF_MASK),
+                span<const std::uint8_t>(frame.data, remote ? 0 : dlc)).serialize();
+        } else {
+            bytes = SocketCANHelper::from_socketcan(frame).serialize();
+        }
+
+        const auto start = std::max(ready, tx_free_);
+        tx_free_ = start + serial_time(bytes.size());
+        to_host_.push_back({tx_free_, std::move(bytes)});
+        ++stats_.delivered;
+    }
+
+    void AdapterEmulator::replay_due(Clock::time_point now) {
+        while (replay_index_ < records_.size()) {
+            const CaptureRecord& record = records_[replay_index_];
+            Clock::time_point due = now;
+            if (replay_speed_ > 0.0) {
+                const double offset_us =
+                    static_cast<double>(record.timestamp_us - records_.front().timestamp_us) /
+                    replay_speed_;
+                due = replay_start_ + std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double, std::micro>(offset_us));
+                if (due > now) {
+                    break;
+                }
+            } else if (!bus_.empty() || to_host_.size() >= config_.host_queue_frames / 2) {
+                break;      // As fast as possible: one frame in flight, no overrun
+            }
+
+            struct can_frame frame;
+            std::memset(&frame, 0, sizeof(frame));
+            frame.can_id = record.can_id;
+            frame.can_dlc = std::min<std::uint8_t>(record.dlc, 8);
+            std::memcpy(frame.data, record.data, frame.can_dlc);
+            schedule_bus(frame, Origin::BUS, due);
+            ++stats_.injected;
+
+            if (++replay_index_ == records_.size() && replay_loop_) {
+                replay_index_ = 0;
+                replay_start_ = std::max(now, bus_free_);
+            }
+        }
+    }
+
+    void AdapterEmulator::complete_bus(Clock::time_point now,
+        std::vector<struct can_frame>& transmitted) {
+        const bool listening = state_.can_mode == CANMode::NORMAL ||
+            state_.can_mode == CANMode::SILENT;
+        while (!bus_.empty() && bus_.front().done <= now) {
+            BusSlot slot = bus_.front();
+            bus_.pop_front();
+            if (slot.origin == Origin::HOST) {
+                ++stats_.bus_frames;
+                transmitted.push_back(slot.frame);
+                if (config_.echo) {
+                    schedule_bus(slot.frame, Origin::BUS, slot.done);
+                }
+                continue;
+            }
+            if (!listening || !rate_matches()) {
+                continue;
+            }
+            if (!accepts(slot.frame)) {
+                ++stats_.filtered;
+                continue;
+            }
+            schedule_host(slot.frame, slot.done);
+        }
+    }
+
+    void AdapterEmulator::flush_host(Clock::time_point now) {
+        host_blocked_ = false;
+        while (!to_host_.empty() && to_host_.front().due <= now) {
+            const auto& bytes = to_host_.front().bytes;
+            ssize_t n = ::write(master_fd_, bytes.data() + written_, bytes.size() - written_);
+            if (n < 0) {
+                // The host is not reading: the pty buffer is the adapter's FIFO
+                host_blocked_ = (errno == EAGAIN || errno == EWOULDBLOCK);
+                break;
+            }
+            written_ += static_cast<std::size_t>(n);
+            if (written_ < bytes.size()) {
+                host_blocked_ = true;
+                break;
+            }
+            written_ = 0;
+            to_host_.pop_front();
+        }
+    }
+
+    std::optional<AdapterEmulator::Clock::time_point> AdapterEmulator::next_deadline() const {
+        std::optional<Clock::time_point> deadline;
+        auto earliest = [&deadline](Clock::time_point t) {
+            if (!deadline || t < *deadline) deadline = t;
+        };
+        if (!bus_.empty()) {
+            earliest(bus_.front().done);
+        }
+        if (!to_host_.empty() && !host_blocked_) {
+            earliest(to_host_.front().due);
+        }
+        if (replay_index_ < records_.size() && replay_speed_ == 0.0) {
+            if (bus_.empty() && to_host_.size() < config_.host_queue_frames / 2) {
+                earliest(Clock::time_point{});
+            }
+        } else if (replay_index_ < records_.size()) {
+            const double offset_us = static_cast<double>(
+                records_[replay_index_].timestamp_us - records_.front().timestamp_us) /
+                replay_speed_;
+            earliest(replay_start_ + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double, std::micro>(offset_us)));
+        }
+        return deadline;
+    }
+
+    // === Host stream ===
+
+    void AdapterEmulator::parse_input(Clock::time_point now) {
+        const std::uint8_t START = to_byte(Constants::START_BYTE);
+        const std::uint8_t HEADER = to_byte(Constants::HEADER);
+
+        std::size_t pos = 0;
+        while (pos < input_.size()) {
+            const std::uint8_t* data = input_.data() + pos;
+            const std::size_t available = input_.size() - pos;
+            if (data[0] != START) {
+                ++stats_.skipped_bytes;
+                ++pos;
+                continue;
+            }
+            if (available < 2) {
+                break;
+            }
+
+            // AA 55 starts a 20-byte frame, AA TYPE a variable one
+            std::size_t length = 0;
+            if (data[1] == HEADER) {
+                length = FIXED_SIZE;
+            } else if ((data[1] & 0xC0) == 0xC0 && (data[1] & 0x0F) <= CAN_MAX_DLEN) {
+                length = VariableFrameLayout::frame_size((data[1] & 0x20) != 0, data[1] & 0x0F);
+            } else {
+                ++stats_.skipped_bytes;
+                ++pos;
+                continue;
+            }
+            if (available < length) {
+                break;
+            }
+
+            // The frame is complete once its last byte is through the serial link
+            rx_free_ = std::max(now, rx_free_) + serial_time(length);
+            if (!handle_frame(data, length, rx_free_)) {
+                ++stats_.skipped_bytes;
+                ++pos;
+                continue;
+            }
+            pos += length;
+        }
+        input_.erase(input_.begin(), input_.begin() + static_cast<std::ptrdiff_t>(pos));
+    }
+
+    bool AdapterEmulator::handle_frame(const std::uint8_t* data, std::size_t size,
+        Clock::time_point ready) {
+        const std::uint8_t type = data[FixedFrameLayout::TYPE];
+        if (size == FIXED_SIZE && (type == to_byte(Type::CONF_FIXED) ||
+            type == to_byte(Type::CONF_VARIABLE))) {
+            try {
+                apply_config(data, size);
+            } catch (const ProtocolException&) {
+                return false;
+            }
+            return true;
+        }
+
+        FrameStreamDecoder& decoder = size == FIXED_SIZE ? fixed_decoder_ : variable_decoder_;
+        decoded_.clear();
+        decoder.decode(data, size, decoded_);
+        decoder.reset();
+        if (decoded_.empty()) {
+            return false;
+        }
+        ++stats_.host_frames;
+        schedule_bus(decoded_.front(), Origin::HOST, ready);
+        return true;
+    }
+
+    void AdapterEmulator::apply_config(const std::uint8_t* data, std::size_t size) {
+        ConfigFrame frame;
+        frame.deserialize(span<const std::uint8_t>(data, size));
+        state_.can_baud = frame.get_baud_rate();
+        state_.can_mode = frame.get_can_mode();
+        state_.auto_rtx = frame.get_auto_rtx();
+        state_.filter = frame.get_filter();
+        state_.mask = frame.get_mask();
+        state_.config_type = frame.get_type();
+        ++stats_.config_frames;
+    }
+
+    // === Thread ===
+
+    void AdapterEmulator::run() {
+        std::vector<struct can_frame> transmitted;
+        std::uint8_t buffer[READ_CHUNK];
+
+        while (running_.load()) {
+            std::optional<Clock::time_point> deadline;
+            bool want_write = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                const auto now = Clock::now();
+                complete_bus(now, transmitted);
+                replay_due(now);
+                flush_host(now);
+                deadline = next_deadline();
+                want_write = host_blocked_;
+            }
+            if (on_transmit_) {
+                for (const auto& frame : transmitted) {
+                    on_transmit_(frame);
+                }
+            }
+            transmitted.clear();
+
+            struct pollfd fds[2] = {
+                {master_fd_, static_cast<short>(POLLIN | (want_write ? POLLOUT : 0)), 0},
+                {wake_fd_, POLLIN, 0}
+            };
+            struct timespec timeout;
+            struct timespec* timeout_ptr = nullptr;
+            if (deadline) {
+                auto wait = std::max(Clock::duration::zero(), *deadline - Clock::now());
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(wait).count();
+                timeout.tv_sec = static_cast<time_t>(ns / 1000000000);
+                timeout.tv_nsec = static_cast<long>(ns % 1000000000);
+                timeout_ptr = &timeout;
+            }
+            if (::ppoll(fds, 2, timeout_ptr, nullptr) < 0 && errno != EINTR) {
+                break;
+            }
+
+            if (fds[1].revents & POLLIN) {
+                std::uint64_t value;
+                ssize_t ignored = ::read(wake_fd_, &value, sizeof(value));
+                (void)ignored;
+            }
+            if (fds[0].revents & POLLIN) {
+                ssize_t n = ::read(master_fd_, buffer, sizeof(buffer));
+                if (n > 0) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    input_.insert(input_.end(), buffer, buffer + n);
+                    parse_input(Clock::now());
+                }
+            }
+        }
+    }
+
+}  // namespace waveshare
@@ -52,6 +52,9 @@ namespace waveshare {
             throw std::invalid_argument("SocketCAN read timeout too large (max 60000ms)");
         }
 
+        // Compiling the rules checks their IDs, fields and divisors
+        GatewayRuleEngine{rules};
+
         // Validate filter/mask based on standard vs extended
         // Note: We can't determine if using standard or extended here,
         // so we just ensure they fit in 29 bits (extended max)
@@ -77,6 +80,7 @@ namespace waveshare {
         config.filter_mask = 0;
         config.usb_read_timeout_ms = 100;
         config.socketcan_read_timeout_ms = 100;
+        config.io_backend = IoBackend::POSIX;
         return config;
     }
 
@@ -134,11 +138,21 @@ namespace waveshare {
                 config_map["WAVESHARE_SOCKETCAN_READ_TIMEOUT"] =
                     std::to_string(bc["socketcan_read_timeout_ms"].get<uint32_t>());
             }
+            if (bc.contains("io_backend")) {
+                config_map["WAVESHARE_IO_BACKEND"] = bc["io_backend"].get<std::string>();
+            }
         }
 
         // Reuse existing parsing logic
         apply_config_map(config, config_map);
 
+        // Rules have no flat key-value form
+        if (j.contains("bridge_config") && j["bridge_config"].contains("rules")) {
+            for (const auto& rule : j["bridge_config"]["rules"]) {
+                config.rules.push_back(GatewayRule::from_json(rule));
+            }
+        }
+
         return config;
     }
 
@@ -220,6 +234,11 @@ namespace waveshare {
         if (auto val = get_val("WAVESHARE_SOCKETCAN_READ_TIMEOUT")) {
             config.socketcan_read_timeout_ms = std::stoul(*val);
         }
+
+        // Apply I/O backend
+        if (auto val = get_val("WAVESHARE_IO_BACKEND")) {
+            config.io_backend = io_backend_from_string(*val);
+        }
     }
 
     // === Load Methods ===
@@ -298,6 +317,9 @@ namespace waveshare {
         if ((val = std::getenv("WAVESHARE_SOCKETCAN_READ_TIMEOUT"))) {
             env_vars["WAVESHARE_SOCKETCAN_READ_TIMEOUT"] = val;
         }
+        if ((val = std::getenv("WAVESHARE_IO_BACKEND"))) {
+            env_vars["WAVESHARE_IO_BACKEND"] = val;
+        }
 
         // Apply environment variables over file config
         if (!env_vars.empty()) {
@@ -0,0 +1,307 @@
+/**
+ * @file bus_analyzer.cpp
+ * @brief Offline capture analysis implementation
+ * @version 1.0
+ * @date 2025-11-24
+ */
+
+#include <linux/can.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#include "../include/pattern/bus_analyzer.hpp"
+
+namespace waveshare {
+
+    namespace {
+        // Below this many records per thread, splitting costs more than it saves
+        constexpr std::size_t MIN_CHUNK_RECORDS = 1024;
+
+        /**
+         * @brief Per-ID state collected over a run of records
+         */
+        struct IdPartial {
+            std::uint64_t frames = 0;
+            std::uint64_t bits = 0;
+            std::uint64_t first_us = 0;
+            std::uint64_t last_us = 0;
+            std::vector<std::uint32_t> gaps;    ///< In capture order, microseconds
+        };
+
+        /**
+         * @brief Everything one thread collects over its chunk
+         */
+        struct ChunkResult {
+            std::unordered_map<std::uint32_t, IdPartial> ids;
+            std::uint64_t first_bin = 0;
+            std::vector<std::uint64_t> bin_frames;  ///< From first_bin on
+            std::vector<std::uint64_t> bin_bits;
+            std::uint64_t first_us = 0;
+            std::uint64_t last_us = 0;              ///< Latest timestamp seen
+            std::uint64_t out_of_order = 0;
+        };
+
+        std::uint32_t record_bits(const CaptureRecord& record) {
+            bool extended = (record.can_id & CAN_EFF_FLAG) != 0;
+            bool remote = (record.can_id & CAN_RTR_FLAG) != 0;
+            std::uint8_t dlc = record.dlc > CAN_MAX_DLEN ? CAN_MAX_DLEN : record.dlc;
+            return can_frame_bits(remote ? 0 : dlc, extended);
+        }
+
+        void scan_chunk(const CaptureRecord* records, std::size_t count, std::uint64_t origin_us,
+            std::uint64_t resolution_us, ChunkResult& out) {
+            std::uint64_t previous = records[0].timestamp_us;
+            out.first_us = previous;
+            out.last_us = previous;
+            out.first_bin = previous > origin_us ? (previous - origin_us) / resolution_us : 0;
+
+            // One-entry cache: consecutive frames often share an ID
+            std::uint32_t cached_id = records[0].can_id;
+            IdPartial* cached = &out.ids[cached_id];
+
+            for (std::size_t i = 0; i < count; ++i) {
+                const CaptureRecord& record = records[i];
+                const std::uint64_t ts = record.timestamp_us;
+                if (ts < previous) {
+                    ++out.out_of_order;
+                }
+                previous = ts;
+                out.last_us = std::max(out.last_us, ts);
+
+                if (record.can_id != cached_id) {
+                    cached_id = record.can_id;
+                    cached = &out.ids[cached_id];
+                }
+                IdPartial& id = *cached;
+                if (id.frames == 0) {
+                    id.first_us = ts;
+                    id.last_us = ts;
+                } else {
+                    std::uint64_t gap = ts > id.last_us ? ts - id.last_us : 0;
+                    id.gaps.push_back(static_cast<std::uint32_t>(std::min<std::uint64_t>(gap,
+                        std::numeric_limits<std::uint32_t>::max())));
+                    id.last_us = std::max(id.last_us, ts);
+                }
+                const std::uint32_t bits = record_bits(record);
+                ++id.frames;
+                id.bits += bits;
+
+                std::uint64_t bin = ts > origin_us ? (ts - origin_us) / resolution_us : 0;
+                std::size_t index = bin > out.first_bin
+                    ? static_cast<std::size_t>(bin - out.first_bin) : 0;
+                if (index >= out.bin_frames.size()) {
+                    out.bin_frames.resize(index + 1, 0);
+                    out.bin_bits.resize(index + 1, 0);
+                }
+                ++out.bin_frames[index];
+                out.bin_bits[index] += bits;
+            }
+        }
+
+        /**
+         * @brief Value at percentile p of sorted values
+         */
+        double percentile(const std::vector<double>& sorted, double p) {
+            if (sorted.empty()) {
+                return 0.0;
+            }
+            std::size_t rank = static_cast<std::size_t>(p / 100.0 *
+                static_cast<double>(sorted.size()));
+            return sorted[std::min(rank, sorted.size() - 1)];
+        }
+
+        IdStatistics summarize(std::uint32_t can_id, const IdPartial& partial,
+            const BusAnalyzerConfig& config, double capacity_bits) {
+            IdStatistics stats;
+            stats.can_id = can_id;
+            stats.frames = partial.frames;
+            stats.bits = partial.bits;
+            stats.first_us = partial.first_us;
+            stats.last_us = partial.last_us;
+            if (capacity_bits > 0.0) {
+                stats.load_percent = 100.0 * static_cast<double>(partial.bits) / capacity_bits;
+            }
+            if (partial.frames < config.min_frames || partial.gaps.empty()) {
+                return stats;
+            }
+
+            std::vector<std::uint32_t> ordered = partial.gaps;
+            auto middle = ordered.begin() + static_cast<std::ptrdiff_t>(ordered.size() / 2);
+            std::nth_element(ordered.begin(), middle, ordered.end());
+            const double period = static_cast<double>(*middle);
+            if (period <= 0.0) {
+                return stats;   // Mostly identical timestamps: no measurable period
+            }
+            stats.period_us = period;
+
+            std::vector<double> deviations;
+            deviations.reserve(partial.gaps.size());
+            std::uint64_t run = 0;
+            for (std::uint32_t gap_us : partial.gaps) {
+                const double gap = static_cast<double>(gap_us);
+                if (gap < config.burst_factor * period) {
+                    ++stats.burst_frames;
+                    if (run++ == 0) {
+                        ++stats.bursts;
+                    }
+                    stats.max_burst = std::max(stats.max_burst, run + 1);
+                    continue;
+                }
+                run = 0;
+                if (gap > config.missed_factor * period) {
+                    stats.missed_cycles += static_cast<std::uint64_t>(
+                        std::max(1.0, std::round(gap / period) - 1.0));
+                    continue;
+                }
+                deviations.push_back(std::fabs(gap - period));
+            }
+
+            std::sort(deviations.begin(), deviations.end());
+            stats.jitter_p50_us = percentile(deviations, 50.0);
+            stats.jitter_p95_us = percentile(deviations, 95.0);
+            stats.jitter_p99_us = percentile(deviations, 99.0);
+            stats.jitter_max_us = deviations.empty() ? 0.0 : deviations.back();
+            return stats;
+        }
+
+        /**
+         * @brief Run body(i) for i in [0, count) on up to threads threads
+         */
+        template<typename Body>
+        void parallel_for(std::size_t count, std::size_t threads, const Body& body) {
+            threads = std::min(threads, count);
+            if (threads <= 1) {
+                for (std::size_t i = 0; i < count; ++i) body(i);
+                return;
+            }
+            std::atomic<std::size_t> next{0};
+            std::vector<std::thread> workers;
+            for (std::size_t t = 0; t < threads; ++t) {
+                workers.emplace_back([&] {
+                        for (std::size_t i = next++; i < count; i = next++) body(i);
+                    });
+            }
+            for (auto& worker : workers) worker.join();
+        }
+    }
+
+    const LoadBin* BusAnalysis::peak_bin() const {
+        if (timeline.empty()) {
+            return nullptr;
+        }
+        return &*std::max_element(timeline.begin(), timeline.end(),
+            [](const LoadBin& a, const LoadBin& b) { return a.bits < b.bits; });
+    }
+
+    BusAnalyzer::BusAnalyzer(const BusAnalyzerConfig& config)
+        : config_(config) {
+        if (config_.resolution.count() <= 0) {
+            throw std::invalid_argument("BusAnalyzer: resolution must be > 0");
+        }
+        if (!(config_.burst_factor >= 0.0) || !(config_.missed_factor > 1.0) ||
+            config_.burst_factor >= config_.missed_factor) {
+            throw std::invalid_argument(
+                "BusAnalyzer: need 0 <= burst_factor < missed_factor and missed_factor > 1");
+        }
+        if (config_.threads == 0) {
+            config_.threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+    }
+
+    BusAnalysis BusAnalyzer::analyze(const CaptureRecord* records, std::size_t count) const {
+        BusAnalysis analysis;
+        if (count == 0) {
+            return analysis;
+        }
+
+        const std::uint64_t origin = records[0].timestamp_us;
+        const std::uint64_t resolution = static_cast<std::uint64_t>(config_.resolution.count());
+
+        // === Scan: one contiguous chunk per thread ===
+        std::size_t chunks = std::max<std::size_t>(1,
+            std::min(config_.threads, count / MIN_CHUNK_RECORDS));
+        std::vector<ChunkResult> results(chunks);
+        parallel_for(chunks, chunks, [&](std::size_t c) {
+                std::size_t begin = count * c / chunks;
+                std::size_t end = count * (c + 1) / chunks;
+                scan_chunk(records + begin, end - begin, origin, resolution, results[c]);
+            });
+
+        // === Stitch the chunks in capture order ===
+        std::unordered_map<std::uint32_t, IdPartial> ids;
+        std::uint64_t last_us = origin;
+        for (std::size_t c = 0; c < chunks; ++c) {
+            ChunkResult& chunk = results[c];
+            if (c > 0 && chunk.first_us < results[c - 1].last_us) {
+                ++analysis.out_of_order;
+            }
+            analysis.out_of_order += chunk.out_of_order;
+            last_us = std::max(last_us, chunk.last_us);
+
+            for (auto& [can_id, part] : chunk.ids) {
+                auto it = ids.find(can_id);
+                if (it == ids.end()) {
+                    ids.emplace(can_id, std::move(part));
+                    continue;
+                }
+                IdPartial& merged = it->second;
+                std::uint64_t gap = part.first_us > merged.last_us
+                    ? part.first_us - merged.last_us : 0;
+                merged.gaps.push_back(static_cast<std::uint32_t>(std::min<std::uint64_t>(gap,
+                    std::numeric_limits<std::uint32_t>::max())));
+                merged.gaps.insert(merged.gaps.end(), part.gaps.begin(), part.gaps.end());
+                merged.frames += part.frames;
+                merged.bits += part.bits;
+                merged.last_us = std::max(merged.last_us, part.last_us);
+            }
+        }
+
+        analysis.frames = count;
+        analysis.first_us = origin;
+        analysis.last_us = last_us;
+
+        // === Load timeline ===
+        const double bit_rate = canbaud_to_int(config_.can_baud);
+        const double bin_capacity = bit_rate * static_cast<double>(resolution) / 1e6;
+        analysis.timeline.resize(static_cast<std::size_t>((last_us - origin) / resolution) + 1);
+        for (std::size_t i = 0; i < analysis.timeline.size(); ++i) {
+            analysis.timeline[i].start_us = origin + i * resolution;
+        }
+        std::uint64_t total_bits = 0;
+        for (const auto& chunk : results) {
+            for (std::size_t i = 0; i < chunk.bin_frames.size(); ++i) {
+                LoadBin& bin = analysis.timeline[chunk.first_bin + i];
+                bin.frames += chunk.bin_frames[i];
+                bin.bits += chunk.bin_bits[i];
+                total_bits += chunk.bin_bits[i];
+            }
+        }
+        for (auto& bin : analysis.timeline) {
+            bin.load_percent = 100.0 * static_cast<double>(bin.bits) / bin_capacity;
+        }
+
+        // A capture of one instant still occupies one bin
+        const double span_us = static_cast<double>(std::max<std::uint64_t>(last_us - origin,
+            resolution));
+        const double capacity = bit_rate * span_us / 1e6;
+        analysis.load_percent = 100.0 * static_cast<double>(total_bits) / capacity;
+
+        // === Per-ID statistics, in parallel ===
+        std::vector<std::uint32_t> keys;
+        keys.reserve(ids.size());
+        for (const auto& entry : ids) keys.push_back(entry.first);
+        std::sort(keys.begin(), keys.end());
+
+        analysis.ids.resize(keys.size());
+        parallel_for(keys.size(), config_.threads, [&](std::size_t i) {
+                analysis.ids[i] = summarize(keys[i], ids.at(keys[i]), config_, capacity);
+            });
+        return analysis;
+    }
+
+}  // namespace waveshare
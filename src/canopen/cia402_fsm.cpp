@@ -6,6 +6,7 @@
  */
 
 #include "canopen/cia402_fsm.hpp"
+#include <algorithm>
 #include <iostream>
 #include <thread>
 
@@ -25,6 +26,11 @@ namespace canopen {
         update_state();
     }
 
+    CIA402FSM::~CIA402FSM() {
+        detach_emcy();
+        disable_pdo_mode();
+    }
+
 // =============================================================================
 // High-Level Control Methods
 // =============================================================================
@@ -232,6 +238,147 @@ namespace canopen {
         return true;
     }
 
+// =============================================================================
+// Event-Driven (PDO) Mode
+// =============================================================================
+
+    bool CIA402FSM::enable_pdo_mode(PDOManager& manager, bool subscribe) {
+        disable_pdo_mode();
+
+        PDOMapping tpdo;
+        try {
+            tpdo = PDOMapping::compile(dictionary_, "tpdo1");
+        } catch (const std::exception& e) {
+            std::cerr << "[CIA402] Cannot use PDO mode: " << e.what() << std::endl;
+            return false;
+        }
+        if (!tpdo.contains("statusword")) {
+            std::cerr << "[CIA402] Cannot use PDO mode: statusword is not mapped to TPDO1" <<
+                std::endl;
+            return false;
+        }
+        const PDOFieldLayout statusword = tpdo.field("statusword");
+        const uint8_t tpdo_length = tpdo.length();
+
+        controlword_via_rpdo_ = false;
+        try {
+            rpdo_ = PDOMapping::compile(dictionary_, "rpdo1");
+            if (rpdo_.contains("controlword") && rpdo_.field_count() == 1) {
+                controlword_field_ = rpdo_.field("controlword");
+                controlword_via_rpdo_ = true;
+            }
+        } catch (const std::exception&) {
+            // No RPDO1 in the dictionary: controlword stays on SDO
+        }
+        if (!controlword_via_rpdo_) {
+            std::cout << "[CIA402] RPDO1 does not carry the controlword alone, "
+                      << "controlword stays on SDO" << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(feedback_->mutex);
+            feedback_->valid = false;
+        }
+        pdo_manager_ = &manager;
+
+        if (subscribe) {
+            manager.register_tpdo_callback(pdo::PDOType::TPDO1, sdo_client_.get_node_id(),
+                [feedback = feedback_, statusword, tpdo_length](const can_frame& frame) {
+                    if (frame.can_dlc < tpdo_length) return;
+                    {
+                        std::lock_guard<std::mutex> lock(feedback->mutex);
+                        feedback->statusword = static_cast<uint16_t>(statusword.decode(frame.data));
+                        feedback->valid = true;
+                        ++feedback->updates;
+                    }
+                    feedback->cv.notify_all();
+                });
+            pdo_subscribed_ = true;
+        }
+
+        std::cout << "[CIA402] PDO mode enabled for node "
+                  << static_cast<int>(sdo_client_.get_node_id()) << std::endl;
+        return true;
+    }
+
+    void CIA402FSM::disable_pdo_mode() {
+        if (!pdo_manager_) {
+            return;
+        }
+
+        if (pdo_subscribed_) {
+            pdo_manager_->unregister_tpdo_callback(pdo::PDOType::TPDO1,
+                sdo_client_.get_node_id());
+            pdo_subscribed_ = false;
+        }
+        pdo_manager_ = nullptr;
+        controlword_via_rpdo_ = false;
+    }
+
+    void CIA402FSM::on_statusword(uint16_t statusword) {
+        {
+            std::lock_guard<std::mutex> lock(feedback_->mutex);
+            feedback_->statusword = statusword;
+            feedback_->valid = true;
+            ++feedback_->updates;
+        }
+        feedback_->cv.notify_all();
+    }
+
+// =============================================================================
+// Emergency (EMCY) Monitoring
+// =============================================================================
+
+    void CIA402FSM::attach_emcy(EMCYConsumer& consumer) {
+        detach_emcy();
+
+        emcy_subscription_ = consumer.subscribe(sdo_client_.get_node_id(),
+            [feedback = feedback_](const Emergency& emergency) {
+                report_emergency(*feedback, emergency.error_code);
+            });
+        emcy_consumer_ = &consumer;
+
+        std::cout << "[CIA402] EMCY monitoring enabled for node "
+                  << static_cast<int>(sdo_client_.get_node_id()) << std::endl;
+    }
+
+    void CIA402FSM::detach_emcy() {
+        if (!emcy_consumer_) {
+            return;
+        }
+
+        emcy_consumer_->unsubscribe(emcy_subscription_);
+        emcy_consumer_ = nullptr;
+        emcy_subscription_ = 0;
+    }
+
+    void CIA402FSM::on_emergency(uint16_t error_code) {
+        report_emergency(*feedback_, error_code);
+    }
+
+    uint16_t CIA402FSM::get_emergency_code() const {
+        std::lock_guard<std::mutex> lock(feedback_->mutex);
+        return feedback_->emergency_code;
+    }
+
+    void CIA402FSM::report_emergency(PDOFeedback& feedback, uint16_t error_code) {
+        {
+            std::lock_guard<std::mutex> lock(feedback.mutex);
+            feedback.emergency_code = error_code;
+            if (error_code != emcy::NO_ERROR) {
+                // Published as a FAULT statusword so PDO-mode waits see it like a TPDO
+                feedback.statusword = static_cast<uint16_t>(
+                    (feedback.statusword &
+                    ~cia402::to_pattern(cia402::StatuswordPattern::MASK)) |
+                    cia402::to_pattern(cia402::StatuswordPattern::FAULT));
+                feedback.valid = true;
+                ++feedback.updates;
+                ++feedback.emergencies;
+            }
+        }
+        feedback.cv.notify_all();
+    }
+
 // =============================================================================
 // State Query Methods
 // =============================================================================
@@ -278,9 +425,37 @@ namespace canopen {
 
     bool CIA402FSM::wait_for_state(cia402::State expected_state,
         std::chrono::milliseconds timeout) {
+        if (pdo_manager_) {
+            return wait_for_state_pdo(expected_state, timeout);
+        }
+
+        const uint64_t generation = cancel_generation_.load();
+        uint64_t emergencies;
+        {
+            std::lock_guard<std::mutex> lock(feedback_->mutex);
+            emergencies = feedback_->emergencies;
+        }
         auto start_time = std::chrono::steady_clock::now();
 
         while (std::chrono::steady_clock::now() - start_time < timeout) {
+            if (cancel_generation_.load() != generation) {
+                std::cerr << "[CIA402] Wait for " << cia402::state_to_string(expected_state)
+                          << " cancelled" << std::endl;
+                return false;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(feedback_->mutex);
+                if (feedback_->emergencies != emergencies) {
+                    current_state_ = cia402::State::FAULT;
+                    std::cerr << "[CIA402] Emergency 0x" << std::hex
+                              << feedback_->emergency_code << std::dec
+                              << " while waiting for "
+                              << cia402::state_to_string(expected_state) << std::endl;
+                    return false;
+                }
+            }
+
             update_state();
 
             if (current_state_ == expected_state) {
@@ -294,8 +469,12 @@ namespace canopen {
                 return false;
             }
 
-            // Small delay before retry
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            // Small delay before retry; an emergency or cancel_wait() cuts it short
+            std::unique_lock<std::mutex> lock(feedback_->mutex);
+            feedback_->cv.wait_for(lock, std::chrono::milliseconds(50), [&] {
+                return feedback_->emergencies != emergencies ||
+                cancel_generation_.load() != generation;
+            });
         }
 
         std::cerr << "[CIA402] Timeout waiting for state " <<
@@ -304,7 +483,104 @@ namespace canopen {
         return false;
     }
 
+    bool CIA402FSM::wait_for_state_pdo(cia402::State expected_state,
+        std::chrono::milliseconds timeout) {
+        const uint64_t generation = cancel_generation_.load();
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::unique_lock<std::mutex> lock(feedback_->mutex);
+
+        // Nothing received yet: start from an SDO read
+        if (!feedback_->valid) {
+            lock.unlock();
+            uint16_t statusword = read_statusword();
+            lock.lock();
+            ++fallback_polls_;
+            if (!feedback_->valid) {
+                feedback_->statusword = statusword;
+                feedback_->valid = true;
+                ++feedback_->updates;
+            }
+        }
+
+        while (true) {
+            apply_statusword(feedback_->statusword);
+
+            if (current_state_ == expected_state) {
+                return true;
+            }
+
+            // A FAULT sent before the last command (e.g. the one a reset is
+            // clearing) is stale until the drive reports again
+            if (current_state_ == cia402::State::FAULT &&
+                feedback_->updates > command_updates_) {
+                std::cerr << "[CIA402] Device entered FAULT state while waiting for "
+                          << cia402::state_to_string(expected_state) << std::endl;
+                return false;
+            }
+
+            if (cancel_generation_.load() != generation) {
+                std::cerr << "[CIA402] Wait for " << cia402::state_to_string(expected_state)
+                          << " cancelled" << std::endl;
+                return false;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                break;
+            }
+
+            // Sleep until the next TPDO; poll over SDO if the drive stays silent
+            const uint64_t seen = feedback_->updates;
+            auto wake = std::min(deadline, now + fallback_poll_interval_);
+            if (!feedback_->cv.wait_until(lock, wake, [&] {
+                return feedback_->updates != seen || cancel_generation_.load() != generation;
+            })) {
+                if (std::chrono::steady_clock::now() >= deadline) {
+                    break;
+                }
+                lock.unlock();
+                uint16_t statusword = read_statusword();
+                lock.lock();
+                ++fallback_polls_;
+                if (feedback_->updates == seen) {
+                    feedback_->statusword = statusword;
+                    ++feedback_->updates;
+                }
+            }
+        }
+
+        std::cerr << "[CIA402] Timeout waiting for state " <<
+            cia402::state_to_string(expected_state)
+                  << ", current state: " << cia402::state_to_string(current_state_) << std::endl;
+        return false;
+    }
+
+    void CIA402FSM::cancel_wait() {
+        {
+            // Bump under the lock so a PDO-mode waiter cannot miss the wake-up
+            std::lock_guard<std::mutex> lock(feedback_->mutex);
+            cancel_generation_.fetch_add(1);
+        }
+        feedback_->cv.notify_all();
+    }
+
     bool CIA402FSM::send_controlword(uint16_t command) {
+        if (pdo_manager_) {
+            std::lock_guard<std::mutex> lock(feedback_->mutex);
+            command_updates_ = feedback_->updates;
+        }
+
+        if (controlword_via_rpdo_) {
+            uint8_t payload[pdo::limits::MAX_PDO_DATA_LENGTH] = {};
+            controlword_field_.encode(payload, command);
+            if (!pdo_manager_->send_rpdo(rpdo_.type(), sdo_client_.get_node_id(), payload,
+                rpdo_.length())) {
+                std::cerr << "[CIA402] RPDO write failed for controlword" << std::endl;
+                return false;
+            }
+            return true;
+        }
+
         try {
             bool success = sdo_client_.write<uint16_t>("controlword", command);
             if (!success) {
@@ -332,8 +608,19 @@ namespace canopen {
     }
 
     void CIA402FSM::update_state() {
-        last_statusword_ = read_statusword();
-        current_state_ = cia402::decode_statusword(last_statusword_);
+        if (pdo_manager_) {
+            std::lock_guard<std::mutex> lock(feedback_->mutex);
+            if (feedback_->valid) {
+                apply_statusword(feedback_->statusword);
+                return;
+            }
+        }
+        apply_statusword(read_statusword());
+    }
+
+    void CIA402FSM::apply_statusword(uint16_t statusword) {
+        last_statusword_ = statusword;
+        current_state_ = cia402::decode_statusword(statusword);
         state_cache_valid_ = true;
     }
 
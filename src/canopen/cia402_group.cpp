@@ -0,0 +1,366 @@
+/**
+ * @file cia402_group.cpp
+ * @brief Parallel CIA402 state machine orchestration implementation
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-16
+ */
+
+#include "canopen/cia402_group.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+
+namespace canopen {
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        std::chrono::microseconds to_us(Clock::duration d) {
+            return std::chrono::duration_cast<std::chrono::microseconds>(d);
+        }
+
+        /**
+         * @brief Outcome of one node's task within a burst
+         */
+        struct TaskOutcome {
+            bool ok = false;
+            Clock::time_point released;
+            Clock::duration elapsed{};
+        };
+    }
+
+    CIA402Group::CIA402Group(std::chrono::milliseconds state_timeout)
+        : state_timeout_(state_timeout) {
+    }
+
+    void CIA402Group::add(CIA402FSM& fsm) {
+        for (const CIA402FSM* member : members_) {
+            if (member->get_node_id() == fsm.get_node_id()) {
+                throw std::invalid_argument("CIA402Group: node " +
+                    std::to_string(fsm.get_node_id()) + " already in group");
+            }
+        }
+        members_.push_back(&fsm);
+    }
+
+// =============================================================================
+// Group Transitions
+// =============================================================================
+
+    GroupResult CIA402Group::enable_operation() {
+        using cia402::State;
+        using cia402::ControlwordCommand;
+
+        const auto timeout = state_timeout_;
+        return run_sequence("enable operation",
+            {
+                {{State::SWITCH_ON_DISABLED}, ControlwordCommand::SHUTDOWN,
+                 State::READY_TO_SWITCH_ON},
+                {{State::READY_TO_SWITCH_ON}, ControlwordCommand::SWITCH_ON, State::SWITCHED_ON},
+                {{State::SWITCHED_ON}, ControlwordCommand::ENABLE_OPERATION,
+                 State::OPERATION_ENABLED},
+            },
+            [](State state) { return state == State::OPERATION_ENABLED; },
+            [](State state) {
+                return state == State::FAULT || state == State::NOT_READY_TO_SWITCH_ON;
+            },
+            [timeout](CIA402FSM& fsm) {
+                if (fsm.get_current_state() == State::FAULT) {
+                    return fsm.reset_fault();
+                }
+                // Drive still initializing: the transition to SWITCH_ON_DISABLED is automatic
+                return fsm.wait_for_state(State::SWITCH_ON_DISABLED, timeout * 5);
+            });
+    }
+
+    GroupResult CIA402Group::disable_operation() {
+        using cia402::State;
+
+        return run_sequence("disable operation",
+            {
+                {{State::OPERATION_ENABLED}, cia402::ControlwordCommand::DISABLE_OPERATION,
+                 State::SWITCHED_ON},
+            },
+            [](State state) { return state != State::OPERATION_ENABLED && state != State::FAULT; });
+    }
+
+    GroupResult CIA402Group::shutdown() {
+        using cia402::State;
+
+        return run_sequence("shutdown",
+            {
+                {{State::SWITCH_ON_DISABLED, State::SWITCHED_ON, State::OPERATION_ENABLED},
+                 cia402::ControlwordCommand::SHUTDOWN, State::READY_TO_SWITCH_ON},
+            },
+            [](State state) { return state == State::READY_TO_SWITCH_ON; });
+    }
+
+    GroupResult CIA402Group::reset_fault() {
+        using cia402::State;
+
+        return run_sequence("fault reset", {},
+            [](State state) { return state != State::FAULT; },
+            [](State state) { return state == State::FAULT; },
+            [](CIA402FSM& fsm) { return fsm.reset_fault(); });
+    }
+
+    GroupResult CIA402Group::quick_stop() {
+        using cia402::State;
+
+        // Pre-empt whatever the group is doing without waiting for it to
+        // return; the operation sees cancelled_ and unwinds on its own. In
+        // SDO mode each Quick Stop write still queues behind the transfer the
+        // operation has in flight on that node
+        cancel();
+        std::lock_guard<std::mutex> lock(stop_mutex_);
+        stopping_.store(true);
+        {
+            // Barrier: a step command already being sent goes out first, any
+            // later one sees cancelled_ and is dropped
+            std::unique_lock<std::shared_mutex> barrier(command_mutex_);
+        }
+
+        std::cout << "[CIA402] Group quick stop (" << members_.size() << " nodes)" << std::endl;
+
+        auto start = Clock::now();
+        GroupResult result = begin();
+        std::vector<bool> ok(members_.size(), false);
+        std::vector<std::size_t> all(members_.size());
+        for (std::size_t i = 0; i < all.size(); ++i) all[i] = i;
+
+        const auto timeout = state_timeout_;
+        run_burst(all, [timeout](CIA402FSM& fsm) {
+                // Target follows the last known state: only enabled drives hold in quick stop
+                State target = fsm.get_current_state() == State::OPERATION_ENABLED
+                    ? State::QUICK_STOP_ACTIVE : State::SWITCH_ON_DISABLED;
+                if (!fsm.send_controlword(cia402::to_command(
+                    cia402::ControlwordCommand::QUICK_STOP))) {
+                    return false;
+                }
+                return fsm.wait_for_state(target, timeout);
+            }, GroupWait::ALL, ok, result);
+
+        stopping_.store(false);
+
+        result = finish(std::move(result), ok, GroupWait::ALL, start);
+        std::cout << "[CIA402] Group quick stop " << (result.success ? "complete" : "FAILED")
+                  << " in " << result.elapsed.count() << " us (skew "
+                  << result.command_skew.count() << " us)" << std::endl;
+        return result;
+    }
+
+    GroupResult CIA402Group::wait_for_state(cia402::State state, GroupWait policy,
+        std::chrono::milliseconds timeout) {
+        std::lock_guard<std::mutex> lock(operation_mutex_);
+        cancelled_.store(false);
+
+        auto start = Clock::now();
+        GroupResult result = begin();
+        std::vector<bool> ok(members_.size(), false);
+        std::vector<std::size_t> all(members_.size());
+        for (std::size_t i = 0; i < all.size(); ++i) all[i] = i;
+
+        run_burst(all, [state, timeout](CIA402FSM& fsm) {
+                return fsm.wait_for_state(state, timeout);
+            }, policy, ok, result);
+
+        return finish(std::move(result), ok, policy, start);
+    }
+
+    void CIA402Group::cancel() {
+        cancelled_.store(true);
+        for (CIA402FSM* member : members_) {
+            member->cancel_wait();
+        }
+    }
+
+// =============================================================================
+// Internal Helper Methods
+// =============================================================================
+
+    GroupResult CIA402Group::begin() const {
+        GroupResult result;
+        result.nodes.reserve(members_.size());
+        for (const CIA402FSM* member : members_) {
+            NodeResult node;
+            node.node_id = member->get_node_id();
+            result.nodes.push_back(node);
+        }
+        return result;
+    }
+
+    std::vector<std::size_t> CIA402Group::select(const std::vector<bool>& ok,
+        const StatePredicate& predicate) const {
+        std::vector<std::size_t> selected;
+        for (std::size_t i = 0; i < members_.size(); ++i) {
+            if (ok[i] && predicate(members_[i]->get_current_state())) {
+                selected.push_back(i);
+            }
+        }
+        return selected;
+    }
+
+    void CIA402Group::run_burst(const std::vector<std::size_t>& selected, const NodeTask& task,
+        GroupWait policy, std::vector<bool>& ok, GroupResult& result) {
+        if (selected.empty()) {
+            return;
+        }
+
+        std::mutex done_mutex;
+        std::condition_variable done_cv;
+        std::size_t done = 0;
+        bool any_success = false;
+
+        // Threads are started first and released together, so thread start-up
+        // cost does not show up as command skew between nodes
+        std::promise<void> gate;
+        std::shared_future<void> go = gate.get_future().share();
+
+        std::vector<std::future<TaskOutcome>> pending;
+        pending.reserve(selected.size());
+        for (std::size_t index : selected) {
+            CIA402FSM* fsm = members_[index];
+            pending.push_back(std::async(std::launch::async, [&, fsm]() {
+                    go.wait();
+                    TaskOutcome outcome;
+                    outcome.released = Clock::now();
+                    try {
+                        outcome.ok = task(*fsm);
+                    } catch (const std::exception& e) {
+                        std::cerr << "[CIA402] Node " << static_cast<int>(fsm->get_node_id())
+                                  << ": " << e.what() << std::endl;
+                    }
+                    outcome.elapsed = Clock::now() - outcome.released;
+
+                    {
+                        std::lock_guard<std::mutex> lock(done_mutex);
+                        ++done;
+                        any_success = any_success || outcome.ok;
+                    }
+                    done_cv.notify_all();
+                    return outcome;
+                }));
+        }
+        gate.set_value();
+
+        // Wake periodically so a cancel issued just before a node entered its
+        // wait is re-sent rather than lost
+        {
+            std::unique_lock<std::mutex> lock(done_mutex);
+            while (done < selected.size()) {
+                done_cv.wait_for(lock, std::chrono::milliseconds(10));
+                // A cancel is not re-sent while a quick stop waits on the same nodes
+                bool stop = (cancelled_.load() && !stopping_.load()) ||
+                    (policy == GroupWait::ANY && any_success);
+                if (stop && done < selected.size()) {
+                    lock.unlock();
+                    for (std::size_t index : selected) {
+                        members_[index]->cancel_wait();
+                    }
+                    lock.lock();
+                }
+            }
+        }
+
+        Clock::time_point first = Clock::time_point::max();
+        Clock::time_point last = Clock::time_point::min();
+        for (std::size_t i = 0; i < selected.size(); ++i) {
+            TaskOutcome outcome = pending[i].get();
+            ok[selected[i]] = outcome.ok;
+            result.nodes[selected[i]].elapsed += to_us(outcome.elapsed);
+            first = std::min(first, outcome.released);
+            last = std::max(last, outcome.released);
+        }
+        result.command_skew = std::max(result.command_skew, to_us(last - first));
+    }
+
+    void CIA402Group::run_step(const Step& step, std::vector<bool>& ok, GroupResult& result) {
+        auto selected = select(ok, [&step](cia402::State state) {
+                return std::find(step.from.begin(), step.from.end(), state) != step.from.end();
+            });
+        if (selected.empty()) {
+            return;
+        }
+
+        const uint16_t command = cia402::to_command(step.command);
+        const cia402::State target = step.to;
+        const auto timeout = state_timeout_;
+        run_burst(selected, [this, command, target, timeout](CIA402FSM& fsm) {
+                {
+                    std::shared_lock<std::shared_mutex> lock(command_mutex_);
+                    if (cancelled_.load() || !fsm.send_controlword(command)) {
+                        return false;
+                    }
+                }
+                return !cancelled_.load() && fsm.wait_for_state(target, timeout);
+            }, GroupWait::ALL, ok, result);
+    }
+
+    GroupResult CIA402Group::finish(GroupResult result, const std::vector<bool>& ok,
+        GroupWait policy, Clock::time_point start) const {
+        std::size_t succeeded = 0;
+        for (std::size_t i = 0; i < members_.size(); ++i) {
+            result.nodes[i].success = ok[i];
+            result.nodes[i].state = members_[i]->get_current_state();
+            if (ok[i]) ++succeeded;
+        }
+
+        result.success = policy == GroupWait::ALL
+            ? succeeded == members_.size()
+            : succeeded > 0;
+        result.elapsed = to_us(Clock::now() - start);
+        return result;
+    }
+
+    GroupResult CIA402Group::run_sequence(const char* name, const std::vector<Step>& steps,
+        const StatePredicate& done, const StatePredicate& needs_prepare,
+        const NodeTask& prepare) {
+        std::lock_guard<std::mutex> lock(operation_mutex_);
+        cancelled_.store(false);
+
+        std::cout << "[CIA402] Group " << name << " (" << members_.size() << " nodes)" <<
+            std::endl;
+
+        auto start = Clock::now();
+        GroupResult result = begin();
+        std::vector<bool> ok(members_.size(), true);
+
+        // Read every node's state in parallel before deciding what to send
+        run_burst(select(ok, [](cia402::State) { return true; }),
+            [](CIA402FSM& fsm) {
+                fsm.get_current_state(true);
+                return true;
+            }, GroupWait::ALL, ok, result);
+        result.command_skew = std::chrono::microseconds(0);
+
+        if (prepare && !cancelled_.load()) {
+            run_burst(select(ok, needs_prepare), prepare, GroupWait::ALL, ok, result);
+        }
+
+        for (const auto& step : steps) {
+            if (cancelled_.load()) {
+                break;
+            }
+            run_step(step, ok, result);
+        }
+
+        for (std::size_t i = 0; i < members_.size(); ++i) {
+            ok[i] = ok[i] && !cancelled_.load() && done(members_[i]->get_current_state());
+        }
+
+        result = finish(std::move(result), ok, GroupWait::ALL, start);
+        for (const auto& node : result.nodes) {
+            if (!node.success) {
+                std::cerr << "[CIA402] Group " << name << ": node "
+                          << static_cast<int>(node.node_id) << " failed in state "
+                          << cia402::state_to_string(node.state) << std::endl;
+            }
+        }
+        std::cout << "[CIA402] Group " << name << " " << (result.success ? "complete" : "FAILED")
+                  << " in " << result.elapsed.count() << " us" << std::endl;
+        return result;
+    }
+
+} // namespace canopen
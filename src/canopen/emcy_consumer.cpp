@@ -0,0 +1,302 @@
+/**
+ * @file emcy_consumer.cpp
+ * @brief EMCY consumer with per-node error history implementation
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-20
+ */
+
+#include "canopen/emcy_consumer.hpp"
+#include <sys/select.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+namespace canopen {
+
+    namespace {
+
+        uint64_t pack(const uint8_t* data, std::size_t length) {
+            uint64_t payload = 0;
+            for (std::size_t i = 0; i < length; ++i) {
+                payload |= static_cast<uint64_t>(data[i]) << (8 * i);
+            }
+            return payload;
+        }
+
+        Emergency unpack(uint8_t node_id, uint64_t payload, int64_t ticks) {
+            can_frame frame{};
+            frame.can_dlc = emcy::FRAME_LENGTH;
+            for (std::size_t i = 0; i < emcy::FRAME_LENGTH; ++i) {
+                frame.data[i] = static_cast<uint8_t>(payload >> (8 * i));
+            }
+            return Emergency::decode(node_id, frame, std::chrono::steady_clock::time_point(
+                std::chrono::steady_clock::duration(ticks)));
+        }
+
+    } // namespace
+
+    Emergency Emergency::decode(uint8_t node_id, const can_frame& frame,
+        std::chrono::steady_clock::time_point timestamp) {
+        uint8_t data[emcy::FRAME_LENGTH] = {};
+        std::memcpy(data, frame.data, std::min<std::size_t>(frame.can_dlc, emcy::FRAME_LENGTH));
+
+        Emergency emergency;
+        emergency.node_id = node_id;
+        emergency.error_code = static_cast<uint16_t>(data[0] | (data[1] << 8));
+        emergency.error_register = data[2];
+        std::copy(data + 3, data + emcy::FRAME_LENGTH, emergency.manufacturer.begin());
+        emergency.timestamp = timestamp;
+        return emergency;
+    }
+
+    EMCYConsumer::EMCYConsumer(std::shared_ptr<waveshare::ICANSocket> socket)
+        : socket_(std::move(socket))
+        , nodes_(new NodeHistory[pdo::MAX_NODE_ID + 1])
+        , subscribers_(std::make_shared<const SubscriberList>()) {
+        if (!socket_ || !socket_->is_open()) {
+            throw std::runtime_error("EMCYConsumer: socket must be open and valid");
+        }
+    }
+
+    EMCYConsumer::~EMCYConsumer() {
+        stop();
+    }
+
+// =============================================================================
+// Lifecycle Management
+// =============================================================================
+
+    bool EMCYConsumer::start() {
+        if (running_.exchange(true)) {
+            return true;
+        }
+
+        receive_thread_ = std::thread(&EMCYConsumer::receive_loop, this);
+        std::cout << "[EMCY] Consumer started on " << socket_->get_interface_name() << std::endl;
+        return true;
+    }
+
+    void EMCYConsumer::stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+
+        if (receive_thread_.joinable()) {
+            receive_thread_.join();
+        }
+        std::cout << "[EMCY] Consumer stopped" << std::endl;
+    }
+
+    void EMCYConsumer::receive_loop() {
+        can_frame frame;
+
+        while (running_.load()) {
+            fd_set readfds;
+            FD_ZERO(&readfds);
+            FD_SET(socket_->get_fd(), &readfds);
+
+            // Wake periodically to notice stop()
+            struct timeval timeout;
+            timeout.tv_sec = 0;
+            timeout.tv_usec = 100000;
+
+            int ret = select(socket_->get_fd() + 1, &readfds, nullptr, nullptr, &timeout);
+            if (ret < 0 && errno != EINTR) {
+                std::cerr << "[EMCY] select() error: " << strerror(errno) << std::endl;
+                continue;
+            }
+
+            if (ret > 0 && socket_->receive(frame) == sizeof(frame)) {
+                process(frame);
+            }
+        }
+    }
+
+    bool EMCYConsumer::process(const can_frame& frame) {
+        if (frame.can_id & (CAN_EFF_FLAG | CAN_RTR_FLAG | CAN_ERR_FLAG)) {
+            return false;
+        }
+
+        uint32_t cob_id = frame.can_id & CAN_SFF_MASK;
+        if (cob_id <= emcy::EMCY_BASE || cob_id > emcy::emcy_cob_id(pdo::MAX_NODE_ID)) {
+            return false;
+        }
+
+        if (frame.can_dlc < 3) {
+            malformed_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        uint8_t node_id = static_cast<uint8_t>(cob_id - emcy::EMCY_BASE);
+        Emergency emergency = Emergency::decode(node_id, frame, now);
+
+        record(emergency, pack(frame.data,
+            std::min<std::size_t>(frame.can_dlc, emcy::FRAME_LENGTH)));
+
+        received_.fetch_add(1, std::memory_order_relaxed);
+        if (emergency.is_reset()) {
+            resets_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            std::cerr << "[EMCY] Node " << static_cast<int>(node_id) << " error 0x"
+                      << std::hex << std::setw(4) << std::setfill('0') << emergency.error_code
+                      << " (" << emcy::error_class_to_string(emergency.error_class())
+                      << "), register 0x" << std::setw(2)
+                      << static_cast<int>(emergency.error_register)
+                      << std::dec << std::setfill(' ') << std::endl;
+        }
+
+        dispatch(emergency);
+        return true;
+    }
+
+    void EMCYConsumer::record(const Emergency& emergency, uint64_t payload) {
+        NodeHistory& history = nodes_[emergency.node_id];
+        uint64_t position = history.head.load(std::memory_order_relaxed);
+        Slot& slot = history.slots[position % HISTORY_SIZE];
+
+        // Seqlock write: odd sequence while the slot is inconsistent
+        slot.sequence.store(2 * position + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.payload.store(payload, std::memory_order_relaxed);
+        slot.timestamp.store(emergency.timestamp.time_since_epoch().count(),
+            std::memory_order_relaxed);
+        slot.sequence.store(2 * position + 2, std::memory_order_release);
+
+        history.active_error.store(emergency.error_code, std::memory_order_relaxed);
+        history.error_register.store(emergency.error_register, std::memory_order_relaxed);
+        history.head.store(position + 1, std::memory_order_release);
+    }
+
+    void EMCYConsumer::dispatch(const Emergency& emergency) {
+        std::shared_ptr<const SubscriberList> subscribers = std::atomic_load(&subscribers_);
+
+        for (const Subscriber& subscriber : *subscribers) {
+            if (subscriber.node_id != ALL_NODES && subscriber.node_id != emergency.node_id) {
+                continue;
+            }
+            try {
+                subscriber.callback(emergency);
+            } catch (const std::exception& e) {
+                callback_errors_.fetch_add(1, std::memory_order_relaxed);
+                std::cerr << "[EMCY] Callback exception: " << e.what() << std::endl;
+            }
+        }
+    }
+
+// =============================================================================
+// Subscriptions
+// =============================================================================
+
+    EMCYConsumer::SubscriptionId EMCYConsumer::subscribe(uint8_t node_id, Callback callback) {
+        if (node_id > pdo::MAX_NODE_ID) {
+            throw std::invalid_argument("EMCYConsumer: invalid node ID " +
+                std::to_string(node_id));
+        }
+
+        std::lock_guard<std::mutex> lock(subscribers_mutex_);
+        auto updated = std::make_shared<SubscriberList>(*subscribers_);
+        SubscriptionId id = next_subscription_++;
+        updated->push_back({id, node_id, std::move(callback)});
+        std::atomic_store(&subscribers_, std::shared_ptr<const SubscriberList>(std::move(updated)));
+        return id;
+    }
+
+    void EMCYConsumer::unsubscribe(SubscriptionId id) {
+        std::lock_guard<std::mutex> lock(subscribers_mutex_);
+        auto updated = std::make_shared<SubscriberList>(*subscribers_);
+        updated->erase(std::remove_if(updated->begin(), updated->end(),
+            [id](const Subscriber& subscriber) { return subscriber.id == id; }), updated->end());
+        std::atomic_store(&subscribers_, std::shared_ptr<const SubscriberList>(std::move(updated)));
+    }
+
+// =============================================================================
+// History
+// =============================================================================
+
+    const EMCYConsumer::NodeHistory* EMCYConsumer::node(uint8_t node_id) const {
+        if (node_id == 0 || node_id > pdo::MAX_NODE_ID) {
+            return nullptr;
+        }
+        return &nodes_[node_id];
+    }
+
+    std::vector<Emergency> EMCYConsumer::history(uint8_t node_id) const {
+        std::vector<Emergency> result;
+        const NodeHistory* history = node(node_id);
+        if (!history) {
+            return result;
+        }
+
+        uint64_t head = history->head.load(std::memory_order_acquire);
+        uint64_t first = head > HISTORY_SIZE ? head - HISTORY_SIZE : 0;
+        result.reserve(static_cast<std::size_t>(head - first));
+
+        for (uint64_t position = first; position < head; ++position) {
+            const Slot& slot = history->slots[position % HISTORY_SIZE];
+            uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != 2 * position + 2) {
+                continue;   // Overwritten by a newer emergency
+            }
+            uint64_t payload = slot.payload.load(std::memory_order_relaxed);
+            int64_t timestamp = slot.timestamp.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+                continue;
+            }
+            result.push_back(unpack(node_id, payload, timestamp));
+        }
+        return result;
+    }
+
+    std::optional<Emergency> EMCYConsumer::last_emergency(uint8_t node_id) const {
+        const NodeHistory* history = node(node_id);
+        if (!history) {
+            return std::nullopt;
+        }
+
+        // A newer emergency may overwrite the slot while it is read: retry
+        while (true) {
+            uint64_t head = history->head.load(std::memory_order_acquire);
+            if (head == 0) {
+                return std::nullopt;
+            }
+            const Slot& slot = history->slots[(head - 1) % HISTORY_SIZE];
+            uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            uint64_t payload = slot.payload.load(std::memory_order_relaxed);
+            int64_t timestamp = slot.timestamp.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence == 2 * head && slot.sequence.load(std::memory_order_relaxed) == sequence) {
+                return unpack(node_id, payload, timestamp);
+            }
+        }
+    }
+
+    uint16_t EMCYConsumer::active_error(uint8_t node_id) const {
+        const NodeHistory* history = node(node_id);
+        return history ? history->active_error.load(std::memory_order_relaxed) : 0;
+    }
+
+    uint8_t EMCYConsumer::error_register(uint8_t node_id) const {
+        const NodeHistory* history = node(node_id);
+        return history ? history->error_register.load(std::memory_order_relaxed) : 0;
+    }
+
+    uint64_t EMCYConsumer::emergency_count(uint8_t node_id) const {
+        const NodeHistory* history = node(node_id);
+        return history ? history->head.load(std::memory_order_acquire) : 0;
+    }
+
+    EMCYConsumer::StatisticsSnapshot EMCYConsumer::get_statistics() const {
+        return {
+            received_.load(std::memory_order_relaxed),
+            resets_.load(std::memory_order_relaxed),
+            malformed_.load(std::memory_order_relaxed),
+            callback_errors_.load(std::memory_order_relaxed)
+        };
+    }
+
+} // namespace canopen
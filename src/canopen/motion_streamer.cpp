@@ -0,0 +1,328 @@
+/**
+ * @file motion_streamer.cpp
+ * @brief CSP/CSV setpoint streaming implementation
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-15
+ */
+
+#include "canopen/motion_streamer.hpp"
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace canopen {
+
+    namespace {
+        bool is_position_mode(cia402::OperationMode mode) {
+            return mode == cia402::OperationMode::CYCLIC_SYNC_POSITION;
+        }
+
+        int64_t to_raw(double value, double scale) {
+            return static_cast<int64_t>(std::llround(value / scale));
+        }
+    }
+
+    std::size_t MotionStreamer::Channel::size() const {
+        std::size_t h = head.load(std::memory_order_acquire);
+        std::size_t t = tail.load(std::memory_order_acquire);
+        return (t + ring.size() - h) % ring.size();
+    }
+
+    MotionStreamer::MotionStreamer(PDOManager& manager, const ObjectDictionary& dictionary,
+        MotionStreamConfig config)
+        : manager_(manager), config_(std::move(config)) {
+        if (config_.mode != cia402::OperationMode::CYCLIC_SYNC_POSITION &&
+            config_.mode != cia402::OperationMode::CYCLIC_SYNC_VELOCITY) {
+            throw std::invalid_argument("MotionStreamer: mode must be CSP or CSV");
+        }
+        if (config_.period.count() <= 0 || config_.buffer_capacity < 2) {
+            throw std::invalid_argument("MotionStreamer: invalid period or buffer capacity");
+        }
+
+        const bool position = is_position_mode(config_.mode);
+        const std::string target_name = position ? "target_position" : "target_velocity";
+        const std::string actual_name = position ? "position_actual" : "velocity_actual";
+
+        rpdo_ = PDOMapping::compile(dictionary, config_.rpdo);
+        if (!PDOManager::is_rpdo(rpdo_.type())) {
+            throw std::runtime_error("MotionStreamer: " + config_.rpdo + " is not an RPDO");
+        }
+        if (!rpdo_.contains(target_name)) {
+            throw std::runtime_error("MotionStreamer: " + target_name + " is not mapped in " +
+                config_.rpdo + "; set MotionStreamConfig::rpdo to the RPDO carrying it");
+        }
+        target_ = rpdo_.field(target_name);
+        has_controlword_ = rpdo_.contains("controlword");
+        if (has_controlword_) {
+            controlword_ = rpdo_.field("controlword");
+        }
+
+        if (!config_.feedback_tpdo.empty()) {
+            feedback_ = PDOMapping::compile(dictionary, config_.feedback_tpdo);
+            if (!PDOManager::is_tpdo(feedback_.type())) {
+                throw std::runtime_error("MotionStreamer: " + config_.feedback_tpdo +
+                    " is not a TPDO");
+            }
+            if (!feedback_.contains(actual_name)) {
+                throw std::runtime_error("MotionStreamer: " + actual_name + " is not mapped in " +
+                    config_.feedback_tpdo + "; set MotionStreamConfig::feedback_tpdo");
+            }
+            actual_ = feedback_.field(actual_name);
+            has_feedback_ = true;
+        }
+
+        active_.reserve(pdo::MAX_NODE_ID);
+    }
+
+    MotionStreamer::~MotionStreamer() {
+        // A callback already dispatched keeps its channel alive until it returns
+        if (has_feedback_) {
+            for (Channel* ch : active_) {
+                manager_.unregister_tpdo_callback(feedback_.type(), ch->node_id);
+            }
+        }
+    }
+
+    MotionStreamer::Channel* MotionStreamer::channel(uint8_t node_id) const {
+        if (node_id < pdo::MIN_NODE_ID || node_id > pdo::MAX_NODE_ID) {
+            return nullptr;
+        }
+        return channels_[node_id].get();
+    }
+
+    void MotionStreamer::add_node(uint8_t node_id) {
+        if (node_id < pdo::MIN_NODE_ID || node_id > pdo::MAX_NODE_ID) {
+            throw std::invalid_argument("MotionStreamer: invalid node ID " +
+                std::to_string(node_id));
+        }
+        if (channels_[node_id]) {
+            throw std::invalid_argument("MotionStreamer: node " + std::to_string(node_id) +
+                " already streamed");
+        }
+
+        auto ch = std::make_shared<Channel>();
+        ch->node_id = node_id;
+        ch->ring.resize(config_.buffer_capacity + 1);
+        active_.push_back(ch.get());
+        channels_[node_id] = ch;
+
+        if (has_feedback_) {
+            // Captures only the channel and copies of the layout, never this
+            manager_.register_tpdo_callback(feedback_.type(), node_id,
+                [ch, actual = actual_, length = feedback_.length(),
+                limit = config_.following_error_limit](const can_frame& frame) {
+                    if (frame.can_dlc < length) return;
+                    double value = static_cast<double>(actual.decode(frame.data)) * actual.scale;
+                    record_actual(*ch, value, limit);
+                });
+        }
+    }
+
+    bool MotionStreamer::push(uint8_t node_id, const Waypoint& waypoint) {
+        Channel* ch = channel(node_id);
+        if (!ch || waypoint.time_s <= ch->last_pushed_time) {
+            return false;
+        }
+
+        std::size_t tail = ch->tail.load(std::memory_order_relaxed);
+        std::size_t next = (tail + 1) % ch->ring.size();
+        if (next == ch->head.load(std::memory_order_acquire)) {
+            return false;  // Full
+        }
+
+        ch->ring[tail] = waypoint;
+        ch->last_pushed_time = waypoint.time_s;
+        ch->finished.store(false, std::memory_order_relaxed);
+        ch->tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    void MotionStreamer::finish(uint8_t node_id) {
+        if (Channel* ch = channel(node_id)) {
+            ch->finished.store(true, std::memory_order_release);
+        }
+    }
+
+    void MotionStreamer::attach(SyncScheduler& scheduler) {
+        if (scheduler.period() != config_.period) {
+            throw std::invalid_argument("MotionStreamer: scheduler period does not match");
+        }
+        scheduler_ = &scheduler;
+        scheduler.set_cycle_callback([this](uint64_t) { step(); });
+    }
+
+    double MotionStreamer::interpolate(const Waypoint& from, const Waypoint& to, double t) {
+        double h = to.time_s - from.time_s;
+        if (h <= 0.0 || t <= from.time_s) return from.value;
+        if (t >= to.time_s) return to.value;
+
+        // Cubic Hermite basis on s ∈ [0, 1]
+        double s = (t - from.time_s) / h;
+        double s2 = s * s;
+        double s3 = s2 * s;
+        double h00 = 2 * s3 - 3 * s2 + 1;
+        double h10 = s3 - 2 * s2 + s;
+        double h01 = -2 * s3 + 3 * s2;
+        double h11 = s3 - s2;
+
+        return h00 * from.value + h10 * h * from.derivative +
+               h01 * to.value + h11 * h * to.derivative;
+    }
+
+    bool MotionStreamer::next_setpoint(Channel& ch, double& setpoint) {
+        const std::size_t capacity = ch.ring.size();
+        std::size_t head = ch.head.load(std::memory_order_relaxed);
+        const std::size_t tail = ch.tail.load(std::memory_order_acquire);
+
+        if (!ch.started) {
+            if (head == tail) return false;  // Idle until the first waypoint arrives
+            ch.started = true;
+            ch.stream_time = 0.0;
+        }
+
+        const double t = ch.stream_time;
+
+        // Drop passed segments, always keeping the current segment start
+        while ((head + 1) % capacity != tail && ch.ring[(head + 1) % capacity].time_s <= t) {
+            head = (head + 1) % capacity;
+        }
+        ch.head.store(head, std::memory_order_release);
+
+        const Waypoint& from = ch.ring[head];
+        bool underrun = false;
+
+        if ((head + 1) % capacity != tail) {
+            setpoint = interpolate(from, ch.ring[(head + 1) % capacity], t);
+        } else if (t <= from.time_s || ch.finished.load(std::memory_order_acquire)) {
+            setpoint = from.value;
+        } else {
+            // Ran past the last waypoint: hold position (CSP) or stop (CSV)
+            underrun = true;
+            setpoint = is_position_mode(config_.mode) ? from.value : 0.0;
+        }
+
+        if (underrun) {
+            ch.underruns.fetch_add(1, std::memory_order_relaxed);
+            if (!ch.in_underrun) {
+                std::cerr << "[PDO] Stream underrun on node " << static_cast<int>(ch.node_id) <<
+                    std::endl;
+                if (underrun_callback_) {
+                    underrun_callback_(ch.node_id);
+                }
+            }
+        }
+        ch.in_underrun = underrun;
+
+        ch.stream_time += std::chrono::duration<double>(config_.period).count();
+        return true;
+    }
+
+    void MotionStreamer::emit(Channel& ch, double setpoint) {
+        target_.encode(ch.payload, to_raw(setpoint, target_.scale));
+        if (has_controlword_) {
+            controlword_.encode(ch.payload, config_.controlword);
+        }
+
+        bool sent = scheduler_
+            ? scheduler_->queue_rpdo(rpdo_.type(), ch.node_id, ch.payload, rpdo_.length())
+            : manager_.send_rpdo(rpdo_.type(), ch.node_id, ch.payload, rpdo_.length());
+
+        if (sent) {
+            ch.last_setpoint.store(setpoint, std::memory_order_relaxed);
+            ch.setpoints_sent.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void MotionStreamer::step() {
+        auto start = std::chrono::steady_clock::now();
+
+        if (last_step_.time_since_epoch().count() != 0) {
+            auto interval = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                start - last_step_);
+            auto deviation = interval - std::chrono::duration_cast<std::chrono::nanoseconds>(
+                config_.period);
+            interval_jitter_.record(static_cast<uint64_t>(std::llabs(deviation.count())));
+        }
+        last_step_ = start;
+
+        for (Channel* ch : active_) {
+            double setpoint = 0.0;
+            if (next_setpoint(*ch, setpoint)) {
+                emit(*ch, setpoint);
+            }
+        }
+
+        cycles_.fetch_add(1, std::memory_order_relaxed);
+        compute_time_.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count()));
+    }
+
+    bool MotionStreamer::feed(const can_frame& frame) {
+        if (!has_feedback_) return false;
+
+        uint8_t node_id = pdo::extract_node_id(frame.can_id & CAN_SFF_MASK);
+        Channel* ch = channel(node_id);
+        if (!ch || (frame.can_id & CAN_SFF_MASK) !=
+            pdo::calculate_cob_id(feedback_.type(), node_id)) {
+            return false;
+        }
+        if (frame.can_dlc < feedback_.length()) {
+            return false;
+        }
+
+        record_actual(*ch, static_cast<double>(actual_.decode(frame.data)) * actual_.scale,
+            config_.following_error_limit);
+        return true;
+    }
+
+    void MotionStreamer::update_actual(uint8_t node_id, double actual) {
+        if (Channel* ch = channel(node_id)) {
+            record_actual(*ch, actual, config_.following_error_limit);
+        }
+    }
+
+    void MotionStreamer::record_actual(Channel& ch, double actual, double error_limit) {
+        double error = ch.last_setpoint.load(std::memory_order_relaxed) - actual;
+        ch.last_actual.store(actual, std::memory_order_relaxed);
+        ch.following_error.store(error, std::memory_order_relaxed);
+
+        double magnitude = std::fabs(error);
+        double prev = ch.max_following_error.load(std::memory_order_relaxed);
+        while (magnitude > prev &&
+            !ch.max_following_error.compare_exchange_weak(prev, magnitude,
+            std::memory_order_relaxed)) {
+        }
+
+        if (error_limit > 0.0 && magnitude > error_limit) {
+            ch.violations.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    MotionStreamer::NodeStatistics MotionStreamer::get_statistics(uint8_t node_id) const {
+        const Channel* ch = channel(node_id);
+        if (!ch) {
+            return NodeStatistics{};
+        }
+
+        NodeStatistics stats;
+        stats.setpoints_sent = ch->setpoints_sent.load(std::memory_order_relaxed);
+        stats.underruns = ch->underruns.load(std::memory_order_relaxed);
+        stats.following_error_violations = ch->violations.load(std::memory_order_relaxed);
+        stats.buffered = ch->size();
+        stats.last_setpoint = ch->last_setpoint.load(std::memory_order_relaxed);
+        stats.last_actual = ch->last_actual.load(std::memory_order_relaxed);
+        stats.following_error = ch->following_error.load(std::memory_order_relaxed);
+        stats.max_following_error = ch->max_following_error.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    MotionStreamer::CycleStatistics MotionStreamer::get_cycle_statistics() const {
+        CycleStatistics stats;
+        stats.cycles = cycles_.load(std::memory_order_relaxed);
+        stats.interval_jitter = interval_jitter_.snapshot();
+        stats.compute_time = compute_time_.snapshot();
+        return stats;
+    }
+
+} // namespace canopen
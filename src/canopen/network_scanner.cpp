@@ -0,0 +1,277 @@
+/**
+ * @file network_scanner.cpp
+ * @brief Parallel CANopen network discovery implementation
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-21
+ */
+
+#include "canopen/network_scanner.hpp"
+#include <sys/select.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace canopen {
+
+    namespace {
+
+        constexpr uint16_t IDENTITY_INDEX = 0x1018;
+        constexpr uint8_t VENDOR_SUBINDEX = 1;
+
+        /**
+         * @brief Inventory reads, in order, after the vendor ID probe
+         */
+        struct InventoryRead {
+            uint16_t index;
+            uint8_t subindex;
+            NodeIdentity::Field field;
+        };
+
+        constexpr InventoryRead INVENTORY[] = {
+            {0x1000, 0, NodeIdentity::DEVICE_TYPE},
+            {IDENTITY_INDEX, 2, NodeIdentity::PRODUCT_CODE},
+            {IDENTITY_INDEX, 3, NodeIdentity::REVISION},
+            {IDENTITY_INDEX, 4, NodeIdentity::SERIAL_NUMBER}
+        };
+
+        constexpr uint8_t INVENTORY_SIZE = sizeof(INVENTORY) / sizeof(INVENTORY[0]);
+
+        uint32_t& field_value(NodeIdentity& node, NodeIdentity::Field field) {
+            switch (field) {
+            case NodeIdentity::DEVICE_TYPE: return node.device_type;
+            case NodeIdentity::PRODUCT_CODE: return node.product_code;
+            case NodeIdentity::REVISION: return node.revision;
+            case NodeIdentity::VENDOR_ID: return node.vendor_id;
+            case NodeIdentity::SERIAL_NUMBER: break;
+            }
+            return node.serial_number;
+        }
+
+    } // namespace
+
+    NetworkScanner::NetworkScanner(std::shared_ptr<waveshare::ICANSocket> socket) {
+        if (!socket || !socket->is_open()) {
+            throw std::runtime_error("NetworkScanner: socket must be open and valid");
+        }
+
+        send_ = [socket](const can_frame& frame) {
+                return socket->send(frame) == sizeof(frame);
+            };
+        receive_ = [socket](can_frame& frame, std::chrono::microseconds timeout) {
+                fd_set readfds;
+                FD_ZERO(&readfds);
+                FD_SET(socket->get_fd(), &readfds);
+
+                struct timeval tv;
+                tv.tv_sec = static_cast<time_t>(timeout.count() / 1000000);
+                tv.tv_usec = static_cast<suseconds_t>(timeout.count() % 1000000);
+
+                int ret = select(socket->get_fd() + 1, &readfds, nullptr, nullptr, &tv);
+                if (ret < 0 && errno != EINTR) {
+                    std::cerr << "[SCAN] select() error: " << strerror(errno) << std::endl;
+                }
+                return ret > 0 && socket->receive(frame) == sizeof(frame);
+            };
+    }
+
+    NetworkScanner::NetworkScanner(SendFunction send, ReceiveFunction receive)
+        : send_(std::move(send))
+        , receive_(std::move(receive)) {
+        if (!send_ || !receive_) {
+            throw std::invalid_argument("NetworkScanner: send and receive functions are required");
+        }
+    }
+
+// =============================================================================
+// Scan
+// =============================================================================
+
+    NetworkScanResult NetworkScanner::scan(const NetworkScanConfig& config) {
+        if (config.first_node == 0 || config.first_node > config.last_node ||
+            config.last_node > pdo::MAX_NODE_ID) {
+            throw std::invalid_argument("NetworkScanner: invalid node range " +
+                std::to_string(config.first_node) + "-" + std::to_string(config.last_node));
+        }
+
+        NetworkScanResult result;
+        ChannelTable channels{};
+        IdentityTable identities{};
+
+        const auto start = Clock::now();
+        auto next_probe_time = start;
+        unsigned next_probe = config.first_node;
+
+        while (true) {
+            auto now = Clock::now();
+
+            // Probe burst: one request per pace interval, all at once if pace is 0
+            while (next_probe <= config.last_node && now >= next_probe_time) {
+                uint8_t node_id = static_cast<uint8_t>(next_probe++);
+                request(channels[node_id], node_id, IDENTITY_INDEX, VENDOR_SUBINDEX, config,
+                    result);
+                next_probe_time += config.pace;
+                if (config.pace.count() > 0) {
+                    break;   // Let responses in between probes
+                }
+            }
+
+            // Expire requests left unanswered and find the next deadline
+            bool pending = false;
+            auto wake = now + config.response_timeout;
+            for (unsigned id = config.first_node; id <= config.last_node; ++id) {
+                Channel& channel = channels[id];
+                if (!channel.pending) {
+                    continue;
+                }
+                if (now >= channel.deadline) {
+                    channel.pending = false;
+                    if (channel.present) {
+                        ++result.timeouts;
+                        request_next(channel, static_cast<uint8_t>(id), config, result);
+                    }
+                }
+                if (channel.pending) {
+                    pending = true;
+                    wake = std::min(wake, channel.deadline);
+                }
+            }
+
+            if (next_probe > config.last_node) {
+                if (!pending) {
+                    break;
+                }
+            } else {
+                wake = std::min(wake, next_probe_time);
+            }
+
+            auto timeout = std::chrono::duration_cast<std::chrono::microseconds>(wake - now);
+            can_frame frame;
+            if (receive_(frame, std::max(timeout, std::chrono::microseconds(0)))) {
+                handle_response(frame, channels, identities, config, result);
+            }
+        }
+
+        for (unsigned id = config.first_node; id <= config.last_node; ++id) {
+            if (channels[id].present) {
+                identities[id].node_id = static_cast<uint8_t>(id);
+                result.nodes.push_back(identities[id]);
+            }
+        }
+        result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now() - start);
+
+        std::cout << "[SCAN] " << result.nodes.size() << " node(s) found in "
+                  << result.elapsed.count() / 1000.0 << " ms (" << result.requests_sent
+                  << " requests)" << std::endl;
+        return result;
+    }
+
+    bool NetworkScanner::request(Channel& channel, uint8_t node_id, uint16_t index,
+        uint8_t subindex, const NetworkScanConfig& config, NetworkScanResult& result) {
+        can_frame frame{};
+        frame.can_id = sdo::request_cob_id(node_id);
+        frame.can_dlc = 8;
+        frame.data[0] = sdo::to_byte(sdo::ClientCommand::INITIATE_UPLOAD);
+        frame.data[1] = static_cast<uint8_t>(index & 0xFF);
+        frame.data[2] = static_cast<uint8_t>(index >> 8);
+        frame.data[3] = subindex;
+
+        if (!send_(frame)) {
+            ++result.send_errors;
+            return false;
+        }
+
+        ++result.requests_sent;
+        channel.pending = true;
+        channel.index = index;
+        channel.subindex = subindex;
+        channel.sent = Clock::now();
+        channel.deadline = channel.sent + config.response_timeout;
+        return true;
+    }
+
+    void NetworkScanner::request_next(Channel& channel, uint8_t node_id,
+        const NetworkScanConfig& config, NetworkScanResult& result) {
+        if (!config.read_identity) {
+            return;
+        }
+
+        // A read the transport refuses is skipped rather than retried
+        while (channel.step < INVENTORY_SIZE) {
+            const InventoryRead& read = INVENTORY[channel.step++];
+            if (request(channel, node_id, read.index, read.subindex, config, result)) {
+                return;
+            }
+        }
+    }
+
+    void NetworkScanner::handle_response(const can_frame& frame, ChannelTable& channels,
+        IdentityTable& identities, const NetworkScanConfig& config, NetworkScanResult& result) {
+        uint32_t cob_id = frame.can_id & CAN_SFF_MASK;
+        if (frame.can_id & (CAN_EFF_FLAG | CAN_RTR_FLAG | CAN_ERR_FLAG) || frame.can_dlc < 8 ||
+            cob_id <= sdo::RESPONSE_BASE || cob_id > sdo::response_cob_id(pdo::MAX_NODE_ID)) {
+            ++result.ignored;
+            return;
+        }
+
+        uint8_t node_id = static_cast<uint8_t>(cob_id - sdo::RESPONSE_BASE);
+        Channel& channel = channels[node_id];
+        uint16_t index = static_cast<uint16_t>(frame.data[1] | (frame.data[2] << 8));
+        if (!channel.pending || index != channel.index || frame.data[3] != channel.subindex) {
+            ++result.ignored;
+            return;
+        }
+
+        channel.pending = false;
+        ++result.responses;
+
+        uint8_t command = sdo::command_of(frame.data[0]);
+        bool expedited = command == static_cast<uint8_t>(sdo::ServerCommand::INITIATE_UPLOAD) &&
+            (frame.data[0] & 0x02);
+        uint32_t value = 0;
+        if (expedited) {
+            // Size indicated: bits 3-2 count the unused bytes
+            std::size_t size = (frame.data[0] & 0x01) ? 4 - ((frame.data[0] >> 2) & 0x03) : 4;
+            for (std::size_t i = 0; i < size; ++i) {
+                value |= static_cast<uint32_t>(frame.data[4 + i]) << (8 * i);
+            }
+        } else if (command == static_cast<uint8_t>(sdo::ServerCommand::INITIATE_UPLOAD)) {
+            // Segmented answer to a 32-bit object: release the server channel
+            can_frame abort{};
+            abort.can_id = sdo::request_cob_id(node_id);
+            abort.can_dlc = 8;
+            abort.data[0] = sdo::to_byte(sdo::ClientCommand::ABORT);
+            std::memcpy(&abort.data[1], &frame.data[1], 3);
+            uint32_t code = sdo::to_value(sdo::AbortCode::LENGTH_MISMATCH);
+            for (std::size_t i = 0; i < 4; ++i) {
+                abort.data[4 + i] = static_cast<uint8_t>(code >> (8 * i));
+            }
+            send_(abort);
+        }
+
+        NodeIdentity& node = identities[node_id];
+        if (!channel.present) {
+            // Any answer to the probe, even an abort, means a node is there
+            channel.present = true;
+            node.probe_latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                Clock::now() - channel.sent);
+            if (expedited) {
+                node.vendor_id = value;
+                node.fields |= NodeIdentity::VENDOR_ID;
+            }
+        } else {
+            const InventoryRead& read = INVENTORY[channel.step - 1];
+            if (expedited) {
+                field_value(node, read.field) = value;
+                node.fields |= read.field;
+            } else {
+                ++result.aborts;
+            }
+        }
+
+        request_next(channel, node_id, config, result);
+    }
+
+} // namespace canopen
@@ -0,0 +1,320 @@
+/**
+ * @file nmt_master.cpp
+ * @brief NMT master with heartbeat consumer and node guarding implementation
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-17
+ */
+
+#include "canopen/nmt_master.hpp"
+#include <sys/select.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace canopen {
+
+    NMTMaster::NMTMaster(std::shared_ptr<waveshare::ICANSocket> socket,
+        std::chrono::milliseconds tick)
+        : socket_(std::move(socket))
+        , tick_(tick)
+        , epoch_(std::chrono::steady_clock::now()) {
+        if (!socket_ || !socket_->is_open()) {
+            throw std::runtime_error("NMTMaster: socket must be open and valid");
+        }
+        if (tick.count() <= 0) {
+            throw std::invalid_argument("NMTMaster: tick must be positive");
+        }
+
+        // Worst case: every node lost and changing state in the same tick
+        events_.reserve(2 * pdo::MAX_NODE_ID);
+        delivering_.reserve(2 * pdo::MAX_NODE_ID);
+    }
+
+    NMTMaster::~NMTMaster() {
+        stop();
+    }
+
+// =============================================================================
+// Lifecycle Management
+// =============================================================================
+
+    bool NMTMaster::start() {
+        if (running_.exchange(true)) {
+            return true;
+        }
+
+        monitor_thread_ = std::thread(&NMTMaster::monitor_loop, this);
+        std::cout << "[NMT] Master started on " << socket_->get_interface_name() << std::endl;
+        return true;
+    }
+
+    void NMTMaster::stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+
+        if (monitor_thread_.joinable()) {
+            monitor_thread_.join();
+        }
+        std::cout << "[NMT] Master stopped" << std::endl;
+    }
+
+// =============================================================================
+// NMT Commands
+// =============================================================================
+
+    bool NMTMaster::send_command(nmt::Command command, uint8_t node_id) {
+        if (node_id > pdo::MAX_NODE_ID) {
+            std::cerr << "[NMT] Invalid node ID: " << static_cast<int>(node_id) << std::endl;
+            return false;
+        }
+
+        can_frame frame{};
+        frame.can_id = nmt::NMT_COB_ID;
+        frame.can_dlc = 2;
+        frame.data[0] = static_cast<uint8_t>(command);
+        frame.data[1] = node_id;
+
+        if (socket_->send(frame) != sizeof(frame)) {
+            std::cerr << "[NMT] Failed to send " << nmt::command_to_string(command) << ": "
+                      << strerror(errno) << std::endl;
+            return false;
+        }
+
+        std::cout << "[NMT] " << nmt::command_to_string(command) << " → "
+                  << (node_id == nmt::BROADCAST ? std::string("all nodes")
+                : "node " + std::to_string(node_id)) << std::endl;
+        return true;
+    }
+
+// =============================================================================
+// Monitoring
+// =============================================================================
+
+    void NMTMaster::validate_node(uint8_t node_id) {
+        if (node_id < pdo::MIN_NODE_ID || node_id > pdo::MAX_NODE_ID) {
+            throw std::invalid_argument("NMTMaster: invalid node ID " + std::to_string(node_id));
+        }
+    }
+
+    uint64_t NMTMaster::now_ticks() const {
+        return static_cast<uint64_t>((std::chrono::steady_clock::now() - epoch_) / tick_);
+    }
+
+    void NMTMaster::monitor_heartbeat(uint8_t node_id, std::chrono::milliseconds producer_time,
+        std::chrono::milliseconds consumer_time) {
+        validate_node(node_id);
+        if (producer_time.count() <= 0) {
+            throw std::invalid_argument("NMTMaster: heartbeat period must be positive");
+        }
+        if (consumer_time.count() <= 0) {
+            consumer_time = producer_time * 3 / 2;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        Node& node = nodes_[node_id];
+        node.status.mode = MonitorMode::HEARTBEAT;
+        node.deadline_ticks = static_cast<uint64_t>((consumer_time + tick_ - std::chrono::
+            steady_clock::duration(1)) / tick_);
+        node.guard_ticks = 0;
+        node.armed = false;
+
+        // Consumer starts with the first heartbeat received
+        wheel_.cancel(deadline_timer(node_id));
+        wheel_.cancel(guard_timer(node_id));
+
+        std::cout << "[NMT] Heartbeat consumer for node " << static_cast<int>(node_id)
+                  << " (" << consumer_time.count() << " ms)" << std::endl;
+    }
+
+    void NMTMaster::monitor_heartbeat(uint8_t node_id, const ObjectDictionary& dictionary) {
+        double period_ms = dictionary.get_communication_param("heartbeat_producer_ms");
+        monitor_heartbeat(node_id, std::chrono::milliseconds(static_cast<int64_t>(period_ms)));
+    }
+
+    void NMTMaster::monitor_node_guard(uint8_t node_id, std::chrono::milliseconds guard_time,
+        uint8_t life_time_factor) {
+        validate_node(node_id);
+        if (guard_time.count() <= 0 || life_time_factor == 0) {
+            throw std::invalid_argument("NMTMaster: guard time and life time factor must be "
+                "positive");
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        Node& node = nodes_[node_id];
+        node.status.mode = MonitorMode::NODE_GUARD;
+        node.guard_ticks = static_cast<uint64_t>((guard_time + tick_ - std::chrono::
+            steady_clock::duration(1)) / tick_);
+        node.deadline_ticks = node.guard_ticks * life_time_factor;
+        node.expected_toggle = 0;
+
+        // First request on the next tick; the node must answer within its life time
+        uint64_t now = now_ticks();
+        wheel_.schedule(guard_timer(node_id), now + 1);
+        wheel_.schedule(deadline_timer(node_id), now + node.deadline_ticks);
+        node.armed = true;
+
+        std::cout << "[NMT] Node guarding for node " << static_cast<int>(node_id) << " ("
+                  << guard_time.count() << " ms × " << static_cast<int>(life_time_factor) << ")" <<
+            std::endl;
+    }
+
+    void NMTMaster::stop_monitoring(uint8_t node_id) {
+        validate_node(node_id);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        Node& node = nodes_[node_id];
+        node.status.mode = MonitorMode::NONE;
+        node.armed = false;
+        wheel_.cancel(deadline_timer(node_id));
+        wheel_.cancel(guard_timer(node_id));
+    }
+
+    NMTMaster::NodeStatus NMTMaster::get_node_status(uint8_t node_id) const {
+        if (node_id < pdo::MIN_NODE_ID || node_id > pdo::MAX_NODE_ID) {
+            return NodeStatus{};
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        return nodes_[node_id].status;
+    }
+
+// =============================================================================
+// Monitor Thread
+// =============================================================================
+
+    void NMTMaster::monitor_loop() {
+        const auto tick_us = std::chrono::duration_cast<std::chrono::microseconds>(tick_).count();
+        can_frame frame;
+
+        while (running_.load()) {
+            fd_set readfds;
+            FD_ZERO(&readfds);
+            FD_SET(socket_->get_fd(), &readfds);
+
+            // Wake at least once per tick to advance the wheel
+            struct timeval timeout;
+            timeout.tv_sec = tick_us / 1000000;
+            timeout.tv_usec = tick_us % 1000000;
+
+            int ret = select(socket_->get_fd() + 1, &readfds, nullptr, nullptr, &timeout);
+            if (ret < 0 && errno != EINTR) {
+                std::cerr << "[NMT] select() error: " << strerror(errno) << std::endl;
+            }
+
+            bool have_frame = ret > 0 && socket_->receive(frame) == sizeof(frame);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                uint64_t now = now_ticks();
+                // Expire first so a heartbeat arriving in the same tick re-arms afterwards
+                wheel_.advance(now, [this](uint32_t id, uint64_t expiry) {
+                        handle_timer(id, expiry);
+                    });
+                if (have_frame) {
+                    handle_frame(frame, now);
+                }
+                delivering_.swap(events_);
+            }
+
+            deliver_events();
+        }
+    }
+
+    void NMTMaster::handle_frame(const can_frame& frame, uint64_t now) {
+        if (frame.can_id & (CAN_EFF_FLAG | CAN_RTR_FLAG | CAN_ERR_FLAG) || frame.can_dlc < 1) {
+            return;
+        }
+
+        uint32_t cob_id = frame.can_id & CAN_SFF_MASK;
+        if (cob_id <= nmt::HEARTBEAT_BASE || cob_id > nmt::heartbeat_cob_id(pdo::MAX_NODE_ID)) {
+            return;
+        }
+
+        uint8_t node_id = static_cast<uint8_t>(cob_id - nmt::HEARTBEAT_BASE);
+        Node& node = nodes_[node_id];
+        nmt::State state = nmt::decode_state(frame.data[0]);
+
+        if (node.status.mode == MonitorMode::NODE_GUARD) {
+            if (state == nmt::State::BOOTUP) {
+                node.expected_toggle = 0;
+            } else {
+                uint8_t toggle = frame.data[0] & nmt::TOGGLE_BIT;
+                if (toggle != node.expected_toggle) {
+                    ++node.status.toggle_errors;
+                    std::cerr << "[NMT] Node guard toggle error on node " <<
+                        static_cast<int>(node_id) << std::endl;
+                }
+                node.expected_toggle = toggle ^ nmt::TOGGLE_BIT;
+            }
+        }
+
+        ++node.status.messages;
+        node.status.last_seen = std::chrono::steady_clock::now();
+        node.status.alive = true;
+        set_state(node_id, state);
+
+        if (node.status.mode != MonitorMode::NONE) {
+            wheel_.schedule(deadline_timer(node_id), now + node.deadline_ticks);
+            node.armed = true;
+        }
+    }
+
+    void NMTMaster::handle_timer(uint32_t id, uint64_t expiry) {
+        uint8_t node_id = static_cast<uint8_t>(id / 2);
+        Node& node = nodes_[node_id];
+
+        if (id == guard_timer(node_id)) {
+            send_guard_request(node_id);
+            // Anchor on the expiry, not on the wake-up, so requests do not drift
+            wheel_.schedule(id, expiry + node.guard_ticks);
+            return;
+        }
+
+        // Deadline missed: report once, re-armed by the next message
+        node.armed = false;
+        if (!node.status.alive && node.status.lost_events > 0) {
+            return;
+        }
+        node.status.alive = false;
+        ++node.status.lost_events;
+        events_.push_back(Event{node_id, true, node.status.state, nmt::State::UNKNOWN});
+        set_state(node_id, nmt::State::UNKNOWN);
+    }
+
+    void NMTMaster::set_state(uint8_t node_id, nmt::State state) {
+        nmt::State previous = nodes_[node_id].status.state;
+        if (previous == state && state != nmt::State::BOOTUP) {
+            return;
+        }
+        nodes_[node_id].status.state = state;
+        events_.push_back(Event{node_id, false, previous, state});
+    }
+
+    bool NMTMaster::send_guard_request(uint8_t node_id) {
+        can_frame frame{};
+        frame.can_id = nmt::heartbeat_cob_id(node_id) | CAN_RTR_FLAG;
+        frame.can_dlc = 1;
+        return socket_->send(frame) == sizeof(frame);
+    }
+
+    void NMTMaster::deliver_events() {
+        for (const Event& event : delivering_) {
+            try {
+                if (event.lost) {
+                    std::cerr << "[NMT] Node " << static_cast<int>(event.node_id) << " lost" <<
+                        std::endl;
+                    if (node_lost_callback_) node_lost_callback_(event.node_id);
+                } else {
+                    if (state_callback_) {
+                        state_callback_(event.node_id, event.previous, event.current);
+                    }
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "[NMT] Callback exception: " << e.what() << std::endl;
+            }
+        }
+        delivering_.clear();
+    }
+
+} // namespace canopen
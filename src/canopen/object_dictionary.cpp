@@ -14,6 +14,7 @@
 #include <stdexcept>
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 
 namespace canopen {
 
@@ -74,6 +75,27 @@ namespace canopen {
             // Store entry in the objects map
             objects_[name] = entry;
         }
+
+        // Parse optional PDO configuration
+        if (config_.contains("pdo_configuration")) {
+            for (auto& [name, pdo_json] : config_["pdo_configuration"].items()) {
+                PDOConfig pdo;
+
+                // Parse COB-ID base as hex string
+                std::string cob_str = pdo_json["cob_id"].get<std::string>();
+                pdo.cob_id_base = static_cast<uint16_t>(std::stoul(cob_str, nullptr, 16));
+
+                pdo.transmission_type = pdo_json.value("transmission_type", 254);
+                pdo.inhibit_time_us = pdo_json.value("inhibit_time_us", 0u);
+                pdo.event_timer_ms = pdo_json.value("event_timer_ms", 0);
+
+                for (const auto& object : pdo_json["objects"]) {
+                    pdo.objects.push_back(object.get<std::string>());
+                }
+
+                pdo_configs_[name] = pdo;
+            }
+        }
     }
 
     ObjectDictionary::DataType ObjectDictionary::parse_datatype(const std::string& type_str) {
@@ -114,6 +136,11 @@ namespace canopen {
         }
     }
 
+    bool ObjectDictionary::ObjectEntry::is_signed() const {
+        return datatype == DataType::INT8 || datatype == DataType::INT16 ||
+               datatype == DataType::INT32 || datatype == DataType::INT64;
+    }
+
     template<typename T>
     std::vector<uint8_t> ObjectDictionary::to_raw(T value) const {
         std::vector<uint8_t> bytes(sizeof(T));
@@ -158,6 +185,11 @@ namespace canopen {
     }
 
     std::vector<std::string> ObjectDictionary::get_pdo_objects(const std::string& pdo_name) const {
+        auto pdo_it = pdo_configs_.find(pdo_name);
+        if (pdo_it != pdo_configs_.end()) {
+            return pdo_it->second.objects;
+        }
+
         std::vector<std::string> result;
         for (const auto& [name, entry] : objects_) {
             if (entry.pdo_mapping == pdo_name) {
@@ -167,6 +199,38 @@ namespace canopen {
         return result;
     }
 
+    bool ObjectDictionary::has_pdo_config(const std::string& pdo_name) const {
+        return pdo_configs_.find(pdo_name) != pdo_configs_.end();
+    }
+
+    const ObjectDictionary::PDOConfig& ObjectDictionary::get_pdo_config(
+        const std::string& pdo_name) const {
+        auto it = pdo_configs_.find(pdo_name);
+        if (it == pdo_configs_.end()) {
+            throw std::runtime_error("PDO not configured: " + pdo_name);
+        }
+        return it->second;
+    }
+
+    std::vector<std::string> ObjectDictionary::get_object_names() const {
+        std::vector<std::string> names;
+        names.reserve(objects_.size());
+        for (const auto& [name, entry] : objects_) {
+            names.push_back(name);
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+    std::vector<std::string> ObjectDictionary::get_pdo_config_names() const {
+        std::vector<std::string> names;
+        for (const auto& [name, pdo] : pdo_configs_) {
+            names.push_back(name);
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
     double ObjectDictionary::get_motor_param(const std::string& param_name) const {
         if (!config_.contains("motor_parameters")) {
             throw std::runtime_error("No motor_parameters section in config");
@@ -180,4 +244,17 @@ namespace canopen {
         return params[param_name].get<double>();
     }
 
+    double ObjectDictionary::get_communication_param(const std::string& param_name) const {
+        if (!config_.contains("communication_parameters")) {
+            throw std::runtime_error("No communication_parameters section in config");
+        }
+
+        auto& params = config_["communication_parameters"];
+        if (!params.contains(param_name)) {
+            throw std::runtime_error("Communication parameter not found: " + param_name);
+        }
+
+        return params[param_name].get<double>();
+    }
+
 } // namespace canopen
\ No newline at end of file
@@ -0,0 +1,111 @@
+/**
+ * @file pdo_codec.cpp
+ * @brief PDO mapping codec implementation
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-12
+ */
+
+#include "canopen/pdo_codec.hpp"
+#include <iostream>
+
+namespace canopen {
+
+// =============================================================================
+// PDOMapping
+// =============================================================================
+
+    pdo::PDOType PDOMapping::parse_type(const std::string& pdo_name) {
+        if (pdo_name == "rpdo1") return pdo::PDOType::RPDO1;
+        if (pdo_name == "rpdo2") return pdo::PDOType::RPDO2;
+        if (pdo_name == "rpdo3") return pdo::PDOType::RPDO3;
+        if (pdo_name == "rpdo4") return pdo::PDOType::RPDO4;
+        if (pdo_name == "tpdo1") return pdo::PDOType::TPDO1;
+        if (pdo_name == "tpdo2") return pdo::PDOType::TPDO2;
+        if (pdo_name == "tpdo3") return pdo::PDOType::TPDO3;
+        if (pdo_name == "tpdo4") return pdo::PDOType::TPDO4;
+        throw std::runtime_error("Unknown PDO name: " + pdo_name);
+    }
+
+    PDOMapping PDOMapping::compile(const ObjectDictionary& dictionary,
+        const std::string& pdo_name) {
+        PDOMapping mapping;
+        mapping.name_ = pdo_name;
+        mapping.type_ = parse_type(pdo_name);
+
+        auto objects = dictionary.get_pdo_objects(pdo_name);
+        if (objects.size() > pdo::limits::MAX_PDO_DATA_LENGTH) {
+            throw std::runtime_error("Too many objects mapped in " + pdo_name);
+        }
+
+        std::size_t offset = 0;
+        for (const auto& object_name : objects) {
+            const auto& entry = dictionary.get_object(object_name);
+            std::size_t width = entry.size_bytes();
+
+            if (width == 0 || offset + width > pdo::limits::MAX_PDO_DATA_LENGTH) {
+                throw std::runtime_error("Mapping of " + pdo_name + " exceeds " +
+                    std::to_string(pdo::limits::MAX_PDO_DATA_LENGTH) + " bytes at " +
+                    object_name);
+            }
+
+            PDOFieldLayout& layout = mapping.fields_[mapping.count_];
+            layout.offset = static_cast<uint8_t>(offset);
+            layout.width = static_cast<uint8_t>(width);
+            layout.sign_shift = entry.is_signed() ? static_cast<uint8_t>(64 - 8 * width) : 0;
+            layout.scale = entry.scaling_factor != 0.0 ? entry.scaling_factor : 1.0;
+
+            mapping.names_[mapping.count_] = object_name;
+            mapping.count_++;
+            offset += width;
+        }
+
+        mapping.length_ = static_cast<uint8_t>(offset);
+        return mapping;
+    }
+
+    const PDOFieldLayout& PDOMapping::field(const std::string& object_name) const {
+        for (std::size_t i = 0; i < count_; ++i) {
+            if (names_[i] == object_name) {
+                return fields_[i];
+            }
+        }
+        throw std::runtime_error("Object " + object_name + " is not mapped in " + name_);
+    }
+
+    bool PDOMapping::contains(const std::string& object_name) const {
+        for (std::size_t i = 0; i < count_; ++i) {
+            if (names_[i] == object_name) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+// =============================================================================
+// PDOCodec
+// =============================================================================
+
+    PDOCodec::PDOCodec(PDOManager& manager, const ObjectDictionary& dictionary)
+        : manager_(manager) {
+        for (const auto& pdo_name : dictionary.get_pdo_config_names()) {
+            PDOMapping compiled = PDOMapping::compile(dictionary, pdo_name);
+            std::size_t slot = static_cast<std::size_t>(compiled.type()) - 1;
+
+            mappings_[slot] = std::move(compiled);
+            configured_[slot] = true;
+
+            std::cout << "[PDO] Compiled " << pdo_name << " mapping ("
+                      << mappings_[slot].field_count() << " objects, "
+                      << static_cast<int>(mappings_[slot].length()) << " bytes)" << std::endl;
+        }
+    }
+
+    const PDOMapping& PDOCodec::mapping(const std::string& pdo_name) const {
+        std::size_t slot = static_cast<std::size_t>(PDOMapping::parse_type(pdo_name)) - 1;
+        if (!configured_[slot]) {
+            throw std::runtime_error("PDO not configured: " + pdo_name);
+        }
+        return mappings_[slot];
+    }
+
+} // namespace canopen
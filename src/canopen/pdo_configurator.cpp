@@ -0,0 +1,208 @@
+/**
+ * @file pdo_configurator.cpp
+ * @brief Startup PDO remapping implementation
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-13
+ */
+
+#include "canopen/pdo_configurator.hpp"
+#include "canopen/pdo_codec.hpp"
+#include <linux/can.h>
+#include <future>
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace canopen {
+
+    PDOConfigurator::PDOConfigurator(const ObjectDictionary& dictionary)
+        : dictionary_(dictionary),
+        pdo_names_(dictionary.get_pdo_config_names()) {
+        // Validate every mapping up front so a bad config fails before touching the bus
+        for (const auto& pdo_name : pdo_names_) {
+            PDOMapping::compile(dictionary_, pdo_name);
+        }
+    }
+
+    std::vector<PDOConfigStep> PDOConfigurator::build_sequence(
+        const ObjectDictionary& dictionary,
+        const std::string& pdo_name,
+        uint8_t node_id
+    ) {
+        using namespace pdo::params;
+
+        if (node_id < pdo::MIN_NODE_ID || node_id > pdo::MAX_NODE_ID) {
+            throw std::runtime_error("Invalid node ID for PDO configuration: " +
+                std::to_string(node_id));
+        }
+
+        const auto& config = dictionary.get_pdo_config(pdo_name);
+        pdo::PDOType type = PDOMapping::parse_type(pdo_name);
+        bool is_tpdo = PDOManager::is_tpdo(type);
+
+        uint16_t comm = communication_index(type);
+        uint16_t map = mapping_index(type);
+        uint32_t cob_id = static_cast<uint32_t>(config.cob_id_base) + node_id;
+
+        if (cob_id > CAN_SFF_MASK) {
+            throw std::runtime_error("COB-ID out of range for " + pdo_name);
+        }
+
+        std::vector<PDOConfigStep> steps;
+
+        // 1. Disable PDO
+        steps.push_back({comm, SUB_COB_ID, cob_id | COB_ID_INVALID, 4, false});
+
+        // 2. Clear mapping
+        steps.push_back({map, SUB_COUNT, 0, 1, false});
+
+        // 3. Mapping entries
+        uint8_t count = 0;
+        for (const auto& object_name : dictionary.get_pdo_objects(pdo_name)) {
+            const auto& entry = dictionary.get_object(object_name);
+            uint8_t bits = static_cast<uint8_t>(entry.size_bytes() * 8);
+            ++count;
+            steps.push_back({map, count, mapping_entry(entry.index, entry.subindex, bits), 4,
+                             true});
+        }
+
+        // 4. Mapping count
+        steps.push_back({map, SUB_COUNT, count, 1, true});
+
+        // 5. Communication parameters (inhibit time and event timer exist on TPDOs only)
+        steps.push_back({comm, SUB_TRANSMISSION_TYPE, config.transmission_type, 1, true});
+        if (is_tpdo) {
+            uint32_t inhibit = config.inhibit_time_us / INHIBIT_TIME_UNIT_US;
+            if (inhibit > 0xFFFF) {
+                throw std::runtime_error("Inhibit time out of range for " + pdo_name);
+            }
+            steps.push_back({comm, SUB_INHIBIT_TIME, inhibit, 2, true});
+            steps.push_back({comm, SUB_EVENT_TIMER, config.event_timer_ms, 2, true});
+        }
+
+        // 6. Re-enable PDO
+        steps.push_back({comm, SUB_COB_ID, cob_id, 4, true});
+
+        return steps;
+    }
+
+    bool PDOConfigurator::configure_node(SDOClient& client, bool verify_result) const {
+        uint8_t node_id = client.get_node_id();
+
+        for (const auto& pdo_name : pdo_names_) {
+            std::vector<PDOConfigStep> steps;
+            try {
+                steps = build_sequence(dictionary_, pdo_name, node_id);
+            } catch (const std::exception& e) {
+                std::cerr << "[PDO] Node " << static_cast<int>(node_id) << ": " << e.what() <<
+                    std::endl;
+                return false;
+            }
+
+            if (!apply(client, steps)) {
+                std::cerr << "[PDO] Node " << static_cast<int>(node_id) << ": failed to remap "
+                          << pdo_name << std::endl;
+                return false;
+            }
+
+            if (verify_result && !verify(client, steps)) {
+                std::cerr << "[PDO] Node " << static_cast<int>(node_id) << ": verification of "
+                          << pdo_name << " failed" << std::endl;
+                return false;
+            }
+
+            std::cout << "[PDO] Node " << static_cast<int>(node_id) << ": " << pdo_name
+                      << " configured" << std::endl;
+        }
+
+        return true;
+    }
+
+    std::map<uint8_t, bool> PDOConfigurator::configure_nodes(
+        const std::vector<SDOClient*>& clients,
+        bool verify_result
+    ) const {
+        std::vector<std::pair<uint8_t, std::future<bool>>> pending;
+        pending.reserve(clients.size());
+
+        for (SDOClient* client : clients) {
+            if (client == nullptr) continue;
+            pending.emplace_back(client->get_node_id(),
+                std::async(std::launch::async, [this, client, verify_result]() {
+                    return configure_node(*client, verify_result);
+                }));
+        }
+
+        std::map<uint8_t, bool> results;
+        for (auto& [node_id, result] : pending) {
+            bool ok = false;
+            try {
+                ok = result.get();
+            } catch (const std::exception& e) {
+                std::cerr << "[PDO] Node " << static_cast<int>(node_id) << ": " << e.what() <<
+                    std::endl;
+            }
+            results[node_id] = ok;
+        }
+
+        return results;
+    }
+
+    bool PDOConfigurator::apply(SDOClient& client,
+        const std::vector<PDOConfigStep>& steps) const {
+        for (const auto& step : steps) {
+            if (!client.write_raw(step.index, step.subindex, to_bytes(step.value, step.size),
+                timeout_)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool PDOConfigurator::verify(SDOClient& client,
+        const std::vector<PDOConfigStep>& steps) const {
+        using namespace pdo::params;
+
+        for (const auto& step : steps) {
+            if (!step.verify) continue;
+
+            std::vector<uint8_t> raw;
+            try {
+                raw = client.read_raw(step.index, step.subindex, timeout_);
+            } catch (const std::exception& e) {
+                std::cerr << "[PDO] " << e.what() << std::endl;
+                return false;
+            }
+
+            uint32_t actual = 0;
+            for (std::size_t i = 0; i < raw.size() && i < step.size; ++i) {
+                actual |= static_cast<uint32_t>(raw[i]) << (8 * i);
+            }
+
+            // Devices may report bit 30 (RTR not allowed) on the COB-ID; ignore it
+            uint32_t expected = step.value;
+            bool communication = step.index < RPDO_MAPPING_BASE ||
+                (step.index >= TPDO_COMMUNICATION_BASE && step.index < TPDO_MAPPING_BASE);
+            if (communication && step.subindex == SUB_COB_ID) {
+                actual &= COB_ID_INVALID | CAN_EFF_MASK;
+            }
+
+            if (actual != expected) {
+                std::cerr << "[PDO] Verify mismatch at 0x" << std::hex << step.index << "."
+                          << static_cast<int>(step.subindex) << ": expected 0x" << expected
+                          << ", got 0x" << actual << std::dec << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<uint8_t> PDOConfigurator::to_bytes(uint32_t value, uint8_t size) {
+        std::vector<uint8_t> bytes(size);
+        for (uint8_t i = 0; i < size; ++i) {
+            bytes[i] = static_cast<uint8_t>((value >> (8 * i)) & 0xFF);
+        }
+        return bytes;
+    }
+
+} // namespace canopen
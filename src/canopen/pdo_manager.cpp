@@ -14,6 +14,7 @@
 #include <cstring>
 #include <iostream>
 #include <stdexcept>
+#include <algorithm>
 
 namespace canopen {
 
@@ -31,6 +32,11 @@ namespace canopen {
 
     PDOManager::~PDOManager() {
         stop();
+
+        // Receive thread is gone: every published callback can be released
+        for (auto& slot : tpdo_table_) {
+            delete slot.exchange(nullptr, std::memory_order_acq_rel);
+        }
     }
 
 // =============================================================================
@@ -83,21 +89,8 @@ namespace canopen {
             return false;
         }
 
-        // Construct CAN frame
-        struct can_frame frame;
-        std::memset(&frame, 0, sizeof(frame));
-        frame.can_id = rpdo1_cob_id(node_id);
-        frame.can_dlc = data.size();
-        std::memcpy(frame.data, data.data(), data.size());
-
-        bool success = send_frame(frame);
-
-        if (success) {
-            // Lock-free atomic increment
-            stats_[node_id].rpdo1_sent.fetch_add(1, std::memory_order_relaxed);
-        }
-
-        return success;
+        return send_rpdo(pdo::PDOType::RPDO1, node_id, data.data(),
+            static_cast<uint8_t>(data.size()));
     }
 
     bool PDOManager::send_rpdo2(uint8_t node_id, const std::vector<uint8_t>& data) {
@@ -106,23 +99,68 @@ namespace canopen {
             return false;
         }
 
+        return send_rpdo(pdo::PDOType::RPDO2, node_id, data.data(),
+            static_cast<uint8_t>(data.size()));
+    }
+
+    bool PDOManager::send_rpdo(pdo::PDOType type, uint8_t node_id, const uint8_t* data,
+        uint8_t length) {
+        Statistics* stats = node_stats(node_id);
+        if (!stats || !is_rpdo(type)) {
+            std::cerr << "[PDO] Invalid RPDO target: " << pdo::pdo_type_to_string(type)
+                      << " node " << static_cast<int>(node_id) << std::endl;
+            return false;
+        }
+
+        if (length > pdo::limits::MAX_PDO_DATA_LENGTH) {
+            std::cerr << "[PDO] " << pdo::pdo_type_to_string(type) << " data too large: "
+                      << static_cast<int>(length) << " bytes" << std::endl;
+            return false;
+        }
+
         // Construct CAN frame
         struct can_frame frame;
         std::memset(&frame, 0, sizeof(frame));
-        frame.can_id = rpdo2_cob_id(node_id);
-        frame.can_dlc = data.size();
-        std::memcpy(frame.data, data.data(), data.size());
+        frame.can_id = pdo::calculate_cob_id(type, node_id);
+        frame.can_dlc = length;
+        if (length > 0) {
+            std::memcpy(frame.data, data, length);
+        }
 
+        auto sent_at = std::chrono::steady_clock::now().time_since_epoch().count();
         bool success = send_frame(frame);
 
         if (success) {
+            // Start a latency measurement unless one is already outstanding
+            std::chrono::steady_clock::rep idle = 0;
+            stats->pending_request_time.compare_exchange_strong(idle, sent_at,
+                std::memory_order_relaxed);
+
             // Lock-free atomic increment
-            stats_[node_id].rpdo2_sent.fetch_add(1, std::memory_order_relaxed);
+            if (type == pdo::PDOType::RPDO1) {
+                stats->rpdo1_sent.fetch_add(1, std::memory_order_relaxed);
+            } else if (type == pdo::PDOType::RPDO2) {
+                stats->rpdo2_sent.fetch_add(1, std::memory_order_relaxed);
+            }
         }
 
         return success;
     }
 
+    bool PDOManager::send_sync() {
+        struct can_frame frame;
+        std::memset(&frame, 0, sizeof(frame));
+        frame.can_id = pdo::to_cob_base(pdo::PDOCobIDBase::SYNC);
+        frame.can_dlc = 0;
+
+        auto sent_at = std::chrono::steady_clock::now().time_since_epoch().count();
+        if (!send_frame(frame)) {
+            return false;
+        }
+        last_sync_time_.store(sent_at, std::memory_order_relaxed);
+        return true;
+    }
+
     bool PDOManager::send_frame(const can_frame& frame) {
         if (!socket_ || !socket_->is_open()) {
             std::cerr << "[PDO] Socket not open" << std::endl;
@@ -146,8 +184,10 @@ namespace canopen {
     void PDOManager::register_tpdo1_callback(uint8_t node_id, TPDOCallback callback) {
         uint32_t cob_id = tpdo1_cob_id(node_id);
 
-        std::lock_guard<std::mutex> lock(callback_mutex_);
-        tpdo_callbacks_[cob_id] = std::move(callback);
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex_);
+            publish_callback(cob_id, std::make_unique<TPDOCallback>(std::move(callback)));
+        }
 
         std::cout << "[PDO] Registered TPDO1 callback for node "
                   << static_cast<int>(node_id)
@@ -157,24 +197,90 @@ namespace canopen {
     void PDOManager::register_tpdo2_callback(uint8_t node_id, TPDOCallback callback) {
         uint32_t cob_id = tpdo2_cob_id(node_id);
 
-        std::lock_guard<std::mutex> lock(callback_mutex_);
-        tpdo_callbacks_[cob_id] = std::move(callback);
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex_);
+            publish_callback(cob_id, std::make_unique<TPDOCallback>(std::move(callback)));
+        }
 
         std::cout << "[PDO] Registered TPDO2 callback for node "
                   << static_cast<int>(node_id)
                   << " (COB-ID: 0x" << std::hex << cob_id << std::dec << ")" << std::endl;
     }
 
-    void PDOManager::unregister_callbacks(uint8_t node_id) {
-        std::lock_guard<std::mutex> lock(callback_mutex_);
+    void PDOManager::register_tpdo_callback(pdo::PDOType type, uint8_t node_id,
+        TPDOCallback callback) {
+        if (!is_tpdo(type)) {
+            throw std::invalid_argument("PDOManager: " + pdo::pdo_type_to_string(type) +
+                " is not a TPDO");
+        }
+
+        uint32_t cob_id = pdo::calculate_cob_id(type, node_id);
+
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex_);
+            publish_callback(cob_id, std::make_unique<TPDOCallback>(std::move(callback)));
+        }
+
+        std::cout << "[PDO] Registered " << pdo::pdo_type_to_string(type)
+                  << " callback for node " << static_cast<int>(node_id)
+                  << " (COB-ID: 0x" << std::hex << cob_id << std::dec << ")" << std::endl;
+    }
+
+    void PDOManager::unregister_tpdo_callback(pdo::PDOType type, uint8_t node_id) {
+        if (!is_tpdo(type)) {
+            throw std::invalid_argument("PDOManager: " + pdo::pdo_type_to_string(type) +
+                " is not a TPDO");
+        }
 
-        tpdo_callbacks_.erase(tpdo1_cob_id(node_id));
-        tpdo_callbacks_.erase(tpdo2_cob_id(node_id));
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex_);
+            publish_callback(pdo::calculate_cob_id(type, node_id), nullptr);
+        }
+
+        std::cout << "[PDO] Unregistered " << pdo::pdo_type_to_string(type)
+                  << " callback for node " << static_cast<int>(node_id) << std::endl;
+    }
+
+    void PDOManager::unregister_callbacks(uint8_t node_id) {
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex_);
+            publish_callback(tpdo1_cob_id(node_id), nullptr);
+            publish_callback(tpdo2_cob_id(node_id), nullptr);
+            publish_callback(pdo::to_cob_base(pdo::PDOCobIDBase::TPDO3) + node_id, nullptr);
+            publish_callback(pdo::to_cob_base(pdo::PDOCobIDBase::TPDO4) + node_id, nullptr);
+        }
 
         std::cout << "[PDO] Unregistered callbacks for node "
                   << static_cast<int>(node_id) << std::endl;
     }
 
+    void PDOManager::publish_callback(uint32_t cob_id,
+        std::unique_ptr<TPDOCallback> callback) {
+        // Seq-cst swap followed by seq-cst load of dispatch_seq_: if the reader
+        // is observed outside a callback, its next load sees the new pointer.
+        TPDOCallback* old = tpdo_table_[cob_id & CAN_SFF_MASK].exchange(callback.release());
+
+        if (old) {
+            retired_callbacks_.push_back({dispatch_seq_.load(), std::unique_ptr<TPDOCallback>(old)});
+        }
+
+        reclaim_retired_callbacks();
+    }
+
+    void PDOManager::reclaim_retired_callbacks() {
+        uint64_t seq = dispatch_seq_.load();
+
+        // Safe once the reader was idle at retirement (even seq) or has since
+        // left the dispatch it was in (seq moved on)
+        auto reclaimable = [seq](const RetiredCallback& retired) {
+                return (retired.dispatch_seq & 1) == 0 || retired.dispatch_seq != seq;
+            };
+
+        retired_callbacks_.erase(
+            std::remove_if(retired_callbacks_.begin(), retired_callbacks_.end(), reclaimable),
+            retired_callbacks_.end());
+    }
+
 // =============================================================================
 // Receive Loop
 // =============================================================================
@@ -229,76 +335,121 @@ namespace canopen {
     }
 
     void PDOManager::dispatch_tpdo(const can_frame& frame) {
-        uint32_t cob_id = frame.can_id;
+        // PDOs are 11-bit data frames; anything else has no dispatch slot
+        if (frame.can_id & (CAN_EFF_FLAG | CAN_RTR_FLAG | CAN_ERR_FLAG)) {
+            return;
+        }
+
+        uint32_t cob_id = frame.can_id & CAN_SFF_MASK;
 
-        // Look up callback
-        std::lock_guard<std::mutex> lock(callback_mutex_);
-        auto it = tpdo_callbacks_.find(cob_id);
+        // Enter read-side critical section (odd sequence)
+        dispatch_seq_.fetch_add(1);
+        TPDOCallback* callback = tpdo_table_[cob_id].load();
 
-        if (it != tpdo_callbacks_.end()) {
+        if (callback) {
             // Extract node ID for statistics
             uint8_t node_id = extract_node_id(cob_id);
+            Statistics* stats = node_stats(node_id);
 
-            if (node_id > 0) {
-                auto& stats = stats_[node_id];
-                auto now = std::chrono::steady_clock::now();
+            if (stats) {
+                auto now = std::chrono::steady_clock::now().time_since_epoch().count();
 
                 // Determine which TPDO type and update lock-free atomic counters
                 if (cob_id == tpdo1_cob_id(node_id)) {
-                    stats.tpdo1_received.fetch_add(1, std::memory_order_relaxed);
-                    stats.last_tpdo1_time = now;
+                    stats->tpdo1_received.fetch_add(1, std::memory_order_relaxed);
+                    stats->last_tpdo1_time.store(now, std::memory_order_relaxed);
                 } else if (cob_id == tpdo2_cob_id(node_id)) {
-                    stats.tpdo2_received.fetch_add(1, std::memory_order_relaxed);
-                    stats.last_tpdo2_time = now;
+                    stats->tpdo2_received.fetch_add(1, std::memory_order_relaxed);
+                    stats->last_tpdo2_time.store(now, std::memory_order_relaxed);
                 }
+
+                record_latency(*stats, now);
             }
 
-            // Call registered callback (outside stats lock to avoid deadlock)
+            // Call registered callback (no lock held)
             try {
-                it->second(frame);
+                (*callback)(frame);
             } catch (const std::exception& e) {
                 std::cerr << "[PDO] Callback exception: " << e.what() << std::endl;
-                if (node_id > 0) {
-                    stats_[node_id].errors.fetch_add(1, std::memory_order_relaxed);
+                if (stats) {
+                    stats->errors.fetch_add(1, std::memory_order_relaxed);
                 }
             }
         }
+
+        // Leave read-side critical section (even sequence)
+        dispatch_seq_.fetch_add(1);
     }
 
 // =============================================================================
 // Statistics & Diagnostics
 // =============================================================================
 
+    void PDOManager::record_latency(Statistics& stats, std::chrono::steady_clock::rep now) {
+        auto origin = stats.pending_request_time.exchange(0, std::memory_order_relaxed);
+        auto previous_tpdo = stats.last_tpdo_time.exchange(now, std::memory_order_relaxed);
+
+        if (origin == 0) {
+            // No RPDO outstanding: the first TPDO after a SYNC answers that SYNC
+            auto sync = last_sync_time_.load(std::memory_order_relaxed);
+            if (sync > previous_tpdo) {
+                origin = sync;
+            }
+        }
+
+        if (origin == 0 || origin > now) {
+            return;
+        }
+
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::duration(now - origin)).count();
+        stats.latency.record(static_cast<uint64_t>(ns));
+        stats.total_latency_us.fetch_add(static_cast<uint64_t>(ns) / 1000,
+            std::memory_order_relaxed);
+        stats.latency_samples.fetch_add(1, std::memory_order_relaxed);
+    }
+
     PDOManager::StatisticsSnapshot PDOManager::get_statistics(uint8_t node_id) const {
-        std::lock_guard<std::mutex> lock(stats_mutex_);
-
-        auto it = stats_.find(node_id);
-        if (it != stats_.end()) {
-            const auto& stats = it->second;
-
-            // Create non-atomic snapshot using memory_order_relaxed for performance
-            StatisticsSnapshot snapshot;
-            snapshot.tpdo1_received = stats.tpdo1_received.load(std::memory_order_relaxed);
-            snapshot.tpdo2_received = stats.tpdo2_received.load(std::memory_order_relaxed);
-            snapshot.rpdo1_sent = stats.rpdo1_sent.load(std::memory_order_relaxed);
-            snapshot.rpdo2_sent = stats.rpdo2_sent.load(std::memory_order_relaxed);
-            snapshot.errors = stats.errors.load(std::memory_order_relaxed);
-            snapshot.avg_latency_us = stats.get_avg_latency_us();
-            snapshot.last_tpdo1_time = stats.last_tpdo1_time;
-            snapshot.last_tpdo2_time = stats.last_tpdo2_time;
-
-            return snapshot;
+        const Statistics* stats = node_stats(node_id);
+        if (!stats) {
+            // Return empty stats if out of range
+            return StatisticsSnapshot{};
         }
 
-        // Return empty stats if not found
-        return StatisticsSnapshot{};
+        using Clock = std::chrono::steady_clock;
+
+        // Create non-atomic snapshot using memory_order_relaxed for performance
+        StatisticsSnapshot snapshot;
+        snapshot.tpdo1_received = stats->tpdo1_received.load(std::memory_order_relaxed);
+        snapshot.tpdo2_received = stats->tpdo2_received.load(std::memory_order_relaxed);
+        snapshot.rpdo1_sent = stats->rpdo1_sent.load(std::memory_order_relaxed);
+        snapshot.rpdo2_sent = stats->rpdo2_sent.load(std::memory_order_relaxed);
+        snapshot.errors = stats->errors.load(std::memory_order_relaxed);
+        snapshot.avg_latency_us = stats->get_avg_latency_us();
+        snapshot.latency = stats->latency.snapshot();
+        snapshot.latency_p50_us = snapshot.latency.percentile_ns(50.0) / 1000.0;
+        snapshot.latency_p90_us = snapshot.latency.percentile_ns(90.0) / 1000.0;
+        snapshot.latency_p99_us = snapshot.latency.percentile_ns(99.0) / 1000.0;
+        snapshot.latency_max_us = snapshot.latency.max_ns / 1000.0;
+        snapshot.last_tpdo1_time = Clock::time_point(
+            Clock::duration(stats->last_tpdo1_time.load(std::memory_order_relaxed)));
+        snapshot.last_tpdo2_time = Clock::time_point(
+            Clock::duration(stats->last_tpdo2_time.load(std::memory_order_relaxed)));
+
+        return snapshot;
     }
 
     void PDOManager::reset_statistics(uint8_t node_id) {
-        std::lock_guard<std::mutex> lock(stats_mutex_);
-        auto it = stats_.find(node_id);
-        if (it != stats_.end()) {
-            it->second.reset();
+        Statistics* stats = node_stats(node_id);
+        if (stats) {
+            stats->reset();
+        }
+    }
+
+    void PDOManager::record_error(uint8_t node_id) {
+        Statistics* stats = node_stats(node_id);
+        if (stats) {
+            stats->errors.fetch_add(1, std::memory_order_relaxed);
         }
     }
 
@@ -19,6 +19,7 @@
 #include <poll.h>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 
 namespace canopen {
 
@@ -54,12 +55,29 @@ namespace canopen {
         }
         std::cout << std::dec << std::endl;
 
+        return write_raw(obj.index, obj.subindex, data, timeout);
+    }
+
+    bool SDOClient::write_raw(
+        uint16_t index,
+        uint8_t subindex,
+        const std::vector<uint8_t>& data,
+        std::chrono::milliseconds timeout
+    ) {
+        if (data.empty() || data.size() > 4) {
+            std::cerr << "[SDO] Expedited write supports 1-4 bytes, got " << data.size() << "\n";
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(transfer_mutex_);
+
         // Create SDO write frame
-        can_frame frame = create_sdo_write_expedited(obj.index, obj.subindex, data);
+        can_frame frame = create_sdo_write_expedited(index, subindex, data);
 
         // Send request
         if (!send_frame(frame)) {
-            std::cerr << "[SDO] Failed to send write request for " << object_name << "\n";
+            std::cerr << "[SDO] Failed to send write request for 0x" << std::hex << index
+                      << std::dec << "." << static_cast<int>(subindex) << "\n";
             return false;
         }
 
@@ -71,8 +89,9 @@ namespace canopen {
         }
 
         // Validate response
-        if (!validate_sdo_response(response, obj.index, obj.subindex)) {
-            std::cerr << "[SDO] Invalid response for " << object_name << "\n";
+        if (!validate_sdo_response(response, index, subindex)) {
+            std::cerr << "[SDO] Invalid response for 0x" << std::hex << index
+                      << std::dec << "." << static_cast<int>(subindex) << "\n";
             return false;
         }
 
@@ -90,27 +109,44 @@ namespace canopen {
                   << " (0x" << std::hex << obj.index << std::dec << "." <<
             static_cast<int>(obj.subindex) << ")\n";
 
+        // Extract only the bytes the dictionary declares for this object
+        std::vector<uint8_t> data = read_raw(obj.index, obj.subindex, timeout);
+        data.resize(obj.size_bytes(), 0);
+        return data;
+    }
+
+    std::vector<uint8_t> SDOClient::read_raw(
+        uint16_t index,
+        uint8_t subindex,
+        std::chrono::milliseconds timeout
+    ) {
+        std::ostringstream where;
+        where << "0x" << std::hex << index << std::dec << "." << static_cast<int>(subindex);
+
+        std::lock_guard<std::mutex> lock(transfer_mutex_);
+
         // Create SDO read request
-        can_frame frame = create_sdo_read_request(obj.index, obj.subindex);
+        can_frame frame = create_sdo_read_request(index, subindex);
 
         // Send request
         if (!send_frame(frame)) {
-            throw std::runtime_error("Failed to send read request for " + object_name);
+            throw std::runtime_error("Failed to send read request for " + where.str());
         }
 
         // Wait for response
         can_frame response;
         if (!receive_frame(response, timeout)) {
-            throw std::runtime_error("Timeout reading " + object_name);
+            throw std::runtime_error("Timeout reading " + where.str());
         }
 
         // Validate and extract data
-        if (!validate_sdo_response(response, obj.index, obj.subindex)) {
-            throw std::runtime_error("Invalid response for " + object_name);
+        if (!validate_sdo_response(response, index, subindex)) {
+            throw std::runtime_error("Invalid response for " + where.str());
         }
 
-        // Extract data from response (bytes 4-7 for expedited transfer)
-        size_t data_size = obj.size_bytes();
+        // Expedited upload: bit 0 = size indicated, bits 3-2 = bytes without data
+        uint8_t cmd = response.data[0];
+        size_t data_size = (cmd & 0x01) ? 4 - ((cmd >> 2) & 0x03) : 4;
         std::vector<uint8_t> data(response.data + 4, response.data + 4 + data_size);
 
         std::cout << "[SDO] Read: ";
@@ -193,35 +229,51 @@ namespace canopen {
     }
 
     bool SDOClient::receive_frame(can_frame& frame, std::chrono::milliseconds timeout) {
-        struct pollfd pfd;
-        pfd.fd = socket_->get_fd();
-        pfd.events = POLLIN;
-
-        int poll_result = poll(&pfd, 1, timeout.count());
-
-        if (poll_result < 0) {
-            std::cerr << "[SDO] Poll error: " << strerror(errno) << "\n";
-            return false;
-        }
-
-        if (poll_result == 0) {
-            // Timeout
-            return false;
-        }
-
-        ssize_t bytes_received = socket_->receive(frame);
-        if (bytes_received != sizeof(frame)) {
-            return false;
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        // Skip unrelated traffic (PDOs, other nodes' SDOs) until our response or timeout
+        while (true) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            if (remaining.count() < 0) {
+                return false;
+            }
+
+            struct pollfd pfd;
+            pfd.fd = socket_->get_fd();
+            pfd.events = POLLIN;
+
+            int poll_result = poll(&pfd, 1, remaining.count());
+
+            if (poll_result < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "[SDO] Poll error: " << strerror(errno) << "\n";
+                return false;
+            }
+
+            if (poll_result == 0) {
+                // Timeout
+                return false;
+            }
+
+            ssize_t bytes_received = socket_->receive(frame);
+            if (bytes_received != sizeof(frame)) {
+                continue;
+            }
+
+            if (frame.can_id != sdo_rx_cob_id()) {
+                continue;
+            }
+
+            std::cout << "[SDO] RX: ID=0x" << std::hex << frame.can_id << " Data=";
+            for (int i = 0; i < frame.can_dlc; ++i) {
+                std::cout << std::setw(2) << std::setfill('0') << static_cast<int>(frame.data[i]) <<
+                    " ";
+            }
+            std::cout << std::dec << std::endl;
+
+            return true;
         }
-
-        std::cout << "[SDO] RX: ID=0x" << std::hex << frame.can_id << " Data=";
-        for (int i = 0; i < frame.can_dlc; ++i) {
-            std::cout << std::setw(2) << std::setfill('0') << static_cast<int>(frame.data[i]) <<
-                " ";
-        }
-        std::cout << std::dec << std::endl;
-
-        return true;
     }
 
     bool SDOClient::validate_sdo_response(
@@ -0,0 +1,859 @@
+/**
+ * @file sdo_server.cpp
+ * @brief SDO server implementation (expedited, segmented and block transfers)
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-19
+ */
+
+#include "canopen/sdo_server.hpp"
+#include "canopen/pdo_constants.hpp"
+#include <sys/select.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace canopen {
+
+    namespace {
+
+        using sdo::AbortCode;
+        using sdo::ClientCommand;
+        using sdo::ServerCommand;
+
+        constexpr uint16_t DEVICE_NAME_INDEX = 0x1008;  ///< Manufacturer device name
+
+        // Byte 0 flags
+        constexpr uint8_t EXPEDITED = 0x02;            ///< Initiate: e
+        constexpr uint8_t SIZE_INDICATED = 0x01;       ///< Initiate: s
+        constexpr uint8_t LAST = 0x01;                 ///< Segment: c
+        constexpr uint8_t BLOCK_CRC = 0x04;            ///< Block initiate: cc / sc
+        constexpr uint8_t BLOCK_SIZE_INDICATED = 0x02; ///< Block initiate: s
+        constexpr uint8_t SEQUENCE_MASK = 0x7F;
+
+        // Block sub-commands (cs / ss, byte 0 bits 1-0)
+        constexpr uint8_t BLOCK_INITIATE = 0;
+        constexpr uint8_t BLOCK_END = 1;
+        constexpr uint8_t BLOCK_ACK = 2;
+        constexpr uint8_t BLOCK_START = 3;
+
+        uint32_t le32(const uint8_t* data) {
+            return data[0] | (data[1] << 8) | (data[2] << 16) |
+                   (static_cast<uint32_t>(data[3]) << 24);
+        }
+
+        void put_le32(uint8_t* data, uint32_t value) {
+            for (int i = 0; i < 4; ++i) {
+                data[i] = static_cast<uint8_t>(value >> (8 * i));
+            }
+        }
+
+        SDOServer::Access parse_access(const std::string& access) {
+            if (access == "wo") return SDOServer::Access::WO;
+            if (access == "const") return SDOServer::Access::CONST;
+            if (access.rfind("rw", 0) == 0) return SDOServer::Access::RW;  // rw, rwr, rww
+            return SDOServer::Access::RO;
+        }
+
+    } // namespace
+
+    SDOServer::SDOServer(std::shared_ptr<waveshare::ICANSocket> socket,
+        const ObjectDictionary& dictionary, uint8_t node_id, std::chrono::milliseconds timeout)
+        : socket_(std::move(socket))
+        , dictionary_(dictionary)
+        , node_id_(node_id != 0 ? node_id : dictionary.get_node_id())
+        , timeout_(timeout) {
+        if (!socket_ || !socket_->is_open()) {
+            throw std::runtime_error("SDOServer: socket must be open and valid");
+        }
+        if (node_id_ < pdo::MIN_NODE_ID || node_id_ > pdo::MAX_NODE_ID) {
+            throw std::invalid_argument("SDOServer: invalid node ID " + std::to_string(node_id_));
+        }
+        load_dictionary();
+    }
+
+    SDOServer::SDOServer(Sender sender, const ObjectDictionary& dictionary, uint8_t node_id,
+        std::chrono::milliseconds timeout)
+        : sender_(std::move(sender))
+        , dictionary_(dictionary)
+        , node_id_(node_id != 0 ? node_id : dictionary.get_node_id())
+        , timeout_(timeout) {
+        if (!sender_) {
+            throw std::runtime_error("SDOServer: sender must be callable");
+        }
+        if (node_id_ < pdo::MIN_NODE_ID || node_id_ > pdo::MAX_NODE_ID) {
+            throw std::invalid_argument("SDOServer: invalid node ID " + std::to_string(node_id_));
+        }
+        load_dictionary();
+    }
+
+    SDOServer::~SDOServer() {
+        stop();
+    }
+
+    void SDOServer::load_dictionary() {
+        for (const auto& name : dictionary_.get_object_names()) {
+            const auto& object = dictionary_.get_object(name);
+            uint32_t object_key = key(object.index, object.subindex);
+            bool duplicate = std::any_of(entries_.begin(), entries_.end(),
+                    [&](const Entry& entry) { return entry.key == object_key; });
+            if (duplicate) continue;
+
+            entries_.push_back(Entry{object_key, parse_access(object.access), false,
+                                     std::vector<uint8_t>(object.size_bytes(), 0), nullptr,
+                                     nullptr});
+        }
+
+        std::string device_name = dictionary_.get_device_name();
+        if (!device_name.empty() && !std::any_of(entries_.begin(), entries_.end(),
+            [](const Entry& entry) { return entry.key == key(DEVICE_NAME_INDEX, 0); })) {
+            entries_.push_back(Entry{key(DEVICE_NAME_INDEX, 0), Access::CONST, true,
+                                     std::vector<uint8_t>(device_name.begin(), device_name.end()),
+                                     nullptr, nullptr});
+        }
+
+        rebuild_index();
+    }
+
+// =============================================================================
+// Lifecycle Management
+// =============================================================================
+
+    bool SDOServer::start() {
+        if (!socket_) {
+            return false;
+        }
+        if (running_.exchange(true)) {
+            return true;
+        }
+
+        server_thread_ = std::thread(&SDOServer::server_loop, this);
+        std::cout << "[SDO] Server for node " << static_cast<int>(node_id_) << " serving "
+                  << object_count() << " objects on " << socket_->get_interface_name()
+                  << std::endl;
+        return true;
+    }
+
+    void SDOServer::stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+
+        if (server_thread_.joinable()) {
+            server_thread_.join();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        transfer_ = TransferState{};
+    }
+
+    void SDOServer::server_loop() {
+        struct can_frame frame;
+
+        while (running_.load()) {
+            fd_set readfds;
+            FD_ZERO(&readfds);
+            FD_SET(socket_->get_fd(), &readfds);
+
+            // Wake up in time to expire a stalled transfer
+            auto wait = std::chrono::microseconds(100000);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (transfer_.type != Transfer::NONE) {
+                    auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(
+                        transfer_.deadline - std::chrono::steady_clock::now());
+                    wait = std::clamp(remaining, std::chrono::microseconds(0), wait);
+                }
+            }
+
+            struct timeval timeout;
+            timeout.tv_sec = 0;
+            timeout.tv_usec = static_cast<suseconds_t>(wait.count());
+
+            int ret = select(socket_->get_fd() + 1, &readfds, nullptr, nullptr, &timeout);
+            if (ret < 0) {
+                if (errno != EINTR) {
+                    std::cerr << "[SDO] select() error: " << strerror(errno) << std::endl;
+                }
+                continue;
+            }
+
+            if (ret > 0 && socket_->receive(frame) == sizeof(frame)) {
+                process(frame);
+            }
+            check_timeout();
+        }
+    }
+
+    void SDOServer::process(const can_frame& frame) {
+        if (frame.can_id & (CAN_EFF_FLAG | CAN_RTR_FLAG | CAN_ERR_FLAG)) {
+            return;
+        }
+        if ((frame.can_id & CAN_SFF_MASK) != sdo::request_cob_id(node_id_) || frame.can_dlc != 8) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        handle_request(frame);
+    }
+
+    void SDOServer::check_timeout() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        expire_transfer();
+    }
+
+// =============================================================================
+// Objects
+// =============================================================================
+
+    void SDOServer::add_object(uint16_t index, uint8_t subindex, Access access,
+        std::vector<uint8_t> value, bool variable_size) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (find(index, subindex) >= 0) {
+            throw std::invalid_argument("SDOServer: object already exists");
+        }
+        if (entries_.size() >= EMPTY) {
+            throw std::invalid_argument("SDOServer: too many objects");
+        }
+
+        entries_.push_back(Entry{key(index, subindex), access, variable_size, std::move(value),
+                                 nullptr, nullptr});
+        transfer_ = TransferState{};  // Entry positions change
+        rebuild_index();
+    }
+
+    bool SDOServer::has_object(uint16_t index, uint8_t subindex) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return find(index, subindex) >= 0;
+    }
+
+    std::size_t SDOServer::object_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+    std::vector<uint8_t> SDOServer::get_value(uint16_t index, uint8_t subindex) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int pos = find(index, subindex);
+        if (pos < 0) {
+            throw std::out_of_range("SDOServer: object not found");
+        }
+        return entries_[pos].data;
+    }
+
+    void SDOServer::set_value(uint16_t index, uint8_t subindex, const std::vector<uint8_t>& value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry& entry = entry_at(index, subindex);
+        if (!entry.variable_size && value.size() != entry.data.size()) {
+            throw std::invalid_argument("SDOServer: value length does not match object size");
+        }
+        entry.data = value;
+    }
+
+    void SDOServer::on_read(uint16_t index, uint8_t subindex, ReadHook hook) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entry_at(index, subindex).read_hook = std::move(hook);
+    }
+
+    void SDOServer::on_read(const std::string& name, ReadHook hook) {
+        const auto& object = dictionary_.get_object(name);
+        on_read(object.index, object.subindex, std::move(hook));
+    }
+
+    void SDOServer::on_write(uint16_t index, uint8_t subindex, WriteHook hook) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entry_at(index, subindex).write_hook = std::move(hook);
+    }
+
+    void SDOServer::on_write(const std::string& name, WriteHook hook) {
+        const auto& object = dictionary_.get_object(name);
+        on_write(object.index, object.subindex, std::move(hook));
+    }
+
+    int SDOServer::find(uint16_t index, uint8_t subindex) const {
+        uint32_t object_key = key(index, subindex);
+        uint16_t pos = table_[(object_key * multiplier_) >> shift_];
+        return (pos != EMPTY && entries_[pos].key == object_key) ? pos : -1;
+    }
+
+    SDOServer::Entry& SDOServer::entry_at(uint16_t index, uint8_t subindex) {
+        int pos = find(index, subindex);
+        if (pos < 0) {
+            throw std::out_of_range("SDOServer: object not found");
+        }
+        return entries_[pos];
+    }
+
+    void SDOServer::rebuild_index() {
+        std::sort(entries_.begin(), entries_.end(),
+            [](const Entry& a, const Entry& b) { return a.key < b.key; });
+
+        // Multiplicative hashing into a power-of-two table at most 25% full;
+        // try multipliers until no two keys share a slot, growing if needed
+        unsigned bits = 2;
+        while ((std::size_t{1} << bits) < entries_.size() * 4) ++bits;
+
+        for (;; ++bits) {
+            table_.assign(std::size_t{1} << bits, EMPTY);
+            shift_ = 32 - bits;
+
+            for (uint32_t attempt = 0; attempt < 64; ++attempt) {
+                multiplier_ = (0x9E3779B1u + attempt * 0x85EBCA6Bu) | 1u;
+                std::fill(table_.begin(), table_.end(), EMPTY);
+
+                bool perfect = true;
+                for (std::size_t i = 0; i < entries_.size() && perfect; ++i) {
+                    uint16_t& slot = table_[(entries_[i].key * multiplier_) >> shift_];
+                    perfect = slot == EMPTY;
+                    slot = static_cast<uint16_t>(i);
+                }
+                if (perfect) return;
+            }
+        }
+    }
+
+// =============================================================================
+// Protocol
+// =============================================================================
+
+    void SDOServer::handle_request(const can_frame& request) {
+        requests_.fetch_add(1, std::memory_order_relaxed);
+        uint8_t command = request.data[0];
+
+        // Block download segments carry a sequence number instead of a command
+        if (transfer_.type == Transfer::BLOCK_DOWNLOAD &&
+            command != sdo::to_byte(ClientCommand::ABORT)) {
+            block_download(request);
+            return;
+        }
+
+        switch (static_cast<ClientCommand>(sdo::command_of(command))) {
+        case ClientCommand::INITIATE_DOWNLOAD:
+            initiate_download(request);
+            break;
+        case ClientCommand::DOWNLOAD_SEGMENT:
+            download_segment(request);
+            break;
+        case ClientCommand::INITIATE_UPLOAD:
+            initiate_upload(request);
+            break;
+        case ClientCommand::UPLOAD_SEGMENT:
+            upload_segment(request);
+            break;
+        case ClientCommand::ABORT:
+            aborts_received_.fetch_add(1, std::memory_order_relaxed);
+            if (transfer_.type != Transfer::NONE) {
+                std::cerr << "[SDO] Client aborted transfer: 0x" << std::hex
+                          << le32(&request.data[4]) << std::dec << std::endl;
+            }
+            transfer_ = TransferState{};
+            break;
+        case ClientCommand::BLOCK_UPLOAD:
+            block_upload(request);
+            break;
+        case ClientCommand::BLOCK_DOWNLOAD:
+            block_download(request);
+            break;
+        default:
+            abort(request.data[1] | (request.data[2] << 8), request.data[3],
+                AbortCode::COMMAND_SPECIFIER);
+            break;
+        }
+    }
+
+    void SDOServer::initiate_download(const can_frame& request) {
+        uint8_t command = request.data[0];
+        uint16_t index = request.data[1] | (request.data[2] << 8);
+        uint8_t subindex = request.data[3];
+        transfer_ = TransferState{};  // A new initiate ends any unfinished transfer
+
+        int pos = find(index, subindex);
+        if (pos < 0) {
+            abort(index, subindex, AbortCode::NO_OBJECT);
+            return;
+        }
+        Entry& entry = entries_[pos];
+        if (!entry.writable()) {
+            abort(index, subindex, AbortCode::READ_ONLY);
+            return;
+        }
+
+        if (command & EXPEDITED) {
+            std::size_t size = sdo::EXPEDITED_MAX;
+            if (command & SIZE_INDICATED) {
+                size -= (command >> 2) & 0x03;
+            } else if (!entry.variable_size) {
+                size = entry.data.size();  // Unspecified size: the object's own
+            }
+            if (size > sdo::EXPEDITED_MAX) {
+                abort(index, subindex, AbortCode::LENGTH_MISMATCH);
+                return;
+            }
+
+            AbortCode code = store(entry, std::vector<uint8_t>(&request.data[4],
+                    &request.data[4] + size));
+            if (code != AbortCode::NONE) {
+                abort(index, subindex, code);
+                return;
+            }
+            expedited_.fetch_add(1, std::memory_order_relaxed);
+            reply(sdo::to_byte(ServerCommand::INITIATE_DOWNLOAD), index, subindex);
+            return;
+        }
+
+        transfer_.size_indicated = command & SIZE_INDICATED;
+        if (transfer_.size_indicated) {
+            transfer_.size = le32(&request.data[4]);
+            AbortCode code = check_length(entry, transfer_.size);
+            if (code != AbortCode::NONE) {
+                abort(index, subindex, code);
+                return;
+            }
+            transfer_.buffer.reserve(transfer_.size);
+        }
+
+        transfer_.type = Transfer::DOWNLOAD;
+        transfer_.entry = static_cast<std::size_t>(pos);
+        transfer_.index = index;
+        transfer_.subindex = subindex;
+        arm_timeout();
+        reply(sdo::to_byte(ServerCommand::INITIATE_DOWNLOAD), index, subindex);
+    }
+
+    void SDOServer::download_segment(const can_frame& request) {
+        uint8_t command = request.data[0];
+        if (transfer_.type != Transfer::DOWNLOAD) {
+            abort(transfer_.index, transfer_.subindex, AbortCode::COMMAND_SPECIFIER);
+            return;
+        }
+        if ((command & sdo::TOGGLE_BIT) != transfer_.toggle) {
+            abort(transfer_.index, transfer_.subindex, AbortCode::TOGGLE_BIT);
+            return;
+        }
+
+        std::size_t length = sdo::SEGMENT_SIZE - ((command >> 1) & 0x07);
+        transfer_.buffer.insert(transfer_.buffer.end(), &request.data[1],
+            &request.data[1] + length);
+        if (transfer_.size_indicated && transfer_.buffer.size() > transfer_.size) {
+            abort(transfer_.index, transfer_.subindex, AbortCode::LENGTH_TOO_HIGH);
+            return;
+        }
+
+        uint8_t response = sdo::to_byte(ServerCommand::DOWNLOAD_SEGMENT) | transfer_.toggle;
+        if (!(command & LAST)) {
+            transfer_.toggle ^= sdo::TOGGLE_BIT;
+            arm_timeout();
+            send_segment(response, nullptr, 0);
+            return;
+        }
+
+        AbortCode code = (transfer_.size_indicated && transfer_.buffer.size() != transfer_.size)
+                         ? AbortCode::LENGTH_TOO_LOW
+                         : store(entries_[transfer_.entry], transfer_.buffer);
+        if (code != AbortCode::NONE) {
+            abort(transfer_.index, transfer_.subindex, code);
+            return;
+        }
+        segmented_.fetch_add(1, std::memory_order_relaxed);
+        transfer_ = TransferState{};
+        send_segment(response, nullptr, 0);
+    }
+
+    void SDOServer::initiate_upload(const can_frame& request) {
+        uint16_t index = request.data[1] | (request.data[2] << 8);
+        uint8_t subindex = request.data[3];
+        transfer_ = TransferState{};
+
+        int pos = find(index, subindex);
+        if (pos < 0) {
+            abort(index, subindex, AbortCode::NO_OBJECT);
+            return;
+        }
+
+        std::vector<uint8_t> data;
+        AbortCode code = read_value(entries_[pos], data);
+        if (code != AbortCode::NONE) {
+            abort(index, subindex, code);
+            return;
+        }
+
+        if (!data.empty() && data.size() <= sdo::EXPEDITED_MAX) {
+            uint8_t command = sdo::to_byte(ServerCommand::INITIATE_UPLOAD) | EXPEDITED |
+                SIZE_INDICATED | static_cast<uint8_t>((sdo::EXPEDITED_MAX - data.size()) << 2);
+            expedited_.fetch_add(1, std::memory_order_relaxed);
+            reply(command, index, subindex, data.data(), data.size());
+            return;
+        }
+
+        uint8_t size[4];
+        put_le32(size, static_cast<uint32_t>(data.size()));
+        transfer_.type = Transfer::UPLOAD;
+        transfer_.entry = static_cast<std::size_t>(pos);
+        transfer_.index = index;
+        transfer_.subindex = subindex;
+        transfer_.size = data.size();
+        transfer_.buffer = std::move(data);
+        arm_timeout();
+        reply(sdo::to_byte(ServerCommand::INITIATE_UPLOAD) | SIZE_INDICATED, index, subindex,
+            size, sizeof(size));
+    }
+
+    void SDOServer::upload_segment(const can_frame& request) {
+        uint8_t command = request.data[0];
+        if (transfer_.type != Transfer::UPLOAD) {
+            abort(transfer_.index, transfer_.subindex, AbortCode::COMMAND_SPECIFIER);
+            return;
+        }
+        if ((command & sdo::TOGGLE_BIT) != transfer_.toggle) {
+            abort(transfer_.index, transfer_.subindex, AbortCode::TOGGLE_BIT);
+            return;
+        }
+
+        std::size_t length = std::min(sdo::SEGMENT_SIZE, transfer_.size - transfer_.offset);
+        bool last = transfer_.offset + length == transfer_.size;
+        uint8_t response = sdo::to_byte(ServerCommand::UPLOAD_SEGMENT) | transfer_.toggle |
+            static_cast<uint8_t>((sdo::SEGMENT_SIZE - length) << 1) | (last ? LAST : 0);
+        const uint8_t* payload = transfer_.buffer.data() + transfer_.offset;
+
+        if (last) {
+            segmented_.fetch_add(1, std::memory_order_relaxed);
+            send_segment(response, payload, length);
+            transfer_ = TransferState{};
+            return;
+        }
+        transfer_.offset += length;
+        transfer_.toggle ^= sdo::TOGGLE_BIT;
+        arm_timeout();
+        send_segment(response, payload, length);
+    }
+
+    void SDOServer::block_download(const can_frame& request) {
+        uint8_t command = request.data[0];
+
+        if (transfer_.type == Transfer::BLOCK_DOWNLOAD) {
+            uint8_t sequence = command & SEQUENCE_MASK;
+            bool last = command & sdo::LAST_SEGMENT;
+            if (sequence == 0 || sequence > transfer_.block_size) {
+                abort(transfer_.index, transfer_.subindex, AbortCode::INVALID_SEQUENCE);
+                return;
+            }
+
+            // Out-of-order segments are dropped; the acknowledge makes the
+            // client resend from the first segment missing
+            bool in_order = sequence == transfer_.sequence + 1;
+            if (in_order) {
+                transfer_.buffer.insert(transfer_.buffer.end(), &request.data[1],
+                    &request.data[1] + sdo::SEGMENT_SIZE);
+                transfer_.sequence = sequence;
+                if (transfer_.size_indicated &&
+                    transfer_.buffer.size() > transfer_.size + sdo::SEGMENT_SIZE - 1) {
+                    abort(transfer_.index, transfer_.subindex, AbortCode::LENGTH_TOO_HIGH);
+                    return;
+                }
+            }
+            arm_timeout();
+
+            if (last || sequence == transfer_.block_size) {
+                uint8_t ack[2] = {transfer_.sequence, transfer_.block_size};
+                if (last && in_order) {
+                    transfer_.type = Transfer::BLOCK_DOWNLOAD_END;
+                }
+                transfer_.sequence = 0;
+                send_segment(sdo::to_byte(ServerCommand::BLOCK_DOWNLOAD) | BLOCK_ACK, ack,
+                    sizeof(ack));
+            }
+            return;
+        }
+
+        if (transfer_.type == Transfer::BLOCK_DOWNLOAD_END) {
+            if ((command & 0x03) != BLOCK_END) {
+                abort(transfer_.index, transfer_.subindex, AbortCode::COMMAND_SPECIFIER);
+                return;
+            }
+
+            // The last segment carries 1..7 bytes, so at most 6 of them are unused
+            std::size_t unused = (command >> 2) & 0x07;
+            if (unused > 6 || unused > transfer_.buffer.size()) {
+                abort(transfer_.index, transfer_.subindex, AbortCode::LENGTH_MISMATCH);
+                return;
+            }
+            transfer_.buffer.resize(transfer_.buffer.size() - unused);
+            uint16_t crc = request.data[1] | (request.data[2] << 8);
+
+            AbortCode code = AbortCode::NONE;
+            if (transfer_.size_indicated && transfer_.buffer.size() != transfer_.size) {
+                code = AbortCode::LENGTH_MISMATCH;
+            } else if (transfer_.crc &&
+                crc != sdo::crc16(transfer_.buffer.data(), transfer_.buffer.size())) {
+                code = AbortCode::CRC_ERROR;
+            } else {
+                code = store(entries_[transfer_.entry], transfer_.buffer);
+            }
+            if (code != AbortCode::NONE) {
+                abort(transfer_.index, transfer_.subindex, code);
+                return;
+            }
+
+            block_.fetch_add(1, std::memory_order_relaxed);
+            transfer_ = TransferState{};
+            send_segment(sdo::to_byte(ServerCommand::BLOCK_DOWNLOAD) | BLOCK_END, nullptr, 0);
+            return;
+        }
+
+        // Initiate
+        uint16_t index = request.data[1] | (request.data[2] << 8);
+        uint8_t subindex = request.data[3];
+        transfer_ = TransferState{};
+        if ((command & 0x01) != BLOCK_INITIATE) {
+            abort(index, subindex, AbortCode::COMMAND_SPECIFIER);
+            return;
+        }
+
+        int pos = find(index, subindex);
+        if (pos < 0) {
+            abort(index, subindex, AbortCode::NO_OBJECT);
+            return;
+        }
+        if (!entries_[pos].writable()) {
+            abort(index, subindex, AbortCode::READ_ONLY);
+            return;
+        }
+
+        transfer_.size_indicated = command & BLOCK_SIZE_INDICATED;
+        if (transfer_.size_indicated) {
+            transfer_.size = le32(&request.data[4]);
+            AbortCode code = check_length(entries_[pos], transfer_.size);
+            if (code != AbortCode::NONE) {
+                abort(index, subindex, code);
+                return;
+            }
+            transfer_.buffer.reserve(transfer_.size + sdo::SEGMENT_SIZE);
+        }
+
+        transfer_.type = Transfer::BLOCK_DOWNLOAD;
+        transfer_.entry = static_cast<std::size_t>(pos);
+        transfer_.index = index;
+        transfer_.subindex = subindex;
+        transfer_.crc = command & BLOCK_CRC;
+        arm_timeout();
+
+        uint8_t block_size = transfer_.block_size;
+        reply(sdo::to_byte(ServerCommand::BLOCK_DOWNLOAD) | BLOCK_CRC | BLOCK_INITIATE,
+            index, subindex, &block_size, 1);
+    }
+
+    void SDOServer::block_upload(const can_frame& request) {
+        uint8_t command = request.data[0];
+
+        switch (command & 0x03) {
+        case BLOCK_INITIATE: {
+            uint16_t index = request.data[1] | (request.data[2] << 8);
+            uint8_t subindex = request.data[3];
+            uint8_t block_size = request.data[4];
+            transfer_ = TransferState{};
+
+            if (block_size == 0 || block_size > sdo::MAX_BLOCK_SIZE) {
+                abort(index, subindex, AbortCode::INVALID_BLOCK_SIZE);
+                return;
+            }
+            int pos = find(index, subindex);
+            if (pos < 0) {
+                abort(index, subindex, AbortCode::NO_OBJECT);
+                return;
+            }
+
+            std::vector<uint8_t> data;
+            AbortCode code = read_value(entries_[pos], data);
+            if (code != AbortCode::NONE) {
+                abort(index, subindex, code);
+                return;
+            }
+
+            // Protocol switch threshold (byte 5) is not used: always block mode
+            uint8_t size[4];
+            put_le32(size, static_cast<uint32_t>(data.size()));
+            transfer_.type = Transfer::BLOCK_UPLOAD_START;
+            transfer_.entry = static_cast<std::size_t>(pos);
+            transfer_.index = index;
+            transfer_.subindex = subindex;
+            transfer_.size = data.size();
+            transfer_.buffer = std::move(data);
+            transfer_.block_size = block_size;
+            transfer_.crc = command & BLOCK_CRC;
+            arm_timeout();
+            reply(sdo::to_byte(ServerCommand::BLOCK_UPLOAD) | BLOCK_CRC | BLOCK_SIZE_INDICATED,
+                index, subindex, size, sizeof(size));
+            return;
+        }
+
+        case BLOCK_START:
+            if (transfer_.type != Transfer::BLOCK_UPLOAD_START) break;
+            transfer_.type = Transfer::BLOCK_UPLOAD;
+            send_upload_block();
+            return;
+
+        case BLOCK_ACK: {
+            if (transfer_.type != Transfer::BLOCK_UPLOAD) break;
+            uint8_t acknowledged = request.data[1];
+            uint8_t block_size = request.data[2];
+            if (acknowledged > transfer_.block_sent) {
+                abort(transfer_.index, transfer_.subindex, AbortCode::INVALID_SEQUENCE);
+                return;
+            }
+            if (block_size == 0 || block_size > sdo::MAX_BLOCK_SIZE) {
+                abort(transfer_.index, transfer_.subindex, AbortCode::INVALID_BLOCK_SIZE);
+                return;
+            }
+
+            transfer_.block_size = block_size;
+            if (transfer_.final_block && acknowledged == transfer_.block_sent) {
+                std::size_t tail = transfer_.size % sdo::SEGMENT_SIZE;
+                uint8_t unused = static_cast<uint8_t>(
+                    (transfer_.size == 0) ? sdo::SEGMENT_SIZE
+                                          : (tail ? sdo::SEGMENT_SIZE - tail : 0));
+                uint16_t crc = transfer_.crc
+                               ? sdo::crc16(transfer_.buffer.data(), transfer_.buffer.size())
+                               : 0;
+                uint8_t end[2] = {static_cast<uint8_t>(crc & 0xFF), static_cast<uint8_t>(crc >> 8)};
+                transfer_.type = Transfer::BLOCK_UPLOAD_END;
+                arm_timeout();
+                send_segment(sdo::to_byte(ServerCommand::BLOCK_UPLOAD) |
+                    static_cast<uint8_t>(unused << 2) | BLOCK_END, end, sizeof(end));
+                return;
+            }
+
+            transfer_.offset += acknowledged * sdo::SEGMENT_SIZE;
+            send_upload_block();
+            return;
+        }
+
+        case BLOCK_END:
+            if (transfer_.type != Transfer::BLOCK_UPLOAD_END) break;
+            block_.fetch_add(1, std::memory_order_relaxed);
+            transfer_ = TransferState{};
+            return;
+        }
+
+        abort(transfer_.index, transfer_.subindex, AbortCode::COMMAND_SPECIFIER);
+    }
+
+    void SDOServer::send_upload_block() {
+        std::size_t position = transfer_.offset;
+        bool last = false;
+        transfer_.block_sent = 0;
+
+        while (!last && transfer_.block_sent < transfer_.block_size) {
+            std::size_t length = std::min(sdo::SEGMENT_SIZE, transfer_.size - position);
+            last = position + length >= transfer_.size;
+            uint8_t sequence = ++transfer_.block_sent;
+            send_segment(sequence | (last ? sdo::LAST_SEGMENT : 0),
+                transfer_.buffer.data() + position, length);
+            position += length;
+        }
+        transfer_.final_block = last;
+        arm_timeout();
+    }
+
+    void SDOServer::expire_transfer() {
+        if (transfer_.type == Transfer::NONE ||
+            std::chrono::steady_clock::now() < transfer_.deadline) {
+            return;
+        }
+        abort(transfer_.index, transfer_.subindex, AbortCode::TIMEOUT);
+        timeouts_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+    sdo::AbortCode SDOServer::check_length(const Entry& entry, std::size_t size) const {
+        if (entry.variable_size || size == entry.data.size()) {
+            return AbortCode::NONE;
+        }
+        return size > entry.data.size() ? AbortCode::LENGTH_TOO_HIGH : AbortCode::LENGTH_TOO_LOW;
+    }
+
+    sdo::AbortCode SDOServer::read_value(Entry& entry, std::vector<uint8_t>& data) {
+        if (!entry.readable()) {
+            return AbortCode::WRITE_ONLY;
+        }
+
+        data = entry.data;
+        if (entry.read_hook) {
+            AbortCode code = entry.read_hook(static_cast<uint16_t>(entry.key >> 8),
+                    static_cast<uint8_t>(entry.key & 0xFF), data);
+            if (code != AbortCode::NONE) return code;
+            if (check_length(entry, data.size()) != AbortCode::NONE) return AbortCode::GENERAL;
+            entry.data = data;
+        }
+        return AbortCode::NONE;
+    }
+
+    sdo::AbortCode SDOServer::store(Entry& entry, const std::vector<uint8_t>& data) {
+        AbortCode code = check_length(entry, data.size());
+        if (code == AbortCode::NONE && entry.write_hook) {
+            code = entry.write_hook(static_cast<uint16_t>(entry.key >> 8),
+                    static_cast<uint8_t>(entry.key & 0xFF), data);
+        }
+        if (code == AbortCode::NONE) {
+            entry.data = data;
+        }
+        return code;
+    }
+
+    void SDOServer::reply(uint8_t command, uint16_t index, uint8_t subindex,
+        const uint8_t* payload, std::size_t length) {
+        uint8_t data[7] = {static_cast<uint8_t>(index & 0xFF), static_cast<uint8_t>(index >> 8),
+                           subindex, 0, 0, 0, 0};
+        if (length > 0) {
+            std::memcpy(&data[3], payload, std::min<std::size_t>(length, 4));
+        }
+        send_segment(command, data, sizeof(data));
+    }
+
+    void SDOServer::send_segment(uint8_t command, const uint8_t* payload, std::size_t length) {
+        can_frame frame;
+        std::memset(&frame, 0, sizeof(frame));
+        frame.can_id = sdo::response_cob_id(node_id_);
+        frame.can_dlc = 8;
+        frame.data[0] = command;
+        if (length > 0) {
+            std::memcpy(&frame.data[1], payload, std::min(length, sdo::SEGMENT_SIZE));
+        }
+
+        bool sent = socket_ ? socket_->send(frame) == sizeof(frame) : sender_(frame);
+        if (!sent) {
+            std::cerr << "[SDO] Failed to send response: " << strerror(errno) << std::endl;
+        }
+    }
+
+    void SDOServer::abort(uint16_t index, uint8_t subindex, sdo::AbortCode code) {
+        uint8_t value[4];
+        put_le32(value, sdo::to_value(code));
+        transfer_ = TransferState{};
+        aborts_sent_.fetch_add(1, std::memory_order_relaxed);
+
+        std::cerr << "[SDO] Abort 0x" << std::hex << index << std::dec << "."
+                  << static_cast<int>(subindex) << ": " << sdo::abort_to_string(code) << std::endl;
+        reply(sdo::to_byte(ServerCommand::ABORT), index, subindex, value, sizeof(value));
+    }
+
+    void SDOServer::arm_timeout() {
+        transfer_.deadline = std::chrono::steady_clock::now() + timeout_;
+    }
+
+    SDOServer::StatisticsSnapshot SDOServer::get_statistics() const {
+        StatisticsSnapshot stats;
+        stats.requests = requests_.load(std::memory_order_relaxed);
+        stats.expedited = expedited_.load(std::memory_order_relaxed);
+        stats.segmented = segmented_.load(std::memory_order_relaxed);
+        stats.block = block_.load(std::memory_order_relaxed);
+        stats.aborts_sent = aborts_sent_.load(std::memory_order_relaxed);
+        stats.aborts_received = aborts_received_.load(std::memory_order_relaxed);
+        stats.timeouts = timeouts_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+} // namespace canopen
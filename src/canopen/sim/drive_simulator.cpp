@@ -0,0 +1,442 @@
+/**
+ * @file drive_simulator.cpp
+ * @brief Event loop simulating a fleet of CiA 402 drives implementation
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-18
+ */
+
+#include "canopen/sim/drive_simulator.hpp"
+#include "canopen/sdo_constants.hpp"
+#include <poll.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace canopen {
+    namespace sim {
+
+        namespace {
+
+            constexpr uint16_t HEARTBEAT_INDEX = 0x1017;
+
+            bool is_sync_transmission(uint8_t type) {
+                return type <= 240;
+            }
+
+            bool is_event_transmission(uint8_t type) {
+                return type == 254 || type == 255;
+            }
+
+        } // namespace
+
+        DriveSimulator::DriveSimulator(std::shared_ptr<waveshare::ICANSocket> socket,
+            const ObjectDictionary& dictionary, SimulatorConfig config)
+            : socket_(std::move(socket))
+            , profile_(dictionary)
+            , config_(config) {
+            if (!socket_ || !socket_->is_open()) {
+                throw std::runtime_error("DriveSimulator: socket must be open and valid");
+            }
+            if (config_.tick.count() <= 0) {
+                throw std::invalid_argument("DriveSimulator: tick must be positive");
+            }
+
+            routes_[nmt::NMT_COB_ID].route = Route::NMT;
+            routes_[pdo::to_cob_base(pdo::PDOCobIDBase::SYNC)].route = Route::SYNC;
+            active_.reserve(pdo::MAX_NODE_ID);
+            sdo_replies_.reserve(sdo::MAX_BLOCK_SIZE);
+        }
+
+        DriveSimulator::~DriveSimulator() {
+            stop();
+        }
+
+// =============================================================================
+// Drives
+// =============================================================================
+
+        VirtualDrive& DriveSimulator::add_drive(uint8_t node_id) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (node_id < pdo::MIN_NODE_ID || node_id > pdo::MAX_NODE_ID) {
+                throw std::invalid_argument("DriveSimulator: invalid node ID " +
+                    std::to_string(node_id));
+            }
+            if (drives_[node_id]) {
+                throw std::invalid_argument("DriveSimulator: node " + std::to_string(node_id) +
+                    " already simulated");
+            }
+
+            drives_[node_id] = std::make_unique<VirtualDrive>(profile_, node_id,
+                config_.auto_start);
+            VirtualDrive& drive = *drives_[node_id];
+            active_.push_back(&drive);
+
+            routes_[sdo::request_cob_id(node_id)] = Dispatch{Route::SDO, node_id, 0};
+            routes_[nmt::heartbeat_cob_id(node_id)] = Dispatch{Route::GUARD, node_id, 0};
+            const auto& rpdos = profile_.rpdos();
+            for (std::size_t i = 0; i < rpdos.size(); ++i) {
+                routes_[rpdos[i].cob_id_base + node_id] =
+                    Dispatch{Route::RPDO, node_id, static_cast<uint8_t>(i)};
+            }
+
+            schedule_timers(drive);
+            return drive;
+        }
+
+        void DriveSimulator::add_drives(uint8_t first, std::size_t count) {
+            if (first < pdo::MIN_NODE_ID || first + count - 1 > pdo::MAX_NODE_ID) {
+                throw std::invalid_argument("DriveSimulator: node range leaves 1-127");
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                add_drive(static_cast<uint8_t>(first + i));
+            }
+        }
+
+        std::size_t DriveSimulator::drive_count() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return active_.size();
+        }
+
+        bool DriveSimulator::with_drive(uint8_t node_id,
+            const std::function<void(VirtualDrive&)>& fn) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (node_id > pdo::MAX_NODE_ID || !drives_[node_id]) {
+                return false;
+            }
+            VirtualDrive& drive = *drives_[node_id];
+            uint16_t heartbeat = drive.heartbeat_ms();
+            fn(drive);
+            sync_heartbeat_timer(drive, drive.heartbeat_ms() != heartbeat);
+            return true;
+        }
+
+// =============================================================================
+// Lifecycle Management
+// =============================================================================
+
+        bool DriveSimulator::start() {
+            if (running_.exchange(true)) {
+                return true;
+            }
+
+            if (config_.send_bootup) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (VirtualDrive* drive : active_) {
+                    send_bootup(*drive);
+                }
+            }
+
+            loop_thread_ = std::thread(&DriveSimulator::loop, this);
+            std::cout << "[SIM] Simulating " << drive_count() << " drives on "
+                      << socket_->get_interface_name() << std::endl;
+            return true;
+        }
+
+        void DriveSimulator::stop() {
+            if (!running_.exchange(false)) {
+                return;
+            }
+
+            if (loop_thread_.joinable()) {
+                loop_thread_.join();
+            }
+            std::cout << "[SIM] Stopped" << std::endl;
+        }
+
+// =============================================================================
+// Event Loop
+// =============================================================================
+
+        void DriveSimulator::loop() {
+            using Clock = std::chrono::steady_clock;
+            const auto tick = std::chrono::duration_cast<Clock::duration>(config_.tick);
+            auto next_tick = Clock::now() + tick;
+
+            struct pollfd pfd;
+            pfd.fd = socket_->get_fd();
+            pfd.events = POLLIN;
+            can_frame frame;
+
+            while (running_.load()) {
+                auto now = Clock::now();
+                if (now < next_tick) {
+                    int wait_ms = static_cast<int>(std::chrono::duration_cast<
+                            std::chrono::milliseconds>(next_tick - now + std::chrono::
+                            microseconds(999)).count());
+                    int ret = poll(&pfd, 1, wait_ms);
+                    if (ret < 0 && errno != EINTR) {
+                        std::cerr << "[SIM] poll() error: " << strerror(errno) << std::endl;
+                        continue;
+                    }
+                    if (ret <= 0) continue;
+
+                    // Drain what is queued, one readiness check per frame so a
+                    // blocking socket never stalls the loop
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    for (std::size_t n = 0; n < config_.rx_budget; ++n) {
+                        if (socket_->receive(frame) != sizeof(frame)) break;
+                        handle_frame(frame);
+                        if (poll(&pfd, 1, 0) <= 0) break;
+                    }
+                    continue;
+                }
+
+                // Catch up on every tick that is due, in one model step
+                uint64_t due = 1 + static_cast<uint64_t>((now - next_tick) / tick);
+                next_tick += tick * due;
+
+                auto start = Clock::now();
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    handle_tick(due);
+                }
+                tick_time_.record(static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            Clock::now() - start).count()));
+                ticks_.fetch_add(due, std::memory_order_relaxed);
+            }
+        }
+
+        void DriveSimulator::handle_frame(const can_frame& frame) {
+            frames_received_.fetch_add(1, std::memory_order_relaxed);
+            if (frame.can_id & (CAN_EFF_FLAG | CAN_ERR_FLAG)) {
+                return;
+            }
+
+            const Dispatch& dispatch = routes_[frame.can_id & CAN_SFF_MASK];
+            bool rtr = frame.can_id & CAN_RTR_FLAG;
+            if (rtr != (dispatch.route == Route::GUARD)) {
+                return;  // Only node guard requests are remote frames
+            }
+
+            VirtualDrive* drive = drives_[dispatch.node_id].get();
+            can_frame reply;
+
+            switch (dispatch.route) {
+            case Route::NMT: {
+                if (frame.can_dlc < 2 || frame.data[1] > pdo::MAX_NODE_ID) return;
+                auto command = static_cast<nmt::Command>(frame.data[0]);
+                if (command != nmt::Command::START && command != nmt::Command::STOP &&
+                    command != nmt::Command::ENTER_PRE_OPERATIONAL &&
+                    command != nmt::Command::RESET_NODE &&
+                    command != nmt::Command::RESET_COMMUNICATION) {
+                    return;
+                }
+                bool reset = command == nmt::Command::RESET_NODE ||
+                    command == nmt::Command::RESET_COMMUNICATION;
+
+                for (VirtualDrive* target : active_) {
+                    if (frame.data[1] != nmt::BROADCAST && frame.data[1] != target->node_id()) {
+                        continue;
+                    }
+                    target->handle_nmt(command);
+                    if (reset) {
+                        send_bootup(*target);
+                        schedule_timers(*target);
+                    }
+                }
+                break;
+            }
+
+            case Route::SYNC:
+                handle_sync();
+                break;
+
+            case Route::SDO:
+                sdo_requests_.fetch_add(1, std::memory_order_relaxed);
+                sdo_replies_.clear();
+                drive->handle_sdo(frame, sdo_replies_);
+                for (const auto& response : sdo_replies_) {
+                    send(response);
+                }
+                if ((frame.data[0] >> 5) == 1 &&
+                    (frame.data[1] | (frame.data[2] << 8)) == HEARTBEAT_INDEX) {
+                    sync_heartbeat_timer(*drive, true);
+                }
+                break;
+
+            case Route::RPDO:
+                rpdos_received_.fetch_add(1, std::memory_order_relaxed);
+                drive->handle_rpdo(dispatch.pdo, frame);
+                break;
+
+            case Route::GUARD:
+                drive->build_guard_reply(reply);
+                send(reply);
+                break;
+
+            case Route::NONE:
+                break;
+            }
+        }
+
+        void DriveSimulator::handle_sync() {
+            syncs_received_.fetch_add(1, std::memory_order_relaxed);
+            const auto& tpdos = profile_.tpdos();
+
+            for (VirtualDrive* drive : active_) {
+                if (drive->nmt_state() != nmt::State::OPERATIONAL) continue;
+
+                for (std::size_t i = 0; i < tpdos.size(); ++i) {
+                    uint8_t type = tpdos[i].transmission_type;
+                    if (!is_sync_transmission(type)) continue;
+
+                    auto& state = drive->tpdo_state[i];
+                    if (type == 0) {
+                        // Acyclic: on the SYNC after a change
+                        can_frame frame;
+                        drive->build_tpdo(i, frame);
+                        if (!state.sent || std::memcmp(frame.data, state.last_data.data(),
+                            frame.can_dlc) != 0) {
+                            send_tpdo(*drive, i);
+                        }
+                    } else if (++state.sync_count >= type) {
+                        state.sync_count = 0;
+                        send_tpdo(*drive, i);
+                    }
+                }
+            }
+        }
+
+        void DriveSimulator::handle_tick(uint64_t ticks) {
+            double dt = std::chrono::duration<double>(config_.tick).count() *
+                static_cast<double>(ticks);
+            uint64_t target = wheel_.now() + ticks;
+            const auto& tpdos = profile_.tpdos();
+
+            for (VirtualDrive* drive : active_) {
+                sdo_replies_.clear();
+                drive->expire_sdo(sdo_replies_);
+                for (const auto& response : sdo_replies_) {
+                    send(response);
+                }
+
+                drive->step(dt);
+                if (drive->nmt_state() != nmt::State::OPERATIONAL) continue;
+
+                // Event-driven TPDOs go out on change, spaced by the inhibit time
+                for (std::size_t i = 0; i < tpdos.size(); ++i) {
+                    if (!is_event_transmission(tpdos[i].transmission_type)) continue;
+
+                    auto& state = drive->tpdo_state[i];
+                    uint64_t inhibit = (tpdos[i].inhibit_time_us * 1000ull +
+                        static_cast<uint64_t>(config_.tick.count()) * 1000 - 1) /
+                        (static_cast<uint64_t>(config_.tick.count()) * 1000);
+                    if (state.sent && target - state.last_sent_tick < inhibit) continue;
+
+                    can_frame frame;
+                    drive->build_tpdo(i, frame);
+                    if (!state.sent || std::memcmp(frame.data, state.last_data.data(),
+                        frame.can_dlc) != 0) {
+                        send_tpdo(*drive, i);
+                    }
+                }
+            }
+
+            wheel_.advance(target, [this](uint32_t id, uint64_t expiry) {
+                    handle_timer(id, expiry);
+                });
+        }
+
+        void DriveSimulator::handle_timer(uint32_t id, uint64_t expiry) {
+            uint8_t node_id = static_cast<uint8_t>(id / TIMERS_PER_NODE);
+            std::size_t slot = id % TIMERS_PER_NODE;
+            VirtualDrive* drive = drives_[node_id].get();
+            if (!drive) return;
+
+            if (slot == pdo::limits::MAX_PDOS_PER_DIRECTION) {
+                uint16_t period = drive->heartbeat_ms();
+                if (period == 0) return;
+                can_frame frame;
+                drive->build_heartbeat(frame);
+                send(frame);
+                heartbeats_sent_.fetch_add(1, std::memory_order_relaxed);
+                wheel_.schedule(id, expiry + ms_to_ticks(period));
+                return;
+            }
+
+            if (drive->nmt_state() == nmt::State::OPERATIONAL) {
+                send_tpdo(*drive, slot);
+            }
+            wheel_.schedule(id, expiry + ms_to_ticks(profile_.tpdos()[slot].event_timer_ms));
+        }
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+        void DriveSimulator::schedule_timers(VirtualDrive& drive) {
+            const auto& tpdos = profile_.tpdos();
+            for (std::size_t i = 0; i < tpdos.size(); ++i) {
+                drive.tpdo_state[i] = VirtualDrive::TPDOState{};
+                if (is_event_transmission(tpdos[i].transmission_type) &&
+                    tpdos[i].event_timer_ms > 0) {
+                    wheel_.schedule(tpdo_timer(drive.node_id(), i),
+                        wheel_.now() + ms_to_ticks(tpdos[i].event_timer_ms));
+                }
+            }
+            sync_heartbeat_timer(drive, true);
+        }
+
+        void DriveSimulator::sync_heartbeat_timer(const VirtualDrive& drive, bool restart) {
+            uint32_t id = heartbeat_timer(drive.node_id());
+            if (drive.heartbeat_ms() == 0) {
+                wheel_.cancel(id);
+            } else if (restart || !wheel_.is_scheduled(id)) {
+                wheel_.schedule(id, wheel_.now() + ms_to_ticks(drive.heartbeat_ms()));
+            }
+        }
+
+        void DriveSimulator::send_tpdo(VirtualDrive& drive, std::size_t pdo) {
+            can_frame frame;
+            drive.build_tpdo(pdo, frame);
+
+            auto& state = drive.tpdo_state[pdo];
+            std::memcpy(state.last_data.data(), frame.data, state.last_data.size());
+            state.last_sent_tick = wheel_.now();
+            state.sent = true;
+
+            send(frame);
+            tpdos_sent_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void DriveSimulator::send_bootup(const VirtualDrive& drive) {
+            can_frame frame{};
+            frame.can_id = nmt::heartbeat_cob_id(drive.node_id());
+            frame.can_dlc = 1;
+            frame.data[0] = static_cast<uint8_t>(nmt::State::BOOTUP);
+            send(frame);
+        }
+
+        void DriveSimulator::send(const can_frame& frame) {
+            if (socket_->send(frame) == sizeof(frame)) {
+                frames_sent_.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                send_errors_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        uint64_t DriveSimulator::ms_to_ticks(uint32_t ms) const {
+            uint64_t tick_us = static_cast<uint64_t>(config_.tick.count());
+            uint64_t ticks = (static_cast<uint64_t>(ms) * 1000 + tick_us - 1) / tick_us;
+            return ticks > 0 ? ticks : 1;
+        }
+
+        DriveSimulator::StatisticsSnapshot DriveSimulator::get_statistics() const {
+            StatisticsSnapshot stats;
+            stats.frames_received = frames_received_.load(std::memory_order_relaxed);
+            stats.frames_sent = frames_sent_.load(std::memory_order_relaxed);
+            stats.send_errors = send_errors_.load(std::memory_order_relaxed);
+            stats.sdo_requests = sdo_requests_.load(std::memory_order_relaxed);
+            stats.rpdos_received = rpdos_received_.load(std::memory_order_relaxed);
+            stats.syncs_received = syncs_received_.load(std::memory_order_relaxed);
+            stats.tpdos_sent = tpdos_sent_.load(std::memory_order_relaxed);
+            stats.heartbeats_sent = heartbeats_sent_.load(std::memory_order_relaxed);
+            stats.ticks = ticks_.load(std::memory_order_relaxed);
+            stats.tick_time = tick_time_.snapshot();
+            return stats;
+        }
+
+    } // namespace sim
+} // namespace canopen
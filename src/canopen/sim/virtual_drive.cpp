@@ -0,0 +1,552 @@
+/**
+ * @file virtual_drive.cpp
+ * @brief Simulated CiA 402 drive implementation
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-18
+ */
+
+#include "canopen/sim/virtual_drive.hpp"
+#include "canopen/cia402_registers.hpp"
+#include "canopen/sdo_constants.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace canopen {
+    namespace sim {
+
+        namespace {
+
+            using Reg = cia402::CIA402Register;
+            using cia402::to_index;
+
+            using sdo::AbortCode;
+
+            double ramp(double current, double target, double step) {
+                return current + std::clamp(target - current, -step, step);
+            }
+
+        } // namespace
+
+// =============================================================================
+// DriveProfile
+// =============================================================================
+
+        DriveProfile::DriveProfile(const ObjectDictionary& dictionary)
+            : dictionary_(dictionary) {
+            for (const auto& name : dictionary.get_object_names()) {
+                const auto& entry = dictionary.get_object(name);
+                add_object(entry.index, entry.subindex, static_cast<uint8_t>(entry.size_bytes()),
+                    entry.is_signed(), entry.access != "ro");
+            }
+
+            // Objects the simulation relies on, if the dictionary omits them
+            add_object(to_index(Reg::DEVICE_TYPE), 0, 4, false, false);
+            add_object(to_index(Reg::ERROR_REGISTER), 0, 1, false, false);
+            add_object(0x1017, 0, 2, false, true);  // Producer heartbeat time
+            add_object(to_index(Reg::IDENTITY_OBJECT), 0, 1, false, false);
+            for (uint8_t sub = 1; sub <= 4; ++sub) {
+                add_object(to_index(Reg::IDENTITY_OBJECT), sub, 4, false, false);
+            }
+            add_object(to_index(Reg::CONTROLWORD), 0, 2, false, true);
+            add_object(to_index(Reg::STATUSWORD), 0, 2, false, false);
+            add_object(to_index(Reg::MODES_OF_OPERATION), 0, 1, true, true);
+            add_object(to_index(Reg::MODES_OF_OPERATION_DISPLAY), 0, 1, true, false);
+            add_object(to_index(Reg::POSITION_ACTUAL), 0, 4, true, false);
+            add_object(to_index(Reg::VELOCITY_ACTUAL), 0, 4, true, false);
+            add_object(to_index(Reg::TARGET_POSITION), 0, 4, true, true);
+            add_object(to_index(Reg::TARGET_VELOCITY), 0, 4, true, true);
+            add_object(to_index(Reg::PROFILE_VELOCITY), 0, 4, false, true);
+            add_object(to_index(Reg::PROFILE_ACCELERATION), 0, 4, false, true);
+            add_object(to_index(Reg::QUICK_STOP_DECELERATION), 0, 4, false, true);
+
+            try {
+                motor_.counts_per_rev = dictionary.get_motor_param("counts_per_revolution");
+            } catch (const std::exception&) {
+                try {
+                    motor_.counts_per_rev = dictionary.get_motor_param("encoder_resolution");
+                } catch (const std::exception&) {}
+            }
+            try {
+                motor_.max_rpm = dictionary.get_motor_param("max_rpm");
+            } catch (const std::exception&) {}
+            try {
+                heartbeat_ms_ = static_cast<uint16_t>(
+                    dictionary.get_communication_param("heartbeat_producer_ms"));
+            } catch (const std::exception&) {}
+
+            for (const char* name : {"rpdo1", "rpdo2", "rpdo3", "rpdo4",
+                                     "tpdo1", "tpdo2", "tpdo3", "tpdo4"}) {
+                if (dictionary.get_pdo_objects(name).empty()) continue;
+                PDO compiled = compile_pdo(dictionary, name);
+                auto& list = name[0] == 'r' ? rpdos_ : tpdos_;
+                list.push_back(compiled);
+                add_pdo_parameters(compiled.type);
+            }
+        }
+
+        uint16_t DriveProfile::add_object(uint16_t index, uint8_t subindex, uint8_t size,
+            bool is_signed, bool writable) {
+            auto it = slots_.find(key(index, subindex));
+            if (it != slots_.end()) {
+                return it->second;
+            }
+            uint16_t slot = static_cast<uint16_t>(objects_.size());
+            objects_.push_back(Object{index, subindex, size, is_signed, writable});
+            slots_.emplace(key(index, subindex), slot);
+            return slot;
+        }
+
+        void DriveProfile::add_pdo_parameters(pdo::PDOType type) {
+            using namespace pdo::params;
+
+            uint16_t comm = communication_index(type);
+            add_object(comm, SUB_COUNT, 1, false, false);
+            add_object(comm, SUB_COB_ID, 4, false, true);
+            add_object(comm, SUB_TRANSMISSION_TYPE, 1, false, true);
+            add_object(comm, SUB_INHIBIT_TIME, 2, false, true);
+            add_object(comm, SUB_EVENT_TIMER, 2, false, true);
+
+            uint16_t map = mapping_index(type);
+            add_object(map, SUB_COUNT, 1, false, true);
+            for (uint8_t sub = 1; sub <= pdo::limits::MAX_PDO_DATA_LENGTH; ++sub) {
+                add_object(map, sub, 4, false, true);
+            }
+        }
+
+        DriveProfile::PDO DriveProfile::compile_pdo(const ObjectDictionary& dictionary,
+            const std::string& name) {
+            PDOMapping mapping = PDOMapping::compile(dictionary, name);
+
+            PDO compiled{};
+            compiled.type = mapping.type();
+            compiled.length = mapping.length();
+            for (const auto& object_name : dictionary.get_pdo_objects(name)) {
+                const auto& entry = dictionary.get_object(object_name);
+                compiled.fields[compiled.count++] = Field{mapping.field(object_name),
+                                                          slot(entry.index, entry.subindex)};
+            }
+
+            bool is_tpdo = name[0] == 't';
+            if (dictionary.has_pdo_config(name)) {
+                const auto& config = dictionary.get_pdo_config(name);
+                compiled.cob_id_base = config.cob_id_base;
+                compiled.transmission_type = config.transmission_type;
+                compiled.inhibit_time_us = config.inhibit_time_us;
+                compiled.event_timer_ms = config.event_timer_ms;
+            } else {
+                // Pre-defined connection set, TPDOs on every SYNC
+                compiled.cob_id_base = static_cast<uint16_t>(
+                    pdo::calculate_cob_id(compiled.type, 1) - 1);
+                compiled.transmission_type = is_tpdo ? 1 : 255;
+                compiled.inhibit_time_us = 0;
+                compiled.event_timer_ms = 0;
+            }
+            return compiled;
+        }
+
+// =============================================================================
+// VirtualDrive
+// =============================================================================
+
+        VirtualDrive::VirtualDrive(const DriveProfile& profile, uint8_t node_id, bool auto_start)
+            : profile_(profile)
+            , node_id_(node_id)
+            , values_(profile.object_count(), 0)
+            , nmt_state_(auto_start ? nmt::State::OPERATIONAL : nmt::State::PRE_OPERATIONAL)
+            , auto_start_(auto_start)
+            , controlword_(profile.slot(to_index(Reg::CONTROLWORD)))
+            , statusword_(profile.slot(to_index(Reg::STATUSWORD)))
+            , mode_(profile.slot(to_index(Reg::MODES_OF_OPERATION)))
+            , mode_display_(profile.slot(to_index(Reg::MODES_OF_OPERATION_DISPLAY)))
+            , position_actual_(profile.slot(to_index(Reg::POSITION_ACTUAL)))
+            , velocity_actual_(profile.slot(to_index(Reg::VELOCITY_ACTUAL)))
+            , target_position_(profile.slot(to_index(Reg::TARGET_POSITION)))
+            , target_velocity_(profile.slot(to_index(Reg::TARGET_VELOCITY)))
+            , profile_velocity_(profile.slot(to_index(Reg::PROFILE_VELOCITY)))
+            , profile_acceleration_(profile.slot(to_index(Reg::PROFILE_ACCELERATION)))
+            , quick_stop_deceleration_(profile.slot(to_index(Reg::QUICK_STOP_DECELERATION)))
+            , error_register_(profile.slot(to_index(Reg::ERROR_REGISTER)))
+            , heartbeat_(profile.slot(0x1017)) {
+            if (node_id < pdo::MIN_NODE_ID || node_id > pdo::MAX_NODE_ID) {
+                throw std::invalid_argument("VirtualDrive: invalid node ID " +
+                    std::to_string(node_id));
+            }
+            reset_objects();
+            serve_objects();
+        }
+
+        void VirtualDrive::serve_objects() {
+            sdo_ = std::make_unique<SDOServer>([this](const can_frame& frame) {
+                    if (outbox_ == nullptr) return false;
+                    outbox_->push_back(frame);
+                    return true;
+                }, profile_.dictionary(), node_id_);
+
+            // Every profile object is served from values_; the server only keeps
+            // objects the profile does not model (e.g. the device name)
+            for (std::size_t slot = 0; slot < profile_.object_count(); ++slot) {
+                const auto& object = profile_.object(slot);
+                if (object.size == 0) continue;
+                if (!sdo_->has_object(object.index, object.subindex)) {
+                    sdo_->add_object(object.index, object.subindex,
+                        object.writable ? SDOServer::Access::RW : SDOServer::Access::RO,
+                        std::vector<uint8_t>(object.size, 0), false);
+                }
+
+                sdo_->on_read(object.index, object.subindex,
+                    [this, slot](uint16_t, uint8_t, std::vector<uint8_t>& data) {
+                        uint64_t value = static_cast<uint64_t>(values_[slot]);
+                        data.resize(profile_.object(slot).size);
+                        for (std::size_t i = 0; i < data.size(); ++i) {
+                            data[i] = static_cast<uint8_t>(value >> (8 * i));
+                        }
+                        return AbortCode::NONE;
+                    });
+                sdo_->on_write(object.index, object.subindex,
+                    [this, slot](uint16_t, uint8_t, const std::vector<uint8_t>& data) {
+                        uint64_t value = 0;
+                        for (std::size_t i = 0; i < data.size() && i < 8; ++i) {
+                            value |= static_cast<uint64_t>(data[i]) << (8 * i);
+                        }
+                        write_slot(slot, static_cast<int64_t>(value));
+                        return AbortCode::NONE;
+                    });
+            }
+        }
+
+        void VirtualDrive::reset_objects() {
+            std::fill(values_.begin(), values_.end(), 0);
+            uint16_t identity = to_index(Reg::IDENTITY_OBJECT);
+            values_[profile_.slot(to_index(Reg::DEVICE_TYPE))] = DEVICE_TYPE;
+            values_[profile_.slot(identity, 0)] = 4;
+            values_[profile_.slot(identity, 1)] = VENDOR_ID;
+            values_[profile_.slot(identity, 2)] = PRODUCT_CODE;
+            values_[profile_.slot(identity, 3)] = REVISION;
+            values_[profile_.slot(identity, 4)] = node_id_;
+            values_[heartbeat_] = profile_.heartbeat_ms();
+
+            for (const auto* list : {&profile_.rpdos(), &profile_.tpdos()}) {
+                for (const auto& pdo : *list) {
+                    using namespace pdo::params;
+                    uint16_t comm = communication_index(pdo.type);
+                    uint16_t map = mapping_index(pdo.type);
+                    values_[profile_.slot(comm, SUB_COUNT)] = SUB_EVENT_TIMER;  // Highest sub-index
+                    values_[profile_.slot(comm, SUB_COB_ID)] = pdo.cob_id_base + node_id_;
+                    values_[profile_.slot(comm, SUB_TRANSMISSION_TYPE)] = pdo.transmission_type;
+                    values_[profile_.slot(comm, SUB_INHIBIT_TIME)] =
+                        pdo.inhibit_time_us / INHIBIT_TIME_UNIT_US;
+                    values_[profile_.slot(comm, SUB_EVENT_TIMER)] = pdo.event_timer_ms;
+                    values_[profile_.slot(map, SUB_COUNT)] = static_cast<int64_t>(pdo.count);
+                    for (std::size_t i = 0; i < pdo.count; ++i) {
+                        const auto& object = profile_.object(pdo.fields[i].slot);
+                        values_[profile_.slot(map, static_cast<uint8_t>(i + 1))] = mapping_entry(
+                            object.index, object.subindex, static_cast<uint8_t>(object.size * 8));
+                    }
+                }
+            }
+
+            state_ = cia402::State::SWITCH_ON_DISABLED;
+            last_controlword_ = 0;
+            position_ = 0.0;
+            velocity_ = 0.0;
+            target_reached_ = true;
+            update_statusword();
+        }
+
+// =============================================================================
+// Protocol
+// =============================================================================
+
+        void VirtualDrive::handle_sdo(const can_frame& request, std::vector<can_frame>& replies) {
+            outbox_ = &replies;
+            sdo_->process(request);
+            outbox_ = nullptr;
+        }
+
+        void VirtualDrive::expire_sdo(std::vector<can_frame>& replies) {
+            outbox_ = &replies;
+            sdo_->check_timeout();
+            outbox_ = nullptr;
+        }
+
+        void VirtualDrive::handle_rpdo(std::size_t pdo, const can_frame& frame) {
+            if (nmt_state_ != nmt::State::OPERATIONAL) return;
+
+            const auto& compiled = profile_.rpdos()[pdo];
+            if (frame.can_dlc < compiled.length) return;  // Length error: ignored
+
+            for (std::size_t i = 0; i < compiled.count; ++i) {
+                write_slot(compiled.fields[i].slot, compiled.fields[i].layout.decode(frame.data));
+            }
+        }
+
+        void VirtualDrive::handle_nmt(nmt::Command command) {
+            switch (command) {
+            case nmt::Command::START:
+                nmt_state_ = nmt::State::OPERATIONAL;
+                break;
+            case nmt::Command::STOP:
+                nmt_state_ = nmt::State::STOPPED;
+                break;
+            case nmt::Command::ENTER_PRE_OPERATIONAL:
+                nmt_state_ = nmt::State::PRE_OPERATIONAL;
+                break;
+            case nmt::Command::RESET_NODE:
+                reset_objects();
+                guard_toggle_ = 0;
+                nmt_state_ = auto_start_ ? nmt::State::OPERATIONAL : nmt::State::PRE_OPERATIONAL;
+                break;
+            case nmt::Command::RESET_COMMUNICATION:
+                guard_toggle_ = 0;
+                nmt_state_ = auto_start_ ? nmt::State::OPERATIONAL : nmt::State::PRE_OPERATIONAL;
+                break;
+            }
+        }
+
+        void VirtualDrive::build_tpdo(std::size_t pdo, can_frame& frame) const {
+            const auto& compiled = profile_.tpdos()[pdo];
+            std::memset(&frame, 0, sizeof(frame));
+            frame.can_id = compiled.cob_id_base + node_id_;
+            frame.can_dlc = compiled.length;
+            for (std::size_t i = 0; i < compiled.count; ++i) {
+                compiled.fields[i].layout.encode(frame.data, values_[compiled.fields[i].slot]);
+            }
+        }
+
+        void VirtualDrive::build_heartbeat(can_frame& frame) const {
+            std::memset(&frame, 0, sizeof(frame));
+            frame.can_id = nmt::heartbeat_cob_id(node_id_);
+            frame.can_dlc = 1;
+            frame.data[0] = static_cast<uint8_t>(nmt_state_);
+        }
+
+        void VirtualDrive::build_guard_reply(can_frame& frame) {
+            build_heartbeat(frame);
+            frame.data[0] |= guard_toggle_;
+            guard_toggle_ ^= nmt::TOGGLE_BIT;
+        }
+
+// =============================================================================
+// CiA 402 State Machine
+// =============================================================================
+
+        void VirtualDrive::apply_controlword(uint16_t controlword) {
+            using S = cia402::State;
+            bool fault_reset = (controlword & 0x0080) && !(last_controlword_ & 0x0080);
+            bool disable_voltage = (controlword & 0x0082) == 0x0000;
+            bool quick_stop = (controlword & 0x0086) == 0x0002;
+            bool shutdown = (controlword & 0x0087) == 0x0006;
+            bool switch_on = (controlword & 0x008F) == 0x0007;
+            bool enable = (controlword & 0x008F) == 0x000F;
+            last_controlword_ = controlword;
+
+            switch (state_) {
+            case S::FAULT:
+                if (fault_reset) {
+                    state_ = S::SWITCH_ON_DISABLED;
+                    values_[error_register_] = 0;
+                }
+                break;
+            case S::NOT_READY_TO_SWITCH_ON:
+            case S::SWITCH_ON_DISABLED:
+                if (shutdown) state_ = S::READY_TO_SWITCH_ON;
+                break;
+            case S::READY_TO_SWITCH_ON:
+                if (disable_voltage || quick_stop) state_ = S::SWITCH_ON_DISABLED;
+                else if (enable) state_ = S::OPERATION_ENABLED;  // Transitions 3 + 4
+                else if (switch_on) state_ = S::SWITCHED_ON;
+                break;
+            case S::SWITCHED_ON:
+                if (disable_voltage || quick_stop) state_ = S::SWITCH_ON_DISABLED;
+                else if (enable) state_ = S::OPERATION_ENABLED;
+                else if (shutdown) state_ = S::READY_TO_SWITCH_ON;
+                break;
+            case S::OPERATION_ENABLED:
+                if (disable_voltage) state_ = S::SWITCH_ON_DISABLED;
+                else if (quick_stop) state_ = S::QUICK_STOP_ACTIVE;
+                else if (switch_on) state_ = S::SWITCHED_ON;
+                else if (shutdown) state_ = S::READY_TO_SWITCH_ON;
+                break;
+            case S::QUICK_STOP_ACTIVE:
+                if (disable_voltage) state_ = S::SWITCH_ON_DISABLED;
+                else if (enable) state_ = S::OPERATION_ENABLED;
+                break;
+            default:
+                break;
+            }
+
+            if (state_ != S::OPERATION_ENABLED && state_ != S::QUICK_STOP_ACTIVE) {
+                velocity_ = 0.0;  // Power stage off: no coasting model
+            }
+            update_statusword();
+        }
+
+        void VirtualDrive::update_statusword() {
+            using S = cia402::State;
+            using cia402::StatuswordPattern;
+            using cia402::StatuswordBit;
+
+            StatuswordPattern pattern;
+            switch (state_) {
+            case S::READY_TO_SWITCH_ON: pattern = StatuswordPattern::READY_TO_SWITCH_ON; break;
+            case S::SWITCHED_ON: pattern = StatuswordPattern::SWITCHED_ON; break;
+            case S::OPERATION_ENABLED: pattern = StatuswordPattern::OPERATION_ENABLED; break;
+            case S::QUICK_STOP_ACTIVE: pattern = StatuswordPattern::QUICK_STOP_ACTIVE; break;
+            case S::FAULT_REACTION_ACTIVE:
+                pattern = StatuswordPattern::FAULT_REACTION_ACTIVE;
+                break;
+            case S::FAULT: pattern = StatuswordPattern::FAULT; break;
+            case S::NOT_READY_TO_SWITCH_ON:
+                pattern = StatuswordPattern::NOT_READY_TO_SWITCH_ON;
+                break;
+            default: pattern = StatuswordPattern::SWITCH_ON_DISABLED; break;
+            }
+
+            uint16_t statusword = cia402::to_pattern(pattern) | cia402::to_mask(StatuswordBit::REMOTE);
+            if (state_ == S::SWITCHED_ON || state_ == S::OPERATION_ENABLED ||
+                state_ == S::QUICK_STOP_ACTIVE) {
+                statusword |= cia402::to_mask(StatuswordBit::VOLTAGE_ENABLED);
+            }
+            if (target_reached_) {
+                statusword |= cia402::to_mask(StatuswordBit::TARGET_REACHED);
+            }
+            values_[statusword_] = statusword;
+        }
+
+        void VirtualDrive::inject_fault() {
+            state_ = cia402::State::FAULT;
+            values_[error_register_] |= cia402::to_mask(cia402::ErrorRegisterBit::GENERIC);
+            velocity_ = 0.0;
+            update_statusword();
+        }
+
+// =============================================================================
+// Motor Model
+// =============================================================================
+
+        void VirtualDrive::step(double dt) {
+            using Mode = cia402::OperationMode;
+            const MotorModel& motor = profile_.motor();
+            if (dt <= 0.0) return;
+
+            double acceleration = values_[profile_acceleration_] > 0
+                ? static_cast<double>(values_[profile_acceleration_]) : motor.acceleration_rpm_s;
+            double counts_per_rpm_s = motor.counts_per_rev / 60.0;  // counts/s at 1 rpm
+            bool reached = std::abs(velocity_) < 1.0;
+
+            if (state_ == cia402::State::OPERATION_ENABLED) {
+                auto mode = static_cast<Mode>(values_[mode_display_]);
+                double target_velocity = std::clamp(static_cast<double>(values_[target_velocity_]),
+                    -motor.max_rpm, motor.max_rpm);
+
+                switch (mode) {
+                case Mode::PROFILE_VELOCITY:
+                case Mode::VELOCITY:
+                    velocity_ = ramp(velocity_, target_velocity, acceleration * dt);
+                    position_ += velocity_ * counts_per_rpm_s * dt;
+                    reached = std::abs(velocity_ - target_velocity) < 1.0;
+                    break;
+
+                case Mode::CYCLIC_SYNC_VELOCITY:
+                    velocity_ = target_velocity;
+                    position_ += velocity_ * counts_per_rpm_s * dt;
+                    reached = true;
+                    break;
+
+                case Mode::CYCLIC_SYNC_POSITION: {
+                    double target = static_cast<double>(values_[target_position_]);
+                    velocity_ = (target - position_) / (counts_per_rpm_s * dt);
+                    position_ = target;
+                    reached = true;
+                    break;
+                }
+
+                case Mode::PROFILE_POSITION: {
+                    double error = static_cast<double>(values_[target_position_]) - position_;
+                    double limit = values_[profile_velocity_] > 0
+                        ? std::min(static_cast<double>(values_[profile_velocity_]), motor.max_rpm)
+                        : motor.max_rpm;
+                    // Fastest speed that can still stop at the target
+                    double braking = std::sqrt(2.0 * acceleration / 60.0 *
+                        std::abs(error) / motor.counts_per_rev) * 60.0;
+                    double desired = std::copysign(std::min(limit, braking), error);
+                    velocity_ = ramp(velocity_, desired, acceleration * dt);
+
+                    double moved = velocity_ * counts_per_rpm_s * dt;
+                    if (std::abs(error) < 0.5 || std::abs(moved) >= std::abs(error)) {
+                        position_ = static_cast<double>(values_[target_position_]);
+                        velocity_ = 0.0;
+                        reached = true;
+                    } else {
+                        position_ += moved;
+                        reached = false;
+                    }
+                    break;
+                }
+
+                default:
+                    velocity_ = ramp(velocity_, 0.0, acceleration * dt);
+                    position_ += velocity_ * counts_per_rpm_s * dt;
+                    break;
+                }
+            } else if (state_ == cia402::State::QUICK_STOP_ACTIVE) {
+                double deceleration = values_[quick_stop_deceleration_] > 0
+                    ? static_cast<double>(values_[quick_stop_deceleration_])
+                    : motor.quick_stop_rpm_s;
+                velocity_ = ramp(velocity_, 0.0, deceleration * dt);
+                position_ += velocity_ * counts_per_rpm_s * dt;
+                reached = std::abs(velocity_) < 1.0;
+            }
+
+            write_slot(position_actual_, std::llround(position_));
+            write_slot(velocity_actual_, std::llround(velocity_));
+            if (reached != target_reached_) {
+                target_reached_ = reached;
+                update_statusword();
+            }
+        }
+
+// =============================================================================
+// Object Access
+// =============================================================================
+
+        int64_t VirtualDrive::get(uint16_t index, uint8_t subindex) const {
+            int slot = profile_.find(index, subindex);
+            if (slot == DriveProfile::NOT_FOUND) {
+                throw std::out_of_range("VirtualDrive: no object " + std::to_string(index) + "/" +
+                    std::to_string(subindex));
+            }
+            return values_[slot];
+        }
+
+        void VirtualDrive::set(uint16_t index, uint8_t subindex, int64_t value) {
+            int slot = profile_.find(index, subindex);
+            if (slot == DriveProfile::NOT_FOUND) {
+                throw std::out_of_range("VirtualDrive: no object " + std::to_string(index) + "/" +
+                    std::to_string(subindex));
+            }
+            write_slot(slot, value);
+        }
+
+        void VirtualDrive::write_slot(std::size_t slot, int64_t value) {
+            const auto& object = profile_.object(slot);
+            if (object.size < 8) {
+                unsigned shift = 64 - 8u * object.size;
+                uint64_t raw = static_cast<uint64_t>(value) << shift;
+                value = object.is_signed ? static_cast<int64_t>(raw) >> shift
+                    : static_cast<int64_t>(raw >> shift);
+            }
+            values_[slot] = value;
+
+            // Write hooks
+            if (slot == controlword_) {
+                apply_controlword(static_cast<uint16_t>(value));
+            } else if (slot == mode_) {
+                values_[mode_display_] = value;
+            }
+        }
+
+    } // namespace sim
+} // namespace canopen
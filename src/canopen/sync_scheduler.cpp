@@ -0,0 +1,219 @@
+/**
+ * @file sync_scheduler.cpp
+ * @brief Cyclic SYNC producer and RPDO scheduler implementation
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-14
+ */
+
+#include "canopen/sync_scheduler.hpp"
+#include <ctime>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace canopen {
+
+    namespace {
+        constexpr int64_t NSEC_PER_SEC = 1'000'000'000;
+
+        int64_t now_ns() {
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return static_cast<int64_t>(ts.tv_sec) * NSEC_PER_SEC + ts.tv_nsec;
+        }
+
+        struct timespec to_timespec(int64_t ns) {
+            struct timespec ts;
+            ts.tv_sec = static_cast<time_t>(ns / NSEC_PER_SEC);
+            ts.tv_nsec = static_cast<long>(ns % NSEC_PER_SEC);
+            return ts;
+        }
+
+        /**
+         * @brief Sleep until an absolute CLOCK_MONOTONIC time (restarts on EINTR)
+         */
+        void sleep_until_ns(int64_t deadline_ns) {
+            struct timespec ts = to_timespec(deadline_ns);
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+            }
+        }
+    }
+
+    SyncScheduler::SyncScheduler(PDOManager& manager, SyncSchedulerConfig config)
+        : manager_(manager), config_(config) {
+        if (config_.period < std::chrono::milliseconds(pdo::limits::MIN_CYCLE_MS)) {
+            throw std::invalid_argument("SyncScheduler: period below MIN_CYCLE_MS");
+        }
+        if (config_.spin.count() < 0 || config_.spin >= config_.period) {
+            throw std::invalid_argument("SyncScheduler: spin window must be in [0, period)");
+        }
+        if (config_.miss_threshold.count() <= 0) {
+            config_.miss_threshold = config_.period / 4;
+        }
+
+        // One slot per RPDO and node is the worst case
+        pending_.reserve(pdo::limits::MAX_PDOS_PER_DIRECTION * pdo::MAX_NODE_ID);
+        burst_.reserve(pdo::limits::MAX_PDOS_PER_DIRECTION * pdo::MAX_NODE_ID);
+    }
+
+    SyncScheduler::~SyncScheduler() {
+        stop();
+    }
+
+    bool SyncScheduler::start() {
+        if (running_.exchange(true)) {
+            return false;
+        }
+
+        cycle_thread_ = std::thread(&SyncScheduler::cycle_loop, this);
+
+        std::cout << "[PDO] SYNC scheduler started (period "
+                  << config_.period.count() << " us, spin " << config_.spin.count()
+                  << " us)" << std::endl;
+        return true;
+    }
+
+    void SyncScheduler::stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+
+        if (cycle_thread_.joinable()) {
+            cycle_thread_.join();
+        }
+
+        std::cout << "[PDO] SYNC scheduler stopped after "
+                  << cycles_.load(std::memory_order_relaxed) << " cycles" << std::endl;
+    }
+
+    bool SyncScheduler::queue_rpdo(pdo::PDOType type, uint8_t node_id, const uint8_t* data,
+        uint8_t length) {
+        if (!PDOManager::is_rpdo(type) || node_id < pdo::MIN_NODE_ID ||
+            node_id > pdo::MAX_NODE_ID || length > pdo::limits::MAX_PDO_DATA_LENGTH) {
+            std::cerr << "[PDO] Invalid RPDO queued: " << pdo::pdo_type_to_string(type)
+                      << " node " << static_cast<int>(node_id) << std::endl;
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+
+        PendingRPDO* slot = nullptr;
+        for (auto& pending : pending_) {
+            if (pending.type == type && pending.node_id == node_id) {
+                slot = &pending;
+                break;
+            }
+        }
+        if (!slot) {
+            pending_.push_back(PendingRPDO{type, node_id, 0, {}});
+            slot = &pending_.back();
+        }
+
+        slot->length = length;
+        if (length > 0) {
+            std::memcpy(slot->data, data, length);
+        }
+        return true;
+    }
+
+    void SyncScheduler::cycle_loop() {
+        const int64_t period_ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(config_.period).count();
+        const int64_t spin_ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(config_.spin).count();
+        const int64_t miss_ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(config_.miss_threshold).count();
+
+        int64_t deadline = now_ns() + period_ns;
+        uint64_t cycle = 0;
+
+        while (running_.load()) {
+            // Coarse sleep to the deadline (minus spin window), then busy-wait the rest
+            sleep_until_ns(deadline - spin_ns);
+            if (spin_ns > 0) {
+                while (now_ns() < deadline) {
+                }
+            }
+
+            int64_t lateness = now_ns() - deadline;
+            if (lateness < 0) lateness = 0;
+
+            send_burst();
+
+            jitter_.record(static_cast<uint64_t>(lateness));
+            if (lateness > miss_ns) {
+                deadline_misses_.fetch_add(1, std::memory_order_relaxed);
+                misses_.record(static_cast<uint64_t>(lateness));
+            }
+
+            // Re-anchor after an overrun: skip lost periods instead of bursting to catch up
+            int64_t skipped = lateness / period_ns;
+            if (skipped > 0) {
+                skipped_cycles_.fetch_add(static_cast<uint64_t>(skipped),
+                    std::memory_order_relaxed);
+            }
+            deadline += period_ns * (skipped + 1);
+
+            cycles_.fetch_add(1, std::memory_order_relaxed);
+
+            if (cycle_callback_) {
+                try {
+                    cycle_callback_(cycle);
+                } catch (const std::exception& e) {
+                    std::cerr << "[PDO] Cycle callback exception: " << e.what() << std::endl;
+                }
+            }
+            ++cycle;
+        }
+    }
+
+    void SyncScheduler::send_burst() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            burst_.swap(pending_);
+        }
+
+        if (config_.send_sync) {
+            if (manager_.send_sync()) {
+                sync_sent_.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                send_errors_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        for (const auto& rpdo : burst_) {
+            if (manager_.send_rpdo(rpdo.type, rpdo.node_id, rpdo.data, rpdo.length)) {
+                rpdos_sent_.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                send_errors_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        burst_.clear();
+    }
+
+    SyncScheduler::StatisticsSnapshot SyncScheduler::get_statistics() const {
+        StatisticsSnapshot snapshot;
+        snapshot.cycles = cycles_.load(std::memory_order_relaxed);
+        snapshot.sync_sent = sync_sent_.load(std::memory_order_relaxed);
+        snapshot.rpdos_sent = rpdos_sent_.load(std::memory_order_relaxed);
+        snapshot.send_errors = send_errors_.load(std::memory_order_relaxed);
+        snapshot.deadline_misses = deadline_misses_.load(std::memory_order_relaxed);
+        snapshot.skipped_cycles = skipped_cycles_.load(std::memory_order_relaxed);
+        snapshot.jitter = jitter_.snapshot();
+        snapshot.misses = misses_.snapshot();
+        return snapshot;
+    }
+
+    void SyncScheduler::reset_statistics() {
+        cycles_.store(0, std::memory_order_relaxed);
+        sync_sent_.store(0, std::memory_order_relaxed);
+        rpdos_sent_.store(0, std::memory_order_relaxed);
+        send_errors_.store(0, std::memory_order_relaxed);
+        deadline_misses_.store(0, std::memory_order_relaxed);
+        skipped_cycles_.store(0, std::memory_order_relaxed);
+        jitter_.reset();
+        misses_.reset();
+    }
+
+} // namespace canopen
@@ -0,0 +1,68 @@
+/**
+ * @file capture_file.cpp
+ * @brief Memory-mapped capture reader implementation
+ * @version 1.0
+ * @date 2025-11-24
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include "../include/io/capture_file.hpp"
+
+namespace waveshare {
+
+    CaptureFile::CaptureFile(const std::string& path)
+        : path_(path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open capture " + path + ": " + std::strerror(errno));
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            int error = errno;
+            ::close(fd);
+            throw std::runtime_error("Cannot stat capture " + path + ": " + std::strerror(error));
+        }
+        length_ = static_cast<std::size_t>(info.st_size);
+        if (length_ < sizeof(CaptureFileHeader)) {
+            ::close(fd);
+            throw std::runtime_error("Not a capture file (too short): " + path);
+        }
+
+        map_ = ::mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+        int error = errno;
+        ::close(fd);    // The mapping keeps the file referenced
+        if (map_ == MAP_FAILED) {
+            map_ = nullptr;
+            throw std::runtime_error("Cannot map capture " + path + ": " + std::strerror(error));
+        }
+        ::madvise(map_, length_, MADV_SEQUENTIAL);
+
+        CaptureFileHeader header;
+        std::memcpy(&header, map_, sizeof(header));
+        if (std::memcmp(header.magic, CAPTURE_MAGIC, sizeof(header.magic)) != 0 ||
+            header.record_size != sizeof(CaptureRecord)) {
+            ::munmap(map_, length_);
+            map_ = nullptr;
+            throw std::runtime_error("Not a capture file (bad header): " + path);
+        }
+
+        records_ = reinterpret_cast<const CaptureRecord*>(
+            static_cast<const std::uint8_t*>(map_) + sizeof(CaptureFileHeader));
+        count_ = (length_ - sizeof(CaptureFileHeader)) / sizeof(CaptureRecord);
+    }
+
+    CaptureFile::~CaptureFile() {
+        if (map_ != nullptr) {
+            ::munmap(map_, length_);
+        }
+    }
+
+}  // namespace waveshare
@@ -0,0 +1,235 @@
+/**
+ * @file capture_writer.cpp
+ * @brief Buffered capture output implementation
+ * @version 1.0
+ * @date 2025-11-23
+ */
+
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include "../include/io/capture_writer.hpp"
+
+namespace waveshare {
+
+    namespace {
+        constexpr char HEX[] = "0123456789ABCDEF";
+
+        // "(seconds.micros) " + " " + 8-digit ID + "#" + 16 hex digits + "\n", rounded up
+        constexpr std::size_t CANDUMP_LINE_MAX = 64;
+
+        std::uint8_t* put_hex(std::uint8_t* out, std::uint32_t value, int digits) {
+            for (int i = digits - 1; i >= 0; --i) {
+                out[i] = static_cast<std::uint8_t>(HEX[value & 0x0F]);
+                value >>= 4;
+            }
+            return out + digits;
+        }
+
+        std::uint8_t* put_decimal(std::uint8_t* out, std::uint64_t value, int min_digits) {
+            std::uint8_t digits[20];
+            int count = 0;
+            do {
+                digits[count++] = static_cast<std::uint8_t>('0' + value % 10);
+                value /= 10;
+            } while (value != 0 || count < min_digits);
+            while (count > 0) {
+                *out++ = digits[--count];
+            }
+            return out;
+        }
+    }
+
+    CaptureWriter::CaptureWriter(int fd, CaptureFormat format, std::string interface_name,
+        std::size_t buffer_size, std::size_t buffer_count)
+        : fd_(fd), format_(format), interface_name_(std::move(interface_name)) {
+        if (fd_ < 0) {
+            throw std::invalid_argument("CaptureWriter: invalid file descriptor");
+        }
+        record_limit_ = format_ == CaptureFormat::BINARY
+            ? sizeof(CaptureRecord)
+            : CANDUMP_LINE_MAX + interface_name_.size();
+        if (buffer_count < 2 || buffer_size < record_limit_ + sizeof(CaptureFileHeader)) {
+            throw std::invalid_argument("CaptureWriter: need at least 2 buffers of " +
+                std::to_string(record_limit_ + sizeof(CaptureFileHeader)) + " bytes");
+        }
+
+        buffers_.resize(buffer_count);
+        for (auto& buf : buffers_) {
+            buf.data.resize(buffer_size);
+            free_.push_back(&buf);
+        }
+
+        current_ = free_.front();
+        free_.pop_front();
+        if (format_ == CaptureFormat::BINARY) {
+            CaptureFileHeader header{};
+            std::memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+            header.record_size = sizeof(CaptureRecord);
+            std::memcpy(current_->data.data(), &header, sizeof(header));
+            current_->used = sizeof(header);
+        }
+
+        thread_ = std::thread(&CaptureWriter::run, this);
+    }
+
+    CaptureWriter::~CaptureWriter() {
+        stop();
+    }
+
+    bool CaptureWriter::write(const struct can_frame& frame, std::uint64_t timestamp_us) {
+        if (current_ == nullptr) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (free_.empty() || stopping_) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            current_ = free_.front();
+            free_.pop_front();
+        }
+
+        format_record(*current_, frame, timestamp_us);
+        records_.fetch_add(1, std::memory_order_relaxed);
+
+        if (current_->used + record_limit_ > current_->data.size()) {
+            submit();
+        }
+        return true;
+    }
+
+    void CaptureWriter::format_record(Buffer& buf, const struct can_frame& frame,
+        std::uint64_t timestamp_us) const {
+        std::uint8_t* out = buf.data.data() + buf.used;
+        const std::uint8_t dlc = frame.can_dlc > CAN_MAX_DLEN ? CAN_MAX_DLEN : frame.can_dlc;
+        const bool remote = (frame.can_id & CAN_RTR_FLAG) != 0;
+
+        if (format_ == CaptureFormat::BINARY) {
+            CaptureRecord record{};
+            record.timestamp_us = timestamp_us;
+            record.can_id = frame.can_id & (CAN_EFF_FLAG | CAN_RTR_FLAG | CAN_EFF_MASK);
+            record.dlc = dlc;
+            if (!remote) {
+                std::memcpy(record.data, frame.data, dlc);
+            }
+            std::memcpy(out, &record, sizeof(record));
+            buf.used += sizeof(record);
+            return;
+        }
+
+        // (1700000000.123456) can0 123#DEADBEEF
+        std::uint8_t* start = out;
+        *out++ = '(';
+        out = put_decimal(out, timestamp_us / 1000000, 1);
+        *out++ = '.';
+        out = put_decimal(out, timestamp_us % 1000000, 6);
+        *out++ = ')';
+        *out++ = ' ';
+        std::memcpy(out, interface_name_.data(), interface_name_.size());
+        out += interface_name_.size();
+        *out++ = ' ';
+        if (frame.can_id & CAN_EFF_FLAG) {
+            out = put_hex(out, frame.can_id & CAN_EFF_MASK, 8);
+        } else {
+            out = put_hex(out, frame.can_id & CAN_SFF_MASK, 3);
+        }
+        *out++ = '#';
+        if (remote) {
+            *out++ = 'R';
+            if (dlc > 0) {
+                *out++ = static_cast<std::uint8_t>('0' + dlc);
+            }
+        } else {
+            for (std::uint8_t i = 0; i < dlc; ++i) {
+                out = put_hex(out, frame.data[i], 2);
+            }
+        }
+        *out++ = '\n';
+        buf.used += static_cast<std::size_t>(out - start);
+    }
+
+    void CaptureWriter::submit() {
+        if (current_ == nullptr) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            full_.push_back(current_);
+        }
+        current_ = nullptr;
+        work_cv_.notify_one();
+    }
+
+    void CaptureWriter::flush() {
+        if (current_ != nullptr && current_->used > 0) {
+            submit();
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this] { return full_.empty() && !writing_; });
+    }
+
+    void CaptureWriter::stop() {
+        if (!thread_.joinable()) {
+            return;
+        }
+        flush();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        work_cv_.notify_one();
+        thread_.join();
+    }
+
+    CaptureStatistics CaptureWriter::get_statistics() const {
+        CaptureStatistics stats;
+        stats.records = records_.load(std::memory_order_relaxed);
+        stats.dropped = dropped_.load(std::memory_order_relaxed);
+        stats.bytes_written = bytes_written_.load(std::memory_order_relaxed);
+        stats.write_errors = write_errors_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void CaptureWriter::run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            work_cv_.wait(lock, [this] { return !full_.empty() || stopping_; });
+            if (full_.empty()) {
+                return;     // Stopping, everything written
+            }
+
+            Buffer* buf = full_.front();
+            full_.pop_front();
+            writing_ = true;
+            lock.unlock();
+
+            write_out(*buf);
+            buf->used = 0;
+
+            lock.lock();
+            writing_ = false;
+            free_.push_back(buf);
+            done_cv_.notify_all();
+        }
+    }
+
+    void CaptureWriter::write_out(const Buffer& buf) {
+        std::size_t offset = 0;
+        while (offset < buf.used) {
+            ssize_t written = ::write(fd_, buf.data.data() + offset, buf.used - offset);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                // The buffer is lost; keep the thread alive for the next one
+                write_errors_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            offset += static_cast<std::size_t>(written);
+            bytes_written_.fetch_add(static_cast<std::uint64_t>(written),
+                std::memory_order_relaxed);
+        }
+    }
+
+}  // namespace waveshare
@@ -0,0 +1,192 @@
+/**
+ * @file frame_stream_decoder.cpp
+ * @brief Buffered Waveshare stream decoder implementation
+ * @version 1.0
+ * @date 2025-11-23
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "../include/io/frame_stream_decoder.hpp"
+#include "../include/enums/protocol.hpp"
+#include "../include/template/frame_traits.hpp"
+
+namespace waveshare {
+
+    namespace {
+        constexpr std::uint8_t START = to_byte(Constants::START_BYTE);
+        constexpr std::uint8_t END = to_byte(Constants::END_BYTE);
+        constexpr std::uint8_t HEADER = to_byte(Constants::HEADER);
+
+        // Bytes appended to a pending partial frame per step: more than any frame
+        constexpr std::size_t COMPLETION_CHUNK = 32;
+
+        std::uint32_t read_le(const std::uint8_t* bytes, std::size_t count) {
+            std::uint32_t value = 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                value |= static_cast<std::uint32_t>(bytes[i]) << (8 * i);
+            }
+            return value;
+        }
+    }
+
+    FrameStreamDecoder::FrameStreamDecoder(Mode mode)
+        : mode_(mode) {
+        pending_.reserve(FixedFrameLayout::CHECKSUM + 1 + COMPLETION_CHUNK);
+    }
+
+    std::size_t FrameStreamDecoder::decode(const std::uint8_t* data, std::size_t size,
+        std::vector<struct can_frame>& frames) {
+        const std::size_t before = frames.size();
+        std::size_t offset = 0;
+
+        // Complete the frame split by the previous chunk, a few bytes at a time,
+        // so the bulk of the chunk is parsed in place
+        while (!pending_.empty() && offset < size) {
+            const std::size_t held = pending_.size();
+            const std::size_t take = std::min(size - offset, COMPLETION_CHUNK);
+            pending_.insert(pending_.end(), data + offset, data + offset + take);
+
+            std::size_t used = parse(pending_.data(), pending_.size(), frames);
+            if (used >= held) {
+                offset += used - held;      // Continue in place from here
+                pending_.clear();
+            } else if (offset + take == size) {
+                pending_.erase(pending_.begin(), pending_.begin() + used);
+                offset = size;
+            } else {
+                pending_.resize(held);
+                pending_.erase(pending_.begin(), pending_.begin() + used);
+            }
+        }
+
+        if (offset < size) {
+            std::size_t used = parse(data + offset, size - offset, frames);
+            pending_.assign(data + offset + used, data + size);
+        }
+        return frames.size() - before;
+    }
+
+    std::size_t FrameStreamDecoder::parse(const std::uint8_t* data, std::size_t size,
+        std::vector<struct can_frame>& frames) {
+        std::size_t pos = 0;
+
+        while (pos < size) {
+            struct can_frame frame;
+            std::size_t length = 0;
+            Parse result = mode_ == Mode::VARIABLE
+                ? parse_variable(data + pos, size - pos, frame, length)
+                : parse_fixed(data + pos, size - pos, frame, length);
+
+            if (result == Parse::FRAME) {
+                frames.push_back(frame);
+                ++stats_.frames;
+                in_garbage_ = false;
+                pos += length;
+                continue;
+            }
+            if (result == Parse::INCOMPLETE) {
+                break;
+            }
+
+            // Count a run of garbage once, then skip to the next START byte
+            if (!in_garbage_) {
+                ++stats_.decode_errors;
+                in_garbage_ = true;
+            }
+            const void* next = std::memchr(data + pos + 1, START, size - pos - 1);
+            std::size_t skip = next
+                ? static_cast<std::size_t>(static_cast<const std::uint8_t*>(next) - (data + pos))
+                : size - pos;
+            stats_.skipped_bytes += skip;
+            pos += skip;
+        }
+        return pos;
+    }
+
+    FrameStreamDecoder::Parse FrameStreamDecoder::parse_variable(const std::uint8_t* data,
+        std::size_t size, struct can_frame& frame, std::size_t& length) const {
+        using Layout = VariableFrameLayout;
+
+        if (data[Layout::START] != START) {
+            return Parse::INVALID;
+        }
+        if (size <= Layout::TYPE) {
+            return Parse::INCOMPLETE;
+        }
+
+        // TYPE: 11 EXT RTR DLC(4)
+        const std::uint8_t type = data[Layout::TYPE];
+        const bool extended = (type & 0x20) != 0;
+        const bool remote = (type & 0x10) != 0;
+        const std::uint8_t dlc = type & 0x0F;
+        if ((type & 0xC0) != 0xC0 || dlc > CAN_MAX_DLEN) {
+            return Parse::INVALID;
+        }
+
+        length = Layout::frame_size(extended, dlc);
+        if (size < length) {
+            return Parse::INCOMPLETE;
+        }
+        if (data[length - 1] != END) {
+            return Parse::INVALID;
+        }
+
+        std::memset(&frame, 0, sizeof(frame));
+        frame.can_id = read_le(data + Layout::ID, Layout::id_size(extended));
+        frame.can_id &= extended ? CAN_EFF_MASK : CAN_SFF_MASK;
+        if (extended) frame.can_id |= CAN_EFF_FLAG;
+        if (remote) frame.can_id |= CAN_RTR_FLAG;
+        frame.can_dlc = dlc;
+        if (!remote) {
+            std::memcpy(frame.data, data + Layout::data_offset(extended), dlc);
+        }
+        return Parse::FRAME;
+    }
+
+    FrameStreamDecoder::Parse FrameStreamDecoder::parse_fixed(const std::uint8_t* data,
+        std::size_t size, struct can_frame& frame, std::size_t& length) const {
+        using Layout = FixedFrameLayout;
+
+        if (data[Layout::START] != START) {
+            return Parse::INVALID;
+        }
+        if (size <= Layout::HEADER) {
+            return Parse::INCOMPLETE;
+        }
+        if (data[Layout::HEADER] != HEADER) {
+            return Parse::INVALID;
+        }
+
+        length = Layout::CHECKSUM + 1;
+        if (size < length) {
+            return Parse::INCOMPLETE;
+        }
+
+        std::uint8_t checksum = 0;
+        for (std::size_t i = Layout::CHECKSUM_START; i <= Layout::CHECKSUM_END; ++i) {
+            checksum = static_cast<std::uint8_t>(checksum + data[i]);
+        }
+        const std::uint8_t dlc = data[Layout::DLC];
+        if (data[Layout::TYPE] != to_byte(Type::DATA_FIXED) ||
+            data[Layout::CHECKSUM] != checksum || dlc > CAN_MAX_DLEN) {
+            return Parse::INVALID;
+        }
+
+        const bool extended = data[Layout::CAN_VERS] == to_byte(CANVersion::EXT_FIXED);
+        const bool remote = data[Layout::FORMAT] == to_byte(Format::REMOTE_FIXED);
+
+        std::memset(&frame, 0, sizeof(frame));
+        frame.can_id = read_le(data + Layout::ID, Layout::ID_SIZE);
+        frame.can_id &= extended ? CAN_EFF_MASK : CAN_SFF_MASK;
+        if (extended) frame.can_id |= CAN_EFF_FLAG;
+        if (remote) frame.can_id |= CAN_RTR_FLAG;
+        frame.can_dlc = dlc;
+        if (!remote) {
+            std::memcpy(frame.data, data + Layout::DATA, dlc);
+        }
+        return Parse::FRAME;
+    }
+
+}  // namespace waveshare
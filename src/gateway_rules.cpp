@@ -0,0 +1,256 @@
+/**
+ * @file gateway_rules.cpp
+ * @brief Gateway rule parsing, compilation and execution
+ * @version 1.0
+ * @date 2025-11-26
+ */
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "../include/pattern/gateway_rules.hpp"
+
+using json = nlohmann::json;
+
+namespace waveshare {
+
+    namespace {
+        // Numbers may be given as JSON numbers or as strings ("0x181")
+        std::uint32_t parse_number(const json& value, const char* what) {
+            if (value.is_string()) {
+                std::string text = value.get<std::string>();
+                std::size_t pos = 0;
+                unsigned long number = std::stoul(text, &pos, 0);
+                if (pos != text.size()) {
+                    throw std::invalid_argument(std::string("Invalid ") + what +
+                        " in gateway rule: " + text);
+                }
+                return static_cast<std::uint32_t>(number);
+            }
+            return value.get<std::uint32_t>();
+        }
+
+        std::string lowercase(std::string text) {
+            std::transform(text.begin(), text.end(), text.begin(), ::tolower);
+            std::replace(text.begin(), text.end(), '-', '_');
+            return text;
+        }
+    }
+
+    RuleDirection rule_direction_from_string(const std::string& name) {
+        std::string direction = lowercase(name);
+        if (direction == "usb_to_can") return RuleDirection::USB_TO_CAN;
+        if (direction == "can_to_usb") return RuleDirection::CAN_TO_USB;
+        if (direction == "both") return RuleDirection::BOTH;
+        throw std::invalid_argument("Invalid gateway rule direction: " + name);
+    }
+
+    // === JSON Parsing ===
+
+    RuleAction RuleAction::from_json(const json& j) {
+        RuleAction action;
+        std::string op = lowercase(j.at("op").get<std::string>());
+        if (op == "set_id") {
+            action.type = Type::SET_ID;
+            action.id = parse_number(j.at("id"), "id");
+            action.extended = j.value("extended", action.id > CAN_SFF_MASK);
+        } else if (op == "and" || op == "or") {
+            action.type = op == "and" ? Type::AND : Type::OR;
+            action.byte = static_cast<std::uint8_t>(j.at("byte").get<unsigned>());
+            std::uint32_t value = parse_number(j.at("value"), "value");
+            if (value > 0xFF) {
+                throw std::invalid_argument("Gateway rule " + op + " value exceeds one byte");
+            }
+            action.value = static_cast<std::uint8_t>(value);
+        } else if (op == "scale") {
+            action.type = Type::SCALE;
+            action.byte = static_cast<std::uint8_t>(j.at("byte").get<unsigned>());
+            action.length = static_cast<std::uint8_t>(j.value("length", 1u));
+            std::string endian = lowercase(j.value("endian", std::string("little")));
+            if (endian != "little" && endian != "big") {
+                throw std::invalid_argument("Invalid gateway rule endian: " + endian);
+            }
+            action.big_endian = endian == "big";
+            action.is_signed = j.value("signed", false);
+            action.mul = j.value("mul", 1);
+            action.div = j.value("div", 1);
+            action.offset = j.value("offset", 0);
+        } else if (op == "drop") {
+            action.type = Type::DROP;
+        } else {
+            throw std::invalid_argument("Invalid gateway rule op: " + op);
+        }
+        return action;
+    }
+
+    GatewayRule GatewayRule::from_json(const json& j) {
+        GatewayRule rule;
+        rule.name = j.value("name", std::string());
+        if (j.contains("direction")) {
+            rule.direction = rule_direction_from_string(j["direction"].get<std::string>());
+        }
+        rule.id = parse_number(j.at("id"), "id");
+        rule.extended = j.value("extended", rule.id > CAN_SFF_MASK);
+        rule.mask = j.contains("mask") ? parse_number(j["mask"], "mask")
+                                       : (rule.extended ? CAN_EFF_MASK : CAN_SFF_MASK);
+        for (const auto& action : j.at("actions")) {
+            rule.actions.push_back(RuleAction::from_json(action));
+        }
+        return rule;
+    }
+
+    // === Compilation ===
+
+    GatewayRuleEngine::GatewayRuleEngine(const std::vector<GatewayRule>& rules) {
+        for (auto& table : standard_) {
+            table.fill(NO_RULE);
+        }
+
+        for (const GatewayRule& rule : rules) {
+            const std::string label = rule.name.empty()
+                ? "Gateway rule " + std::to_string(rule_count_)
+                : "Gateway rule '" + rule.name + "'";
+            const std::uint32_t width = rule.extended ? CAN_EFF_MASK : CAN_SFF_MASK;
+            if (rule.id > width || rule.mask > width) {
+                throw std::invalid_argument(label + ": ID or mask exceeds the ID width");
+            }
+            if (rule.actions.empty()) {
+                throw std::invalid_argument(label + ": no actions");
+            }
+
+            const std::size_t program = code_.size();
+            for (const RuleAction& action : rule.actions) {
+                Instruction in{};
+                switch (action.type) {
+                case RuleAction::Type::SET_ID:
+                    if (action.id > (action.extended ? CAN_EFF_MASK : CAN_SFF_MASK)) {
+                        throw std::invalid_argument(label + ": set_id out of range");
+                    }
+                    in.op = Op::SET_ID;
+                    in.arg = action.id | (action.extended ? CAN_EFF_FLAG : 0);
+                    break;
+                case RuleAction::Type::AND:
+                case RuleAction::Type::OR:
+                    if (action.byte >= CAN_MAX_DLEN) {
+                        throw std::invalid_argument(label + ": byte index out of range");
+                    }
+                    in.op = action.type == RuleAction::Type::AND ? Op::AND : Op::OR;
+                    in.byte = action.byte;
+                    in.arg = action.value;
+                    break;
+                case RuleAction::Type::SCALE:
+                    if (action.length != 1 && action.length != 2 && action.length != 4) {
+                        throw std::invalid_argument(label + ": scale length must be 1, 2 or 4");
+                    }
+                    if (action.byte + action.length > CAN_MAX_DLEN) {
+                        throw std::invalid_argument(label + ": scale field beyond byte 7");
+                    }
+                    if (action.div == 0) {
+                        throw std::invalid_argument(label + ": scale divisor is zero");
+                    }
+                    in.op = Op::SCALE;
+                    in.byte = action.byte;
+                    in.length = action.length;
+                    in.flags = static_cast<std::uint8_t>(
+                        (action.big_endian ? SCALE_BIG_ENDIAN : 0) |
+                        (action.is_signed ? SCALE_SIGNED : 0));
+                    in.mul = action.mul;
+                    in.div = action.div;
+                    in.offset = action.offset;
+                    break;
+                case RuleAction::Type::DROP:
+                    in.op = Op::DROP;
+                    break;
+                }
+                code_.push_back(in);
+                if (in.op == Op::DROP) {
+                    break;  // Nothing after a drop can run
+                }
+            }
+            code_.push_back(Instruction{Op::END, 0, 0, 0, 0, 0, 0, 0});
+            if (code_.size() > NO_RULE) {
+                throw std::invalid_argument("Gateway rules: too many actions");
+            }
+            const auto entry = static_cast<std::uint16_t>(program);
+
+            for (std::size_t d = 0; d < 2; ++d) {
+                const auto bit = static_cast<std::uint8_t>(1u << d);
+                if ((static_cast<std::uint8_t>(rule.direction) & bit) == 0) {
+                    continue;
+                }
+                if (rule.extended) {
+                    extended_[d].push_back(ExtendedMatch{
+                        (rule.id & rule.mask) | CAN_EFF_FLAG, rule.mask | CAN_EFF_FLAG, entry});
+                    continue;
+                }
+                // Earlier rules keep the IDs they already claimed
+                for (std::uint32_t id = 0; id <= CAN_SFF_MASK; ++id) {
+                    if (standard_[d][id] == NO_RULE && (id & rule.mask) == (rule.id & rule.mask)) {
+                        standard_[d][id] = entry;
+                    }
+                }
+            }
+            ++rule_count_;
+        }
+    }
+
+    // === Execution ===
+
+    GatewayRuleEngine::Verdict GatewayRuleEngine::run(std::uint16_t program,
+        struct can_frame& frame) const {
+        for (const Instruction* in = &code_[program]; ; ++in) {
+            switch (in->op) {
+            case Op::SET_ID:
+                frame.can_id = in->arg | (frame.can_id & CAN_RTR_FLAG);
+                break;
+            case Op::AND:
+                if (in->byte < frame.can_dlc) {
+                    frame.data[in->byte] &= static_cast<std::uint8_t>(in->arg);
+                }
+                break;
+            case Op::OR:
+                if (in->byte < frame.can_dlc) {
+                    frame.data[in->byte] |= static_cast<std::uint8_t>(in->arg);
+                }
+                break;
+            case Op::SCALE: {
+                if (in->byte + in->length > frame.can_dlc) {
+                    break;  // Field not present in this frame
+                }
+                const bool big = (in->flags & SCALE_BIG_ENDIAN) != 0;
+                const unsigned bits = 8u * in->length;
+                std::uint64_t raw = 0;
+                for (unsigned k = 0; k < in->length; ++k) {
+                    raw = (raw << 8) | frame.data[in->byte + (big ? k : in->length - 1 - k)];
+                }
+
+                std::int64_t value = static_cast<std::int64_t>(raw);
+                std::int64_t low = 0;
+                std::int64_t high = static_cast<std::int64_t>((1ULL << bits) - 1);
+                if (in->flags & SCALE_SIGNED) {
+                    high = static_cast<std::int64_t>((1ULL << (bits - 1)) - 1);
+                    low = -high - 1;
+                    if (value > high) {
+                        value -= static_cast<std::int64_t>(1ULL << bits);
+                    }
+                }
+                // |value| < 2^32 and |mul| < 2^31: the product fits in 64 bits
+                value = value * in->mul / in->div + in->offset;
+                value = std::min(std::max(value, low), high);
+
+                raw = static_cast<std::uint64_t>(value);
+                for (unsigned k = 0; k < in->length; ++k) {
+                    frame.data[in->byte + (big ? in->length - 1 - k : k)] =
+                        static_cast<std::uint8_t>(raw >> (8 * k));
+                }
+                break;
+            }
+            case Op::DROP:
+                return Verdict::DROP;
+            case Op::END:
+                return Verdict::REWRITTEN;
+            }
+        }
+    }
+
+}  // namespace waveshare
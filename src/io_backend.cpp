@@ -0,0 +1,77 @@
+/**
+ * @file io_backend.cpp
+ * @brief I/O backend selection
+ * @version 1.0
+ * @date 2025-11-29
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/io/io_backend.hpp"
+#include "../include/io/real_can_socket.hpp"
+#include "../include/io/real_serial_port.hpp"
+#include "../include/io/uring_can_socket.hpp"
+#include "../include/io/uring_serial_port.hpp"
+
+namespace waveshare {
+
+    IoBackend io_backend_from_string(const std::string& name) {
+        std::string lower = name;
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        if (lower == "posix") {
+            return IoBackend::POSIX;
+        }
+        if (lower == "io_uring" || lower == "uring") {
+            return IoBackend::IO_URING;
+        }
+        throw std::invalid_argument("Invalid I/O backend: " + name + " (posix, io_uring)");
+    }
+
+    std::string io_backend_to_string(IoBackend backend) {
+        return backend == IoBackend::IO_URING ? "io_uring" : "posix";
+    }
+
+    IoBackend effective_io_backend(IoBackend requested) {
+        if (requested == IoBackend::IO_URING && !IoUringContext::is_supported()) {
+            return IoBackend::POSIX;
+        }
+        return requested;
+    }
+
+    namespace {
+        bool use_uring(IoBackend backend) {
+            if (backend != IoBackend::IO_URING) {
+                return false;
+            }
+            if (effective_io_backend(backend) == IoBackend::POSIX) {
+                static bool warned = false;
+                if (!warned) {
+                    warned = true;
+                    std::cerr << "[IO] io_uring not supported by this kernel, using POSIX I/O"
+                              << std::endl;
+                }
+                return false;
+            }
+            return true;
+        }
+    }
+
+    std::unique_ptr<ISerialPort> open_serial_port(const std::string& device_path,
+        SerialBaud baud_rate, IoBackend backend) {
+        if (use_uring(backend)) {
+            return std::make_unique<UringSerialPort>(device_path, baud_rate);
+        }
+        return std::make_unique<RealSerialPort>(device_path, baud_rate);
+    }
+
+    std::unique_ptr<ICANSocket> open_can_socket(const std::string& interface, int timeout_ms,
+        IoBackend backend) {
+        if (use_uring(backend)) {
+            return std::make_unique<UringCANSocket>(interface, timeout_ms);
+        }
+        return std::make_unique<RealCANSocket>(interface, timeout_ms);
+    }
+
+}  // namespace waveshare
@@ -0,0 +1,515 @@
+/**
+ * @file isotp_engine.cpp
+ * @brief ISO-TP transport implementation
+ * @version 1.0
+ * @date 2025-11-25
+ */
+
+#include <poll.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/pattern/isotp_engine.hpp"
+#include "../include/pattern/usb_adapter.hpp"
+#include "../include/interface/socketcan_helpers.hpp"
+
+namespace waveshare {
+
+    // === IsoTpBufferPool ===
+
+    IsoTpBufferPool::IsoTpBufferPool(std::size_t count, std::size_t buffer_size)
+        : buffer_size_(buffer_size), storage_(count * buffer_size) {
+        free_.reserve(count);
+        for (std::size_t i = count; i > 0; --i) {
+            free_.push_back(static_cast<int>(i - 1));
+        }
+    }
+
+    int IsoTpBufferPool::acquire() {
+        if (free_.empty()) {
+            return NONE;
+        }
+        int index = free_.back();
+        free_.pop_back();
+        return index;
+    }
+
+    void IsoTpBufferPool::release(int index) {
+        if (index != NONE) {
+            free_.push_back(index);
+        }
+    }
+
+    // === IsoTpEngine ===
+
+    IsoTpEngine::IsoTpEngine(std::shared_ptr<ICANSocket> socket, const IsoTpEngineConfig& config)
+        : IsoTpEngine(SendFunction(), config) {
+        if (!socket) {
+            throw std::invalid_argument("IsoTpEngine: socket is null");
+        }
+        socket_ = std::move(socket);
+        send_ = [sock = socket_.get()](const struct can_frame& frame) {
+                return sock->send(frame) == static_cast<ssize_t>(sizeof(frame));
+            };
+    }
+
+    IsoTpEngine::IsoTpEngine(SendFunction send, const IsoTpEngineConfig& config)
+        : send_(std::move(send)), config_(config),
+        pool_(config.pool_buffers, config.buffer_size) {
+        if (config_.buffer_size > isotp::MAX_MESSAGE_SIZE) {
+            throw std::invalid_argument("IsoTpEngine: buffer_size above "
+                + std::to_string(isotp::MAX_MESSAGE_SIZE));
+        }
+    }
+
+    IsoTpEngine::~IsoTpEngine() {
+        stop();
+    }
+
+    IsoTpEngine::SendFunction IsoTpEngine::adapter_sender(std::shared_ptr<USBAdapter> adapter) {
+        return [adapter = std::move(adapter)](const struct can_frame& frame) {
+                try {
+                    adapter->send_frame(SocketCANHelper::from_socketcan(frame));
+                    return true;
+                } catch (const std::exception& e) {
+                    std::cerr << "[ISOTP] Adapter send failed: " << e.what() << std::endl;
+                    return false;
+                }
+            };
+    }
+
+    std::size_t IsoTpEngine::add_channel(const IsoTpChannelConfig& config) {
+        if (config.timeout.count() <= 0) {
+            throw std::invalid_argument("IsoTpEngine: channel timeout must be > 0");
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (by_rx_id_.count(config.rx_id) != 0) {
+            throw std::invalid_argument("IsoTpEngine: rx_id already used by another channel");
+        }
+        Channel channel;
+        channel.config = config;
+        channels_.push_back(channel);
+        by_rx_id_[config.rx_id] = channels_.size() - 1;
+        return channels_.size() - 1;
+    }
+
+    void IsoTpEngine::on_receive(ReceiveCallback callback) {
+        auto shared = std::make_shared<const ReceiveCallback>(std::move(callback));
+        std::lock_guard<std::mutex> lock(mutex_);
+        receive_callback_ = std::move(shared);
+    }
+
+    void IsoTpEngine::on_send_complete(SendCallback callback) {
+        auto shared = std::make_shared<const SendCallback>(std::move(callback));
+        std::lock_guard<std::mutex> lock(mutex_);
+        send_callback_ = std::move(shared);
+    }
+
+    IsoTpStatistics IsoTpEngine::get_statistics() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    std::size_t IsoTpEngine::available_buffers() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pool_.available();
+    }
+
+    // === Sending ===
+
+    IsoTpResult IsoTpEngine::send(std::size_t channel, const uint8_t* data, std::size_t size,
+        Clock::time_point now) {
+        if (size == 0 || size > isotp::MAX_MESSAGE_SIZE) {
+            throw std::invalid_argument("IsoTpEngine::send: message size " +
+                std::to_string(size) + " outside 1.." +
+                std::to_string(isotp::MAX_MESSAGE_SIZE));
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (channel >= channels_.size()) {
+            throw std::out_of_range("IsoTpEngine::send: unknown channel");
+        }
+        Channel& ch = channels_[channel];
+        if (ch.tx_state != TxState::IDLE) {
+            return IsoTpResult::BUSY;
+        }
+
+        uint8_t payload[CAN_MAX_DLEN];
+        if (size <= isotp::SF_MAX_DATA) {
+            payload[0] = static_cast<uint8_t>(isotp::PCI_SINGLE_FRAME | size);
+            std::memcpy(payload + 1, data, size);
+            if (!send_frame(ch, payload, size + 1)) {
+                return IsoTpResult::SEND_ERROR;
+            }
+            finish_send(channel, IsoTpResult::OK);
+            dispatch_events(lock);
+            return IsoTpResult::OK;
+        }
+
+        if (size > pool_.buffer_size()) {
+            return IsoTpResult::NO_BUFFER;
+        }
+        int buffer = pool_.acquire();
+        if (buffer == IsoTpBufferPool::NONE) {
+            return IsoTpResult::NO_BUFFER;
+        }
+        std::memcpy(pool_.data(buffer), data, size);
+
+        payload[0] = static_cast<uint8_t>(isotp::PCI_FIRST_FRAME | (size >> 8));
+        payload[1] = static_cast<uint8_t>(size & 0xFF);
+        std::memcpy(payload + 2, data, isotp::FF_DATA);
+        if (!send_frame(ch, payload, CAN_MAX_DLEN)) {
+            pool_.release(buffer);
+            return IsoTpResult::SEND_ERROR;
+        }
+        ch.tx_state = TxState::WAIT_FC;
+        ch.tx_buffer = buffer;
+        ch.tx_size = size;
+        ch.tx_sent = isotp::FF_DATA;
+        ch.tx_sn = 1;
+        ch.tx_wait_count = 0;
+        ch.tx_deadline = now + ch.config.timeout;
+        return IsoTpResult::OK;
+    }
+
+    bool IsoTpEngine::send_frame(Channel& channel, const uint8_t* data, std::size_t size) {
+        struct can_frame frame{};
+        frame.can_id = channel.config.tx_id;
+        std::memcpy(frame.data, data, size);
+        if (channel.config.pad) {
+            std::memset(frame.data + size, channel.config.padding, CAN_MAX_DLEN - size);
+            frame.can_dlc = CAN_MAX_DLEN;
+        } else {
+            frame.can_dlc = static_cast<uint8_t>(size);
+        }
+        if (!send_(frame)) {
+            ++stats_.send_errors;
+            return false;
+        }
+        ++stats_.frames_sent;
+        return true;
+    }
+
+    bool IsoTpEngine::send_flow_control(Channel& channel, isotp::FlowStatus status) {
+        const uint8_t payload[3] = {
+            static_cast<uint8_t>(isotp::PCI_FLOW_CONTROL | static_cast<uint8_t>(status)),
+            channel.config.block_size,
+            channel.config.st_min
+        };
+        return send_frame(channel, payload, sizeof(payload));
+    }
+
+    void IsoTpEngine::send_consecutive(std::size_t index, Clock::time_point now) {
+        Channel& ch = channels_[index];
+        const uint8_t* message = pool_.data(ch.tx_buffer);
+        uint8_t payload[CAN_MAX_DLEN];
+
+        // With STmin 0 the deadline stays at now and the block goes out back to back
+        while (ch.tx_state == TxState::SENDING && ch.tx_deadline <= now) {
+            std::size_t chunk = std::min(isotp::CF_DATA, ch.tx_size - ch.tx_sent);
+            payload[0] = static_cast<uint8_t>(isotp::PCI_CONSECUTIVE_FRAME | ch.tx_sn);
+            std::memcpy(payload + 1, message + ch.tx_sent, chunk);
+            if (!send_frame(ch, payload, chunk + 1)) {
+                finish_send(index, IsoTpResult::SEND_ERROR);
+                return;
+            }
+            ch.tx_sent += chunk;
+            ch.tx_sn = static_cast<uint8_t>((ch.tx_sn + 1) & 0x0F);
+
+            if (ch.tx_sent == ch.tx_size) {
+                finish_send(index, IsoTpResult::OK);
+                return;
+            }
+            if (ch.tx_block_size != 0 && --ch.tx_block_remaining == 0) {
+                ch.tx_state = TxState::WAIT_FC;
+                ch.tx_wait_count = 0;
+                ch.tx_deadline = now + ch.config.timeout;
+                return;
+            }
+            ch.tx_deadline = now + ch.tx_st_min;
+        }
+    }
+
+    void IsoTpEngine::finish_send(std::size_t index, IsoTpResult result) {
+        Channel& ch = channels_[index];
+        pool_.release(ch.tx_buffer);
+        ch.tx_buffer = IsoTpBufferPool::NONE;
+        ch.tx_state = TxState::IDLE;
+        if (result == IsoTpResult::OK) {
+            ++stats_.messages_sent;
+        } else if (result == IsoTpResult::TIMEOUT_BS) {
+            ++stats_.timeouts;
+        }
+        events_.push_back(Event{index, result, false, IsoTpBufferPool::NONE, 0, {}});
+    }
+
+    // === Receiving ===
+
+    void IsoTpEngine::process(const struct can_frame& frame, Clock::time_point now) {
+        if ((frame.can_id & (CAN_RTR_FLAG | CAN_ERR_FLAG)) != 0 || frame.can_dlc == 0) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = by_rx_id_.find(frame.can_id);
+        if (it == by_rx_id_.end()) {
+            return;
+        }
+        ++stats_.frames_received;
+
+        switch (frame.data[0] & isotp::PCI_TYPE_MASK) {
+        case isotp::PCI_SINGLE_FRAME:
+            handle_single(it->second, frame);
+            break;
+        case isotp::PCI_FIRST_FRAME:
+            handle_first(it->second, frame, now);
+            break;
+        case isotp::PCI_CONSECUTIVE_FRAME:
+            handle_consecutive(it->second, frame, now);
+            break;
+        case isotp::PCI_FLOW_CONTROL:
+            handle_flow_control(it->second, frame, now);
+            break;
+        default:
+            break;  // Reserved PCI types are ignored
+        }
+        dispatch_events(lock);
+    }
+
+    void IsoTpEngine::handle_single(std::size_t index, const struct can_frame& frame) {
+        std::size_t size = frame.data[0] & 0x0F;
+        if (size == 0 || size > isotp::SF_MAX_DATA || size + 1 > frame.can_dlc) {
+            return;
+        }
+        if (channels_[index].rx_state == RxState::RECEIVING) {
+            abort_reception(index, IsoTpResult::UNEXPECTED_PDU);
+        }
+        Event event{index, IsoTpResult::OK, true, IsoTpBufferPool::NONE, size, {}};
+        std::memcpy(event.single, frame.data + 1, size);
+        events_.push_back(event);
+        ++stats_.messages_received;
+    }
+
+    void IsoTpEngine::handle_first(std::size_t index, const struct can_frame& frame,
+        Clock::time_point now) {
+        Channel& ch = channels_[index];
+        std::size_t size = (static_cast<std::size_t>(frame.data[0] & 0x0F) << 8) | frame.data[1];
+        if (frame.can_dlc != CAN_MAX_DLEN || size <= isotp::SF_MAX_DATA) {
+            return;     // Malformed, or the CAN FD escape (FF_DL = 0)
+        }
+        if (ch.rx_state == RxState::RECEIVING) {
+            abort_reception(index, IsoTpResult::UNEXPECTED_PDU);
+        }
+
+        int buffer = size <= pool_.buffer_size() ? pool_.acquire() : IsoTpBufferPool::NONE;
+        if (buffer == IsoTpBufferPool::NONE) {
+            ++stats_.overflows;
+            send_flow_control(ch, isotp::FlowStatus::OVERFLOW);
+            return;
+        }
+        std::memcpy(pool_.data(buffer), frame.data + 2, isotp::FF_DATA);
+        ch.rx_state = RxState::RECEIVING;
+        ch.rx_buffer = buffer;
+        ch.rx_size = size;
+        ch.rx_received = isotp::FF_DATA;
+        ch.rx_sn = 1;
+        ch.rx_block_count = 0;
+        ch.rx_deadline = now + ch.config.timeout;
+        if (!send_flow_control(ch, isotp::FlowStatus::CONTINUE)) {
+            abort_reception(index, IsoTpResult::SEND_ERROR);
+        }
+    }
+
+    void IsoTpEngine::handle_consecutive(std::size_t index, const struct can_frame& frame,
+        Clock::time_point now) {
+        Channel& ch = channels_[index];
+        if (ch.rx_state != RxState::RECEIVING) {
+            return;
+        }
+        if ((frame.data[0] & 0x0F) != ch.rx_sn) {
+            abort_reception(index, IsoTpResult::WRONG_SN);
+            return;
+        }
+        std::size_t chunk = std::min(isotp::CF_DATA, ch.rx_size - ch.rx_received);
+        if (chunk + 1 > frame.can_dlc) {
+            return;
+        }
+        std::memcpy(pool_.data(ch.rx_buffer) + ch.rx_received, frame.data + 1, chunk);
+        ch.rx_received += chunk;
+        ch.rx_sn = static_cast<uint8_t>((ch.rx_sn + 1) & 0x0F);
+
+        if (ch.rx_received == ch.rx_size) {
+            // The buffer travels with the event and is released after the callback
+            events_.push_back(Event{index, IsoTpResult::OK, true, ch.rx_buffer, ch.rx_size, {}});
+            ++stats_.messages_received;
+            ch.rx_buffer = IsoTpBufferPool::NONE;
+            ch.rx_state = RxState::IDLE;
+            return;
+        }
+        ch.rx_deadline = now + ch.config.timeout;
+        if (ch.config.block_size != 0 && ++ch.rx_block_count == ch.config.block_size) {
+            ch.rx_block_count = 0;
+            if (!send_flow_control(ch, isotp::FlowStatus::CONTINUE)) {
+                abort_reception(index, IsoTpResult::SEND_ERROR);
+            }
+        }
+    }
+
+    void IsoTpEngine::handle_flow_control(std::size_t index, const struct can_frame& frame,
+        Clock::time_point now) {
+        Channel& ch = channels_[index];
+        if (ch.tx_state != TxState::WAIT_FC || frame.can_dlc < 3) {
+            return;
+        }
+        switch (static_cast<isotp::FlowStatus>(frame.data[0] & 0x0F)) {
+        case isotp::FlowStatus::CONTINUE:
+            ch.tx_state = TxState::SENDING;
+            ch.tx_block_size = frame.data[1];
+            ch.tx_block_remaining = frame.data[1];
+            ch.tx_st_min = isotp::stmin_to_duration(frame.data[2]);
+            ch.tx_deadline = now;
+            send_consecutive(index, now);
+            break;
+        case isotp::FlowStatus::WAIT:
+            if (++ch.tx_wait_count > ch.config.max_wait_frames) {
+                finish_send(index, IsoTpResult::WFT_OVERRUN);
+            } else {
+                ch.tx_deadline = now + ch.config.timeout;
+            }
+            break;
+        case isotp::FlowStatus::OVERFLOW:
+            finish_send(index, IsoTpResult::OVERFLOW);
+            break;
+        default:
+            finish_send(index, IsoTpResult::UNEXPECTED_PDU);
+            break;
+        }
+    }
+
+    void IsoTpEngine::abort_reception(std::size_t index, IsoTpResult result) {
+        Channel& ch = channels_[index];
+        pool_.release(ch.rx_buffer);
+        ch.rx_buffer = IsoTpBufferPool::NONE;
+        ch.rx_state = RxState::IDLE;
+        switch (result) {
+        case IsoTpResult::TIMEOUT_CR: ++stats_.timeouts; break;
+        case IsoTpResult::WRONG_SN: ++stats_.sequence_errors; break;
+        case IsoTpResult::UNEXPECTED_PDU: ++stats_.interrupted; break;
+        default: break;     // SEND_ERROR is already counted
+        }
+    }
+
+    // === Timers ===
+
+    IsoTpEngine::Clock::time_point IsoTpEngine::poll(Clock::time_point now) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        Clock::time_point next = Clock::time_point::max();
+        for (std::size_t i = 0; i < channels_.size(); ++i) {
+            Channel& ch = channels_[i];
+            if (ch.rx_state == RxState::RECEIVING) {
+                if (now >= ch.rx_deadline) {
+                    abort_reception(i, IsoTpResult::TIMEOUT_CR);
+                } else {
+                    next = std::min(next, ch.rx_deadline);
+                }
+            }
+            if (ch.tx_state == TxState::WAIT_FC && now >= ch.tx_deadline) {
+                finish_send(i, IsoTpResult::TIMEOUT_BS);
+            } else if (ch.tx_state == TxState::SENDING) {
+                send_consecutive(i, now);
+            }
+            if (ch.tx_state != TxState::IDLE) {
+                next = std::min(next, ch.tx_deadline);
+            }
+        }
+        dispatch_events(lock);
+        return next;
+    }
+
+    void IsoTpEngine::dispatch_events(std::unique_lock<std::mutex>& lock) {
+        if (events_.empty()) {
+            return;
+        }
+        std::vector<Event> events;
+        events.swap(events_);
+        auto on_receive = receive_callback_;
+        auto on_send = send_callback_;
+        lock.unlock();
+
+        // Callbacks may call send(); the buffers stay ours until released below
+        for (const Event& event : events) {
+            if (event.received) {
+                if (on_receive && *on_receive) {
+                    const uint8_t* data = event.buffer == IsoTpBufferPool::NONE
+                        ? event.single : pool_.data(event.buffer);
+                    (*on_receive)(event.channel, data, event.size);
+                }
+            } else if (on_send && *on_send) {
+                (*on_send)(event.channel, event.result);
+            }
+        }
+
+        lock.lock();
+        for (const Event& event : events) {
+            pool_.release(event.buffer);
+        }
+        if (events_.empty()) {
+            events.clear();
+            events_.swap(events);   // Keep the capacity for the next frame
+        }
+    }
+
+    // === Receive loop ===
+
+    void IsoTpEngine::start() {
+        if (!socket_) {
+            throw std::logic_error("IsoTpEngine::start: no socket, feed process() instead");
+        }
+        if (running_.exchange(true)) {
+            return;
+        }
+        thread_ = std::thread(&IsoTpEngine::receive_loop, this);
+    }
+
+    void IsoTpEngine::stop() {
+        running_ = false;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    void IsoTpEngine::receive_loop() {
+        const int fd = socket_->get_fd();
+        struct can_frame frame;
+
+        while (running_) {
+            Clock::time_point now = Clock::now();
+            Clock::time_point next = poll(now);
+            auto wait = std::chrono::duration_cast<std::chrono::nanoseconds>(config_.idle_wait);
+            if (next != Clock::time_point::max()) {
+                wait = std::min(wait, std::max(std::chrono::nanoseconds(0), next - now));
+            }
+
+            struct pollfd pfd{fd, POLLIN, 0};
+            struct timespec timeout{
+                static_cast<time_t>(wait.count() / 1000000000),
+                static_cast<long>(wait.count() % 1000000000)
+            };
+            int ready = ::ppoll(&pfd, 1, &timeout, nullptr);
+            if (ready < 0) {
+                if (errno != EINTR) {
+                    std::cerr << "[ISOTP] poll failed: " << std::strerror(errno) << std::endl;
+                    break;
+                }
+                continue;
+            }
+            if (ready > 0 && (pfd.revents & POLLIN) &&
+                socket_->receive(frame) == static_cast<ssize_t>(sizeof(frame))) {
+                process(frame);
+            }
+        }
+        running_ = false;
+    }
+
+}  // namespace waveshare
@@ -0,0 +1,297 @@
+/**
+ * @file load_generator.cpp
+ * @brief Paced CAN traffic generator implementation
+ * @version 1.0
+ * @date 2025-11-22
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#include "../include/pattern/load_generator.hpp"
+#include "../include/frame/fixed_frame.hpp"
+#include "../include/interface/socketcan_helpers.hpp"
+
+using json = nlohmann::json;
+
+namespace waveshare {
+
+    namespace {
+        // Remaining wait below which run() spins instead of sleeping
+        constexpr auto SPIN_THRESHOLD = std::chrono::microseconds(200);
+
+        std::uint32_t parse_id(const json& value) {
+            if (value.is_string()) {
+                std::string text = value.get<std::string>();
+                std::size_t pos = 0;
+                unsigned long id = std::stoul(text, &pos, 0);
+                if (pos != text.size()) {
+                    throw std::invalid_argument("Invalid CAN ID in load profile: " + text);
+                }
+                return static_cast<std::uint32_t>(id);
+            }
+            return value.get<std::uint32_t>();
+        }
+    }
+
+    // === LoadProfile ===
+
+    void LoadProfile::validate() const {
+        if (ids.empty() || dlcs.empty()) {
+            throw std::invalid_argument("Load profile needs at least one ID and one DLC");
+        }
+        for (const auto& entry : ids) {
+            if (entry.id > (entry.extended ? CAN_EFF_MASK : CAN_SFF_MASK)) {
+                throw std::invalid_argument("Load profile ID out of range: " +
+                    std::to_string(entry.id));
+            }
+            if (!(entry.weight > 0.0)) {
+                throw std::invalid_argument("Load profile weights must be positive");
+            }
+        }
+        for (const auto& entry : dlcs) {
+            if (entry.dlc > 8) {
+                throw std::invalid_argument("Load profile DLC must be 0-8, got " +
+                    std::to_string(entry.dlc));
+            }
+            if (!(entry.weight > 0.0)) {
+                throw std::invalid_argument("Load profile weights must be positive");
+            }
+        }
+    }
+
+    LoadProfile LoadProfile::single(std::uint32_t id, std::uint8_t dlc) {
+        LoadProfile profile;
+        profile.ids.push_back({id, id > CAN_SFF_MASK, 1.0});
+        profile.dlcs.push_back({dlc, 1.0});
+        return profile;
+    }
+
+    LoadProfile LoadProfile::from_json(const json& j) {
+        if (!j.contains("load_profile")) {
+            throw std::invalid_argument("JSON missing 'load_profile' section");
+        }
+        const auto& lp = j["load_profile"];
+
+        LoadProfile profile;
+        try {
+            for (const auto& entry : lp.at("ids")) {
+                std::uint32_t id = parse_id(entry.at("id"));
+                profile.ids.push_back({id, entry.value("extended", id > CAN_SFF_MASK),
+                                       entry.value("weight", 1.0)});
+            }
+            for (const auto& entry : lp.at("dlc")) {
+                profile.dlcs.push_back({entry.at("dlc").get<std::uint8_t>(),
+                                        entry.value("weight", 1.0)});
+            }
+        } catch (const json::exception& e) {
+            throw std::invalid_argument(std::string("Malformed load profile: ") + e.what());
+        }
+
+        profile.validate();
+        return profile;
+    }
+
+    LoadProfile LoadProfile::from_file(const std::string& filepath) {
+        std::ifstream file(filepath);
+        if (!file.is_open()) {
+            throw std::runtime_error("Cannot open load profile: " + filepath);
+        }
+
+        json j;
+        try {
+            file >> j;
+        } catch (const json::parse_error& e) {
+            throw std::runtime_error("JSON parse error in " + filepath + ": " + e.what());
+        }
+        return from_json(j);
+    }
+
+    // === LoadStatistics ===
+
+    double LoadStatistics::frame_rate() const {
+        if (elapsed.count() <= 0) {
+            return 0.0;
+        }
+        return static_cast<double>(frames_sent) * 1e6 / static_cast<double>(elapsed.count());
+    }
+
+    double LoadStatistics::bus_load_percent(CANBaud can_baud) const {
+        if (elapsed.count() <= 0) {
+            return 0.0;
+        }
+        double capacity = static_cast<double>(canbaud_to_int(can_baud)) *
+            static_cast<double>(elapsed.count()) / 1e6;
+        return 100.0 * static_cast<double>(bits_sent) / capacity;
+    }
+
+    // === LoadGenerator ===
+
+    LoadGenerator::LoadGenerator(const LoadProfile& profile, const LoadGeneratorConfig& config)
+        : config_(config) {
+        profile.validate();
+        if (config_.batch_size == 0 || config_.pool_size == 0) {
+            throw std::invalid_argument("LoadGenerator: batch and pool size must be > 0");
+        }
+        if (config_.bus_load_percent < 0.0 || config_.bus_load_percent > 100.0) {
+            throw std::invalid_argument("LoadGenerator: bus load must be 0-100%");
+        }
+        if (config_.bus_load_percent == 0.0 && config_.gap.count() <= 0) {
+            throw std::invalid_argument("LoadGenerator: gap must be > 0 without a bus load");
+        }
+
+        std::size_t batches = (config_.pool_size + config_.batch_size - 1) / config_.batch_size;
+        std::size_t pool = batches * config_.batch_size;
+
+        // Draw the pool
+        std::mt19937 rng(config_.seed);
+        std::vector<double> id_weights;
+        for (const auto& entry : profile.ids) id_weights.push_back(entry.weight);
+        std::vector<double> dlc_weights;
+        for (const auto& entry : profile.dlcs) dlc_weights.push_back(entry.weight);
+        std::discrete_distribution<std::size_t> pick_id(id_weights.begin(), id_weights.end());
+        std::discrete_distribution<std::size_t> pick_dlc(dlc_weights.begin(), dlc_weights.end());
+        std::uniform_int_distribution<int> pick_byte(0, 0xFF);
+
+        frames_.resize(pool);
+        offsets_.reserve(pool + 1);
+        encoded_.reserve(pool * (config_.fixed_frames ? 20 : 15));
+        for (auto& frame : frames_) {
+            std::memset(&frame, 0, sizeof(frame));
+            const auto& id = profile.ids[pick_id(rng)];
+            frame.can_id = id.extended ? (id.id | CAN_EFF_FLAG) : id.id;
+            frame.can_dlc = profile.dlcs[pick_dlc(rng)].dlc;
+            for (std::uint8_t i = 0; i < frame.can_dlc; ++i) {
+                frame.data[i] = static_cast<std::uint8_t>(pick_byte(rng));
+            }
+
+            std::vector<std::uint8_t> bytes;
+            if (config_.fixed_frames) {
+                bytes = FixedFrame(Format::DATA_FIXED,
+                    id.extended ? CANVersion::EXT_FIXED : CANVersion::STD_FIXED, id.id,
+                    span<const std::uint8_t>(frame.data, frame.can_dlc)).serialize();
+            } else {
+                bytes = SocketCANHelper::from_socketcan(frame).serialize();
+            }
+            offsets_.push_back(encoded_.size());
+            encoded_.insert(encoded_.end(), bytes.begin(), bytes.end());
+        }
+        offsets_.push_back(encoded_.size());
+
+        // Schedule: each frame owns a slot proportional to its bus time, or a fixed gap
+        const double bit_rate = canbaud_to_int(config_.can_baud);
+        bits_.assign(batches, 0);
+        periods_.assign(batches, Clock::duration::zero());
+        for (std::size_t i = 0; i < pool; ++i) {
+            bool extended = (frames_[i].can_id & CAN_EFF_FLAG) != 0;
+            std::uint32_t bits = can_frame_bits(frames_[i].can_dlc, extended);
+            Clock::duration slot = config_.gap;
+            if (config_.bus_load_percent > 0.0) {
+                slot = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(
+                    bits / (bit_rate * config_.bus_load_percent / 100.0)));
+            }
+            bits_[i / config_.batch_size] += bits;
+            periods_[i / config_.batch_size] += slot;
+            cycle_ += slot;
+        }
+    }
+
+    double LoadGenerator::target_frame_rate() const {
+        auto seconds = std::chrono::duration<double>(cycle_).count();
+        return seconds > 0.0 ? static_cast<double>(frames_.size()) / seconds : 0.0;
+    }
+
+    void LoadGenerator::wait_until(Clock::time_point deadline) {
+        auto now = Clock::now();
+        if (deadline - now > SPIN_THRESHOLD) {
+            std::this_thread::sleep_until(deadline - SPIN_THRESHOLD);
+        }
+        while (Clock::now() < deadline) {
+        }
+    }
+
+    LoadStatistics LoadGenerator::run(const SendFunction& send, const std::atomic<bool>& running,
+        const StatsCallback& on_stats) {
+        LoadStatistics total;
+        LoadStatistics interval;
+
+        const std::size_t batches = periods_.size();
+        const auto start = Clock::now();
+        auto deadline = start;
+        auto interval_start = start;
+        std::size_t batch = 0;
+        std::uint64_t failures = 0;
+
+        while (running.load(std::memory_order_relaxed) &&
+            (config_.count == 0 || total.frames_sent < config_.count)) {
+            wait_until(deadline);
+
+            // The last batch of a counted run may be partial
+            std::size_t first = batch * config_.batch_size;
+            std::size_t count = config_.batch_size;
+            if (config_.count > 0) {
+                count = static_cast<std::size_t>(std::min<std::uint64_t>(count,
+                    config_.count - total.frames_sent));
+            }
+
+            auto now = Clock::now();
+            auto lateness = std::chrono::duration_cast<std::chrono::microseconds>(now - deadline);
+            LoadBatch load_batch{&frames_[first], count, &encoded_[offsets_[first]],
+                                 offsets_[first + count] - offsets_[first]};
+
+            std::uint64_t bits = bits_[batch];
+            if (count < config_.batch_size) {
+                bits = 0;
+                for (std::size_t i = first; i < first + count; ++i) {
+                    bits += can_frame_bits(frames_[i].can_dlc,
+                        (frames_[i].can_id & CAN_EFF_FLAG) != 0);
+                }
+            }
+
+            bool sent = send(load_batch);
+            for (LoadStatistics* stats : {&total, &interval}) {
+                if (sent) {
+                    stats->frames_sent += count;
+                    stats->batches_sent += 1;
+                    stats->bytes_sent += load_batch.size;
+                    stats->bits_sent += bits;
+                } else {
+                    stats->send_errors += 1;
+                }
+                if (now - deadline > periods_[batch]) {
+                    stats->late_batches += 1;
+                }
+                stats->max_lateness = std::max(stats->max_lateness, lateness);
+            }
+
+            // Absolute schedule: the next deadline never depends on when this one was met
+            deadline += periods_[batch];
+            batch = (batch + 1) % batches;
+
+            failures = sent ? 0 : failures + 1;
+            if (config_.count > 0 && config_.max_send_failures > 0 &&
+                failures >= config_.max_send_failures) {
+                total.gave_up = true;
+                break;
+            }
+
+            if (on_stats && now - interval_start >= config_.stats_interval) {
+                interval.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                    now - interval_start);
+                total.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - start);
+                on_stats(interval, total);
+                interval = LoadStatistics();
+                interval_start = now;
+            }
+        }
+
+        total.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now() - start);
+        return total;
+    }
+
+}  // namespace waveshare
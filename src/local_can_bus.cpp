@@ -0,0 +1,398 @@
+/**
+ * @file local_can_bus.cpp
+ * @brief In-process loopback CAN bus implementation
+ * @version 1.0
+ * @date 2025-11-28
+ */
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include "../include/io/local_can_bus.hpp"
+#include "../include/exception/waveshare_exception.hpp"
+
+namespace waveshare {
+
+    namespace {
+        constexpr std::size_t CACHE_LINE = 64;
+
+        /**
+         * @brief Bounded multi-producer multi-consumer frame queue
+         *
+         * Each cell carries a sequence number telling producers and consumers
+         * whose turn it is, so push and pop are one CAS on a position counter
+         * plus a frame copy, with no lock.
+         */
+        class FrameRing {
+            public:
+                explicit FrameRing(std::size_t capacity) {
+                    std::size_t size = 1;
+                    while (size < capacity) {
+                        size <<= 1;
+                    }
+                    cells_.reset(new Cell[size]);
+                    mask_ = size - 1;
+                    for (std::size_t i = 0; i < size; ++i) {
+                        cells_[i].sequence.store(i, std::memory_order_relaxed);
+                    }
+                }
+
+                bool push(const struct can_frame& frame) {
+                    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+                    for (;;) {
+                        Cell& cell = cells_[pos & mask_];
+                        std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+                        auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+                        if (diff == 0) {
+                            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                std::memory_order_relaxed)) {
+                                cell.frame = frame;
+                                cell.sequence.store(pos + 1, std::memory_order_release);
+                                return true;
+                            }
+                        } else if (diff < 0) {
+                            return false;   // Full
+                        } else {
+                            pos = enqueue_pos_.load(std::memory_order_relaxed);
+                        }
+                    }
+                }
+
+                bool pop(struct can_frame& frame) {
+                    std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+                    for (;;) {
+                        Cell& cell = cells_[pos & mask_];
+                        std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+                        auto diff = static_cast<std::ptrdiff_t>(seq) -
+                            static_cast<std::ptrdiff_t>(pos + 1);
+                        if (diff == 0) {
+                            if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                std::memory_order_relaxed)) {
+                                frame = cell.frame;
+                                cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                                return true;
+                            }
+                        } else if (diff < 0) {
+                            return false;   // Empty
+                        } else {
+                            pos = dequeue_pos_.load(std::memory_order_relaxed);
+                        }
+                    }
+                }
+
+                /**
+                 * @brief Claimed slots, including pushes still being copied
+                 */
+                std::size_t size() const {
+                    std::size_t tail = enqueue_pos_.load(std::memory_order_seq_cst);
+                    std::size_t head = dequeue_pos_.load(std::memory_order_seq_cst);
+                    return tail > head ? tail - head : 0;
+                }
+
+            private:
+                struct Cell {
+                    std::atomic<std::size_t> sequence;
+                    struct can_frame frame;
+                };
+
+                std::unique_ptr<Cell[]> cells_;
+                std::size_t mask_ = 0;
+                alignas(CACHE_LINE) std::atomic<std::size_t> enqueue_pos_{0};
+                alignas(CACHE_LINE) std::atomic<std::size_t> dequeue_pos_{0};
+        };
+    }
+
+    /**
+     * @brief Endpoint state shared by its socket and the bus snapshots
+     *
+     * The eventfd is "armed" (readable) from the first frame of a burst until
+     * a receiver finds the queue empty, so senders write it once per burst.
+     */
+    struct LocalCANEndpoint {
+        explicit LocalCANEndpoint(const LocalCANSocketConfig& config)
+            : ring(config.queue_capacity), timeout_ms(config.timeout_ms),
+            filters(config.filters), error_mask(config.error_mask),
+            receive_own(config.receive_own) {
+            event_fd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+            if (event_fd < 0) {
+                throw DeviceException(Status::DCONFIG_ERROR,
+                    "LocalCANBus: eventfd failed: " + std::string(std::strerror(errno)));
+            }
+        }
+
+        ~LocalCANEndpoint() {
+            ::close(event_fd);
+        }
+
+        void signal() {
+            if (!armed.exchange(true)) {
+                std::uint64_t one = 1;
+                ssize_t ignored = ::write(event_fd, &one, sizeof(one));
+                (void)ignored;
+            }
+        }
+
+        /**
+         * @brief Clear the eventfd, re-arming it if frames raced in
+         */
+        void quiesce() {
+            armed.store(false);
+            std::uint64_t value;
+            ssize_t ignored = ::read(event_fd, &value, sizeof(value));
+            if (ring.size() > 0) {
+                armed.store(true);
+                std::uint64_t one = 1;
+                ignored = ::write(event_fd, &one, sizeof(one));
+            }
+            (void)ignored;
+        }
+
+        bool take(struct can_frame& frame) {
+            if (!ring.pop(frame)) {
+                quiesce();
+                if (!ring.pop(frame)) {
+                    return false;
+                }
+            }
+            if (ring.size() == 0) {
+                quiesce();
+            }
+            return true;
+        }
+
+        FrameRing ring;
+        int event_fd = -1;
+        int timeout_ms;
+        std::atomic<bool> armed{false};
+        std::atomic<bool> open{true};
+
+        alignas(CACHE_LINE) std::atomic<std::uint64_t> tx_frames{0};
+        alignas(CACHE_LINE) std::atomic<std::uint64_t> rx_frames{0};
+        std::atomic<std::uint64_t> rx_dropped{0};
+
+        // Receive options, changed under the bus mutex and copied into Routes
+        std::vector<struct can_filter> filters;
+        can_err_mask_t error_mask;
+        bool receive_own;
+    };
+
+    /**
+     * @brief Immutable view of the bus used by send()
+     */
+    struct LocalCANBus::Routes {
+        struct Route {
+            LocalCANEndpoint* endpoint;
+            std::vector<struct can_filter> filters;
+            can_err_mask_t error_mask;
+            bool receive_own;
+
+            bool accepts(const struct can_frame& frame) const {
+                if (frame.can_id & CAN_ERR_FLAG) {
+                    return (frame.can_id & error_mask & CAN_ERR_MASK) != 0;
+                }
+                for (const auto& filter : filters) {
+                    const bool inverted = (filter.can_id & CAN_INV_FILTER) != 0;
+                    const bool match = (frame.can_id & filter.can_mask) ==
+                        (filter.can_id & ~CAN_INV_FILTER & filter.can_mask);
+                    if (match != inverted) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+        };
+
+        std::vector<Route> routes;
+        std::vector<std::shared_ptr<LocalCANEndpoint>> keep_alive;
+    };
+
+    // === LocalCANBus ===
+
+    LocalCANBus::LocalCANBus(const std::string& name)
+        : name_(name), routes_(std::make_shared<const Routes>()) {}
+
+    LocalCANBus::~LocalCANBus() = default;
+
+    std::shared_ptr<LocalCANBus> LocalCANBus::create(const std::string& name) {
+        return std::shared_ptr<LocalCANBus>(new LocalCANBus(name));
+    }
+
+    std::shared_ptr<LocalCANSocket> LocalCANBus::open(const LocalCANSocketConfig& config) {
+        if (config.queue_capacity == 0) {
+            throw std::invalid_argument("LocalCANBus: queue capacity must be > 0");
+        }
+        auto endpoint = std::make_shared<LocalCANEndpoint>(config);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            endpoints_.push_back(endpoint);
+            publish();
+        }
+        return std::shared_ptr<LocalCANSocket>(
+            new LocalCANSocket(shared_from_this(), std::move(endpoint)));
+    }
+
+    std::size_t LocalCANBus::endpoint_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return endpoints_.size();
+    }
+
+    void LocalCANBus::publish() {
+        auto routes = std::make_shared<Routes>();
+        routes->routes.reserve(endpoints_.size());
+        for (const auto& endpoint : endpoints_) {
+            routes->routes.push_back({endpoint.get(), endpoint->filters,
+                                      endpoint->error_mask, endpoint->receive_own});
+        }
+        routes->keep_alive = endpoints_;
+        std::atomic_store(&routes_, std::shared_ptr<const Routes>(std::move(routes)));
+    }
+
+    void LocalCANBus::detach(const LocalCANEndpoint* endpoint) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        endpoints_.erase(std::remove_if(endpoints_.begin(), endpoints_.end(),
+            [endpoint](const auto& e) { return e.get() == endpoint; }), endpoints_.end());
+        publish();
+    }
+
+    void LocalCANBus::deliver(const LocalCANEndpoint* sender, const struct can_frame& frame) const {
+        auto snapshot = std::atomic_load(&routes_);
+        for (const auto& route : snapshot->routes) {
+            if (route.endpoint == sender && !route.receive_own) {
+                continue;
+            }
+            if (!route.accepts(frame)) {
+                continue;
+            }
+            if (route.endpoint->ring.push(frame)) {
+                route.endpoint->rx_frames.fetch_add(1, std::memory_order_relaxed);
+                route.endpoint->signal();
+            } else {
+                route.endpoint->rx_dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // === LocalCANSocket ===
+
+    LocalCANSocket::LocalCANSocket(std::shared_ptr<LocalCANBus> bus,
+        std::shared_ptr<LocalCANEndpoint> endpoint)
+        : bus_(std::move(bus)), endpoint_(std::move(endpoint)) {}
+
+    LocalCANSocket::~LocalCANSocket() {
+        close();
+    }
+
+    void LocalCANSocket::close() {
+        if (!endpoint_->open.exchange(false)) {
+            return;
+        }
+        bus_->detach(endpoint_.get());
+        // Wake receivers blocked in poll(); they then see the socket closed
+        std::uint64_t one = 1;
+        ssize_t ignored = ::write(endpoint_->event_fd, &one, sizeof(one));
+        (void)ignored;
+    }
+
+    bool LocalCANSocket::is_open() const {
+        return endpoint_->open.load();
+    }
+
+    std::string LocalCANSocket::get_interface_name() const {
+        return bus_->get_name();
+    }
+
+    int LocalCANSocket::get_fd() const {
+        return endpoint_->open.load() ? endpoint_->event_fd : -1;
+    }
+
+    ssize_t LocalCANSocket::send(const struct can_frame& frame) {
+        if (!endpoint_->open.load(std::memory_order_relaxed)) {
+            errno = ENOTCONN;
+            return -1;
+        }
+        if (frame.can_dlc > CAN_MAX_DLEN) {
+            errno = EINVAL;
+            return -1;
+        }
+        bus_->deliver(endpoint_.get(), frame);
+        endpoint_->tx_frames.fetch_add(1, std::memory_order_relaxed);
+        return static_cast<ssize_t>(sizeof(frame));
+    }
+
+    ssize_t LocalCANSocket::receive(struct can_frame& frame) {
+        LocalCANEndpoint& endpoint = *endpoint_;
+        if (!endpoint.open.load(std::memory_order_relaxed)) {
+            errno = ENOTCONN;
+            return -1;
+        }
+        if (endpoint.take(frame)) {
+            return static_cast<ssize_t>(sizeof(frame));
+        }
+
+        using Clock = std::chrono::steady_clock;
+        const auto deadline = Clock::now() + std::chrono::milliseconds(endpoint.timeout_ms);
+        for (;;) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - Clock::now()).count();
+            if (remaining <= 0) {
+                errno = EAGAIN;
+                return -1;
+            }
+            struct pollfd pfd = {endpoint.event_fd, POLLIN, 0};
+            if (::poll(&pfd, 1, static_cast<int>(remaining)) < 0 && errno != EINTR) {
+                return -1;
+            }
+            if (!endpoint.open.load()) {
+                errno = ENOTCONN;
+                return -1;
+            }
+            if (endpoint.take(frame)) {
+                return static_cast<ssize_t>(sizeof(frame));
+            }
+        }
+    }
+
+    void LocalCANSocket::set_filters(const std::vector<struct can_filter>& filters) {
+        std::lock_guard<std::mutex> lock(bus_->mutex_);
+        endpoint_->filters = filters;
+        if (endpoint_->open.load()) {
+            bus_->publish();
+        }
+    }
+
+    void LocalCANSocket::set_error_filter(can_err_mask_t mask) {
+        std::lock_guard<std::mutex> lock(bus_->mutex_);
+        endpoint_->error_mask = mask;
+        if (endpoint_->open.load()) {
+            bus_->publish();
+        }
+    }
+
+    void LocalCANSocket::set_receive_own(bool enable) {
+        std::lock_guard<std::mutex> lock(bus_->mutex_);
+        endpoint_->receive_own = enable;
+        if (endpoint_->open.load()) {
+            bus_->publish();
+        }
+    }
+
+    LocalCANSocketStatistics LocalCANSocket::get_statistics() const {
+        LocalCANSocketStatistics stats;
+        stats.tx_frames = endpoint_->tx_frames.load(std::memory_order_relaxed);
+        stats.rx_frames = endpoint_->rx_frames.load(std::memory_order_relaxed);
+        stats.rx_dropped = endpoint_->rx_dropped.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    std::size_t LocalCANSocket::pending() const {
+        return endpoint_->ring.size();
+    }
+
+}  // namespace waveshare
@@ -19,7 +19,7 @@
 #include "../include/interface/socketcan_helpers.hpp"
 #include "../include/exception/waveshare_exception.hpp"
 #include "../include/pattern/frame_builder.hpp"
-#include "../include/io/real_can_socket.hpp"
+#include "../include/io/io_backend.hpp"
 
 namespace waveshare {
 
@@ -34,6 +34,7 @@ namespace waveshare {
 
         // Validate configuration
         config_.validate();
+        rules_ = GatewayRuleEngine(config_.rules);
 
         // Validate injected dependencies
         if (!can_socket_ || !can_socket_->is_open()) {
@@ -51,16 +52,18 @@ namespace waveshare {
         // Validate configuration first
         config.validate();
 
-        // Create real CAN socket (auto-opens and configures)
-        auto can_socket = std::make_unique<RealCANSocket>(
+        // Create CAN socket (auto-opens and configures)
+        auto can_socket = open_can_socket(
             config.socketcan_interface,
-            config.socketcan_read_timeout_ms
+            static_cast<int>(config.socketcan_read_timeout_ms),
+            config.io_backend
         );
 
         // Create USB adapter (auto-opens and configures)
         auto usb_adapter = USBAdapter::create(
             config.usb_device_path,
-            config.serial_baud_rate
+            config.serial_baud_rate,
+            config.io_backend
         );
 
         // Configure USB adapter for CAN
@@ -170,6 +173,8 @@ namespace waveshare {
         snapshot.socketcan_rx_errors = stats_.socketcan_rx_errors.load(std::memory_order_relaxed);
         snapshot.socketcan_tx_errors = stats_.socketcan_tx_errors.load(std::memory_order_relaxed);
         snapshot.conversion_errors = stats_.conversion_errors.load(std::memory_order_relaxed);
+        snapshot.rule_rewrites = stats_.rule_rewrites.load(std::memory_order_relaxed);
+        snapshot.rule_drops = stats_.rule_drops.load(std::memory_order_relaxed);
 
         return snapshot;
     }
@@ -212,6 +217,20 @@ namespace waveshare {
 
     // === Forwarding Threads ===
 
+    bool SocketCANBridge::apply_rules(RuleDirection direction, struct can_frame& cf) {
+        switch (rules_.apply(direction, cf)) {
+        case GatewayRuleEngine::Verdict::PASS:
+            return true;
+        case GatewayRuleEngine::Verdict::REWRITTEN:
+            stats_.rule_rewrites.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        case GatewayRuleEngine::Verdict::DROP:
+            stats_.rule_drops.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
     void SocketCANBridge::usb_to_socketcan_loop() {
         while (running_.load(std::memory_order_relaxed)) {
             try {
@@ -222,6 +241,11 @@ namespace waveshare {
                 // Convert to SocketCAN format
                 struct can_frame cf = SocketCANHelper::to_socketcan(frame);
 
+                // Apply gateway rules
+                if (!apply_rules(RuleDirection::USB_TO_CAN, cf)) {
+                    continue;
+                }
+
                 // Write to CAN socket
                 ssize_t bytes = can_socket_->send(cf);
                 if (bytes != sizeof(struct can_frame)) {
@@ -300,6 +324,11 @@ namespace waveshare {
 
                 stats_.socketcan_rx_frames.fetch_add(1, std::memory_order_relaxed);
 
+                // Apply gateway rules
+                if (!apply_rules(RuleDirection::CAN_TO_USB, cf)) {
+                    continue;
+                }
+
                 // Convert to Waveshare VariableFrame
                 auto frame = SocketCANHelper::from_socketcan(cf);
 
@@ -0,0 +1,105 @@
+/**
+ * @file uring_can_socket.cpp
+ * @brief io_uring CAN socket implementation
+ * @version 1.0
+ * @date 2025-11-29
+ */
+
+#include <cerrno>
+#include <chrono>
+#include <vector>
+
+#include "../include/io/uring_can_socket.hpp"
+#include "../include/io/real_can_socket.hpp"
+
+namespace waveshare {
+
+    IoUringStreamConfig UringCANSocket::stream_config() {
+        IoUringStreamConfig config;
+        config.socket = true;
+        config.ring_entries = 256;
+        config.read_buffers = 1024;
+        config.read_buffer_size = sizeof(struct can_frame);
+        config.write_slots = 128;
+        config.write_slot_size = sizeof(struct can_frame);
+        return config;
+    }
+
+    UringCANSocket::UringCANSocket(const std::string& interface, int timeout_ms)
+        : UringCANSocket(std::make_unique<RealCANSocket>(interface, timeout_ms), timeout_ms) {}
+
+    UringCANSocket::UringCANSocket(std::unique_ptr<ICANSocket> socket, int timeout_ms)
+        : socket_(std::move(socket)), timeout_ms_(timeout_ms) {
+        if (!socket_ || !socket_->is_open()) {
+            throw DeviceException(Status::DNOT_OPEN, "UringCANSocket: socket not open");
+        }
+        stream_ = std::make_unique<IoUringStream>(socket_->get_fd(), stream_config());
+    }
+
+    UringCANSocket::~UringCANSocket() {
+        close();
+    }
+
+    ssize_t UringCANSocket::send(const struct can_frame& frame) {
+        return send_batch(&frame, 1) == 1 ? static_cast<ssize_t>(sizeof(frame)) : -1;
+    }
+
+    std::size_t UringCANSocket::send_batch(const struct can_frame* frames, std::size_t count) {
+        if (!stream_) {
+            errno = ENOTCONN;
+            return 0;
+        }
+        std::vector<struct iovec> messages(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            messages[i].iov_base = const_cast<struct can_frame*>(&frames[i]);
+            messages[i].iov_len = sizeof(struct can_frame);
+        }
+        return stream_->write_batch(messages.data(), count);
+    }
+
+    ssize_t UringCANSocket::receive(struct can_frame& frame) {
+        if (!stream_) {
+            errno = ENOTCONN;
+            return -1;
+        }
+
+        using Clock = std::chrono::steady_clock;
+        const auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms_);
+        for (;;) {
+            ssize_t bytes = stream_->read(&frame, sizeof(frame), true);
+            if (bytes != 0) {
+                return bytes;
+            }
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - Clock::now()).count();
+            if (remaining <= 0 || !stream_->wait_readable(static_cast<int>(remaining))) {
+                errno = EAGAIN;
+                return -1;
+            }
+        }
+    }
+
+    bool UringCANSocket::is_open() const {
+        return stream_ && socket_->is_open();
+    }
+
+    void UringCANSocket::close() {
+        stream_.reset();
+        if (socket_) {
+            socket_->close();
+        }
+    }
+
+    std::string UringCANSocket::get_interface_name() const {
+        return socket_->get_interface_name();
+    }
+
+    int UringCANSocket::get_fd() const {
+        return stream_ ? stream_->get_event_fd() : -1;
+    }
+
+    IoUringStreamStatistics UringCANSocket::get_statistics() const {
+        return stream_ ? stream_->get_statistics() : IoUringStreamStatistics{};
+    }
+
+}  // namespace waveshare
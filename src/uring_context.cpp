@@ -0,0 +1,562 @@
+/**
+ * @file uring_context.cpp
+ * @brief io_uring ring and stream implementation (raw syscalls)
+ * @version 1.0
+ * @date 2025-11-29
+ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#include "../include/io/uring_context.hpp"
+#include "../include/exception/waveshare_exception.hpp"
+
+namespace waveshare {
+
+    namespace {
+        // IORING_OP_READ_MULTISHOT (Linux 6.7) is newer than some uapi headers
+        constexpr std::uint8_t OP_READ_MULTISHOT = 49;
+
+        constexpr std::uint64_t READ_TAG = 1;
+        constexpr std::uint64_t WRITE_TAG = 1ULL << 32;   ///< + write slot
+
+        int sys_setup(unsigned entries, struct io_uring_params* params) {
+            return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+        }
+
+        int sys_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags,
+            const void* arg, std::size_t arg_size) {
+            return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+                flags, arg, arg_size));
+        }
+
+        int sys_register(int fd, unsigned opcode, const void* arg, unsigned nr_args) {
+            return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+        }
+
+        [[noreturn]] void throw_errno(const std::string& what) {
+            throw DeviceException(Status::DCONFIG_ERROR,
+                "io_uring: " + what + ": " + std::strerror(errno));
+        }
+
+        template<typename T>
+        T* at(void* base, std::uint32_t offset) {
+            return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+        }
+    }
+
+    // === IoUringContext ===
+
+    IoUringContext::IoUringContext(unsigned entries) {
+        ring_fd_ = sys_setup(entries, &params_);
+        if (ring_fd_ < 0) {
+            throw_errno("setup");
+        }
+
+        const bool single_mmap = (params_.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        sq_ring_size_ = params_.sq_off.array + params_.sq_entries * sizeof(unsigned);
+        cq_ring_size_ = params_.cq_off.cqes + params_.cq_entries * sizeof(struct io_uring_cqe);
+        if (single_mmap) {
+            sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        }
+
+        sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+        if (sq_ring_ == MAP_FAILED) {
+            sq_ring_ = nullptr;
+            ::close(ring_fd_);
+            throw_errno("mmap SQ ring");
+        }
+        if (single_mmap) {
+            cq_ring_ = sq_ring_;
+        } else {
+            cq_ring_ = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+            if (cq_ring_ == MAP_FAILED) {
+                cq_ring_ = nullptr;
+                ::munmap(sq_ring_, sq_ring_size_);
+                ::close(ring_fd_);
+                throw_errno("mmap CQ ring");
+            }
+        }
+        sqes_size_ = params_.sq_entries * sizeof(struct io_uring_sqe);
+        void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            if (!single_mmap) {
+                ::munmap(cq_ring_, cq_ring_size_);
+            }
+            ::munmap(sq_ring_, sq_ring_size_);
+            ::close(ring_fd_);
+            throw_errno("mmap SQEs");
+        }
+        sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+
+        sq_head_ = at<unsigned>(sq_ring_, params_.sq_off.head);
+        sq_tail_ = at<unsigned>(sq_ring_, params_.sq_off.tail);
+        sq_mask_ = *at<unsigned>(sq_ring_, params_.sq_off.ring_mask);
+        sqe_tail_ = *sq_tail_;
+        unsigned* array = at<unsigned>(sq_ring_, params_.sq_off.array);
+        for (unsigned i = 0; i < params_.sq_entries; ++i) {
+            array[i] = i;   // SQE i always sits in slot i
+        }
+        cq_head_ = at<unsigned>(cq_ring_, params_.cq_off.head);
+        cq_tail_ = at<unsigned>(cq_ring_, params_.cq_off.tail);
+        cq_mask_ = *at<unsigned>(cq_ring_, params_.cq_off.ring_mask);
+        cqes_ = at<struct io_uring_cqe>(cq_ring_, params_.cq_off.cqes);
+
+        // Opcode probe; an old kernel without it simply reports nothing
+        std::vector<std::uint8_t> buffer(sizeof(struct io_uring_probe) +
+            256 * sizeof(struct io_uring_probe_op));
+        auto* probe = reinterpret_cast<struct io_uring_probe*>(buffer.data());
+        probe_.assign(256, 0);
+        if (sys_register(ring_fd_, IORING_REGISTER_PROBE, probe, 256) == 0) {
+            for (unsigned i = 0; i < probe->ops_len; ++i) {
+                probe_[probe->ops[i].op] = (probe->ops[i].flags & IO_URING_OP_SUPPORTED) ? 1 : 0;
+            }
+        }
+    }
+
+    IoUringContext::~IoUringContext() {
+        if (buffer_ring_) {
+            ::munmap(buffer_ring_, buffer_ring_size_);
+        }
+        ::munmap(sqes_, sqes_size_);
+        if (cq_ring_ != sq_ring_) {
+            ::munmap(cq_ring_, cq_ring_size_);
+        }
+        ::munmap(sq_ring_, sq_ring_size_);
+        ::close(ring_fd_);
+    }
+
+    bool IoUringContext::is_supported() {
+        static const bool supported = []() {
+            try {
+                IoUringContext ring(4);
+                if (!(ring.params_.features & IORING_FEAT_EXT_ARG) ||
+                    !ring.supports(IORING_OP_READ) || !ring.supports(IORING_OP_RECV) ||
+                    !ring.supports(IORING_OP_WRITE_FIXED)) {
+                    return false;
+                }
+                ring.setup_buffer_ring(1, 16);
+                return true;
+            } catch (const std::exception&) {
+                return false;
+            }
+        }();
+        return supported;
+    }
+
+    bool IoUringContext::supports(std::uint8_t opcode) const {
+        return probe_[opcode] != 0;
+    }
+
+    struct io_uring_sqe* IoUringContext::get_sqe() {
+        unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+        if (sqe_tail_ - head >= params_.sq_entries) {
+            return nullptr;
+        }
+        struct io_uring_sqe* sqe = &sqes_[sqe_tail_ & sq_mask_];
+        ++sqe_tail_;
+        std::memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    int IoUringContext::submit(unsigned wait_nr, int timeout_ms) {
+        unsigned to_submit = sqe_tail_ - *sq_tail_;
+        __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+        if (to_submit == 0 && wait_nr == 0) {
+            return 0;
+        }
+
+        unsigned flags = wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0;
+        struct __kernel_timespec ts {};
+        struct io_uring_getevents_arg arg {};
+        const void* arg_ptr = nullptr;
+        std::size_t arg_size = 0;
+        if (wait_nr > 0 && timeout_ms >= 0) {
+            ts.tv_sec = timeout_ms / 1000;
+            ts.tv_nsec = static_cast<long long>(timeout_ms % 1000) * 1000000;
+            arg.ts = reinterpret_cast<std::uint64_t>(&ts);
+            flags |= IORING_ENTER_EXT_ARG;
+            arg_ptr = &arg;
+            arg_size = sizeof(arg);
+        }
+        ++enter_calls_;
+        return sys_enter(ring_fd_, to_submit, wait_nr, flags, arg_ptr, arg_size);
+    }
+
+    void IoUringContext::register_buffers(const struct iovec* buffers, unsigned count) {
+        if (sys_register(ring_fd_, IORING_REGISTER_BUFFERS, buffers, count) < 0) {
+            throw_errno("register buffers");
+        }
+    }
+
+    void IoUringContext::register_eventfd(int fd) {
+        if (sys_register(ring_fd_, IORING_REGISTER_EVENTFD, &fd, 1) < 0) {
+            throw_errno("register eventfd");
+        }
+    }
+
+    void IoUringContext::setup_buffer_ring(unsigned count, unsigned size) {
+        if (count == 0 || (count & (count - 1)) != 0 || count > 32768) {
+            throw std::invalid_argument("io_uring: buffer count must be a power of two <= 32768");
+        }
+        buffer_ring_size_ = count * sizeof(struct io_uring_buf);
+        buffer_ring_ = ::mmap(nullptr, buffer_ring_size_, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (buffer_ring_ == MAP_FAILED) {
+            buffer_ring_ = nullptr;
+            throw_errno("mmap buffer ring");
+        }
+
+        struct io_uring_buf_reg reg {};
+        reg.ring_addr = reinterpret_cast<std::uint64_t>(buffer_ring_);
+        reg.ring_entries = count;
+        reg.bgid = 0;
+        if (sys_register(ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+            ::munmap(buffer_ring_, buffer_ring_size_);
+            buffer_ring_ = nullptr;
+            throw_errno("register buffer ring");
+        }
+
+        buffer_mask_ = count - 1;
+        buffer_size_ = size;
+        buffer_data_.assign(static_cast<std::size_t>(count) * size, 0);
+        for (unsigned i = 0; i < count; ++i) {
+            recycle(static_cast<std::uint16_t>(i));
+        }
+    }
+
+    void IoUringContext::recycle(std::uint16_t id) {
+        // Index the entries directly: in C++ the header's flexible bufs[]
+        // member sits after an empty struct and does not start at offset 0
+        auto* bufs = static_cast<struct io_uring_buf*>(buffer_ring_);
+        auto* tail = reinterpret_cast<std::uint16_t*>(static_cast<std::uint8_t*>(buffer_ring_) +
+            offsetof(struct io_uring_buf_ring, tail));
+        // Field by field: entry 0 overlays the ring tail
+        struct io_uring_buf& buf = bufs[buffer_tail_ & buffer_mask_];
+        buf.addr = reinterpret_cast<std::uint64_t>(buffer(id));
+        buf.len = buffer_size_;
+        buf.bid = id;
+        ++buffer_tail_;
+        __atomic_store_n(tail, buffer_tail_, __ATOMIC_RELEASE);
+    }
+
+    // === IoUringStream ===
+
+    IoUringStream::IoUringStream(int fd, const IoUringStreamConfig& config)
+        : fd_(fd), config_(config), ring_(config.ring_entries) {
+        if (fd_ < 0) {
+            throw DeviceException(Status::DNOT_OPEN, "IoUringStream: descriptor not open");
+        }
+        if (config_.write_slots == 0 || config_.write_slot_size == 0 ||
+            config_.write_slots >= config_.ring_entries) {
+            throw std::invalid_argument("IoUringStream: need 0 < write_slots < ring_entries");
+        }
+
+        event_fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (event_fd_ < 0) {
+            throw_errno("eventfd");
+        }
+        try {
+            ring_.register_eventfd(event_fd_);
+            ring_.setup_buffer_ring(config_.read_buffers, config_.read_buffer_size);
+            write_data_.assign(static_cast<std::size_t>(config_.write_slots) *
+                config_.write_slot_size, 0);
+            struct iovec iov = {write_data_.data(), write_data_.size()};
+            ring_.register_buffers(&iov, 1);
+        } catch (...) {
+            ::close(event_fd_);
+            throw;
+        }
+        write_results_.assign(config_.write_slots, 0);
+
+        // Let the kernel park reads on the descriptor instead of failing them
+        original_flags_ = ::fcntl(fd_, F_GETFL);
+        if (original_flags_ >= 0 && (original_flags_ & O_NONBLOCK)) {
+            ::fcntl(fd_, F_SETFL, original_flags_ & ~O_NONBLOCK);
+        }
+
+        // Sockets learn about multishot recv from the first completion
+        multishot_ = config_.multishot &&
+            (config_.socket || ring_.supports(OP_READ_MULTISHOT));
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        arm_read();
+        ring_.submit();
+    }
+
+    IoUringStream::~IoUringStream() {
+        // Destroying the ring (after this body) cancels the armed read
+        if (original_flags_ >= 0) {
+            ::fcntl(fd_, F_SETFL, original_flags_);
+        }
+        ::close(event_fd_);
+    }
+
+    void IoUringStream::arm_read() {
+        if (read_armed_ || read_error_ != 0 || starved_) {
+            return;
+        }
+        struct io_uring_sqe* sqe = ring_.get_sqe();
+        if (!sqe) {
+            return;     // Re-armed on the next drain
+        }
+        sqe->fd = fd_;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = 0;
+        sqe->user_data = READ_TAG;
+        if (config_.socket) {
+            sqe->opcode = IORING_OP_RECV;
+            if (multishot_) {
+                sqe->ioprio = IORING_RECV_MULTISHOT;
+            }
+        } else {
+            sqe->opcode = multishot_ ? OP_READ_MULTISHOT : static_cast<__u8>(IORING_OP_READ);
+            sqe->off = ~0ULL;   // Current position; ignored by streams
+        }
+        read_armed_ = true;
+        ++stats_.read_arms;
+    }
+
+    void IoUringStream::drain_completions() {
+        ring_.reap([this](const struct io_uring_cqe& cqe) {
+            if (cqe.user_data >= WRITE_TAG) {
+                write_results_[cqe.user_data - WRITE_TAG] = cqe.res;
+                --writes_pending_;
+                ++stats_.write_completions;
+                return;
+            }
+
+            ++stats_.read_completions;
+            const bool has_buffer = (cqe.flags & IORING_CQE_F_BUFFER) != 0;
+            const auto buffer = static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+            if (cqe.res > 0 && has_buffer) {
+                chunks_.push_back({buffer, 0, static_cast<std::uint32_t>(cqe.res)});
+            } else if (has_buffer) {
+                ring_.recycle(buffer);
+            }
+            if (cqe.flags & IORING_CQE_F_MORE) {
+                return;
+            }
+
+            read_armed_ = false;
+            if (cqe.res == -EINVAL && multishot_) {
+                multishot_ = false;     // Kernel without multishot for this opcode
+            } else if (cqe.res == -ENOBUFS) {
+                starved_ = true;        // Re-armed once read() frees a buffer
+            } else if (cqe.res == 0) {
+                read_error_ = ENOTCONN; // End of file: the peer or device is gone
+            } else if (cqe.res < 0 && cqe.res != -EAGAIN && cqe.res != -EINTR) {
+                read_error_ = -cqe.res;
+            }
+        });
+        stats_.multishot = multishot_;
+
+        if (!read_armed_) {
+            arm_read();
+            if (read_armed_ && writes_pending_ == 0) {
+                ring_.submit();
+            }
+        }
+    }
+
+    void IoUringStream::quiesce() {
+        std::uint64_t value;
+        ssize_t ignored = ::read(event_fd_, &value, sizeof(value));
+        drain_completions();
+        if (!chunks_.empty() || read_error_ != 0) {
+            std::uint64_t one = 1;
+            ignored = ::write(event_fd_, &one, sizeof(one));
+        }
+        (void)ignored;
+    }
+
+    ssize_t IoUringStream::read(void* data, std::size_t len, bool whole_chunk) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (chunks_.empty()) {
+            drain_completions();
+        }
+        if (chunks_.empty()) {
+            if (read_error_ != 0) {
+                errno = read_error_;
+                return -1;
+            }
+            quiesce();
+            return 0;
+        }
+
+        auto* out = static_cast<std::uint8_t*>(data);
+        std::size_t copied = 0;
+        while (copied < len && !chunks_.empty()) {
+            Chunk& chunk = chunks_.front();
+            std::size_t n = std::min<std::size_t>(len - copied, chunk.length - chunk.offset);
+            std::memcpy(out + copied, ring_.buffer(chunk.buffer) + chunk.offset, n);
+            copied += n;
+            chunk.offset += static_cast<std::uint32_t>(n);
+            if (whole_chunk || chunk.offset == chunk.length) {
+                ring_.recycle(chunk.buffer);
+                chunks_.pop_front();
+                if (starved_) {
+                    starved_ = false;
+                    arm_read();
+                    ring_.submit();
+                }
+            }
+            if (whole_chunk) {
+                break;
+            }
+        }
+        if (chunks_.empty()) {
+            quiesce();
+        }
+        return static_cast<ssize_t>(copied);
+    }
+
+    bool IoUringStream::wait_readable(int timeout_ms) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (chunks_.empty()) {
+                quiesce();
+            }
+            if (!chunks_.empty() || read_error_ != 0) {
+                return true;
+            }
+        }
+        struct pollfd pfd = {event_fd_, POLLIN, 0};
+        return ::poll(&pfd, 1, timeout_ms) > 0;
+    }
+
+    std::size_t IoUringStream::run_writes(unsigned count, std::size_t* bytes) {
+        writes_pending_ = count;
+        std::fill(write_results_.begin(), write_results_.begin() + count, 0);
+        while (writes_pending_ > 0) {
+            if (ring_.submit(1) < 0 && errno != EINTR) {
+                write_error_ = errno;
+                break;
+            }
+            drain_completions();
+        }
+        if (writes_pending_ > 0) {
+            // The kernel refused the batch: nothing more will complete
+            writes_pending_ = 0;
+            errno = write_error_;
+            return 0;
+        }
+        if (!read_armed_) {
+            arm_read();
+            ring_.submit();
+        }
+
+        std::size_t complete = 0;
+        for (unsigned i = 0; i < count; ++i) {
+            std::int32_t result = write_results_[i];
+            if (result < 0) {
+                errno = -result;
+                break;
+            }
+            *bytes += static_cast<std::size_t>(result);
+            ++complete;
+        }
+        return complete;
+    }
+
+    ssize_t IoUringStream::write(const void* data, std::size_t len) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto* in = static_cast<const std::uint8_t*>(data);
+        std::size_t written = 0;
+        while (written < len) {
+            unsigned ops = 0;
+            std::size_t batch = 0;
+            struct io_uring_sqe* last = nullptr;
+            for (; ops < config_.write_slots && written + batch < len; ++ops) {
+                std::size_t n = std::min<std::size_t>(config_.write_slot_size, len - written - batch);
+                std::uint8_t* slot = write_data_.data() +
+                    static_cast<std::size_t>(ops) * config_.write_slot_size;
+                std::memcpy(slot, in + written + batch, n);
+
+                struct io_uring_sqe* sqe = ring_.get_sqe();
+                sqe->opcode = IORING_OP_WRITE_FIXED;
+                sqe->fd = fd_;
+                sqe->addr = reinterpret_cast<std::uint64_t>(slot);
+                sqe->len = static_cast<std::uint32_t>(n);
+                sqe->off = ~0ULL;
+                sqe->buf_index = 0;
+                sqe->user_data = WRITE_TAG + ops;
+                sqe->flags = IOSQE_IO_LINK;     // Keep the byte order
+                last = sqe;
+                batch += n;
+            }
+            last->flags = 0;    // The chain ends with this batch
+            std::size_t bytes = 0;
+            run_writes(ops, &bytes);
+            written += bytes;
+            if (bytes < batch) {
+                break;
+            }
+        }
+        if (written == 0 && len > 0) {
+            return -1;
+        }
+        return static_cast<ssize_t>(written);
+    }
+
+    std::size_t IoUringStream::write_batch(const struct iovec* messages, std::size_t count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::size_t sent = 0;
+        while (sent < count) {
+            unsigned ops = 0;
+            struct io_uring_sqe* last = nullptr;
+            for (; ops < config_.write_slots && sent + ops < count; ++ops) {
+                const struct iovec& message = messages[sent + ops];
+                if (message.iov_len > config_.write_slot_size) {
+                    break;
+                }
+                std::uint8_t* slot = write_data_.data() +
+                    static_cast<std::size_t>(ops) * config_.write_slot_size;
+                std::memcpy(slot, message.iov_base, message.iov_len);
+
+                struct io_uring_sqe* sqe = ring_.get_sqe();
+                sqe->opcode = IORING_OP_WRITE_FIXED;
+                sqe->fd = fd_;
+                sqe->addr = reinterpret_cast<std::uint64_t>(slot);
+                sqe->len = static_cast<std::uint32_t>(message.iov_len);
+                sqe->off = ~0ULL;
+                sqe->buf_index = 0;
+                sqe->user_data = WRITE_TAG + ops;
+                sqe->flags = IOSQE_IO_LINK;     // Keep the frame order
+                last = sqe;
+            }
+            if (ops == 0) {
+                errno = EMSGSIZE;
+                break;
+            }
+            last->flags = 0;
+            std::size_t bytes = 0;
+            std::size_t complete = run_writes(ops, &bytes);
+            sent += complete;
+            if (complete < ops) {
+                break;
+            }
+        }
+        return sent;
+    }
+
+    IoUringStreamStatistics IoUringStream::get_statistics() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        IoUringStreamStatistics stats = stats_;
+        stats.enter_calls = ring_.enter_calls();
+        return stats;
+    }
+
+}  // namespace waveshare
@@ -0,0 +1,92 @@
+/**
+ * @file uring_serial_port.cpp
+ * @brief io_uring serial port implementation
+ * @version 1.0
+ * @date 2025-11-29
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+
+#include "../include/io/uring_serial_port.hpp"
+#include "../include/io/real_serial_port.hpp"
+
+namespace waveshare {
+
+    UringSerialPort::UringSerialPort(const std::string& device_path, SerialBaud baud_rate,
+        const IoUringStreamConfig& config)
+        : UringSerialPort(std::make_unique<RealSerialPort>(device_path, baud_rate), config) {}
+
+    UringSerialPort::UringSerialPort(std::unique_ptr<ISerialPort> port,
+        const IoUringStreamConfig& config)
+        : port_(std::move(port)) {
+        if (!port_ || !port_->is_open()) {
+            throw DeviceException(Status::DNOT_OPEN, "UringSerialPort: port not open");
+        }
+        IoUringStreamConfig stream_config = config;
+        stream_config.socket = false;
+        stream_ = std::make_unique<IoUringStream>(port_->get_fd(), stream_config);
+    }
+
+    UringSerialPort::~UringSerialPort() {
+        close();
+    }
+
+    ssize_t UringSerialPort::write(const void* data, std::size_t len) {
+        if (!stream_) {
+            errno = ENOTCONN;
+            return -1;
+        }
+        return stream_->write(data, len);
+    }
+
+    ssize_t UringSerialPort::read(void* data, std::size_t len, int timeout_ms) {
+        if (!stream_) {
+            errno = ENOTCONN;
+            return -1;
+        }
+        // Every completion wakes wait_readable(), write ones included: wait
+        // again until data arrives or the timeout is spent
+        using Clock = std::chrono::steady_clock;
+        const auto deadline = Clock::now() + std::chrono::milliseconds(std::max(timeout_ms, 0));
+        for (;;) {
+            ssize_t bytes = stream_->read(data, len);
+            if (bytes != 0) {
+                return bytes;
+            }
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - Clock::now()).count();
+            if (remaining <= 0 || !stream_->wait_readable(static_cast<int>(remaining))) {
+                // Same contract as RealSerialPort's non-blocking read
+                errno = EAGAIN;
+                return -1;
+            }
+        }
+    }
+
+    bool UringSerialPort::is_open() const {
+        return stream_ && port_->is_open();
+    }
+
+    void UringSerialPort::close() {
+        // Tear the ring down first: it cancels the read still armed on the fd
+        stream_.reset();
+        if (port_) {
+            port_->close();
+        }
+    }
+
+    std::string UringSerialPort::get_device_path() const {
+        return port_->get_device_path();
+    }
+
+    int UringSerialPort::get_fd() const {
+        return stream_ ? stream_->get_event_fd() : -1;
+    }
+
+    IoUringStreamStatistics UringSerialPort::get_statistics() const {
+        return stream_ ? stream_->get_statistics() : IoUringStreamStatistics{};
+    }
+
+}  // namespace waveshare
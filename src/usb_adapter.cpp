@@ -10,7 +10,10 @@
  */
 
 #include "../include/pattern/usb_adapter.hpp"
-#include "../include/io/real_serial_port.hpp"
+#include "../include/pattern/frame_builder.hpp"
+#include <algorithm>
+#include <poll.h>
+#include <thread>
 
 
 namespace waveshare {
@@ -35,9 +38,9 @@ namespace waveshare {
     }
 
     std::unique_ptr<USBAdapter> USBAdapter::create(const std::string& usb_dev,
-        SerialBaud baudrate) {
+        SerialBaud baudrate, IoBackend backend) {
         // Create real serial port (auto-opens and configures)
-        auto serial_port = std::make_unique<RealSerialPort>(usb_dev, baudrate);
+        auto serial_port = open_serial_port(usb_dev, baudrate, backend);
 
         // Create adapter with injected port
         return std::unique_ptr<USBAdapter>(new USBAdapter(std::move(serial_port), usb_dev,
@@ -141,6 +144,20 @@ namespace waveshare {
 
 
 
+    int USBAdapter::receive_bytes(std::uint8_t* buffer, std::size_t size, int timeout_ms) {
+        int bytes_read = read_bytes(buffer, size);
+        if (bytes_read > 0 || timeout_ms <= 0) {
+            return bytes_read;
+        }
+
+        // Nothing queued: sleep in the kernel until the port is readable
+        struct pollfd pfd = {get_fd(), POLLIN, 0};
+        if (pfd.fd < 0 || ::poll(&pfd, 1, timeout_ms) <= 0) {
+            return 0;
+        }
+        return read_bytes(buffer, size);
+    }
+
     // === Frame-Level API ===
 
 
@@ -214,4 +231,136 @@ namespace waveshare {
         }
     }
 
-}
\ No newline at end of file
+    // === CAN Bit-Rate Detection ===
+
+    namespace {
+        // Most common rates first: CANopen and industrial buses cluster at the top
+        constexpr CANBaud AUTOBAUD_ORDER[] = {
+            CANBaud::BAUD_1M, CANBaud::BAUD_500K, CANBaud::BAUD_250K, CANBaud::BAUD_125K,
+            CANBaud::BAUD_800K, CANBaud::BAUD_100K, CANBaud::BAUD_50K, CANBaud::BAUD_20K,
+            CANBaud::BAUD_10K, CANBaud::BAUD_400K, CANBaud::BAUD_200K, CANBaud::BAUD_5K
+        };
+    }
+
+    void USBAdapter::configure_can(CANBaud baud_rate, CANMode mode, RTX auto_rtx,
+        std::uint32_t filter, std::uint32_t mask, std::chrono::milliseconds settle) {
+        // Variable-length frames, as everything else in this class speaks
+        send_frame(make_config_frame()
+            .with_baud_rate(baud_rate)
+            .with_mode(mode)
+            .with_rtx(auto_rtx)
+            .with_filter(filter)
+            .with_mask(mask)
+            .build());
+        if (settle.count() > 0) {
+            std::this_thread::sleep_for(settle);
+        }
+    }
+
+    void USBAdapter::discard_input() {
+        // Bounded: on a busy bus the adapter never runs dry
+        std::uint8_t buffer[64];
+        for (std::size_t dropped = 0; dropped < 4096; ) {
+            int count = read_bytes(buffer, sizeof(buffer));
+            if (count <= 0) {
+                break;
+            }
+            dropped += static_cast<std::size_t>(count);
+        }
+    }
+
+    AutobaudResult USBAdapter::autobaud(const AutobaudConfig& config) {
+        using Clock = std::chrono::steady_clock;
+
+        if (config.initial_window.count() <= 0 || config.max_window < config.initial_window ||
+            config.frames_required == 0) {
+            throw ProtocolException(Status::WBAD_DATA, "autobaud: invalid configuration");
+        }
+
+        // Candidate order: last detected rate, then the caller's (or default) order
+        struct Candidate {
+            CANBaud baud;
+            std::size_t frames;
+        };
+        std::vector<Candidate> candidates;
+        auto add = [&](CANBaud baud) {
+                for (const auto& candidate : candidates) {
+                    if (candidate.baud == baud) return;
+                }
+                candidates.push_back({baud, 0});
+            };
+        if (auto previous = detected_can_baud()) {
+            add(*previous);
+        }
+        if (config.candidates.empty()) {
+            for (CANBaud baud : AUTOBAUD_ORDER) add(baud);
+        } else {
+            for (CANBaud baud : config.candidates) add(baud);
+        }
+
+        AutobaudResult result;
+        const auto start = Clock::now();
+
+        auto window = config.initial_window;
+        while (true) {
+            for (auto& candidate : candidates) {
+                configure_can(candidate.baud, CANMode::SILENT, config.auto_rtx, 0, 0,
+                    config.settle);
+                discard_input();
+                ++result.attempts;
+
+                // Listen until enough frames, a malformed frame or the window ends
+                candidate.frames = 0;
+                const auto deadline = Clock::now() + window;
+                while (candidate.frames < config.frames_required) {
+                    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        deadline - Clock::now()).count();
+                    if (remaining <= 0) {
+                        break;
+                    }
+                    try {
+                        receive_variable_frame(static_cast<int>(remaining));
+                        ++candidate.frames;
+                    } catch (const TimeoutException&) {
+                        break;
+                    } catch (const ProtocolException&) {
+                        ++result.errors;
+                        break;
+                    }
+                }
+
+                if (candidate.frames >= config.frames_required) {
+                    result.detected = true;
+                    result.baud_rate = candidate.baud;
+                    result.frames = candidate.frames;
+                    break;
+                }
+            }
+
+            if (result.detected || window >= config.max_window) {
+                break;
+            }
+            window = std::min(window * 2, config.max_window);
+
+            // Rates that produced some valid frames are the most likely ones
+            std::stable_sort(candidates.begin(), candidates.end(),
+                [](const Candidate& a, const Candidate& b) { return a.frames > b.frames; });
+        }
+
+        result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            Clock::now() - start);
+
+        if (result.detected) {
+            {
+                std::unique_lock<std::shared_mutex> lock(state_mutex_);
+                detected_can_baud_ = result.baud_rate;
+            }
+            if (config.final_mode != CANMode::SILENT || config.filter != 0 || config.mask != 0) {
+                configure_can(result.baud_rate, config.final_mode, config.auto_rtx, config.filter,
+                    config.mask, config.settle);
+            }
+        }
+        return result;
+    }
+
+}
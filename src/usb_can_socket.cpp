@@ -0,0 +1,203 @@
+/**
+ * @file usb_can_socket.cpp
+ * @brief USB adapter backed CAN socket implementation
+ * @version 1.0
+ * @date 2025-11-27
+ */
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include "../include/io/usb_can_socket.hpp"
+#include "../include/pattern/usb_adapter.hpp"
+#include "../include/template/frame_traits.hpp"
+
+namespace waveshare {
+
+    namespace {
+        // One serial read: many frames, decoded in a single pass
+        constexpr std::size_t READ_CHUNK = 4096;
+    }
+
+    USBCANSocket::USBCANSocket(std::shared_ptr<USBAdapter> adapter,
+        const USBCANSocketConfig& config)
+        : adapter_(std::move(adapter)), config_(config) {
+        if (!adapter_ || !adapter_->is_open()) {
+            throw DeviceException(Status::DNOT_OPEN, "USBCANSocket: USB adapter not open");
+        }
+        if (config_.queue_capacity == 0) {
+            throw std::invalid_argument("USBCANSocket: queue capacity must be > 0");
+        }
+        interface_name_ = config_.interface_name.empty()
+            ? adapter_->get_usb_device() : config_.interface_name;
+
+        event_fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (event_fd_ < 0) {
+            throw DeviceException(Status::DCONFIG_ERROR,
+                "USBCANSocket: eventfd failed: " + std::string(std::strerror(errno)));
+        }
+        ring_.resize(config_.queue_capacity);
+
+        open_ = true;
+        reader_ = std::thread(&USBCANSocket::reader_loop, this);
+    }
+
+    USBCANSocket::~USBCANSocket() {
+        close();
+    }
+
+    void USBCANSocket::close() {
+        if (!open_.exchange(false)) {
+            return;
+        }
+        not_empty_.notify_all();
+        if (reader_.joinable()) {
+            reader_.join();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        ::close(event_fd_);
+        event_fd_ = -1;
+        count_ = 0;
+    }
+
+    // === Transmit ===
+
+    std::size_t USBCANSocket::encode_variable(const struct can_frame& frame, std::uint8_t* out) {
+        using Layout = VariableFrameLayout;
+        const bool extended = (frame.can_id & CAN_EFF_FLAG) != 0;
+        const bool remote = (frame.can_id & CAN_RTR_FLAG) != 0;
+        const std::uint8_t dlc = frame.can_dlc > CAN_MAX_DLEN ? CAN_MAX_DLEN : frame.can_dlc;
+        const std::uint32_t id = frame.can_id & (extended ? CAN_EFF_MASK : CAN_SFF_MASK);
+
+        // TYPE: 11 EXT RTR DLC(4)
+        out[Layout::START] = to_byte(Constants::START_BYTE);
+        out[Layout::TYPE] = static_cast<std::uint8_t>(0xC0 | (extended ? 0x20 : 0) |
+            (remote ? 0x10 : 0) | dlc);
+        for (std::size_t i = 0; i < Layout::id_size(extended); ++i) {
+            out[Layout::ID + i] = static_cast<std::uint8_t>(id >> (8 * i));
+        }
+        std::memcpy(out + Layout::data_offset(extended), frame.data, dlc);
+        out[Layout::end_offset(extended, dlc)] = to_byte(Constants::END_BYTE);
+        return Layout::frame_size(extended, dlc);
+    }
+
+    ssize_t USBCANSocket::send(const struct can_frame& frame) {
+        if (!open_) {
+            errno = ENOTCONN;
+            return -1;
+        }
+        std::uint8_t buffer[VariableFrameLayout::frame_size(true, CAN_MAX_DLEN)];
+        std::size_t size = encode_variable(frame, buffer);
+        try {
+            adapter_->send_encoded(buffer, size);
+        } catch (const std::exception& e) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++stats_.tx_errors;
+            }
+            std::cerr << "[USBCAN] Send error: " << e.what() << std::endl;
+            errno = EIO;
+            return -1;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.tx_frames;
+        return static_cast<ssize_t>(sizeof(frame));
+    }
+
+    // === Receive ===
+
+    ssize_t USBCANSocket::receive(struct can_frame& frame) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (count_ == 0 && open_) {
+            not_empty_.wait_for(lock, std::chrono::milliseconds(config_.receive_timeout_ms),
+                [this] { return count_ > 0 || !open_; });
+        }
+        if (!open_) {
+            errno = ENOTCONN;
+            return -1;
+        }
+        if (count_ == 0) {
+            errno = EAGAIN;
+            return -1;
+        }
+
+        frame = ring_[head_];
+        head_ = (head_ + 1) % ring_.size();
+        if (--count_ == 0) {
+            // Queue drained: clear the eventfd so poll() stops reporting it
+            std::uint64_t value;
+            ssize_t ignored = ::read(event_fd_, &value, sizeof(value));
+            (void)ignored;
+        }
+        return static_cast<ssize_t>(sizeof(frame));
+    }
+
+    void USBCANSocket::enqueue(const std::vector<struct can_frame>& frames) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const bool was_empty = count_ == 0;
+        for (const auto& frame : frames) {
+            if (count_ == ring_.size()) {
+                ++stats_.rx_dropped;
+                continue;
+            }
+            ring_[(head_ + count_) % ring_.size()] = frame;
+            ++count_;
+        }
+        stats_.rx_frames += frames.size();
+        if (was_empty && count_ > 0) {
+            std::uint64_t one = 1;
+            ssize_t ignored = ::write(event_fd_, &one, sizeof(one));
+            (void)ignored;
+            not_empty_.notify_all();
+        }
+    }
+
+    void USBCANSocket::reader_loop() {
+        FrameStreamDecoder decoder(config_.mode);
+        std::vector<std::uint8_t> buffer(READ_CHUNK);
+        std::vector<struct can_frame> frames;
+        frames.reserve(READ_CHUNK / VariableFrameLayout::frame_size(false, 0));
+
+        while (open_) {
+            int bytes;
+            try {
+                bytes = adapter_->receive_bytes(buffer.data(), buffer.size(),
+                    config_.read_timeout_ms);
+            } catch (const std::exception& e) {
+                std::cerr << "[USBCAN] Adapter read error: " << e.what() << std::endl;
+                std::this_thread::sleep_for(std::chrono::milliseconds(config_.read_timeout_ms));
+                continue;
+            }
+            if (bytes <= 0) {
+                continue;
+            }
+
+            frames.clear();
+            std::uint64_t errors_before = decoder.get_statistics().decode_errors;
+            decoder.decode(buffer.data(), static_cast<std::size_t>(bytes), frames);
+            if (!frames.empty()) {
+                enqueue(frames);
+            }
+            std::uint64_t errors = decoder.get_statistics().decode_errors - errors_before;
+            if (errors > 0) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stats_.decode_errors += errors;
+            }
+        }
+    }
+
+    USBCANSocketStatistics USBCANSocket::get_statistics() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    std::size_t USBCANSocket::pending() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return count_;
+    }
+
+}  // namespace waveshare
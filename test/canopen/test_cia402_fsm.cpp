@@ -0,0 +1,291 @@
+/**
+ * @file test_cia402_fsm.cpp
+ * @brief Unit tests for the event-driven (PDO) mode of the CIA402 state machine
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-16
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "canopen/cia402_fsm.hpp"
+#include "canopen/emcy_consumer.hpp"
+#include "canopen/pdo_manager.hpp"
+#include "canopen/sdo_client.hpp"
+#include "canopen/object_dictionary.hpp"
+#include "test_utils_canopen.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+using namespace canopen;
+using namespace test_utils;
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+namespace {
+    constexpr uint8_t NODE_ID = 1;
+
+    bool is_sdo_controlword_write(const can_frame& frame) {
+        return frame.can_id == 0x600u + NODE_ID && (frame.data[0] & 0xE0) == 0x20 &&
+               frame.data[1] == 0x40 && frame.data[2] == 0x60;
+    }
+}
+
+// =============================================================================
+// Test Fixture
+// =============================================================================
+
+struct CIA402FSMFixture {
+    std::string config_path = "/tmp/canopen_test/test_cia402_fsm.json";
+    std::unique_ptr<ObjectDictionary> dict;
+    std::shared_ptr<PollableMockCANSocket> sdo_socket = std::make_shared<PollableMockCANSocket>();
+    std::shared_ptr<PollableMockCANSocket> pdo_socket = std::make_shared<PollableMockCANSocket>();
+    PDOManager manager{pdo_socket};
+    MockCIA402Drive drive{NODE_ID};
+
+    CIA402FSMFixture() {
+        std::filesystem::create_directories("/tmp/canopen_test");
+        drive.attach(*sdo_socket, *pdo_socket);
+        REQUIRE(manager.start());
+    }
+
+    ~CIA402FSMFixture() {
+        manager.stop();
+        std::filesystem::remove(config_path);
+    }
+
+    void load(const std::string& rpdo1_objects, const std::string& tpdo1_objects) {
+        std::ofstream config_file(config_path);
+        config_file << R"({
+            "node_id": 1,
+            "objects": {
+                "controlword": {"index": "0x6040", "subindex": 0, "datatype": "uint16_t",
+                                "access": "rw", "pdo_mapping": "rpdo1"},
+                "target_velocity": {"index": "0x60FF", "subindex": 0, "datatype": "int32_t",
+                                    "access": "rw", "pdo_mapping": "rpdo1"},
+                "statusword": {"index": "0x6041", "subindex": 0, "datatype": "uint16_t",
+                               "access": "ro", "pdo_mapping": "tpdo1"},
+                "position_actual": {"index": "0x6064", "subindex": 0, "datatype": "int32_t",
+                                    "access": "ro", "pdo_mapping": "tpdo1"}
+            },
+            "pdo_configuration": {
+                "rpdo1": {"cob_id": "0x200", "transmission_type": 255,
+                          "objects": [)" << rpdo1_objects << R"(]},
+                "tpdo1": {"cob_id": "0x180", "transmission_type": 255,
+                          "objects": [)" << tpdo1_objects << R"(]}
+            }
+        })";
+        config_file.close();
+        dict = std::make_unique<ObjectDictionary>(config_path);
+    }
+
+    std::size_t count_sent(PollableMockCANSocket& socket, bool (*pred)(const can_frame&)) {
+        auto history = socket.get_tx_history();
+        return static_cast<std::size_t>(std::count_if(history.begin(), history.end(), pred));
+    }
+};
+
+// =============================================================================
+// PDO Mode
+// =============================================================================
+
+TEST_CASE_METHOD(CIA402FSMFixture, "CIA402FSM: PDO mode transitions",
+    "[cia402_fsm][pdo]") {
+    load(R"("controlword")", R"("statusword", "position_actual")");
+    SDOClient sdo(sdo_socket, *dict, NODE_ID);
+    CIA402FSM fsm(sdo, *dict);
+
+    SECTION("Statusword from TPDO1 completes each transition without polling") {
+        REQUIRE(fsm.enable_pdo_mode(manager));
+        REQUIRE(fsm.is_pdo_mode());
+
+        // Drive reports its current state before any command
+        can_frame initial;
+        drive.make_tpdo(drive.statusword(), initial);
+        pdo_socket->inject(initial);
+        REQUIRE(wait_until([&] { return manager.get_statistics(NODE_ID).tpdo1_received == 1; }));
+        sdo_socket->clear_tx_history();
+
+        REQUIRE(fsm.enable_operation());
+        REQUIRE(fsm.get_current_state() == cia402::State::OPERATION_ENABLED);
+        REQUIRE(fsm.get_fallback_polls() == 0);
+
+        // Controlword went by RPDO1, nothing by SDO
+        std::vector<uint16_t> controlwords;
+        for (const auto& frame : pdo_socket->get_tx_history()) {
+            if (frame.can_id == 0x200u + NODE_ID) {
+                REQUIRE(frame.can_dlc == 2);
+                controlwords.push_back(frame.data[0] | (frame.data[1] << 8));
+            }
+        }
+        REQUIRE(controlwords == std::vector<uint16_t>{0x0006, 0x0007, 0x000F});
+        REQUIRE(sdo_socket->get_tx_history().empty());
+    }
+
+    SECTION("Silent TPDO falls back to SDO polling") {
+        drive.emit_tpdo = false;
+        fsm.set_fallback_poll_interval(std::chrono::milliseconds(5));
+        REQUIRE(fsm.enable_pdo_mode(manager));
+
+        REQUIRE(fsm.enable_operation());
+        REQUIRE(fsm.get_current_state() == cia402::State::OPERATION_ENABLED);
+        REQUIRE(fsm.get_fallback_polls() >= 3);
+        REQUIRE(count_sent(*sdo_socket, is_sdo_controlword_write) == 0);
+    }
+
+    SECTION("FAULT reported by TPDO aborts the wait immediately") {
+        drive.fault_on_enable = true;
+        fsm.set_state_timeout(std::chrono::milliseconds(2000));
+        REQUIRE(fsm.enable_pdo_mode(manager));
+
+        auto start = std::chrono::steady_clock::now();
+        REQUIRE_FALSE(fsm.enable_operation());
+        REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1000));
+        REQUIRE(fsm.get_current_state() == cia402::State::FAULT);
+    }
+
+    SECTION("Fault reset is not failed by the FAULT it clears") {
+        drive.fault_on_enable = true;
+        REQUIRE(fsm.enable_pdo_mode(manager));
+        REQUIRE_FALSE(fsm.enable_operation());
+        REQUIRE(fsm.get_current_state() == cia402::State::FAULT);
+
+        // The reset is only seen by the next poll; the cached FAULT
+        // predates the reset command and must not end the wait
+        drive.fault_on_enable = false;
+        drive.emit_tpdo = false;
+        fsm.set_fallback_poll_interval(std::chrono::milliseconds(5));
+        REQUIRE(fsm.reset_fault());
+        REQUIRE(fsm.get_current_state() == cia402::State::SWITCH_ON_DISABLED);
+        REQUIRE(fsm.enable_operation());
+    }
+
+    SECTION("Forwarded statusword drives transitions without subscribing") {
+        drive.emit_tpdo = false;
+        REQUIRE(fsm.enable_pdo_mode(manager, false));
+        fsm.on_statusword(drive.statusword());
+
+        // Forward the drive's state as another component owning TPDO1 would
+        std::atomic<bool> forwarding{true};
+        std::thread forwarder([&] {
+                while (forwarding) {
+                    fsm.on_statusword(drive.statusword());
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            });
+
+        REQUIRE(fsm.shutdown());
+        forwarding = false;
+        forwarder.join();
+        REQUIRE(fsm.get_fallback_polls() == 0);
+    }
+
+    SECTION("Leaving PDO mode restores SDO control") {
+        REQUIRE(fsm.enable_pdo_mode(manager));
+        fsm.disable_pdo_mode();
+        REQUIRE_FALSE(fsm.is_pdo_mode());
+
+        REQUIRE(fsm.shutdown());
+        REQUIRE(count_sent(*sdo_socket, is_sdo_controlword_write) == 1);
+    }
+}
+
+TEST_CASE_METHOD(CIA402FSMFixture, "CIA402FSM: PDO mode mapping checks",
+    "[cia402_fsm][pdo]") {
+    SECTION("Statusword must be mapped to TPDO1") {
+        load(R"("controlword")", R"("position_actual")");
+        SDOClient sdo(sdo_socket, *dict, NODE_ID);
+        CIA402FSM fsm(sdo, *dict);
+
+        REQUIRE_FALSE(fsm.enable_pdo_mode(manager));
+        REQUIRE_FALSE(fsm.is_pdo_mode());
+    }
+
+    SECTION("Controlword shared with other RPDO1 objects stays on SDO") {
+        load(R"("controlword", "target_velocity")", R"("statusword", "position_actual")");
+        SDOClient sdo(sdo_socket, *dict, NODE_ID);
+        CIA402FSM fsm(sdo, *dict);
+
+        REQUIRE(fsm.enable_pdo_mode(manager));
+        REQUIRE(fsm.enable_operation());
+
+        REQUIRE(count_sent(*sdo_socket, is_sdo_controlword_write) == 3);
+        REQUIRE(count_sent(*pdo_socket, [](const can_frame& f) {
+                return f.can_id == 0x200u + NODE_ID;
+            }) == 0);
+    }
+}
+
+// =============================================================================
+// Emergency (EMCY) Monitoring
+// =============================================================================
+
+TEST_CASE_METHOD(CIA402FSMFixture, "CIA402FSM: Emergency ends a pending transition",
+    "[cia402_fsm][emcy]") {
+    load(R"("controlword")", R"("statusword", "position_actual")");
+    SDOClient sdo(sdo_socket, *dict, NODE_ID);
+    CIA402FSM fsm(sdo, *dict);
+
+    auto emcy_socket = std::make_shared<PollableMockCANSocket>();
+    EMCYConsumer emcy(emcy_socket);
+    fsm.attach_emcy(emcy);
+    REQUIRE(emcy.start());
+
+    // The drive never completes the transition; only the emergency can end the wait
+    drive.transition_delay = std::chrono::milliseconds(10000);
+    fsm.set_state_timeout(std::chrono::milliseconds(3000));
+
+    auto send_emcy = [&](uint16_t error_code) {
+            can_frame frame{};
+            frame.can_id = 0x080 + NODE_ID;
+            frame.can_dlc = 8;
+            frame.data[0] = error_code & 0xFF;
+            frame.data[1] = error_code >> 8;
+            frame.data[2] = 0x03;
+            emcy_socket->inject(frame);
+        };
+
+    auto shutdown_with_emcy = [&] {
+            std::thread producer([&] {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                    send_emcy(0x2310);
+                });
+            auto start = std::chrono::steady_clock::now();
+            bool result = fsm.shutdown();
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            producer.join();
+            REQUIRE_FALSE(result);
+            REQUIRE(elapsed < std::chrono::milliseconds(1000));
+        };
+
+    SECTION("SDO mode") {
+        shutdown_with_emcy();
+        REQUIRE(fsm.get_emergency_code() == 0x2310);
+    }
+
+    SECTION("PDO mode") {
+        REQUIRE(fsm.enable_pdo_mode(manager));
+        shutdown_with_emcy();
+        REQUIRE(fsm.get_emergency_code() == 0x2310);
+        REQUIRE(fsm.get_current_state() == cia402::State::FAULT);
+    }
+
+    SECTION("Error reset clears the code, detached FSM ignores emergencies") {
+        fsm.on_emergency(0x4210);
+        REQUIRE(fsm.get_emergency_code() == 0x4210);
+        send_emcy(0x0000);
+        REQUIRE(wait_until([&] { return fsm.get_emergency_code() == 0; }));
+
+        fsm.detach_emcy();
+        send_emcy(0x5000);
+        REQUIRE(wait_until([&] { return emcy.emergency_count(NODE_ID) == 2; }));
+        REQUIRE(fsm.get_emergency_code() == 0);
+    }
+
+    emcy.stop();
+}
@@ -0,0 +1,292 @@
+/**
+ * @file test_cia402_group.cpp
+ * @brief Unit tests for parallel multi-drive CIA402 orchestration
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-16
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "canopen/cia402_group.hpp"
+#include "canopen/cia402_fsm.hpp"
+#include "canopen/pdo_manager.hpp"
+#include "canopen/sdo_client.hpp"
+#include "canopen/object_dictionary.hpp"
+#include "test_utils_canopen.hpp"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace canopen;
+using namespace test_utils;
+
+// =============================================================================
+// Test Fixture
+// =============================================================================
+
+struct CIA402GroupFixture {
+    static constexpr uint8_t AXES = 8;
+
+    std::string config_path = "/tmp/canopen_test/test_cia402_group.json";
+    std::unique_ptr<ObjectDictionary> dict;
+
+    // One SDO socket and client per axis, one shared PDO bus
+    std::shared_ptr<PollableMockCANSocket> pdo_socket = std::make_shared<PollableMockCANSocket>();
+    PDOManager manager{pdo_socket};
+    std::vector<std::unique_ptr<MockCIA402Drive>> drives;
+    std::vector<std::shared_ptr<PollableMockCANSocket>> sdo_sockets;
+    std::vector<std::unique_ptr<SDOClient>> clients;
+    std::vector<std::unique_ptr<CIA402FSM>> fsms;
+    CIA402Group group;
+
+    CIA402GroupFixture() {
+        std::filesystem::create_directories("/tmp/canopen_test");
+        std::ofstream config_file(config_path);
+        config_file << R"({
+            "node_id": 1,
+            "objects": {
+                "controlword": {"index": "0x6040", "subindex": 0, "datatype": "uint16_t",
+                                "access": "rw", "pdo_mapping": "rpdo1"},
+                "statusword": {"index": "0x6041", "subindex": 0, "datatype": "uint16_t",
+                               "access": "ro", "pdo_mapping": "tpdo1"},
+                "position_actual": {"index": "0x6064", "subindex": 0, "datatype": "int32_t",
+                                    "access": "ro", "pdo_mapping": "tpdo1"}
+            },
+            "pdo_configuration": {
+                "rpdo1": {"cob_id": "0x200", "transmission_type": 255,
+                          "objects": ["controlword"]},
+                "tpdo1": {"cob_id": "0x180", "transmission_type": 255,
+                          "objects": ["statusword", "position_actual"]}
+            }
+        })";
+        config_file.close();
+        dict = std::make_unique<ObjectDictionary>(config_path);
+
+        for (uint8_t node = 1; node <= AXES; ++node) {
+            drives.push_back(std::make_unique<MockCIA402Drive>(node));
+            auto socket = std::make_shared<PollableMockCANSocket>();
+            MockCIA402Drive* drive = drives.back().get();
+            socket->set_responder([drive](const can_frame& request, can_frame& reply) {
+                    return drive->respond_sdo(request, reply);
+                });
+            sdo_sockets.push_back(socket);
+        }
+
+        // Route RPDO1 on the shared bus to the addressed drive
+        pdo_socket->set_responder([this](const can_frame& request, can_frame& reply) {
+                for (auto& drive : drives) {
+                    if (drive->respond_pdo(request, reply)) return true;
+                }
+                return false;
+            });
+        REQUIRE(manager.start());
+    }
+
+    ~CIA402GroupFixture() {
+        fsms.clear();
+        manager.stop();
+        std::filesystem::remove(config_path);
+    }
+
+    void build(bool pdo_mode) {
+        for (uint8_t i = 0; i < AXES; ++i) {
+            clients.push_back(std::make_unique<SDOClient>(sdo_sockets[i], *dict, i + 1));
+            fsms.push_back(std::make_unique<CIA402FSM>(*clients.back(), *dict));
+            if (pdo_mode) {
+                REQUIRE(fsms.back()->enable_pdo_mode(manager));
+            }
+            group.add(*fsms.back());
+        }
+    }
+};
+
+// =============================================================================
+// Group Transitions
+// =============================================================================
+
+TEST_CASE_METHOD(CIA402GroupFixture, "CIA402Group: Parallel enable", "[cia402_group]") {
+    SECTION("Duplicate node IDs are rejected") {
+        build(false);
+        REQUIRE_THROWS_AS(group.add(*fsms.front()), std::invalid_argument);
+    }
+
+    SECTION("Steps overlap across axes instead of running one node after the other") {
+        for (auto& drive : drives) {
+            drive->transition_delay = std::chrono::milliseconds(100);
+        }
+        build(false);
+
+        auto result = group.enable_operation();
+        REQUIRE(result.success);
+        REQUIRE(result.nodes.size() == AXES);
+        for (const auto& node : result.nodes) {
+            REQUIRE(node.state == cia402::State::OPERATION_ENABLED);
+        }
+
+        // Sequential enabling needs at least 8 axes x 3 steps x 100ms
+        REQUIRE(result.elapsed < std::chrono::milliseconds(1500));
+    }
+
+    SECTION("Failures are reported per node") {
+        drives[2]->fault_on_enable = true;
+        drives[5]->fault_on_enable = true;
+        build(true);
+
+        auto result = group.enable_operation();
+        REQUIRE_FALSE(result.success);
+        REQUIRE(result.failed_nodes() == std::vector<uint8_t>{3, 6});
+        REQUIRE(result.nodes[2].state == cia402::State::FAULT);
+        REQUIRE(result.nodes[0].state == cia402::State::OPERATION_ENABLED);
+
+        // Faulted axes recover with a group fault reset
+        drives[2]->fault_on_enable = false;
+        drives[5]->fault_on_enable = false;
+        REQUIRE(group.reset_fault().success);
+        REQUIRE(group.enable_operation().success);
+    }
+
+    SECTION("Disable and shutdown") {
+        build(true);
+        REQUIRE(group.enable_operation().success);
+
+        auto disabled = group.disable_operation();
+        REQUIRE(disabled.success);
+        REQUIRE(disabled.nodes[7].state == cia402::State::SWITCHED_ON);
+
+        auto shut = group.shutdown();
+        REQUIRE(shut.success);
+        REQUIRE(shut.nodes[0].state == cia402::State::READY_TO_SWITCH_ON);
+    }
+}
+
+TEST_CASE_METHOD(CIA402GroupFixture, "CIA402Group: Coordinated quick stop",
+    "[cia402_group][quick_stop]") {
+    build(true);
+    REQUIRE(group.enable_operation().success);
+
+    SECTION("All axes stop in one burst") {
+        auto result = group.quick_stop();
+        REQUIRE(result.success);
+        for (const auto& node : result.nodes) {
+            REQUIRE(node.state == cia402::State::QUICK_STOP_ACTIVE);
+        }
+        REQUIRE(result.command_skew <= result.elapsed);
+        REQUIRE(result.elapsed < std::chrono::milliseconds(500));
+
+        // Every drive got the Quick Stop controlword
+        std::size_t quick_stops = 0;
+        for (const auto& frame : pdo_socket->get_tx_history()) {
+            if ((frame.can_id & 0x780) == 0x200 && frame.data[0] == 0x02) ++quick_stops;
+        }
+        REQUIRE(quick_stops == AXES);
+    }
+
+    SECTION("Quick stop pre-empts a running group wait") {
+        std::thread waiter([&] {
+                group.wait_for_state(cia402::State::FAULT, GroupWait::ALL,
+                std::chrono::milliseconds(5000));
+            });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        auto start = std::chrono::steady_clock::now();
+        auto result = group.quick_stop();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        waiter.join();
+
+        REQUIRE(result.success);
+        REQUIRE(elapsed < std::chrono::milliseconds(1000));
+    }
+
+    SECTION("Quick stop does not wait for a slow operation to return") {
+        std::mutex mutex;
+        std::vector<std::chrono::steady_clock::time_point> stops;
+        pdo_socket->set_responder([&](const can_frame& request, can_frame& reply) {
+                if ((request.can_id & 0x780) == 0x200 && request.data[0] == 0x02) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stops.push_back(std::chrono::steady_clock::now());
+                }
+                for (auto& drive : drives) {
+                    if (drive->respond_pdo(request, reply)) return true;
+                }
+                return false;
+            });
+
+        // Fresh PDO mode: the next operation starts with a slow SDO read per drive
+        for (uint8_t i = 0; i < AXES; ++i) {
+            REQUIRE(fsms[i]->enable_pdo_mode(manager));
+            drives[i]->sdo_delay = std::chrono::milliseconds(300);
+        }
+        std::thread operation([&] { group.disable_operation(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        auto start = std::chrono::steady_clock::now();
+        auto result = group.quick_stop();
+        operation.join();
+
+        REQUIRE(result.success);
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(stops.size() == AXES);
+        for (auto sent : stops) {
+            REQUIRE(sent - start < std::chrono::milliseconds(100));
+        }
+    }
+}
+
+TEST_CASE_METHOD(CIA402GroupFixture, "CIA402Group: Quick stop in SDO mode",
+    "[cia402_group][quick_stop]") {
+    build(false);
+    REQUIRE(group.enable_operation().success);
+    for (auto& drive : drives) drive->sdo_delay = std::chrono::milliseconds(100);
+
+    // The waiter keeps a statusword read in flight on every client; the Quick
+    // Stop write queues behind that one transfer, not behind the whole wait
+    std::thread waiter([&] {
+            group.wait_for_state(cia402::State::FAULT, GroupWait::ALL,
+            std::chrono::milliseconds(5000));
+        });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    auto start = std::chrono::steady_clock::now();
+    auto result = group.quick_stop();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    waiter.join();
+
+    REQUIRE(result.success);
+    for (const auto& node : result.nodes) {
+        REQUIRE(node.state == cia402::State::QUICK_STOP_ACTIVE);
+    }
+    REQUIRE(elapsed < std::chrono::milliseconds(5000));
+
+    for (const auto& socket : sdo_sockets) {
+        std::size_t quick_stops = 0;
+        for (const auto& frame : socket->get_tx_history()) {
+            if (frame.data[0] == 0x2B && frame.data[1] == 0x40 && frame.data[2] == 0x60 &&
+                frame.data[4] == 0x02) {
+                ++quick_stops;
+            }
+        }
+        REQUIRE(quick_stops == 1);
+    }
+}
+
+TEST_CASE_METHOD(CIA402GroupFixture, "CIA402Group: Wait policies", "[cia402_group][wait]") {
+    build(false);
+    REQUIRE(fsms[4]->shutdown());
+
+    SECTION("ANY returns with the first node and cancels the rest") {
+        auto start = std::chrono::steady_clock::now();
+        auto result = group.wait_for_state(cia402::State::READY_TO_SWITCH_ON, GroupWait::ANY,
+            std::chrono::milliseconds(3000));
+        REQUIRE(result.success);
+        REQUIRE(result.nodes[4].success);
+        REQUIRE(result.failed_nodes().size() == AXES - 1);
+        REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1000));
+    }
+
+    SECTION("ALL fails on a timeout but reports who made it") {
+        auto result = group.wait_for_state(cia402::State::READY_TO_SWITCH_ON, GroupWait::ALL,
+            std::chrono::milliseconds(100));
+        REQUIRE_FALSE(result.success);
+        REQUIRE(result.nodes[4].success);
+        REQUIRE(result.failed_nodes().size() == AXES - 1);
+    }
+}
@@ -38,7 +38,7 @@ using Catch::Matchers::ContainsSubstring;
 // ==============================================================================
 
 bool is_vcan_test_available() {
-    return std::filesystem::exists("/sys/class/net/vcan_test");
+    return is_test_bus_available("vcan_test");
 }
 
 bool is_motor_config_available() {
@@ -0,0 +1,345 @@
+/**
+ * @file test_drive_simulator.cpp
+ * @brief Unit tests for the virtual CiA 402 drive simulator
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-18
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "canopen/sim/drive_simulator.hpp"
+#include "canopen/cia402_fsm.hpp"
+#include "canopen/nmt_master.hpp"
+#include "canopen/pdo_configurator.hpp"
+#include "canopen/sdo_client.hpp"
+#include "test_utils_canopen.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+using namespace canopen;
+using namespace test_utils;
+
+namespace {
+
+    struct SimBus {
+        std::shared_ptr<LinkedMockCANSocket> master = std::make_shared<LinkedMockCANSocket>();
+        std::shared_ptr<LinkedMockCANSocket> drives = std::make_shared<LinkedMockCANSocket>();
+
+        SimBus() {
+            master->link(drives.get());
+            drives->link(master.get());
+        }
+    };
+
+    can_frame sdo_read(uint8_t node_id, uint16_t index, uint8_t subindex) {
+        can_frame frame{};
+        frame.can_id = 0x600 + node_id;
+        frame.can_dlc = 8;
+        frame.data[0] = 0x40;
+        frame.data[1] = index & 0xFF;
+        frame.data[2] = index >> 8;
+        frame.data[3] = subindex;
+        return frame;
+    }
+
+    can_frame sdo_request(uint8_t node_id, std::initializer_list<uint8_t> bytes) {
+        can_frame frame{};
+        frame.can_id = 0x600 + node_id;
+        frame.can_dlc = 8;
+        std::copy(bytes.begin(), bytes.end(), frame.data);
+        return frame;
+    }
+
+    // Single-response SDO exchange with a drive
+    can_frame exchange(sim::VirtualDrive& drive, const can_frame& request) {
+        std::vector<can_frame> replies;
+        drive.handle_sdo(request, replies);
+        REQUIRE(replies.size() == 1);
+        return replies.front();
+    }
+
+    uint32_t le32(const uint8_t* data) {
+        return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+    }
+
+    ObjectDictionary make_dictionary() {
+        std::filesystem::create_directories("/tmp/canopen_test");
+        std::string path = "/tmp/canopen_test/test_drive_simulator.json";
+        {
+            std::ofstream config(path);
+            config << R"({
+                "node_id": 1,
+                "device_name": "SimDrive 402",
+                "objects": {
+                    "controlword": {"index": "0x6040", "subindex": 0, "datatype": "uint16_t",
+                                    "access": "rw", "pdo_mapping": "rpdo1"},
+                    "statusword": {"index": "0x6041", "subindex": 0, "datatype": "uint16_t",
+                                   "access": "ro", "pdo_mapping": "tpdo1"},
+                    "position_actual": {"index": "0x6064", "subindex": 0, "datatype": "int32_t",
+                                        "access": "ro", "pdo_mapping": "tpdo1"},
+                    "velocity_actual": {"index": "0x606C", "subindex": 0, "datatype": "int32_t",
+                                        "access": "ro", "pdo_mapping": "tpdo2"}
+                },
+                "pdo_configuration": {
+                    "rpdo1": {"cob_id": "0x200", "transmission_type": 1,
+                              "objects": ["controlword"]},
+                    "tpdo1": {"cob_id": "0x180", "transmission_type": 1,
+                              "objects": ["statusword", "position_actual"]},
+                    "tpdo2": {"cob_id": "0x280", "transmission_type": 1,
+                              "objects": ["velocity_actual"]}
+                },
+                "communication_parameters": {"heartbeat_producer_ms": 1000}
+            })";
+        }
+        ObjectDictionary dict(path);
+        std::filesystem::remove(path);
+        return dict;
+    }
+
+} // namespace
+
+TEST_CASE("VirtualDrive: Object storage and SDO", "[sim]") {
+    ObjectDictionary dict = make_dictionary();
+    sim::DriveProfile profile(dict);
+    sim::VirtualDrive drive(profile, 12);
+    can_frame reply;
+    std::vector<can_frame> replies;
+
+    SECTION("Identity and required objects are present") {
+        REQUIRE(drive.get(0x1000) == sim::DEVICE_TYPE);
+        REQUIRE(drive.get(0x1018, 4) == 12);
+        REQUIRE(drive.heartbeat_ms() == 1000);
+        REQUIRE(profile.find(0x6041, 0) != sim::DriveProfile::NOT_FOUND);
+        REQUIRE(profile.find(0x2FFF, 0) == sim::DriveProfile::NOT_FOUND);
+        REQUIRE(drive.state() == cia402::State::SWITCH_ON_DISABLED);
+    }
+
+    SECTION("Expedited upload reports size") {
+        reply = exchange(drive, sdo_read(12, 0x1018, 1));
+        REQUIRE(reply.can_id == 0x58C);
+        REQUIRE(reply.data[0] == 0x43);
+        REQUIRE(le32(&reply.data[4]) == sim::VENDOR_ID);
+
+        reply = exchange(drive, sdo_read(12, 0x6041, 0));
+        REQUIRE(reply.data[0] == 0x4B);
+    }
+
+    SECTION("Abort codes") {
+        reply = exchange(drive, sdo_read(12, 0x2FFF, 0));
+        REQUIRE(reply.data[0] == 0x80);
+        REQUIRE(le32(&reply.data[4]) == 0x06020000);
+
+        can_frame write = sdo_read(12, 0x6041, 0);
+        write.data[0] = 0x2B;
+        reply = exchange(drive, write);
+        REQUIRE(le32(&reply.data[4]) == 0x06010002);
+
+        write = sdo_read(12, 0x6040, 0);
+        write.data[0] = 0x23;  // 4 bytes into a 2-byte object
+        reply = exchange(drive, write);
+        REQUIRE(le32(&reply.data[4]) == 0x06070012);
+
+        // Frames shorter than 8 bytes are not SDO requests
+        write.can_dlc = 4;
+        drive.handle_sdo(write, replies);
+        REQUIRE(replies.empty());
+    }
+
+    SECTION("Device name is uploaded in segments") {
+        reply = exchange(drive, sdo_read(12, 0x1008, 0));
+        REQUIRE(reply.data[0] == 0x41);
+        REQUIRE(le32(&reply.data[4]) == 12);
+
+        std::string name;
+        reply = exchange(drive, sdo_request(12, {0x60}));
+        REQUIRE(reply.data[0] == 0x00);
+        name.append(reinterpret_cast<const char*>(&reply.data[1]), 7);
+        reply = exchange(drive, sdo_request(12, {0x70}));
+        REQUIRE(reply.data[0] == (0x10 | (2 << 1) | 0x01));
+        name.append(reinterpret_cast<const char*>(&reply.data[1]), 5);
+        REQUIRE(name == "SimDrive 402");
+    }
+
+    SECTION("Segmented download reaches the drive model") {
+        reply = exchange(drive, sdo_request(12, {0x21, 0x40, 0x60, 0x00, 2, 0, 0, 0}));
+        REQUIRE(reply.data[0] == 0x60);
+        reply = exchange(drive, sdo_request(12, {(5 << 1) | 0x01, 0x06, 0x00}));
+        REQUIRE(reply.data[0] == 0x20);
+        REQUIRE(drive.state() == cia402::State::READY_TO_SWITCH_ON);
+    }
+
+    SECTION("Domains added to the SDO server take block downloads") {
+        drive.sdo_server().add_object(0x2200, 0, SDOServer::Access::RW, {});
+        reply = exchange(drive, sdo_request(12, {0xC2, 0x00, 0x22, 0x00, 3, 0, 0, 0}));
+        REQUIRE(reply.data[0] == 0xA4);
+        reply = exchange(drive, sdo_request(12, {0x81, 0xAA, 0xBB, 0xCC}));
+        REQUIRE(reply.data[0] == 0xA2);
+        reply = exchange(drive, sdo_request(12, {0xC1 | (4 << 2)}));
+        REQUIRE(reply.data[0] == 0xA1);
+        REQUIRE(drive.sdo_server().get_value(0x2200, 0) == std::vector<uint8_t>{0xAA, 0xBB, 0xCC});
+    }
+
+    SECTION("PDO parameters report the profile and read back writes") {
+        reply = exchange(drive, sdo_read(12, 0x1800, 1));
+        REQUIRE(le32(&reply.data[4]) == 0x18C);
+        reply = exchange(drive, sdo_read(12, 0x1A00, 0));
+        REQUIRE(reply.data[4] == 2);
+        reply = exchange(drive, sdo_read(12, 0x1A00, 2));
+        REQUIRE(le32(&reply.data[4]) == 0x60640020);
+
+        reply = exchange(drive, sdo_request(12, {0x2F, 0x00, 0x14, 0x02, 5}));
+        REQUIRE(reply.data[0] == 0x60);
+        REQUIRE(drive.get(0x1400, 2) == 5);
+    }
+
+    SECTION("Controlword drives the state machine") {
+        drive.set(0x6040, 0, 0x06);
+        REQUIRE(drive.state() == cia402::State::READY_TO_SWITCH_ON);
+        drive.set(0x6040, 0, 0x0F);
+        REQUIRE(drive.state() == cia402::State::OPERATION_ENABLED);
+        REQUIRE((drive.statusword() & 0x6F) == 0x27);
+
+        drive.inject_fault();
+        REQUIRE(drive.state() == cia402::State::FAULT);
+        drive.set(0x6040, 0, 0x80);
+        REQUIRE(drive.state() == cia402::State::SWITCH_ON_DISABLED);
+    }
+
+    SECTION("Profile velocity model moves the position") {
+        drive.set(0x6060, 0, static_cast<int64_t>(cia402::OperationMode::PROFILE_VELOCITY));
+        drive.set(0x6040, 0, 0x06);
+        drive.set(0x6040, 0, 0x0F);
+        drive.set(0x60FF, 0, 600);
+        for (int i = 0; i < 500; ++i) drive.step(0.001);
+
+        REQUIRE(drive.get(0x606C) == 600);
+        REQUIRE(drive.position() > 0.0);
+        REQUIRE(drive.get(0x6064) == std::llround(drive.position()));
+        REQUIRE(drive.get(0x6061) == static_cast<int64_t>(cia402::OperationMode::PROFILE_VELOCITY));
+    }
+}
+
+TEST_CASE("DriveSimulator: Bus behaviour", "[sim]") {
+    using namespace std::chrono_literals;
+    ObjectDictionary dict = make_dictionary();
+    SimBus bus;
+    sim::DriveSimulator simulator(bus.drives, dict);
+
+    SECTION("Node setup is validated") {
+        simulator.add_drive(1);
+        REQUIRE_THROWS_AS(simulator.add_drive(1), std::invalid_argument);
+        REQUIRE_THROWS_AS(simulator.add_drive(0), std::invalid_argument);
+        REQUIRE_THROWS_AS(simulator.add_drives(120, 10), std::invalid_argument);
+    }
+
+    SECTION("SDO client enables a simulated drive through the FSM") {
+        simulator.add_drives(1, 3);
+        REQUIRE(simulator.start());
+
+        SDOClient sdo(bus.master, dict, 2);
+        auto serial = sdo.read_raw(0x1018, 4);
+        REQUIRE(serial == std::vector<uint8_t>{2, 0, 0, 0});
+
+        CIA402FSM fsm(sdo, dict);
+        REQUIRE(fsm.enable_operation());
+        REQUIRE(fsm.get_current_state(true) == cia402::State::OPERATION_ENABLED);
+
+        cia402::State other;
+        simulator.with_drive(3, [&](sim::VirtualDrive& drive) { other = drive.state(); });
+        REQUIRE(other == cia402::State::SWITCH_ON_DISABLED);
+    }
+
+    SECTION("PDO configurator remaps and verifies a simulated drive") {
+        simulator.add_drive(4);
+        REQUIRE(simulator.start());
+
+        SDOClient sdo(bus.master, dict, 4);
+        REQUIRE(PDOConfigurator(dict).configure_node(sdo));
+        REQUIRE(sdo.read_raw(0x1800, 1) == std::vector<uint8_t>{0x84, 0x01, 0x00, 0x00});
+    }
+
+    SECTION("One SYNC answers every drive") {
+        simulator.add_drives(1, pdo::MAX_NODE_ID);
+        REQUIRE(simulator.drive_count() == pdo::MAX_NODE_ID);
+        REQUIRE(simulator.start());
+
+        can_frame sync{};
+        sync.can_id = 0x080;
+        bus.master->send(sync);
+
+        // tpdo1 and tpdo2 use transmission type 1
+        REQUIRE(wait_until([&] { return simulator.get_statistics().tpdos_sent == 2 * 127u; }));
+        auto rx = bus.drives->get_tx_history();
+        std::size_t tpdo1 = 0;
+        for (const auto& frame : rx) {
+            if (frame.can_id >= 0x181 && frame.can_id <= 0x1FF) ++tpdo1;
+        }
+        REQUIRE(tpdo1 == 127);
+    }
+
+    SECTION("RPDO controlword and NMT commands") {
+        simulator.add_drive(5);
+        REQUIRE(simulator.start());
+
+        can_frame rpdo{};
+        rpdo.can_id = 0x205;
+        rpdo.can_dlc = 2;
+        rpdo.data[0] = 0x06;
+        bus.master->send(rpdo);
+        auto state_of_5 = [&] {
+                cia402::State state = cia402::State::UNKNOWN;
+                simulator.with_drive(5, [&](sim::VirtualDrive& drive) { state = drive.state(); });
+                return state;
+            };
+        REQUIRE(wait_until([&] { return state_of_5() == cia402::State::READY_TO_SWITCH_ON; }));
+
+        NMTMaster nmt(bus.master);
+        REQUIRE(nmt.stop_node(5));
+        REQUIRE(wait_until([&] {
+                nmt::State state = nmt::State::UNKNOWN;
+                simulator.with_drive(5, [&](sim::VirtualDrive& drive) { state = drive.nmt_state(); });
+                return state == nmt::State::STOPPED;
+            }));
+
+        bus.drives->clear_tx_history();
+        REQUIRE(nmt.reset_node(5));
+        REQUIRE(wait_until([&] { return state_of_5() == cia402::State::SWITCH_ON_DISABLED; }));
+        REQUIRE(wait_until([&] { return !bus.drives->get_tx_history().empty(); }));
+        auto bootup = bus.drives->get_tx_history().front();
+        REQUIRE(bootup.can_id == 0x705);
+        REQUIRE(bootup.data[0] == 0);
+    }
+}
+
+TEST_CASE("DriveSimulator: NMT master monitoring", "[sim][nmt]") {
+    using namespace std::chrono_literals;
+    ObjectDictionary dict = make_dictionary();
+    SimBus bus;
+    auto sdo_socket = std::make_shared<LinkedMockCANSocket>();
+    sdo_socket->link(bus.drives.get());
+    bus.drives->link(sdo_socket.get());
+
+    sim::DriveSimulator simulator(bus.drives, dict);
+    simulator.add_drives(1, 2);
+    simulator.with_drive(1, [](sim::VirtualDrive& drive) { drive.set(0x1017, 0, 20); });
+    simulator.with_drive(2, [](sim::VirtualDrive& drive) { drive.set(0x1017, 0, 0); });
+    REQUIRE(simulator.start());
+
+    NMTMaster master(bus.master);
+    master.monitor_heartbeat(1, 20ms);
+    master.monitor_node_guard(2, 20ms, 3);
+    REQUIRE(master.start());
+
+    REQUIRE(wait_until([&] {
+            return master.get_node_status(1).messages >= 5 &&
+            master.get_node_status(2).messages >= 5;
+        }));
+    REQUIRE(master.get_node_state(1) == nmt::State::OPERATIONAL);
+    REQUIRE(master.get_node_status(2).toggle_errors == 0);
+
+    // Heartbeat disabled over SDO (from a second master socket): node 1 is lost
+    SDOClient sdo(sdo_socket, dict, 1);
+    REQUIRE(sdo.write_raw(0x1017, 0, {0, 0}));
+    REQUIRE(wait_until([&] { return !master.is_node_alive(1); }, 500ms));
+    REQUIRE(master.is_node_alive(2));
+}
@@ -0,0 +1,190 @@
+/**
+ * @file test_emcy_consumer.cpp
+ * @brief Unit tests for the EMCY consumer and its per-node history
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-20
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "canopen/emcy_consumer.hpp"
+#include "test_utils_canopen.hpp"
+#include <atomic>
+#include <thread>
+
+using namespace canopen;
+using namespace test_utils;
+
+namespace {
+
+    can_frame emcy_frame(uint8_t node_id, uint16_t error_code, uint8_t error_register,
+        uint8_t manufacturer = 0) {
+        can_frame frame{};
+        frame.can_id = emcy::emcy_cob_id(node_id);
+        frame.can_dlc = 8;
+        frame.data[0] = error_code & 0xFF;
+        frame.data[1] = error_code >> 8;
+        frame.data[2] = error_register;
+        frame.data[3] = manufacturer;
+        frame.data[7] = static_cast<uint8_t>(~manufacturer);
+        return frame;
+    }
+
+} // namespace
+
+TEST_CASE("EMCY constants: Error code classes", "[emcy]") {
+    REQUIRE(emcy::emcy_cob_id(5) == 0x085);
+    REQUIRE(emcy::classify(0x0000) == emcy::ErrorClass::NO_ERROR);
+    REQUIRE(emcy::classify(0x1000) == emcy::ErrorClass::GENERIC);
+    REQUIRE(emcy::classify(0x2310) == emcy::ErrorClass::CURRENT);
+    REQUIRE(emcy::classify(0x3210) == emcy::ErrorClass::VOLTAGE);
+    REQUIRE(emcy::classify(0x4310) == emcy::ErrorClass::TEMPERATURE);
+    REQUIRE(emcy::classify(0x8130) == emcy::ErrorClass::MONITORING);
+    REQUIRE(emcy::classify(0xF001) == emcy::ErrorClass::ADDITIONAL_FUNCTIONS);
+    REQUIRE(emcy::classify(0xFF42) == emcy::ErrorClass::DEVICE_SPECIFIC);
+    REQUIRE(emcy::classify(0xA000) == emcy::ErrorClass::UNKNOWN);
+    REQUIRE(emcy::error_class_to_string(emcy::ErrorClass::VOLTAGE) == "VOLTAGE");
+}
+
+TEST_CASE("EMCYConsumer: Decoding and history", "[emcy]") {
+    auto socket = std::make_shared<PollableMockCANSocket>();
+    EMCYConsumer consumer(socket);
+
+    SECTION("Frame fields are decoded") {
+        can_frame frame = emcy_frame(3, 0x2310, 0x03, 0xA5);
+        frame.data[4] = 0x11;
+        REQUIRE(consumer.process(frame));
+
+        auto last = consumer.last_emergency(3);
+        REQUIRE(last.has_value());
+        REQUIRE(last->node_id == 3);
+        REQUIRE(last->error_code == 0x2310);
+        REQUIRE(last->error_register == 0x03);
+        REQUIRE(last->manufacturer == std::array<uint8_t, 5>{0xA5, 0x11, 0, 0, 0x5A});
+        REQUIRE(last->error_class() == emcy::ErrorClass::CURRENT);
+        REQUIRE(consumer.active_error(3) == 0x2310);
+        REQUIRE(consumer.error_register(3) == 0x03);
+        REQUIRE_FALSE(consumer.last_emergency(4).has_value());
+    }
+
+    SECTION("Other frames are ignored") {
+        can_frame frame = emcy_frame(1, 0x1000, 0x01);
+        frame.can_id = 0x080;   // SYNC
+        REQUIRE_FALSE(consumer.process(frame));
+        frame.can_id = 0x181;   // TPDO1
+        REQUIRE_FALSE(consumer.process(frame));
+        frame.can_id = 0x081 | CAN_RTR_FLAG;
+        REQUIRE_FALSE(consumer.process(frame));
+
+        frame = emcy_frame(1, 0x1000, 0x01);
+        frame.can_dlc = 2;
+        REQUIRE_FALSE(consumer.process(frame));
+        REQUIRE(consumer.get_statistics().malformed == 1);
+        REQUIRE(consumer.get_statistics().received == 0);
+        REQUIRE(consumer.emergency_count(1) == 0);
+    }
+
+    SECTION("Short frames leave missing bytes at zero") {
+        can_frame frame = emcy_frame(2, 0x8130, 0x11, 0x7F);
+        frame.can_dlc = 4;
+        REQUIRE(consumer.process(frame));
+        REQUIRE(consumer.last_emergency(2)->manufacturer ==
+            std::array<uint8_t, 5>{0x7F, 0, 0, 0, 0});
+    }
+
+    SECTION("Error reset clears the active error but stays in history") {
+        consumer.process(emcy_frame(7, 0x3210, 0x05));
+        REQUIRE(consumer.has_active_error(7));
+        consumer.process(emcy_frame(7, 0x0000, 0x00));
+        REQUIRE_FALSE(consumer.has_active_error(7));
+
+        auto history = consumer.history(7);
+        REQUIRE(history.size() == 2);
+        REQUIRE(history[0].error_code == 0x3210);
+        REQUIRE(history[1].is_reset());
+        REQUIRE(history[0].timestamp <= history[1].timestamp);
+        REQUIRE(consumer.get_statistics().resets == 1);
+    }
+
+    SECTION("Ring keeps the most recent emergencies per node") {
+        const std::size_t total = EMCYConsumer::HISTORY_SIZE + 5;
+        for (std::size_t i = 0; i < total; ++i) {
+            consumer.process(emcy_frame(9, static_cast<uint16_t>(0x1000 + i), 0x01));
+        }
+        consumer.process(emcy_frame(10, 0x6000, 0x01));
+
+        auto history = consumer.history(9);
+        REQUIRE(history.size() == EMCYConsumer::HISTORY_SIZE);
+        REQUIRE(history.front().error_code == 0x1005);
+        REQUIRE(history.back().error_code == 0x1000 + total - 1);
+        REQUIRE(consumer.emergency_count(9) == total);
+        REQUIRE(consumer.history(10).size() == 1);
+        REQUIRE(consumer.history(0).empty());
+        REQUIRE(consumer.history(200).empty());
+    }
+}
+
+TEST_CASE("EMCYConsumer: Subscriptions", "[emcy]") {
+    auto socket = std::make_shared<PollableMockCANSocket>();
+    EMCYConsumer consumer(socket);
+
+    std::vector<Emergency> node4;
+    std::vector<Emergency> all;
+    auto id4 = consumer.subscribe(4, [&](const Emergency& e) { node4.push_back(e); });
+    consumer.subscribe(EMCYConsumer::ALL_NODES, [&](const Emergency& e) { all.push_back(e); });
+    consumer.subscribe(4, [](const Emergency&) { throw std::runtime_error("subscriber"); });
+    REQUIRE_THROWS_AS(consumer.subscribe(128, [](const Emergency&) {}), std::invalid_argument);
+
+    consumer.process(emcy_frame(4, 0x4310, 0x09));
+    consumer.process(emcy_frame(5, 0x5000, 0x01));
+    REQUIRE(node4.size() == 1);
+    REQUIRE(node4[0].error_code == 0x4310);
+    REQUIRE(all.size() == 2);
+    REQUIRE(all[1].node_id == 5);
+    REQUIRE(consumer.get_statistics().callback_errors == 1);
+
+    consumer.unsubscribe(id4);
+    consumer.process(emcy_frame(4, 0x0000, 0x00));
+    REQUIRE(node4.size() == 1);
+    REQUIRE(all.size() == 3);
+}
+
+TEST_CASE("EMCYConsumer: Receive thread and concurrent readers", "[emcy]") {
+    auto socket = std::make_shared<PollableMockCANSocket>();
+    EMCYConsumer consumer(socket);
+
+    std::atomic<int> callbacks{0};
+    consumer.subscribe(EMCYConsumer::ALL_NODES, [&](const Emergency&) { ++callbacks; });
+    REQUIRE(consumer.start());
+
+    // Readers check every copied entry is internally consistent and in order
+    std::atomic<bool> reading{true};
+    std::atomic<bool> torn{false};
+    std::thread reader([&] {
+            while (reading) {
+                auto history = consumer.history(1);
+                for (std::size_t i = 0; i < history.size(); ++i) {
+                    const auto& e = history[i];
+                    uint8_t low = static_cast<uint8_t>(e.error_code);
+                    if (e.manufacturer[0] != low || e.manufacturer[4] != static_cast<uint8_t>(~low) ||
+                        (i > 0 && e.error_code <= history[i - 1].error_code)) {
+                        torn = true;
+                    }
+                }
+            }
+        });
+
+    const int total = 500;
+    for (int i = 0; i < total; ++i) {
+        uint16_t code = static_cast<uint16_t>(0x1000 + i);
+        socket->inject(emcy_frame(1, code, 0x01, static_cast<uint8_t>(code)));
+    }
+
+    REQUIRE(wait_until([&] { return consumer.emergency_count(1) == total; }));
+    reading = false;
+    reader.join();
+    consumer.stop();
+
+    REQUIRE_FALSE(torn);
+    REQUIRE(callbacks == total);
+    REQUIRE(consumer.history(1).back().error_code == 0x1000 + total - 1);
+}
@@ -0,0 +1,397 @@
+/**
+ * @file test_motion_streamer.cpp
+ * @brief Unit tests for CSP/CSV setpoint streaming
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-15
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include "canopen/motion_streamer.hpp"
+#include "canopen/pdo_manager.hpp"
+#include "canopen/sync_scheduler.hpp"
+#include "canopen/object_dictionary.hpp"
+#include "test_utils_canopen.hpp"
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace canopen;
+using namespace test_utils;
+using Catch::Matchers::ContainsSubstring;
+
+// =============================================================================
+// Test Fixture
+// =============================================================================
+
+struct MotionStreamerFixture {
+    std::string config_path = "/tmp/canopen_test/test_motion_streamer.json";
+    std::unique_ptr<ObjectDictionary> dict;
+    std::shared_ptr<PollableMockCANSocket> socket = std::make_shared<PollableMockCANSocket>();
+    PDOManager manager{socket};
+
+    MotionStreamerFixture() {
+        std::filesystem::create_directories("/tmp/canopen_test");
+        std::ofstream config_file(config_path);
+        config_file << R"({
+            "node_id": 1,
+            "objects": {
+                "controlword": {"index": "0x6040", "subindex": 0, "datatype": "uint16_t",
+                                "access": "rw", "pdo_mapping": "rpdo1"},
+                "target_position": {"index": "0x607A", "subindex": 0, "datatype": "int32_t",
+                                    "access": "rw", "pdo_mapping": "rpdo1"},
+                "target_velocity": {"index": "0x60FF", "subindex": 0, "datatype": "int32_t",
+                                    "access": "rw", "pdo_mapping": "rpdo2"},
+                "statusword": {"index": "0x6041", "subindex": 0, "datatype": "uint16_t",
+                               "access": "ro", "pdo_mapping": "tpdo1"},
+                "position_actual": {"index": "0x6064", "subindex": 0, "datatype": "int32_t",
+                                    "access": "ro", "pdo_mapping": "tpdo1"},
+                "velocity_actual": {"index": "0x606C", "subindex": 0, "datatype": "int32_t",
+                                    "access": "ro", "pdo_mapping": "tpdo2"}
+            },
+            "pdo_configuration": {
+                "rpdo1": {"cob_id": "0x200", "transmission_type": 1,
+                          "objects": ["controlword", "target_position"]},
+                "rpdo2": {"cob_id": "0x300", "transmission_type": 1,
+                          "objects": ["target_velocity"]},
+                "tpdo1": {"cob_id": "0x180", "transmission_type": 1,
+                          "objects": ["statusword", "position_actual"]},
+                "tpdo2": {"cob_id": "0x280", "transmission_type": 1,
+                          "objects": ["velocity_actual"]}
+            }
+        })";
+        config_file.close();
+        dict = std::make_unique<ObjectDictionary>(config_path);
+    }
+
+    ~MotionStreamerFixture() {
+        manager.stop();
+        std::filesystem::remove(config_path);
+    }
+
+    static int32_t target_of(const can_frame& frame, int offset) {
+        int32_t value;
+        std::memcpy(&value, &frame.data[offset], sizeof(value));
+        return value;
+    }
+};
+
+// =============================================================================
+// Interpolation
+// =============================================================================
+
+TEST_CASE("MotionStreamer: Cubic Hermite interpolation", "[motion_streamer][interpolation]") {
+    SECTION("Endpoints are reproduced") {
+        Waypoint a{0.0, 10.0, 0.0};
+        Waypoint b{1.0, 20.0, 0.0};
+        REQUIRE(MotionStreamer::interpolate(a, b, 0.0) == 10.0);
+        REQUIRE(MotionStreamer::interpolate(a, b, 1.0) == 20.0);
+    }
+
+    SECTION("Zero end velocities give a smooth S-curve") {
+        Waypoint a{0.0, 0.0, 0.0};
+        Waypoint b{1.0, 1.0, 0.0};
+        REQUIRE(std::fabs(MotionStreamer::interpolate(a, b, 0.25) - 0.15625) < 1e-12);
+        REQUIRE(std::fabs(MotionStreamer::interpolate(a, b, 0.5) - 0.5) < 1e-12);
+    }
+
+    SECTION("Consistent derivatives reproduce a straight line") {
+        Waypoint a{0.0, 0.0, 100.0};
+        Waypoint b{2.0, 200.0, 100.0};
+        REQUIRE(std::fabs(MotionStreamer::interpolate(a, b, 0.5) - 50.0) < 1e-9);
+        REQUIRE(std::fabs(MotionStreamer::interpolate(a, b, 1.5) - 150.0) < 1e-9);
+    }
+}
+
+// =============================================================================
+// Construction
+// =============================================================================
+
+TEST_CASE_METHOD(MotionStreamerFixture, "MotionStreamer: Configuration",
+    "[motion_streamer]") {
+    SECTION("Non-cyclic modes are rejected") {
+        MotionStreamConfig config;
+        config.mode = cia402::OperationMode::PROFILE_POSITION;
+        REQUIRE_THROWS_AS(MotionStreamer(manager, *dict, config), std::invalid_argument);
+    }
+
+    SECTION("RPDO without the target object is rejected") {
+        MotionStreamConfig config;
+        config.mode = cia402::OperationMode::CYCLIC_SYNC_VELOCITY;  // target_velocity is in rpdo2
+        REQUIRE_THROWS_WITH(MotionStreamer(manager, *dict, config), ContainsSubstring("target_velocity is not mapped in rpdo1"));
+
+        config.rpdo = "rpdo2";
+        config.feedback_tpdo = "tpdo1";  // velocity_actual is in tpdo2
+        REQUIRE_THROWS_WITH(MotionStreamer(manager, *dict, config),
+            ContainsSubstring("velocity_actual is not mapped in tpdo1"));
+    }
+
+    SECTION("Nodes are validated") {
+        MotionStreamer streamer(manager, *dict);
+        REQUIRE_THROWS_AS(streamer.add_node(0), std::invalid_argument);
+        streamer.add_node(1);
+        REQUIRE_THROWS_AS(streamer.add_node(1), std::invalid_argument);
+    }
+
+    SECTION("Waypoints must move forward in time and fit the buffer") {
+        MotionStreamConfig config;
+        config.buffer_capacity = 2;
+        MotionStreamer streamer(manager, *dict, config);
+        streamer.add_node(1);
+
+        REQUIRE(streamer.push(1, {0.0, 0.0, 0.0}));
+        REQUIRE_FALSE(streamer.push(1, {0.0, 1.0, 0.0}));
+        REQUIRE(streamer.push(1, {0.1, 1.0, 0.0}));
+        REQUIRE_FALSE(streamer.push(1, {0.2, 2.0, 0.0}));  // full
+        REQUIRE_FALSE(streamer.push(2, {0.0, 0.0, 0.0}));  // unknown node
+    }
+}
+
+// =============================================================================
+// Streaming
+// =============================================================================
+
+TEST_CASE_METHOD(MotionStreamerFixture, "MotionStreamer: CSP streaming",
+    "[motion_streamer][csp]") {
+    MotionStreamConfig config;
+    config.period = std::chrono::milliseconds(1);
+    config.feedback_tpdo = "";
+
+    SECTION("One RPDO per node per cycle following the trajectory") {
+        MotionStreamer streamer(manager, *dict, config);
+        streamer.add_node(1);
+        streamer.add_node(2);
+
+        REQUIRE(streamer.push(1, {0.0, 0.0, 0.0}));
+        REQUIRE(streamer.push(1, {0.010, 1000.0, 0.0}));
+        streamer.finish(1);
+        REQUIRE(streamer.push(2, {0.0, -50.0, 0.0}));
+        streamer.finish(2);
+
+        for (int i = 0; i < 12; ++i) {
+            streamer.step();
+        }
+
+        auto tx = socket->get_tx_history();
+        REQUIRE(tx.size() == 24);
+
+        int32_t previous = -1;
+        for (std::size_t i = 0; i < tx.size(); i += 2) {
+            REQUIRE(tx[i].can_id == 0x201);
+            REQUIRE(tx[i].can_dlc == 6);
+            REQUIRE(tx[i].data[0] == 0x0F);  // Enable Operation controlword
+            int32_t position = target_of(tx[i], 2);
+            REQUIRE(position >= previous);
+            previous = position;
+
+            REQUIRE(tx[i + 1].can_id == 0x202);
+            REQUIRE(target_of(tx[i + 1], 2) == -50);
+        }
+        REQUIRE(target_of(tx[0], 2) == 0);
+        REQUIRE(target_of(tx[10], 2) == 500);  // Midpoint at t = 5 ms
+        REQUIRE(previous == 1000);
+
+        auto stats = streamer.get_statistics(1);
+        REQUIRE(stats.setpoints_sent == 12);
+        REQUIRE(stats.underruns == 0);
+        REQUIRE(stats.last_setpoint == 1000.0);
+        REQUIRE(streamer.get_cycle_statistics().cycles == 12);
+        REQUIRE(streamer.get_cycle_statistics().compute_time.count == 12);
+    }
+
+    SECTION("Nodes without waypoints stay silent") {
+        MotionStreamer streamer(manager, *dict, config);
+        streamer.add_node(1);
+        streamer.step();
+        streamer.step();
+
+        REQUIRE(socket->get_tx_history().empty());
+        REQUIRE(streamer.get_statistics(1).underruns == 0);
+    }
+
+    SECTION("Underrun holds position, notifies once, and recovers") {
+        MotionStreamer streamer(manager, *dict, config);
+        std::atomic<int> notifications{0};
+        streamer.set_underrun_callback([&](uint8_t node) {
+                REQUIRE(node == 1);
+                notifications++;
+            });
+        streamer.add_node(1);
+
+        REQUIRE(streamer.push(1, {0.0, 0.0, 0.0}));
+        REQUIRE(streamer.push(1, {0.002, 10.0, 0.0}));
+        for (int i = 0; i < 5; ++i) streamer.step();  // t = 0..4 ms
+
+        auto stats = streamer.get_statistics(1);
+        REQUIRE(stats.underruns == 2);
+        REQUIRE(stats.last_setpoint == 10.0);
+        REQUIRE(notifications == 1);
+
+        REQUIRE(streamer.push(1, {0.008, 20.0, 0.0}));
+        streamer.step();  // t = 5 ms, back inside the trajectory
+        REQUIRE(streamer.get_statistics(1).underruns == 2);
+        REQUIRE(streamer.get_statistics(1).last_setpoint > 10.0);
+
+        for (int i = 0; i < 4; ++i) streamer.step();  // t = 6..9 ms
+        REQUIRE(notifications == 2);
+    }
+}
+
+TEST_CASE_METHOD(MotionStreamerFixture, "MotionStreamer: CSV streaming",
+    "[motion_streamer][csv]") {
+    MotionStreamConfig config;
+    config.mode = cia402::OperationMode::CYCLIC_SYNC_VELOCITY;
+    config.period = std::chrono::milliseconds(1);
+    config.rpdo = "rpdo2";
+    config.feedback_tpdo = "tpdo2";
+
+    MotionStreamer streamer(manager, *dict, config);
+    streamer.add_node(4);
+
+    SECTION("Underrun commands zero velocity") {
+        REQUIRE(streamer.push(4, {0.0, 300.0, 0.0}));
+        streamer.step();
+        streamer.step();
+
+        auto tx = socket->get_tx_history();
+        REQUIRE(tx.size() == 2);
+        REQUIRE(tx[0].can_id == 0x304);
+        REQUIRE(tx[0].can_dlc == 4);
+        REQUIRE(target_of(tx[0], 0) == 300);
+        REQUIRE(target_of(tx[1], 0) == 0);
+        REQUIRE(streamer.get_statistics(4).underruns == 1);
+    }
+
+    SECTION("Following error is tracked from TPDO feedback") {
+        REQUIRE(manager.start());
+        REQUIRE(streamer.push(4, {0.0, 300.0, 0.0}));
+        streamer.finish(4);
+        streamer.step();
+
+        can_frame feedback{};
+        feedback.can_id = 0x284;
+        feedback.can_dlc = 4;
+        int32_t actual = 280;
+        std::memcpy(feedback.data, &actual, sizeof(actual));
+        socket->inject(feedback);
+
+        REQUIRE(wait_until([&] { return streamer.get_statistics(4).last_actual == 280.0; }));
+        auto stats = streamer.get_statistics(4);
+        REQUIRE(stats.following_error == 20.0);
+        REQUIRE(stats.max_following_error == 20.0);
+        REQUIRE(stats.following_error_violations == 0);
+    }
+}
+
+TEST_CASE_METHOD(MotionStreamerFixture, "MotionStreamer: Destruction keeps other TPDO callbacks",
+    "[motion_streamer]") {
+    std::atomic<int> statuswords{0};
+    manager.register_tpdo1_callback(4, [&](const can_frame&) { ++statuswords; });
+    REQUIRE(manager.start());
+
+    {
+        MotionStreamConfig config;
+        config.mode = cia402::OperationMode::CYCLIC_SYNC_VELOCITY;
+        config.rpdo = "rpdo2";
+        config.feedback_tpdo = "tpdo2";
+        MotionStreamer streamer(manager, *dict, config);
+        streamer.add_node(4);
+    }
+
+    // Only the streamer's TPDO2 subscription went away
+    can_frame tpdo1{};
+    tpdo1.can_id = 0x184;
+    tpdo1.can_dlc = 6;
+    socket->inject(tpdo1);
+    REQUIRE(wait_until([&] { return statuswords.load() == 1; }));
+}
+
+TEST_CASE_METHOD(MotionStreamerFixture, "MotionStreamer: Destruction while TPDOs arrive",
+    "[motion_streamer]") {
+    REQUIRE(manager.start());
+
+    // Feedback keeps flowing while streamers come and go
+    std::atomic<bool> running{true};
+    std::thread drive([&] {
+            can_frame tpdo1{};
+            tpdo1.can_id = 0x181;
+            tpdo1.can_dlc = 6;
+            while (running) {
+                socket->inject(tpdo1);
+                std::this_thread::yield();
+            }
+        });
+
+    for (int i = 0; i < 2000; ++i) {
+        MotionStreamConfig config;
+        config.following_error_limit = 1.0;
+        MotionStreamer streamer(manager, *dict, config);
+        streamer.add_node(1);
+        streamer.update_actual(1, 0.0);
+    }
+    running = false;
+    drive.join();
+
+    REQUIRE(manager.get_statistics(1).tpdo1_received > 0);
+}
+
+TEST_CASE_METHOD(MotionStreamerFixture, "MotionStreamer: Following error limit",
+    "[motion_streamer][following_error]") {
+    MotionStreamConfig config;
+    config.feedback_tpdo = "";
+    config.following_error_limit = 5.0;
+
+    MotionStreamer streamer(manager, *dict, config);
+    streamer.add_node(1);
+    REQUIRE(streamer.push(1, {0.0, 100.0, 0.0}));
+    streamer.finish(1);
+    streamer.step();
+
+    streamer.update_actual(1, 97.0);
+    REQUIRE(streamer.get_statistics(1).following_error_violations == 0);
+    streamer.update_actual(1, 90.0);
+    REQUIRE(streamer.get_statistics(1).following_error_violations == 1);
+    REQUIRE(streamer.get_statistics(1).max_following_error == 10.0);
+}
+
+TEST_CASE_METHOD(MotionStreamerFixture, "MotionStreamer: SyncScheduler integration",
+    "[motion_streamer][scheduler]") {
+    MotionStreamConfig config;
+    config.period = std::chrono::milliseconds(2);
+    config.feedback_tpdo = "";
+
+    SyncSchedulerConfig sync_config;
+    sync_config.period = std::chrono::milliseconds(2);
+
+    SECTION("Period mismatch is rejected") {
+        SyncSchedulerConfig other;
+        other.period = std::chrono::milliseconds(4);
+        SyncScheduler scheduler(manager, other);
+        MotionStreamer streamer(manager, *dict, config);
+        REQUIRE_THROWS_AS(streamer.attach(scheduler), std::invalid_argument);
+    }
+
+    SECTION("Setpoints follow SYNC in each burst") {
+        SyncScheduler scheduler(manager, sync_config);
+        MotionStreamer streamer(manager, *dict, config);
+        streamer.add_node(3);
+        streamer.attach(scheduler);
+
+        REQUIRE(streamer.push(3, {0.0, 0.0, 0.0}));
+        REQUIRE(streamer.push(3, {1.0, 1000.0, 0.0}));
+
+        REQUIRE(scheduler.start());
+        REQUIRE(wait_until([&] { return streamer.get_statistics(3).setpoints_sent >= 5; }));
+        scheduler.stop();
+
+        auto tx = socket->get_tx_history();
+        REQUIRE(tx[0].can_id == 0x080);
+        REQUIRE(tx[1].can_id == 0x080);  // first setpoint queued after cycle 0
+        REQUIRE(tx[2].can_id == 0x203);
+        REQUIRE(tx[3].can_id == 0x080);
+        REQUIRE(tx[4].can_id == 0x203);
+        REQUIRE(streamer.get_cycle_statistics().interval_jitter.count >= 4);
+    }
+}
@@ -0,0 +1,216 @@
+/**
+ * @file test_network_scanner.cpp
+ * @brief Unit tests for parallel CANopen network discovery
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-21
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "canopen/network_scanner.hpp"
+#include "canopen/sim/drive_simulator.hpp"
+#include "test_utils_canopen.hpp"
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+
+using namespace canopen;
+using namespace test_utils;
+
+namespace {
+
+    ObjectDictionary make_dictionary() {
+        std::filesystem::create_directories("/tmp/canopen_test");
+        std::string path = "/tmp/canopen_test/test_network_scanner.json";
+        {
+            std::ofstream config(path);
+            config << R"({
+                "node_id": 1,
+                "objects": {
+                    "controlword": {"index": "0x6040", "subindex": 0, "datatype": "uint16_t",
+                                    "access": "rw"},
+                    "statusword": {"index": "0x6041", "subindex": 0, "datatype": "uint16_t",
+                                   "access": "ro"}
+                }
+            })";
+        }
+        ObjectDictionary dict(path);
+        std::filesystem::remove(path);
+        return dict;
+    }
+
+    /**
+     * @brief Scripted transport: answers each request through a handler
+     */
+    struct FakeTransport {
+        std::function<bool(const can_frame&, can_frame&)> handler;
+        std::deque<can_frame> rx;
+        std::vector<can_frame> tx;
+
+        NetworkScanner scanner() {
+            return NetworkScanner(
+                [this](const can_frame& frame) {
+                    tx.push_back(frame);
+                    can_frame reply{};
+                    if (handler && handler(frame, reply)) rx.push_back(reply);
+                    return true;
+                },
+                [this](can_frame& frame, std::chrono::microseconds) {
+                    if (rx.empty()) return false;
+                    frame = rx.front();
+                    rx.pop_front();
+                    return true;
+                });
+        }
+    };
+
+    can_frame upload_reply(const can_frame& request, uint8_t command, uint32_t value) {
+        can_frame reply{};
+        reply.can_id = 0x580 + (request.can_id - 0x600);
+        reply.can_dlc = 8;
+        reply.data[0] = command;
+        std::memcpy(&reply.data[1], &request.data[1], 3);
+        for (int i = 0; i < 4; ++i) reply.data[4 + i] = static_cast<uint8_t>(value >> (8 * i));
+        return reply;
+    }
+
+} // namespace
+
+TEST_CASE("NetworkScanner: Configuration checks", "[scanner]") {
+    FakeTransport transport;
+    auto scanner = transport.scanner();
+
+    NetworkScanConfig config;
+    config.first_node = 0;
+    REQUIRE_THROWS_AS(scanner.scan(config), std::invalid_argument);
+    config.first_node = 10;
+    config.last_node = 5;
+    REQUIRE_THROWS_AS(scanner.scan(config), std::invalid_argument);
+    config.first_node = 1;
+    config.last_node = 128;
+    REQUIRE_THROWS_AS(scanner.scan(config), std::invalid_argument);
+
+    REQUIRE_THROWS_AS(NetworkScanner(nullptr, nullptr), std::invalid_argument);
+    REQUIRE_THROWS_AS(NetworkScanner(std::shared_ptr<waveshare::ICANSocket>()),
+        std::runtime_error);
+}
+
+TEST_CASE("NetworkScanner: Response matching", "[scanner]") {
+    using namespace std::chrono_literals;
+    FakeTransport transport;
+    NetworkScanConfig config;
+    config.pace = 0us;
+    config.response_timeout = 20ms;
+
+    SECTION("Empty network ends after one response timeout") {
+        auto result = transport.scanner().scan(config);
+        REQUIRE(result.nodes.empty());
+        REQUIRE(result.requests_sent == 127);
+        REQUIRE(transport.tx.front().can_id == 0x601);
+        REQUIRE(transport.tx.front().data[0] == 0x40);
+        REQUIRE(transport.tx.front().data[1] == 0x18);
+        REQUIRE(transport.tx.front().data[2] == 0x10);
+        REQUIRE(transport.tx.front().data[3] == 1);
+        REQUIRE(result.elapsed < 500ms);
+    }
+
+    SECTION("Aborts, size indication and stale frames") {
+        transport.handler = [](const can_frame& request, can_frame& reply) {
+                uint8_t node = request.can_id - 0x600;
+                uint16_t index = request.data[1] | (request.data[2] << 8);
+                if (node == 3) {
+                    // 2-byte answer with size indicated, 0x1018:3 refused
+                    if (index == 0x1018 && request.data[3] == 3) {
+                        reply = upload_reply(request, 0x80, 0x06020000);
+                    } else {
+                        reply = upload_reply(request, 0x4B, 0xAAAA1234);
+                    }
+                    return true;
+                }
+                if (node == 9 && index == 0x1018 && request.data[3] == 1) {
+                    reply = upload_reply(request, 0x80, 0x06020000);  // Probe refused
+                    return true;
+                }
+                return false;
+            };
+        // Frames from nowhere: wrong multiplexer, no request in flight, not SDO
+        can_frame stale{};
+        stale.can_id = 0x583;
+        stale.can_dlc = 8;
+        stale.data[0] = 0x43;
+        stale.data[1] = 0x00;
+        stale.data[2] = 0x20;
+        transport.rx.push_back(stale);
+        stale.can_id = 0x5FF;
+        transport.rx.push_back(stale);
+        stale.can_id = 0x181;
+        transport.rx.push_back(stale);
+
+        auto result = transport.scanner().scan(config);
+        REQUIRE(result.nodes.size() == 2);
+        REQUIRE(result.ignored == 3);
+
+        const NodeIdentity& node3 = result.nodes[0];
+        REQUIRE(node3.node_id == 3);
+        REQUIRE(node3.vendor_id == 0x1234);
+        REQUIRE(node3.has(NodeIdentity::VENDOR_ID));
+        REQUIRE(node3.device_type == 0x1234);
+        REQUIRE(node3.has(NodeIdentity::PRODUCT_CODE));
+        REQUIRE_FALSE(node3.has(NodeIdentity::REVISION));
+        REQUIRE(node3.has(NodeIdentity::SERIAL_NUMBER));
+        REQUIRE(result.aborts == 1);
+
+        // A refused probe still reveals a node; its identity is read anyway
+        const NodeIdentity& node9 = result.nodes[1];
+        REQUIRE(node9.node_id == 9);
+        REQUIRE(node9.vendor_id == 0);
+        REQUIRE_FALSE(node9.has(NodeIdentity::VENDOR_ID));
+        REQUIRE(result.timeouts == 4);
+    }
+
+    SECTION("Listing only skips the inventory") {
+        config.read_identity = false;
+        transport.handler = [](const can_frame& request, can_frame& reply) {
+                reply = upload_reply(request, 0x43, 42);
+                return request.can_id == 0x605;
+            };
+        auto result = transport.scanner().scan(config);
+        REQUIRE(result.nodes.size() == 1);
+        REQUIRE(result.nodes[0].vendor_id == 42);
+        REQUIRE(result.nodes[0].fields == NodeIdentity::VENDOR_ID);
+        REQUIRE(result.requests_sent == 127);
+    }
+}
+
+TEST_CASE("NetworkScanner: Inventory of a simulated network", "[scanner][sim]") {
+    using namespace std::chrono_literals;
+    ObjectDictionary dict = make_dictionary();
+    auto master = std::make_shared<LinkedMockCANSocket>();
+    auto drives = std::make_shared<LinkedMockCANSocket>();
+    master->link(drives.get());
+    drives->link(master.get());
+
+    sim::DriveSimulator simulator(drives, dict);
+    std::vector<uint8_t> present = {1, 2, 7, 31, 64, 100, 127};
+    for (uint8_t node : present) simulator.add_drive(node);
+    REQUIRE(simulator.start());
+
+    NetworkScanner scanner(master);
+    auto result = scanner.scan();
+
+    REQUIRE(result.nodes.size() == present.size());
+    for (std::size_t i = 0; i < present.size(); ++i) {
+        const NodeIdentity& node = result.nodes[i];
+        REQUIRE(node.node_id == present[i]);
+        REQUIRE(node.vendor_id == sim::VENDOR_ID);
+        REQUIRE(node.device_type == sim::DEVICE_TYPE);
+        REQUIRE(node.device_profile() == 402);
+        REQUIRE(node.product_code == sim::PRODUCT_CODE);
+        REQUIRE(node.revision == sim::REVISION);
+        REQUIRE(node.serial_number == present[i]);
+        REQUIRE(node.fields == 0x1F);
+    }
+    REQUIRE(result.requests_sent == 127 + 4 * present.size());
+    REQUIRE(result.timeouts == 0);
+    REQUIRE(result.elapsed < 1s);
+}
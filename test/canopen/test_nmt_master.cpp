@@ -0,0 +1,208 @@
+/**
+ * @file test_nmt_master.cpp
+ * @brief Unit tests for NMT master, heartbeat consumer and node guarding
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-17
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "canopen/nmt_master.hpp"
+#include "test_utils_canopen.hpp"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace canopen;
+using namespace test_utils;
+
+namespace {
+
+    can_frame heartbeat(uint8_t node_id, nmt::State state, uint8_t toggle = 0) {
+        can_frame frame{};
+        frame.can_id = nmt::heartbeat_cob_id(node_id);
+        frame.can_dlc = 1;
+        frame.data[0] = static_cast<uint8_t>(state) | toggle;
+        return frame;
+    }
+
+} // namespace
+
+TEST_CASE("NMTMaster: Commands", "[nmt]") {
+    auto socket = std::make_shared<PollableMockCANSocket>();
+    NMTMaster master(socket);
+
+    SECTION("Single node and broadcast frames") {
+        REQUIRE(master.start_node(5));
+        REQUIRE(master.reset_communication());
+        REQUIRE(master.broadcast(nmt::Command::ENTER_PRE_OPERATIONAL));
+
+        auto tx = socket->get_tx_history();
+        REQUIRE(tx.size() == 3);
+        REQUIRE(tx[0].can_id == 0x000);
+        REQUIRE(tx[0].can_dlc == 2);
+        REQUIRE(tx[0].data[0] == 0x01);
+        REQUIRE(tx[0].data[1] == 5);
+        REQUIRE(tx[1].data[0] == 0x82);
+        REQUIRE(tx[1].data[1] == 0);
+        REQUIRE(tx[2].data[0] == 0x80);
+    }
+
+    SECTION("Invalid node IDs") {
+        REQUIRE_FALSE(master.stop_node(128));
+        REQUIRE_THROWS_AS(master.monitor_heartbeat(0, std::chrono::milliseconds(100)),
+            std::invalid_argument);
+        REQUIRE_THROWS_AS(master.monitor_node_guard(1, std::chrono::milliseconds(0)),
+            std::invalid_argument);
+    }
+}
+
+TEST_CASE("NMTMaster: Heartbeat consumer", "[nmt][heartbeat]") {
+    using namespace std::chrono_literals;
+    auto socket = std::make_shared<PollableMockCANSocket>();
+    NMTMaster master(socket);
+
+    std::mutex mutex;
+    std::vector<uint8_t> lost;
+    std::vector<std::pair<nmt::State, nmt::State>> transitions;
+    master.set_node_lost_callback([&](uint8_t node) {
+            std::lock_guard<std::mutex> lock(mutex);
+            lost.push_back(node);
+        });
+    master.set_state_callback([&](uint8_t node, nmt::State previous, nmt::State current) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (node == 3) transitions.emplace_back(previous, current);
+        });
+
+    master.monitor_heartbeat(3, 50ms);
+    master.monitor_heartbeat(4, 50ms);
+    REQUIRE(master.start());
+
+    SECTION("Silent producer is reported lost within one period of the missed heartbeat") {
+        socket->inject(heartbeat(3, nmt::State::PRE_OPERATIONAL));
+        REQUIRE(wait_until([&] { return master.is_node_alive(3); }));
+        auto last = std::chrono::steady_clock::now();
+
+        // Node 4 keeps beating, node 3 goes silent
+        for (int i = 0; i < 6; ++i) {
+            socket->inject(heartbeat(4, nmt::State::OPERATIONAL));
+            std::this_thread::sleep_for(40ms);
+        }
+        REQUIRE(wait_until([&] { return !master.is_node_alive(3); }));
+        auto detected = master.get_node_status(3);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(lost == std::vector<uint8_t>{3});
+        REQUIRE(detected.lost_events == 1);
+        REQUIRE(detected.state == nmt::State::UNKNOWN);
+        REQUIRE(master.is_node_alive(4));
+        // Missed heartbeat was due at last + 50ms; loss reported at last + 75ms
+        REQUIRE(std::chrono::steady_clock::now() - last < 500ms);
+    }
+
+    SECTION("Recovery and state changes are reported") {
+        socket->inject(heartbeat(3, nmt::State::BOOTUP));
+        socket->inject(heartbeat(3, nmt::State::OPERATIONAL));
+        REQUIRE(wait_until([&] { return master.get_node_state(3) == nmt::State::OPERATIONAL; }));
+        REQUIRE(wait_until([&] { return !master.is_node_alive(3); }));
+
+        socket->inject(heartbeat(3, nmt::State::STOPPED));
+        REQUIRE(wait_until([&] { return master.get_node_state(3) == nmt::State::STOPPED; }));
+        master.stop();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(transitions.size() == 4);
+        REQUIRE(transitions[0].second == nmt::State::BOOTUP);
+        REQUIRE(transitions[1].second == nmt::State::OPERATIONAL);
+        REQUIRE(transitions[2] == std::make_pair(nmt::State::OPERATIONAL, nmt::State::UNKNOWN));
+        REQUIRE(transitions[3] == std::make_pair(nmt::State::UNKNOWN, nmt::State::STOPPED));
+        REQUIRE(master.get_node_status(3).messages == 3);
+    }
+
+    SECTION("No deadline before the first heartbeat") {
+        std::this_thread::sleep_for(150ms);
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(lost.empty());
+    }
+}
+
+TEST_CASE("NMTMaster: Node guarding", "[nmt][node_guard]") {
+    using namespace std::chrono_literals;
+    auto socket = std::make_shared<PollableMockCANSocket>();
+    NMTMaster master(socket);
+
+    // Node 7 answers RTRs with an alternating toggle bit unless muted
+    std::atomic<bool> answer{true};
+    std::atomic<bool> break_toggle{false};
+    uint8_t toggle = 0;
+    socket->set_responder([&](const can_frame& request, can_frame& reply) {
+            if (request.can_id != (nmt::heartbeat_cob_id(7) | CAN_RTR_FLAG) || !answer) {
+                return false;
+            }
+            reply = heartbeat(7, nmt::State::OPERATIONAL, toggle);
+            if (!break_toggle) toggle ^= nmt::TOGGLE_BIT;
+            return true;
+        });
+
+    std::atomic<int> lost_count{0};
+    master.set_node_lost_callback([&](uint8_t) { ++lost_count; });
+    master.monitor_node_guard(7, 20ms, 3);
+    REQUIRE(master.start());
+
+    SECTION("Periodic RTR requests keep the node alive") {
+        REQUIRE(wait_until([&] { return master.get_node_status(7).messages >= 5; }));
+        auto status = master.get_node_status(7);
+        REQUIRE(status.alive);
+        REQUIRE(status.mode == NMTMaster::MonitorMode::NODE_GUARD);
+        REQUIRE(status.toggle_errors == 0);
+        REQUIRE(status.state == nmt::State::OPERATIONAL);
+
+        auto tx = socket->get_tx_history();
+        REQUIRE_FALSE(tx.empty());
+        REQUIRE(tx[0].can_id == (0x707 | CAN_RTR_FLAG));
+        REQUIRE(lost_count == 0);
+    }
+
+    SECTION("Toggle errors are counted") {
+        REQUIRE(wait_until([&] { return master.get_node_status(7).messages >= 2; }));
+        break_toggle = true;
+        REQUIRE(wait_until([&] { return master.get_node_status(7).toggle_errors >= 2; }));
+    }
+
+    SECTION("Node lost after guard time x life time factor") {
+        REQUIRE(wait_until([&] { return master.is_node_alive(7); }));
+        answer = false;
+        REQUIRE(wait_until([&] { return lost_count == 1; }, 500ms));
+        REQUIRE(master.get_node_state(7) == nmt::State::UNKNOWN);
+
+        // Requests continue and the node comes back
+        answer = true;
+        REQUIRE(wait_until([&] { return master.is_node_alive(7); }));
+        REQUIRE(lost_count == 1);
+    }
+}
+
+TEST_CASE("NMTMaster: Heartbeat period from dictionary", "[nmt][heartbeat]") {
+    std::filesystem::create_directories("/tmp/canopen_test");
+    std::string path = "/tmp/canopen_test/test_nmt_master.json";
+    {
+        std::ofstream config(path);
+        config << R"({
+            "node_id": 1,
+            "objects": {},
+            "communication_parameters": {"heartbeat_producer_ms": 40}
+        })";
+    }
+    ObjectDictionary dict(path);
+
+    auto socket = std::make_shared<PollableMockCANSocket>();
+    NMTMaster master(socket);
+    master.monitor_heartbeat(1, dict);
+    REQUIRE(master.get_node_status(1).mode == NMTMaster::MonitorMode::HEARTBEAT);
+    REQUIRE(master.start());
+
+    socket->inject(heartbeat(1, nmt::State::OPERATIONAL));
+    REQUIRE(wait_until([&] { return master.is_node_alive(1); }));
+    REQUIRE(wait_until([&] { return !master.is_node_alive(1); }, std::chrono::milliseconds(300)));
+
+    std::filesystem::remove(path);
+}
@@ -370,9 +370,62 @@ TEST_CASE("ObjectDictionary: Load actual motor config", "[object_dictionary][int
             // Verify motor parameters
             REQUIRE_NOTHROW(dict.get_motor_param("max_rpm"));
             REQUIRE_NOTHROW(dict.get_motor_param("encoder_resolution"));
+            REQUIRE(dict.get_communication_param("heartbeat_producer_ms") == 1000.0);
         }
     } else {
         WARN("Actual motor_config.json not found at " << config_path <<
             ", skipping integration test");
     }
 }
+
+TEST_CASE("ObjectDictionary: PDO configuration parsing", "[object_dictionary][pdo]") {
+    std::filesystem::create_directories("/tmp/canopen_test");
+    std::string path = "/tmp/canopen_test/test_pdo_config.json";
+    {
+        std::ofstream config_file(path);
+        config_file << R"({
+            "node_id": 2,
+            "objects": {
+                "statusword": {"index": "0x6041", "subindex": 0, "datatype": "uint16_t",
+                               "access": "ro", "pdo_mapping": "tpdo1"},
+                "position_actual": {"index": "0x6064", "subindex": 0, "datatype": "int32_t",
+                                    "access": "ro", "pdo_mapping": "tpdo1"}
+            },
+            "pdo_configuration": {
+                "tpdo1": {"cob_id": "0x180", "transmission_type": 1,
+                          "inhibit_time_us": 10000, "event_timer_ms": 50,
+                          "objects": ["position_actual", "statusword"]}
+            }
+        })";
+    }
+
+    ObjectDictionary dict(path);
+
+    SECTION("Communication parameters are parsed") {
+        REQUIRE(dict.has_pdo_config("tpdo1"));
+        REQUIRE_FALSE(dict.has_pdo_config("tpdo2"));
+
+        const auto& tpdo1 = dict.get_pdo_config("tpdo1");
+        REQUIRE(tpdo1.cob_id_base == 0x180);
+        REQUIRE(tpdo1.transmission_type == 1);
+        REQUIRE(tpdo1.inhibit_time_us == 10000);
+        REQUIRE(tpdo1.event_timer_ms == 50);
+        REQUIRE(dict.get_pdo_config_names() == std::vector<std::string>{"tpdo1"});
+    }
+
+    SECTION("Configured object order takes precedence") {
+        auto objects = dict.get_pdo_objects("tpdo1");
+        REQUIRE(objects == std::vector<std::string>{"position_actual", "statusword"});
+    }
+
+    SECTION("Missing PDO configuration throws") {
+        REQUIRE_THROWS_WITH(dict.get_pdo_config("rpdo3"), ContainsSubstring("not configured"));
+    }
+
+    SECTION("Signedness follows datatype") {
+        REQUIRE(dict.get_object("position_actual").is_signed());
+        REQUIRE_FALSE(dict.get_object("statusword").is_signed());
+    }
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,313 @@
+/**
+ * @file test_pdo_codec.cpp
+ * @brief Unit tests for the declarative PDO mapping codec
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-12
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include "canopen/pdo_codec.hpp"
+#include "canopen/pdo_manager.hpp"
+#include "canopen/object_dictionary.hpp"
+#include "test_utils_canopen.hpp"
+#include <filesystem>
+#include <fstream>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+using namespace canopen;
+using namespace canopen::pdo;
+using namespace test_utils;
+using Catch::Matchers::ContainsSubstring;
+
+// =============================================================================
+// Test Structs and Layouts
+// =============================================================================
+
+namespace {
+    struct Feedback {
+        uint16_t statusword;
+        int32_t position_counts;
+        double position_rad;
+    };
+
+    struct Command {
+        uint16_t controlword;
+        double velocity_rpm;
+    };
+
+    struct VelocityFeedback {
+        int32_t velocity;
+        int16_t torque;
+    };
+}
+
+template<>
+struct canopen::PDOLayout<Feedback> {
+    static constexpr const char* pdo = "tpdo1";
+    static constexpr auto fields = std::make_tuple(
+        pdo_field("statusword", &Feedback::statusword),
+        pdo_field("position_actual", &Feedback::position_counts),
+        pdo_field("position_actual", &Feedback::position_rad));
+};
+
+template<>
+struct canopen::PDOLayout<Command> {
+    static constexpr const char* pdo = "rpdo1";
+    static constexpr auto fields = std::make_tuple(
+        pdo_field("controlword", &Command::controlword),
+        pdo_field("target_velocity", &Command::velocity_rpm));
+};
+
+template<>
+struct canopen::PDOLayout<VelocityFeedback> {
+    static constexpr const char* pdo = "tpdo2";
+    static constexpr auto fields = std::make_tuple(
+        pdo_field("velocity_actual", &VelocityFeedback::velocity),
+        pdo_field("torque_actual", &VelocityFeedback::torque));
+};
+
+// =============================================================================
+// Test Fixture
+// =============================================================================
+
+struct PDOCodecFixture {
+    std::string config_path = "/tmp/canopen_test/test_pdo_codec_config.json";
+
+    PDOCodecFixture() {
+        std::filesystem::create_directories("/tmp/canopen_test");
+        std::ofstream config_file(config_path);
+        config_file << R"({
+            "node_id": 1,
+            "objects": {
+                "controlword": {"index": "0x6040", "subindex": 0, "datatype": "uint16_t",
+                                "access": "rw", "pdo_mapping": "rpdo1"},
+                "statusword": {"index": "0x6041", "subindex": 0, "datatype": "uint16_t",
+                               "access": "ro", "pdo_mapping": "tpdo1"},
+                "position_actual": {"index": "0x6064", "subindex": 0, "datatype": "int32_t",
+                                    "access": "ro", "pdo_mapping": "tpdo1",
+                                    "scaling_factor": 0.5},
+                "target_velocity": {"index": "0x60FF", "subindex": 0, "datatype": "int32_t",
+                                    "access": "rw", "pdo_mapping": "rpdo1",
+                                    "scaling_factor": 0.1},
+                "velocity_actual": {"index": "0x606C", "subindex": 0, "datatype": "int32_t",
+                                    "access": "ro", "pdo_mapping": "tpdo2"},
+                "torque_actual": {"index": "0x6077", "subindex": 0, "datatype": "int16_t",
+                                  "access": "ro", "pdo_mapping": "tpdo2"},
+                "error_register": {"index": "0x1001", "subindex": 0, "datatype": "uint8_t",
+                                   "access": "ro"}
+            },
+            "pdo_configuration": {
+                "rpdo1": {"cob_id": "0x200", "transmission_type": 1,
+                          "objects": ["controlword", "target_velocity"]},
+                "tpdo1": {"cob_id": "0x180", "transmission_type": 1, "inhibit_time_us": 10000,
+                          "objects": ["statusword", "position_actual"]},
+                "tpdo2": {"cob_id": "0x280", "transmission_type": 1,
+                          "objects": ["velocity_actual", "torque_actual"]}
+            }
+        })";
+    }
+
+    ~PDOCodecFixture() {
+        std::filesystem::remove(config_path);
+    }
+};
+
+// =============================================================================
+// Mapping Compilation Tests
+// =============================================================================
+
+TEST_CASE_METHOD(PDOCodecFixture, "PDOCodec: Mapping compilation", "[pdo_codec][mapping]") {
+    ObjectDictionary dict(config_path);
+
+    SECTION("Offsets follow pdo_configuration order") {
+        auto tpdo1 = PDOMapping::compile(dict, "tpdo1");
+
+        REQUIRE(tpdo1.type() == PDOType::TPDO1);
+        REQUIRE(tpdo1.field_count() == 2);
+        REQUIRE(tpdo1.length() == 6);
+        REQUIRE(tpdo1.field("statusword").offset == 0);
+        REQUIRE(tpdo1.field("statusword").width == 2);
+        REQUIRE(tpdo1.field("statusword").sign_shift == 0);
+        REQUIRE(tpdo1.field("position_actual").offset == 2);
+        REQUIRE(tpdo1.field("position_actual").width == 4);
+        REQUIRE(tpdo1.field("position_actual").sign_shift == 32);
+        REQUIRE(tpdo1.field("position_actual").scale == 0.5);
+    }
+
+    SECTION("Unknown PDO name throws") {
+        REQUIRE_THROWS_WITH(PDOMapping::compile(dict, "xpdo9"),
+            ContainsSubstring("Unknown PDO name"));
+    }
+
+    SECTION("Unmapped object lookup throws") {
+        auto tpdo2 = PDOMapping::compile(dict, "tpdo2");
+        REQUIRE_FALSE(tpdo2.contains("statusword"));
+        REQUIRE_THROWS_WITH(tpdo2.field("statusword"), ContainsSubstring("not mapped"));
+    }
+}
+
+TEST_CASE("PDOCodec: Field layout decode/encode", "[pdo_codec][layout]") {
+    SECTION("Signed 16-bit sign extension") {
+        PDOFieldLayout layout{1, 2, 48, 1.0};
+        uint8_t data[8] = {0x00, 0xFE, 0xFF};
+        REQUIRE(layout.decode(data) == -2);
+    }
+
+    SECTION("Unsigned 32-bit has no sign extension") {
+        PDOFieldLayout layout{0, 4, 0, 1.0};
+        uint8_t data[8] = {0xFF, 0xFF, 0xFF, 0xFF};
+        REQUIRE(layout.decode(data) == 0xFFFFFFFFLL);
+    }
+
+    SECTION("Encode round-trips negative values") {
+        PDOFieldLayout layout{4, 4, 32, 1.0};
+        uint8_t data[8] = {};
+        layout.encode(data, -123456);
+        REQUIRE(layout.decode(data) == -123456);
+        REQUIRE(data[0] == 0);
+    }
+}
+
+// =============================================================================
+// Struct Codec Tests
+// =============================================================================
+
+TEST_CASE_METHOD(PDOCodecFixture, "PDOCodec: Struct pack/unpack", "[pdo_codec][struct]") {
+    ObjectDictionary dict(config_path);
+
+    SECTION("Unpack TPDO1 into typed, scaled struct") {
+        PDOStructCodec<Feedback> codec(PDOMapping::compile(dict, "tpdo1"));
+
+        can_frame frame{};
+        frame.can_id = 0x181;
+        frame.can_dlc = 6;
+        frame.data[0] = 0x37;  // statusword 0x0237
+        frame.data[1] = 0x02;
+        int32_t position = -1000;
+        std::memcpy(&frame.data[2], &position, sizeof(position));
+
+        Feedback fb{};
+        REQUIRE(codec.unpack(frame, fb));
+        REQUIRE(fb.statusword == 0x0237);
+        REQUIRE(fb.position_counts == -1000);
+        REQUIRE(fb.position_rad == -500.0);
+    }
+
+    SECTION("Short frame is rejected") {
+        PDOStructCodec<Feedback> codec(PDOMapping::compile(dict, "tpdo1"));
+        can_frame frame{};
+        frame.can_dlc = 4;
+
+        Feedback fb{};
+        REQUIRE_FALSE(codec.unpack(frame, fb));
+    }
+
+    SECTION("Pack RPDO1 from typed struct") {
+        PDOStructCodec<Command> codec(PDOMapping::compile(dict, "rpdo1"));
+
+        can_frame frame{};
+        codec.pack(Command{0x000F, -12.3}, frame);
+
+        REQUIRE(frame.can_dlc == 6);
+        REQUIRE(frame.data[0] == 0x0F);
+        REQUIRE(frame.data[1] == 0x00);
+        int32_t raw;
+        std::memcpy(&raw, &frame.data[2], sizeof(raw));
+        REQUIRE(raw == -123);
+    }
+
+    SECTION("Binding to an unmapped object throws") {
+        REQUIRE_THROWS_WITH(PDOStructCodec<Feedback>(PDOMapping::compile(dict, "tpdo2")),
+            ContainsSubstring("not mapped"));
+    }
+}
+
+// =============================================================================
+// PDOManager Integration
+// =============================================================================
+
+TEST_CASE_METHOD(PDOCodecFixture, "PDOCodec: Typed callbacks and senders",
+    "[pdo_codec][manager]") {
+    ObjectDictionary dict(config_path);
+    auto socket = std::make_shared<PollableMockCANSocket>();
+    PDOManager manager(socket);
+    PDOCodec codec(manager, dict);
+
+    SECTION("on_tpdo delivers unpacked structs") {
+        std::atomic<int> count{0};
+        std::atomic<int32_t> velocity{0};
+        std::atomic<int16_t> torque{0};
+
+        codec.on_tpdo<VelocityFeedback>(4, [&](const VelocityFeedback& fb) {
+                velocity = fb.velocity;
+                torque = fb.torque;
+                count++;
+            });
+        REQUIRE(manager.start());
+
+        can_frame frame{};
+        frame.can_id = 0x284;
+        frame.can_dlc = 6;
+        int32_t v = 1500;
+        int16_t t = -250;
+        std::memcpy(&frame.data[0], &v, sizeof(v));
+        std::memcpy(&frame.data[4], &t, sizeof(t));
+        socket->inject(frame);
+
+        REQUIRE(wait_until([&] { return count == 1; }));
+        REQUIRE(velocity == 1500);
+        REQUIRE(torque == -250);
+        REQUIRE(manager.get_statistics(4).tpdo2_received == 1);
+        manager.stop();
+    }
+
+    SECTION("Short TPDO is counted as error and not delivered") {
+        std::atomic<int> count{0};
+        codec.on_tpdo<Feedback>(2, [&](const Feedback&) { count++; });
+        REQUIRE(manager.start());
+
+        // Rejected without an exception through dispatch (which would log)
+        std::ostringstream captured;
+        std::streambuf* old_cerr = std::cerr.rdbuf(captured.rdbuf());
+        can_frame frame{};
+        frame.can_id = 0x182;
+        frame.can_dlc = 2;
+        socket->inject(frame);
+
+        bool counted = wait_until([&] { return manager.get_statistics(2).errors == 1; });
+        std::cerr.rdbuf(old_cerr);
+        REQUIRE(counted);
+        REQUIRE(count == 0);
+        REQUIRE(captured.str().find("Callback exception") == std::string::npos);
+        manager.stop();
+    }
+
+    SECTION("rpdo_sender packs and sends on the node COB-ID") {
+        auto sender = codec.rpdo_sender<Command>(3);
+        REQUIRE(sender.send(Command{0x0006, 100.0}));
+
+        auto tx = socket->get_tx_history();
+        REQUIRE(tx.size() == 1);
+        REQUIRE(tx[0].can_id == 0x203);
+        REQUIRE(tx[0].can_dlc == 6);
+        REQUIRE(tx[0].data[0] == 0x06);
+        int32_t raw;
+        std::memcpy(&raw, &tx[0].data[2], sizeof(raw));
+        REQUIRE(raw == 1000);
+        REQUIRE(manager.get_statistics(3).rpdo1_sent == 1);
+    }
+
+    SECTION("Direction mismatch is rejected") {
+        REQUIRE_THROWS_WITH(codec.rpdo_sender<Feedback>(1), ContainsSubstring("not an RPDO"));
+        REQUIRE_THROWS_WITH(codec.on_tpdo<Command>(1, [](const Command&) {}),
+            ContainsSubstring("not a TPDO"));
+    }
+
+    SECTION("Unconfigured PDO throws") {
+        REQUIRE_THROWS_WITH(codec.mapping("tpdo4"), ContainsSubstring("not configured"));
+    }
+}
@@ -0,0 +1,272 @@
+/**
+ * @file test_pdo_configurator.cpp
+ * @brief Unit tests for startup PDO remapping over SDO
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-13
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include "canopen/pdo_configurator.hpp"
+#include "canopen/sdo_client.hpp"
+#include "canopen/object_dictionary.hpp"
+#include "test_utils_canopen.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+using namespace canopen;
+using namespace canopen::pdo::params;
+using namespace test_utils;
+using Catch::Matchers::ContainsSubstring;
+
+// =============================================================================
+// In-Memory SDO Server
+// =============================================================================
+
+namespace {
+    /**
+     * @brief Minimal expedited SDO server backing a pollable mock socket
+     */
+    class MockSDOServer {
+        public:
+            explicit MockSDOServer(uint8_t node_id) : node_id_(node_id) {}
+
+            void attach(PollableMockCANSocket& socket) {
+                socket.set_responder([this](const can_frame& request, can_frame& reply) {
+                        return respond(request, reply);
+                    });
+            }
+
+            uint32_t value(uint16_t index, uint8_t subindex) const {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = objects_.find(key(index, subindex));
+                return it != objects_.end() ? it->second : 0;
+            }
+
+            // Accept writes to this object but never store them (firmware quirk)
+            void ignore_writes_to(uint16_t index, uint8_t subindex) {
+                ignored_ = key(index, subindex);
+            }
+
+            std::vector<std::pair<uint16_t, uint8_t>> writes() const {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return writes_;
+            }
+
+        private:
+            static uint32_t key(uint16_t index, uint8_t subindex) {
+                return (static_cast<uint32_t>(index) << 8) | subindex;
+            }
+
+            bool respond(const can_frame& request, can_frame& reply) {
+                if (request.can_id != 0x600u + node_id_) return false;
+
+                uint8_t cmd = request.data[0];
+                uint16_t index = request.data[1] | (request.data[2] << 8);
+                uint8_t subindex = request.data[3];
+
+                reply.can_id = 0x580 + node_id_;
+                reply.can_dlc = 8;
+                reply.data[1] = request.data[1];
+                reply.data[2] = request.data[2];
+                reply.data[3] = subindex;
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                if ((cmd & 0xE0) == 0x20) {
+                    uint8_t size = 4 - ((cmd >> 2) & 0x03);
+                    uint32_t value = 0;
+                    for (uint8_t i = 0; i < size; ++i) {
+                        value |= static_cast<uint32_t>(request.data[4 + i]) << (8 * i);
+                    }
+                    writes_.emplace_back(index, subindex);
+                    if (key(index, subindex) != ignored_) {
+                        objects_[key(index, subindex)] = value;
+                    }
+                    reply.data[0] = 0x60;
+                } else if (cmd == 0x40) {
+                    uint32_t value = objects_[key(index, subindex)];
+                    reply.data[0] = 0x43;
+                    std::memcpy(&reply.data[4], &value, sizeof(value));
+                }
+                return true;
+            }
+
+            uint8_t node_id_;
+            mutable std::mutex mutex_;
+            std::map<uint32_t, uint32_t> objects_;
+            std::vector<std::pair<uint16_t, uint8_t>> writes_;
+            uint32_t ignored_ = 0xFFFFFFFF;
+    };
+}
+
+// =============================================================================
+// Test Fixture
+// =============================================================================
+
+struct PDOConfiguratorFixture {
+    std::string config_path = "/tmp/canopen_test/test_pdo_configurator.json";
+
+    PDOConfiguratorFixture() {
+        std::filesystem::create_directories("/tmp/canopen_test");
+        std::ofstream config_file(config_path);
+        config_file << R"({
+            "node_id": 1,
+            "objects": {
+                "controlword": {"index": "0x6040", "subindex": 0, "datatype": "uint16_t",
+                                "access": "rw", "pdo_mapping": "rpdo1"},
+                "target_velocity": {"index": "0x60FF", "subindex": 0, "datatype": "int32_t",
+                                    "access": "rw", "pdo_mapping": "rpdo1"},
+                "statusword": {"index": "0x6041", "subindex": 0, "datatype": "uint16_t",
+                               "access": "ro", "pdo_mapping": "tpdo1"},
+                "position_actual": {"index": "0x6064", "subindex": 0, "datatype": "int32_t",
+                                    "access": "ro", "pdo_mapping": "tpdo1"},
+                "torque_actual": {"index": "0x6077", "subindex": 0, "datatype": "int16_t",
+                                  "access": "ro", "pdo_mapping": "tpdo1"}
+            },
+            "pdo_configuration": {
+                "rpdo1": {"cob_id": "0x200", "transmission_type": 1,
+                          "objects": ["controlword", "target_velocity"]},
+                "tpdo1": {"cob_id": "0x180", "transmission_type": 1,
+                          "inhibit_time_us": 10000, "event_timer_ms": 20,
+                          "objects": ["statusword", "position_actual", "torque_actual"]}
+            }
+        })";
+    }
+
+    ~PDOConfiguratorFixture() {
+        std::filesystem::remove(config_path);
+    }
+};
+
+// =============================================================================
+// Sequence Construction
+// =============================================================================
+
+TEST_CASE_METHOD(PDOConfiguratorFixture, "PDOConfigurator: Remap sequence",
+    "[pdo_configurator][sequence]") {
+    ObjectDictionary dict(config_path);
+
+    SECTION("TPDO follows CiA 301 disable-map-enable order") {
+        auto steps = PDOConfigurator::build_sequence(dict, "tpdo1", 5);
+        REQUIRE(steps.size() == 10);
+
+        REQUIRE(steps[0].index == 0x1800);
+        REQUIRE(steps[0].subindex == SUB_COB_ID);
+        REQUIRE(steps[0].value == (0x185 | COB_ID_INVALID));
+
+        REQUIRE(steps[1].index == 0x1A00);
+        REQUIRE(steps[1].subindex == SUB_COUNT);
+        REQUIRE(steps[1].value == 0);
+
+        REQUIRE(steps[2].value == 0x60410010);
+        REQUIRE(steps[3].value == 0x60640020);
+        REQUIRE(steps[4].value == 0x60770010);
+        REQUIRE(steps[5].subindex == SUB_COUNT);
+        REQUIRE(steps[5].value == 3);
+
+        REQUIRE(steps[6].subindex == SUB_TRANSMISSION_TYPE);
+        REQUIRE(steps[6].value == 1);
+        REQUIRE(steps[7].subindex == SUB_INHIBIT_TIME);
+        REQUIRE(steps[7].value == 100);  // 10000 us in 100 us units
+        REQUIRE(steps[8].subindex == SUB_EVENT_TIMER);
+        REQUIRE(steps[8].value == 20);
+
+        REQUIRE(steps[9].index == 0x1800);
+        REQUIRE(steps[9].value == 0x185);
+    }
+
+    SECTION("RPDO has no inhibit time or event timer") {
+        auto steps = PDOConfigurator::build_sequence(dict, "rpdo1", 2);
+        REQUIRE(steps.size() == 7);
+        REQUIRE(steps.front().index == 0x1400);
+        REQUIRE(steps[1].index == 0x1600);
+        REQUIRE(steps.back().value == 0x202);
+    }
+
+    SECTION("Invalid node ID is rejected") {
+        REQUIRE_THROWS_WITH(PDOConfigurator::build_sequence(dict, "tpdo1", 0),
+            ContainsSubstring("Invalid node ID"));
+    }
+}
+
+// =============================================================================
+// Applying Configuration
+// =============================================================================
+
+TEST_CASE_METHOD(PDOConfiguratorFixture, "PDOConfigurator: Configure nodes",
+    "[pdo_configurator][sdo]") {
+    ObjectDictionary dict(config_path);
+    PDOConfigurator configurator(dict);
+    configurator.set_timeout(std::chrono::milliseconds(200));
+
+    SECTION("Single node is remapped and verified") {
+        auto socket = std::make_shared<PollableMockCANSocket>();
+        MockSDOServer server(3);
+        server.attach(*socket);
+        SDOClient client(socket, dict, 3);
+
+        REQUIRE(configurator.configure_node(client));
+
+        REQUIRE(server.value(0x1800, SUB_COB_ID) == 0x183);
+        REQUIRE(server.value(0x1A00, SUB_COUNT) == 3);
+        REQUIRE(server.value(0x1A00, 3) == 0x60770010);
+        REQUIRE(server.value(0x1400, SUB_COB_ID) == 0x203);
+        REQUIRE(server.value(0x1600, SUB_COUNT) == 2);
+
+        // Mapping sub0 is cleared before the first entry is written
+        auto writes = server.writes();
+        auto first_entry = std::find(writes.begin(), writes.end(),
+            std::make_pair<uint16_t, uint8_t>(0x1A00, 1));
+        auto clear = std::find(writes.begin(), writes.end(),
+            std::make_pair<uint16_t, uint8_t>(0x1A00, 0));
+        REQUIRE(clear < first_entry);
+    }
+
+    SECTION("Verification catches values the drive did not keep") {
+        auto socket = std::make_shared<PollableMockCANSocket>();
+        MockSDOServer server(4);
+        server.ignore_writes_to(0x1A00, 2);
+        server.attach(*socket);
+        SDOClient client(socket, dict, 4);
+
+        REQUIRE_FALSE(configurator.configure_node(client));
+        REQUIRE(configurator.configure_node(client, false));
+    }
+
+    SECTION("Silent node times out") {
+        auto socket = std::make_shared<PollableMockCANSocket>();
+        SDOClient client(socket, dict, 9);
+        configurator.set_timeout(std::chrono::milliseconds(20));
+
+        REQUIRE_FALSE(configurator.configure_node(client));
+    }
+
+    SECTION("Multiple nodes are configured in parallel") {
+        constexpr int NODES = 8;
+        std::vector<std::shared_ptr<PollableMockCANSocket>> sockets;
+        std::vector<std::unique_ptr<MockSDOServer>> servers;
+        std::vector<std::unique_ptr<SDOClient>> clients;
+        std::vector<SDOClient*> client_ptrs;
+
+        for (uint8_t node = 1; node <= NODES; ++node) {
+            sockets.push_back(std::make_shared<PollableMockCANSocket>());
+            servers.push_back(std::make_unique<MockSDOServer>(node));
+            servers.back()->attach(*sockets.back());
+            clients.push_back(std::make_unique<SDOClient>(sockets.back(), dict, node));
+            client_ptrs.push_back(clients.back().get());
+        }
+        servers[5]->ignore_writes_to(0x1800, SUB_TRANSMISSION_TYPE);
+
+        auto results = configurator.configure_nodes(client_ptrs);
+
+        REQUIRE(results.size() == NODES);
+        for (uint8_t node = 1; node <= NODES; ++node) {
+            INFO("node " << static_cast<int>(node));
+            REQUIRE(results[node] == (node != 6));
+            REQUIRE(servers[node - 1]->value(0x1400, SUB_COB_ID) == 0x200u + node);
+        }
+    }
+}
@@ -44,10 +44,10 @@ using Catch::Matchers::ContainsSubstring;
 // ==============================================================================
 
 /**
- * @brief Check if vcan_test interface is available
+ * @brief Check if vcan_test (or its in-process stand-in) is available
  */
 bool is_vcan_test_available() {
-    return std::filesystem::exists("/sys/class/net/vcan_test");
+    return is_test_bus_available("vcan_test");
 }
 
 /**
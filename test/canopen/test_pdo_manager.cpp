@@ -11,6 +11,8 @@
 #include "test_utils_canopen.hpp"
 #include <thread>
 #include <chrono>
+#include <atomic>
+#include <future>
 
 using namespace canopen;
 using namespace canopen::pdo;
@@ -28,6 +30,14 @@ namespace {
             std::string get_interface_name() const override { return "mock0"; }
             int get_fd() const override { return 99; }
     };
+
+    can_frame make_tpdo(uint32_t cob_id, uint8_t first_byte = 0) {
+        can_frame frame{};
+        frame.can_id = cob_id;
+        frame.can_dlc = 8;
+        frame.data[0] = first_byte;
+        return frame;
+    }
 }
 
 // =============================================================================
@@ -254,3 +264,300 @@ TEST_CASE("PDOManager: Multi-motor support", "[pdo_manager][multi_motor]") {
         REQUIRE(stats2.tpdo1_received == 0);
     }
 }
+
+// =============================================================================
+// TPDO Dispatch Table Tests
+// =============================================================================
+
+TEST_CASE("PDOManager: TPDO dispatch table", "[pdo_manager][dispatch]") {
+    auto socket = std::make_shared<PollableMockCANSocket>();
+    PDOManager pdo(socket);
+    REQUIRE(pdo.start());
+
+    SECTION("TPDO1 and TPDO2 are routed by COB-ID") {
+        std::atomic<int> tpdo1_count{0};
+        std::atomic<int> tpdo2_count{0};
+
+        std::atomic<uint32_t> tpdo1_id{0};
+        std::atomic<uint32_t> tpdo2_id{0};
+
+        pdo.register_tpdo1_callback(3, [&](const can_frame& f) {
+                tpdo1_id = f.can_id;
+                tpdo1_count++;
+            });
+        pdo.register_tpdo2_callback(3, [&](const can_frame& f) {
+                tpdo2_id = f.can_id;
+                tpdo2_count++;
+            });
+
+        socket->inject(make_tpdo(0x183));
+        socket->inject(make_tpdo(0x283));
+        socket->inject(make_tpdo(0x184));  // No callback registered
+
+        REQUIRE(wait_until([&] { return tpdo1_count == 1 && tpdo2_count == 1; }));
+        REQUIRE(tpdo1_id == 0x183);
+        REQUIRE(tpdo2_id == 0x283);
+        REQUIRE(pdo.get_statistics(3).tpdo1_received == 1);
+        REQUIRE(pdo.get_statistics(3).tpdo2_received == 1);
+    }
+
+    SECTION("Extended and RTR frames are not dispatched") {
+        std::atomic<int> count{0};
+        pdo.register_tpdo1_callback(1, [&](const can_frame&) { count++; });
+
+        socket->inject(make_tpdo(0x181 | CAN_EFF_FLAG));
+        socket->inject(make_tpdo(0x181 | CAN_RTR_FLAG));
+        socket->inject(make_tpdo(0x181));
+
+        REQUIRE(wait_until([&] { return count == 1; }));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        REQUIRE(count == 1);
+    }
+
+    SECTION("Re-registration replaces callback") {
+        std::atomic<int> first{0};
+        std::atomic<int> second{0};
+
+        pdo.register_tpdo1_callback(2, [&](const can_frame&) { first++; });
+        socket->inject(make_tpdo(0x182));
+        REQUIRE(wait_until([&] { return first == 1; }));
+
+        pdo.register_tpdo1_callback(2, [&](const can_frame&) { second++; });
+        socket->inject(make_tpdo(0x182));
+        REQUIRE(wait_until([&] { return second == 1; }));
+        REQUIRE(first == 1);
+    }
+
+    SECTION("Unregistered callbacks stop receiving") {
+        std::atomic<int> count{0};
+        pdo.register_tpdo1_callback(5, [&](const can_frame&) { count++; });
+        socket->inject(make_tpdo(0x185));
+        REQUIRE(wait_until([&] { return count == 1; }));
+
+        pdo.unregister_callbacks(5);
+        socket->inject(make_tpdo(0x185));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        REQUIRE(count == 1);
+    }
+
+    SECTION("Slow callback does not block registration") {
+        std::promise<void> release;
+        auto released = release.get_future().share();
+        std::atomic<bool> in_callback{false};
+
+        pdo.register_tpdo1_callback(6, [&, released](const can_frame&) {
+                in_callback = true;
+                released.wait();
+            });
+        socket->inject(make_tpdo(0x186));
+        REQUIRE(wait_until([&] { return in_callback.load(); }));
+
+        // Registration and unregistration complete while the callback is blocked
+        auto start = std::chrono::steady_clock::now();
+        pdo.register_tpdo1_callback(7, [](const can_frame&) {});
+        pdo.unregister_callbacks(6);
+        REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(100));
+
+        release.set_value();
+    }
+
+    pdo.stop();
+}
+
+// =============================================================================
+// Concurrency Tests (run under -DENABLE_TSAN=ON to check for data races)
+// =============================================================================
+
+TEST_CASE("PDOManager: Concurrent send and receive statistics", "[pdo_manager][concurrency]") {
+    auto socket = std::make_shared<PollableMockCANSocket>();
+    socket->set_record_tx(false);
+    PDOManager pdo(socket);
+
+    constexpr int SENDER_THREADS = 4;
+    constexpr int SENDS_PER_THREAD = 2000;
+    constexpr int TPDO_ROUNDS = 20;
+    constexpr uint8_t NODES = MAX_NODE_ID;
+
+    std::atomic<uint64_t> callback_count{0};
+    for (uint8_t node = MIN_NODE_ID; node <= NODES; ++node) {
+        pdo.register_tpdo1_callback(node, [&](const can_frame&) { callback_count++; });
+        pdo.register_tpdo2_callback(node, [&](const can_frame&) { callback_count++; });
+    }
+    REQUIRE(pdo.start());
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+
+    // RPDO senders spread over every node
+    for (int t = 0; t < SENDER_THREADS; ++t) {
+        threads.emplace_back([&, t] {
+                std::vector<uint8_t> payload = {0x0F, 0x00, 0x10, 0x27, 0x00, 0x00};
+                for (int i = 0; i < SENDS_PER_THREAD; ++i) {
+                    uint8_t node = static_cast<uint8_t>(1 + (t * SENDS_PER_THREAD + i) % NODES);
+                    pdo.send_rpdo1(node, payload);
+                    pdo.send_rpdo2(node, payload);
+                }
+            });
+    }
+
+    // TPDO producer feeding the receive thread
+    threads.emplace_back([&] {
+            for (int round = 0; round < TPDO_ROUNDS; ++round) {
+                for (uint8_t node = MIN_NODE_ID; node <= NODES; ++node) {
+                    socket->inject(make_tpdo(to_cob_base(PDOCobIDBase::TPDO1) + node));
+                    socket->inject(make_tpdo(to_cob_base(PDOCobIDBase::TPDO2) + node));
+                }
+            }
+        });
+
+    // Statistics reader running alongside
+    std::thread reader([&] {
+            while (!done.load()) {
+                for (uint8_t node = MIN_NODE_ID; node <= NODES; ++node) {
+                    (void)pdo.get_statistics(node);
+                }
+            }
+        });
+
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    const uint64_t expected_tpdos = 2ULL * TPDO_ROUNDS * NODES;
+    REQUIRE(wait_until([&] { return callback_count.load() == expected_tpdos; },
+        std::chrono::milliseconds(10000)));
+
+    done.store(true);
+    reader.join();
+    pdo.stop();
+
+    uint64_t rpdo1_total = 0, rpdo2_total = 0, tpdo1_total = 0, tpdo2_total = 0;
+    for (uint8_t node = MIN_NODE_ID; node <= NODES; ++node) {
+        auto stats = pdo.get_statistics(node);
+        rpdo1_total += stats.rpdo1_sent;
+        rpdo2_total += stats.rpdo2_sent;
+        tpdo1_total += stats.tpdo1_received;
+        tpdo2_total += stats.tpdo2_received;
+        REQUIRE(stats.last_tpdo1_time.time_since_epoch().count() > 0);
+    }
+
+    REQUIRE(rpdo1_total == SENDER_THREADS * SENDS_PER_THREAD);
+    REQUIRE(rpdo2_total == SENDER_THREADS * SENDS_PER_THREAD);
+    REQUIRE(tpdo1_total == TPDO_ROUNDS * NODES);
+    REQUIRE(tpdo2_total == TPDO_ROUNDS * NODES);
+}
+
+TEST_CASE("PDOManager: Statistics storage layout", "[pdo_manager][statistics]") {
+    auto socket = std::make_shared<MockCANSocket>();
+    PDOManager pdo(socket);
+
+    SECTION("Per-node records are cache-line aligned") {
+        REQUIRE(alignof(PDOManager::Statistics) == limits::CACHE_LINE_SIZE);
+        REQUIRE(sizeof(PDOManager::Statistics) % limits::CACHE_LINE_SIZE == 0);
+    }
+
+    SECTION("Out-of-range node IDs are rejected") {
+        std::vector<uint8_t> data = {0x01};
+        REQUIRE_FALSE(pdo.send_rpdo1(0, data));
+        REQUIRE_FALSE(pdo.send_rpdo2(128, data));
+        REQUIRE(pdo.get_statistics(200).rpdo2_sent == 0);
+    }
+
+    SECTION("Sent RPDOs are counted per node") {
+        std::vector<uint8_t> data = {0x06, 0x00};
+        REQUIRE(pdo.send_rpdo1(10, data));
+        REQUIRE(pdo.send_rpdo1(10, data));
+        REQUIRE(pdo.send_rpdo2(11, data));
+
+        REQUIRE(pdo.get_statistics(10).rpdo1_sent == 2);
+        REQUIRE(pdo.get_statistics(11).rpdo2_sent == 1);
+        REQUIRE(pdo.get_statistics(11).rpdo1_sent == 0);
+
+        pdo.reset_statistics(10);
+        REQUIRE(pdo.get_statistics(10).rpdo1_sent == 0);
+    }
+}
+
+// =============================================================================
+// Latency Measurement
+// =============================================================================
+
+TEST_CASE("PDOManager: RPDO to TPDO latency", "[pdo_manager][latency]") {
+    auto socket = std::make_shared<PollableMockCANSocket>();
+    PDOManager pdo(socket);
+
+    std::atomic<int> received{0};
+    for (uint8_t node : {5, 6, 7}) {
+        pdo.register_tpdo1_callback(node, [&](const can_frame&) { received++; });
+    }
+    REQUIRE(pdo.start());
+
+    auto inject_and_wait = [&](uint8_t node) {
+            int before = received.load();
+            socket->inject(make_tpdo(0x180 + node, 0x37));
+            REQUIRE(wait_until([&] { return received.load() == before + 1; }));
+        };
+
+    SECTION("RPDO is correlated with the next TPDO from the same node") {
+        REQUIRE(pdo.send_rpdo1(5, {0x0F, 0x00}));
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        inject_and_wait(5);
+
+        auto stats = pdo.get_statistics(5);
+        REQUIRE(stats.latency.count == 1);
+        REQUIRE(stats.latency_max_us >= 2000.0);
+        REQUIRE(stats.latency_p50_us >= 2000.0);
+        REQUIRE(stats.avg_latency_us >= 2000.0);
+
+        // Node 6 had no request: nothing sampled
+        inject_and_wait(6);
+        REQUIRE(pdo.get_statistics(6).latency.count == 0);
+    }
+
+    SECTION("Unsolicited TPDOs are not sampled") {
+        REQUIRE(pdo.send_rpdo1(5, {0x0F, 0x00}));
+        inject_and_wait(5);
+        inject_and_wait(5);
+
+        REQUIRE(pdo.get_statistics(5).latency.count == 1);
+    }
+
+    SECTION("Back-to-back RPDOs measure from the oldest unanswered one") {
+        REQUIRE(pdo.send_rpdo1(7, {0x0F, 0x00}));
+        std::this_thread::sleep_for(std::chrono::milliseconds(3));
+        REQUIRE(pdo.send_rpdo2(7, {0x00, 0x00}));
+        inject_and_wait(7);
+
+        auto stats = pdo.get_statistics(7);
+        REQUIRE(stats.latency.count == 1);
+        REQUIRE(stats.latency_max_us >= 3000.0);
+    }
+
+    SECTION("SYNC is correlated with the first TPDO of each node") {
+        REQUIRE(pdo.send_sync());
+        inject_and_wait(5);
+        inject_and_wait(6);
+        inject_and_wait(6);
+
+        REQUIRE(pdo.get_statistics(5).latency.count == 1);
+        REQUIRE(pdo.get_statistics(6).latency.count == 1);
+        REQUIRE(pdo.get_statistics(7).latency.count == 0);
+
+        REQUIRE(pdo.send_sync());
+        inject_and_wait(6);
+        REQUIRE(pdo.get_statistics(6).latency.count == 2);
+    }
+
+    SECTION("Reset clears latency state") {
+        REQUIRE(pdo.send_rpdo1(5, {0x0F, 0x00}));
+        inject_and_wait(5);
+        pdo.reset_statistics(5);
+
+        auto stats = pdo.get_statistics(5);
+        REQUIRE(stats.latency.count == 0);
+        REQUIRE(stats.avg_latency_us == 0.0);
+        REQUIRE(stats.latency_p99_us == 0.0);
+    }
+
+    pdo.stop();
+}
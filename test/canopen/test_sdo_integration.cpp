@@ -49,10 +49,10 @@ std::string decode_statusword_string(uint16_t statusword) {
     State state = decode_statusword(statusword);
     return state_to_string(state);
 }/**
-  * @brief Check if vcan_test interface is available
+  * @brief Check if vcan_test (or its in-process stand-in) is available
   */
 bool is_vcan_test_available() {
-    return std::filesystem::exists("/sys/class/net/vcan_test");
+    return is_test_bus_available("vcan_test");
 }
 
 /**
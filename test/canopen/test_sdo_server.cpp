@@ -0,0 +1,376 @@
+/**
+ * @file test_sdo_server.cpp
+ * @brief Unit tests for the SDO server (expedited, segmented, block transfers)
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-19
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "canopen/sdo_server.hpp"
+#include "canopen/sdo_client.hpp"
+#include "test_utils_canopen.hpp"
+#include <filesystem>
+#include <fstream>
+
+using namespace canopen;
+using namespace test_utils;
+
+namespace {
+
+    constexpr uint8_t NODE = 3;
+
+    ObjectDictionary make_dictionary() {
+        std::filesystem::create_directories("/tmp/canopen_test");
+        std::string path = "/tmp/canopen_test/test_sdo_server.json";
+        {
+            std::ofstream config(path);
+            config << R"({
+                "node_id": 3,
+                "device_name": "Test IO Node",
+                "objects": {
+                    "controlword": {"index": "0x6040", "subindex": 0, "datatype": "uint16_t",
+                                    "access": "rw"},
+                    "statusword": {"index": "0x6041", "subindex": 0, "datatype": "uint16_t",
+                                   "access": "ro"},
+                    "target_position": {"index": "0x607A", "subindex": 0, "datatype": "int32_t",
+                                        "access": "rw"},
+                    "password": {"index": "0x2000", "subindex": 1, "datatype": "uint32_t",
+                                 "access": "wo"}
+                }
+            })";
+        }
+        ObjectDictionary dict(path);
+        std::filesystem::remove(path);
+        return dict;
+    }
+
+    can_frame request(std::initializer_list<uint8_t> bytes) {
+        can_frame frame{};
+        frame.can_id = 0x600 + NODE;
+        frame.can_dlc = 8;
+        std::size_t i = 0;
+        for (uint8_t byte : bytes) frame.data[i++] = byte;
+        return frame;
+    }
+
+    can_frame segment(uint8_t command, const uint8_t* data, std::size_t length) {
+        can_frame frame = request({command});
+        std::memcpy(&frame.data[1], data, length);
+        return frame;
+    }
+
+    uint32_t le32(const uint8_t* data) {
+        return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+    }
+
+/**
+ * @brief Drives an SDOServer synchronously through process()
+ */
+    struct ServerFixture {
+        ObjectDictionary dict = make_dictionary();
+        std::shared_ptr<PollableMockCANSocket> socket = std::make_shared<PollableMockCANSocket>();
+        SDOServer server{socket, dict};
+
+        can_frame exchange(const can_frame& frame) {
+            socket->clear_tx_history();
+            server.process(frame);
+            auto tx = socket->get_tx_history();
+            REQUIRE(tx.size() == 1);
+            REQUIRE(tx[0].can_id == 0x580u + NODE);
+            return tx[0];
+        }
+
+        std::vector<can_frame> send(const can_frame& frame) {
+            socket->clear_tx_history();
+            server.process(frame);
+            return socket->get_tx_history();
+        }
+    };
+
+    uint32_t abort_code(const can_frame& frame) {
+        REQUIRE(frame.data[0] == 0x80);
+        return le32(&frame.data[4]);
+    }
+
+} // namespace
+
+TEST_CASE_METHOD(ServerFixture, "SDOServer: Expedited transfers", "[sdo_server]") {
+    REQUIRE(server.get_node_id() == NODE);
+    REQUIRE(server.has_object(0x1008, 0));  // device_name
+
+    SECTION("Download then upload") {
+        auto response = exchange(request({0x2B, 0x40, 0x60, 0x00, 0x0F, 0x00}));
+        REQUIRE(response.data[0] == 0x60);
+        REQUIRE(response.data[1] == 0x40);
+        REQUIRE(response.data[2] == 0x60);
+        REQUIRE(server.get<uint16_t>("controlword") == 0x000F);
+
+        server.set<uint16_t>("statusword", 0x0237);
+        response = exchange(request({0x40, 0x41, 0x60, 0x00}));
+        REQUIRE(response.data[0] == 0x4B);
+        REQUIRE(response.data[4] == 0x37);
+        REQUIRE(response.data[5] == 0x02);
+
+        server.set<int32_t>("target_position", -2);
+        response = exchange(request({0x40, 0x7A, 0x60, 0x00}));
+        REQUIRE(response.data[0] == 0x43);
+        REQUIRE(le32(&response.data[4]) == 0xFFFFFFFE);
+    }
+
+    SECTION("Abort codes") {
+        REQUIRE(abort_code(exchange(request({0x40, 0x00, 0x30, 0x00}))) == 0x06020000);
+        REQUIRE(abort_code(exchange(request({0x2B, 0x41, 0x60, 0x00, 1, 0}))) == 0x06010002);
+        REQUIRE(abort_code(exchange(request({0x40, 0x00, 0x20, 0x01}))) == 0x06010001);
+        REQUIRE(abort_code(exchange(request({0x23, 0x40, 0x60, 0x00}))) == 0x06070012);
+        REQUIRE(abort_code(exchange(request({0x2F, 0x40, 0x60, 0x00}))) == 0x06070013);
+        REQUIRE(abort_code(exchange(request({0xE0, 0x40, 0x60, 0x00}))) == 0x05040001);
+        REQUIRE(server.get_statistics().aborts_sent == 6);
+    }
+
+    SECTION("Write-only object accepts downloads") {
+        exchange(request({0x23, 0x00, 0x20, 0x01, 0x78, 0x56, 0x34, 0x12}));
+        REQUIRE(server.get_value(0x2000, 1) == std::vector<uint8_t>{0x78, 0x56, 0x34, 0x12});
+    }
+
+    SECTION("Frames for other nodes are ignored") {
+        can_frame other = request({0x40, 0x41, 0x60, 0x00});
+        other.can_id = 0x604;
+        REQUIRE(send(other).empty());
+    }
+}
+
+TEST_CASE_METHOD(ServerFixture, "SDOServer: Segmented transfers", "[sdo_server]") {
+    SECTION("Upload of a string object") {
+        auto response = exchange(request({0x40, 0x08, 0x10, 0x00}));
+        REQUIRE(response.data[0] == 0x41);
+        REQUIRE(le32(&response.data[4]) == 12);
+
+        response = exchange(request({0x60}));
+        REQUIRE(response.data[0] == 0x00);
+        std::string text(reinterpret_cast<char*>(&response.data[1]), 7);
+
+        response = exchange(request({0x70}));
+        REQUIRE(response.data[0] == (0x10 | (2 << 1) | 0x01));  // toggle, 5 bytes, last
+        text.append(reinterpret_cast<char*>(&response.data[1]), 5);
+        REQUIRE(text == "Test IO Node");
+        REQUIRE(server.get_statistics().segmented == 1);
+    }
+
+    SECTION("Download into a domain object") {
+        server.add_object(0x2100, 0, SDOServer::Access::RW, {});
+        const uint8_t payload[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+
+        auto response = exchange(request({0x21, 0x00, 0x21, 0x00, 10, 0, 0, 0}));
+        REQUIRE(response.data[0] == 0x60);
+        response = exchange(segment(0x00, payload, 7));
+        REQUIRE(response.data[0] == 0x20);
+        response = exchange(segment(0x10 | (4 << 1) | 0x01, payload + 7, 3));
+        REQUIRE(response.data[0] == 0x30);
+
+        REQUIRE(server.get_value(0x2100, 0) ==
+            std::vector<uint8_t>(payload, payload + sizeof(payload)));
+    }
+
+    SECTION("8-byte object needs a segmented upload") {
+        server.add_object(0x2001, 0, SDOServer::Access::RW, std::vector<uint8_t>(8), false);
+        REQUIRE_THROWS_AS(server.set_value(0x2001, 0, {1, 2, 3, 4}), std::invalid_argument);
+        server.set_value(0x2001, 0, {1, 2, 3, 4, 5, 6, 7, 8});
+
+        auto response = exchange(request({0x40, 0x01, 0x20, 0x00}));
+        REQUIRE(response.data[0] == 0x41);
+        REQUIRE(le32(&response.data[4]) == 8);
+        REQUIRE(exchange(request({0x60})).data[0] == 0x00);
+        response = exchange(request({0x70}));
+        REQUIRE(response.data[0] == (0x10 | (6 << 1) | 0x01));
+        REQUIRE(response.data[1] == 8);
+    }
+
+    SECTION("Toggle error and stray segments abort") {
+        exchange(request({0x40, 0x08, 0x10, 0x00}));
+        REQUIRE(abort_code(exchange(request({0x70}))) == 0x05030000);
+        REQUIRE(abort_code(exchange(request({0x60}))) == 0x05040001);
+    }
+}
+
+TEST_CASE_METHOD(ServerFixture, "SDOServer: Block transfers", "[sdo_server]") {
+    std::vector<uint8_t> payload(40);
+    for (std::size_t i = 0; i < payload.size(); ++i) payload[i] = static_cast<uint8_t>(i * 3);
+    server.add_object(0x2200, 0, SDOServer::Access::RW, {});
+    uint16_t crc = sdo::crc16(payload.data(), payload.size());
+
+    SECTION("Download with CRC, a lost segment is resent") {
+        auto response = exchange(request({0xC6, 0x00, 0x22, 0x00, 40, 0, 0, 0}));
+        REQUIRE(response.data[0] == 0xA4);
+        uint8_t block_size = response.data[4];
+        REQUIRE(block_size == 127);
+
+        // 6 segments; segment 3 is lost the first time
+        REQUIRE(send(segment(1, &payload[0], 7)).empty());
+        REQUIRE(send(segment(2, &payload[7], 7)).empty());
+        REQUIRE(send(segment(4, &payload[21], 7)).empty());
+        REQUIRE(send(segment(5, &payload[28], 7)).empty());
+        response = exchange(segment(0x80 | 6, &payload[35], 5));
+        REQUIRE(response.data[0] == 0xA2);
+        REQUIRE(response.data[1] == 2);  // Last segment received in sequence
+
+        REQUIRE(send(segment(1, &payload[14], 7)).empty());
+        REQUIRE(send(segment(2, &payload[21], 7)).empty());
+        REQUIRE(send(segment(3, &payload[28], 7)).empty());
+        response = exchange(segment(0x80 | 4, &payload[35], 5));
+        REQUIRE(response.data[1] == 4);
+
+        response = exchange(request({0xC1 | (2 << 2), static_cast<uint8_t>(crc & 0xFF),
+                                     static_cast<uint8_t>(crc >> 8)}));
+        REQUIRE(response.data[0] == 0xA1);
+        REQUIRE(server.get_value(0x2200, 0) == payload);
+        REQUIRE(server.get_statistics().block == 1);
+    }
+
+    SECTION("CRC mismatch aborts") {
+        exchange(request({0xC6, 0x00, 0x22, 0x00, 7, 0, 0, 0}));
+        exchange(segment(0x80 | 1, payload.data(), 7));
+        auto response = exchange(request({0xC1, 0x00, 0x00}));
+        REQUIRE(abort_code(response) == 0x05040004);
+        REQUIRE(server.get_value(0x2200, 0).empty());
+    }
+
+    SECTION("End with more unused bytes than a segment carries aborts") {
+        exchange(request({0xC0, 0x00, 0x22, 0x00}));
+        exchange(segment(0x80 | 1, payload.data(), 7));
+        auto response = exchange(request({0xC1 | (7 << 2), 0x00, 0x00}));
+        REQUIRE(abort_code(response) == 0x06070010);
+        REQUIRE(server.get_value(0x2200, 0).empty());
+    }
+
+    SECTION("Upload in blocks of 4 segments") {
+        server.set_value(0x2200, 0, payload);
+        auto response = exchange(request({0xA4, 0x00, 0x22, 0x00, 4, 0}));
+        REQUIRE(response.data[0] == 0xC6);
+        REQUIRE(le32(&response.data[4]) == 40);
+
+        std::vector<uint8_t> received;
+        auto block = send(request({0xA3}));
+        REQUIRE(block.size() == 4);
+        for (const auto& frame : block) received.insert(received.end(), &frame.data[1], &frame.data[8]);
+
+        // Acknowledge 3 of 4: segment 4 is sent again in the next block
+        received.resize(21);
+        block = send(request({0xA2, 3, 4}));
+        REQUIRE(block.size() == 3);
+        REQUIRE(block.back().data[0] == (0x80 | 3));
+        for (const auto& frame : block) received.insert(received.end(), &frame.data[1], &frame.data[8]);
+
+        response = exchange(request({0xA2, 3, 4}));
+        REQUIRE((response.data[0] & 0xE3) == 0xC1);
+        std::size_t unused = (response.data[0] >> 2) & 0x07;
+        received.resize(received.size() - unused);
+        REQUIRE(received == payload);
+        REQUIRE((response.data[1] | (response.data[2] << 8)) == crc);
+
+        REQUIRE(send(request({0xA1})).empty());
+        REQUIRE(server.get_statistics().block == 1);
+    }
+
+    SECTION("Invalid block size aborts") {
+        REQUIRE(abort_code(exchange(request({0xA4, 0x00, 0x22, 0x00, 0}))) == 0x05040002);
+    }
+}
+
+TEST_CASE_METHOD(ServerFixture, "SDOServer: Hooks", "[sdo_server]") {
+    int reads = 0;
+    server.on_read("statusword", [&](uint16_t index, uint8_t, std::vector<uint8_t>& data) {
+            REQUIRE(index == 0x6041);
+            data = {static_cast<uint8_t>(++reads), 0};
+            return sdo::AbortCode::NONE;
+        });
+    server.on_write(0x6040, 0, [](uint16_t, uint8_t, const std::vector<uint8_t>& data) {
+            return data[0] & 0x80 ? sdo::AbortCode::DEVICE_STATE : sdo::AbortCode::NONE;
+        });
+
+    REQUIRE(exchange(request({0x40, 0x41, 0x60, 0x00})).data[4] == 1);
+    REQUIRE(exchange(request({0x40, 0x41, 0x60, 0x00})).data[4] == 2);
+    REQUIRE(server.get<uint16_t>("statusword") == 2);
+
+    REQUIRE(abort_code(exchange(request({0x2B, 0x40, 0x60, 0x00, 0x80, 0x00}))) == 0x08000022);
+    REQUIRE(server.get<uint16_t>("controlword") == 0);
+    REQUIRE(exchange(request({0x2B, 0x40, 0x60, 0x00, 0x06, 0x00})).data[0] == 0x60);
+    REQUIRE(server.get<uint16_t>("controlword") == 6);
+
+    REQUIRE_THROWS_AS(server.on_write(0x3000, 0, nullptr), std::out_of_range);
+}
+
+TEST_CASE_METHOD(ServerFixture, "SDOServer: Lookup table", "[sdo_server]") {
+    for (uint16_t index = 0x3000; index < 0x3100; ++index) {
+        for (uint8_t subindex = 0; subindex < 4; ++subindex) {
+            server.add_object(index, subindex, SDOServer::Access::RW,
+                {static_cast<uint8_t>(index), subindex}, false);
+        }
+    }
+    REQUIRE(server.object_count() == 5 + 1024);
+
+    for (uint16_t index = 0x3000; index < 0x3100; ++index) {
+        for (uint8_t subindex = 0; subindex < 4; ++subindex) {
+            REQUIRE(server.get_value(index, subindex) ==
+                std::vector<uint8_t>{static_cast<uint8_t>(index), subindex});
+        }
+    }
+    REQUIRE_FALSE(server.has_object(0x3000, 4));
+    REQUIRE_FALSE(server.has_object(0x3100, 0));
+    REQUIRE_THROWS_AS(server.add_object(0x3000, 0, SDOServer::Access::RO, {}), std::invalid_argument);
+    REQUIRE_THROWS_AS(server.set_value(0x3000, 0, {1}), std::invalid_argument);
+}
+
+TEST_CASE("SDOServer: Built on a sender", "[sdo_server]") {
+    ObjectDictionary dict = make_dictionary();
+    std::vector<can_frame> sent;
+    SDOServer server([&](const can_frame& frame) {
+            sent.push_back(frame);
+            return true;
+        }, dict, 5);
+    REQUIRE_FALSE(server.start());
+
+    can_frame read{};
+    read.can_id = 0x605;
+    read.can_dlc = 8;
+    read.data[0] = 0x40;
+    read.data[1] = 0x41;
+    read.data[2] = 0x60;
+    server.set<uint16_t>("statusword", 0x0237);
+    server.process(read);
+    REQUIRE(sent.size() == 1);
+    REQUIRE(sent[0].can_id == 0x585);
+    REQUIRE(sent[0].data[0] == 0x4B);
+    REQUIRE((sent[0].data[4] | (sent[0].data[5] << 8)) == 0x0237);
+
+    REQUIRE_THROWS_AS(SDOServer(SDOServer::Sender{}, dict), std::runtime_error);
+}
+
+TEST_CASE("SDOServer: Served over a socket", "[sdo_server]") {
+    using namespace std::chrono_literals;
+    ObjectDictionary dict = make_dictionary();
+    auto client_socket = std::make_shared<LinkedMockCANSocket>();
+    auto server_socket = std::make_shared<LinkedMockCANSocket>();
+    client_socket->link(server_socket.get());
+    server_socket->link(client_socket.get());
+
+    SDOServer server(server_socket, dict, 0, 50ms);
+    REQUIRE(server.start());
+
+    SECTION("SDOClient reads and writes") {
+        SDOClient client(client_socket, dict, NODE);
+        REQUIRE(client.write<int32_t>("target_position", 123456));
+        REQUIRE(server.get<int32_t>("target_position") == 123456);
+        server.set<uint16_t>("statusword", 0x0631);
+        REQUIRE(client.read<uint16_t>("statusword") == 0x0631);
+    }
+
+    SECTION("Stalled transfer times out") {
+        can_frame initiate = request({0x40, 0x08, 0x10, 0x00});
+        client_socket->send(initiate);
+        REQUIRE(wait_until([&] { return server.get_statistics().timeouts == 1; }, 500ms));
+
+        auto tx = server_socket->get_tx_history();
+        REQUIRE(tx.size() == 2);
+        REQUIRE(abort_code(tx[1]) == 0x05040000);
+    }
+}
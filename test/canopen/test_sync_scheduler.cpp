@@ -0,0 +1,138 @@
+/**
+ * @file test_sync_scheduler.cpp
+ * @brief Unit tests for the cyclic SYNC/RPDO scheduler
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-14
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include "canopen/sync_scheduler.hpp"
+#include "canopen/pdo_manager.hpp"
+#include "test_utils_canopen.hpp"
+#include <atomic>
+
+using namespace canopen;
+using namespace canopen::pdo;
+using namespace test_utils;
+using Catch::Matchers::ContainsSubstring;
+
+TEST_CASE("SyncScheduler: Configuration", "[sync_scheduler]") {
+    auto socket = std::make_shared<PollableMockCANSocket>();
+    PDOManager manager(socket);
+
+    SECTION("Period below MIN_CYCLE_MS is rejected") {
+        SyncSchedulerConfig config;
+        config.period = std::chrono::microseconds(500);
+        REQUIRE_THROWS_WITH(SyncScheduler(manager, config), ContainsSubstring("MIN_CYCLE_MS"));
+    }
+
+    SECTION("Spin window must be shorter than the period") {
+        SyncSchedulerConfig config;
+        config.period = std::chrono::milliseconds(2);
+        config.spin = std::chrono::milliseconds(2);
+        REQUIRE_THROWS_WITH(SyncScheduler(manager, config), ContainsSubstring("spin"));
+    }
+
+    SECTION("Default period follows RECOMMENDED_CYCLE_MS") {
+        SyncScheduler scheduler(manager);
+        REQUIRE(scheduler.period() == std::chrono::milliseconds(limits::RECOMMENDED_CYCLE_MS));
+    }
+
+    SECTION("Invalid RPDO targets are not queued") {
+        SyncScheduler scheduler(manager);
+        uint8_t data[2] = {0x0F, 0x00};
+        REQUIRE_FALSE(scheduler.queue_rpdo(PDOType::TPDO1, 1, data, 2));
+        REQUIRE_FALSE(scheduler.queue_rpdo(PDOType::RPDO1, 0, data, 2));
+        REQUIRE_FALSE(scheduler.queue_rpdo(PDOType::RPDO1, 1, std::vector<uint8_t>(9)));
+    }
+}
+
+TEST_CASE("SyncScheduler: Cyclic operation", "[sync_scheduler][timing]") {
+    auto socket = std::make_shared<PollableMockCANSocket>();
+    PDOManager manager(socket);
+
+    SyncSchedulerConfig config;
+    config.period = std::chrono::milliseconds(2);
+    config.spin = std::chrono::microseconds(100);
+
+    SECTION("SYNC is emitted every cycle with jitter recorded") {
+        SyncScheduler scheduler(manager, config);
+        REQUIRE(scheduler.start());
+        REQUIRE_FALSE(scheduler.start());
+        REQUIRE(wait_until([&] { return scheduler.get_statistics().cycles >= 20; }));
+        scheduler.stop();
+        REQUIRE_FALSE(scheduler.is_running());
+
+        auto stats = scheduler.get_statistics();
+        REQUIRE(stats.sync_sent == stats.cycles);
+        REQUIRE(stats.jitter.count == stats.cycles);
+        REQUIRE(stats.misses.count == stats.deadline_misses);
+        REQUIRE(stats.send_errors == 0);
+
+        auto tx = socket->get_tx_history();
+        REQUIRE(tx.size() == stats.cycles);
+        for (const auto& frame : tx) {
+            REQUIRE(frame.can_id == 0x080);
+            REQUIRE(frame.can_dlc == 0);
+        }
+    }
+
+    SECTION("Queued RPDOs follow SYNC in the same burst, latest value wins") {
+        SyncScheduler scheduler(manager, config);
+        std::atomic<uint64_t> callbacks{0};
+        scheduler.set_cycle_callback([&](uint64_t) { callbacks++; });
+
+        uint8_t first[2] = {0x06, 0x00};
+        uint8_t second[2] = {0x0F, 0x00};
+        uint8_t velocity[4] = {0x10, 0x27, 0x00, 0x00};
+        REQUIRE(scheduler.queue_rpdo(PDOType::RPDO1, 3, first, 2));
+        REQUIRE(scheduler.queue_rpdo(PDOType::RPDO1, 3, second, 2));
+        REQUIRE(scheduler.queue_rpdo(PDOType::RPDO2, 3, velocity, 4));
+
+        REQUIRE(scheduler.start());
+        REQUIRE(wait_until([&] { return scheduler.get_statistics().cycles >= 3; }));
+        scheduler.stop();
+
+        auto tx = socket->get_tx_history();
+        REQUIRE(tx.size() >= 5);
+        REQUIRE(tx[0].can_id == 0x080);
+        REQUIRE(tx[1].can_id == 0x203);
+        REQUIRE(tx[1].data[0] == 0x0F);
+        REQUIRE(tx[2].can_id == 0x303);
+        REQUIRE(tx[3].can_id == 0x080);  // sent once, not repeated next cycle
+
+        auto stats = scheduler.get_statistics();
+        REQUIRE(stats.rpdos_sent == 2);
+        REQUIRE(callbacks == stats.cycles);
+        REQUIRE(manager.get_statistics(3).rpdo1_sent == 1);
+    }
+
+    SECTION("Cycle callback can queue next cycle's commands") {
+        SyncScheduler scheduler(manager, config);
+        scheduler.set_cycle_callback([&](uint64_t cycle) {
+                uint8_t data[1] = {static_cast<uint8_t>(cycle)};
+                scheduler.queue_rpdo(PDOType::RPDO1, 1, data, 1);
+            });
+
+        REQUIRE(scheduler.start());
+        REQUIRE(wait_until([&] { return scheduler.get_statistics().rpdos_sent >= 5; }));
+        scheduler.stop();
+
+        auto stats = scheduler.get_statistics();
+        REQUIRE(stats.rpdos_sent + 1 >= stats.cycles);
+        REQUIRE(stats.sync_sent == stats.cycles);
+    }
+
+    SECTION("Statistics reset") {
+        SyncScheduler scheduler(manager, config);
+        REQUIRE(scheduler.start());
+        REQUIRE(wait_until([&] { return scheduler.get_statistics().cycles >= 2; }));
+        scheduler.stop();
+        scheduler.reset_statistics();
+
+        auto stats = scheduler.get_statistics();
+        REQUIRE(stats.cycles == 0);
+        REQUIRE(stats.jitter.count == 0);
+    }
+}
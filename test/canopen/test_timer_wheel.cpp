@@ -0,0 +1,103 @@
+/**
+ * @file test_timer_wheel.cpp
+ * @brief Unit tests for the hierarchical timer wheel
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-17
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "canopen/timer_wheel.hpp"
+#include <map>
+#include <vector>
+
+using namespace canopen;
+
+TEST_CASE("TimerWheel: Expiry", "[timer_wheel]") {
+    TimerWheel wheel(8);
+
+    SECTION("Timer fires exactly at its tick") {
+        wheel.schedule(3, 10);
+        std::vector<uint64_t> fired_at;
+        auto record = [&](uint32_t, uint64_t) { fired_at.push_back(wheel.now()); };
+
+        REQUIRE(wheel.advance(9, record) == 0);
+        REQUIRE(wheel.is_scheduled(3));
+        REQUIRE(wheel.advance(10, record) == 1);
+        REQUIRE(fired_at == std::vector<uint64_t>{10});
+        REQUIRE_FALSE(wheel.is_scheduled(3));
+    }
+
+    SECTION("Past ticks fire on the next tick") {
+        wheel.advance(5, [](uint32_t, uint64_t) {});
+        wheel.schedule(0, 2);
+        REQUIRE(wheel.expiry(0) == 6);
+        REQUIRE(wheel.advance(6, [](uint32_t, uint64_t) {}) == 1);
+    }
+
+    SECTION("Reschedule and cancel") {
+        wheel.schedule(1, 5);
+        wheel.schedule(1, 20);
+        wheel.schedule(2, 5);
+        wheel.cancel(2);
+
+        std::vector<uint32_t> fired;
+        wheel.advance(19, [&](uint32_t id, uint64_t) { fired.push_back(id); });
+        REQUIRE(fired.empty());
+        wheel.advance(20, [&](uint32_t id, uint64_t) { fired.push_back(id); });
+        REQUIRE(fired == std::vector<uint32_t>{1});
+    }
+
+    SECTION("Invalid IDs throw") {
+        REQUIRE_THROWS_AS(wheel.schedule(8, 1), std::out_of_range);
+    }
+}
+
+TEST_CASE("TimerWheel: Cascading", "[timer_wheel]") {
+    SECTION("Long delays cascade down to the exact tick") {
+        const std::vector<uint64_t> expiries = {63, 64, 65, 4095, 4096, 4097, 300000,
+                                                TimerWheel::MAX_DELTA + 1000};
+        TimerWheel wheel(expiries.size(), 7);
+        for (uint32_t id = 0; id < expiries.size(); ++id) {
+            wheel.schedule(id, expiries[id] + 7);
+        }
+
+        std::map<uint32_t, uint64_t> fired;
+        wheel.advance(TimerWheel::MAX_DELTA + 2000, [&](uint32_t id, uint64_t) {
+                fired[id] = wheel.now();
+            });
+
+        REQUIRE(fired.size() == expiries.size());
+        for (uint32_t id = 0; id < expiries.size(); ++id) {
+            REQUIRE(fired[id] == expiries[id] + 7);
+        }
+    }
+
+    SECTION("Many timers with mixed delays") {
+        constexpr uint32_t COUNT = 256;
+        TimerWheel wheel(COUNT);
+        for (uint32_t id = 0; id < COUNT; ++id) {
+            wheel.schedule(id, 1 + (id * 97) % 5000);
+        }
+
+        std::size_t late = 0;
+        std::size_t fired = wheel.advance(5000, [&](uint32_t, uint64_t expiry) {
+                if (expiry != wheel.now()) ++late;
+            });
+        REQUIRE(fired == COUNT);
+        REQUIRE(late == 0);
+    }
+
+    SECTION("Periodic timer re-armed from its callback") {
+        TimerWheel wheel(1);
+        wheel.schedule(0, 100);
+
+        std::vector<uint64_t> fired_at;
+        wheel.advance(1000, [&](uint32_t id, uint64_t expiry) {
+                fired_at.push_back(expiry);
+                wheel.schedule(id, expiry + 100);
+            });
+        REQUIRE(fired_at.size() == 10);
+        REQUIRE(fired_at.back() == 1000);
+        REQUIRE(wheel.expiry(0) == 1100);
+    }
+}
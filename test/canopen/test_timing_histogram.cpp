@@ -0,0 +1,74 @@
+/**
+ * @file test_timing_histogram.cpp
+ * @brief Unit tests for the fixed-memory timing histogram
+ * @author effibot (andrea.efficace1@gmail.com)
+ * @date 2025-11-14
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "canopen/timing_histogram.hpp"
+#include <thread>
+#include <vector>
+
+using namespace canopen;
+
+TEST_CASE("TimingHistogram: Bucketing", "[timing_histogram]") {
+    SECTION("Bounds are inclusive") {
+        REQUIRE(TimingHistogram::bucket_for(0) == 0);
+        REQUIRE(TimingHistogram::bucket_for(1'000) == 0);
+        REQUIRE(TimingHistogram::bucket_for(1'001) == 1);
+        REQUIRE(TimingHistogram::bucket_for(1'000'000) == 9);
+    }
+
+    SECTION("Values above 1 s land in the overflow bucket") {
+        REQUIRE(TimingHistogram::bucket_for(5'000'000'000ULL) ==
+            TimingHistogram::BUCKET_COUNT - 1);
+    }
+}
+
+TEST_CASE("TimingHistogram: Percentiles", "[timing_histogram]") {
+    TimingHistogram histogram;
+
+    SECTION("Empty histogram reports zero") {
+        auto snap = histogram.snapshot();
+        REQUIRE(snap.count == 0);
+        REQUIRE(snap.percentile_ns(99.0) == 0);
+        REQUIRE(snap.mean_ns() == 0.0);
+    }
+
+    SECTION("Percentiles return the containing bucket bound") {
+        for (int i = 0; i < 90; ++i) histogram.record(800);        // <= 1 us
+        for (int i = 0; i < 9; ++i) histogram.record(150'000);     // <= 200 us
+        histogram.record(3'000'000);                               // <= 5 ms
+
+        auto snap = histogram.snapshot();
+        REQUIRE(snap.count == 100);
+        REQUIRE(snap.max_ns == 3'000'000);
+        REQUIRE(snap.percentile_ns(50.0) == 1'000);
+        REQUIRE(snap.percentile_ns(95.0) == 200'000);
+        REQUIRE(snap.percentile_ns(100.0) == 3'000'000);  // clamped to max
+    }
+
+    SECTION("Reset clears all buckets") {
+        histogram.record(10);
+        histogram.reset();
+        REQUIRE(histogram.count() == 0);
+        REQUIRE(histogram.snapshot().max_ns == 0);
+    }
+
+    SECTION("Concurrent recording keeps an exact count") {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&histogram, t] {
+                    for (int i = 0; i < 10000; ++i) {
+                        histogram.record(static_cast<uint64_t>(t * 1000 + i));
+                    }
+                });
+        }
+        for (auto& thread : threads) thread.join();
+
+        auto snap = histogram.snapshot();
+        REQUIRE(snap.count == 40000);
+        REQUIRE(snap.max_ns == 3000 + 9999);
+    }
+}
@@ -9,6 +9,7 @@
 
 #include "io/can_socket.hpp"
 #include "io/real_can_socket.hpp"
+#include "io/local_can_bus.hpp"
 #include "canopen/object_dictionary.hpp"
 #include "canopen/cia402_constants.hpp"
 #include <memory>
@@ -17,18 +18,42 @@
 #include <atomic>
 #include <mutex>
 #include <map>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <optional>
 #include <linux/can.h>
 #include <sys/select.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 #include <cstring>
 #include <iostream>
 
 namespace test_utils {
 
+/**
+ * @brief In-process bus standing in for a missing CAN interface
+ * @param interface_name Bus name; one bus per name for the whole test binary
+ */
+    inline std::shared_ptr<waveshare::LocalCANBus> local_test_bus(const std::string& interface_name) {
+        static std::mutex mutex;
+        static std::map<std::string, std::shared_ptr<waveshare::LocalCANBus>> buses;
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& bus = buses[interface_name];
+        if (!bus) {
+            bus = waveshare::LocalCANBus::create(interface_name);
+        }
+        return bus;
+    }
+
 /**
  * @brief Create a CAN socket for testing
  * @param interface_name CAN interface name (default: "vcan_test")
  * @param timeout_ms Socket receive timeout in milliseconds
- * @return Shared pointer to ICANSocket (RealCANSocket implementation)
+ * @return Shared pointer to ICANSocket: a RealCANSocket when the interface
+ *         exists, otherwise an endpoint of local_test_bus(interface_name)
  *
  * This helper function is automatically available to all CANopen tests
  * via CMake target_include_directories configuration.
@@ -37,7 +62,24 @@ namespace test_utils {
         const std::string& interface_name = "vcan_test",
         int timeout_ms = 1000
     ) {
-        return std::make_shared<waveshare::RealCANSocket>(interface_name, timeout_ms);
+        if (std::filesystem::exists("/sys/class/net/" + interface_name)) {
+            return std::make_shared<waveshare::RealCANSocket>(interface_name, timeout_ms);
+        }
+        waveshare::LocalCANSocketConfig config;
+        config.timeout_ms = timeout_ms;
+        return local_test_bus(interface_name)->open(config);
+    }
+
+/**
+ * @brief Check that create_test_socket() can open the interface (or its stand-in)
+ */
+    inline bool is_test_bus_available(const std::string& interface_name = "vcan_test") {
+        try {
+            auto socket = create_test_socket(interface_name);
+            return socket && socket->is_open();
+        } catch (...) {
+            return false;
+        }
     }
 
 /**
@@ -51,6 +93,278 @@ namespace test_utils {
         return canopen::ObjectDictionary("../../config/motor_config.json");
     }
 
+/**
+ * @brief Queue-backed mock CAN socket with a pollable eventfd
+ *
+ * Unlike a plain mock, get_fd() returns a real descriptor that becomes
+ * readable when frames are injected, so receive loops built on select()/poll()
+ * (PDOManager, SDOClient) run unmodified without a vcan interface.
+ */
+    class PollableMockCANSocket : public waveshare::ICANSocket {
+        public:
+            ~PollableMockCANSocket() override { close(); }
+
+            /**
+             * @brief Queue frame for reception (thread-safe)
+             */
+            void inject(const can_frame& frame) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    rx_queue_.push_back(frame);
+                }
+                uint64_t one = 1;
+                (void)::write(efd_, &one, sizeof(one));
+            }
+
+            /**
+             * @brief Get copy of transmitted frames (thread-safe)
+             */
+            std::vector<can_frame> get_tx_history() const {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return tx_history_;
+            }
+
+            void clear_tx_history() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                tx_history_.clear();
+            }
+
+            ssize_t send(const struct can_frame& frame) override {
+                Responder responder;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (record_tx_) {
+                        tx_history_.push_back(frame);
+                    }
+                    responder = responder_;
+                }
+
+                can_frame reply{};
+                if (responder && responder(frame, reply)) {
+                    inject(reply);
+                }
+                return sizeof(can_frame);
+            }
+
+            /**
+             * @brief Reply generator: return true and fill reply to answer a sent frame
+             */
+            using Responder = std::function<bool(const can_frame& request, can_frame& reply)>;
+
+            /**
+             * @brief Install a responder invoked synchronously for every sent frame
+             *
+             * Lets a test emulate a device (e.g. an SDO server) without a thread.
+             */
+            void set_responder(Responder responder) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                responder_ = std::move(responder);
+            }
+
+            ssize_t receive(struct can_frame& frame) override {
+                uint64_t count;
+                if (::read(efd_, &count, sizeof(count)) != sizeof(count)) {
+                    return -1;  // errno = EAGAIN when empty
+                }
+                std::lock_guard<std::mutex> lock(mutex_);
+                frame = rx_queue_.front();
+                rx_queue_.pop_front();
+                return sizeof(can_frame);
+            }
+
+            bool is_open() const override { return efd_ >= 0; }
+
+            void close() override {
+                if (efd_ >= 0) {
+                    ::close(efd_);
+                    efd_ = -1;
+                }
+            }
+
+            std::string get_interface_name() const override { return "pollmock0"; }
+            int get_fd() const override { return efd_; }
+
+            /**
+             * @brief Enable/disable TX history recording (off for stress tests)
+             */
+            void set_record_tx(bool enable) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                record_tx_ = enable;
+            }
+
+        private:
+            int efd_ = ::eventfd(0, EFD_NONBLOCK | EFD_SEMAPHORE);
+            mutable std::mutex mutex_;
+            std::deque<can_frame> rx_queue_;
+            std::vector<can_frame> tx_history_;
+            bool record_tx_ = true;
+            Responder responder_;
+    };
+
+/**
+ * @brief Pollable mock whose transmitted frames are also received by its peers
+ *
+ * Two linked sockets behave like two nodes on one bus, so a master (SDOClient,
+ * NMTMaster) and a device-side component (SDOServer, DriveSimulator) can run
+ * against each other. Link peers before starting any thread on them.
+ */
+    class LinkedMockCANSocket : public PollableMockCANSocket {
+        public:
+            void link(LinkedMockCANSocket* peer) { peers_.push_back(peer); }
+
+            ssize_t send(const struct can_frame& frame) override {
+                PollableMockCANSocket::send(frame);
+                for (auto* peer : peers_) peer->inject(frame);
+                return sizeof(can_frame);
+            }
+
+        private:
+            std::vector<LinkedMockCANSocket*> peers_;
+    };
+
+/**
+ * @brief Poll a predicate until it holds or the timeout expires
+ */
+    template<typename Predicate>
+    bool wait_until(Predicate pred,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(1000)) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (pred()) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return pred();
+    }
+
+/**
+ * @brief In-process CiA 402 drive model answering through pollable mock sockets
+ *
+ * Controlwords arrive either as an SDO download to 0x6040 or as RPDO1 (first
+ * two bytes); the statusword is served by SDO upload of 0x6041 and, when
+ * emit_tpdo is set, reported by TPDO1 in reply to every RPDO1. A transition
+ * delay makes the new state visible only after the drive "settles".
+ */
+    class MockCIA402Drive {
+        public:
+            explicit MockCIA402Drive(uint8_t node_id) : node_id_(node_id) {}
+
+            bool emit_tpdo = true;         ///< Report the state by TPDO1 after each RPDO1
+            bool fault_on_enable = false;  ///< Enter FAULT instead of OPERATION_ENABLED
+            std::chrono::milliseconds transition_delay{0};
+            std::chrono::milliseconds sdo_delay{0};  ///< Time to answer an SDO request
+
+            /**
+             * @brief Install this drive as the only device on both sockets
+             */
+            void attach(PollableMockCANSocket& sdo_socket, PollableMockCANSocket& pdo_socket) {
+                sdo_socket.set_responder([this](const can_frame& request, can_frame& reply) {
+                        return respond_sdo(request, reply);
+                    });
+                pdo_socket.set_responder([this](const can_frame& request, can_frame& reply) {
+                        return respond_pdo(request, reply);
+                    });
+            }
+
+            uint8_t node_id() const { return node_id_; }
+
+            uint16_t statusword() const {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return settle();
+            }
+
+            /**
+             * @brief Answer an SDO request addressed to this node
+             */
+            bool respond_sdo(const can_frame& request, can_frame& reply) {
+                if (request.can_id != 0x600u + node_id_) return false;
+                std::this_thread::sleep_for(sdo_delay);
+
+                uint16_t index = request.data[1] | (request.data[2] << 8);
+                reply.can_id = 0x580 + node_id_;
+                reply.can_dlc = 8;
+                std::memcpy(&reply.data[1], &request.data[1], 3);
+
+                if ((request.data[0] & 0xE0) == 0x20 && index == 0x6040) {
+                    apply(request.data[4] | (request.data[5] << 8));
+                    reply.data[0] = 0x60;
+                } else if (request.data[0] == 0x40 && index == 0x6041) {
+                    uint16_t value = statusword();
+                    reply.data[0] = 0x4B;
+                    reply.data[4] = value & 0xFF;
+                    reply.data[5] = value >> 8;
+                } else {
+                    reply.data[0] = 0x80;  // Abort
+                }
+                return true;
+            }
+
+            /**
+             * @brief Apply an RPDO1 addressed to this node, replying with TPDO1
+             */
+            bool respond_pdo(const can_frame& request, can_frame& reply) {
+                if (request.can_id != 0x200u + node_id_) return false;
+                uint16_t value = apply(request.data[0] | (request.data[1] << 8));
+                return emit_tpdo && make_tpdo(value, reply);
+            }
+
+            /**
+             * @brief Build TPDO1 (statusword + 32-bit position) for this node
+             */
+            bool make_tpdo(uint16_t value, can_frame& frame) const {
+                frame = {};
+                frame.can_id = 0x180 + node_id_;
+                frame.can_dlc = 6;
+                frame.data[0] = value & 0xFF;
+                frame.data[1] = value >> 8;
+                return true;
+            }
+
+        private:
+            using Clock = std::chrono::steady_clock;
+
+            // Caller holds mutex_
+            uint16_t settle() const {
+                if (pending_ && Clock::now() >= pending_at_) {
+                    statusword_ = *pending_;
+                    pending_.reset();
+                }
+                return statusword_;
+            }
+
+            uint16_t apply(uint16_t controlword) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                uint16_t current = settle();
+                uint16_t next = current;
+                uint8_t state = current & 0x6F;
+
+                if (state == 0x08) {
+                    if (controlword & 0x0080) next = 0x0040;
+                } else if ((controlword & 0x0006) == 0x0002) {
+                    next = state == 0x27 ? 0x0007 : 0x0040;  // Quick stop
+                } else if (controlword == 0x0006) {
+                    next = 0x0021;
+                } else if (controlword == 0x0007) {
+                    next = 0x0023;
+                } else if (controlword == 0x000F) {
+                    next = fault_on_enable ? 0x0008 : 0x0027;
+                }
+
+                if (transition_delay.count() > 0 && next != current) {
+                    pending_ = next;
+                    pending_at_ = Clock::now() + transition_delay;
+                    return current;
+                }
+                statusword_ = next;
+                return statusword_;
+            }
+
+            uint8_t node_id_;
+            mutable std::mutex mutex_;
+            mutable uint16_t statusword_ = 0x0040;  // SWITCH_ON_DISABLED
+            mutable std::optional<uint16_t> pending_;
+            Clock::time_point pending_at_{};
+    };
+
 /**
  * @brief Mock CANopen motor responder for integration tests
  *
@@ -356,12 +670,7 @@ namespace test_utils {
             }
 
             static bool is_vcan_available() {
-                try {
-                    auto test_socket = create_test_socket("vcan_test");
-                    return test_socket && test_socket->is_open();
-                } catch (...) {
-                    return false;
-                }
+                return is_test_bus_available("vcan_test");
             }
 
             MockMotorResponder mock_motor;
@@ -6,14 +6,24 @@
  *
  * Provides queue-based simulation of SocketCAN I/O for testing SocketCANBridge
  * and related components without hardware.
+ *
+ * By default injected frames are received at once. After set_timing() the
+ * socket sits on a bus at a given bit rate: every frame occupies the bus for
+ * can_frame_bits() bit times, the transmit and receive queues are bounded,
+ * and frames are received only once they have arrived on the MockClock.
  */
 
 #pragma once
 
 #include "../../include/io/can_socket.hpp"
 #include "../../include/enums/error.hpp"
+#include "../../include/enums/protocol.hpp"
 #include "../../include/exception/waveshare_exception.hpp"
+#include "mock_link_timing.hpp"
 #include <linux/can.h>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <queue>
 #include <vector>
 #include <cerrno>
@@ -23,6 +33,17 @@
 namespace waveshare {
     namespace test {
 
+        /**
+         * @brief Bus model for MockCANSocket::set_timing()
+         */
+        struct MockCANTiming {
+            CANBaud bit_rate = DEFAULT_CAN_BAUD;
+            std::size_t rx_queue_frames = 256;      ///< Arriving frames beyond this are lost
+            std::size_t tx_queue_frames = 10;       ///< send() returns EAGAIN when full
+                                                    ///< (default txqueuelen of CAN netdevs)
+            MockLinkDelay delay;                    ///< Latency and jitter of received frames
+        };
+
         /**
          * @brief Mock CAN socket for testing
          *
@@ -30,6 +51,7 @@ namespace waveshare {
          * - Queue-based RX/TX simulation for can_frame
          * - TX history tracking for verification
          * - Configurable error injection (timeout, I/O errors)
+         * - Optional bus timing (bit rate, bounded queues, latency)
          * - No actual SocketCAN hardware required
          */
         class MockCANSocket : public ICANSocket {
@@ -37,7 +59,7 @@ namespace waveshare {
                 /**
                  * @brief Construct mock CAN socket
                  * @param interface_name Simulated interface name (e.g., "vcan0", "mock0")
-                 * @param timeout_ms Simulated timeout (not actually used in mock)
+                 * @param timeout_ms Receive timeout (used only once timed)
                  */
                 MockCANSocket(const std::string& interface_name, int timeout_ms)
                     : interface_name_(interface_name)
@@ -65,6 +87,21 @@ namespace waveshare {
                         return -1;
                     }
 
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (tx_link_) {
+                        const auto now = clock_->now();
+                        while (!tx_done_.empty() && tx_done_.front() <= now) {
+                            tx_done_.pop_front();
+                        }
+                        if (tx_done_.size() >= timing_.tx_queue_frames) {
+                            ++tx_rejected_;
+                            errno = EAGAIN;
+                            return -1;
+                        }
+                        tx_link_->transmit(frame_time(frame));
+                        tx_done_.push_back(tx_link_->line_free());
+                    }
+
                     // Record transmitted frame
                     tx_history_.push_back(frame);
 
@@ -82,6 +119,24 @@ namespace waveshare {
                         return -1;
                     }
 
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    if (rx_link_ && !simulate_timeout_) {
+                        settle_rx();
+                        if (rx_queue_.empty() && timeout_ms_ > 0) {
+                            // Block like SO_RCVTIMEO, on the mock clock
+                            auto until = clock_->now() +
+                                MockClock::Duration(std::chrono::milliseconds(timeout_ms_));
+                            if (!in_flight_.empty()) {
+                                until = std::min(until, in_flight_.front().at);
+                            }
+                            auto clock = clock_;
+                            lock.unlock();
+                            clock->advance_to(until);
+                            lock.lock();
+                            settle_rx();
+                        }
+                    }
+
                     if (simulate_timeout_ || rx_queue_.empty()) {
                         errno = EAGAIN;  // Timeout
                         return -1;
@@ -113,11 +168,44 @@ namespace waveshare {
 
                 // === Mock Control Interface ===
 
+                /**
+                 * @brief Model the bus at a bit rate from now on
+                 * @param timing Bit rate, queue sizes and delay
+                 * @param clock Clock to share with other mocks (default: a
+                 *        new virtual clock)
+                 */
+                void set_timing(const MockCANTiming& timing,
+                    std::shared_ptr<MockClock> clock = nullptr) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (!clock) {
+                        clock = std::make_shared<MockClock>();
+                    }
+                    timing_ = timing;
+                    clock_ = clock;
+                    rx_link_ = std::make_unique<MockLink>(clock, timing.delay);
+                    tx_link_ = std::make_unique<MockLink>(clock, MockLinkDelay{});
+                }
+
+                /**
+                 * @brief Clock of the timing model (null while untimed)
+                 */
+                std::shared_ptr<MockClock> get_clock() const {
+                    return clock_;
+                }
+
                 /**
                  * @brief Inject CAN frame into RX queue (simulates receiving frame)
                  * @param frame CAN frame to inject
+                 *
+                 * Timed, the frame goes on the bus after earlier injections
+                 * and is received once it has arrived.
                  */
                 void inject_rx_frame(const can_frame& frame) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (rx_link_) {
+                        in_flight_.push_back({rx_link_->transmit(frame_time(frame)), frame});
+                        return;
+                    }
                     rx_queue_.push(frame);
                 }
 
@@ -127,7 +215,7 @@ namespace waveshare {
                  */
                 void inject_rx_frames(const std::vector<can_frame>& frames) {
                     for (const auto& frame : frames) {
-                        rx_queue_.push(frame);
+                        inject_rx_frame(frame);
                     }
                 }
 
@@ -150,9 +238,11 @@ namespace waveshare {
                  * @brief Clear RX queue
                  */
                 void clear_rx_queue() {
+                    std::lock_guard<std::mutex> lock(mutex_);
                     while (!rx_queue_.empty()) {
                         rx_queue_.pop();
                     }
+                    in_flight_.clear();
                 }
 
                 /**
@@ -184,7 +274,34 @@ namespace waveshare {
                  * @return Size of RX queue
                  */
                 std::size_t get_rx_queue_size() const {
-                    return rx_queue_.size();
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    return rx_queue_.size() + in_flight_.size();
+                }
+
+                /**
+                 * @brief Frames still being transmitted (timed only)
+                 */
+                std::size_t get_tx_queue_size() const {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    const auto now = clock_ ? clock_->now() : MockClock::Duration::zero();
+                    return static_cast<std::size_t>(std::count_if(tx_done_.begin(),
+                        tx_done_.end(), [now](MockClock::Duration done) { return done > now; }));
+                }
+
+                /**
+                 * @brief Received frames lost to a full RX queue (timed only)
+                 */
+                std::uint64_t get_rx_overruns() const {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    return rx_overruns_;
+                }
+
+                /**
+                 * @brief Sends refused with EAGAIN (timed only)
+                 */
+                std::uint64_t get_tx_rejected() const {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    return tx_rejected_;
                 }
 
                 /**
@@ -203,6 +320,34 @@ namespace waveshare {
                 }
 
             private:
+                struct Arrival {
+                    MockClock::Duration at;
+                    can_frame frame;
+                };
+
+                MockClock::Duration frame_time(const can_frame& frame) const {
+                    const std::uint64_t bits = can_frame_bits(
+                        std::min<std::uint8_t>(frame.can_dlc, 8), frame.can_id & CAN_EFF_FLAG);
+                    return MockClock::Duration(static_cast<std::int64_t>(
+                        bits * 1000000000ULL / static_cast<std::uint64_t>(
+                            canbaud_to_int(timing_.bit_rate))));
+                }
+
+                /**
+                 * @brief Move arrived frames into the bounded RX queue
+                 */
+                void settle_rx() {
+                    const auto now = clock_->now();
+                    while (!in_flight_.empty() && in_flight_.front().at <= now) {
+                        if (rx_queue_.size() < timing_.rx_queue_frames) {
+                            rx_queue_.push(in_flight_.front().frame);
+                        } else {
+                            ++rx_overruns_;
+                        }
+                        in_flight_.pop_front();
+                    }
+                }
+
                 std::string interface_name_;
                 int timeout_ms_;
                 bool is_open_;
@@ -218,6 +363,17 @@ namespace waveshare {
                 bool simulate_timeout_;
                 bool simulate_send_error_;
                 bool simulate_receive_error_;
+
+                // Timing model (set_timing)
+                mutable std::mutex mutex_;
+                MockCANTiming timing_;
+                std::shared_ptr<MockClock> clock_;
+                std::unique_ptr<MockLink> rx_link_;
+                std::unique_ptr<MockLink> tx_link_;
+                std::deque<Arrival> in_flight_;
+                std::deque<MockClock::Duration> tx_done_;
+                std::uint64_t rx_overruns_ = 0;
+                std::uint64_t tx_rejected_ = 0;
         };
 
     } // namespace test
@@ -0,0 +1,146 @@
+/**
+ * @file mock_link_timing.hpp
+ * @brief Clock and link timing model shared by the mock serial port and CAN socket
+ * @version 1.0
+ * @date 2025-12-01
+ *
+ * A MockLink is one direction of a link: every transfer occupies the line
+ * for its wire time, transfers queue behind each other, and a fixed latency
+ * plus a seeded, uniformly distributed jitter is added before the far end
+ * sees them. Times are read from a MockClock, which is either virtual
+ * (advanced only by the test or by a mock waiting for data, so results do
+ * not depend on the host's scheduling) or the real steady clock.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <thread>
+
+namespace waveshare {
+    namespace test {
+
+        /**
+         * @brief Time source of the timed mocks
+         *
+         * Several mocks may share one clock, e.g. the serial port and the CAN
+         * socket of a bridge under test.
+         */
+        class MockClock {
+            public:
+                using Duration = std::chrono::nanoseconds;
+
+                enum class Mode {
+                    VIRTUAL,    ///< Starts at 0, moves only through advance()
+                    REAL        ///< Steady clock since construction; advance() sleeps
+                };
+
+                explicit MockClock(Mode mode = Mode::VIRTUAL)
+                    : mode_(mode)
+                    , origin_(std::chrono::steady_clock::now()) {}
+
+                Duration now() const {
+                    if (mode_ == Mode::VIRTUAL) {
+                        return Duration(virtual_ns_.load());
+                    }
+                    return std::chrono::duration_cast<Duration>(
+                        std::chrono::steady_clock::now() - origin_);
+                }
+
+                void advance(Duration duration) {
+                    advance_to(now() + duration);
+                }
+
+                /**
+                 * @brief Move to time (never backwards)
+                 */
+                void advance_to(Duration time) {
+                    if (mode_ == Mode::REAL) {
+                        std::this_thread::sleep_until(origin_ + time);
+                        return;
+                    }
+                    std::int64_t current = virtual_ns_.load();
+                    while (current < time.count() &&
+                        !virtual_ns_.compare_exchange_weak(current, time.count())) {
+                    }
+                }
+
+                bool is_virtual() const {
+                    return mode_ == Mode::VIRTUAL;
+                }
+
+            private:
+                Mode mode_;
+                std::chrono::steady_clock::time_point origin_;
+                std::atomic<std::int64_t> virtual_ns_{0};
+        };
+
+        /**
+         * @brief Delay added to every delivery on a link
+         */
+        struct MockLinkDelay {
+            std::chrono::nanoseconds latency{0};    ///< Fixed part (USB polling, driver)
+            std::chrono::nanoseconds jitter{0};     ///< Uniform extra delay in [0, jitter]
+            std::uint32_t seed = 1;                 ///< Same seed, same jitter sequence
+        };
+
+        /**
+         * @brief One direction of a link
+         */
+        class MockLink {
+            public:
+                using Duration = MockClock::Duration;
+
+                MockLink(std::shared_ptr<MockClock> clock, const MockLinkDelay& delay)
+                    : clock_(std::move(clock))
+                    , delay_(delay)
+                    , random_(delay.seed) {}
+
+                /**
+                 * @brief Put a transfer on the line
+                 * @param wire_time Time the transfer occupies the line
+                 * @return Time the far end sees it; never earlier than the
+                 *         previous transfer, so jitter does not reorder
+                 */
+                Duration transmit(Duration wire_time) {
+                    line_free_ = std::max(clock_->now(), line_free_) + wire_time;
+                    Duration arrival = line_free_ + delay_.latency;
+                    if (delay_.jitter.count() > 0) {
+                        std::uniform_int_distribution<std::int64_t> jitter(0,
+                            delay_.jitter.count());
+                        arrival += Duration(jitter(random_));
+                    }
+                    last_arrival_ = std::max(arrival, last_arrival_);
+                    return last_arrival_;
+                }
+
+                /**
+                 * @brief Wire time still queued on the line
+                 */
+                Duration backlog() const {
+                    return std::max(Duration::zero(), line_free_ - clock_->now());
+                }
+
+                Duration line_free() const {
+                    return line_free_;
+                }
+
+                MockClock& clock() const {
+                    return *clock_;
+                }
+
+            private:
+                std::shared_ptr<MockClock> clock_;
+                MockLinkDelay delay_;
+                std::mt19937 random_;
+                Duration line_free_{0};
+                Duration last_arrival_{0};
+        };
+
+    } // namespace test
+} // namespace waveshare
@@ -6,13 +6,23 @@
  *
  * Provides queue-based simulation of serial port I/O for testing USBAdapter
  * and related components without hardware.
+ *
+ * By default injected data is readable at once. After set_timing() the port
+ * behaves like the USB-CAN-A link at a given baud rate: bytes take 10 bit
+ * times each way, the driver buffers are bounded, and reads see data only
+ * once it has arrived on the MockClock.
  */
 
 #pragma once
 
 #include "../../include/io/serial_port.hpp"
 #include "../../include/enums/error.hpp"
+#include "../../include/enums/protocol.hpp"
 #include "../../include/exception/waveshare_exception.hpp"
+#include "mock_link_timing.hpp"
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <queue>
 #include <vector>
 #include <cstring>
@@ -22,6 +32,17 @@
 namespace waveshare {
     namespace test {
 
+        /**
+         * @brief Link model for MockSerialPort::set_timing()
+         */
+        struct MockSerialTiming {
+            SerialBaud baud = DEFAULT_SERIAL_BAUD;
+            std::size_t rx_buffer_bytes = 4096;     ///< Arriving bytes beyond this are lost
+            std::size_t tx_buffer_bytes = 4096;     ///< write() returns EAGAIN when full
+            std::chrono::milliseconds read_wait{1}; ///< Wait of read(..., -1) for data
+            MockLinkDelay delay;                    ///< Latency and jitter toward the host
+        };
+
         /**
          * @brief Mock serial port for testing
          *
@@ -29,6 +50,7 @@ namespace waveshare {
          * - Queue-based RX/TX simulation
          * - TX history tracking for verification
          * - Configurable error injection (timeout, I/O errors)
+         * - Optional link timing (baud rate, bounded buffers, latency)
          * - No actual hardware required
          */
         class MockSerialPort : public ISerialPort {
@@ -62,6 +84,22 @@ namespace waveshare {
                         return -1;
                     }
 
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (tx_link_) {
+                        // Accept what fits in the driver buffer, like a
+                        // non-blocking tty
+                        std::size_t queued = wire_bytes(tx_link_->backlog());
+                        std::size_t room = timing_.tx_buffer_bytes -
+                            std::min(queued, timing_.tx_buffer_bytes);
+                        if (room == 0) {
+                            ++tx_rejected_;
+                            errno = EAGAIN;
+                            return -1;
+                        }
+                        len = std::min(len, room);
+                        tx_link_->transmit(wire_time(len));
+                    }
+
                     // Record transmitted data
                     const uint8_t* bytes = static_cast<const uint8_t*>(data);
                     std::vector<uint8_t> frame(bytes, bytes + len);
@@ -70,9 +108,12 @@ namespace waveshare {
                     return static_cast<ssize_t>(len);
                 }
 
+                /**
+                 * @note Untimed, timeout_ms is ignored. Timed, a read with
+                 *       nothing buffered waits up to timeout_ms (read_wait
+                 *       for -1) on the clock for the next arrival.
+                 */
                 ssize_t read(void* data, std::size_t len, int timeout_ms) override {
-                    (void)timeout_ms;  // Mock doesn't use timeout for simplicity
-
                     if (!is_open_) {
                         errno = EBADF;
                         return -1;
@@ -83,6 +124,11 @@ namespace waveshare {
                         return -1;
                     }
 
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    if (rx_link_ && !simulate_timeout_) {
+                        return read_timed(static_cast<uint8_t*>(data), len, timeout_ms, lock);
+                    }
+
                     if (simulate_timeout_ || rx_queue_.empty()) {
                         errno = EAGAIN;  // Timeout
                         return -1;
@@ -117,11 +163,44 @@ namespace waveshare {
 
                 // === Mock Control Interface ===
 
+                /**
+                 * @brief Model the link at a baud rate from now on
+                 * @param timing Baud rate, buffer sizes and delay
+                 * @param clock Clock to share with other mocks (default: a
+                 *        new virtual clock)
+                 */
+                void set_timing(const MockSerialTiming& timing,
+                    std::shared_ptr<MockClock> clock = nullptr) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (!clock) {
+                        clock = std::make_shared<MockClock>();
+                    }
+                    timing_ = timing;
+                    clock_ = clock;
+                    rx_link_ = std::make_unique<MockLink>(clock, timing.delay);
+                    tx_link_ = std::make_unique<MockLink>(clock, MockLinkDelay{});
+                }
+
+                /**
+                 * @brief Clock of the timing model (null while untimed)
+                 */
+                std::shared_ptr<MockClock> get_clock() const {
+                    return clock_;
+                }
+
                 /**
                  * @brief Inject data into RX queue (simulates receiving data)
                  * @param data Data to inject
+                 *
+                 * Timed, the bytes go on the line after earlier injections
+                 * and become readable once they have arrived.
                  */
                 void inject_rx_data(const std::vector<uint8_t>& data) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (rx_link_) {
+                        in_flight_.push_back({rx_link_->transmit(wire_time(data.size())), data});
+                        return;
+                    }
                     rx_queue_.push(data);
                 }
 
@@ -131,7 +210,7 @@ namespace waveshare {
                  */
                 void inject_rx_frames(const std::vector<std::vector<uint8_t> >& frames) {
                     for (const auto& frame : frames) {
-                        rx_queue_.push(frame);
+                        inject_rx_data(frame);
                     }
                 }
 
@@ -154,9 +233,12 @@ namespace waveshare {
                  * @brief Clear RX queue
                  */
                 void clear_rx_queue() {
+                    std::lock_guard<std::mutex> lock(mutex_);
                     while (!rx_queue_.empty()) {
                         rx_queue_.pop();
                     }
+                    in_flight_.clear();
+                    rx_buffer_.clear();
                 }
 
                 /**
@@ -185,13 +267,97 @@ namespace waveshare {
 
                 /**
                  * @brief Get number of frames waiting in RX queue
-                 * @return Size of RX queue
+                 * @return Size of RX queue (timed: injections still on the line)
                  */
                 std::size_t get_rx_queue_size() const {
-                    return rx_queue_.size();
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    return rx_link_ ? in_flight_.size() : rx_queue_.size();
+                }
+
+                /**
+                 * @brief Received bytes lost to a full RX buffer (timed only)
+                 */
+                std::uint64_t get_rx_overrun_bytes() const {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    return rx_overrun_bytes_;
+                }
+
+                /**
+                 * @brief Writes refused with EAGAIN (timed only)
+                 */
+                std::uint64_t get_tx_rejected() const {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    return tx_rejected_;
                 }
 
             private:
+                struct Arrival {
+                    MockClock::Duration at;
+                    std::vector<uint8_t> bytes;
+                };
+
+                static constexpr std::uint64_t BITS_PER_BYTE = 10;  // 8N1
+                static constexpr std::uint64_t NS_PER_S = 1000000000;
+
+                MockClock::Duration wire_time(std::size_t bytes) const {
+                    return MockClock::Duration(static_cast<std::int64_t>(
+                        bytes * BITS_PER_BYTE * NS_PER_S / to_speed_t(timing_.baud)));
+                }
+
+                std::size_t wire_bytes(MockClock::Duration time) const {
+                    const std::uint64_t bits = static_cast<std::uint64_t>(time.count()) *
+                        to_speed_t(timing_.baud);
+                    const std::uint64_t per_byte = BITS_PER_BYTE * NS_PER_S;
+                    return static_cast<std::size_t>((bits + per_byte - 1) / per_byte);
+                }
+
+                /**
+                 * @brief Move arrived bytes into the bounded RX buffer
+                 */
+                void settle_rx() {
+                    const auto now = clock_->now();
+                    while (!in_flight_.empty() && in_flight_.front().at <= now) {
+                        const auto& bytes = in_flight_.front().bytes;
+                        std::size_t room = timing_.rx_buffer_bytes -
+                            std::min(rx_buffer_.size(), timing_.rx_buffer_bytes);
+                        std::size_t kept = std::min(room, bytes.size());
+                        rx_buffer_.insert(rx_buffer_.end(), bytes.begin(),
+                            bytes.begin() + static_cast<std::ptrdiff_t>(kept));
+                        rx_overrun_bytes_ += bytes.size() - kept;
+                        in_flight_.pop_front();
+                    }
+                }
+
+                ssize_t read_timed(uint8_t* data, std::size_t len, int timeout_ms,
+                    std::unique_lock<std::mutex>& lock) {
+                    settle_rx();
+                    if (rx_buffer_.empty()) {
+                        MockClock::Duration wait = timeout_ms >= 0 ?
+                            MockClock::Duration(std::chrono::milliseconds(timeout_ms)) :
+                            MockClock::Duration(timing_.read_wait);
+                        if (wait.count() > 0) {
+                            auto until = clock_->now() + wait;
+                            if (!in_flight_.empty()) {
+                                until = std::min(until, in_flight_.front().at);
+                            }
+                            auto clock = clock_;
+                            lock.unlock();
+                            clock->advance_to(until);
+                            lock.lock();
+                            settle_rx();
+                        }
+                    }
+                    if (rx_buffer_.empty()) {
+                        errno = EAGAIN;
+                        return -1;
+                    }
+                    std::size_t count = std::min(len, rx_buffer_.size());
+                    std::copy_n(rx_buffer_.begin(), count, data);
+                    rx_buffer_.erase(rx_buffer_.begin(),
+                        rx_buffer_.begin() + static_cast<std::ptrdiff_t>(count));
+                    return static_cast<ssize_t>(count);
+                }
+
                 std::string device_path_;
                 bool is_open_;
                 int fd_;
@@ -206,6 +372,17 @@ namespace waveshare {
                 bool simulate_timeout_;
                 bool simulate_write_error_;
                 bool simulate_read_error_;
+
+                // Timing model (set_timing)
+                mutable std::mutex mutex_;
+                MockSerialTiming timing_;
+                std::shared_ptr<MockClock> clock_;
+                std::unique_ptr<MockLink> rx_link_;
+                std::unique_ptr<MockLink> tx_link_;
+                std::deque<Arrival> in_flight_;
+                std::deque<uint8_t> rx_buffer_;
+                std::uint64_t rx_overrun_bytes_ = 0;
+                std::uint64_t tx_rejected_ = 0;
         };
 
     } // namespace test
@@ -0,0 +1,298 @@
+/**
+ * @file test_adapter_emulator.cpp
+ * @brief Unit tests for the pty USB-CAN-A emulator
+ * @version 1.0
+ * @date 2025-11-30
+ *
+ * The host side is the real stack: RealSerialPort on the pty slave, under
+ * USBAdapter and USBCANSocket.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../include/io/capture_writer.hpp"
+#include "../include/io/usb_can_socket.hpp"
+#include "../include/pattern/adapter_emulator.hpp"
+#include "../include/pattern/usb_adapter.hpp"
+
+using namespace waveshare;
+using namespace std::chrono_literals;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct can_frame make_frame(canid_t id, std::uint8_t first, std::uint8_t dlc = 8) {
+        struct can_frame frame;
+        std::memset(&frame, 0, sizeof(frame));
+        frame.can_id = id;
+        frame.can_dlc = dlc;
+        frame.data[0] = first;
+        return frame;
+    }
+
+    bool wait_for(const std::function<bool ()>& done, std::chrono::milliseconds timeout = 1000ms) {
+        auto deadline = Clock::now() + timeout;
+        while (!done()) {
+            if (Clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    }
+
+    void configure(USBAdapter& adapter, CANBaud baud, CANMode mode, std::uint32_t filter = 0,
+        std::uint32_t mask = 0) {
+        adapter.send_frame(ConfigFrame(Type::CONF_VARIABLE, baud, mode, RTX::AUTO, filter, mask,
+            CANVersion::STD_FIXED));
+    }
+
+    USBCANSocketConfig socket_config() {
+        USBCANSocketConfig config;
+        config.receive_timeout_ms = 500;
+        config.read_timeout_ms = 10;
+        return config;
+    }
+}
+
+TEST_CASE("AdapterEmulator - ConfigFrames set the adapter state", "[emulator]") {
+    AdapterEmulator emulator;
+    emulator.start();
+    auto adapter = USBAdapter::create(emulator.get_slave_path(), SerialBaud::BAUD_2M);
+
+    adapter->send_frame(ConfigFrame(Type::CONF_FIXED, CANBaud::BAUD_250K, CANMode::SILENT,
+        RTX::OFF, 0x120, 0x7F0, CANVersion::STD_FIXED));
+    REQUIRE(wait_for([&] { return emulator.get_statistics().config_frames == 1; }));
+
+    auto state = emulator.get_state();
+    REQUIRE(state.can_baud == CANBaud::BAUD_250K);
+    REQUIRE(state.can_mode == CANMode::SILENT);
+    REQUIRE(state.auto_rtx == RTX::OFF);
+    REQUIRE(state.filter == 0x120);
+    REQUIRE(state.mask == 0x7F0);
+    REQUIRE(state.config_type == Type::CONF_FIXED);
+
+    // Line noise is skipped and the next frame still parses
+    const std::uint8_t noise[] = {0x00, 0x13, 0xAA, 0x07};
+    adapter->send_encoded(noise, sizeof(noise));
+    configure(*adapter, CANBaud::BAUD_1M, CANMode::NORMAL);
+    REQUIRE(wait_for([&] { return emulator.get_statistics().config_frames == 2; }));
+    REQUIRE(emulator.get_statistics().skipped_bytes == sizeof(noise));
+    REQUIRE(emulator.get_state().can_baud == CANBaud::BAUD_1M);
+}
+
+TEST_CASE("AdapterEmulator - Host frames by CAN mode", "[emulator]") {
+    AdapterEmulatorConfig config;
+    config.echo = true;
+    AdapterEmulator emulator(config);
+    std::mutex mutex;
+    std::vector<struct can_frame> on_bus;
+    emulator.on_transmit([&](const struct can_frame& frame) {
+            std::lock_guard<std::mutex> lock(mutex);
+            on_bus.push_back(frame);
+        });
+    emulator.start();
+
+    std::shared_ptr<USBAdapter> adapter = USBAdapter::create(emulator.get_slave_path(),
+        SerialBaud::BAUD_2M);
+    const auto sent = make_frame(0x18FF0001 | CAN_EFF_FLAG, 0x42);
+
+    SECTION("NORMAL transmits on the bus; the echo node answers") {
+        configure(*adapter, CANBaud::BAUD_1M, CANMode::NORMAL);
+        USBCANSocket socket(adapter, socket_config());
+        REQUIRE(socket.send(sent) == sizeof(sent));
+
+        struct can_frame echo;
+        REQUIRE(socket.receive(echo) == sizeof(echo));
+        REQUIRE(echo.can_id == sent.can_id);
+        REQUIRE(echo.data[0] == 0x42);
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(on_bus.size() == 1);
+        REQUIRE(on_bus[0].can_id == sent.can_id);
+    }
+
+    SECTION("LOOPBACK returns the frame without using the bus") {
+        configure(*adapter, CANBaud::BAUD_1M, CANMode::LOOPBACK);
+        USBCANSocket socket(adapter, socket_config());
+        REQUIRE(socket.send(sent) == sizeof(sent));
+
+        struct can_frame looped;
+        REQUIRE(socket.receive(looped) == sizeof(looped));
+        REQUIRE(looped.can_id == sent.can_id);
+        REQUIRE(emulator.get_statistics().bus_frames == 0);
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(on_bus.empty());
+    }
+
+    SECTION("SILENT never transmits") {
+        configure(*adapter, CANBaud::BAUD_1M, CANMode::SILENT);
+        USBCANSocket socket(adapter, socket_config());
+        REQUIRE(socket.send(sent) == sizeof(sent));
+        REQUIRE(wait_for([&] { return emulator.get_statistics().not_sent == 1; }));
+        REQUIRE(emulator.get_statistics().bus_frames == 0);
+    }
+}
+
+TEST_CASE("AdapterEmulator - Host frame format follows the ConfigFrame type", "[emulator]") {
+    AdapterEmulator emulator;
+    emulator.start();
+    auto adapter = USBAdapter::create(emulator.get_slave_path(), SerialBaud::BAUD_2M);
+
+    adapter->send_frame(ConfigFrame(Type::CONF_FIXED, CANBaud::BAUD_1M, CANMode::NORMAL,
+        RTX::AUTO, 0, 0, CANVersion::STD_FIXED));
+    REQUIRE(wait_for([&] { return emulator.get_statistics().config_frames == 1; }));
+    emulator.inject(make_frame(0x181, 0x42, 2));
+
+    // 20-byte fixed frame, nothing else
+    auto frame = adapter->receive_fixed_frame(1000);
+    std::uint8_t extra;
+    REQUIRE(adapter->receive_bytes(&extra, 1, 50) == 0);
+    REQUIRE(frame.get_can_id() == 0x181);
+    REQUIRE(frame.get_dlc() == 2);
+    REQUIRE(frame.get_data()[0] == 0x42);
+
+    // Back to variable frames
+    configure(*adapter, CANBaud::BAUD_1M, CANMode::NORMAL);
+    REQUIRE(wait_for([&] { return emulator.get_statistics().config_frames == 2; }));
+    emulator.inject(make_frame(0x182, 0x43, 2));
+    auto variable = adapter->receive_variable_frame(1000);
+    REQUIRE(variable.get_can_id() == 0x182);
+    REQUIRE(variable.get_data()[0] == 0x43);
+}
+
+TEST_CASE("AdapterEmulator - Acceptance filter and bus timing", "[emulator]") {
+    AdapterEmulator emulator;
+    emulator.start();
+    std::shared_ptr<USBAdapter> adapter = USBAdapter::create(emulator.get_slave_path(),
+        SerialBaud::BAUD_2M);
+    configure(*adapter, CANBaud::BAUD_125K, CANMode::NORMAL, 0x100, 0x700);
+    REQUIRE(wait_for([&] { return emulator.get_statistics().config_frames == 1; }));
+    USBCANSocket socket(adapter, socket_config());
+
+    // Every other frame is outside 0x100-0x1FF, but all of them use the bus
+    constexpr std::size_t FRAMES = 40;
+    auto start = Clock::now();
+    for (std::size_t i = 0; i < FRAMES; ++i) {
+        emulator.inject(make_frame((i % 2 ? 0x200 : 0x100) + static_cast<canid_t>(i),
+            static_cast<std::uint8_t>(i)));
+    }
+    for (std::size_t i = 0; i < FRAMES; i += 2) {
+        struct can_frame frame;
+        REQUIRE(socket.receive(frame) == sizeof(frame));
+        REQUIRE(frame.can_id == 0x100 + i);
+        REQUIRE(frame.data[0] == i);
+    }
+    auto elapsed = Clock::now() - start;
+
+    // The last accepted frame ends after FRAMES - 1 bus slots
+    auto slot = std::chrono::duration<double>(can_frame_bits(8, false) / 125000.0);
+    REQUIRE(elapsed >= std::chrono::duration_cast<Clock::duration>(slot * (FRAMES - 1) * 0.9));
+    REQUIRE(wait_for([&] { return emulator.get_statistics().filtered == FRAMES / 2; }));
+    REQUIRE(emulator.get_statistics().delivered == FRAMES / 2);
+}
+
+TEST_CASE("AdapterEmulator - Capture replay", "[emulator]") {
+    const std::string path = "/tmp/test_adapter_emulator.wscap";
+    constexpr std::size_t RECORDS = 10;
+    {
+        FILE* file = std::fopen(path.c_str(), "wb");
+        REQUIRE(file != nullptr);
+        CaptureWriter writer(::fileno(file), CaptureFormat::BINARY);
+        for (std::size_t i = 0; i < RECORDS; ++i) {
+            // 5 ms apart, from an arbitrary epoch
+            REQUIRE(writer.write(make_frame(0x181, static_cast<std::uint8_t>(i), 2),
+                1700000000000000ULL + 5000 * i));
+        }
+        writer.stop();
+        std::fclose(file);
+    }
+
+    AdapterEmulator emulator;
+    emulator.start();
+    std::shared_ptr<USBAdapter> adapter = USBAdapter::create(emulator.get_slave_path(),
+        SerialBaud::BAUD_2M);
+    configure(*adapter, CANBaud::BAUD_1M, CANMode::NORMAL);
+    REQUIRE(wait_for([&] { return emulator.get_statistics().config_frames == 1; }));
+    USBCANSocket socket(adapter, socket_config());
+
+    SECTION("Recorded timing") {
+        auto start = Clock::now();
+        emulator.replay(path);
+        for (std::size_t i = 0; i < RECORDS; ++i) {
+            struct can_frame frame;
+            REQUIRE(socket.receive(frame) == sizeof(frame));
+            REQUIRE(frame.can_id == 0x181);
+            REQUIRE(frame.data[0] == i);
+        }
+        REQUIRE(Clock::now() - start >= 40ms);
+        REQUIRE(emulator.replay_done());
+    }
+
+    SECTION("As fast as the link allows") {
+        auto start = Clock::now();
+        emulator.replay(path, 0.0);
+        for (std::size_t i = 0; i < RECORDS; ++i) {
+            struct can_frame frame;
+            REQUIRE(socket.receive(frame) == sizeof(frame));
+            REQUIRE(frame.data[0] == i);
+        }
+        REQUIRE(Clock::now() - start < 40ms);
+    }
+
+    SECTION("Bad arguments") {
+        REQUIRE_THROWS_AS(emulator.replay(path, -1.0), std::invalid_argument);
+        REQUIRE_THROWS_AS(emulator.replay("/tmp/does_not_exist.wscap"), std::runtime_error);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("AdapterEmulator - Fixed bus rate and autobaud", "[emulator][autobaud]") {
+    AdapterEmulatorConfig config;
+    config.bus_baud = CANBaud::BAUD_250K;
+    AdapterEmulator emulator(config);
+    emulator.start();
+    auto adapter = USBAdapter::create(emulator.get_slave_path(), SerialBaud::BAUD_2M);
+
+    // A node transmitting every 2 ms
+    std::atomic<bool> running{true};
+    std::thread node([&] {
+            for (std::uint8_t i = 0; running; ++i) {
+                emulator.inject(make_frame(0x701, i, 1));
+                std::this_thread::sleep_for(2ms);
+            }
+        });
+
+    AutobaudConfig autobaud;
+    autobaud.initial_window = 20ms;
+    autobaud.max_window = 80ms;
+    autobaud.settle = 0ms;
+    autobaud.frames_required = 3;
+    auto result = adapter->autobaud(autobaud);
+    running = false;
+    node.join();
+
+    REQUIRE(result.detected);
+    REQUIRE(result.baud_rate == CANBaud::BAUD_250K);
+    REQUIRE(emulator.get_state().can_baud == CANBaud::BAUD_250K);
+}
+
+TEST_CASE("AdapterEmulator - Link path", "[emulator]") {
+    AdapterEmulatorConfig config;
+    config.link_path = "/tmp/test_ttyWS0";
+    {
+        AdapterEmulator emulator(config);
+        REQUIRE(emulator.get_slave_path() == config.link_path);
+        REQUIRE(::access(config.link_path.c_str(), F_OK) == 0);
+    }
+    REQUIRE(::access(config.link_path.c_str(), F_OK) != 0);
+}
@@ -27,6 +27,7 @@ TEST_CASE("BridgeConfig::create_default - Default values", "[bridge][config]") {
     REQUIRE(config.filter_mask == 0);
     REQUIRE(config.usb_read_timeout_ms == 100);
     REQUIRE(config.socketcan_read_timeout_ms == 100);
+    REQUIRE(config.io_backend == IoBackend::POSIX);
 }
 
 TEST_CASE("BridgeConfig::validate - Empty interface throws", "[bridge][config][validation]") {
@@ -219,6 +220,35 @@ TEST_CASE("BridgeConfig::from_file - JSON case insensitive mode", "[bridge][conf
     std::remove(test_file.c_str());
 }
 
+TEST_CASE("BridgeConfig::from_file - JSON I/O backend", "[bridge][config][json]") {
+    const std::string test_file = "/tmp/test_bridge_io_backend.json";
+    {
+        std::ofstream out(test_file);
+        out << R"({
+  "bridge_config": {
+    "io_backend": "io_uring"
+  }
+})";
+        out.close();
+    }
+
+    auto config = BridgeConfig::from_file(test_file, true);
+    REQUIRE(config.io_backend == IoBackend::IO_URING);
+
+    {
+        std::ofstream out(test_file);
+        out << R"({
+  "bridge_config": {
+    "io_backend": "epoll"
+  }
+})";
+        out.close();
+    }
+    REQUIRE_THROWS_AS(BridgeConfig::from_file(test_file, true), std::invalid_argument);
+
+    std::remove(test_file.c_str());
+}
+
 TEST_CASE("BridgeConfig::load - JSON priority: env > file > defaults",
     "[bridge][config][json][load]") {
     const std::string test_file = "/tmp/test_bridge_priority.json";
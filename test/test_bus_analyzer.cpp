@@ -0,0 +1,236 @@
+/**
+ * @file test_bus_analyzer.cpp
+ * @brief Unit tests for the capture file reader and the bus analyzer
+ * @version 1.0
+ * @date 2025-11-24
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "../include/io/capture_file.hpp"
+#include "../include/io/capture_writer.hpp"
+#include "../include/pattern/bus_analyzer.hpp"
+
+using namespace waveshare;
+
+namespace {
+    constexpr std::uint64_t T0 = 1700000000000000ULL;
+    constexpr std::uint32_t HEARTBEAT_ID = 0x18FF0001 | CAN_EFF_FLAG;
+
+    CaptureRecord make_record(std::uint64_t timestamp_us, std::uint32_t can_id, std::uint8_t dlc) {
+        CaptureRecord record{};
+        record.timestamp_us = timestamp_us;
+        record.can_id = can_id;
+        record.dlc = dlc;
+        return record;
+    }
+
+    /**
+     * @brief 10 s of traffic
+     *
+     * - 0x181, 8 bytes every 1 ms; every 10th frame 50 us late; frames
+     *   5000-5002 missing
+     * - 0x18FF0001, 4 bytes every 100 ms; frame 50 followed by 3 extra
+     *   frames 1 ms apart
+     */
+    std::vector<CaptureRecord> make_traffic() {
+        std::vector<CaptureRecord> records;
+        for (std::uint64_t i = 0; i < 10000; ++i) {
+            if (i >= 5000 && i <= 5002) continue;
+            records.push_back(make_record(T0 + i * 1000 + (i % 10 == 5 ? 50 : 0), 0x181, 8));
+        }
+        for (std::uint64_t i = 0; i < 100; ++i) {
+            records.push_back(make_record(T0 + i * 100000 + 300, HEARTBEAT_ID, 4));
+            if (i == 50) {
+                for (std::uint64_t k = 1; k <= 3; ++k) {
+                    records.push_back(make_record(T0 + i * 100000 + 300 + k * 1000,
+                        HEARTBEAT_ID, 4));
+                }
+            }
+        }
+        std::stable_sort(records.begin(), records.end(),
+            [](const CaptureRecord& a, const CaptureRecord& b) {
+                return a.timestamp_us < b.timestamp_us;
+            });
+        return records;
+    }
+
+    std::string temp_path(const char* name) {
+        return std::string("/tmp/") + name + "_" + std::to_string(::getpid());
+    }
+}
+
+TEST_CASE("BusAnalyzer - Periodicity, missed cycles and bursts", "[analyzer]") {
+    auto records = make_traffic();
+    BusAnalyzerConfig config;
+    config.resolution = std::chrono::seconds(1);
+    config.threads = 1;
+    BusAnalysis analysis = BusAnalyzer(config).analyze(records.data(), records.size());
+
+    REQUIRE(analysis.frames == records.size());
+    REQUIRE(analysis.out_of_order == 0);
+    REQUIRE(analysis.ids.size() == 2);
+
+    SECTION("Cyclic ID with jitter and a gap") {
+        const IdStatistics& pdo = analysis.ids[0];
+        REQUIRE(pdo.can_id == 0x181);
+        REQUIRE(pdo.frames == 9997);
+        REQUIRE(pdo.period_us == 1000.0);
+        REQUIRE(pdo.missed_cycles == 3);
+        REQUIRE(pdo.bursts == 0);
+        REQUIRE(pdo.jitter_p50_us == 0.0);
+        REQUIRE(pdo.jitter_p95_us == 50.0);
+        REQUIRE(pdo.jitter_max_us == 50.0);
+        // 135 bit times per frame over ~10 s at 1 Mbit/s
+        REQUIRE(pdo.load_percent > 13.49);
+        REQUIRE(pdo.load_percent < 13.51);
+    }
+
+    SECTION("Burst on a slow ID") {
+        const IdStatistics& heartbeat = analysis.ids[1];
+        REQUIRE(heartbeat.can_id == HEARTBEAT_ID);
+        REQUIRE(heartbeat.frames == 103);
+        REQUIRE(heartbeat.period_us == 100000.0);
+        REQUIRE(heartbeat.bursts == 1);
+        REQUIRE(heartbeat.burst_frames == 3);
+        REQUIRE(heartbeat.max_burst == 4);
+        REQUIRE(heartbeat.missed_cycles == 0);
+        REQUIRE(heartbeat.jitter_max_us == 3000.0);     // 97 ms back to the schedule
+    }
+
+    SECTION("Load timeline") {
+        REQUIRE(analysis.timeline.size() == 10);
+        std::uint64_t frames = 0;
+        std::uint64_t bits = 0;
+        for (const auto& bin : analysis.timeline) {
+            frames += bin.frames;
+            bits += bin.bits;
+        }
+        REQUIRE(frames == records.size());
+        REQUIRE(bits == 9997ULL * can_frame_bits(8, false) + 103ULL * can_frame_bits(4, true));
+        REQUIRE(analysis.timeline[1].start_us == T0 + 1000000);
+
+        // Second 5 misses three 0x181 frames but holds the burst
+        REQUIRE(analysis.timeline[5].frames == 1000 - 3 + 10 + 3);
+        REQUIRE(analysis.peak_bin() != nullptr);
+        REQUIRE(analysis.peak_bin()->frames == 1010);
+        // (1000 × 135 + 10 × 120) bits in 1 s at 1 Mbit/s
+        REQUIRE(analysis.timeline[0].load_percent > 13.619);
+        REQUIRE(analysis.timeline[0].load_percent < 13.621);
+    }
+}
+
+TEST_CASE("BusAnalyzer - Parallel chunks match a single pass", "[analyzer][parallel]") {
+    auto records = make_traffic();
+    BusAnalyzerConfig config;
+    config.resolution = std::chrono::milliseconds(250);
+    config.threads = 1;
+    BusAnalysis serial = BusAnalyzer(config).analyze(records.data(), records.size());
+
+    for (std::size_t threads : {2, 3, 7}) {
+        config.threads = threads;
+        BusAnalysis parallel = BusAnalyzer(config).analyze(records.data(), records.size());
+        INFO("threads " << threads);
+        REQUIRE(parallel.frames == serial.frames);
+        REQUIRE(parallel.last_us == serial.last_us);
+        REQUIRE(parallel.ids.size() == serial.ids.size());
+        for (std::size_t i = 0; i < serial.ids.size(); ++i) {
+            const auto& a = serial.ids[i];
+            const auto& b = parallel.ids[i];
+            REQUIRE(a.can_id == b.can_id);
+            REQUIRE(a.frames == b.frames);
+            REQUIRE(a.period_us == b.period_us);
+            REQUIRE(a.missed_cycles == b.missed_cycles);
+            REQUIRE(a.bursts == b.bursts);
+            REQUIRE(a.jitter_p95_us == b.jitter_p95_us);
+            REQUIRE(a.jitter_max_us == b.jitter_max_us);
+        }
+        REQUIRE(parallel.timeline.size() == serial.timeline.size());
+        for (std::size_t i = 0; i < serial.timeline.size(); ++i) {
+            REQUIRE(parallel.timeline[i].bits == serial.timeline[i].bits);
+        }
+    }
+}
+
+TEST_CASE("BusAnalyzer - Edge cases", "[analyzer]") {
+    SECTION("Empty and tiny inputs") {
+        BusAnalyzer analyzer;
+        REQUIRE(analyzer.analyze(nullptr, 0).ids.empty());
+
+        std::vector<CaptureRecord> records = {make_record(T0, 0x100, 1),
+                                              make_record(T0 + 10, 0x100, 1)};
+        BusAnalysis analysis = analyzer.analyze(records.data(), records.size());
+        REQUIRE(analysis.ids.size() == 1);
+        REQUIRE(analysis.ids[0].period_us == 0.0);   // Below min_frames
+        REQUIRE(analysis.timeline.size() == 1);
+    }
+
+    SECTION("Out-of-order timestamps are counted, not fatal") {
+        std::vector<CaptureRecord> records = {make_record(T0 + 1000, 0x100, 1),
+                                              make_record(T0, 0x100, 1),
+                                              make_record(T0 + 2000, 0x100, 1)};
+        BusAnalysis analysis = BusAnalyzer().analyze(records.data(), records.size());
+        REQUIRE(analysis.out_of_order == 1);
+        REQUIRE(analysis.timeline.size() == 1);
+    }
+
+    SECTION("Invalid configuration") {
+        BusAnalyzerConfig config;
+        config.resolution = std::chrono::microseconds(0);
+        REQUIRE_THROWS_AS(BusAnalyzer(config), std::invalid_argument);
+        config.resolution = std::chrono::microseconds(1000);
+        config.burst_factor = 2.0;
+        REQUIRE_THROWS_AS(BusAnalyzer(config), std::invalid_argument);
+    }
+}
+
+TEST_CASE("CaptureFile - Memory-mapped reading", "[analyzer][file]") {
+    std::string path = temp_path("test_bus_analyzer.wscap");
+
+    SECTION("Records written by CaptureWriter") {
+        FILE* file = std::fopen(path.c_str(), "wb");
+        REQUIRE(file != nullptr);
+        {
+            CaptureWriter writer(::fileno(file), CaptureFormat::BINARY);
+            struct can_frame frame{};
+            frame.can_dlc = 2;
+            for (std::uint32_t i = 0; i < 1000; ++i) {
+                frame.can_id = i & CAN_SFF_MASK;
+                frame.data[0] = static_cast<std::uint8_t>(i);
+                writer.write(frame, T0 + i);
+            }
+        }
+        std::fputs("partial!", file);    // Interrupted mid-record
+        std::fclose(file);
+
+        CaptureFile capture(path);
+        REQUIRE(capture.size() == 1000);
+        REQUIRE(capture[999].timestamp_us == T0 + 999);
+        REQUIRE(capture[999].can_id == (999 & CAN_SFF_MASK));
+        REQUIRE(capture[999].data[0] == static_cast<std::uint8_t>(999));
+
+        BusAnalysis analysis = BusAnalyzer().analyze(capture);
+        REQUIRE(analysis.frames == 1000);
+    }
+
+    SECTION("Not a capture") {
+        {
+            std::ofstream file(path);
+            file << "(1700000000.000000) can0 123#00\n";
+        }
+        REQUIRE_THROWS_AS(CaptureFile(path), std::runtime_error);
+        {
+            std::ofstream file(path);
+            file << "short";
+        }
+        REQUIRE_THROWS_AS(CaptureFile(path), std::runtime_error);
+        REQUIRE_THROWS_AS(CaptureFile("/nonexistent/bus.wscap"), std::runtime_error);
+    }
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,282 @@
+/**
+ * @file test_capture.cpp
+ * @brief Unit tests for the stream decoder and the capture writer
+ * @version 1.0
+ * @date 2025-11-23
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+
+#include "../include/io/frame_stream_decoder.hpp"
+#include "../include/io/capture_writer.hpp"
+#include "../include/frame/fixed_frame.hpp"
+#include "../include/interface/socketcan_helpers.hpp"
+
+using namespace waveshare;
+
+namespace {
+    struct can_frame make_frame(canid_t id, std::vector<std::uint8_t> data) {
+        struct can_frame frame;
+        std::memset(&frame, 0, sizeof(frame));
+        frame.can_id = id;
+        frame.can_dlc = static_cast<std::uint8_t>(data.size());
+        std::memcpy(frame.data, data.data(), data.size());
+        return frame;
+    }
+
+    bool same_frame(const struct can_frame& a, const struct can_frame& b) {
+        return a.can_id == b.can_id && a.can_dlc == b.can_dlc &&
+               std::memcmp(a.data, b.data, a.can_dlc) == 0;
+    }
+
+    void append(std::vector<std::uint8_t>& stream, const std::vector<std::uint8_t>& bytes) {
+        stream.insert(stream.end(), bytes.begin(), bytes.end());
+    }
+
+    std::vector<std::uint8_t> variable_bytes(const struct can_frame& frame) {
+        return SocketCANHelper::from_socketcan(frame).serialize();
+    }
+
+    std::vector<std::uint8_t> fixed_bytes(const struct can_frame& frame) {
+        bool extended = (frame.can_id & CAN_EFF_FLAG) != 0;
+        return FixedFrame((frame.can_id & CAN_RTR_FLAG) ? Format::REMOTE_FIXED : Format::DATA_FIXED,
+            extended ? CANVersion::EXT_FIXED : CANVersion::STD_FIXED,
+            frame.can_id & (extended ? CAN_EFF_MASK : CAN_SFF_MASK),
+            span<const std::uint8_t>(frame.data, frame.can_dlc)).serialize();
+    }
+
+    std::string temp_path(const char* name) {
+        return std::string("/tmp/") + name + "_" + std::to_string(::getpid());
+    }
+
+    std::string read_file(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+}
+
+TEST_CASE("FrameStreamDecoder - Variable frames", "[capture][decoder]") {
+    // END and START values inside the payload must not split the frame
+    std::vector<struct can_frame> sent = {
+        make_frame(0x123, {0x55, 0xAA, 0x55}),
+        make_frame(0x18FF0001 | CAN_EFF_FLAG, {1, 2, 3, 4, 5, 6, 7, 8}),
+        make_frame(0x7FF | CAN_RTR_FLAG, {}),
+        make_frame(0x000, {0x55}),
+    };
+    std::vector<std::uint8_t> stream;
+    for (const auto& frame : sent) append(stream, variable_bytes(frame));
+
+    SECTION("Whole stream in one chunk") {
+        FrameStreamDecoder decoder;
+        std::vector<struct can_frame> frames;
+        REQUIRE(decoder.decode(stream.data(), stream.size(), frames) == sent.size());
+        for (std::size_t i = 0; i < sent.size(); ++i) {
+            REQUIRE(same_frame(frames[i], sent[i]));
+        }
+        REQUIRE(decoder.pending() == 0);
+        REQUIRE(decoder.get_statistics().decode_errors == 0);
+    }
+
+    SECTION("Frames split at every chunk size") {
+        for (std::size_t chunk = 1; chunk <= stream.size(); ++chunk) {
+            FrameStreamDecoder decoder;
+            std::vector<struct can_frame> frames;
+            for (std::size_t pos = 0; pos < stream.size(); pos += chunk) {
+                decoder.decode(stream.data() + pos, std::min(chunk, stream.size() - pos), frames);
+            }
+            INFO("chunk size " << chunk);
+            REQUIRE(frames.size() == sent.size());
+            for (std::size_t i = 0; i < sent.size(); ++i) {
+                REQUIRE(same_frame(frames[i], sent[i]));
+            }
+            REQUIRE(decoder.get_statistics().decode_errors == 0);
+        }
+    }
+
+    SECTION("Garbage is skipped and counted once per run") {
+        std::vector<std::uint8_t> noisy = {0x00, 0x13, 0xAA, 0x00};
+        append(noisy, variable_bytes(sent[0]));
+        append(noisy, {0xAA, 0xC9, 0x01});             // DLC 9
+        append(noisy, variable_bytes(sent[1]));
+        append(noisy, {0xAA, 0xC1, 0x10, 0x00, 0x42, 0x00});   // Wrong END byte
+        append(noisy, variable_bytes(sent[2]));
+
+        FrameStreamDecoder decoder;
+        std::vector<struct can_frame> frames;
+        decoder.decode(noisy.data(), noisy.size(), frames);
+        REQUIRE(frames.size() == 3);
+        REQUIRE(same_frame(frames[2], sent[2]));
+        REQUIRE(decoder.get_statistics().frames == 3);
+        REQUIRE(decoder.get_statistics().decode_errors == 3);
+        REQUIRE(decoder.get_statistics().skipped_bytes == 4 + 3 + 6);
+    }
+
+    SECTION("Partial frame is held until reset") {
+        FrameStreamDecoder decoder;
+        std::vector<struct can_frame> frames;
+        decoder.decode(stream.data(), 4, frames);
+        REQUIRE(frames.empty());
+        REQUIRE(decoder.pending() == 4);
+        decoder.reset();
+        REQUIRE(decoder.pending() == 0);
+    }
+}
+
+TEST_CASE("FrameStreamDecoder - Fixed frames", "[capture][decoder]") {
+    std::vector<struct can_frame> sent = {
+        make_frame(0x181, {0xAA, 0x55, 0x00, 0x55}),
+        make_frame(0x1ABCDEF0 | CAN_EFF_FLAG | CAN_RTR_FLAG, {}),
+        make_frame(0x701, {0x05}),
+    };
+    std::vector<std::uint8_t> stream;
+    for (const auto& frame : sent) append(stream, fixed_bytes(frame));
+
+    SECTION("Frames split at every chunk size") {
+        for (std::size_t chunk : {1, 3, 7, 19, 20, 21, 41, 60}) {
+            FrameStreamDecoder decoder(FrameStreamDecoder::Mode::FIXED);
+            std::vector<struct can_frame> frames;
+            for (std::size_t pos = 0; pos < stream.size(); pos += chunk) {
+                decoder.decode(stream.data() + pos, std::min(chunk, stream.size() - pos), frames);
+            }
+            INFO("chunk size " << chunk);
+            REQUIRE(frames.size() == sent.size());
+            for (std::size_t i = 0; i < sent.size(); ++i) {
+                REQUIRE(same_frame(frames[i], sent[i]));
+            }
+        }
+    }
+
+    SECTION("Bad checksum is rejected") {
+        stream[19] ^= 0xFF;
+        FrameStreamDecoder decoder(FrameStreamDecoder::Mode::FIXED);
+        std::vector<struct can_frame> frames;
+        decoder.decode(stream.data(), stream.size(), frames);
+        REQUIRE(frames.size() == 2);
+        REQUIRE(same_frame(frames[0], sent[1]));
+        REQUIRE(decoder.get_statistics().decode_errors == 1);
+    }
+}
+
+TEST_CASE("CaptureWriter - Output formats", "[capture][writer]") {
+    std::vector<struct can_frame> frames = {
+        make_frame(0x123, {0xDE, 0xAD, 0xBE, 0xEF}),
+        make_frame(0x18FF0001 | CAN_EFF_FLAG, {1, 2, 3, 4, 5, 6, 7, 8}),
+        make_frame(0x7FF | CAN_RTR_FLAG, {}),
+        make_frame(0x00A, {}),
+    };
+    frames[2].can_dlc = 2;
+
+    SECTION("Binary records") {
+        std::string path = temp_path("test_capture.wscap");
+        FILE* file = std::fopen(path.c_str(), "wb");
+        REQUIRE(file != nullptr);
+        {
+            CaptureWriter writer(::fileno(file), CaptureFormat::BINARY, "can0", 64, 2);
+            for (std::size_t i = 0; i < frames.size(); ++i) {
+                REQUIRE(writer.write(frames[i], 1700000000000000ULL + i));
+            }
+            writer.stop();
+            auto stats = writer.get_statistics();
+            REQUIRE(stats.records == frames.size());
+            REQUIRE(stats.dropped == 0);
+            REQUIRE(stats.bytes_written == 16 + 24 * frames.size());
+        }
+        std::fclose(file);
+
+        std::string content = read_file(path);
+        std::remove(path.c_str());
+        REQUIRE(content.size() == sizeof(CaptureFileHeader) + frames.size() * sizeof(CaptureRecord));
+
+        CaptureFileHeader header;
+        std::memcpy(&header, content.data(), sizeof(header));
+        REQUIRE(std::memcmp(header.magic, CAPTURE_MAGIC, sizeof(header.magic)) == 0);
+        REQUIRE(header.record_size == 24);
+
+        for (std::size_t i = 0; i < frames.size(); ++i) {
+            CaptureRecord record;
+            std::memcpy(&record, content.data() + sizeof(header) + i * sizeof(record),
+                sizeof(record));
+            REQUIRE(record.timestamp_us == 1700000000000000ULL + i);
+            REQUIRE(record.can_id == frames[i].can_id);
+            REQUIRE(record.dlc == frames[i].can_dlc);
+        }
+        CaptureRecord record;
+        std::memcpy(&record, content.data() + sizeof(header) + sizeof(record), sizeof(record));
+        REQUIRE(record.data[7] == 8);
+    }
+
+    SECTION("candump -L lines") {
+        std::string path = temp_path("test_capture.log");
+        FILE* file = std::fopen(path.c_str(), "wb");
+        REQUIRE(file != nullptr);
+        {
+            CaptureWriter writer(::fileno(file), CaptureFormat::CANDUMP, "vcan1");
+            writer.write(frames[0], 1700000000000042ULL);
+            writer.write(frames[1], 1700000001500000ULL);
+            writer.write(frames[2], 5ULL);
+            writer.write(frames[3], 1700000002000000ULL);
+        }
+        std::fclose(file);
+
+        std::string content = read_file(path);
+        std::remove(path.c_str());
+        REQUIRE(content ==
+            "(1700000000.000042) vcan1 123#DEADBEEF\n"
+            "(1700000001.500000) vcan1 18FF0001#0102030405060708\n"
+            "(0.000005) vcan1 7FF#R2\n"
+            "(1700000002.000000) vcan1 00A#\n");
+    }
+
+    SECTION("Invalid setup is rejected") {
+        REQUIRE_THROWS_AS(CaptureWriter(-1, CaptureFormat::BINARY), std::invalid_argument);
+        REQUIRE_THROWS_AS(CaptureWriter(STDOUT_FILENO, CaptureFormat::BINARY, "can0", 1 << 16, 1),
+            std::invalid_argument);
+        REQUIRE_THROWS_AS(CaptureWriter(STDOUT_FILENO, CaptureFormat::BINARY, "can0", 16, 4),
+            std::invalid_argument);
+    }
+}
+
+TEST_CASE("CaptureWriter - Slow output drops instead of blocking", "[capture][writer]") {
+    int pipe_fds[2];
+    REQUIRE(::pipe(pipe_fds) == 0);
+
+    constexpr std::size_t COUNT = 20000;       // 480 kB, far more than a pipe holds
+    auto frame = make_frame(0x181, {1, 2, 3, 4, 5, 6, 7, 8});
+    CaptureWriter writer(pipe_fds[1], CaptureFormat::BINARY, "can0", 4096, 2);
+
+    // Nobody reads the pipe yet: the writer thread blocks, the buffers fill up
+    auto start = std::chrono::steady_clock::now();
+    std::size_t accepted = 0;
+    for (std::size_t i = 0; i < COUNT; ++i) {
+        if (writer.write(frame, i)) ++accepted;
+    }
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+
+    auto stats = writer.get_statistics();
+    REQUIRE(stats.dropped > 0);
+    REQUIRE(stats.records == accepted);
+    REQUIRE(stats.records + stats.dropped == COUNT);
+
+    std::size_t received = 0;
+    std::thread drain([&] {
+            char buffer[8192];
+            ssize_t n;
+            while ((n = ::read(pipe_fds[0], buffer, sizeof(buffer))) > 0) {
+                received += static_cast<std::size_t>(n);
+            }
+        });
+    writer.stop();
+    ::close(pipe_fds[1]);
+    drain.join();
+    ::close(pipe_fds[0]);
+
+    REQUIRE(received == sizeof(CaptureFileHeader) + accepted * sizeof(CaptureRecord));
+    REQUIRE(writer.get_statistics().bytes_written == received);
+}
@@ -0,0 +1,240 @@
+/**
+ * @file test_gateway_rules.cpp
+ * @brief Unit tests for the bridge gateway rules
+ * @version 1.0
+ * @date 2025-11-26
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "../include/pattern/gateway_rules.hpp"
+#include "../include/pattern/socketcan_bridge.hpp"
+#include "test_utils.hpp"
+
+using namespace waveshare;
+using json = nlohmann::json;
+using Verdict = GatewayRuleEngine::Verdict;
+
+namespace {
+    struct can_frame make_frame(canid_t id, std::vector<std::uint8_t> data) {
+        struct can_frame frame;
+        std::memset(&frame, 0, sizeof(frame));
+        frame.can_id = id;
+        frame.can_dlc = static_cast<std::uint8_t>(data.size());
+        std::memcpy(frame.data, data.data(), data.size());
+        return frame;
+    }
+
+    GatewayRuleEngine compile(const char* text) {
+        std::vector<GatewayRule> rules;
+        for (const auto& rule : json::parse(text)) {
+            rules.push_back(GatewayRule::from_json(rule));
+        }
+        return GatewayRuleEngine(rules);
+    }
+}
+
+TEST_CASE("GatewayRuleEngine - ID remapping and matching", "[gateway]") {
+    auto rules = compile(R"([
+        {"name": "node 1 to 3", "direction": "usb_to_can", "id": "0x181",
+         "actions": [{"op": "set_id", "id": "0x183"}]},
+        {"name": "all TPDO1", "direction": "usb_to_can", "id": "0x180", "mask": "0x780",
+         "actions": [{"op": "set_id", "id": "0x18FF0000"}]},
+        {"direction": "can_to_usb", "id": "0x18DA0000", "mask": "0x1FFF0000",
+         "actions": [{"op": "drop"}]}
+    ])");
+    REQUIRE(rules.size() == 3);
+
+    SECTION("First matching rule wins") {
+        auto frame = make_frame(0x181, {1, 2});
+        REQUIRE(rules.apply(RuleDirection::USB_TO_CAN, frame) == Verdict::REWRITTEN);
+        REQUIRE(frame.can_id == 0x183);
+        REQUIRE(frame.data[1] == 2);
+
+        frame = make_frame(0x1A5, {});
+        REQUIRE(rules.apply(RuleDirection::USB_TO_CAN, frame) == Verdict::REWRITTEN);
+        REQUIRE(frame.can_id == (0x18FF0000 | CAN_EFF_FLAG));
+    }
+
+    SECTION("Unmatched IDs and other directions pass unchanged") {
+        auto frame = make_frame(0x201, {1});
+        REQUIRE(rules.apply(RuleDirection::USB_TO_CAN, frame) == Verdict::PASS);
+        frame = make_frame(0x181, {1});
+        REQUIRE(rules.apply(RuleDirection::CAN_TO_USB, frame) == Verdict::PASS);
+        REQUIRE(frame.can_id == 0x181);
+
+        // An 11-bit rule never matches a 29-bit frame with the same low bits
+        frame = make_frame(0x181 | CAN_EFF_FLAG, {1});
+        REQUIRE(rules.apply(RuleDirection::USB_TO_CAN, frame) == Verdict::PASS);
+    }
+
+    SECTION("Extended mask match and drop") {
+        auto frame = make_frame(0x18DAF110 | CAN_EFF_FLAG, {0x02, 0x10, 0x01});
+        REQUIRE(rules.apply(RuleDirection::CAN_TO_USB, frame) == Verdict::DROP);
+        frame = make_frame(0x18DBF110 | CAN_EFF_FLAG, {0x02});
+        REQUIRE(rules.apply(RuleDirection::CAN_TO_USB, frame) == Verdict::PASS);
+    }
+
+    SECTION("RTR is preserved, error frames are never touched") {
+        auto frame = make_frame(0x181 | CAN_RTR_FLAG, {});
+        rules.apply(RuleDirection::USB_TO_CAN, frame);
+        REQUIRE(frame.can_id == (0x183 | CAN_RTR_FLAG));
+
+        frame = make_frame(0x181 | CAN_ERR_FLAG, {});
+        REQUIRE(rules.apply(RuleDirection::USB_TO_CAN, frame) == Verdict::PASS);
+    }
+}
+
+TEST_CASE("GatewayRuleEngine - Payload transforms", "[gateway][payload]") {
+    SECTION("Bit masks") {
+        auto rules = compile(R"([{"id": "0x100", "actions": [
+            {"op": "and", "byte": 0, "value": "0x0F"},
+            {"op": "or", "byte": 1, "value": "0x80"},
+            {"op": "or", "byte": 7, "value": "0x01"}]}])");
+        auto frame = make_frame(0x100, {0xAB, 0x01, 0x00});
+        REQUIRE(rules.apply(RuleDirection::CAN_TO_USB, frame) == Verdict::REWRITTEN);
+        REQUIRE(frame.data[0] == 0x0B);
+        REQUIRE(frame.data[1] == 0x81);
+        REQUIRE(frame.data[7] == 0x00);     // Beyond the DLC: left alone
+        REQUIRE(frame.can_dlc == 3);
+    }
+
+    SECTION("Scaling little- and big-endian fields") {
+        auto rules = compile(R"([{"id": "0x100", "actions": [
+            {"op": "scale", "byte": 0, "length": 2, "mul": 1, "div": 10},
+            {"op": "scale", "byte": 2, "length": 2, "endian": "big", "signed": true,
+             "mul": 2, "offset": -5},
+            {"op": "scale", "byte": 4, "length": 4, "mul": 3, "div": 2}]}])");
+        // 1000 LE, -100 BE, 0x01000000 LE
+        auto frame = make_frame(0x100, {0xE8, 0x03, 0xFF, 0x9C, 0x00, 0x00, 0x00, 0x01});
+        rules.apply(RuleDirection::USB_TO_CAN, frame);
+        REQUIRE(frame.data[0] == 100);
+        REQUIRE(frame.data[1] == 0);
+        // -100 × 2 - 5 = -205 = 0xFF33
+        REQUIRE(frame.data[2] == 0xFF);
+        REQUIRE(frame.data[3] == 0x33);
+        // 16777216 × 3 / 2 = 25165824 = 0x01800000
+        REQUIRE(frame.data[7] == 0x01);
+        REQUIRE(frame.data[6] == 0x80);
+    }
+
+    SECTION("Scaling saturates to the field range") {
+        auto rules = compile(R"([{"id": "0x100", "actions": [
+            {"op": "scale", "byte": 0, "mul": 10},
+            {"op": "scale", "byte": 1, "signed": true, "offset": -200}]}])");
+        auto frame = make_frame(0x100, {200, 10});
+        rules.apply(RuleDirection::USB_TO_CAN, frame);
+        REQUIRE(frame.data[0] == 0xFF);
+        REQUIRE(frame.data[1] == 0x80);     // -128
+    }
+
+    SECTION("Fields beyond the DLC are skipped") {
+        auto rules = compile(R"([{"id": "0x100", "actions": [
+            {"op": "scale", "byte": 2, "length": 2, "mul": 2}]}])");
+        auto frame = make_frame(0x100, {1, 2, 3});
+        REQUIRE(rules.apply(RuleDirection::USB_TO_CAN, frame) == Verdict::REWRITTEN);
+        REQUIRE(frame.data[2] == 3);
+    }
+}
+
+TEST_CASE("GatewayRuleEngine - Invalid rules", "[gateway][validation]") {
+    REQUIRE_THROWS_AS(compile(R"([{"id": "0x800", "extended": false,
+        "actions": [{"op": "drop"}]}])"), std::invalid_argument);
+    REQUIRE_THROWS_AS(compile(R"([{"id": "0x100", "actions": []}])"), std::invalid_argument);
+    REQUIRE_THROWS_AS(compile(R"([{"id": "0x100", "actions": [{"op": "rotate"}]}])"),
+        std::invalid_argument);
+    REQUIRE_THROWS_AS(compile(R"([{"id": "0x100", "actions":
+        [{"op": "scale", "byte": 6, "length": 4}]}])"), std::invalid_argument);
+    REQUIRE_THROWS_AS(compile(R"([{"id": "0x100", "actions":
+        [{"op": "scale", "byte": 0, "length": 3}]}])"), std::invalid_argument);
+    REQUIRE_THROWS_AS(compile(R"([{"id": "0x100", "actions":
+        [{"op": "scale", "byte": 0, "div": 0}]}])"), std::invalid_argument);
+    REQUIRE_THROWS_AS(compile(R"([{"id": "0x100", "actions":
+        [{"op": "or", "byte": 8, "value": 1}]}])"), std::invalid_argument);
+    REQUIRE_THROWS_AS(compile(R"([{"id": "0x100", "direction": "sideways",
+        "actions": [{"op": "drop"}]}])"), std::invalid_argument);
+}
+
+TEST_CASE("GatewayRuleEngine - Bridge configuration", "[gateway][bridge]") {
+    const std::string test_file = "/tmp/test_gateway_rules.json";
+    {
+        std::ofstream out(test_file);
+        out << R"({
+  "bridge_config": {
+    "socketcan_interface": "vcan0",
+    "rules": [
+      {"direction": "both", "id": "0x181", "actions": [{"op": "set_id", "id": "0x281"}]},
+      {"direction": "usb_to_can", "id": "0x18FF0000", "mask": "0x1FFF0000",
+       "actions": [{"op": "drop"}]}
+    ]
+  }
+})";
+    }
+
+    auto config = BridgeConfig::from_file(test_file);
+    REQUIRE(config.rules.size() == 2);
+    REQUIRE(config.rules[1].extended);
+    REQUIRE(config.rules[1].direction == RuleDirection::USB_TO_CAN);
+    REQUIRE_NOTHROW(config.validate());
+
+    config.usb_device_path = "/dev/ttyUSB0";
+    auto bridge = waveshare::test::create_bridge_with_mocks(config);
+    REQUIRE(bridge->get_rules().size() == 2);
+    REQUIRE(bridge->get_statistics().rule_drops == 0);
+
+    config.rules[0].actions[0].id = 0x800;  // 11-bit set_id out of range
+    REQUIRE_THROWS_AS(config.validate(), std::invalid_argument);
+    REQUIRE_THROWS_AS(waveshare::test::create_bridge_with_mocks(config), std::invalid_argument);
+
+    std::remove(test_file.c_str());
+}
+
+TEST_CASE("GatewayRuleEngine - Per-frame cost", "[gateway][performance]") {
+    // 64 remapped standard IDs, a transform and an extended drop rule
+    std::vector<GatewayRule> rules;
+    for (std::uint32_t i = 0; i < 64; ++i) {
+        GatewayRule rule;
+        rule.direction = RuleDirection::USB_TO_CAN;
+        rule.id = 0x100 + i;
+        RuleAction remap;
+        remap.type = RuleAction::Type::SET_ID;
+        remap.id = 0x500 + i;
+        RuleAction scale;
+        scale.type = RuleAction::Type::SCALE;
+        scale.length = 2;
+        scale.mul = 3;
+        scale.div = 2;
+        rule.actions = {remap, scale};
+        rules.push_back(rule);
+    }
+    GatewayRule extended;
+    extended.extended = true;
+    extended.id = 0x18FF0000;
+    extended.mask = 0x1FFF0000;
+    extended.actions.resize(1);
+    rules.push_back(extended);
+    GatewayRuleEngine engine(rules);
+
+    constexpr std::size_t FRAMES = 1000000;
+    std::uint64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < FRAMES; ++i) {
+        auto frame = make_frame(i % 2 ? 0x100 + (i % 64) : 0x18FE0000 | CAN_EFF_FLAG,
+            {static_cast<std::uint8_t>(i), 1, 2, 3, 4, 5, 6, 7});
+        engine.apply(RuleDirection::USB_TO_CAN, frame);
+        checksum += frame.can_id + frame.data[0];
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count();
+    REQUIRE(checksum != 0);
+
+    // The target is < 100 ns in a release build; this only catches regressions
+    // by an order of magnitude, unoptimized or on a loaded machine
+    double per_frame = elapsed / FRAMES;
+    INFO("ns per frame: " << per_frame);
+    REQUIRE(per_frame < 1000.0);
+}
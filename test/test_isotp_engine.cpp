@@ -0,0 +1,356 @@
+/**
+ * @file test_isotp_engine.cpp
+ * @brief Unit tests for the ISO-TP engine
+ * @version 1.0
+ * @date 2025-11-25
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <numeric>
+#include <thread>
+
+#include "../include/pattern/isotp_engine.hpp"
+
+using namespace waveshare;
+using namespace std::chrono_literals;
+
+namespace {
+    using Clock = IsoTpEngine::Clock;
+
+    constexpr uint32_t TESTER_ID = 0x7E0;
+    constexpr uint32_t ECU_ID = 0x7E8;
+
+    /**
+     * @brief Two engines whose frames are queued until pump() delivers them
+     */
+    struct Link {
+        std::deque<struct can_frame> to_ecu;
+        std::deque<struct can_frame> to_tester;
+        std::vector<struct can_frame> trace;    ///< Every frame, in send order
+        bool drop_to_tester = false;
+
+        IsoTpEngine tester;
+        IsoTpEngine ecu;
+        std::vector<std::vector<uint8_t>> tester_rx;
+        std::vector<std::vector<uint8_t>> ecu_rx;
+        std::vector<IsoTpResult> tester_done;
+
+        explicit Link(const IsoTpEngineConfig& config = {})
+            : tester([this](const struct can_frame& f) {
+                    trace.push_back(f);
+                    to_ecu.push_back(f);
+                    return true;
+                }, config),
+            ecu([this](const struct can_frame& f) {
+                    trace.push_back(f);
+                    if (!drop_to_tester) to_tester.push_back(f);
+                    return true;
+                }, config) {
+            tester.on_receive([this](std::size_t, const uint8_t* data, std::size_t size) {
+                    tester_rx.emplace_back(data, data + size);
+                });
+            ecu.on_receive([this](std::size_t, const uint8_t* data, std::size_t size) {
+                    ecu_rx.emplace_back(data, data + size);
+                });
+            tester.on_send_complete([this](std::size_t, IsoTpResult result) {
+                    tester_done.push_back(result);
+                });
+        }
+
+        /**
+         * @brief Deliver queued frames until both queues are empty
+         */
+        void pump(Clock::time_point now) {
+            while (!to_ecu.empty() || !to_tester.empty()) {
+                while (!to_ecu.empty()) {
+                    auto frame = to_ecu.front();
+                    to_ecu.pop_front();
+                    ecu.process(frame, now);
+                }
+                while (!to_tester.empty()) {
+                    auto frame = to_tester.front();
+                    to_tester.pop_front();
+                    tester.process(frame, now);
+                }
+            }
+        }
+    };
+
+    std::vector<uint8_t> make_message(std::size_t size) {
+        std::vector<uint8_t> message(size);
+        std::iota(message.begin(), message.end(), static_cast<uint8_t>(1));
+        return message;
+    }
+
+    std::size_t count_type(const std::vector<struct can_frame>& frames, uint8_t pci) {
+        std::size_t count = 0;
+        for (const auto& frame : frames) {
+            if ((frame.data[0] & isotp::PCI_TYPE_MASK) == pci) ++count;
+        }
+        return count;
+    }
+}
+
+TEST_CASE("IsoTpEngine - Single and multi-frame transfers", "[isotp]") {
+    Link link;
+    IsoTpChannelConfig tester_channel{TESTER_ID, ECU_ID};
+    IsoTpChannelConfig ecu_channel{ECU_ID, TESTER_ID};
+    ecu_channel.block_size = 4;
+    std::size_t tester = link.tester.add_channel(tester_channel);
+    std::size_t ecu = link.ecu.add_channel(ecu_channel);
+    Clock::time_point t0 = Clock::now();
+
+    SECTION("Single frame, padded") {
+        const uint8_t request[] = {0x22, 0xF1, 0x90};
+        REQUIRE(link.tester.send(tester, request, sizeof(request), t0) == IsoTpResult::OK);
+        link.pump(t0);
+
+        REQUIRE(link.trace.size() == 1);
+        REQUIRE(link.trace[0].can_id == TESTER_ID);
+        REQUIRE(link.trace[0].can_dlc == 8);
+        REQUIRE(link.trace[0].data[0] == 0x03);
+        REQUIRE(link.trace[0].data[7] == 0xCC);
+        REQUIRE(link.ecu_rx.size() == 1);
+        REQUIRE(link.ecu_rx[0] == std::vector<uint8_t>(request, request + 3));
+        REQUIRE(link.tester_done == std::vector<IsoTpResult>{IsoTpResult::OK});
+    }
+
+    SECTION("Multi-frame with block size 4 and STmin 0") {
+        auto message = make_message(100);
+        REQUIRE(link.tester.send(tester, message.data(), message.size(), t0) == IsoTpResult::OK);
+        REQUIRE(link.tester.send(tester, message.data(), 3, t0) == IsoTpResult::BUSY);
+        link.pump(t0);
+
+        // FF carries 6 bytes, then 14 CFs of up to 7; an FC every 4 CFs
+        REQUIRE(count_type(link.trace, isotp::PCI_FIRST_FRAME) == 1);
+        REQUIRE(count_type(link.trace, isotp::PCI_CONSECUTIVE_FRAME) == 14);
+        REQUIRE(count_type(link.trace, isotp::PCI_FLOW_CONTROL) == 4);
+        REQUIRE(link.trace[0].data[0] == 0x10);
+        REQUIRE(link.trace[0].data[1] == 100);
+        REQUIRE(link.trace[1].can_id == ECU_ID);
+        REQUIRE(link.trace[1].data[0] == 0x30);
+        REQUIRE(link.trace[1].data[1] == 4);
+        REQUIRE(link.trace[2].data[0] == 0x21);
+
+        REQUIRE(link.ecu_rx.size() == 1);
+        REQUIRE(link.ecu_rx[0] == message);
+        REQUIRE(link.tester_done == std::vector<IsoTpResult>{IsoTpResult::OK});
+        REQUIRE(link.ecu.available_buffers() == IsoTpEngineConfig{}.pool_buffers);
+        REQUIRE(link.tester.available_buffers() == IsoTpEngineConfig{}.pool_buffers);
+    }
+
+    SECTION("Maximum size both ways, sequence number wraps") {
+        auto request = make_message(isotp::MAX_MESSAGE_SIZE);
+        auto response = make_message(2000);
+        REQUIRE(link.tester.send(tester, request.data(), request.size(), t0) == IsoTpResult::OK);
+        REQUIRE(link.ecu.send(ecu, response.data(), response.size(), t0) == IsoTpResult::OK);
+        link.pump(t0);
+
+        REQUIRE(link.ecu_rx.size() == 1);
+        REQUIRE(link.ecu_rx[0] == request);
+        REQUIRE(link.tester_rx.size() == 1);
+        REQUIRE(link.tester_rx[0] == response);
+
+        auto stats = link.ecu.get_statistics();
+        REQUIRE(stats.messages_received == 1);
+        REQUIRE(stats.messages_sent == 1);
+        REQUIRE(stats.sequence_errors == 0);
+    }
+}
+
+TEST_CASE("IsoTpEngine - STmin paces consecutive frames", "[isotp][timing]") {
+    Link link;
+    IsoTpChannelConfig ecu_channel{ECU_ID, TESTER_ID};
+    ecu_channel.st_min = 5;     // 5 ms
+    std::size_t tester = link.tester.add_channel({TESTER_ID, ECU_ID});
+    link.ecu.add_channel(ecu_channel);
+    Clock::time_point t0 = Clock::now();
+
+    auto message = make_message(20);    // FF + 2 CFs
+    link.tester.send(tester, message.data(), message.size(), t0);
+    link.pump(t0);
+
+    // The first CF follows the FC at once, the second waits for STmin
+    REQUIRE(count_type(link.trace, isotp::PCI_CONSECUTIVE_FRAME) == 1);
+    REQUIRE(link.tester.poll(t0 + 4ms) == t0 + 5ms);
+    REQUIRE(count_type(link.trace, isotp::PCI_CONSECUTIVE_FRAME) == 1);
+
+    REQUIRE(link.tester.poll(t0 + 5ms) == Clock::time_point::max());
+    link.pump(t0 + 5ms);
+    REQUIRE(count_type(link.trace, isotp::PCI_CONSECUTIVE_FRAME) == 2);
+    REQUIRE(link.ecu_rx.size() == 1);
+    REQUIRE(link.ecu_rx[0] == message);
+
+    REQUIRE(isotp::stmin_to_duration(0xF3) == 300us);
+    REQUIRE(isotp::stmin_to_duration(0x80) == 127ms);
+}
+
+TEST_CASE("IsoTpEngine - Errors and timeouts", "[isotp][errors]") {
+    IsoTpEngineConfig config;
+    config.pool_buffers = 1;
+    Link link(config);
+    IsoTpChannelConfig tester_channel{TESTER_ID, ECU_ID};
+    tester_channel.timeout = 50ms;
+    IsoTpChannelConfig ecu_channel{ECU_ID, TESTER_ID};
+    ecu_channel.timeout = 50ms;
+    std::size_t tester = link.tester.add_channel(tester_channel);
+    link.ecu.add_channel(ecu_channel);
+    Clock::time_point t0 = Clock::now();
+    auto message = make_message(30);
+
+    SECTION("No flow control: N_Bs timeout") {
+        link.drop_to_tester = true;
+        link.tester.send(tester, message.data(), message.size(), t0);
+        link.pump(t0);
+        REQUIRE(link.tester.poll(t0 + 10ms) == t0 + 50ms);
+        REQUIRE(link.tester_done.empty());
+        link.tester.poll(t0 + 50ms);
+        REQUIRE(link.tester_done == std::vector<IsoTpResult>{IsoTpResult::TIMEOUT_BS});
+        REQUIRE(link.tester.available_buffers() == 1);
+
+        // The ECU still waits for CFs until N_Cr
+        REQUIRE(link.ecu.available_buffers() == 0);
+        link.ecu.poll(t0 + 50ms);
+        REQUIRE(link.ecu.available_buffers() == 1);
+        REQUIRE(link.ecu.get_statistics().timeouts == 1);
+    }
+
+    SECTION("Out-of-sequence CF aborts the reception") {
+        struct can_frame ff{};
+        ff.can_id = TESTER_ID;
+        ff.can_dlc = 8;
+        ff.data[0] = 0x10;
+        ff.data[1] = 30;
+        link.ecu.process(ff, t0);
+        struct can_frame cf = ff;
+        cf.data[0] = 0x22;
+        link.ecu.process(cf, t0);
+        REQUIRE(link.ecu.get_statistics().sequence_errors == 1);
+        REQUIRE(link.ecu.available_buffers() == 1);
+        REQUIRE(link.ecu_rx.empty());
+    }
+
+    SECTION("Empty pool: FC overflow") {
+        link.ecu.add_channel({0x7E9, 0x7E1});
+        IsoTpEngine other([&](const struct can_frame& f) {
+                link.to_ecu.push_back(f);
+                return true;
+            });
+        std::size_t second = other.add_channel({0x7E1, 0x7E9});
+        std::vector<IsoTpResult> other_done;
+        other.on_send_complete([&](std::size_t, IsoTpResult r) { other_done.push_back(r); });
+
+        link.drop_to_tester = true;     // The ECU's single buffer stays busy
+        link.tester.send(tester, message.data(), message.size(), t0);
+        link.pump(t0);
+        REQUIRE(link.ecu.available_buffers() == 0);
+
+        link.drop_to_tester = false;
+        other.send(second, message.data(), message.size(), t0);
+        link.pump(t0);
+        REQUIRE(link.ecu.get_statistics().overflows == 1);
+
+        struct can_frame fc = link.trace.back();
+        REQUIRE(fc.can_id == 0x7E9);
+        REQUIRE(fc.data[0] == 0x32);
+        other.process(fc, t0);
+        REQUIRE(other_done == std::vector<IsoTpResult>{IsoTpResult::OVERFLOW});
+    }
+
+    SECTION("Invalid use") {
+        REQUIRE_THROWS_AS(link.tester.add_channel({0x123, ECU_ID}), std::invalid_argument);
+        REQUIRE_THROWS_AS(link.tester.send(tester, message.data(), 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(link.tester.send(7, message.data(), 3), std::out_of_range);
+        REQUIRE_THROWS_AS(link.tester.start(), std::logic_error);
+
+        IsoTpEngineConfig small;
+        small.buffer_size = 16;
+        IsoTpEngine engine([](const struct can_frame&) { return true; }, small);
+        std::size_t channel = engine.add_channel({TESTER_ID, ECU_ID});
+        REQUIRE(engine.send(channel, message.data(), message.size()) == IsoTpResult::NO_BUFFER);
+    }
+}
+
+TEST_CASE("IsoTpEngine - Concurrent channels over sockets", "[isotp][socket]") {
+    /**
+     * @brief ICANSocket over one end of a datagram socketpair
+     */
+    class PairSocket : public ICANSocket {
+        public:
+            explicit PairSocket(int fd) : fd_(fd) {}
+            ~PairSocket() override { close(); }
+            ssize_t send(const struct can_frame& frame) override {
+                return ::write(fd_, &frame, sizeof(frame));
+            }
+            ssize_t receive(struct can_frame& frame) override {
+                return ::read(fd_, &frame, sizeof(frame));
+            }
+            bool is_open() const override { return fd_ >= 0; }
+            void close() override {
+                if (fd_ >= 0) ::close(fd_);
+                fd_ = -1;
+            }
+            std::string get_interface_name() const override { return "pair"; }
+            int get_fd() const override { return fd_; }
+
+        private:
+            int fd_;
+    };
+
+    int fds[2];
+    REQUIRE(::socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) == 0);
+    IsoTpEngine tester(std::make_shared<PairSocket>(fds[0]));
+    IsoTpEngine ecus(std::make_shared<PairSocket>(fds[1]));
+
+    constexpr std::size_t CHANNELS = 4;
+    std::vector<std::size_t> tester_channels;
+    for (std::size_t i = 0; i < CHANNELS; ++i) {
+        IsoTpChannelConfig ecu{static_cast<uint32_t>(0x7E8 + i), static_cast<uint32_t>(0x7E0 + i)};
+        ecu.block_size = 8;
+        ecu.st_min = 0xF1;  // 100 us
+        ecus.add_channel(ecu);
+        tester_channels.push_back(tester.add_channel({ecu.rx_id, ecu.tx_id}));
+    }
+
+    // Each ECU echoes what it receives
+    ecus.on_receive([&](std::size_t channel, const uint8_t* data, std::size_t size) {
+            ecus.send(channel, data, size);
+        });
+    std::mutex mutex;
+    std::vector<std::vector<uint8_t>> echoes(CHANNELS);
+    std::atomic<std::size_t> done{0};
+    tester.on_receive([&](std::size_t channel, const uint8_t* data, std::size_t size) {
+            std::lock_guard<std::mutex> lock(mutex);
+            echoes[channel].assign(data, data + size);
+            ++done;
+        });
+    tester.start();
+    ecus.start();
+
+    std::vector<std::vector<uint8_t>> messages;
+    for (std::size_t i = 0; i < CHANNELS; ++i) {
+        messages.push_back(make_message(500 + 700 * i));
+        messages.back()[0] = static_cast<uint8_t>(i);
+        REQUIRE(tester.send(tester_channels[i], messages[i].data(), messages[i].size()) ==
+            IsoTpResult::OK);
+    }
+
+    auto deadline = Clock::now() + 5s;
+    while (done < CHANNELS && Clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    tester.stop();
+    ecus.stop();
+
+    REQUIRE(done == CHANNELS);
+    for (std::size_t i = 0; i < CHANNELS; ++i) {
+        REQUIRE(echoes[i] == messages[i]);
+    }
+    REQUIRE(tester.get_statistics().messages_sent == CHANNELS);
+    REQUIRE(ecus.get_statistics().messages_received == CHANNELS);
+}
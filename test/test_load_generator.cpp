@@ -0,0 +1,280 @@
+/**
+ * @file test_load_generator.cpp
+ * @brief Unit tests for the paced CAN load generator
+ * @version 1.0
+ * @date 2025-11-22
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+#include <fstream>
+#include <map>
+
+#include "../include/pattern/load_generator.hpp"
+#include "../include/frame/fixed_frame.hpp"
+#include "../include/interface/socketcan_helpers.hpp"
+
+using namespace waveshare;
+using namespace std::chrono_literals;
+
+TEST_CASE("LoadGenerator - Frame bit times", "[load][timing]") {
+    // Worst-case stuffed lengths, intermission included
+    REQUIRE(can_frame_bits(0, false) == 55);
+    REQUIRE(can_frame_bits(8, false) == 135);
+    REQUIRE(can_frame_bits(0, true) == 80);
+    REQUIRE(can_frame_bits(8, true) == 160);
+    REQUIRE(canbaud_to_int(CANBaud::BAUD_125K) == 125000);
+
+    bool use_default = false;
+    for (int rate : {5000, 10000, 20000, 50000, 100000, 125000, 200000, 250000, 400000, 500000,
+                     800000, 1000000}) {
+        REQUIRE(canbaud_to_int(canbaud_from_int(rate, use_default)) == rate);
+    }
+}
+
+TEST_CASE("LoadGenerator - Profile parsing", "[load][profile]") {
+    SECTION("IDs as hex strings or numbers, extended inferred") {
+        auto profile = LoadProfile::from_json(nlohmann::json::parse(R"({
+            "load_profile": {
+                "ids": [{"id": "0x181", "weight": 3}, {"id": 1793},
+                        {"id": "0x18FF0001"}, {"id": "0x10", "extended": true}],
+                "dlc": [{"dlc": 8, "weight": 2.5}, {"dlc": 0}]
+            }
+        })"));
+        REQUIRE(profile.ids.size() == 4);
+        REQUIRE(profile.ids[0].id == 0x181);
+        REQUIRE(profile.ids[0].weight == 3.0);
+        REQUIRE(profile.ids[1].id == 0x701);
+        REQUIRE(profile.ids[1].weight == 1.0);
+        REQUIRE_FALSE(profile.ids[1].extended);
+        REQUIRE(profile.ids[2].extended);
+        REQUIRE(profile.ids[3].extended);
+        REQUIRE(profile.dlcs[0].weight == 2.5);
+    }
+
+    SECTION("Invalid profiles are rejected") {
+        using nlohmann::json;
+        REQUIRE_THROWS_AS(LoadProfile::from_json(json::parse(R"({"ids": []})")),
+            std::invalid_argument);
+        REQUIRE_THROWS_AS(LoadProfile::from_json(json::parse(
+            R"({"load_profile": {"ids": [{"id": "0x181"}], "dlc": []}})")),
+            std::invalid_argument);
+        REQUIRE_THROWS_AS(LoadProfile::from_json(json::parse(
+            R"({"load_profile": {"ids": [{"id": "0x181"}], "dlc": [{"dlc": 9}]}})")),
+            std::invalid_argument);
+        REQUIRE_THROWS_AS(LoadProfile::from_json(json::parse(
+            R"({"load_profile": {"ids": [{"id": "0x900", "extended": false}],
+                "dlc": [{"dlc": 1}]}})")),
+            std::invalid_argument);
+        REQUIRE_THROWS_AS(LoadProfile::from_json(json::parse(
+            R"({"load_profile": {"ids": [{"id": "0x181", "weight": 0}],
+                "dlc": [{"dlc": 1}]}})")),
+            std::invalid_argument);
+        REQUIRE_THROWS_AS(LoadProfile::from_json(json::parse(
+            R"({"load_profile": {"ids": [{"id": "0x18Z"}], "dlc": [{"dlc": 1}]}})")),
+            std::invalid_argument);
+        REQUIRE_THROWS_AS(LoadProfile::from_file("/nonexistent/load_profile.json"),
+            std::runtime_error);
+    }
+
+    SECTION("Profile file") {
+        std::string path = "/tmp/test_load_profile.json";
+        {
+            std::ofstream file(path);
+            file << R"({"load_profile": {"ids": [{"id": "0x123"}], "dlc": [{"dlc": 4}]}})";
+        }
+        auto profile = LoadProfile::from_file(path);
+        std::remove(path.c_str());
+        REQUIRE(profile.ids[0].id == 0x123);
+        REQUIRE(profile.dlcs[0].dlc == 4);
+    }
+}
+
+TEST_CASE("LoadGenerator - Frame pool", "[load][pool]") {
+    LoadProfile profile;
+    profile.ids = {{0x100, false, 3.0}, {0x1ABCDEF0, true, 1.0}};
+    profile.dlcs = {{8, 1.0}, {2, 1.0}};
+
+    LoadGeneratorConfig config;
+    config.pool_size = 4000;
+    config.batch_size = 3;
+
+    SECTION("Draws follow the profile weights") {
+        LoadGenerator generator(profile, config);
+        REQUIRE(generator.frames().size() == 4002);     // Rounded up to whole batches
+
+        std::map<canid_t, std::size_t> ids;
+        std::map<int, std::size_t> dlcs;
+        for (const auto& frame : generator.frames()) {
+            ++ids[frame.can_id];
+            ++dlcs[frame.can_dlc];
+        }
+        REQUIRE(ids.size() == 2);
+        REQUIRE(ids[0x100] > 2800);
+        REQUIRE(ids[0x100] < 3200);
+        REQUIRE(ids[0x1ABCDEF0 | CAN_EFF_FLAG] > 800);
+        REQUIRE(dlcs.size() == 2);
+        REQUIRE(dlcs[8] > 1800);
+        REQUIRE(dlcs[2] > 1800);
+
+        // Same seed, same pool
+        LoadGenerator again(profile, config);
+        REQUIRE(again.encoded() == generator.encoded());
+    }
+
+    SECTION("Pre-encoded bytes match per-frame serialization") {
+        LoadGenerator generator(profile, config);
+        std::vector<std::uint8_t> expected;
+        for (const auto& frame : generator.frames()) {
+            auto bytes = SocketCANHelper::from_socketcan(frame).serialize();
+            expected.insert(expected.end(), bytes.begin(), bytes.end());
+        }
+        REQUIRE(generator.encoded() == expected);
+    }
+
+    SECTION("Fixed frames are 20 bytes each") {
+        config.fixed_frames = true;
+        LoadGenerator generator(profile, config);
+        REQUIRE(generator.encoded().size() == 20 * generator.frames().size());
+
+        FixedFrame frame;
+        frame.deserialize(span<const std::uint8_t>(generator.encoded().data() + 20, 20));
+        const auto& source = generator.frames()[1];
+        REQUIRE(frame.get_can_id() == (source.can_id & CAN_EFF_MASK));
+        REQUIRE(frame.get_dlc() == source.can_dlc);
+    }
+
+    SECTION("Invalid configuration is rejected") {
+        config.batch_size = 0;
+        REQUIRE_THROWS_AS(LoadGenerator(profile, config), std::invalid_argument);
+        config.batch_size = 1;
+        config.bus_load_percent = 120.0;
+        REQUIRE_THROWS_AS(LoadGenerator(profile, config), std::invalid_argument);
+        config.bus_load_percent = 0.0;
+        config.gap = 0us;
+        REQUIRE_THROWS_AS(LoadGenerator(profile, config), std::invalid_argument);
+    }
+}
+
+TEST_CASE("LoadGenerator - Paced run", "[load][run]") {
+    std::atomic<bool> running{true};
+    std::vector<LoadBatch> batches;
+    std::vector<std::chrono::steady_clock::time_point> times;
+    auto record = [&](const LoadBatch& batch) {
+            batches.push_back(batch);
+            times.push_back(std::chrono::steady_clock::now());
+            return true;
+        };
+
+    SECTION("Target bus load from frame timing") {
+        // 8-byte standard frames: 135 bits, 270 us each at 50% of 1 Mbit/s
+        LoadGeneratorConfig config;
+        config.can_baud = CANBaud::BAUD_1M;
+        config.bus_load_percent = 50.0;
+        config.batch_size = 4;
+        config.pool_size = 64;
+        config.count = 400;
+        LoadGenerator generator(LoadProfile::single(0x181, 8), config);
+        REQUIRE(generator.target_frame_rate() > 3703.0);
+        REQUIRE(generator.target_frame_rate() < 3704.0);
+
+        auto start = std::chrono::steady_clock::now();
+        auto stats = generator.run(record, running);
+        REQUIRE(stats.frames_sent == 400);
+        REQUIRE(stats.batches_sent == 100);
+        REQUIRE(stats.bits_sent == 400 * 135);
+        REQUIRE(stats.bytes_sent == 400 * 13);
+        REQUIRE(batches.size() == 100);
+        REQUIRE(batches[0].count == 4);
+        REQUIRE(batches[0].size == 4 * 13);
+        REQUIRE(batches[16].frames == batches[0].frames);   // Pool wraps around
+
+        // The last write is due 99 periods of 1080 us after the start
+        auto span = std::chrono::duration_cast<std::chrono::microseconds>(
+            times.back() - start);
+        REQUIRE(span >= 106900us);
+        REQUIRE(stats.bus_load_percent(CANBaud::BAUD_1M) <= 51.0);
+    }
+
+    SECTION("Microsecond gaps on absolute deadlines") {
+        LoadGeneratorConfig config;
+        config.gap = 50us;
+        config.pool_size = 16;
+        config.count = 2000;
+        LoadGenerator generator(LoadProfile::single(0x10, 1), config);
+
+        auto start = std::chrono::steady_clock::now();
+        auto stats = generator.run(record, running);
+        REQUIRE(stats.frames_sent == 2000);
+        auto span = std::chrono::duration_cast<std::chrono::microseconds>(
+            times.back() - start);
+        REQUIRE(span >= 99950us);
+    }
+
+    SECTION("Partial last batch, errors and stop flag") {
+        LoadGeneratorConfig config;
+        config.gap = 10us;
+        config.batch_size = 8;
+        config.pool_size = 8;
+        config.count = 20;
+        LoadGenerator generator(LoadProfile::single(0x10, 1), config);
+
+        auto stats = generator.run([&](const LoadBatch& batch) {
+                batches.push_back(batch);
+                return batches.size() != 2;
+            }, running);
+        // The refused batch is not counted: the run ends after 20 frames went out
+        REQUIRE(batches.size() == 4);
+        REQUIRE(batches[3].count == 4);
+        REQUIRE(stats.frames_sent == 20);
+        REQUIRE(stats.send_errors == 1);
+
+        config.count = 0;
+        LoadGenerator endless(LoadProfile::single(0x10, 1), config);
+        std::size_t sent = 0;
+        stats = endless.run([&](const LoadBatch&) {
+                if (++sent == 50) running = false;
+                return true;
+            }, running);
+        REQUIRE(stats.batches_sent == 50);
+        REQUIRE_FALSE(stats.gave_up);
+    }
+
+    SECTION("A dead transport ends a counted run") {
+        LoadGeneratorConfig config;
+        config.gap = 10us;
+        config.count = 20;
+        config.max_send_failures = 25;
+        LoadGenerator generator(LoadProfile::single(0x10, 1), config);
+
+        std::size_t attempts = 0;
+        auto stats = generator.run([&](const LoadBatch&) {
+                ++attempts;
+                return false;
+            }, running);
+        REQUIRE(stats.gave_up);
+        REQUIRE(attempts == 25);
+        REQUIRE(stats.send_errors == 25);
+        REQUIRE(stats.frames_sent == 0);
+    }
+
+    SECTION("Periodic statistics") {
+        LoadGeneratorConfig config;
+        config.gap = 100us;
+        config.count = 600;
+        config.stats_interval = 20ms;
+        LoadGenerator generator(LoadProfile::single(0x10, 0), config);
+
+        std::uint64_t reported = 0;
+        int reports = 0;
+        auto stats = generator.run(record, running,
+            [&](const LoadStatistics& interval, const LoadStatistics& total) {
+                ++reports;
+                reported += interval.frames_sent;
+                REQUIRE(total.frames_sent == reported);
+                REQUIRE(interval.elapsed >= 20ms);
+            });
+        REQUIRE(reports >= 2);
+        REQUIRE(reported <= stats.frames_sent);
+    }
+}
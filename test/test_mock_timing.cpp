@@ -0,0 +1,229 @@
+/**
+ * @file test_mock_timing.cpp
+ * @brief Unit tests for the link timing model of the mock serial port and CAN socket
+ * @version 1.0
+ * @date 2025-12-01
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include "../include/pattern/usb_adapter.hpp"
+#include "../include/interface/socketcan_helpers.hpp"
+#include "mocks/mock_can_socket.hpp"
+#include "mocks/mock_serial_port.hpp"
+
+using namespace waveshare;
+using namespace waveshare::test;
+using namespace std::chrono_literals;
+
+namespace {
+    // 8N1 at 2 Mbaud: 10 bit times of 500 ns
+    constexpr std::int64_t BYTE_NS = 5000;
+
+    std::int64_t can_frame_ns(std::uint8_t dlc, int bit_rate) {
+        return static_cast<std::int64_t>(can_frame_bits(dlc, false)) * 1000000000LL / bit_rate;
+    }
+}
+
+TEST_CASE("MockClock - Virtual time", "[mock][timing]") {
+    MockClock clock;
+    REQUIRE(clock.is_virtual());
+    REQUIRE(clock.now() == 0ns);
+    clock.advance(5ms);
+    REQUIRE(clock.now() == 5ms);
+    clock.advance_to(2ms);      // Never backwards
+    REQUIRE(clock.now() == 5ms);
+
+    MockClock real(MockClock::Mode::REAL);
+    auto before = real.now();
+    real.advance(2ms);
+    REQUIRE(real.now() - before >= 2ms);
+}
+
+TEST_CASE("MockSerialPort - Baud rate, buffers and latency", "[mock][timing]") {
+    MockSerialPort port("/dev/mock");
+    MockSerialTiming timing;
+    timing.baud = SerialBaud::BAUD_2M;
+    timing.rx_buffer_bytes = 64;
+    timing.tx_buffer_bytes = 100;
+    timing.delay.latency = 1ms;
+    port.set_timing(timing);
+    auto clock = port.get_clock();
+    REQUIRE(clock != nullptr);
+    std::uint8_t buffer[256];
+
+    SECTION("Bytes are readable once they have crossed the link") {
+        port.inject_rx_data(std::vector<std::uint8_t>(20, 0x11));
+        REQUIRE(port.read(buffer, sizeof(buffer), 0) == -1);
+        REQUIRE(errno == EAGAIN);
+
+        // A waiting read ends at the arrival, not at the timeout
+        REQUIRE(port.read(buffer, sizeof(buffer), 100) == 20);
+        REQUIRE(clock->now().count() == 20 * BYTE_NS + 1000000);
+
+        // -1 waits read_wait
+        REQUIRE(port.read(buffer, sizeof(buffer), -1) == -1);
+        REQUIRE(clock->now().count() == 20 * BYTE_NS + 2000000);
+    }
+
+    SECTION("Reads cross injection boundaries like a byte stream") {
+        port.inject_rx_data({0x01, 0x02, 0x03});
+        port.inject_rx_data({0x04, 0x05});
+        clock->advance(10ms);
+        REQUIRE(port.read(buffer, 4, 0) == 4);
+        REQUIRE(buffer[3] == 0x04);
+        REQUIRE(port.read(buffer, 4, 0) == 1);
+        REQUIRE(buffer[0] == 0x05);
+    }
+
+    SECTION("A full RX buffer loses the bytes that arrive") {
+        port.inject_rx_data(std::vector<std::uint8_t>(50, 0x22));
+        port.inject_rx_data(std::vector<std::uint8_t>(50, 0x33));
+        clock->advance(20ms);
+        REQUIRE(port.read(buffer, sizeof(buffer), 0) == 64);
+        REQUIRE(buffer[63] == 0x33);
+        REQUIRE(port.get_rx_overrun_bytes() == 36);
+    }
+
+    SECTION("A full TX buffer accepts part of a write, then refuses") {
+        std::vector<std::uint8_t> data(80, 0x44);
+        REQUIRE(port.write(data.data(), data.size()) == 80);
+        REQUIRE(port.write(data.data(), data.size()) == 20);
+        REQUIRE(port.write(data.data(), data.size()) == -1);
+        REQUIRE(errno == EAGAIN);
+        REQUIRE(port.get_tx_rejected() == 1);
+
+        // 50 bytes leave the buffer
+        clock->advance(std::chrono::nanoseconds(50 * BYTE_NS));
+        REQUIRE(port.write(data.data(), data.size()) == 50);
+        REQUIRE(port.get_tx_history().size() == 3);
+    }
+
+    SECTION("Jitter is reproducible and keeps the byte order") {
+        auto arrivals = [](std::uint32_t seed) {
+            MockSerialPort jittery("/dev/mock");
+            MockSerialTiming jitter_timing;
+            jitter_timing.delay.latency = 100us;
+            jitter_timing.delay.jitter = 500us;
+            jitter_timing.delay.seed = seed;
+            jittery.set_timing(jitter_timing);
+            std::vector<std::int64_t> times;
+            for (std::uint8_t i = 0; i < 20; ++i) {
+                jittery.inject_rx_data({i});
+            }
+            std::uint8_t byte;
+            for (std::uint8_t i = 0; i < 20; ++i) {
+                REQUIRE(jittery.read(&byte, 1, 10) == 1);
+                REQUIRE(byte == i);
+                times.push_back(jittery.get_clock()->now().count());
+            }
+            return times;
+        };
+        auto first = arrivals(7);
+        REQUIRE(first == arrivals(7));
+        REQUIRE(first != arrivals(8));
+    }
+}
+
+TEST_CASE("MockSerialPort - USBAdapter at the link rate", "[mock][timing]") {
+    auto mock = std::make_unique<MockSerialPort>("/dev/mock");
+    MockSerialPort* port = mock.get();
+    MockSerialTiming timing;
+    timing.baud = SerialBaud::BAUD_2M;
+    port->set_timing(timing);
+    auto clock = port->get_clock();
+    USBAdapter adapter(std::move(mock), "/dev/mock", SerialBaud::BAUD_2M);
+
+    constexpr std::size_t FRAMES = 20;
+    std::size_t frame_bytes = 0;
+    for (std::size_t i = 0; i < FRAMES; ++i) {
+        struct can_frame frame;
+        std::memset(&frame, 0, sizeof(frame));
+        frame.can_id = 0x181;
+        frame.can_dlc = 8;
+        frame.data[0] = static_cast<std::uint8_t>(i);
+        auto bytes = SocketCANHelper::from_socketcan(frame).serialize();
+        frame_bytes = bytes.size();
+        port->inject_rx_data(std::vector<std::uint8_t>(bytes.begin(), bytes.end()));
+    }
+
+    for (std::size_t i = 0; i < FRAMES; ++i) {
+        auto frame = adapter.receive_variable_frame(1000);
+        REQUIRE(frame.get_data()[0] == i);
+    }
+    // The reader waited exactly as long as the link took
+    REQUIRE(clock->now().count() ==
+        static_cast<std::int64_t>(FRAMES * frame_bytes) * BYTE_NS);
+}
+
+TEST_CASE("MockCANSocket - Bit rate, queues and latency", "[mock][timing]") {
+    MockCANSocket socket("mock0", 100);
+    MockCANTiming timing;
+    timing.bit_rate = CANBaud::BAUD_500K;
+    timing.rx_queue_frames = 4;
+    timing.tx_queue_frames = 3;
+    timing.delay.latency = 50us;
+    socket.set_timing(timing);
+    auto clock = socket.get_clock();
+    const auto frame = MockCANSocket::make_frame(0x181, {1, 2, 3, 4, 5, 6, 7, 8});
+    const std::int64_t frame_ns = can_frame_ns(8, 500000);
+
+    SECTION("Frames arrive back to back at the bit rate") {
+        for (int i = 0; i < 3; ++i) {
+            socket.inject_rx_frame(frame);
+        }
+        can_frame received;
+        for (int i = 1; i <= 3; ++i) {
+            REQUIRE(socket.receive(received) == sizeof(can_frame));
+            REQUIRE(clock->now().count() == i * frame_ns + 50000);
+        }
+        // Empty: the receive timeout elapses on the clock
+        REQUIRE(socket.receive(received) == -1);
+        REQUIRE(errno == EAGAIN);
+        REQUIRE(clock->now().count() == 3 * frame_ns + 50000 + 100000000);
+    }
+
+    SECTION("A full RX queue drops frames") {
+        for (int i = 0; i < 10; ++i) {
+            socket.inject_rx_frame(frame);
+        }
+        clock->advance(10ms);
+        can_frame received;
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(socket.receive(received) == sizeof(can_frame));
+        }
+        REQUIRE(socket.get_rx_overruns() == 6);
+        REQUIRE(socket.get_rx_queue_size() == 0);
+    }
+
+    SECTION("A full TX queue refuses frames until one is sent") {
+        for (int i = 0; i < 3; ++i) {
+            REQUIRE(socket.send(frame) == sizeof(can_frame));
+        }
+        REQUIRE(socket.send(frame) == -1);
+        REQUIRE(errno == EAGAIN);
+        REQUIRE(socket.get_tx_queue_size() == 3);
+
+        clock->advance(std::chrono::nanoseconds(frame_ns));
+        REQUIRE(socket.get_tx_queue_size() == 2);
+        REQUIRE(socket.send(frame) == sizeof(can_frame));
+        REQUIRE(socket.get_tx_rejected() == 1);
+        REQUIRE(socket.get_tx_history().size() == 4);
+    }
+}
+
+TEST_CASE("MockCANSocket - Untimed behaviour is unchanged", "[mock][timing]") {
+    MockCANSocket socket("mock0", 100);
+    REQUIRE(socket.get_clock() == nullptr);
+    for (int i = 0; i < 50; ++i) {
+        REQUIRE(socket.send(MockCANSocket::make_frame(0x100, {})) == sizeof(can_frame));
+    }
+    socket.inject_rx_frame(MockCANSocket::make_frame(0x200, {0xAA}));
+    can_frame received;
+    REQUIRE(socket.receive(received) == sizeof(can_frame));
+    REQUIRE(received.can_id == 0x200);
+}
@@ -13,6 +13,8 @@
 #include <atomic>
 #include <filesystem>
 #include <regex>
+#include <algorithm>
+#include <optional>
 
 using namespace waveshare;
 namespace fs = std::filesystem;
@@ -366,6 +368,197 @@ TEST_CASE("USBAdapter - Resource management", "[usb_adapter][resource]") {
     }
 }
 
+namespace {
+
+    /**
+     * @brief Serial port simulating an adapter on a bus running at one rate
+     *
+     * Tracks the rate and mode set by each ConfigFrame written; frames are
+     * only received while the adapter is at bus_rate, malformed bytes while
+     * it is at noisy_rate.
+     */
+    class SimulatedBusPort : public ISerialPort {
+        public:
+            struct Setting {
+                CANBaud baud;
+                CANMode mode;
+                Type type;
+                RTX auto_rtx;
+                std::uint32_t filter;
+                std::uint32_t mask;
+            };
+
+            SimulatedBusPort(std::optional<CANBaud> bus_rate, std::vector<Setting>& settings,
+                std::optional<CANBaud> noisy_rate = std::nullopt)
+                : bus_rate_(bus_rate), noisy_rate_(noisy_rate), settings_(settings) {
+            }
+
+            ssize_t write(const void* data, std::size_t len) override {
+                const auto* bytes = static_cast<const std::uint8_t*>(data);
+                if (len == 20 && bytes[0] == 0xAA) {
+                    ConfigFrame config;
+                    config.deserialize(span<const std::uint8_t>(bytes, len));
+                    current_ = config.get_baud_rate();
+                    settings_.push_back({config.get_baud_rate(), config.get_can_mode(),
+                        config.get_type(), config.get_auto_rtx(), config.get_filter(),
+                        config.get_mask()});
+                    rx_.clear();
+                }
+                return static_cast<ssize_t>(len);
+            }
+
+            ssize_t read(void* data, std::size_t len, int) override {
+                if (rx_.empty()) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                    auto now = std::chrono::steady_clock::now();
+                    if (now - last_frame_ < std::chrono::microseconds(100)) {
+                        return 0;   // Bus traffic paced at one frame per 100 us
+                    }
+                    last_frame_ = now;
+                    if (current_ == bus_rate_) {
+                        std::uint8_t payload[] = {0x05};  // Heartbeat: pre-operational
+                        VariableFrame frame(Format::DATA_VARIABLE, CANVersion::STD_VARIABLE,
+                            0x701, span<const std::uint8_t>(payload, 1));
+                        auto bytes = frame.serialize();
+                        rx_.insert(rx_.end(), bytes.begin(), bytes.end());
+                    } else if (current_ == noisy_rate_) {
+                        rx_ = {0xAA, 0x13, 0x55};
+                    }
+                    if (rx_.empty()) {
+                        return 0;
+                    }
+                }
+                std::size_t count = std::min(len, rx_.size());
+                std::copy_n(rx_.begin(), count, static_cast<std::uint8_t*>(data));
+                rx_.erase(rx_.begin(), rx_.begin() + static_cast<std::ptrdiff_t>(count));
+                return static_cast<ssize_t>(count);
+            }
+
+            bool is_open() const override { return true; }
+            void close() override {}
+            std::string get_device_path() const override { return "/dev/sim_bus"; }
+            int get_fd() const override { return -1; }
+
+        private:
+            std::optional<CANBaud> bus_rate_;
+            std::optional<CANBaud> noisy_rate_;
+            std::optional<CANBaud> current_;
+            std::vector<Setting>& settings_;
+            std::vector<std::uint8_t> rx_;
+            std::chrono::steady_clock::time_point last_frame_;
+    };
+
+    AutobaudConfig fast_autobaud() {
+        AutobaudConfig config;
+        config.initial_window = std::chrono::milliseconds(20);
+        config.max_window = std::chrono::milliseconds(80);
+        config.settle = std::chrono::milliseconds(0);
+        config.frames_required = 3;
+        return config;
+    }
+
+} // namespace
+
+TEST_CASE("USBAdapter - Autobaud", "[usb_adapter][autobaud]") {
+    std::vector<SimulatedBusPort::Setting> settings;
+
+    SECTION("Detects the bus rate while listening only") {
+        USBAdapter adapter(std::make_unique<SimulatedBusPort>(CANBaud::BAUD_125K, settings),
+            "/dev/sim_bus");
+        REQUIRE_FALSE(adapter.detected_can_baud().has_value());
+
+        auto result = adapter.autobaud(fast_autobaud());
+        REQUIRE(result.detected);
+        REQUIRE(result.baud_rate == CANBaud::BAUD_125K);
+        REQUIRE(result.frames == 3);
+        REQUIRE(adapter.detected_can_baud() == CANBaud::BAUD_125K);
+
+        // Common rates first, all sampled silent, then the final mode
+        REQUIRE(result.attempts == 4);
+        REQUIRE(settings.size() == 5);
+        REQUIRE(settings[0].baud == CANBaud::BAUD_1M);
+        REQUIRE(settings[1].baud == CANBaud::BAUD_500K);
+        REQUIRE(settings[2].baud == CANBaud::BAUD_250K);
+        for (std::size_t i = 0; i < 4; ++i) {
+            REQUIRE(settings[i].mode == CANMode::SILENT);
+        }
+        REQUIRE(settings[4].baud == CANBaud::BAUD_125K);
+        REQUIRE(settings[4].mode == CANMode::NORMAL);
+        for (const auto& setting : settings) {
+            REQUIRE(setting.type == Type::CONF_VARIABLE);
+        }
+
+        // The detected rate is tried first next time
+        settings.clear();
+        result = adapter.autobaud(fast_autobaud());
+        REQUIRE(result.attempts == 1);
+        REQUIRE(settings[0].baud == CANBaud::BAUD_125K);
+    }
+
+    SECTION("Malformed frames end a window early") {
+        USBAdapter adapter(std::make_unique<SimulatedBusPort>(CANBaud::BAUD_5K, settings,
+            CANBaud::BAUD_1M), "/dev/sim_bus");
+
+        auto config = fast_autobaud();
+        config.candidates = {CANBaud::BAUD_1M, CANBaud::BAUD_5K};
+        config.final_mode = CANMode::SILENT;
+        auto result = adapter.autobaud(config);
+        REQUIRE(result.detected);
+        REQUIRE(result.baud_rate == CANBaud::BAUD_5K);
+        REQUIRE(result.errors == 1);
+        REQUIRE(settings.size() == 2);  // Stays silent: no final ConfigFrame
+    }
+
+    SECTION("The caller's filter, mask and RTX are applied at the detected rate") {
+        USBAdapter adapter(std::make_unique<SimulatedBusPort>(CANBaud::BAUD_1M, settings),
+            "/dev/sim_bus");
+
+        auto config = fast_autobaud();
+        config.auto_rtx = RTX::OFF;
+        config.filter = 0x180;
+        config.mask = 0x780;
+        REQUIRE(adapter.autobaud(config).detected);
+        REQUIRE(settings.size() == 2);
+
+        // Sampled with an accept-all filter, so the heartbeat is not hidden
+        REQUIRE(settings[0].type == Type::CONF_VARIABLE);
+        REQUIRE(settings[0].filter == 0);
+        REQUIRE(settings[0].mask == 0);
+
+        REQUIRE(settings[1].type == Type::CONF_VARIABLE);
+        REQUIRE(settings[1].mode == CANMode::NORMAL);
+        REQUIRE(settings[1].auto_rtx == RTX::OFF);
+        REQUIRE(settings[1].filter == 0x180);
+        REQUIRE(settings[1].mask == 0x780);
+    }
+
+    SECTION("Idle bus widens the window until max_window") {
+        USBAdapter adapter(std::make_unique<SimulatedBusPort>(std::nullopt, settings),
+            "/dev/sim_bus");
+
+        auto config = fast_autobaud();
+        config.candidates = {CANBaud::BAUD_500K, CANBaud::BAUD_250K};
+        auto result = adapter.autobaud(config);
+        REQUIRE_FALSE(result.detected);
+        REQUIRE(result.attempts == 6);  // Windows of 20, 40 and 80 ms
+        REQUIRE(result.elapsed >= std::chrono::milliseconds(280));
+        REQUIRE_FALSE(adapter.detected_can_baud().has_value());
+    }
+
+    SECTION("Invalid configuration is rejected") {
+        USBAdapter adapter(std::make_unique<SimulatedBusPort>(std::nullopt, settings),
+            "/dev/sim_bus");
+
+        auto config = fast_autobaud();
+        config.frames_required = 0;
+        REQUIRE_THROWS_AS(adapter.autobaud(config), ProtocolException);
+        config = fast_autobaud();
+        config.max_window = std::chrono::milliseconds(1);
+        REQUIRE_THROWS_AS(adapter.autobaud(config), ProtocolException);
+        REQUIRE(settings.empty());
+    }
+}
+
 // Integration test documentation (requires hardware)
 /*
  * Hardware Integration Test Plan: